@@ -136,6 +136,11 @@ extern DECLSPEC SDL_bool SDLCALL SDL_HasSSE41(void);
  */
 extern DECLSPEC SDL_bool SDLCALL SDL_HasSSE42(void);
 
+/**
+ *  This function returns true if the CPU has AVX features.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasAVX(void);
+
 
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
@@ -117,6 +117,60 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_VSYNC               "SDL_RENDER_VSYNC"
 
+/**
+ *  \brief  A variable controlling whether the 2D renderer batches draw calls.
+ *
+ *  When enabled, SDL_RenderCopy() and SDL_RenderFillRects() are recorded and
+ *  sent to the renderer backend in batches when the frame is presented, the
+ *  render target changes, pixels are read back or SDL_RenderFlush() is called.
+ *  Applications that mix their own graphics API calls with the 2D renderer
+ *  should call SDL_RenderFlush() first, or disable batching.
+ *
+ *  Renderers from SDL_CreateSoftwareRenderer() don't batch by default, since
+ *  applications read their surface directly.  With batching enabled for them,
+ *  call SDL_RenderFlush() before using the surface.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Draw calls go to the backend immediately
+ *    "1"       - Draw calls are batched
+ *
+ *  By default, draw calls are batched for renderers created for a window.
+ *
+ *  This is read when the renderer is created.
+ */
+#define SDL_HINT_RENDER_BATCHING            "SDL_RENDER_BATCHING"
+
+/**
+ *  \brief  A variable controlling how many threads the software renderer uses.
+ *
+ *  With more than one thread, clears, rectangles, points and unscaled copies
+ *  are recorded, sorted into screen tiles and drawn in parallel when the
+ *  frame is presented, pixels are read back or SDL_RenderFlush() is called.
+ *  The result is the same as drawing on a single thread.
+ *
+ *  This variable can be set to the following values:
+ *    "0" or "1" - Draw on the calling thread (default)
+ *    "N"        - Draw with N threads, including the calling thread
+ *    "auto"     - Draw with one thread per CPU
+ *
+ *  This is read when the renderer is created.
+ */
+#define SDL_HINT_RENDER_SOFTWARE_THREADS    "SDL_RENDER_SOFTWARE_THREADS"
+
+/**
+ *  \brief  A variable controlling the YUV to RGB conversion of textures that
+ *          are converted in software.
+ *
+ *  This variable can be set to the following values:
+ *    "JPEG"       - BT.601 with full range YUV (default)
+ *    "BT601"      - BT.601 with limited range YUV, as used by SD video
+ *    "BT709"      - BT.709 with limited range YUV, as used by HD video
+ *    "BT709_FULL" - BT.709 with full range YUV
+ *
+ *  This is read when the texture is created.
+ */
+#define SDL_HINT_YUV_CONVERSION_MODE        "SDL_YUV_CONVERSION_MODE"
+
 /**
  *  \brief  A variable controlling whether the X11 VidMode extension should be used.
  *
@@ -229,6 +283,21 @@ extern "C" {
 #define SDL_HINT_JOYSTICK_ALLOW_BACKGROUND_EVENTS "SDL_JOYSTICK_ALLOW_BACKGROUND_EVENTS"
 
 
+/**
+ *  \brief A variable controlling whether the window surface tracks modified regions.
+ *
+ *  When enabled, blits, fills and locks on the surface returned by
+ *  SDL_GetWindowSurface() record the changed area, and SDL_UpdateWindowSurface()
+ *  only sends those pixels to the screen.  Only enable this if the application
+ *  always locks the surface before writing to its pixels directly.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - SDL_UpdateWindowSurface() updates the entire window (default)
+ *    "1"       - SDL_UpdateWindowSurface() updates only the modified regions
+ */
+#define SDL_HINT_FRAMEBUFFER_DIRTY_RECTS "SDL_FRAMEBUFFER_DIRTY_RECTS"
+
+
 /**
  *  \brief If set to 0 then never set the top most bit on a SDL Window, even if the video mode expects it.
  *      This is a debugging aid for developers and not expected to be used by end users. The default is "1"
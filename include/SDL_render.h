@@ -115,6 +115,31 @@ typedef enum
     SDL_FLIP_VERTICAL = 0x00000002     /**< flip vertically */
 } SDL_RendererFlip;
 
+/**
+ *  \brief A single copy drawn by SDL_RenderCopyMany
+ */
+typedef struct SDL_RenderCopyData
+{
+    SDL_Rect srcrect;           /**< The source rectangle, or empty for the entire texture */
+    SDL_Rect dstrect;           /**< The destination rectangle */
+    double angle;               /**< Clockwise rotation in degrees around the center of dstrect */
+    SDL_RendererFlip flip;      /**< Flipping actions to perform on the texture */
+    Uint8 r, g, b, a;           /**< Color and alpha modulation used instead of the texture's */
+} SDL_RenderCopyData;
+
+/**
+ *  \brief The work a renderer sent to the graphics driver
+ *
+ *  \sa SDL_GetRenderStats()
+ */
+typedef struct SDL_RenderStats
+{
+    Uint32 draw_calls;          /**< Clears and batches of primitives drawn */
+    Uint32 state_changes;       /**< Changes of blend mode, shader, color and similar state */
+    Uint32 texture_binds;       /**< Textures bound for drawing or updating */
+    Uint64 bytes_uploaded;      /**< Texture pixel data sent to the driver */
+} SDL_RenderStats;
+
 /**
  *  \brief A structure representing rendering state
  */
@@ -127,6 +152,12 @@ typedef struct SDL_Renderer SDL_Renderer;
 struct SDL_Texture;
 typedef struct SDL_Texture SDL_Texture;
 
+/**
+ *  \brief A set of shared textures that many small images are packed into
+ */
+struct SDL_TextureAtlas;
+typedef struct SDL_TextureAtlas SDL_TextureAtlas;
+
 
 /* Function prototypes */
 
@@ -257,6 +288,86 @@ extern DECLSPEC SDL_Texture * SDLCALL SDL_CreateTexture(SDL_Renderer * renderer,
  */
 extern DECLSPEC SDL_Texture * SDLCALL SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface);
 
+/**
+ *  \brief Create a texture atlas, which packs images into shared textures.
+ *
+ *  \param renderer The renderer.
+ *  \param format The format of the atlas pages, or 0 for SDL_PIXELFORMAT_ARGB8888.
+ *  \param w      The width of each atlas page.
+ *  \param h      The height of each atlas page.
+ *
+ *  \return The created atlas, or NULL if the format isn't supported.
+ *
+ *  Textures created from an atlas draw from part of a shared page texture,
+ *  so copies from different images in the same page can be batched.  Pages
+ *  are added as needed, and are repacked when images destroyed with
+ *  SDL_DestroyTexture() have left enough free space.
+ *
+ *  The atlas belongs to the application, which must free it with
+ *  SDL_DestroyTextureAtlas().  Destroying the renderer destroys the atlas's
+ *  textures and pages but not the atlas itself, which can then only be
+ *  passed to SDL_GetTextureAtlasRenderer() and SDL_DestroyTextureAtlas().
+ *
+ *  \sa SDL_CreateAtlasTextureFromSurface()
+ *  \sa SDL_GetTextureAtlasRenderer()
+ *  \sa SDL_DestroyTextureAtlas()
+ */
+extern DECLSPEC SDL_TextureAtlas * SDLCALL SDL_CreateTextureAtlas(SDL_Renderer * renderer,
+                                                        Uint32 format,
+                                                        int w, int h);
+
+/**
+ *  \brief Pack a surface into a texture atlas.
+ *
+ *  \param atlas The texture atlas.
+ *  \param surface The surface containing pixel data used to fill the texture.
+ *
+ *  \return The created texture is returned, or NULL on error.
+ *
+ *  The texture is static and can be used like any other, except that it
+ *  can't be locked or used as a render target.  SDL_UpdateTexture() and
+ *  SDL_DestroyTexture() work on the image in the atlas.
+ *
+ *  \sa SDL_CreateTextureFromSurface()
+ */
+extern DECLSPEC SDL_Texture * SDLCALL SDL_CreateAtlasTextureFromSurface(SDL_TextureAtlas * atlas,
+                                                                SDL_Surface * surface);
+
+/**
+ *  \brief Repack the images in a texture atlas, releasing unused pages.
+ *
+ *  \return 0 on success, or -1 on error.
+ *
+ *  Textures from the atlas stay valid.  This is done automatically when the
+ *  atlas runs out of room, so it's only needed to release memory early.
+ */
+extern DECLSPEC int SDLCALL SDL_DefragmentTextureAtlas(SDL_TextureAtlas * atlas);
+
+/**
+ *  \brief Get the number of pages in use by a texture atlas.
+ *
+ *  \return The number of pages, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_GetTextureAtlasPages(SDL_TextureAtlas * atlas);
+
+/**
+ *  \brief Get the renderer of a texture atlas.
+ *
+ *  \return The renderer, or NULL if it has been destroyed.
+ *
+ *  This doesn't set an error when the renderer has been destroyed, so it
+ *  can be used to check whether the atlas's textures are still valid.
+ */
+extern DECLSPEC SDL_Renderer * SDLCALL SDL_GetTextureAtlasRenderer(SDL_TextureAtlas * atlas);
+
+/**
+ *  \brief Destroy a texture atlas and all the textures created from it.
+ *
+ *  Destroying the renderer destroys the atlas's textures and pages, and
+ *  the atlas can only be destroyed after that.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyTextureAtlas(SDL_TextureAtlas * atlas);
+
 /**
  *  \brief Query the attributes of a texture
  *
@@ -364,6 +475,45 @@ extern DECLSPEC int SDLCALL SDL_SetTextureBlendMode(SDL_Texture * texture,
 extern DECLSPEC int SDLCALL SDL_GetTextureBlendMode(SDL_Texture * texture,
                                                     SDL_BlendMode *blendMode);
 
+/**
+ *  \brief Set a texture to be drawn as a signed distance field.
+ *
+ *  \param texture   The texture to update.
+ *  \param spread    The distance in texture pixels from the edge of a shape
+ *                   to where its alpha reaches 0 outside or 255 inside, or 0
+ *                   to draw the texture normally.
+ *  \param threshold The alpha value on the edge of the shapes, usually 128.
+ *
+ *  \return 0 on success, or -1 if the texture is not valid or the renderer
+ *          can't draw distance fields.
+ *
+ *  The alpha of a distance field texture is sampled with linear filtering
+ *  and turned into coverage of the edge at the size it's drawn, so a single
+ *  small texture stays sharp when it's copied at any scale.  The color
+ *  channels and modulation are used as they are for other textures.
+ *
+ *  \sa SDL_GetTextureDistanceField()
+ */
+extern DECLSPEC int SDLCALL SDL_SetTextureDistanceField(SDL_Texture * texture,
+                                                        int spread,
+                                                        Uint8 threshold);
+
+/**
+ *  \brief Get the distance field settings of a texture.
+ *
+ *  \param texture   The texture to query.
+ *  \param spread    A pointer filled in with the spread, 0 if the texture is
+ *                   not a distance field.
+ *  \param threshold A pointer filled in with the alpha on the edges.
+ *
+ *  \return 0 on success, or -1 if the texture is not valid.
+ *
+ *  \sa SDL_SetTextureDistanceField()
+ */
+extern DECLSPEC int SDLCALL SDL_GetTextureDistanceField(SDL_Texture * texture,
+                                                        int *spread,
+                                                        Uint8 *threshold);
+
 /**
  *  \brief Update the given texture rectangle with new pixel data.
  *
@@ -381,6 +531,31 @@ extern DECLSPEC int SDLCALL SDL_UpdateTexture(SDL_Texture * texture,
                                               const SDL_Rect * rect,
                                               const void *pixels, int pitch);
 
+/**
+ *  \brief Update a rectangle within a planar YV12 or IYUV texture with new pixel data.
+ *
+ *  \param texture   The texture to update
+ *  \param rect      A pointer to the rectangle of pixels to update, or NULL to
+ *                   update the entire texture.
+ *  \param Yplane    The raw pixel data for the Y plane.
+ *  \param Ypitch    The number of bytes between rows of pixel data for the Y plane.
+ *  \param Uplane    The raw pixel data for the U plane.
+ *  \param Upitch    The number of bytes between rows of pixel data for the U plane.
+ *  \param Vplane    The raw pixel data for the V plane.
+ *  \param Vpitch    The number of bytes between rows of pixel data for the V plane.
+ *
+ *  \return 0 on success, or -1 if the texture is not valid.
+ *
+ *  \note You can use SDL_UpdateTexture() as long as your pixel data is
+ *        a contiguous block of Y and U/V planes in the proper order, but
+ *        this function is available if your pixel data is not contiguous.
+ */
+extern DECLSPEC int SDLCALL SDL_UpdateYUVTexture(SDL_Texture * texture,
+                                                 const SDL_Rect * rect,
+                                                 const Uint8 *Yplane, int Ypitch,
+                                                 const Uint8 *Uplane, int Upitch,
+                                                 const Uint8 *Vplane, int Vpitch);
+
 /**
  *  \brief Lock a portion of the texture for write-only pixel access.
  *
@@ -407,6 +582,76 @@ extern DECLSPEC int SDLCALL SDL_LockTexture(SDL_Texture * texture,
  */
 extern DECLSPEC void SDLCALL SDL_UnlockTexture(SDL_Texture * texture);
 
+/**
+ *  \brief Unlock a texture, uploading only the parts of it that changed.
+ *
+ *  \param texture   The locked texture.
+ *  \param rects     The rectangles written while the texture was locked, in
+ *                   texture coordinates.  They are clipped to the locked area.
+ *  \param count     The number of rectangles, 0 if nothing was changed.
+ *
+ *  \note Rectangles that cover most of their bounding box are uploaded as
+ *        that one box.
+ *
+ *  \sa SDL_LockTexture()
+ *  \sa SDL_UnlockTexture()
+ */
+extern DECLSPEC void SDLCALL SDL_UnlockTextureRects(SDL_Texture * texture,
+                                                    const SDL_Rect * rects,
+                                                    int count);
+
+/**
+ *  \brief Give a streaming texture a ring of CPU frame buffers, so another
+ *         thread can fill the next frame while the texture is being drawn.
+ *
+ *  \param texture   The texture, which was created with
+ *                   ::SDL_TEXTUREACCESS_STREAMING.
+ *  \param count     The number of frame buffers, at least 2, or 0 to free them.
+ *
+ *  \return 0 on success, or -1 if the texture is not valid, is not streaming
+ *          or a frame buffer is locked.
+ *
+ *  The newest frame finished with SDL_UnlockTextureBuffer() is uploaded the
+ *  next time the texture is copied to the renderer.  A finished frame that
+ *  hasn't been drawn yet is replaced by a newer one, so a writer that gets
+ *  ahead drops frames rather than waiting for the renderer.
+ *
+ *  \sa SDL_LockTextureBuffer()
+ *  \sa SDL_UnlockTextureBuffer()
+ */
+extern DECLSPEC int SDLCALL SDL_SetTextureStreamingBuffers(SDL_Texture * texture,
+                                                           int count);
+
+/**
+ *  \brief Get a free frame buffer of the texture to write the next frame into.
+ *
+ *  \param texture   The texture, which has streaming buffers.
+ *  \param pixels    This is filled in with a pointer to the frame pixels, in
+ *                   the format of the texture.
+ *  \param pitch     This is filled in with the pitch of the frame pixels.
+ *
+ *  \return 0 on success, or -1 if the texture has no streaming buffers or
+ *          a frame buffer is already locked.
+ *
+ *  \note This may be called from any thread, but only one frame buffer may
+ *        be locked at a time.
+ *
+ *  \sa SDL_SetTextureStreamingBuffers()
+ *  \sa SDL_UnlockTextureBuffer()
+ */
+extern DECLSPEC int SDLCALL SDL_LockTextureBuffer(SDL_Texture * texture,
+                                                  void **pixels, int *pitch);
+
+/**
+ *  \brief Queue the locked frame buffer to be shown the next time the texture
+ *         is copied to the renderer.
+ *
+ *  \note This may be called from any thread.
+ *
+ *  \sa SDL_LockTextureBuffer()
+ */
+extern DECLSPEC void SDLCALL SDL_UnlockTextureBuffer(SDL_Texture * texture);
+
 /**
  * \brief Determines whether a window supports the use of render targets
  *
@@ -770,6 +1015,27 @@ extern DECLSPEC int SDLCALL SDL_RenderCopyEx(SDL_Renderer * renderer,
                                            const SDL_Point *center,
                                            const SDL_RendererFlip flip);
 
+/**
+ *  \brief Copy many portions of a texture to the current rendering target at once.
+ *
+ *  \param renderer The renderer which should copy parts of a texture.
+ *  \param texture The source texture.
+ *  \param copies   An array of copies to perform, in drawing order.
+ *  \param count    The number of copies.
+ *
+ *  \return 0 on success, or -1 on error
+ *
+ *  Each copy is drawn as SDL_RenderCopyEx() would draw it after setting the
+ *  texture color and alpha modulation to the copy's r, g, b and a, but the
+ *  texture's own modulation is left unchanged.  The whole array goes to the
+ *  renderer in one call, which is much faster than drawing the copies one by
+ *  one when there are many of them.
+ */
+extern DECLSPEC int SDLCALL SDL_RenderCopyMany(SDL_Renderer * renderer,
+                                               SDL_Texture * texture,
+                                               const SDL_RenderCopyData * copies,
+                                               int count);
+
 /**
  *  \brief Read pixels from the current rendering target.
  *
@@ -790,6 +1056,107 @@ extern DECLSPEC int SDLCALL SDL_RenderReadPixels(SDL_Renderer * renderer,
                                                  Uint32 format,
                                                  void *pixels, int pitch);
 
+/**
+ *  \brief A read of the rendering target that completes in the background.
+ *
+ *  \sa SDL_RenderReadPixelsAsync()
+ */
+struct SDL_RenderReadback;
+typedef struct SDL_RenderReadback SDL_RenderReadback;
+
+/**
+ *  \brief Start reading pixels from the current rendering target.
+ *
+ *  \param renderer The renderer from which pixels should be read.
+ *  \param rect   A pointer to the rectangle to read, or NULL for the entire
+ *                render target.  It is clipped to the viewport.
+ *  \param format The desired format of the pixel data, or 0 to use the format
+ *                of the rendering target
+ *
+ *  \return The pending read, or NULL if the rectangle is empty or there was
+ *          an error.
+ *
+ *  Where the driver supports it the pixels are copied from the graphics
+ *  card while rendering continues, so the read is ready a frame or two
+ *  later without stalling the renderer.  Flipping and converting them to
+ *  \c format is done on another thread.
+ *
+ *  \sa SDL_PollRenderReadback()
+ *  \sa SDL_WaitRenderReadback()
+ *  \sa SDL_FreeRenderReadback()
+ */
+extern DECLSPEC SDL_RenderReadback * SDLCALL SDL_RenderReadPixelsAsync(SDL_Renderer * renderer,
+                                                                       const SDL_Rect * rect,
+                                                                       Uint32 format);
+
+/**
+ *  \brief Check whether the pixels of a read are ready, without waiting.
+ *
+ *  \return 1 if the pixels are ready, 0 if they are still being read, or -1
+ *          if the read failed.
+ *
+ *  This should be called from the thread that renders, usually once a frame.
+ */
+extern DECLSPEC int SDLCALL SDL_PollRenderReadback(SDL_RenderReadback * readback);
+
+/**
+ *  \brief Wait for the pixels of a read to be ready.
+ *
+ *  \param readback The read to wait for.
+ *  \param pixels   Filled in with the pixel data, which belongs to the read.
+ *  \param pitch    Filled in with the pitch of the pixel data.
+ *
+ *  \return 0 on success, or -1 if the read failed.
+ */
+extern DECLSPEC int SDLCALL SDL_WaitRenderReadback(SDL_RenderReadback * readback,
+                                                   const void **pixels,
+                                                   int *pitch);
+
+/**
+ *  \brief Free a read and its pixel data, cancelling it if it's still pending.
+ *
+ *  Reads that are pending when their renderer is destroyed fail, but still
+ *  need to be freed.
+ */
+extern DECLSPEC void SDLCALL SDL_FreeRenderReadback(SDL_RenderReadback * readback);
+
+/**
+ *  \brief Send any batched drawing commands to the graphics driver.
+ *
+ *  \param renderer The renderer to flush.
+ *
+ *  \return 0 on success, or -1 if a batched command failed.
+ *
+ *  Rendering is flushed automatically when the screen is updated, the render
+ *  target changes or pixels are read, so this is only needed before making
+ *  graphics API calls directly, for example after SDL_GL_BindTexture().
+ *  The software renderer also finishes drawing its recorded tiles, so the
+ *  target surface is up to date when this returns.
+ *
+ *  \sa SDL_HINT_RENDER_BATCHING
+ *  \sa SDL_HINT_RENDER_SOFTWARE_THREADS
+ */
+extern DECLSPEC int SDLCALL SDL_RenderFlush(SDL_Renderer * renderer);
+
+/**
+ *  \brief Get the work a renderer sent to the graphics driver.
+ *
+ *  \param renderer The renderer to query.
+ *  \param current  Filled in with the work since the last SDL_RenderPresent(),
+ *                  may be NULL.
+ *  \param previous Filled in with the work of the last presented frame,
+ *                  may be NULL.
+ *
+ *  \return 0 on success, or -1 on error.
+ *
+ *  Batched draws are flushed first, so they are in the current counts.  State
+ *  that a draw would set to the value it already has isn't sent again, and
+ *  isn't counted.
+ */
+extern DECLSPEC int SDLCALL SDL_GetRenderStats(SDL_Renderer * renderer,
+                                               SDL_RenderStats * current,
+                                               SDL_RenderStats * previous);
+
 /**
  *  \brief Update the screen with rendering performed.
  */
@@ -807,6 +1174,9 @@ extern DECLSPEC void SDLCALL SDL_DestroyTexture(SDL_Texture * texture);
  *  \brief Destroy the rendering context for a window and free associated
  *         textures.
  *
+ *  Texture atlases of the renderer must still be freed with
+ *  SDL_DestroyTextureAtlas().
+ *
  *  \sa SDL_CreateRenderer()
  */
 extern DECLSPEC void SDLCALL SDL_DestroyRenderer(SDL_Renderer * renderer);
@@ -45,6 +45,8 @@ extern "C" {
 #define SDL_RWOPS_JNIFILE   3   /* Android asset */
 #define SDL_RWOPS_MEMORY    4   /* Memory stream */
 #define SDL_RWOPS_MEMORY_RO 5   /* Read-Only memory stream */
+#define SDL_RWOPS_MAPPED    6   /* Read-Only memory-mapped file */
+#define SDL_RWOPS_BUFFERED  7   /* Read-ahead buffer over another stream */
 
 /**
  * This is the read/write operation structure -- very basic.
@@ -134,6 +136,16 @@ typedef struct SDL_RWops
             Uint8 *stop;
         } mem;
         struct
+        {
+            /* These start out like mem, so SDL_RWgetc() can use either */
+            Uint8 *base;
+            Uint8 *here;
+            Uint8 *stop;
+            struct SDL_RWops *source;
+            Sint64 position;    /* Where base is in the source */
+            int freesrc;
+        } buffered;
+        struct
         {
             void *data1;
             void *data2;
@@ -165,6 +177,39 @@ extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromMem(void *mem, int size);
 extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromConstMem(const void *mem,
                                                       int size);
 
+/**
+ *  Open a file for reading by mapping it into memory, so that
+ *  SDL_RWGetBuffer() can hand its contents to a loader without copying.
+ *
+ *  Where the file can't be mapped (it isn't a regular file, or the
+ *  platform has no mmap()), this is the same as SDL_RWFromFile(file, "rb").
+ *
+ *  Loaders that take a file name, like SDL_LoadBMP(), open it with
+ *  SDL_RWFromFile().  To load from a mapping, pass the result of this to
+ *  their _RW versions instead.
+ *
+ *  \note The file must not be truncated while it is open, or reading
+ *        the missing part crashes the program.
+ */
+extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromMappedFile(const char *file);
+
+/**
+ *  Read ahead from another data source, so that it can be parsed a byte
+ *  at a time with SDL_RWgetc() and friends without a call per byte.
+ *
+ *  The new data source is read-only and starts at the current position of
+ *  \c src, which shouldn't be used until it is closed.  If \c src reads
+ *  from memory, the bytes are read from there without being copied.
+ *
+ *  \param src The data source to read from.
+ *  \param freesrc Non-zero to close \c src when the new data source is
+ *                 closed, zero to leave \c src where reading stopped.
+ *
+ *  \return The new data source, or NULL on error.
+ */
+extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromBufferedRW(SDL_RWops * src,
+                                                        int freesrc);
+
 /* @} *//* RWFrom functions */
 
 
@@ -189,6 +234,29 @@ extern DECLSPEC void SDLCALL SDL_FreeRW(SDL_RWops * area);
 #define SDL_RWclose(ctx)        (ctx)->close(ctx)
 /* @} *//* Read/write macros */
 
+/**
+ *  Get the bytes that \c context will read next, if it reads from memory
+ *  or from a memory-mapped file.
+ *
+ *  \param context The data source.
+ *  \param size If not NULL, filled in with the number of bytes left.
+ *
+ *  \return A pointer to the data at the current position, which stays
+ *          valid until \c context is closed, or NULL if the data source
+ *          doesn't read from memory.
+ */
+extern DECLSPEC const void *SDLCALL SDL_RWGetBuffer(SDL_RWops * context,
+                                                    size_t * size);
+
+/**
+ *  Read more into the buffer of a data source from SDL_RWFromBufferedRW()
+ *  if it is empty.
+ *
+ *  \return The number of bytes that can now be read from memory, or 0
+ *          at end of file or if \c context doesn't read from memory.
+ */
+extern DECLSPEC size_t SDLCALL SDL_RWFillBuffer(SDL_RWops * context);
+
 
 /**
  *  \name Read endian functions
@@ -205,6 +273,87 @@ extern DECLSPEC Uint64 SDLCALL SDL_ReadLE64(SDL_RWops * src);
 extern DECLSPEC Uint64 SDLCALL SDL_ReadBE64(SDL_RWops * src);
 /* @} *//* Read endian functions */
 
+/**
+ *  \name Inline read functions
+ *
+ *  Read a byte or an item of the specified endianness, straight from
+ *  memory if \c context reads from memory or from a buffer.  These are
+ *  for parsers that read a little at a time, best used on a data source
+ *  from SDL_RWFromBufferedRW().
+ */
+/* @{ */
+#define SDL_RWOPS_INMEMORY(ctx) \
+    ((ctx)->type - SDL_RWOPS_MEMORY <= SDL_RWOPS_BUFFERED - SDL_RWOPS_MEMORY)
+
+/**
+ *  \return The next byte, or -1 at end of file or on error.
+ */
+SDL_FORCE_INLINE int
+SDL_RWgetc(SDL_RWops * context)
+{
+    Uint8 value;
+
+    if (SDL_RWOPS_INMEMORY(context)) {
+        if (context->hidden.mem.here < context->hidden.mem.stop ||
+            SDL_RWFillBuffer(context) > 0) {
+            return *context->hidden.mem.here++;
+        }
+        return -1;
+    }
+    return SDL_RWread(context, &value, 1, 1) ? value : -1;
+}
+
+SDL_FORCE_INLINE Uint16
+SDL_RWgetLE16(SDL_RWops * context)
+{
+    if (SDL_RWOPS_INMEMORY(context) &&
+        context->hidden.mem.stop - context->hidden.mem.here >= 2) {
+        const Uint8 *p = context->hidden.mem.here;
+        context->hidden.mem.here += 2;
+        return (Uint16) (p[0] | (p[1] << 8));
+    }
+    return SDL_ReadLE16(context);
+}
+
+SDL_FORCE_INLINE Uint16
+SDL_RWgetBE16(SDL_RWops * context)
+{
+    if (SDL_RWOPS_INMEMORY(context) &&
+        context->hidden.mem.stop - context->hidden.mem.here >= 2) {
+        const Uint8 *p = context->hidden.mem.here;
+        context->hidden.mem.here += 2;
+        return (Uint16) ((p[0] << 8) | p[1]);
+    }
+    return SDL_ReadBE16(context);
+}
+
+SDL_FORCE_INLINE Uint32
+SDL_RWgetLE32(SDL_RWops * context)
+{
+    if (SDL_RWOPS_INMEMORY(context) &&
+        context->hidden.mem.stop - context->hidden.mem.here >= 4) {
+        const Uint8 *p = context->hidden.mem.here;
+        context->hidden.mem.here += 4;
+        return ((Uint32) p[0] | ((Uint32) p[1] << 8) |
+                ((Uint32) p[2] << 16) | ((Uint32) p[3] << 24));
+    }
+    return SDL_ReadLE32(context);
+}
+
+SDL_FORCE_INLINE Uint32
+SDL_RWgetBE32(SDL_RWops * context)
+{
+    if (SDL_RWOPS_INMEMORY(context) &&
+        context->hidden.mem.stop - context->hidden.mem.here >= 4) {
+        const Uint8 *p = context->hidden.mem.here;
+        context->hidden.mem.here += 4;
+        return (((Uint32) p[0] << 24) | ((Uint32) p[1] << 16) |
+                ((Uint32) p[2] << 8) | (Uint32) p[3]);
+    }
+    return SDL_ReadBE32(context);
+}
+/* @} *//* Inline read functions */
+
 /**
  *  \name Write endian functions
  *
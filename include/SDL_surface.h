@@ -53,6 +53,7 @@ extern "C" {
 #define SDL_PREALLOC        0x00000001  /**< Surface uses preallocated memory */
 #define SDL_RLEACCEL        0x00000002  /**< Surface is RLE encoded */
 #define SDL_DONTFREE        0x00000004  /**< Surface is referenced internally */
+#define SDL_TRACKDIRTY      0x00000008  /**< Surface records modified regions */
 /* @} *//* Surface flags */
 
 /**
@@ -159,6 +160,23 @@ extern DECLSPEC int SDLCALL SDL_SetSurfacePalette(SDL_Surface * surface,
  *  \sa SDL_UnlockSurface()
  */
 extern DECLSPEC int SDLCALL SDL_LockSurface(SDL_Surface * surface);
+
+/**
+ *  \brief Sets up a surface for changing the pixels in an area of it.
+ *
+ *  This works like SDL_LockSurface(), but tells SDL that only the pixels in
+ *  \c rect may be changed before the surface is unlocked, so an RLE
+ *  accelerated surface only has to re-encode that part.  Nested locks
+ *  accumulate their areas.  A NULL \c rect covers the whole surface.
+ *
+ *  \return 0, or -1 if the surface couldn't be locked.
+ *
+ *  \sa SDL_LockSurface()
+ *  \sa SDL_UnlockSurface()
+ */
+extern DECLSPEC int SDLCALL SDL_LockSurfaceRect(SDL_Surface * surface,
+                                                const SDL_Rect * rect);
+
 /** \sa SDL_LockSurface() */
 extern DECLSPEC void SDLCALL SDL_UnlockSurface(SDL_Surface * surface);
 
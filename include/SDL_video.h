@@ -707,6 +707,26 @@ extern DECLSPEC int SDLCALL SDL_UpdateWindowSurfaceRects(SDL_Window * window,
                                                          const SDL_Rect * rects,
                                                          int numrects);
 
+/**
+ *  \brief Get the regions of the window surface modified since the last
+ *         call to SDL_UpdateWindowSurface().
+ *
+ *  \param window The window to query.
+ *  \param rects Filled in with up to \c maxrects regions, or NULL.
+ *  \param maxrects The number of rectangles \c rects has room for.
+ *
+ *  \return The number of modified regions, or -1 if the window surface isn't
+ *          tracking them.
+ *
+ *  Regions are only tracked when SDL_HINT_FRAMEBUFFER_DIRTY_RECTS is set.
+ *  Overlapping and neighbouring changes are merged as they are recorded.
+ *
+ *  \sa SDL_UpdateWindowSurface()
+ */
+extern DECLSPEC int SDLCALL SDL_GetWindowSurfaceDirtyRects(SDL_Window * window,
+                                                           SDL_Rect * rects,
+                                                           int maxrects);
+
 /**
  *  \brief Set a window's input grab mode.
  *
@@ -27,6 +27,14 @@
 
 #include "SDL_image.h"
 
+#ifdef LOAD_WEBP
+/* For the WEBP_DECODER_ABI_VERSION that IMG_isWEBP() checks as well */
+#ifdef macintosh
+#define MACOS
+#endif
+#include <webp/decode.h>
+#endif
+
 #define ARRAYSIZE(a) (sizeof(a) / sizeof((a)[0]))
 
 /* Table of image detection and loading functions */
@@ -53,6 +61,38 @@ static struct {
 //     { "WEBP", IMG_isWEBP, IMG_LoadWEBP_RW },
 };
 
+/* Magic numbers at the start of each type of image, where '?' matches any
+   byte.  Types without any here, whose magic isn't at a fixed place or
+   isn't enough to tell, are detected with their IMG_is*() function.
+ */
+static const struct {
+    char *type;
+    int size;
+    const char *magic;
+} signatures[] = {
+    { "BMP", 2, "BM" },
+    { "GIF", 6, "GIF87a" },
+    { "GIF", 6, "GIF89a" },
+    { "LBM", 12, "FORM????PBM " },
+    { "LBM", 12, "FORM????ILBM" },
+    { "PNG", 4, "\x89PNG" },
+    { "PNM", 2, "P1" },
+    { "PNM", 2, "P2" },
+    { "PNM", 2, "P3" },
+    { "PNM", 2, "P4" },
+    { "PNM", 2, "P5" },
+    { "PNM", 2, "P6" },
+    { "TIF", 4, "II\x2a\0" },
+    { "TIF", 4, "MM\0\x2a" },
+    { "XCF", 14, "gimp xcf ?????" },
+    { "XPM", 9, "/* XPM */" },
+    { "WEBP", 20, "RIFF????WEBPVP8 ????" },
+#if defined(LOAD_WEBP) && WEBP_DECODER_ABI_VERSION >= 0x0003 /* old versions don't support WEBPVP8X and WEBPVP8L */
+    { "WEBP", 20, "RIFF????WEBPVP8X????" },
+    { "WEBP", 20, "RIFF????WEBPVP8L????" },
+#endif
+};
+
 const SDL_version *IMG_Linked_Version(void)
 {
     static SDL_version linked_version;
@@ -70,6 +110,10 @@ extern void IMG_QuitPNG();
 // extern int IMG_InitWEBP();
 // extern void IMG_QuitWEBP();
 
+#if SDL_VERSION_ATLEAST(2,0,0)
+extern void IMG_QuitAsync(void);
+#endif
+
 static int initialized = 0;
 
 int IMG_Init(int flags)
@@ -96,13 +140,20 @@ int IMG_Init(int flags)
 //             result |= IMG_INIT_WEBP;
 //         }
 //     }
-    initialized |= result;
+    /* Loaders on the worker threads check this at the same time */
+    if ( result & ~initialized ) {
+        initialized |= result;
+    }
 
     return (initialized);
 }
 
 void IMG_Quit()
 {
+#if SDL_VERSION_ATLEAST(2,0,0)
+    /* The worker threads may still be using the libraries */
+    IMG_QuitAsync();
+#endif
 //     if (initialized & IMG_INIT_JPG) {
 //         IMG_QuitJPG();
 //     }
@@ -154,10 +205,44 @@ static int IMG_string_equals(const char *str1, const char *str2)
     return (!*str1 && !*str2);
 }
 
+/* See if the header matches the signatures of a type of image.
+   Returns 1 or 0, or -1 if the type has no signatures.
+ */
+static int IMG_MatchSignature(const char *type, const Uint8 *header, int size)
+{
+    int i, j;
+    int found = -1;
+
+    for ( i=0; i < ARRAYSIZE(signatures); ++i ) {
+        if ( SDL_strcmp(signatures[i].type, type) != 0 )
+            continue;
+        found = 0;
+        if ( size < signatures[i].size )
+            continue;
+        for ( j=0; j < signatures[i].size; ++j ) {
+            if ( signatures[i].magic[j] != '?' &&
+                 (Uint8)signatures[i].magic[j] != header[j] )
+                break;
+        }
+        if ( j == signatures[i].size )
+            return 1;
+    }
+    return found;
+}
+
 /* Load an image from an SDL datasource, optionally specifying the type */
 SDL_Surface *IMG_LoadTyped_RW(SDL_RWops *src, int freesrc, const char *type)
 {
-    int i;
+    return IMG_LoadTypedHeader_RW(src, freesrc, type, NULL, 0);
+}
+
+/* Load an image from an SDL datasource whose header has been read */
+SDL_Surface *IMG_LoadTypedHeader_RW(SDL_RWops *src, int freesrc, const char *type,
+                                    const void *header, int size)
+{
+    int i, match;
+    Sint64 start;
+    Uint8 buffer[IMG_HEADER_SIZE];
     SDL_Surface *image;
 
     /* Make sure there is something to do.. */
@@ -167,17 +252,36 @@ SDL_Surface *IMG_LoadTyped_RW(SDL_RWops *src, int freesrc, const char *type)
     }
 
     /* See whether or not this data source can handle seeking */
-    if ( SDL_RWseek(src, 0, RW_SEEK_CUR) < 0 ) {
+    start = SDL_RWseek(src, 0, RW_SEEK_CUR);
+    if ( start < 0 ) {
         IMG_SetError("Can't seek in this data source");
         if(freesrc)
             SDL_RWclose(src);
         return(NULL);
     }
 
+    /* Read the header once, for all the signatures, unless it's in memory */
+    if ( header == NULL || size < IMG_HEADER_SIZE ) {
+        size_t available;
+
+        header = SDL_RWGetBuffer(src, &available);
+        if ( header ) {
+            size = (int)SDL_min(available, IMG_HEADER_SIZE);
+        } else {
+            size = (int)SDL_RWread(src, buffer, 1, sizeof(buffer));
+            SDL_RWseek(src, start, RW_SEEK_SET);
+            header = buffer;
+        }
+    }
+
     /* Detect the type of image being loaded */
     image = NULL;
     for ( i=0; i < ARRAYSIZE(supported); ++i ) {
-        if(supported[i].is) {
+        match = IMG_MatchSignature(supported[i].type, (const Uint8 *)header, size);
+        if(match >= 0) {
+            if(!match)
+                continue;
+        } else if(supported[i].is) {
             if(!supported[i].is(src))
                 continue;
         } else {
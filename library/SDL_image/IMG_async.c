@@ -0,0 +1,407 @@
+/*
+  SDL_image:  An example image loading library for use with SDL
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* Loading images on a pool of worker threads */
+
+#include "SDL_image.h"
+
+#if SDL_VERSION_ATLEAST(2,0,0)
+
+typedef enum {
+    IMG_ASYNC_QUEUED,
+    IMG_ASYNC_LOADING,
+    IMG_ASYNC_DONE
+} IMG_AsyncStatus;
+
+struct _IMG_AsyncLoad {
+    /* What to load: a file, or a data source and an optional type */
+    char *file;
+    SDL_RWops *src;
+    int freesrc;
+    char *type;
+
+    /* The event to push when the load is done, or 0 */
+    Uint32 event;
+
+    /* Guarded by the pool lock */
+    IMG_AsyncStatus status;
+    SDL_Surface *image;
+    char *error;
+    struct _IMG_AsyncLoad *next;
+};
+
+typedef struct {
+    SDL_mutex *lock;
+    SDL_cond *wake;             /* Signalled when a load is queued */
+    SDL_cond *done;             /* Broadcast when a load is done */
+    IMG_AsyncLoad *head;
+    IMG_AsyncLoad *tail;
+    SDL_Thread **threads;
+    int num_threads;
+    SDL_bool quit;
+} IMG_AsyncPool;
+
+static IMG_AsyncPool *pool = NULL;
+static Uint32 async_event = 0;
+
+/* Decode an image, on a worker thread or the thread waiting for it */
+static void IMG_RunAsyncLoad(IMG_AsyncLoad *load)
+{
+    const Uint32 event_type = load->event;
+    SDL_Surface *image;
+    char *error = NULL;
+
+    if ( load->file ) {
+        image = IMG_Load(load->file);
+    } else {
+        image = IMG_LoadTyped_RW(load->src, load->freesrc, load->type);
+    }
+
+    /* The error is per thread, so keep it for the one finishing the load */
+    if ( !image ) {
+        error = SDL_strdup(IMG_GetError());
+    }
+
+    /* The event goes out first, since the load may be finished and freed
+       as soon as it's marked done.
+     */
+    if ( event_type ) {
+        SDL_Event event;
+
+        SDL_zero(event);
+        event.type = event_type;
+        event.user.code = image ? 0 : -1;
+        event.user.data1 = load;
+        SDL_PushEvent(&event);
+    }
+
+    SDL_LockMutex(pool->lock);
+    load->image = image;
+    load->error = error;
+    load->status = IMG_ASYNC_DONE;
+    SDL_CondBroadcast(pool->done);
+    SDL_UnlockMutex(pool->lock);
+}
+
+/* Drop the event of a load finished before the event was handled */
+static int SDLCALL IMG_DropAsyncEvent(void *userdata, SDL_Event *event)
+{
+    IMG_AsyncLoad *load = (IMG_AsyncLoad *)userdata;
+
+    return !(event->type == load->event && event->user.data1 == load);
+}
+
+static int SDLCALL IMG_AsyncThread(void *data)
+{
+    SDL_LockMutex(pool->lock);
+    for ( ; ; ) {
+        IMG_AsyncLoad *load;
+
+        while ( !pool->head && !pool->quit ) {
+            SDL_CondWait(pool->wake, pool->lock);
+        }
+        if ( !pool->head ) {
+            break;
+        }
+        load = pool->head;
+        pool->head = load->next;
+        if ( !pool->head ) {
+            pool->tail = NULL;
+        }
+        load->status = IMG_ASYNC_LOADING;
+        SDL_UnlockMutex(pool->lock);
+
+        IMG_RunAsyncLoad(load);
+
+        SDL_LockMutex(pool->lock);
+    }
+    SDL_UnlockMutex(pool->lock);
+    return 0;
+}
+
+/* Finish the queued loads and stop the worker threads */
+void IMG_QuitAsync(void)
+{
+    int i;
+
+    if ( !pool ) {
+        return;
+    }
+    if ( pool->lock ) {
+        SDL_LockMutex(pool->lock);
+        pool->quit = SDL_TRUE;
+        SDL_CondBroadcast(pool->wake);
+        SDL_UnlockMutex(pool->lock);
+    }
+    for ( i = 0; i < pool->num_threads; ++i ) {
+        SDL_WaitThread(pool->threads[i], NULL);
+    }
+    if ( pool->lock ) {
+        SDL_DestroyMutex(pool->lock);
+    }
+    if ( pool->wake ) {
+        SDL_DestroyCond(pool->wake);
+    }
+    if ( pool->done ) {
+        SDL_DestroyCond(pool->done);
+    }
+    SDL_free(pool->threads);
+    SDL_free(pool);
+    pool = NULL;
+}
+
+/* Start one worker thread per CPU core, the first time they're needed */
+static int IMG_InitAsync(void)
+{
+    int i, count;
+
+    if ( pool ) {
+        return 0;
+    }
+
+    pool = (IMG_AsyncPool *)SDL_calloc(1, sizeof(*pool));
+    if ( !pool ) {
+        SDL_OutOfMemory();
+        return -1;
+    }
+    count = SDL_max(SDL_GetCPUCount(), 1);
+    pool->lock = SDL_CreateMutex();
+    pool->wake = SDL_CreateCond();
+    pool->done = SDL_CreateCond();
+    pool->threads = (SDL_Thread **)SDL_calloc(count, sizeof(*pool->threads));
+    if ( !pool->lock || !pool->wake || !pool->done || !pool->threads ) {
+        IMG_QuitAsync();
+        SDL_OutOfMemory();
+        return -1;
+    }
+
+    /* The loaders initialize their libraries on first use, which isn't
+       safe to do from several threads at once, so do it here.
+     */
+    IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG | IMG_INIT_TIF | IMG_INIT_WEBP);
+
+    for ( i = 0; i < count; ++i ) {
+        pool->threads[i] = SDL_CreateThread(IMG_AsyncThread, "SDL_image", NULL);
+        if ( !pool->threads[i] ) {
+            break;
+        }
+        ++pool->num_threads;
+    }
+    if ( pool->num_threads == 0 ) {
+        IMG_QuitAsync();
+        return -1;
+    }
+    return 0;
+}
+
+static IMG_AsyncLoad *IMG_QueueAsyncLoad(IMG_AsyncLoad *load, Uint32 event)
+{
+    if ( IMG_InitAsync() < 0 ) {
+        return NULL;
+    }
+    load->event = event;
+    load->status = IMG_ASYNC_QUEUED;
+
+    SDL_LockMutex(pool->lock);
+    if ( pool->tail ) {
+        pool->tail->next = load;
+    } else {
+        pool->head = load;
+    }
+    pool->tail = load;
+    SDL_CondSignal(pool->wake);
+    SDL_UnlockMutex(pool->lock);
+    return load;
+}
+
+static IMG_AsyncLoad *IMG_CreateAsyncLoad(const char *file, SDL_RWops *src,
+                                          int freesrc, const char *type)
+{
+    IMG_AsyncLoad *load;
+
+    load = (IMG_AsyncLoad *)SDL_calloc(1, sizeof(*load));
+    if ( !load ) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    if ( file ) {
+        load->file = SDL_strdup(file);
+    }
+    if ( type ) {
+        load->type = SDL_strdup(type);
+    }
+    if ( (file && !load->file) || (type && !load->type) ) {
+        SDL_free(load->file);
+        SDL_free(load->type);
+        SDL_free(load);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    load->src = src;
+    load->freesrc = freesrc;
+    return load;
+}
+
+static void IMG_FreeAsyncLoad(IMG_AsyncLoad *load)
+{
+    SDL_free(load->file);
+    SDL_free(load->type);
+    SDL_free(load->error);
+    SDL_free(load);
+}
+
+IMG_AsyncLoad *IMG_LoadAsync(const char *file)
+{
+    IMG_AsyncLoad *load;
+
+    if ( !file ) {
+        IMG_SetError("Passed a NULL file name");
+        return NULL;
+    }
+    load = IMG_CreateAsyncLoad(file, NULL, 0, NULL);
+    if ( load && !IMG_QueueAsyncLoad(load, async_event) ) {
+        IMG_FreeAsyncLoad(load);
+        return NULL;
+    }
+    return load;
+}
+
+IMG_AsyncLoad *IMG_LoadTypedAsync_RW(SDL_RWops *src, int freesrc, const char *type)
+{
+    IMG_AsyncLoad *load;
+
+    if ( !src ) {
+        IMG_SetError("Passed a NULL data source");
+        return NULL;
+    }
+    load = IMG_CreateAsyncLoad(NULL, src, freesrc, type);
+    if ( load && !IMG_QueueAsyncLoad(load, async_event) ) {
+        IMG_FreeAsyncLoad(load);
+        load = NULL;
+    }
+    if ( !load && freesrc ) {
+        SDL_RWclose(src);
+    }
+    return load;
+}
+
+int IMG_AsyncLoadDone(IMG_AsyncLoad *load)
+{
+    int done;
+
+    if ( !load || !pool ) {
+        return 1;
+    }
+    SDL_LockMutex(pool->lock);
+    done = (load->status == IMG_ASYNC_DONE);
+    SDL_UnlockMutex(pool->lock);
+    return done;
+}
+
+SDL_Surface *IMG_FinishAsyncLoad(IMG_AsyncLoad *load)
+{
+    SDL_Surface *image;
+    IMG_AsyncLoad **prev;
+
+    if ( !load ) {
+        IMG_SetError("Passed a NULL load");
+        return NULL;
+    }
+
+    /* The pool is only gone once every load is done */
+    if ( pool ) {
+        SDL_LockMutex(pool->lock);
+        if ( load->status == IMG_ASYNC_QUEUED ) {
+            /* Nobody has started on it, so load it here instead of waiting */
+            IMG_AsyncLoad *last = NULL;
+
+            for ( prev = &pool->head; *prev != load; prev = &(*prev)->next ) {
+                last = *prev;
+            }
+            *prev = load->next;
+            if ( pool->tail == load ) {
+                pool->tail = last;
+            }
+            load->status = IMG_ASYNC_LOADING;
+            load->event = 0;
+            SDL_UnlockMutex(pool->lock);
+
+            IMG_RunAsyncLoad(load);
+        } else {
+            while ( load->status != IMG_ASYNC_DONE ) {
+                SDL_CondWait(pool->done, pool->lock);
+            }
+            SDL_UnlockMutex(pool->lock);
+        }
+    }
+    if ( load->event ) {
+        SDL_FilterEvents(IMG_DropAsyncEvent, load);
+    }
+
+    image = load->image;
+    if ( !image ) {
+        IMG_SetError("%s", load->error ? load->error : "Out of memory");
+    }
+    IMG_FreeAsyncLoad(load);
+    return image;
+}
+
+void IMG_SetAsyncLoadEvent(Uint32 type)
+{
+    async_event = type;
+}
+
+int IMG_LoadBatch(const char **files, int count, SDL_Surface **surfaces)
+{
+    IMG_AsyncLoad **loads;
+    int i, loaded = 0;
+
+    if ( count <= 0 ) {
+        return 0;
+    }
+    loads = (IMG_AsyncLoad **)SDL_malloc(count * sizeof(*loads));
+    if ( !loads ) {
+        SDL_OutOfMemory();
+        return -1;
+    }
+
+    /* Queue them all, and then help with the ones not started yet */
+    for ( i = 0; i < count; ++i ) {
+        loads[i] = IMG_CreateAsyncLoad(files[i], NULL, 0, NULL);
+        if ( loads[i] && !IMG_QueueAsyncLoad(loads[i], 0) ) {
+            IMG_FreeAsyncLoad(loads[i]);
+            loads[i] = NULL;
+        }
+    }
+    for ( i = 0; i < count; ++i ) {
+        surfaces[i] = NULL;
+        if ( loads[i] ) {
+            surfaces[i] = IMG_FinishAsyncLoad(loads[i]);
+        }
+        if ( surfaces[i] ) {
+            ++loaded;
+        }
+    }
+    SDL_free(loads);
+    return loaded;
+}
+
+#endif /* SDL 2.0 */
@@ -116,18 +116,27 @@ static int readRlePixels(SDL_Surface * surface, SDL_RWops * src, int isRle8)
     int ofs = 0;
     Uint8 ch;
     Uint8 needsPad;
+    const Uint8 *data, *here, *stop;
+    size_t size;
+
+    /* Walk the data in place if the source is in memory */
+    data = (const Uint8 *)SDL_RWGetBuffer(src, &size);
+    here = data;
+    stop = data ? data + size : NULL;
 
 #define COPY_PIXEL(x)   spot = &bits[ofs++]; if(spot >= start && spot < end) *spot = (x)
+#define READ_BYTE(x)    if ( data ) { if ( here == stop ) return 1; (x) = *here++; } \
+                        else if ( !SDL_RWread(src, &(x), 1, 1) ) return 1
 
     for (;;) {
-        if ( !SDL_RWread(src, &ch, 1, 1) ) return 1;
+        READ_BYTE(ch);
         /*
         | encoded mode starts with a run length, and then a byte
         | with two colour indexes to alternate between for the run
         */
         if ( ch ) {
             Uint8 pixel;
-            if ( !SDL_RWread(src, &pixel, 1, 1) ) return 1;
+            READ_BYTE(pixel);
             if ( isRle8 ) {                 /* 256-color bitmap, compressed */
                 do {
                     COPY_PIXEL(pixel);
@@ -148,18 +157,21 @@ static int readRlePixels(SDL_Surface * surface, SDL_RWops * src, int isRle8)
             | a cursor move, or some absolute data.
             | zero tag may be absolute mode or an escape
             */
-            if ( !SDL_RWread(src, &ch, 1, 1) ) return 1;
+            READ_BYTE(ch);
             switch (ch) {
             case 0:                         /* end of line */
                 ofs = 0;
                 bits -= pitch;               /* go to previous */
                 break;
             case 1:                         /* end of bitmap */
+                if ( data ) {
+                    SDL_RWseek(src, here - data, RW_SEEK_CUR);
+                }
                 return 0;                    /* success! */
             case 2:                         /* delta */
-                if ( !SDL_RWread(src, &ch, 1, 1) ) return 1;
+                READ_BYTE(ch);
                 ofs += ch;
-                if ( !SDL_RWread(src, &ch, 1, 1) ) return 1;
+                READ_BYTE(ch);
                 bits -= (ch * pitch);
                 break;
             default:                        /* no compression */
@@ -167,14 +179,14 @@ static int readRlePixels(SDL_Surface * surface, SDL_RWops * src, int isRle8)
                     needsPad = ( ch & 1 );
                     do {
                         Uint8 pixel;
-                        if ( !SDL_RWread(src, &pixel, 1, 1) ) return 1;
+                        READ_BYTE(pixel);
                         COPY_PIXEL(pixel);
                     } while (--ch);
                 } else {
                     needsPad = ( ((ch+1)>>1) & 1 ); /* (ch+1)>>1: bytes size */
                     for (;;) {
                         Uint8 pixel;
-                        if ( !SDL_RWread(src, &pixel, 1, 1) ) return 1;
+                        READ_BYTE(pixel);
                         COPY_PIXEL(pixel >> 4);
                         if (!--ch) break;
                         COPY_PIXEL(pixel & 0x0F);
@@ -182,7 +194,9 @@ static int readRlePixels(SDL_Surface * surface, SDL_RWops * src, int isRle8)
                     }
                 }
                 /* pad at even boundary */
-                if ( needsPad && !SDL_RWread(src, &ch, 1, 1) ) return 1;
+                if ( needsPad ) {
+                    READ_BYTE(ch);
+                }
                 break;
             }
         }
@@ -521,10 +535,7 @@ static SDL_Surface *LoadBMP_RW (SDL_RWops *src, int freesrc)
         }
         /* Skip padding bytes, ugh */
         if ( pad ) {
-            Uint8 padbyte;
-            for ( i=0; i<pad; ++i ) {
-                SDL_RWread(src, &padbyte, 1, 1);
-            }
+            SDL_RWseek(src, pad, RW_SEEK_CUR);
         }
         if ( topDown ) {
             bits += surface->pitch;
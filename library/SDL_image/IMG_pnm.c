@@ -70,20 +70,22 @@ int IMG_isPNM(SDL_RWops *src)
 static int ReadNumber(SDL_RWops *src)
 {
     int number;
-    unsigned char ch;
+    int ch;
 
     /* Initialize return value */
     number = 0;
 
     /* Skip leading whitespace */
     do {
-        if ( ! SDL_RWread(src, &ch, 1, 1) ) {
+        ch = SDL_RWgetc(src);
+        if ( ch < 0 ) {
             return(0);
         }
         /* Eat comments as whitespace */
         if ( ch == '#' ) {  /* Comment is '#' to end of line */
             do {
-                if ( ! SDL_RWread(src, &ch, 1, 1) ) {
+                ch = SDL_RWgetc(src);
+                if ( ch < 0 ) {
                     return -1;
                 }
             } while ( (ch != '\r') && (ch != '\n') );
@@ -95,7 +97,8 @@ static int ReadNumber(SDL_RWops *src)
         number *= 10;
         number += ch-'0';
 
-        if ( !SDL_RWread(src, &ch, 1, 1) ) {
+        ch = SDL_RWgetc(src);
+        if ( ch < 0 ) {
             return -1;
         }
     } while ( isdigit(ch) );
@@ -106,6 +109,7 @@ static int ReadNumber(SDL_RWops *src)
 SDL_Surface *IMG_LoadPNM_RW(SDL_RWops *src)
 {
     Sint64 start;
+    SDL_RWops *in;
     SDL_Surface *surface = NULL;
     int width, height;
     int maxval, y, bpl;
@@ -124,7 +128,13 @@ SDL_Surface *IMG_LoadPNM_RW(SDL_RWops *src)
     }
     start = SDL_RWtell(src);
 
-    SDL_RWread(src, magic, 2, 1);
+    /* The header and ASCII formats are parsed a character at a time */
+    in = SDL_RWFromBufferedRW(src, 0);
+    if ( in == NULL ) {
+        return NULL;
+    }
+
+    SDL_RWread(in, magic, 2, 1);
     kind = magic[1] - '1';
     ascii = 1;
     if(kind >= 3) {
@@ -132,13 +142,13 @@ SDL_Surface *IMG_LoadPNM_RW(SDL_RWops *src)
         kind -= 3;
     }
 
-    width = ReadNumber(src);
-    height = ReadNumber(src);
+    width = ReadNumber(in);
+    height = ReadNumber(in);
     if(width <= 0 || height <= 0)
         ERROR("Unable to read image width and height");
 
     if(kind != PBM) {
-        maxval = ReadNumber(src);
+        maxval = ReadNumber(in);
         if(maxval <= 0 || maxval > 255)
             ERROR("unsupported PNM format");
     } else
@@ -191,17 +201,17 @@ SDL_Surface *IMG_LoadPNM_RW(SDL_RWops *src)
                 for(i = 0; i < width; i++) {
                     Uint8 ch;
                     do {
-                        if(!SDL_RWread(src, &ch,
-                                   1, 1))
+                        int c = SDL_RWgetc(in);
+                        if(c < 0)
                                ERROR("file truncated");
-                        ch -= '0';
+                        ch = c - '0';
                     } while(ch > 1);
                     row[i] = ch;
                 }
             } else {
                 for(i = 0; i < bpl; i++) {
                     int c;
-                    c = ReadNumber(src);
+                    c = ReadNumber(in);
                     if(c < 0)
                         ERROR("file truncated");
                     row[i] = c;
@@ -209,7 +219,7 @@ SDL_Surface *IMG_LoadPNM_RW(SDL_RWops *src)
             }
         } else {
             Uint8 *dst = (kind == PBM) ? buf : row;
-            if(!SDL_RWread(src, dst, bpl, 1))
+            if(!SDL_RWread(in, dst, bpl, 1))
                 ERROR("file truncated");
             if(kind == PBM) {
                 /* expand bitmap to 8bpp */
@@ -230,6 +240,7 @@ SDL_Surface *IMG_LoadPNM_RW(SDL_RWops *src)
     }
 done:
     SDL_free(buf);
+    SDL_RWclose(in);
     if(error) {
         SDL_RWseek(src, start, RW_SEEK_SET);
         if ( surface ) {
@@ -88,6 +88,7 @@ enum tga_type {
 SDL_Surface *IMG_LoadTGA_RW(SDL_RWops *src)
 {
     Sint64 start;
+    SDL_RWops *in;
     const char *error = NULL;
     struct TGAheader hdr;
     int rle = 0;
@@ -111,7 +112,13 @@ SDL_Surface *IMG_LoadTGA_RW(SDL_RWops *src)
     }
     start = SDL_RWtell(src);
 
-    if(!SDL_RWread(src, &hdr, sizeof(hdr), 1)) {
+    /* RLE packets are read a byte and a pixel at a time */
+    in = SDL_RWFromBufferedRW(src, 0);
+    if ( !in ) {
+        return NULL;
+    }
+
+    if(!SDL_RWread(in, &hdr, sizeof(hdr), 1)) {
         error = "Error reading TGA data";
     goto error;
     }
@@ -194,7 +201,7 @@ SDL_Surface *IMG_LoadTGA_RW(SDL_RWops *src)
         goto unsupported;
     }
 
-    SDL_RWseek(src, hdr.infolen, RW_SEEK_CUR); /* skip info field */
+    SDL_RWseek(in, hdr.infolen, RW_SEEK_CUR); /* skip info field */
 
     w = LE16(hdr.width);
     h = LE16(hdr.height);
@@ -212,7 +219,7 @@ SDL_Surface *IMG_LoadTGA_RW(SDL_RWops *src)
         Uint8 *pal = (Uint8 *)SDL_malloc(palsiz), *p = pal;
         SDL_Color *colors = img->format->palette->colors;
         img->format->palette->ncolors = ncols;
-        SDL_RWread(src, pal, palsiz, 1);
+        SDL_RWread(in, pal, palsiz, 1);
         for(i = 0; i < ncols; i++) {
         switch(hdr.cmap_bits) {
         case 15:
@@ -240,7 +247,7 @@ SDL_Surface *IMG_LoadTGA_RW(SDL_RWops *src)
         SDL_SetColorKey(img, SDL_TRUE, ckey);
     } else {
         /* skip unneeded colormap */
-        SDL_RWseek(src, palsiz, RW_SEEK_CUR);
+        SDL_RWseek(in, palsiz, RW_SEEK_CUR);
     }
     }
 
@@ -266,13 +273,13 @@ SDL_Surface *IMG_LoadTGA_RW(SDL_RWops *src)
     if(rle) {
         int x = 0;
         for(;;) {
-        Uint8 c;
+        int c;
 
         if(count) {
             int n = count;
             if(n > w - x)
             n = w - x;
-            SDL_RWread(src, dst + x * bpp, n * bpp, 1);
+            SDL_RWread(in, dst + x * bpp, n * bpp, 1);
             count -= n;
             x += n;
             if(x == w)
@@ -290,9 +297,13 @@ SDL_Surface *IMG_LoadTGA_RW(SDL_RWops *src)
             break;
         }
 
-        SDL_RWread(src, &c, 1, 1);
+        c = SDL_RWgetc(in);
+        if(c < 0) {
+            error = "Error reading TGA data";
+            goto error;
+        }
         if(c & 0x80) {
-            SDL_RWread(src, &pixel, bpp, 1);
+            SDL_RWread(in, &pixel, bpp, 1);
             rep = (c & 0x7f) + 1;
         } else {
             count = c + 1;
@@ -300,7 +311,7 @@ SDL_Surface *IMG_LoadTGA_RW(SDL_RWops *src)
         }
 
     } else {
-        SDL_RWread(src, dst, w * bpp, 1);
+        SDL_RWread(in, dst, w * bpp, 1);
     }
 #if SDL_BYTEORDER == SDL_LIL_ENDIAN
     if (bpp == 2) {
@@ -313,12 +324,14 @@ SDL_Surface *IMG_LoadTGA_RW(SDL_RWops *src)
 #endif
     dst += lstep;
     }
+    SDL_RWclose(in);
     return img;
 
 unsupported:
     error = "Unsupported TGA format";
 
 error:
+    SDL_RWclose(in);
     SDL_RWseek(src, start, RW_SEEK_SET);
     if ( img ) {
         SDL_FreeSurface(img);
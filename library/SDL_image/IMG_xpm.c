@@ -905,71 +905,77 @@ static int color_to_rgb(char *spec, int speclen, Uint32 *rgb)
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #endif
 
-static char *linebuf;
-static int buflen;
-static char *error;
+/* The line buffer and error of one load, so images can load on several
+   threads */
+struct line_reader {
+    char *linebuf;
+    int buflen;
+    char *error;
+};
 
 /*
  * Read next line from the source.
  * If len > 0, it's assumed to be at least len chars (for efficiency).
  * Return NULL and set error upon EOF or parse error.
  */
-static char *get_next_line(char ***lines, SDL_RWops *src, int len)
+static char *get_next_line(char ***lines, SDL_RWops *src, int len,
+                           struct line_reader *reader)
 {
     char *linebufnew;
 
     if(lines) {
         return *(*lines)++;
     } else {
-        char c;
+        int c;
         int n;
         do {
-            if(SDL_RWread(src, &c, 1, 1) <= 0) {
-                error = "Premature end of data";
+            c = SDL_RWgetc(src);
+            if(c < 0) {
+                reader->error = "Premature end of data";
                 return NULL;
             }
         } while(c != '"');
         if(len) {
             len += 4;   /* "\",\n\0" */
-            if(len > buflen){
-                buflen = len;
-                linebufnew = (char *)SDL_realloc(linebuf, buflen);
+            if(len > reader->buflen){
+                reader->buflen = len;
+                linebufnew = (char *)SDL_realloc(reader->linebuf, reader->buflen);
                 if(!linebufnew) {
-                    SDL_free(linebuf);
-                    error = "Out of memory";
+                    reader->error = "Out of memory";
                     return NULL;
                 }
-                linebuf = linebufnew;
+                reader->linebuf = linebufnew;
             }
-            if(SDL_RWread(src, linebuf, len - 1, 1) <= 0) {
-                error = "Premature end of data";
+            if(SDL_RWread(src, reader->linebuf, len - 1, 1) <= 0) {
+                reader->error = "Premature end of data";
                 return NULL;
             }
             n = len - 2;
         } else {
             n = 0;
             do {
-                if(n >= buflen - 1) {
-                    if(buflen == 0)
-                        buflen = 16;
-                    buflen *= 2;
-                    linebufnew = (char *)SDL_realloc(linebuf, buflen);
+                if(n >= reader->buflen - 1) {
+                    if(reader->buflen == 0)
+                        reader->buflen = 16;
+                    reader->buflen *= 2;
+                    linebufnew = (char *)SDL_realloc(reader->linebuf, reader->buflen);
                     if(!linebufnew) {
-                        SDL_free(linebuf);
-                        error = "Out of memory";
+                        reader->error = "Out of memory";
                         return NULL;
                     }
-                    linebuf = linebufnew;
+                    reader->linebuf = linebufnew;
                 }
-                if(SDL_RWread(src, linebuf + n, 1, 1) <= 0) {
-                    error = "Premature end of data";
+                c = SDL_RWgetc(src);
+                if(c < 0) {
+                    reader->error = "Premature end of data";
                     return NULL;
                 }
-            } while(linebuf[n++] != '"');
+                reader->linebuf[n] = (char)c;
+            } while(reader->linebuf[n++] != '"');
             n--;
         }
-        linebuf[n] = '\0';
-        return linebuf;
+        reader->linebuf[n] = '\0';
+        return reader->linebuf;
     }
 }
 
@@ -989,6 +995,7 @@ do {                            \
 static SDL_Surface *load_xpm(char **xpm, SDL_RWops *src)
 {
     Sint64 start = 0;
+    SDL_RWops *in = NULL;
     SDL_Surface *image = NULL;
     int index;
     int x, y;
@@ -1001,18 +1008,24 @@ static SDL_Surface *load_xpm(char **xpm, SDL_RWops *src)
     char *line;
     char ***xpmlines = NULL;
     int pixels_len;
+    struct line_reader reader;
 
-    error = NULL;
-    linebuf = NULL;
-    buflen = 0;
+    reader.error = NULL;
+    reader.linebuf = NULL;
+    reader.buflen = 0;
 
-    if ( src )
+    if ( src ) {
         start = SDL_RWtell(src);
+        /* The lines are read a character at a time */
+        in = SDL_RWFromBufferedRW(src, 0);
+        if ( !in )
+            return NULL;
+    }
 
     if(xpm)
         xpmlines = &xpm;
 
-    line = get_next_line(xpmlines, src, 0);
+    line = get_next_line(xpmlines, in, 0, &reader);
     if(!line)
         goto done;
     /*
@@ -1026,13 +1039,13 @@ static SDL_Surface *load_xpm(char **xpm, SDL_RWops *src)
      */
     if(SDL_sscanf(line, "%d %d %d %d", &w, &h, &ncolors, &cpp) != 4
        || w <= 0 || h <= 0 || ncolors <= 0 || cpp <= 0) {
-        error = "Invalid format description";
+        reader.error = "Invalid format description";
         goto done;
     }
 
     keystrings = (char *)SDL_malloc(ncolors * cpp);
     if(!keystrings) {
-        error = "Out of memory";
+        reader.error = "Out of memory";
         goto done;
     }
     nextkey = keystrings;
@@ -1057,12 +1070,12 @@ static SDL_Surface *load_xpm(char **xpm, SDL_RWops *src)
     /* Read the colors */
     colors = create_colorhash(ncolors);
     if (!colors) {
-        error = "Out of memory";
+        reader.error = "Out of memory";
         goto done;
     }
     for(index = 0; index < ncolors; ++index ) {
         char *p;
-        line = get_next_line(xpmlines, src, 0);
+        line = get_next_line(xpmlines, in, 0, &reader);
         if(!line)
             goto done;
 
@@ -1076,7 +1089,7 @@ static SDL_Surface *load_xpm(char **xpm, SDL_RWops *src)
 
             SKIPSPACE(p);
             if(!*p) {
-                error = "colour parse error";
+                reader.error = "colour parse error";
                 goto done;
             }
             nametype = *p;
@@ -1111,7 +1124,9 @@ static SDL_Surface *load_xpm(char **xpm, SDL_RWops *src)
     pixels_len = w * cpp;
     dst = (Uint8 *)image->pixels;
     for(y = 0; y < h; y++) {
-        line = get_next_line(xpmlines, src, pixels_len);
+        line = get_next_line(xpmlines, in, pixels_len, &reader);
+        if(!line)
+            goto done;
         if(indexed) {
             /* optimization for some common cases */
             if(cpp == 1)
@@ -1133,20 +1148,22 @@ static SDL_Surface *load_xpm(char **xpm, SDL_RWops *src)
     }
 
 done:
-    if(error) {
+    if ( in )
+        SDL_RWclose(in);
+    if(reader.error) {
         if ( src )
             SDL_RWseek(src, start, RW_SEEK_SET);
         if ( image ) {
             SDL_FreeSurface(image);
             image = NULL;
         }
-        IMG_SetError(error);
+        IMG_SetError(reader.error);
     }
     if (keystrings)
         SDL_free(keystrings);
     free_colorhash(colors);
-    if (linebuf)
-        SDL_free(linebuf);
+    if (reader.linebuf)
+        SDL_free(reader.linebuf);
     return(image);
 }
 
@@ -81,6 +81,18 @@ extern DECLSPEC void SDLCALL IMG_Quit(void);
     SDL_SetColorKey(image, SDL_RLEACCEL, image->format->colorkey);
  */
 extern DECLSPEC SDL_Surface * SDLCALL IMG_LoadTyped_RW(SDL_RWops *src, int freesrc, const char *type);
+
+/* The most bytes at the start of an image used to detect its type */
+#define IMG_HEADER_SIZE 32
+
+/* Load an image from an SDL data source, as IMG_LoadTyped_RW() does, when
+   the bytes at its current position have already been read into 'header',
+   to look at them or from an index of the data.  The type is detected
+   from those bytes, so the data source is only read by the loader.
+   If 'size' is less than IMG_HEADER_SIZE and the image is longer, the
+   header is read from the data source again.
+ */
+extern DECLSPEC SDL_Surface * SDLCALL IMG_LoadTypedHeader_RW(SDL_RWops *src, int freesrc, const char *type, const void *header, int size);
 /* Convenience functions */
 extern DECLSPEC SDL_Surface * SDLCALL IMG_Load(const char *file);
 extern DECLSPEC SDL_Surface * SDLCALL IMG_Load_RW(SDL_RWops *src, int freesrc);
@@ -93,6 +105,48 @@ extern DECLSPEC SDL_Texture * SDLCALL IMG_LoadTexture_RW(SDL_Renderer *renderer,
 extern DECLSPEC SDL_Texture * SDLCALL IMG_LoadTextureTyped_RW(SDL_Renderer *renderer, SDL_RWops *src, int freesrc, const char *type);
 #endif /* SDL 2.0 */
 
+#if SDL_VERSION_ATLEAST(2,0,0)
+/* An image being loaded on the worker threads.  The threads, one per CPU
+   core, are started by the first load and stopped by IMG_Quit(), after
+   they finish the loads still queued.
+ */
+typedef struct _IMG_AsyncLoad IMG_AsyncLoad;
+
+/* Start loading an image on the worker threads, as IMG_Load() or
+   IMG_LoadTyped_RW() would.  The data source belongs to the load until
+   it's finished.
+   These functions return a handle for the load, or NULL if there was an
+   error, in which case a data source to be freed is freed.
+ */
+extern DECLSPEC IMG_AsyncLoad * SDLCALL IMG_LoadAsync(const char *file);
+extern DECLSPEC IMG_AsyncLoad * SDLCALL IMG_LoadTypedAsync_RW(SDL_RWops *src, int freesrc, const char *type);
+
+/* Returns 1 if the load is done, or 0 if it's still going */
+extern DECLSPEC int SDLCALL IMG_AsyncLoadDone(IMG_AsyncLoad *load);
+
+/* Wait for a load to finish, loading it on this thread if no worker has
+   started on it yet, and free the handle.
+   This function returns the image, or NULL if there was an error.
+ */
+extern DECLSPEC SDL_Surface * SDLCALL IMG_FinishAsyncLoad(IMG_AsyncLoad *load);
+
+/* Push an event of the given type, from SDL_RegisterEvents(), when each
+   load started after this call is done, or pass 0 to stop.  The event has
+   the handle in user.data1 and user.code 0, or -1 if there was an error.
+   Finish the load when its event arrives.  A load finished earlier has
+   its event taken out of the queue, or never pushed.
+ */
+extern DECLSPEC void SDLCALL IMG_SetAsyncLoadEvent(Uint32 type);
+
+/* Load all the files on the worker threads and this one, and wait for
+   them.  Each surfaces[i] is set to the image from files[i], or NULL if
+   it couldn't be loaded.
+   This function returns the number of images loaded, or -1 if there was
+   an error.
+ */
+extern DECLSPEC int SDLCALL IMG_LoadBatch(const char **files, int count, SDL_Surface **surfaces);
+#endif /* SDL 2.0 */
+
 /* Functions to detect a file type, given a seekable source */
 extern DECLSPEC int SDLCALL IMG_isICO(SDL_RWops *src);
 extern DECLSPEC int SDLCALL IMG_isCUR(SDL_RWops *src);
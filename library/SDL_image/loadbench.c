@@ -0,0 +1,226 @@
+/*
+  loadbench:  Compare loading a directory of images one at a time and in parallel.
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* A benchmark of the time to load every image in a directory, as a game
+   would at startup: with IMG_Load() on one thread, with IMG_LoadBatch(),
+   and with IMG_LoadAsync() while waiting for the completion events.
+ */
+
+/* quiet windows compiler warnings */
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+#include "SDL.h"
+#include "SDL_image.h"
+
+#define DEFAULT_ITERATIONS  5
+
+static char *Usage =
+"Usage: %s <directory> [iterations]\n";
+
+static char **files;
+static int num_files;
+
+static void AddFile(const char *dir, const char *name)
+{
+    size_t len = strlen(dir) + strlen(name) + 2;
+    char **more = (char **)realloc(files, (num_files + 1) * sizeof(*files));
+
+    if ( more == NULL ) {
+        return;
+    }
+    files = more;
+    files[num_files] = (char *)malloc(len);
+    if ( files[num_files] ) {
+        sprintf(files[num_files], "%s/%s", dir, name);
+        ++num_files;
+    }
+}
+
+static int ListFiles(const char *dir)
+{
+#ifdef _WIN32
+    WIN32_FIND_DATAA data;
+    char pattern[MAX_PATH];
+    HANDLE find;
+
+    SDL_snprintf(pattern, sizeof(pattern), "%s\\*", dir);
+    find = FindFirstFileA(pattern, &data);
+    if ( find == INVALID_HANDLE_VALUE ) {
+        return -1;
+    }
+    do {
+        if ( !(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ) {
+            AddFile(dir, data.cFileName);
+        }
+    } while ( FindNextFileA(find, &data) );
+    FindClose(find);
+#else
+    DIR *d = opendir(dir);
+    struct dirent *entry;
+
+    if ( d == NULL ) {
+        return -1;
+    }
+    while ( (entry = readdir(d)) != NULL ) {
+        if ( entry->d_name[0] != '.' ) {
+            AddFile(dir, entry->d_name);
+        }
+    }
+    closedir(d);
+#endif
+    return 0;
+}
+
+static double Seconds(Uint64 start)
+{
+    return (double)(SDL_GetPerformanceCounter() - start) /
+           SDL_GetPerformanceFrequency();
+}
+
+static void FreeImages(SDL_Surface **images, int *pixels)
+{
+    int i;
+
+    *pixels = 0;
+    for ( i = 0; i < num_files; ++i ) {
+        if ( images[i] ) {
+            *pixels += images[i]->w * images[i]->h;
+            SDL_FreeSurface(images[i]);
+            images[i] = NULL;
+        }
+    }
+}
+
+static void Report(const char *what, int iterations, int loaded, double seconds)
+{
+    printf("%-24s %9.2f ms %8.1f images/s %5d loaded\n", what,
+           seconds * 1000.0 / iterations,
+           seconds > 0.0 ? loaded * iterations / seconds : 0.0, loaded);
+}
+
+int main(int argc, char *argv[])
+{
+    SDL_Surface **images;
+    Uint32 event_type;
+    Uint64 start;
+    double serial = 0.0, batch = 0.0, async = 0.0;
+    int iterations = DEFAULT_ITERATIONS;
+    int i, n, loaded = 0, pixels = 0;
+
+    if ( argc < 2 ) {
+        fprintf(stderr, Usage, argv[0]);
+        return(1);
+    }
+    if ( argc > 2 ) {
+        iterations = atoi(argv[2]);
+    }
+    if ( iterations <= 0 ) {
+        fprintf(stderr, Usage, argv[0]);
+        return(1);
+    }
+
+    if ( SDL_Init(SDL_INIT_EVENTS) < 0 ) {
+        fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return(2);
+    }
+    IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG | IMG_INIT_TIF | IMG_INIT_WEBP);
+
+    if ( ListFiles(argv[1]) < 0 || num_files == 0 ) {
+        fprintf(stderr, "Couldn't find any files in %s\n", argv[1]);
+        IMG_Quit();
+        SDL_Quit();
+        return(2);
+    }
+    images = (SDL_Surface **)calloc(num_files, sizeof(*images));
+    if ( images == NULL ) {
+        fprintf(stderr, "Out of memory\n");
+        IMG_Quit();
+        SDL_Quit();
+        return(2);
+    }
+    event_type = SDL_RegisterEvents(1);
+
+    /* Read everything once, so the timings don't depend on the disk cache */
+    for ( i = 0; i < num_files; ++i ) {
+        images[i] = IMG_Load(files[i]);
+    }
+    FreeImages(images, &pixels);
+
+    for ( n = 0; n < iterations; ++n ) {
+        start = SDL_GetPerformanceCounter();
+        loaded = 0;
+        for ( i = 0; i < num_files; ++i ) {
+            images[i] = IMG_Load(files[i]);
+            if ( images[i] ) {
+                ++loaded;
+            }
+        }
+        serial += Seconds(start);
+        FreeImages(images, &pixels);
+
+        start = SDL_GetPerformanceCounter();
+        IMG_LoadBatch((const char **)files, num_files, images);
+        batch += Seconds(start);
+        FreeImages(images, &pixels);
+
+        /* As a game would, picking the images up as their events arrive */
+        start = SDL_GetPerformanceCounter();
+        IMG_SetAsyncLoadEvent(event_type);
+        for ( i = 0; i < num_files; ++i ) {
+            IMG_LoadAsync(files[i]);
+        }
+        IMG_SetAsyncLoadEvent(0);
+        for ( i = 0; i < num_files; ) {
+            SDL_Event event;
+
+            if ( SDL_WaitEvent(&event) && event.type == event_type ) {
+                images[i++] = IMG_FinishAsyncLoad((IMG_AsyncLoad *)event.user.data1);
+            }
+        }
+        async += Seconds(start);
+        FreeImages(images, &pixels);
+    }
+
+    printf("%d files, %d images, %.1f megapixels, %d CPUs, %d iterations\n",
+           num_files, loaded, pixels / 1000000.0, SDL_GetCPUCount(), iterations);
+    Report("IMG_Load", iterations, loaded, serial);
+    Report("IMG_LoadBatch", iterations, loaded, batch);
+    Report("IMG_LoadAsync events", iterations, loaded, async);
+
+    for ( i = 0; i < num_files; ++i ) {
+        free(files[i]);
+    }
+    free(files);
+    free(images);
+    IMG_Quit();
+    SDL_Quit();
+    return(0);
+}
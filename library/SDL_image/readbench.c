@@ -0,0 +1,174 @@
+/*
+  readbench:  Time the loaders that parse their files a little at a time.
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* A benchmark of loading PNM, XPM, GIF and TGA images, which are read a
+   byte, a line or a data block at a time, from a stdio file, from a
+   memory-mapped file and from memory.  Large images show the cost of
+   each read best.
+ */
+
+/* quiet windows compiler warnings */
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "SDL_image.h"
+
+#define DEFAULT_ITERATIONS  5
+
+static char *Usage =
+"Usage: %s [-iterations N] <image.pnm|.pbm|.pgm|.ppm|.xpm|.gif|.tga> ...\n";
+
+typedef SDL_Surface *(*Loader)(SDL_RWops *src);
+
+static Loader FindLoader(const char *file)
+{
+    const char *ext = strrchr(file, '.');
+
+    if ( ext == NULL ) {
+        return NULL;
+    }
+    ++ext;
+    if ( SDL_strcasecmp(ext, "pnm") == 0 || SDL_strcasecmp(ext, "pbm") == 0 ||
+         SDL_strcasecmp(ext, "pgm") == 0 || SDL_strcasecmp(ext, "ppm") == 0 ) {
+        return IMG_LoadPNM_RW;
+    }
+    if ( SDL_strcasecmp(ext, "xpm") == 0 ) {
+        return IMG_LoadXPM_RW;
+    }
+    if ( SDL_strcasecmp(ext, "gif") == 0 ) {
+        return IMG_LoadGIF_RW;
+    }
+    if ( SDL_strcasecmp(ext, "tga") == 0 ) {
+        return IMG_LoadTGA_RW;
+    }
+    return NULL;
+}
+
+/* Seconds per load, or a negative number if the image didn't load */
+static double Time(Loader load, const char *file, int how, int iterations)
+{
+    SDL_RWops *src;
+    SDL_Surface *image;
+    void *mem = NULL;
+    Sint64 size = 0;
+    Uint64 start, elapsed = 0;
+    int i;
+
+    if ( how == 2 ) {
+        /* Read the file beforehand, so only the decoding is timed */
+        src = SDL_RWFromFile(file, "rb");
+        if ( src == NULL ) {
+            return -1.0;
+        }
+        size = SDL_RWsize(src);
+        mem = malloc((size_t)size);
+        if ( mem == NULL || !SDL_RWread(src, mem, (size_t)size, 1) ) {
+            SDL_RWclose(src);
+            free(mem);
+            return -1.0;
+        }
+        SDL_RWclose(src);
+    }
+
+    for ( i = 0; i < iterations; ++i ) {
+        start = SDL_GetPerformanceCounter();
+        switch (how) {
+        case 0:
+            src = SDL_RWFromFile(file, "rb");
+            break;
+        case 1:
+            src = SDL_RWFromMappedFile(file);
+            break;
+        default:
+            src = SDL_RWFromConstMem(mem, (int)size);
+            break;
+        }
+        image = src ? load(src) : NULL;
+        if ( src ) {
+            SDL_RWclose(src);
+        }
+        elapsed += SDL_GetPerformanceCounter() - start;
+        if ( image == NULL ) {
+            free(mem);
+            return -1.0;
+        }
+        SDL_FreeSurface(image);
+    }
+    free(mem);
+    return (double)elapsed / SDL_GetPerformanceFrequency() / iterations;
+}
+
+int main(int argc, char *argv[])
+{
+    static const char *sources[] = { "stdio", "mapped", "memory" };
+    int iterations = DEFAULT_ITERATIONS;
+    int i, how;
+
+    for ( i = 1; i < argc && argv[i][0] == '-'; ++i ) {
+        if ( strcmp(argv[i], "-iterations") == 0 && i + 1 < argc ) {
+            iterations = atoi(argv[++i]);
+        } else {
+            break;
+        }
+    }
+    if ( i == argc || iterations <= 0 ) {
+        fprintf(stderr, Usage, argv[0]);
+        return(1);
+    }
+
+    if ( SDL_Init(0) < 0 ) {
+        fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return(2);
+    }
+
+    printf("%d iterations, milliseconds per load\n", iterations);
+    printf("%-24s %10s %10s %10s\n", "File",
+           sources[0], sources[1], sources[2]);
+    for ( ; i < argc; ++i ) {
+        Loader load = FindLoader(argv[i]);
+        const char *name = strrchr(argv[i], '/');
+
+        name = name ? name + 1 : argv[i];
+        if ( load == NULL ) {
+            fprintf(stderr, "%s: unknown image type\n", argv[i]);
+            continue;
+        }
+        printf("%-24.24s", name);
+        for ( how = 0; how < 3; ++how ) {
+            double seconds = Time(load, argv[i], how, iterations);
+
+            if ( seconds < 0.0 ) {
+                printf(" %10s", "failed");
+            } else {
+                printf(" %10.2f", seconds * 1000.0);
+            }
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+
+    SDL_Quit();
+    return(0);
+}
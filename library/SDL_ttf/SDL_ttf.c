@@ -35,6 +35,11 @@
 #include "SDL_endian.h"
 #include "SDL_ttf.h"
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define TTF_USE_NEON
+#include <arm_neon.h>
+#endif
+
 /* FIXME: Right now we assume the gray-scale renderer Freetype is using
    supports 256 shades of gray, but we should instead key off of num_grays
    in the result FT_Bitmap after the FT_Render_Glyph() call. */
@@ -48,6 +53,18 @@
 #define CACHED_BITMAP   0x01
 #define CACHED_PIXMAP   0x02
 
+/* The glyph cache starts with this many slots and doubles when 3/4 full */
+#define GLYPH_CACHE_MIN_SLOTS   64
+
+/* The default limit on the memory used by a font's glyph cache */
+#define GLYPH_CACHE_DEFAULT_SIZE    (4 * 1024 * 1024)
+
+/* Font atlas pages are at least this size, and larger for large fonts */
+#define FONT_ATLAS_MIN_PAGE_SIZE    256
+
+/* Far enough away for any glyph in a distance transform */
+#define DISTANCE_INFINITY   1e20
+
 /* Cached glyph information */
 typedef struct cached_glyph {
     int stored;
@@ -60,9 +77,120 @@ typedef struct cached_glyph {
     int maxy;
     int yoffset;
     int advance;
-    Uint16 cached;
+
+    /* The glyph is cached for a character in a style and outline */
+    Uint32 ch;
+    int style;
+    int outline;
+
+    /* Memory used by the glyph and its bitmaps */
+    size_t bytes;
+
+    /* The glyphs in order of use, the most recent first */
+    struct cached_glyph *lru_prev;
+    struct cached_glyph *lru_next;
 } c_glyph;
 
+/* A glyph packed into a font atlas, with the metrics needed to place it */
+typedef struct atlas_glyph {
+    int stored;
+    Uint32 ch;
+    int style;
+    int outline;
+    FT_UInt index;
+    int minx;
+    int maxx;
+    int yoffset;
+    int advance;
+    int width;
+    int rows;
+    SDL_Texture *texture;       /* NULL for glyphs without any pixels */
+} a_glyph;
+
+/* A glyph of wrapped text, with its pen position as if the text were on a
+   single line, and the extent of the glyph around it.
+ */
+typedef struct wrapped_glyph {
+    Uint32 ch;
+    int x;
+    int left;
+    int right;
+} w_glyph;
+
+/* A line of wrapped text */
+typedef struct wrapped_line {
+    int first;
+    int last;                   /* Past the last glyph that isn't white space */
+    int x;                      /* Added to the glyph pen positions */
+    int width;
+} w_line;
+
+/* Text laid out into lines, kept around to reuse the memory */
+typedef struct wrapped_text {
+    w_glyph *glyphs;
+    int num_glyphs;
+    int max_glyphs;
+    w_line *lines;
+    int num_lines;
+    int max_lines;
+    int width;
+    int height;
+    int line_height;            /* The lines are this far apart, plus spacing */
+} w_text;
+
+/* Glyphs drawn with a renderer from shared texture pages */
+struct _TTF_FontAtlas {
+    TTF_Font *font;
+    SDL_Renderer *renderer;
+    SDL_TextureAtlas *pages;
+
+    /* A white square, stretched for underlines and strikethroughs */
+    SDL_Texture *line;
+
+    /* The distance field spread and padding around each glyph, or 0 */
+    int spread;
+
+    /* An open addressed hash table of the glyphs, like the glyph cache */
+    a_glyph *glyphs;
+    int glyph_slots;            /* A power of two */
+    int glyph_count;
+
+    /* Scratch space for laying out wrapped text */
+    w_text wrapped;
+
+    /* The other atlases of the font */
+    struct _TTF_FontAtlas *next;
+};
+
+/* A character of a text run and where it was laid out */
+typedef struct run_glyph {
+    Uint32 ch;
+    FT_UInt index;
+    int x;                      /* The pen position, as in TTF_RenderUTF8_Blended() */
+} r_glyph;
+
+/* Text decoded and laid out once, to be measured and drawn many times */
+struct _TTF_TextRun {
+    TTF_Font *font;
+
+    /* The font settings the run was laid out with */
+    int style;
+    int outline;
+    int kerning;
+    int hinting;
+
+    r_glyph *glyphs;
+    int num_glyphs;
+    int max_glyphs;
+
+    /* Where the next glyph goes and the bounds so far, for appending */
+    int xstart;
+    FT_UInt prev_index;
+    int minx;
+    int maxx;
+    int miny;
+};
+
 /* The structure used to hold internal font information */
 struct _TTF_Font {
     /* Freetype2 maintains all sorts of useful info itself */
@@ -82,6 +210,10 @@ struct _TTF_Font {
     /* Whether kerning is desired */
     int kerning;
 
+    /* How lines of wrapped text are aligned and the pixels between them */
+    int wrapped_align;
+    int wrapped_spacing;
+
     /* Extra width in glyph bounds for text styles */
     int glyph_overhang;
     float glyph_italics;
@@ -90,9 +222,22 @@ struct _TTF_Font {
     int underline_offset;
     int underline_height;
 
-    /* Cache for style-transformed glyphs */
+    /* Cache for style-transformed glyphs, an open addressed hash table
+       with linear probing.  When it uses more memory than the budget the
+       least recently used glyphs are thrown away.
+     */
     c_glyph *current;
-    c_glyph cache[257]; /* 257 is a prime */
+    c_glyph **cache;
+    int cache_slots;            /* A power of two */
+    int cache_count;
+    c_glyph *lru_first;
+    c_glyph *lru_last;
+    size_t cache_bytes;
+    size_t cache_budget;        /* 0 for no limit */
+    TTF_GlyphCacheStats cache_stats;
+
+    /* Atlases drawing the font, which go away with it */
+    TTF_FontAtlas *atlases;
 
     /* We are responsible for closing the font stream */
     SDL_RWops *src;
@@ -121,6 +266,7 @@ struct _TTF_Font {
 static FT_Library library;
 static int TTF_initialized = 0;
 static int TTF_byteswapped = 0;
+static SDL_bool TTF_hasSSE2 = SDL_FALSE;
 
 #define TTF_CHECKPOINTER(p, errval)                 \
     if ( !TTF_initialized ) {                   \
@@ -282,6 +428,30 @@ static void TTF_drawLine_Blended(const TTF_Font *font, const SDL_Surface *textbu
     }
 }
 
+/* Gets the height of a line of text from its lowest point, the same as
+   TTF_SizeUTF8() reports it.
+*/
+static int TTF_text_height(TTF_Font *font, int miny)
+{
+    /* Some fonts descend below font height (FletcherGothicFLF) */
+    /* Add outline extra height */
+    int height = font->ascent - miny;
+    if ( font->outline > 0 ) {
+        height += font->outline * 2;
+    }
+    if ( height < font->height ) {
+        height = font->height;
+    }
+    /* Update height according to the needs of the underline style */
+    if ( TTF_HANDLE_STYLE_UNDERLINE(font) ) {
+        int bottom_row = TTF_underline_bottom_row(font);
+        if ( height < bottom_row ) {
+            height = bottom_row;
+        }
+    }
+    return height;
+}
+
 /* rcg06192001 get linked library's version. */
 const SDL_version *TTF_Linked_Version(void)
 {
@@ -344,6 +514,7 @@ int TTF_Init( void )
         }
     }
     if ( status == 0 ) {
+        TTF_hasSSE2 = SDL_HasSSE2();
         ++TTF_initialized;
     }
     return status;
@@ -375,6 +546,8 @@ TTF_Font* TTF_OpenFontIndexRW( SDL_RWops *src, int freesrc, int ptsize, long ind
     FT_Stream stream;
     FT_CharMap found;
     Sint64 position;
+    const void *data;
+    size_t size;
     int i;
 
     if ( ! TTF_initialized ) {
@@ -413,21 +586,30 @@ TTF_Font* TTF_OpenFontIndexRW( SDL_RWops *src, int freesrc, int ptsize, long ind
     font->src = src;
     font->freesrc = freesrc;
 
-    stream = (FT_Stream)malloc(sizeof(*stream));
-    if ( stream == NULL ) {
-        TTF_SetError( "Out of memory" );
-        TTF_CloseFont( font );
-        return NULL;
-    }
-    memset(stream, 0, sizeof(*stream));
+    /* If the font is in memory or a mapped file, FreeType can use its
+       tables where they are instead of copying them through RWread() */
+    data = SDL_RWGetBuffer( src, &size );
+    if ( data ) {
+        font->args.flags = FT_OPEN_MEMORY;
+        font->args.memory_base = (const FT_Byte *)data;
+        font->args.memory_size = (FT_Long)size;
+    } else {
+        stream = (FT_Stream)malloc(sizeof(*stream));
+        if ( stream == NULL ) {
+            TTF_SetError( "Out of memory" );
+            TTF_CloseFont( font );
+            return NULL;
+        }
+        memset(stream, 0, sizeof(*stream));
 
-    stream->read = RWread;
-    stream->descriptor.pointer = src;
-    stream->pos = (unsigned long)position;
-    stream->size = (unsigned long)(SDL_RWsize(src) - position);
+        stream->read = RWread;
+        stream->descriptor.pointer = src;
+        stream->pos = (unsigned long)position;
+        stream->size = (unsigned long)(SDL_RWsize(src) - position);
 
-    font->args.flags = FT_OPEN_STREAM;
-    font->args.stream = stream;
+        font->args.flags = FT_OPEN_STREAM;
+        font->args.stream = stream;
+    }
 
     error = FT_Open_Face( library, &font->args, index, &font->face );
     if ( error ) {
@@ -537,6 +719,10 @@ TTF_Font* TTF_OpenFontIndexRW( SDL_RWops *src, int freesrc, int ptsize, long ind
     font->glyph_italics = 0.207f;
     font->glyph_italics *= font->height;
 
+    font->cache_budget = GLYPH_CACHE_DEFAULT_SIZE;
+    font->wrapped_align = TTF_WRAPPED_ALIGN_LEFT;
+    font->wrapped_spacing = 2;
+
     return font;
 }
 
@@ -562,33 +748,162 @@ TTF_Font* TTF_OpenFont( const char *file, int ptsize )
 
 static void Flush_Glyph( c_glyph* glyph )
 {
-    glyph->stored = 0;
-    glyph->index = 0;
     if ( glyph->bitmap.buffer ) {
         free( glyph->bitmap.buffer );
-        glyph->bitmap.buffer = 0;
     }
     if ( glyph->pixmap.buffer ) {
         free( glyph->pixmap.buffer );
-        glyph->pixmap.buffer = 0;
     }
-    glyph->cached = 0;
+    free( glyph );
 }
 
 static void Flush_Cache( TTF_Font* font )
 {
     int i;
-    int size = sizeof( font->cache ) / sizeof( font->cache[0] );
 
-    for ( i = 0; i < size; ++i ) {
-        if ( font->cache[i].cached ) {
-            Flush_Glyph( &font->cache[i] );
+    for ( i = 0; i < font->cache_slots; ++i ) {
+        if ( font->cache[i] ) {
+            Flush_Glyph( font->cache[i] );
+            font->cache[i] = NULL;
+        }
+    }
+    font->current = NULL;
+    font->cache_count = 0;
+    font->lru_first = NULL;
+    font->lru_last = NULL;
+    font->cache_bytes = 0;
+}
+
+/* Whether the renderer was destroyed, taking the pages and glyph textures */
+static SDL_bool Atlas_Detached( TTF_FontAtlas* atlas )
+{
+    return ( SDL_GetTextureAtlasRenderer( atlas->pages ) == NULL );
+}
+
+static void Flush_Atlas( TTF_FontAtlas* atlas )
+{
+    const SDL_bool detached = Atlas_Detached( atlas );
+    int i;
+
+    for ( i = 0; i < atlas->glyph_slots; ++i ) {
+        if ( atlas->glyphs[i].texture && !detached ) {
+            SDL_DestroyTexture( atlas->glyphs[i].texture );
+        }
+    }
+    if ( atlas->glyphs ) {
+        memset( atlas->glyphs, 0, atlas->glyph_slots * sizeof(*atlas->glyphs) );
+    }
+    atlas->glyph_count = 0;
+}
+
+static __inline__ Uint32 Hash_Glyph( Uint32 ch, int style, int outline )
+{
+    Uint32 hash = ch ^ ((Uint32)style << 21) ^ ((Uint32)outline << 24);
+    hash *= 0x9E3779B1;
+    return hash ^ (hash >> 16);
+}
+
+/* Find the slot holding a glyph, or the empty slot where it would go */
+static int Find_Glyph_Slot( const TTF_Font* font, Uint32 ch, int style, int outline )
+{
+    int mask = font->cache_slots - 1;
+    int slot = (int)(Hash_Glyph( ch, style, outline ) & mask);
+
+    for ( ; ; ) {
+        const c_glyph *glyph = font->cache[slot];
+        if ( !glyph ||
+             (glyph->ch == ch && glyph->style == style && glyph->outline == outline) ) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+static int Grow_Cache( TTF_Font* font )
+{
+    c_glyph **old_cache = font->cache;
+    int old_slots = font->cache_slots;
+    int i;
+
+    font->cache_slots = old_slots ? old_slots * 2 : GLYPH_CACHE_MIN_SLOTS;
+    font->cache = (c_glyph **)calloc( font->cache_slots, sizeof(*font->cache) );
+    if ( !font->cache ) {
+        font->cache = old_cache;
+        font->cache_slots = old_slots;
+        return -1;
+    }
+    for ( i = 0; i < old_slots; ++i ) {
+        c_glyph *glyph = old_cache[i];
+        if ( glyph ) {
+            font->cache[Find_Glyph_Slot( font, glyph->ch, glyph->style, glyph->outline )] = glyph;
+        }
+    }
+    free( old_cache );
+    return 0;
+}
+
+/* Move a glyph to the front of the use order */
+static void Touch_Glyph( TTF_Font* font, c_glyph* glyph )
+{
+    if ( font->lru_first == glyph ) {
+        return;
+    }
+    if ( glyph->lru_prev ) {
+        glyph->lru_prev->lru_next = glyph->lru_next;
+    }
+    if ( glyph->lru_next ) {
+        glyph->lru_next->lru_prev = glyph->lru_prev;
+    } else if ( font->lru_last == glyph ) {
+        font->lru_last = glyph->lru_prev;
+    }
+    glyph->lru_prev = NULL;
+    glyph->lru_next = font->lru_first;
+    if ( font->lru_first ) {
+        font->lru_first->lru_prev = glyph;
+    }
+    font->lru_first = glyph;
+    if ( !font->lru_last ) {
+        font->lru_last = glyph;
+    }
+}
+
+/* Remove a glyph, moving back the glyphs after it that probed past it */
+static void Evict_Glyph( TTF_Font* font, c_glyph* glyph )
+{
+    int mask = font->cache_slots - 1;
+    int slot = Find_Glyph_Slot( font, glyph->ch, glyph->style, glyph->outline );
+    int next = (slot + 1) & mask;
+
+    while ( font->cache[next] ) {
+        const c_glyph *moved = font->cache[next];
+        int home = (int)(Hash_Glyph( moved->ch, moved->style, moved->outline ) & mask);
+
+        /* Move it into the hole unless its home is between the two */
+        if ( ((next - home) & mask) >= ((next - slot) & mask) ) {
+            font->cache[slot] = font->cache[next];
+            slot = next;
         }
+        next = (next + 1) & mask;
+    }
+    font->cache[slot] = NULL;
+    --font->cache_count;
 
+    if ( glyph->lru_prev ) {
+        glyph->lru_prev->lru_next = glyph->lru_next;
+    } else {
+        font->lru_first = glyph->lru_next;
+    }
+    if ( glyph->lru_next ) {
+        glyph->lru_next->lru_prev = glyph->lru_prev;
+    } else {
+        font->lru_last = glyph->lru_prev;
     }
+    font->cache_bytes -= glyph->bytes;
+    ++font->cache_stats.evictions;
+    Flush_Glyph( glyph );
 }
 
-static FT_Error Load_Glyph( TTF_Font* font, Uint16 ch, c_glyph* cached, int want )
+static FT_Error Load_Glyph( TTF_Font* font, Uint32 ch, c_glyph* cached, int want )
 {
     FT_Face face;
     FT_Error error;
@@ -896,33 +1211,105 @@ static FT_Error Load_Glyph( TTF_Font* font, Uint16 ch, c_glyph* cached, int want
         }
     }
 
-    /* We're done, mark this glyph cached */
-    cached->cached = ch;
-
     return 0;
 }
 
-static FT_Error Find_Glyph( TTF_Font* font, Uint16 ch, int want )
+static FT_Error Find_Glyph( TTF_Font* font, Uint32 ch, int want )
 {
     int retval = 0;
-    int hsize = sizeof( font->cache ) / sizeof( font->cache[0] );
+    int style = font->style & ~TTF_STYLE_NO_GLYPH_CHANGE;
+    int slot;
+    c_glyph *glyph;
+
+    if ( !font->cache_slots && Grow_Cache( font ) < 0 ) {
+        return FT_Err_Out_Of_Memory;
+    }
+
+    slot = Find_Glyph_Slot( font, ch, style, font->outline );
+    glyph = font->cache[slot];
+    if ( glyph ) {
+        if ( (glyph->stored & want) == want ) {
+            ++font->cache_stats.hits;
+        } else {
+            ++font->cache_stats.misses;
+        }
+    } else {
+        if ( (font->cache_count + 1) * 4 > font->cache_slots * 3 ) {
+            if ( Grow_Cache( font ) < 0 ) {
+                return FT_Err_Out_Of_Memory;
+            }
+            slot = Find_Glyph_Slot( font, ch, style, font->outline );
+        }
+        glyph = (c_glyph *)calloc( 1, sizeof(*glyph) );
+        if ( !glyph ) {
+            return FT_Err_Out_Of_Memory;
+        }
+        glyph->ch = ch;
+        glyph->style = style;
+        glyph->outline = font->outline;
+        glyph->bytes = sizeof(*glyph);
+        font->cache[slot] = glyph;
+        ++font->cache_count;
+        font->cache_bytes += glyph->bytes;
+        ++font->cache_stats.misses;
+    }
+    Touch_Glyph( font, glyph );
+    font->current = glyph;
 
-    int h = ch % hsize;
-    font->current = &font->cache[h];
+    if ( (glyph->stored & want) != want ) {
+        size_t bytes;
 
-    if (font->current->cached != ch)
-        Flush_Glyph( font->current );
+        retval = Load_Glyph( font, ch, glyph, want );
 
-    if ( (font->current->stored & want) != want ) {
-        retval = Load_Glyph( font, ch, font->current, want );
+        bytes = sizeof(*glyph);
+        if ( glyph->bitmap.buffer ) {
+            bytes += glyph->bitmap.pitch * glyph->bitmap.rows;
+        }
+        if ( glyph->pixmap.buffer ) {
+            bytes += glyph->pixmap.pitch * glyph->pixmap.rows;
+        }
+        font->cache_bytes += bytes - glyph->bytes;
+        glyph->bytes = bytes;
+
+        /* Make room, keeping at least the glyph being returned */
+        while ( font->cache_budget && font->cache_bytes > font->cache_budget &&
+                font->lru_last != glyph ) {
+            Evict_Glyph( font, font->lru_last );
+        }
     }
     return retval;
 }
 
+void TTF_SetFontGlyphCacheSize( TTF_Font* font, size_t bytes )
+{
+    font->cache_budget = bytes;
+    while ( font->cache_budget && font->cache_bytes > font->cache_budget &&
+            font->lru_last ) {
+        Evict_Glyph( font, font->lru_last );
+    }
+    font->current = NULL;
+}
+
+void TTF_GetFontGlyphCacheStats( const TTF_Font* font, TTF_GlyphCacheStats* stats )
+{
+    *stats = font->cache_stats;
+    stats->glyphs = font->cache_count;
+    stats->bytes = font->cache_bytes;
+}
+
+void TTF_ResetFontGlyphCacheStats( TTF_Font* font )
+{
+    SDL_zero( font->cache_stats );
+}
+
 void TTF_CloseFont( TTF_Font* font )
 {
     if ( font ) {
+        while ( font->atlases ) {
+            TTF_DestroyFontAtlas( font->atlases );
+        }
         Flush_Cache( font );
+        free( font->cache );
         if ( font->face ) {
             FT_Done_Face( font->face );
         }
@@ -993,6 +1380,27 @@ static void UCS2_to_UTF8(const Uint16 *src, Uint8 *dst)
     *dst = '\0';
 }
 
+/* Convert a UCS-4 character to a UTF-8 string */
+static void UCS4_to_UTF8(Uint32 ch, Uint8 *dst)
+{
+    if (ch <= 0x7F) {
+        *dst++ = (Uint8) ch;
+    } else if (ch <= 0x7FF) {
+        *dst++ = 0xC0 | (Uint8) ((ch >> 6) & 0x1F);
+        *dst++ = 0x80 | (Uint8) (ch & 0x3F);
+    } else if (ch <= 0xFFFF) {
+        *dst++ = 0xE0 | (Uint8) ((ch >> 12) & 0x0F);
+        *dst++ = 0x80 | (Uint8) ((ch >> 6) & 0x3F);
+        *dst++ = 0x80 | (Uint8) (ch & 0x3F);
+    } else {
+        *dst++ = 0xF0 | (Uint8) ((ch >> 18) & 0x07);
+        *dst++ = 0x80 | (Uint8) ((ch >> 12) & 0x3F);
+        *dst++ = 0x80 | (Uint8) ((ch >> 6) & 0x3F);
+        *dst++ = 0x80 | (Uint8) (ch & 0x3F);
+    }
+    *dst = '\0';
+}
+
 /* Gets a unicode value from a UTF-8 encoded string and advance the string */
 #define UNKNOWN_UNICODE 0xFFFD
 static Uint32 UTF8_getch(const char **src, size_t *srclen)
@@ -1113,6 +1521,26 @@ void TTF_SetFontKerning(TTF_Font *font, int allowed)
     font->kerning = allowed;
 }
 
+int TTF_GetFontWrappedAlign(const TTF_Font *font)
+{
+    return(font->wrapped_align);
+}
+
+void TTF_SetFontWrappedAlign(TTF_Font *font, int align)
+{
+    font->wrapped_align = align;
+}
+
+int TTF_GetFontWrappedSpacing(const TTF_Font *font)
+{
+    return(font->wrapped_spacing);
+}
+
+void TTF_SetFontWrappedSpacing(TTF_Font *font, int spacing)
+{
+    font->wrapped_spacing = spacing;
+}
+
 long TTF_FontFaces(const TTF_Font *font)
 {
     return(font->face->num_faces);
@@ -1138,8 +1566,19 @@ int TTF_GlyphIsProvided(const TTF_Font *font, Uint16 ch)
   return(FT_Get_Char_Index(font->face, ch));
 }
 
+int TTF_GlyphIsProvided32(const TTF_Font *font, Uint32 ch)
+{
+  return(FT_Get_Char_Index(font->face, ch));
+}
+
 int TTF_GlyphMetrics(TTF_Font *font, Uint16 ch,
                      int* minx, int* maxx, int* miny, int* maxy, int* advance)
+{
+    return TTF_GlyphMetrics32(font, ch, minx, maxx, miny, maxy, advance);
+}
+
+int TTF_GlyphMetrics32(TTF_Font *font, Uint32 ch,
+                       int* minx, int* maxx, int* miny, int* maxy, int* advance)
 {
     FT_Error error;
 
@@ -1223,7 +1662,7 @@ int TTF_SizeUTF8(TTF_Font *font, const char *text, int *w, int *h)
     textlen = SDL_strlen(text);
     x= 0;
     while ( textlen > 0 ) {
-        Uint16 c = UTF8_getch(&text, &textlen);
+        Uint32 c = UTF8_getch(&text, &textlen);
         if ( c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED ) {
             continue;
         }
@@ -1293,19 +1732,7 @@ int TTF_SizeUTF8(TTF_Font *font, const char *text, int *w, int *h)
         *w = (maxx - minx) + outline_delta;
     }
     if ( h ) {
-        /* Some fonts descend below font height (FletcherGothicFLF) */
-        /* Add outline extra height */
-        *h = (font->ascent - miny) + outline_delta;
-        if ( *h < font->height ) {
-            *h = font->height;
-        }
-        /* Update height according to the needs of the underline style */
-        if ( TTF_HANDLE_STYLE_UNDERLINE(font) ) {
-            int bottom_row = TTF_underline_bottom_row(font);
-            if ( *h < bottom_row ) {
-                *h = bottom_row;
-            }
-        }
+        *h = TTF_text_height(font, miny);
     }
     return status;
 }
@@ -1328,6 +1755,140 @@ int TTF_SizeUNICODE(TTF_Font *font, const Uint16 *text, int *w, int *h)
     return status;
 }
 
+/* Composite a row of glyph coverage into a row of an 8-bit surface,
+   keeping the larger value where glyphs overlap.  The palette indices
+   of solid and shaded text grow with the coverage, so this is the same
+   as taking the larger alpha.
+*/
+static void TTF_maxRow8(Uint8 *dst, const Uint8 *src, int width)
+{
+#if defined(TTF_USE_NEON)
+    while ( width >= 16 ) {
+        vst1q_u8(dst, vmaxq_u8(vld1q_u8(dst), vld1q_u8(src)));
+        dst += 16;
+        src += 16;
+        width -= 16;
+    }
+    if ( width >= 8 ) {
+        vst1_u8(dst, vmax_u8(vld1_u8(dst), vld1_u8(src)));
+        dst += 8;
+        src += 8;
+        width -= 8;
+    }
+#elif defined(__SSE2__)
+    if ( TTF_hasSSE2 ) {
+        while ( width >= 16 ) {
+            __m128i d = _mm_loadu_si128((const __m128i *)dst);
+            __m128i s = _mm_loadu_si128((const __m128i *)src);
+            _mm_storeu_si128((__m128i *)dst, _mm_max_epu8(d, s));
+            dst += 16;
+            src += 16;
+            width -= 16;
+        }
+        if ( width >= 8 ) {
+            __m128i d = _mm_loadl_epi64((const __m128i *)dst);
+            __m128i s = _mm_loadl_epi64((const __m128i *)src);
+            _mm_storel_epi64((__m128i *)dst, _mm_max_epu8(d, s));
+            dst += 8;
+            src += 8;
+            width -= 8;
+        }
+    }
+#endif
+    while ( width-- > 0 ) {
+        if ( *src > *dst ) {
+            *dst = *src;
+        }
+        ++dst;
+        ++src;
+    }
+}
+
+/* Composite a row of glyph coverage into a row of a 32-bit ARGB surface
+   filled with the color in pixel, keeping the larger alpha where glyphs
+   overlap.  Since every pixel already has the text color, the larger
+   alpha is also the larger of the two pixels in each byte.
+*/
+static void TTF_blendRow(Uint32 *dst, const Uint8 *src, int width,
+                         Uint32 pixel)
+{
+    Uint32 alpha;
+
+#if defined(TTF_USE_NEON) && SDL_BYTEORDER == SDL_LIL_ENDIAN
+    uint8x16x4_t d;
+    const uint8x16_t b = vdupq_n_u8((Uint8)pixel);
+    const uint8x16_t g = vdupq_n_u8((Uint8)(pixel >> 8));
+    const uint8x16_t r = vdupq_n_u8((Uint8)(pixel >> 16));
+
+    while ( width >= 16 ) {
+        d = vld4q_u8((const Uint8 *)dst);
+        d.val[0] = b;
+        d.val[1] = g;
+        d.val[2] = r;
+        d.val[3] = vmaxq_u8(d.val[3], vld1q_u8(src));
+        vst4q_u8((Uint8 *)dst, d);
+        dst += 16;
+        src += 16;
+        width -= 16;
+    }
+    if ( width >= 8 ) {
+        uint8x8x4_t d8 = vld4_u8((const Uint8 *)dst);
+        d8.val[0] = vget_low_u8(b);
+        d8.val[1] = vget_low_u8(g);
+        d8.val[2] = vget_low_u8(r);
+        d8.val[3] = vmax_u8(d8.val[3], vld1_u8(src));
+        vst4_u8((Uint8 *)dst, d8);
+        dst += 8;
+        src += 8;
+        width -= 8;
+    }
+#elif defined(__SSE2__)
+    if ( TTF_hasSSE2 ) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i color = _mm_set1_epi32(pixel & 0x00FFFFFF);
+
+        while ( width >= 16 ) {
+            __m128i s = _mm_loadu_si128((const __m128i *)src);
+            /* Move each coverage byte to the top of its own pixel */
+            __m128i lo = _mm_unpacklo_epi8(zero, s);
+            __m128i hi = _mm_unpackhi_epi8(zero, s);
+            __m128i p0 = _mm_or_si128(_mm_unpacklo_epi16(zero, lo), color);
+            __m128i p1 = _mm_or_si128(_mm_unpackhi_epi16(zero, lo), color);
+            __m128i p2 = _mm_or_si128(_mm_unpacklo_epi16(zero, hi), color);
+            __m128i p3 = _mm_or_si128(_mm_unpackhi_epi16(zero, hi), color);
+            __m128i *d = (__m128i *)dst;
+
+            _mm_storeu_si128(d + 0, _mm_max_epu8(_mm_loadu_si128(d + 0), p0));
+            _mm_storeu_si128(d + 1, _mm_max_epu8(_mm_loadu_si128(d + 1), p1));
+            _mm_storeu_si128(d + 2, _mm_max_epu8(_mm_loadu_si128(d + 2), p2));
+            _mm_storeu_si128(d + 3, _mm_max_epu8(_mm_loadu_si128(d + 3), p3));
+            dst += 16;
+            src += 16;
+            width -= 16;
+        }
+        while ( width >= 4 ) {
+            __m128i s;
+            __m128i *d = (__m128i *)dst;
+
+            SDL_memcpy(&alpha, src, sizeof(alpha));
+            s = _mm_unpacklo_epi8(zero, _mm_cvtsi32_si128((int)alpha));
+            s = _mm_or_si128(_mm_unpacklo_epi16(zero, s), color);
+            _mm_storeu_si128(d, _mm_max_epu8(_mm_loadu_si128(d), s));
+            dst += 4;
+            src += 4;
+            width -= 4;
+        }
+    }
+#endif
+    while ( width-- > 0 ) {
+        alpha = (Uint32)*src++ << 24;
+        if ( alpha > (*dst & 0xFF000000) ) {
+            *dst = pixel | alpha;
+        }
+        ++dst;
+    }
+}
+
 SDL_Surface *TTF_RenderText_Solid(TTF_Font *font,
                 const char *text, SDL_Color fg)
 {
@@ -1404,7 +1965,7 @@ SDL_Surface *TTF_RenderUTF8_Solid(TTF_Font *font,
     first = SDL_TRUE;
     xstart = 0;
     while ( textlen > 0 ) {
-        Uint16 c = UTF8_getch(&text, &textlen);
+        Uint32 c = UTF8_getch(&text, &textlen);
         if ( c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED ) {
             continue;
         }
@@ -1449,9 +2010,11 @@ SDL_Surface *TTF_RenderUTF8_Solid(TTF_Font *font,
                 xstart + glyph->minx;
             src = current->buffer + row * current->pitch;
 
-            for ( col=width; col>0 && dst < dst_check; --col ) {
-                *dst++ |= *src++;
+            col = width;
+            if ( col > dst_check - dst ) {
+                col = (int)(dst_check - dst);
             }
+            TTF_maxRow8(dst, src, col);
         }
 
         xstart += glyph->advance;
@@ -1503,6 +2066,14 @@ SDL_Surface *TTF_RenderGlyph_Solid(TTF_Font *font, Uint16 ch, SDL_Color fg)
     return TTF_RenderUTF8_Solid(font, (char *)utf8, fg);
 }
 
+SDL_Surface *TTF_RenderGlyph32_Solid(TTF_Font *font, Uint32 ch, SDL_Color fg)
+{
+    Uint8 utf8[5];
+
+    UCS4_to_UTF8(ch, utf8);
+    return TTF_RenderUTF8_Solid(font, (char *)utf8, fg);
+}
+
 SDL_Surface *TTF_RenderText_Shaded(TTF_Font *font,
                 const char *text, SDL_Color fg, SDL_Color bg)
 {
@@ -1586,7 +2157,7 @@ SDL_Surface *TTF_RenderUTF8_Shaded(TTF_Font *font,
     first = SDL_FALSE;
     xstart = 0;
     while ( textlen > 0 ) {
-        Uint16 c = UTF8_getch(&text, &textlen);
+        Uint32 c = UTF8_getch(&text, &textlen);
         if ( c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED ) {
             continue;
         }
@@ -1630,9 +2201,11 @@ SDL_Surface *TTF_RenderUTF8_Shaded(TTF_Font *font,
                 (row+glyph->yoffset) * textbuf->pitch +
                 xstart + glyph->minx;
             src = current->buffer + row * current->pitch;
-            for ( col=width; col>0 && dst < dst_check; --col ) {
-                *dst++ |= *src++;
+            col = width;
+            if ( col > dst_check - dst ) {
+                col = (int)(dst_check - dst);
             }
+            TTF_maxRow8(dst, src, col);
         }
 
         xstart += glyph->advance;
@@ -1689,6 +2262,66 @@ SDL_Surface* TTF_RenderGlyph_Shaded( TTF_Font* font,
     return TTF_RenderUTF8_Shaded(font, (char *)utf8, fg, bg);
 }
 
+SDL_Surface* TTF_RenderGlyph32_Shaded( TTF_Font* font,
+                       Uint32 ch,
+                       SDL_Color fg,
+                       SDL_Color bg )
+{
+    Uint8 utf8[5];
+
+    UCS4_to_UTF8(ch, utf8);
+    return TTF_RenderUTF8_Shaded(font, (char *)utf8, fg, bg);
+}
+
+/* Blend the pixmap of a glyph into a 32-bit ARGB surface filled with the
+   text color, with the glyph origin at xstart and the top of its line of
+   text at ystart.  Where glyphs overlap the larger alpha wins.
+*/
+static void TTF_blendGlyph(const TTF_Font *font, const SDL_Surface *textbuf,
+                           const c_glyph *glyph, int xstart, int ystart,
+                           Uint32 pixel)
+{
+    /* Adding bound checking to avoid all kinds of memory corruption errors
+       that may occur. */
+    Uint32 *dst_check = (Uint32*)textbuf->pixels + textbuf->pitch/4 * textbuf->h;
+    Uint8 *src;
+    Uint32 *dst;
+    int row, col;
+    int width;
+
+    /* Ensure the width of the pixmap is correct. On some cases,
+     * freetype may report a larger pixmap than possible.*/
+    width = glyph->pixmap.width;
+    if (font->outline <= 0 && width > glyph->maxx - glyph->minx) {
+        width = glyph->maxx - glyph->minx;
+    }
+
+    ystart += glyph->yoffset;
+    for ( row = 0; row < glyph->pixmap.rows; ++row ) {
+        /* Make sure we don't go either over, or under the
+         * limit */
+        if ( row+ystart < 0 ) {
+            continue;
+        }
+        if ( row+ystart >= textbuf->h ) {
+            continue;
+        }
+        dst = (Uint32*) textbuf->pixels +
+            (row+ystart) * textbuf->pitch/4 +
+            xstart + glyph->minx;
+
+        /* Added code to adjust src pointer for pixmaps to
+         * account for pitch.
+         * */
+        src = (Uint8*) (glyph->pixmap.buffer + glyph->pixmap.pitch * row);
+        col = width;
+        if ( col > dst_check - dst ) {
+            col = (int)(dst_check - dst);
+        }
+        TTF_blendRow(dst, src, col, pixel);
+    }
+}
+
 SDL_Surface *TTF_RenderText_Blended(TTF_Font *font,
                 const char *text, SDL_Color fg)
 {
@@ -1715,12 +2348,8 @@ SDL_Surface *TTF_RenderUTF8_Blended(TTF_Font *font,
     int xstart;
     int width, height;
     SDL_Surface *textbuf;
-    Uint32 alpha;
     Uint32 pixel;
-    Uint8 *src;
-    Uint32 *dst;
-    Uint32 *dst_check;
-    int row, col;
+    int row;
     c_glyph *glyph;
     FT_Error error;
     FT_Long use_kerning;
@@ -1742,10 +2371,6 @@ SDL_Surface *TTF_RenderUTF8_Blended(TTF_Font *font,
         return(NULL);
     }
 
-    /* Adding bound checking to avoid all kinds of memory corruption errors
-       that may occur. */
-    dst_check = (Uint32*)textbuf->pixels + textbuf->pitch/4 * textbuf->h;
-
     /* check kerning */
     use_kerning = FT_HAS_KERNING( font->face ) && font->kerning;
 
@@ -1756,7 +2381,7 @@ SDL_Surface *TTF_RenderUTF8_Blended(TTF_Font *font,
     pixel = (fg.r<<16)|(fg.g<<8)|fg.b;
     SDL_FillRect(textbuf, NULL, pixel); /* Initialize with fg and 0 alpha */
     while ( textlen > 0 ) {
-        Uint16 c = UTF8_getch(&text, &textlen);
+        Uint32 c = UTF8_getch(&text, &textlen);
         if ( c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED ) {
             continue;
         }
@@ -1768,12 +2393,6 @@ SDL_Surface *TTF_RenderUTF8_Blended(TTF_Font *font,
             return NULL;
         }
         glyph = font->current;
-        /* Ensure the width of the pixmap is correct. On some cases,
-         * freetype may report a larger pixmap than possible.*/
-        width = glyph->pixmap.width;
-        if (font->outline <= 0 && width > glyph->maxx - glyph->minx) {
-            width = glyph->maxx - glyph->minx;
-        }
         /* do kerning, if possible AC-Patch */
         if ( use_kerning && prev_index && glyph->index ) {
             FT_Vector delta;
@@ -1787,28 +2406,7 @@ SDL_Surface *TTF_RenderUTF8_Blended(TTF_Font *font,
         }
         first = SDL_FALSE;
 
-        for ( row = 0; row < glyph->pixmap.rows; ++row ) {
-            /* Make sure we don't go either over, or under the
-             * limit */
-            if ( row+glyph->yoffset < 0 ) {
-                continue;
-            }
-            if ( row+glyph->yoffset >= textbuf->h ) {
-                continue;
-            }
-            dst = (Uint32*) textbuf->pixels +
-                (row+glyph->yoffset) * textbuf->pitch/4 +
-                xstart + glyph->minx;
-
-            /* Added code to adjust src pointer for pixmaps to
-             * account for pitch.
-             * */
-            src = (Uint8*) (glyph->pixmap.buffer + glyph->pixmap.pitch * row);
-            for ( col = width; col>0 && dst < dst_check; --col) {
-                alpha = *src++;
-                *dst++ |= pixel | (alpha << 24);
-            }
-        }
+        TTF_blendGlyph(font, textbuf, glyph, xstart, 0, pixel);
 
         xstart += glyph->advance;
         if ( TTF_HANDLE_STYLE_BOLD(font) ) {
@@ -1869,241 +2467,348 @@ SDL_Surface *TTF_RenderText_Blended_Wrapped(TTF_Font *font, const char *text, SD
     return surface;
 }
 
-static SDL_bool CharacterIsDelimiter(char c, const char *delimiters)
+/* Start a line of wrapped text at the given glyph */
+static w_line* Add_Wrapped_Line( w_text* wrapped, int first )
 {
-    while (*delimiters) {
-        if (c == *delimiters) {
-            return SDL_TRUE;
+    w_line *line;
+
+    if ( wrapped->num_lines == wrapped->max_lines ) {
+        int max_lines = wrapped->max_lines ? wrapped->max_lines * 2 : 16;
+        w_line *lines = (w_line *)realloc(wrapped->lines, max_lines * sizeof(*lines));
+        if ( lines == NULL ) {
+            TTF_SetError( "Out of memory" );
+            return NULL;
         }
-        ++delimiters;
+        wrapped->lines = lines;
+        wrapped->max_lines = max_lines;
     }
-    return SDL_FALSE;
+    line = &wrapped->lines[wrapped->num_lines++];
+    line->first = first;
+    line->last = first;
+    line->x = 0;
+    line->width = 0;
+    return line;
 }
 
-SDL_Surface *TTF_RenderUTF8_Blended_Wrapped(TTF_Font *font,
-                                    const char *text, SDL_Color fg, Uint32 wrapLength)
+/* Place the first glyph of a line as TTF_RenderUTF8_Blended() would */
+static int Wrapped_Line_Origin( const w_text* wrapped, w_line* line )
+{
+    const w_glyph *first = &wrapped->glyphs[line->first];
+
+    /* Compensate for the wrap around bug with negative minx's */
+    line->x = (first->left < 0) ? -first->left - first->x : -first->x;
+    return first->x;
+}
+
+static void Finish_Wrapped_Line( TTF_Font* font, w_line* line, int minx, int maxx )
+{
+    if ( line->last > line->first ) {
+        line->width = maxx - minx;
+        if ( font->outline > 0 ) {
+            line->width += font->outline * 2;
+        }
+    }
+}
+
+/* Lay out text into lines no wider than wrapLength in one pass.  Lines are
+   broken after spaces and tabs, within a word that doesn't fit on a line
+   by itself, and at line endings.  The glyphs are laid out along a single
+   line, so moving a word to the next line only needs its bounds again.
+ */
+static int Wrap_Text( TTF_Font* font, const char* text, Uint32 wrapLength, w_text* wrapped )
 {
-    SDL_bool first;
-    int xstart;
-    int width, height;
-    SDL_Surface *textbuf;
-    Uint32 alpha;
-    Uint32 pixel;
-    Uint8 *src;
-    Uint32 *dst;
-    Uint32 *dst_check;
-    int row, col;
-    c_glyph *glyph;
-    FT_Error error;
     FT_Long use_kerning;
     FT_UInt prev_index = 0;
-    const int lineSpace = 2;
-    int line, numLines, rowSize;
-    char *str, **strLines;
+    FT_Error error;
+    c_glyph *glyph;
+    w_glyph *laid;
+    w_line *line;
+    SDL_bool prev_cr = SDL_FALSE;
+    SDL_bool prev_space = SDL_FALSE;
+    int xstart = 0;
+    int origin = 0;
+    int minx = 0, maxx = 0;     /* The bounds of the line, without trailing space */
+    int word = -1;              /* The last word after white space in the line */
+    int word_minx = 0, word_maxx = 0, word_last = 0;
+    int miny = 0;
+    int i, j, z;
     size_t textlen;
 
-    TTF_CHECKPOINTER(text, NULL);
+    /* check kerning */
+    use_kerning = FT_HAS_KERNING( font->face ) && font->kerning;
 
-    /* Get the dimensions of the text surface */
-    if ( (TTF_SizeUTF8(font, text, &width, &height) < 0) || !width ) {
-        TTF_SetError("Text has zero width");
-        return(NULL);
+    /* There's at most one character per byte */
+    textlen = SDL_strlen(text);
+    if ( textlen > (size_t)wrapped->max_glyphs ) {
+        w_glyph *glyphs = (w_glyph *)realloc(wrapped->glyphs, textlen * sizeof(*glyphs));
+        if ( glyphs == NULL ) {
+            TTF_SetError( "Out of memory" );
+            return -1;
+        }
+        wrapped->glyphs = glyphs;
+        wrapped->max_glyphs = (int)textlen;
     }
+    wrapped->num_glyphs = 0;
+    wrapped->num_lines = 0;
+    line = Add_Wrapped_Line( wrapped, 0 );
+    if ( line == NULL ) {
+        return -1;
+    }
+
+    while ( textlen > 0 ) {
+        Uint32 c = UTF8_getch(&text, &textlen);
+        if ( c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED ) {
+            continue;
+        }
 
-    numLines = 1;
-    str = NULL;
-    strLines = NULL;
-    if ( wrapLength > 0 && *text ) {
-        const char *wrapDelims = " \t\r\n";
-        int w, h;
-        int line = 0;
-        char *spot, *tok, *next_tok, *end;
-        char delim;
-        size_t str_len = SDL_strlen(text);
-
-        numLines = 0;
-
-        str = SDL_stack_alloc(char, str_len+1);
-        if ( str == NULL ) {
-            TTF_SetError("Out of memory");
-            return(NULL);
-        }
-
-        SDL_strlcpy(str, text, str_len+1);
-        tok = str;
-        end = str + str_len;
-        do {
-            strLines = (char **)SDL_realloc(strLines, (numLines+1)*sizeof(*strLines));
-            if (!strLines) {
-                TTF_SetError("Out of memory");
-                return(NULL);
+        /* Lines end with \n, \r or \r\n */
+        if ( c == '\n' || c == '\r' ) {
+            if ( c == '\n' && prev_cr ) {
+                prev_cr = SDL_FALSE;
+                continue;
             }
-            strLines[numLines++] = tok;
+            prev_cr = (c == '\r');
 
-            /* Look for the end of the line */
-            if ((spot = SDL_strchr(tok, '\r')) != NULL ||
-                (spot = SDL_strchr(tok, '\n')) != NULL) {
-                if (*spot == '\r') {
-                    ++spot;
-                }
-                if (*spot == '\n') {
-                    ++spot;
-                }
-            } else {
-                spot = end;
+            Finish_Wrapped_Line( font, line, minx, maxx );
+            line = Add_Wrapped_Line( wrapped, wrapped->num_glyphs );
+            if ( line == NULL ) {
+                return -1;
             }
-            next_tok = spot;
-
-            /* Get the longest string that will fit in the desired space */
-            for ( ; ; ) {
-                /* Strip trailing whitespace */
-                while ( spot > tok &&
-                        CharacterIsDelimiter(spot[-1], wrapDelims) ) {
-                    --spot;
-                }
-                if ( spot == tok ) {
-                    if (CharacterIsDelimiter(*spot, wrapDelims)) {
-                        *spot = '\0';
-                    }
-                    break;
-                }
-                delim = *spot;
-                *spot = '\0';
+            prev_index = 0;
+            prev_space = SDL_FALSE;
+            minx = maxx = 0;
+            word = -1;
+            continue;
+        }
+        prev_cr = SDL_FALSE;
 
-                TTF_SizeUTF8(font, tok, &w, &h);
-                if ((Uint32)w <= wrapLength) {
-                    break;
-                } else {
-                    /* Back up and try again... */
-                    *spot = delim;
-                }
+        error = Find_Glyph(font, c, CACHED_METRICS);
+        if ( error ) {
+            TTF_SetFTError("Couldn't find glyph", error);
+            return -1;
+        }
+        glyph = font->current;
 
-                while ( spot > tok &&
-                        !CharacterIsDelimiter(spot[-1], wrapDelims) ) {
-                    --spot;
-                }
-                if ( spot > tok ) {
-                    next_tok = spot;
-                }
+        /* handle kerning */
+        if ( use_kerning && prev_index && glyph->index ) {
+            FT_Vector delta;
+            FT_Get_Kerning( font->face, prev_index, glyph->index, ft_kerning_default, &delta );
+            xstart += delta.x >> 6;
+        }
+        prev_index = glyph->index;
+
+        i = wrapped->num_glyphs++;
+        laid = &wrapped->glyphs[i];
+        laid->ch = c;
+        laid->x = xstart;
+        laid->left = glyph->minx;
+        if ( TTF_HANDLE_STYLE_BOLD(font) ) {
+            xstart += font->glyph_overhang;
+        }
+        if ( glyph->advance > glyph->maxx ) {
+            z = xstart + glyph->advance;
+        } else {
+            z = xstart + glyph->maxx;
+        }
+        laid->right = z - laid->x;
+        xstart += glyph->advance;
+        if ( glyph->miny < miny ) {
+            miny = glyph->miny;
+        }
+
+        if ( i == line->first ) {
+            origin = Wrapped_Line_Origin( wrapped, line );
+        }
+
+        /* White space hangs past the end of the line */
+        if ( c == ' ' || c == '\t' ) {
+            prev_space = SDL_TRUE;
+            continue;
+        }
+        if ( prev_space && line->last > line->first ) {
+            word = i;
+            word_minx = minx;
+            word_maxx = maxx;
+            word_last = line->last;
+        }
+        prev_space = SDL_FALSE;
+
+        z = SDL_min(minx, laid->x - origin + laid->left);
+        j = SDL_max(maxx, laid->x - origin + laid->right);
+        if ( wrapLength > 0 && line->last > line->first &&
+             (Uint32)(j - z + (font->outline > 0 ? font->outline * 2 : 0)) > wrapLength ) {
+            if ( word > line->first ) {
+                /* Move the last word to the next line */
+                line->last = word_last;
+                Finish_Wrapped_Line( font, line, word_minx, word_maxx );
+                line = Add_Wrapped_Line( wrapped, word );
+            } else {
+                /* Break the word, it's too long for a line */
+                Finish_Wrapped_Line( font, line, minx, maxx );
+                line = Add_Wrapped_Line( wrapped, i );
+            }
+            if ( line == NULL ) {
+                return -1;
+            }
+            origin = Wrapped_Line_Origin( wrapped, line );
+            minx = maxx = 0;
+            for ( j = line->first; j <= i; ++j ) {
+                laid = &wrapped->glyphs[j];
+                minx = SDL_min(minx, laid->x - origin + laid->left);
+                maxx = SDL_max(maxx, laid->x - origin + laid->right);
             }
-            tok = next_tok;
-        } while (tok < end);
+            word = -1;
+        } else {
+            minx = z;
+            maxx = j;
+        }
+        line->last = i + 1;
     }
+    Finish_Wrapped_Line( font, line, minx, maxx );
 
-    /* Create the target surface */
-    textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE,
-            (numLines > 1) ? wrapLength : width,
-            height * numLines + (lineSpace * (numLines - 1)),
-            32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
-    if ( textbuf == NULL ) {
-        if ( strLines ) {
-            SDL_free(strLines);
-            SDL_stack_free(str);
+    /* Lines are as wide as the wrap length, or the text if that's less */
+    wrapped->width = 0;
+    for ( i = 0; i < wrapped->num_lines; ++i ) {
+        wrapped->width = SDL_max(wrapped->width, wrapped->lines[i].width);
+    }
+    if ( wrapLength > 0 && wrapped->num_lines > 1 &&
+         wrapped->width < (int)wrapLength ) {
+        wrapped->width = (int)wrapLength;
+    }
+    wrapped->line_height = TTF_text_height(font, miny);
+    wrapped->height = wrapped->line_height * wrapped->num_lines +
+                      font->wrapped_spacing * (wrapped->num_lines - 1);
+    if ( wrapped->height < wrapped->line_height ) {
+        wrapped->height = wrapped->line_height;
+    }
+    return 0;
+}
+
+/* Gets the x offset of a line of wrapped text for the alignment */
+static int TTF_alignWrappedLine(const TTF_Font *font, const w_text *wrapped, const w_line *line)
+{
+    switch ( font->wrapped_align ) {
+    case TTF_WRAPPED_ALIGN_CENTER:
+        return (wrapped->width - line->width) / 2;
+    case TTF_WRAPPED_ALIGN_RIGHT:
+        return wrapped->width - line->width;
+    default:
+        return 0;
+    }
+}
+
+/* Draw a blended line of underline_height (+ optional outline) under a
+   line of wrapped text.
+*/
+static void TTF_drawLine_Wrapped(const TTF_Font *font, SDL_Surface *textbuf,
+                                 int x, int y, int width, const Uint32 color)
+{
+    SDL_Rect rect;
+
+    rect.x = x;
+    rect.y = y;
+    rect.w = width;
+    rect.h = font->underline_height;
+    /* Take outline into account */
+    if ( font->outline > 0 ) {
+        rect.h += font->outline * 2;
+    }
+    SDL_FillRect(textbuf, &rect, color | 0xFF000000);
+}
+
+int TTF_SizeUTF8_Wrapped(TTF_Font *font, const char *text, Uint32 wrapLength, int *w, int *h)
+{
+    w_text wrapped;
+    int status;
+
+    TTF_CHECKPOINTER(text, -1);
+
+    SDL_zero(wrapped);
+    status = Wrap_Text(font, text, wrapLength, &wrapped);
+    if ( status == 0 ) {
+        if ( w ) {
+            *w = wrapped.width;
+        }
+        if ( h ) {
+            *h = wrapped.height;
         }
-        return(NULL);
     }
+    free(wrapped.glyphs);
+    free(wrapped.lines);
+    return status;
+}
+
+SDL_Surface *TTF_RenderUTF8_Blended_Wrapped(TTF_Font *font,
+                                    const char *text, SDL_Color fg, Uint32 wrapLength)
+{
+    w_text wrapped;
+    const w_line *line;
+    SDL_Surface *textbuf = NULL;
+    Uint32 pixel;
+    FT_Error error;
+    int x, y, i, l;
 
-    rowSize = textbuf->pitch/4 * height;
+    TTF_CHECKPOINTER(text, NULL);
 
-    /* Adding bound checking to avoid all kinds of memory corruption errors
-     that may occur. */
-    dst_check = (Uint32*)textbuf->pixels + textbuf->pitch/4 * textbuf->h;
+    /* Lay out the lines and get the dimensions of the text surface */
+    SDL_zero(wrapped);
+    if ( Wrap_Text(font, text, wrapLength, &wrapped) < 0 ) {
+        goto done;
+    }
+    if ( !wrapped.width ) {
+        TTF_SetError("Text has zero width");
+        goto done;
+    }
 
-    /* check kerning */
-    use_kerning = FT_HAS_KERNING( font->face ) && font->kerning;
+    /* Create the target surface */
+    textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE, wrapped.width, wrapped.height,
+            32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    if ( textbuf == NULL ) {
+        goto done;
+    }
 
     /* Load and render each character */
     pixel = (fg.r<<16)|(fg.g<<8)|fg.b;
     SDL_FillRect(textbuf, NULL, pixel); /* Initialize with fg and 0 alpha */
 
-    for ( line = 0; line < numLines; line++ ) {
-        if ( strLines ) {
-            text = strLines[line];
-        }
-        textlen = SDL_strlen(text);
-        first = SDL_TRUE;
-        xstart = 0;
-        while ( textlen > 0 ) {
-            Uint16 c = UTF8_getch(&text, &textlen);
-            if ( c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED ) {
-                continue;
-            }
+    for ( l = 0; l < wrapped.num_lines; ++l ) {
+        line = &wrapped.lines[l];
+        x = TTF_alignWrappedLine(font, &wrapped, line);
+        y = l * (wrapped.line_height + font->wrapped_spacing);
 
-            error = Find_Glyph(font, c, CACHED_METRICS|CACHED_PIXMAP);
+        for ( i = line->first; i < line->last; ++i ) {
+            error = Find_Glyph(font, wrapped.glyphs[i].ch, CACHED_METRICS|CACHED_PIXMAP);
             if ( error ) {
                 TTF_SetFTError("Couldn't find glyph", error);
                 SDL_FreeSurface( textbuf );
-                return NULL;
-            }
-            glyph = font->current;
-            /* Ensure the width of the pixmap is correct. On some cases,
-             * freetype may report a larger pixmap than possible.*/
-            width = glyph->pixmap.width;
-            if ( font->outline <= 0 && width > glyph->maxx - glyph->minx ) {
-                width = glyph->maxx - glyph->minx;
+                textbuf = NULL;
+                goto done;
             }
-            /* do kerning, if possible AC-Patch */
-            if ( use_kerning && prev_index && glyph->index ) {
-                FT_Vector delta;
-                FT_Get_Kerning( font->face, prev_index, glyph->index, ft_kerning_default, &delta );
-                xstart += delta.x >> 6;
-            }
-
-            /* Compensate for the wrap around bug with negative minx's */
-            if ( first && (glyph->minx < 0) ) {
-                xstart -= glyph->minx;
-            }
-            first = SDL_FALSE;
-
-            for ( row = 0; row < glyph->pixmap.rows; ++row ) {
-                /* Make sure we don't go either over, or under the
-                 * limit */
-                if ( row+glyph->yoffset < 0 ) {
-                    continue;
-                }
-                if ( row+glyph->yoffset >= textbuf->h ) {
-                    continue;
-                }
-                dst =  ((Uint32*)textbuf->pixels + rowSize * line) +
-                (row+glyph->yoffset) * textbuf->pitch/4 +
-                xstart + glyph->minx;
-
-                /* Added code to adjust src pointer for pixmaps to
-                 * account for pitch.
-                 * */
-                src = (Uint8*) (glyph->pixmap.buffer + glyph->pixmap.pitch * row);
-                for ( col = width; col>0 && dst < dst_check; --col) {
-                    alpha = *src++;
-                    *dst++ |= pixel | (alpha << 24);
-                }
-            }
-
-            xstart += glyph->advance;
-            if ( TTF_HANDLE_STYLE_BOLD(font) ) {
-                xstart += font->glyph_overhang;
-            }
-            prev_index = glyph->index;
+            TTF_blendGlyph(font, textbuf, font->current,
+                           x + line->x + wrapped.glyphs[i].x, y, pixel);
+        }
+        if ( !line->width ) {
+            continue;
         }
 
-        /* Handle the underline style *
+        /* Handle the underline style */
         if ( TTF_HANDLE_STYLE_UNDERLINE(font) ) {
-            row = TTF_underline_top_row(font);
-            TTF_drawLine_Blended(font, textbuf, row, pixel);
+            TTF_drawLine_Wrapped(font, textbuf, x,
+                                 y + SDL_max(TTF_underline_top_row(font), 0),
+                                 line->width, pixel);
         }
-        */
 
-        /* Handle the strikethrough style *
+        /* Handle the strikethrough style */
         if ( TTF_HANDLE_STYLE_STRIKETHROUGH(font) ) {
-            row = TTF_strikethrough_top_row(font);
-            TTF_drawLine_Blended(font, textbuf, row, pixel);
+            TTF_drawLine_Wrapped(font, textbuf, x,
+                                 y + SDL_max(TTF_strikethrough_top_row(font), 0),
+                                 line->width, pixel);
         }
-        */
     }
 
-    if ( strLines ) {
-        SDL_free(strLines);
-        SDL_stack_free(str);
-    }
+done:
+    free(wrapped.glyphs);
+    free(wrapped.lines);
     return(textbuf);
 }
 
@@ -2135,47 +2840,1024 @@ SDL_Surface *TTF_RenderGlyph_Blended(TTF_Font *font, Uint16 ch, SDL_Color fg)
     return TTF_RenderUTF8_Blended(font, (char *)utf8, fg);
 }
 
-void TTF_SetFontStyle( TTF_Font* font, int style )
+SDL_Surface *TTF_RenderGlyph32_Blended(TTF_Font *font, Uint32 ch, SDL_Color fg)
 {
-    int prev_style = font->style;
-    font->style = style | font->face_style;
+    Uint8 utf8[5];
 
-    /* Flush the cache if the style has changed.
-     * Ignore UNDERLINE which does not impact glyph drawning.
-     * */
-    if ( (font->style | TTF_STYLE_NO_GLYPH_CHANGE ) != ( prev_style | TTF_STYLE_NO_GLYPH_CHANGE )) {
-        Flush_Cache( font );
+    UCS4_to_UTF8(ch, utf8);
+    return TTF_RenderUTF8_Blended(font, (char *)utf8, fg);
+}
+
+/* Find the slot holding a packed glyph, or the empty slot where it would go */
+static int Find_Atlas_Slot( const TTF_FontAtlas* atlas, Uint32 ch, int style, int outline )
+{
+    int mask = atlas->glyph_slots - 1;
+    int slot = (int)(Hash_Glyph( ch, style, outline ) & mask);
+
+    for ( ; ; ) {
+        const a_glyph *glyph = &atlas->glyphs[slot];
+        if ( !glyph->stored ||
+             (glyph->ch == ch && glyph->style == style && glyph->outline == outline) ) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
     }
 }
 
-int TTF_GetFontStyle( const TTF_Font* font )
+static int Grow_Atlas( TTF_FontAtlas* atlas )
 {
-    return font->style;
+    a_glyph *old_glyphs = atlas->glyphs;
+    int old_slots = atlas->glyph_slots;
+    int i;
+
+    atlas->glyph_slots = old_slots ? old_slots * 2 : GLYPH_CACHE_MIN_SLOTS;
+    atlas->glyphs = (a_glyph *)calloc( atlas->glyph_slots, sizeof(*atlas->glyphs) );
+    if ( !atlas->glyphs ) {
+        atlas->glyphs = old_glyphs;
+        atlas->glyph_slots = old_slots;
+        return -1;
+    }
+    for ( i = 0; i < old_slots; ++i ) {
+        const a_glyph *glyph = &old_glyphs[i];
+        if ( glyph->stored ) {
+            atlas->glyphs[Find_Atlas_Slot( atlas, glyph->ch, glyph->style, glyph->outline )] = *glyph;
+        }
+    }
+    free( old_glyphs );
+    return 0;
 }
 
-void TTF_SetFontOutline( TTF_Font* font, int outline )
+/* Where the parabolas of the distance transform rooted at q and r meet */
+static __inline__ double TTF_parabolaIntersection( const double* f, int q, int r )
 {
-    font->outline = outline;
-    Flush_Cache( font );
+    return ((f[q] + q * q) - (f[r] + r * r)) / (2 * (q - r));
 }
 
-int TTF_GetFontOutline( const TTF_Font* font )
+/* The exact squared Euclidean distance transform of n samples in the grid
+   with the given stride, in place, after Felzenszwalb and Huttenlocher.
+   The f, v and z scratch space holds n, n and n + 1 values.
+ */
+static void TTF_distanceTransform1D( double* grid, int stride, int n,
+                                     double* f, int* v, double* z )
 {
-    return font->outline;
+    double s;
+    int q, k;
+
+    for ( q = 0; q < n; ++q ) {
+        f[q] = grid[q * stride];
+    }
+
+    /* Find the lower envelope of the parabolas rooted at each sample */
+    k = 0;
+    v[0] = 0;
+    z[0] = -DISTANCE_INFINITY;
+    z[1] = DISTANCE_INFINITY;
+    for ( q = 1; q < n; ++q ) {
+        s = TTF_parabolaIntersection(f, q, v[k]);
+        while ( s <= z[k] ) {
+            --k;
+            s = TTF_parabolaIntersection(f, q, v[k]);
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = DISTANCE_INFINITY;
+    }
+
+    k = 0;
+    for ( q = 0; q < n; ++q ) {
+        while ( z[k + 1] < q ) {
+            ++k;
+        }
+        grid[q * stride] = (double)(q - v[k]) * (q - v[k]) + f[v[k]];
+    }
 }
 
-void TTF_SetFontHinting( TTF_Font* font, int hinting )
+static void TTF_distanceTransform( double* grid, int width, int height,
+                                   double* f, int* v, double* z )
 {
-    if (hinting == TTF_HINTING_LIGHT)
-        font->hinting = FT_LOAD_TARGET_LIGHT;
-    else if (hinting == TTF_HINTING_MONO)
-        font->hinting = FT_LOAD_TARGET_MONO;
-    else if (hinting == TTF_HINTING_NONE)
-        font->hinting = FT_LOAD_NO_HINTING;
-    else
-        font->hinting = 0;
+    int i;
 
-    Flush_Cache( font );
+    for ( i = 0; i < width; ++i ) {
+        TTF_distanceTransform1D(grid + i, width, height, f, v, z);
+    }
+    for ( i = 0; i < height; ++i ) {
+        TTF_distanceTransform1D(grid + i * width, 1, width, f, v, z);
+    }
+}
+
+/* Fill the surface with the signed distance field of a glyph's coverage,
+   padded by spread pixels on every side.  Partly covered pixels place the
+   edge inside them, so the field keeps the antialiased outline instead of
+   snapping it to whole pixels.
+ */
+static int TTF_distanceField( const FT_Bitmap* pixmap, int width, int rows,
+                              int spread, SDL_Surface* surface )
+{
+    const int w = surface->w;
+    const int h = surface->h;
+    const int n = SDL_max(w, h);
+    double *outer, *inner, *f, *z;
+    int *v;
+    int row, col;
+
+    outer = (double *)malloc( (w * h * 2 + n * 2 + 1) * sizeof(double) );
+    v = (int *)malloc( n * sizeof(int) );
+    if ( outer == NULL || v == NULL ) {
+        free( outer );
+        free( v );
+        TTF_SetError( "Out of memory" );
+        return -1;
+    }
+    inner = outer + w * h;
+    f = inner + w * h;
+    z = f + n;
+
+    /* The squared distances to the outline from outside and inside it */
+    for ( row = 0; row < h; ++row ) {
+        for ( col = 0; col < w; ++col ) {
+            const int x = col - spread;
+            const int y = row - spread;
+            const int i = row * w + col;
+            double a = 0.0;
+
+            if ( x >= 0 && x < width && y >= 0 && y < rows ) {
+                a = pixmap->buffer[y * pixmap->pitch + x] / 255.0;
+            }
+            if ( a >= 1.0 ) {
+                outer[i] = 0.0;
+                inner[i] = DISTANCE_INFINITY;
+            } else if ( a <= 0.0 ) {
+                outer[i] = DISTANCE_INFINITY;
+                inner[i] = 0.0;
+            } else {
+                outer[i] = a < 0.5 ? (0.5 - a) * (0.5 - a) : 0.0;
+                inner[i] = a > 0.5 ? (a - 0.5) * (a - 0.5) : 0.0;
+            }
+        }
+    }
+    TTF_distanceTransform(outer, w, h, f, v, z);
+    TTF_distanceTransform(inner, w, h, f, v, z);
+
+    for ( row = 0; row < h; ++row ) {
+        Uint32 *dst = (Uint32*) ((Uint8*) surface->pixels + surface->pitch * row);
+        for ( col = 0; col < w; ++col ) {
+            const int i = row * w + col;
+            const double d = SDL_sqrt(inner[i]) - SDL_sqrt(outer[i]);
+            int alpha = (int)SDL_floor(128.0 + d * 255.0 / (2 * spread) + 0.5);
+
+            if ( alpha < 0 ) {
+                alpha = 0;
+            } else if ( alpha > 255 ) {
+                alpha = 255;
+            }
+            dst[col] = 0x00FFFFFF | ((Uint32) alpha << 24);
+        }
+    }
+    free( outer );
+    free( v );
+    return 0;
+}
+
+/* Render a glyph and pack it into the atlas pages as white with alpha,
+   so it can be drawn in any color with the texture color modulation.
+ */
+static int Pack_Atlas_Glyph( TTF_FontAtlas* atlas, Uint32 ch, a_glyph* packed )
+{
+    TTF_Font *font = atlas->font;
+    c_glyph *glyph;
+    SDL_Surface *surface;
+    FT_Error error;
+    Uint8 *src;
+    Uint32 *dst;
+    int row, col;
+
+    error = Find_Glyph(font, ch, CACHED_METRICS|CACHED_PIXMAP);
+    if ( error ) {
+        TTF_SetFTError("Couldn't find glyph", error);
+        return -1;
+    }
+    glyph = font->current;
+
+    packed->index = glyph->index;
+    packed->minx = glyph->minx;
+    packed->maxx = glyph->maxx;
+    packed->yoffset = glyph->yoffset;
+    packed->advance = glyph->advance;
+    packed->texture = NULL;
+
+    /* The same width correction as in TTF_RenderUTF8_Blended() */
+    packed->width = glyph->pixmap.width;
+    if ( font->outline <= 0 && packed->width > glyph->maxx - glyph->minx ) {
+        packed->width = glyph->maxx - glyph->minx;
+    }
+    packed->rows = glyph->pixmap.rows;
+    if ( packed->width <= 0 || packed->rows <= 0 ) {
+        return 0;
+    }
+
+    surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
+                               packed->width + atlas->spread * 2,
+                               packed->rows + atlas->spread * 2, 32,
+                               0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    if ( surface == NULL ) {
+        return -1;
+    }
+    if ( atlas->spread > 0 ) {
+        if ( TTF_distanceField(&glyph->pixmap, packed->width, packed->rows,
+                               atlas->spread, surface) < 0 ) {
+            SDL_FreeSurface( surface );
+            return -1;
+        }
+    } else {
+        for ( row = 0; row < packed->rows; ++row ) {
+            src = (Uint8*) (glyph->pixmap.buffer + glyph->pixmap.pitch * row);
+            dst = (Uint32*) ((Uint8*) surface->pixels + surface->pitch * row);
+            for ( col = 0; col < packed->width; ++col ) {
+                dst[col] = 0x00FFFFFF | ((Uint32) src[col] << 24);
+            }
+        }
+    }
+    packed->texture = SDL_CreateAtlasTextureFromSurface(atlas->pages, surface);
+    SDL_FreeSurface( surface );
+    if ( packed->texture == NULL ) {
+        return -1;
+    }
+    if ( atlas->spread > 0 &&
+         SDL_SetTextureDistanceField(packed->texture, atlas->spread, 128) < 0 ) {
+        SDL_DestroyTexture( packed->texture );
+        packed->texture = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+/* Find a glyph in the current style and outline, packing it if it's new.
+   The glyph may move when another one is packed.
+ */
+static a_glyph* Find_Atlas_Glyph( TTF_FontAtlas* atlas, Uint32 ch )
+{
+    TTF_Font *font = atlas->font;
+    int style = font->style & ~TTF_STYLE_NO_GLYPH_CHANGE;
+    int outline = font->outline;
+    a_glyph *glyph;
+
+    if ( atlas->glyph_slots ) {
+        glyph = &atlas->glyphs[Find_Atlas_Slot( atlas, ch, style, outline )];
+        if ( glyph->stored ) {
+            return glyph;
+        }
+    }
+
+    if ( (atlas->glyph_count + 1) * 4 > atlas->glyph_slots * 3 ) {
+        if ( Grow_Atlas( atlas ) < 0 ) {
+            TTF_SetError( "Out of memory" );
+            return NULL;
+        }
+    }
+    glyph = &atlas->glyphs[Find_Atlas_Slot( atlas, ch, style, outline )];
+    if ( Pack_Atlas_Glyph( atlas, ch, glyph ) < 0 ) {
+        return NULL;
+    }
+    glyph->stored = 1;
+    glyph->ch = ch;
+    glyph->style = style;
+    glyph->outline = outline;
+    ++atlas->glyph_count;
+    return glyph;
+}
+
+/* Copy from the atlas pages.  The OpenGL ES 2 renderer batches copies from
+   the same page in the same color into one draw, the others draw each glyph
+   on its own.
+ */
+static int Copy_Atlas_Texture( TTF_FontAtlas* atlas, SDL_Texture* texture,
+                               const SDL_Rect* srcrect, const SDL_Rect* dstrect,
+                               SDL_Color fg )
+{
+    if ( SDL_SetTextureColorMod(texture, fg.r, fg.g, fg.b) < 0 ||
+         SDL_SetTextureAlphaMod(texture, fg.a) < 0 ) {
+        return -1;
+    }
+    return SDL_RenderCopy(atlas->renderer, texture, srcrect, dstrect);
+}
+
+/* Place a span of the layout at the scale, rounding both of its ends so
+   spans that touch still touch after scaling.
+ */
+static void Scale_Atlas_Span( int origin, int start, int length, float scale,
+                              int* position, int* size )
+{
+    int first = (int)SDL_floor(start * scale + 0.5);
+    int last = (int)SDL_floor((start + length) * scale + 0.5);
+
+    *position = origin + first;
+    *size = last - first;
+}
+
+/* Copy a glyph with its pen at xstart along text drawn at (x, y) */
+static int Copy_Atlas_Glyph( TTF_FontAtlas* atlas, const a_glyph* glyph,
+                             int x, int y, int xstart, float scale, SDL_Color fg )
+{
+    const int pad = atlas->spread;
+    SDL_Rect dstrect;
+
+    if ( !glyph->texture ) {
+        return 0;
+    }
+    Scale_Atlas_Span(x, xstart + glyph->minx - pad, glyph->width + pad * 2,
+                     scale, &dstrect.x, &dstrect.w);
+    Scale_Atlas_Span(y, glyph->yoffset - pad, glyph->rows + pad * 2,
+                     scale, &dstrect.y, &dstrect.h);
+    return Copy_Atlas_Texture(atlas, glyph->texture, NULL, &dstrect, fg);
+}
+
+static int Draw_Atlas_Line( TTF_FontAtlas* atlas, int x, int y, int width,
+                            int row, float scale, SDL_Color fg )
+{
+    TTF_Font *font = atlas->font;
+    SDL_Rect srcrect;
+    SDL_Rect dstrect;
+    int height;
+
+    /* The middle of the square, so filtering doesn't blur the edges */
+    srcrect.x = 1;
+    srcrect.y = 1;
+    srcrect.w = 1;
+    srcrect.h = 1;
+
+    height = font->underline_height;
+    if ( font->outline > 0 ) {
+        height += font->outline * 2;
+    }
+    Scale_Atlas_Span(x, 0, width, scale, &dstrect.x, &dstrect.w);
+    Scale_Atlas_Span(y, SDL_max(row, 0), height, scale, &dstrect.y, &dstrect.h);
+    return Copy_Atlas_Texture(atlas, atlas->line, &srcrect, &dstrect, fg);
+}
+
+/* Draw the underline and strikethrough styles across text of the width */
+static int Draw_Atlas_Lines( TTF_FontAtlas* atlas, int x, int y, int width,
+                             float scale, SDL_Color fg )
+{
+    TTF_Font *font = atlas->font;
+
+    if ( width <= 0 ) {
+        return 0;
+    }
+
+    /* Handle the underline style */
+    if ( TTF_HANDLE_STYLE_UNDERLINE(font) ) {
+        if ( Draw_Atlas_Line(atlas, x, y, width, TTF_underline_top_row(font), scale, fg) < 0 ) {
+            return -1;
+        }
+    }
+
+    /* Handle the strikethrough style */
+    if ( TTF_HANDLE_STYLE_STRIKETHROUGH(font) ) {
+        if ( Draw_Atlas_Line(atlas, x, y, width, TTF_strikethrough_top_row(font), scale, fg) < 0 ) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static TTF_FontAtlas *Create_Font_Atlas( TTF_Font* font, SDL_Renderer* renderer,
+                                        int spread )
+{
+    TTF_FontAtlas *atlas;
+    SDL_RendererInfo info;
+    SDL_Surface *line;
+    int w, h;
+
+    TTF_CHECKPOINTER(font, NULL);
+    TTF_CHECKPOINTER(renderer, NULL);
+
+    if ( SDL_GetRendererInfo(renderer, &info) < 0 ) {
+        return NULL;
+    }
+
+    /* Make room for a good number of the largest glyphs in each page */
+    w = FONT_ATLAS_MIN_PAGE_SIZE;
+    while ( w < (font->height + spread * 2) * 8 ) {
+        w *= 2;
+    }
+    h = w;
+    if ( info.max_texture_width && w > info.max_texture_width ) {
+        w = info.max_texture_width;
+    }
+    if ( info.max_texture_height && h > info.max_texture_height ) {
+        h = info.max_texture_height;
+    }
+
+    atlas = (TTF_FontAtlas *)malloc(sizeof *atlas);
+    if ( atlas == NULL ) {
+        TTF_SetError( "Out of memory" );
+        return NULL;
+    }
+    memset(atlas, 0, sizeof(*atlas));
+    atlas->font = font;
+    atlas->renderer = renderer;
+    atlas->spread = spread;
+
+    atlas->pages = SDL_CreateTextureAtlas(renderer, SDL_PIXELFORMAT_ARGB8888, w, h);
+    if ( atlas->pages == NULL ) {
+        free( atlas );
+        return NULL;
+    }
+
+    line = SDL_CreateRGBSurface(SDL_SWSURFACE, 3, 3, 32,
+                               0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    if ( line ) {
+        SDL_FillRect(line, NULL, 0xFFFFFFFF);
+        atlas->line = SDL_CreateAtlasTextureFromSurface(atlas->pages, line);
+        SDL_FreeSurface( line );
+    }
+    if ( atlas->line == NULL ) {
+        SDL_DestroyTextureAtlas( atlas->pages );
+        free( atlas );
+        return NULL;
+    }
+
+    atlas->next = font->atlases;
+    font->atlases = atlas;
+    return atlas;
+}
+
+TTF_FontAtlas *TTF_CreateFontAtlas(TTF_Font *font, SDL_Renderer *renderer)
+{
+    return Create_Font_Atlas(font, renderer, 0);
+}
+
+TTF_FontAtlas *TTF_CreateFontAtlas_SDF(TTF_Font *font, SDL_Renderer *renderer,
+                int spread)
+{
+    TTF_FontAtlas *atlas;
+
+    if ( spread <= 0 ) {
+        TTF_SetError( "Invalid distance field spread" );
+        return NULL;
+    }
+    atlas = Create_Font_Atlas(font, renderer, spread);
+    if ( atlas == NULL ) {
+        return NULL;
+    }
+
+    /* Find out now if the renderer can't draw distance fields */
+    if ( SDL_SetTextureDistanceField(atlas->line, spread, 128) < 0 ) {
+        TTF_DestroyFontAtlas(atlas);
+        return NULL;
+    }
+    SDL_SetTextureDistanceField(atlas->line, 0, 128);
+    return atlas;
+}
+
+int TTF_DrawText_Atlas(TTF_FontAtlas *atlas,
+                const char *text, int x, int y, SDL_Color fg)
+{
+    return TTF_DrawText_Atlas_Scaled(atlas, text, x, y, 1.0f, fg);
+}
+
+int TTF_DrawUTF8_Atlas(TTF_FontAtlas *atlas,
+                const char *text, int x, int y, SDL_Color fg)
+{
+    return TTF_DrawUTF8_Atlas_Scaled(atlas, text, x, y, 1.0f, fg);
+}
+
+int TTF_DrawUNICODE_Atlas(TTF_FontAtlas *atlas,
+                const Uint16 *text, int x, int y, SDL_Color fg)
+{
+    return TTF_DrawUNICODE_Atlas_Scaled(atlas, text, x, y, 1.0f, fg);
+}
+
+int TTF_DrawText_Atlas_Scaled(TTF_FontAtlas *atlas,
+                const char *text, int x, int y, float scale, SDL_Color fg)
+{
+    int status = -1;
+    Uint8 *utf8;
+
+    TTF_CHECKPOINTER(text, -1);
+
+    utf8 = SDL_stack_alloc(Uint8, SDL_strlen(text)*2+1);
+    if ( utf8 ) {
+        LATIN1_to_UTF8(text, utf8);
+        status = TTF_DrawUTF8_Atlas_Scaled(atlas, (char *)utf8, x, y, scale, fg);
+        SDL_stack_free(utf8);
+    } else {
+        SDL_OutOfMemory();
+    }
+    return status;
+}
+
+int TTF_DrawUTF8_Atlas_Scaled(TTF_FontAtlas *atlas,
+                const char *text, int x, int y, float scale, SDL_Color fg)
+{
+    TTF_Font *font;
+    SDL_bool first;
+    int xstart;
+    int minx, maxx;
+    int z, width;
+    a_glyph *glyph;
+    FT_Long use_kerning;
+    FT_UInt prev_index = 0;
+    size_t textlen;
+
+    TTF_CHECKPOINTER(atlas, -1);
+    TTF_CHECKPOINTER(text, -1);
+    if ( Atlas_Detached(atlas) ) {
+        TTF_SetError("The atlas's renderer was destroyed");
+        return -1;
+    }
+    font = atlas->font;
+
+    /* check kerning */
+    use_kerning = FT_HAS_KERNING( font->face ) && font->kerning;
+
+    /* Lay out the text as TTF_RenderUTF8_Blended() does, keeping track of
+       the bounds for the lines as TTF_SizeUTF8() does.
+     */
+    textlen = SDL_strlen(text);
+    first = SDL_TRUE;
+    xstart = 0;
+    minx = maxx = 0;
+    while ( textlen > 0 ) {
+        Uint32 c = UTF8_getch(&text, &textlen);
+        if ( c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED ) {
+            continue;
+        }
+
+        glyph = Find_Atlas_Glyph(atlas, c);
+        if ( glyph == NULL ) {
+            return -1;
+        }
+
+        /* do kerning, if possible AC-Patch */
+        if ( use_kerning && prev_index && glyph->index ) {
+            FT_Vector delta;
+            FT_Get_Kerning( font->face, prev_index, glyph->index, ft_kerning_default, &delta );
+            xstart += delta.x >> 6;
+        }
+
+        /* Compensate for the wrap around bug with negative minx's */
+        if ( first ) {
+            if ( glyph->minx < 0 ) {
+                xstart -= glyph->minx;
+            }
+            minx = maxx = xstart;
+        }
+        first = SDL_FALSE;
+
+        if ( Copy_Atlas_Glyph(atlas, glyph, x, y, xstart, scale, fg) < 0 ) {
+            return -1;
+        }
+
+        z = xstart + glyph->minx;
+        if ( minx > z ) {
+            minx = z;
+        }
+        if ( TTF_HANDLE_STYLE_BOLD(font) ) {
+            xstart += font->glyph_overhang;
+        }
+        if ( glyph->advance > glyph->maxx ) {
+            z = xstart + glyph->advance;
+        } else {
+            z = xstart + glyph->maxx;
+        }
+        if ( maxx < z ) {
+            maxx = z;
+        }
+        xstart += glyph->advance;
+        prev_index = glyph->index;
+    }
+
+    width = maxx - minx;
+    if ( font->outline > 0 ) {
+        width += font->outline * 2;
+    }
+    return Draw_Atlas_Lines(atlas, x, y, width, scale, fg);
+}
+
+int TTF_DrawUNICODE_Atlas_Scaled(TTF_FontAtlas *atlas,
+                const Uint16 *text, int x, int y, float scale, SDL_Color fg)
+{
+    int status = -1;
+    Uint8 *utf8;
+
+    TTF_CHECKPOINTER(text, -1);
+
+    utf8 = SDL_stack_alloc(Uint8, UCS2_len(text)*3+1);
+    if ( utf8 ) {
+        UCS2_to_UTF8(text, utf8);
+        status = TTF_DrawUTF8_Atlas_Scaled(atlas, (char *)utf8, x, y, scale, fg);
+        SDL_stack_free(utf8);
+    } else {
+        SDL_OutOfMemory();
+    }
+    return status;
+}
+
+int TTF_DrawUTF8_Wrapped_Atlas(TTF_FontAtlas *atlas, const char *text,
+                int x, int y, SDL_Color fg, Uint32 wrapLength)
+{
+    w_text *wrapped;
+    const w_line *line;
+    a_glyph *glyph;
+    int lx, ly, i, l;
+
+    TTF_CHECKPOINTER(atlas, -1);
+    TTF_CHECKPOINTER(text, -1);
+    if ( Atlas_Detached(atlas) ) {
+        TTF_SetError("The atlas's renderer was destroyed");
+        return -1;
+    }
+
+    wrapped = &atlas->wrapped;
+    if ( Wrap_Text(atlas->font, text, wrapLength, wrapped) < 0 ) {
+        return -1;
+    }
+
+    for ( l = 0; l < wrapped->num_lines; ++l ) {
+        line = &wrapped->lines[l];
+        lx = x + TTF_alignWrappedLine(atlas->font, wrapped, line);
+        ly = y + l * (wrapped->line_height + atlas->font->wrapped_spacing);
+
+        for ( i = line->first; i < line->last; ++i ) {
+            glyph = Find_Atlas_Glyph(atlas, wrapped->glyphs[i].ch);
+            if ( glyph == NULL ) {
+                return -1;
+            }
+            if ( Copy_Atlas_Glyph(atlas, glyph, lx, ly, line->x + wrapped->glyphs[i].x,
+                                  1.0f, fg) < 0 ) {
+                return -1;
+            }
+        }
+        if ( Draw_Atlas_Lines(atlas, lx, ly, line->width, 1.0f, fg) < 0 ) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void TTF_DestroyFontAtlas(TTF_FontAtlas *atlas)
+{
+    TTF_FontAtlas **prev;
+
+    if ( atlas == NULL ) {
+        return;
+    }
+    for ( prev = &atlas->font->atlases; *prev; prev = &(*prev)->next ) {
+        if ( *prev == atlas ) {
+            *prev = atlas->next;
+            break;
+        }
+    }
+
+    /* The glyph textures are destroyed with the pages, or were already
+       destroyed with the renderer */
+    SDL_DestroyTextureAtlas( atlas->pages );
+    free( atlas->glyphs );
+    free( atlas->wrapped.glyphs );
+    free( atlas->wrapped.lines );
+    free( atlas );
+}
+
+/* Lay out the next glyph of a run, as TTF_RenderUTF8_Blended() places it
+   and keeping the bounds as TTF_SizeUTF8() does.
+ */
+static int Layout_Run_Glyph( TTF_TextRun* run, r_glyph* laid )
+{
+    TTF_Font *font = run->font;
+    c_glyph *glyph;
+    FT_Error error;
+    int z;
+
+    error = Find_Glyph(font, laid->ch, CACHED_METRICS);
+    if ( error ) {
+        TTF_SetFTError("Couldn't find glyph", error);
+        return -1;
+    }
+    glyph = font->current;
+    laid->index = glyph->index;
+
+    /* handle kerning */
+    if ( font->kerning && run->prev_index && glyph->index &&
+         FT_HAS_KERNING( font->face ) ) {
+        FT_Vector delta;
+        FT_Get_Kerning( font->face, run->prev_index, glyph->index, ft_kerning_default, &delta );
+        run->xstart += delta.x >> 6;
+    }
+
+    /* Compensate for the wrap around bug with negative minx's */
+    if ( laid == run->glyphs ) {
+        if ( glyph->minx < 0 ) {
+            run->xstart -= glyph->minx;
+        }
+        run->minx = run->maxx = run->xstart;
+    }
+    laid->x = run->xstart;
+
+    z = run->xstart + glyph->minx;
+    if ( run->minx > z ) {
+        run->minx = z;
+    }
+    if ( TTF_HANDLE_STYLE_BOLD(font) ) {
+        run->xstart += font->glyph_overhang;
+    }
+    if ( glyph->advance > glyph->maxx ) {
+        z = run->xstart + glyph->advance;
+    } else {
+        z = run->xstart + glyph->maxx;
+    }
+    if ( run->maxx < z ) {
+        run->maxx = z;
+    }
+    run->xstart += glyph->advance;
+
+    if ( glyph->miny < run->miny ) {
+        run->miny = glyph->miny;
+    }
+    run->prev_index = glyph->index;
+    return 0;
+}
+
+static void Reset_Text_Run( TTF_TextRun* run )
+{
+    TTF_Font *font = run->font;
+
+    run->style = font->style;
+    run->outline = font->outline;
+    run->kerning = font->kerning;
+    run->hinting = font->hinting;
+    run->xstart = 0;
+    run->prev_index = 0;
+    run->minx = run->maxx = 0;
+    run->miny = 0;
+}
+
+/* Lay the run out again if the font settings have changed since */
+static int Update_Text_Run( TTF_TextRun* run )
+{
+    TTF_Font *font = run->font;
+    int i;
+
+    if ( run->style == font->style && run->outline == font->outline &&
+         run->kerning == font->kerning && run->hinting == font->hinting ) {
+        return 0;
+    }
+
+    Reset_Text_Run( run );
+    for ( i = 0; i < run->num_glyphs; ++i ) {
+        if ( Layout_Run_Glyph( run, &run->glyphs[i] ) < 0 ) {
+            /* Try again next time */
+            run->hinting = -1;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+TTF_TextRun *TTF_CreateTextRun(TTF_Font *font)
+{
+    TTF_TextRun *run;
+
+    TTF_CHECKPOINTER(font, NULL);
+
+    run = (TTF_TextRun *)malloc(sizeof *run);
+    if ( run == NULL ) {
+        TTF_SetError( "Out of memory" );
+        return NULL;
+    }
+    memset(run, 0, sizeof(*run));
+    run->font = font;
+    Reset_Text_Run( run );
+    return run;
+}
+
+int TTF_SetTextRunUTF8(TTF_TextRun *run, const char *text)
+{
+    TTF_CHECKPOINTER(run, -1);
+
+    run->num_glyphs = 0;
+    Reset_Text_Run( run );
+    return TTF_AppendTextRunUTF8(run, text);
+}
+
+int TTF_AppendTextRunUTF8(TTF_TextRun *run, const char *text)
+{
+    size_t textlen;
+
+    TTF_CHECKPOINTER(run, -1);
+    TTF_CHECKPOINTER(text, -1);
+
+    if ( Update_Text_Run( run ) < 0 ) {
+        return -1;
+    }
+
+    /* There's at most one character per byte */
+    textlen = SDL_strlen(text);
+    if ( textlen > (size_t)(run->max_glyphs - run->num_glyphs) ) {
+        int max_glyphs = SDL_max(run->max_glyphs * 2, run->num_glyphs + (int)textlen);
+        r_glyph *glyphs = (r_glyph *)realloc(run->glyphs, max_glyphs * sizeof(*glyphs));
+        if ( glyphs == NULL ) {
+            TTF_SetError( "Out of memory" );
+            return -1;
+        }
+        run->glyphs = glyphs;
+        run->max_glyphs = max_glyphs;
+    }
+
+    while ( textlen > 0 ) {
+        r_glyph *laid = &run->glyphs[run->num_glyphs];
+
+        laid->ch = UTF8_getch(&text, &textlen);
+        if ( laid->ch == UNICODE_BOM_NATIVE || laid->ch == UNICODE_BOM_SWAPPED ) {
+            continue;
+        }
+        if ( Layout_Run_Glyph( run, laid ) < 0 ) {
+            return -1;
+        }
+        ++run->num_glyphs;
+    }
+    return 0;
+}
+
+int TTF_SizeTextRun(TTF_TextRun *run, int *w, int *h)
+{
+    TTF_CHECKPOINTER(run, -1);
+
+    if ( Update_Text_Run( run ) < 0 ) {
+        return -1;
+    }
+    if ( w ) {
+        /* Add outline extra width */
+        *w = run->maxx - run->minx;
+        if ( run->font->outline > 0 ) {
+            *w += run->font->outline * 2;
+        }
+    }
+    if ( h ) {
+        *h = TTF_text_height(run->font, run->miny);
+    }
+    return 0;
+}
+
+int TTF_GetTextRunLength(const TTF_TextRun *run)
+{
+    TTF_CHECKPOINTER(run, -1);
+
+    return run->num_glyphs;
+}
+
+int TTF_GetTextRunGlyph(TTF_TextRun *run, int index, Uint32 *ch, int *x)
+{
+    TTF_CHECKPOINTER(run, -1);
+
+    if ( index < 0 || index >= run->num_glyphs ) {
+        TTF_SetError("Glyph index out of range");
+        return -1;
+    }
+    if ( Update_Text_Run( run ) < 0 ) {
+        return -1;
+    }
+    if ( ch ) {
+        *ch = run->glyphs[index].ch;
+    }
+    if ( x ) {
+        *x = run->glyphs[index].x;
+    }
+    return 0;
+}
+
+SDL_Surface *TTF_RenderTextRun_Blended(TTF_TextRun *run, SDL_Color fg)
+{
+    TTF_Font *font;
+    int width, height;
+    SDL_Surface *textbuf;
+    Uint32 pixel;
+    int i, row;
+    FT_Error error;
+
+    /* Get the dimensions of the text surface */
+    if ( ( TTF_SizeTextRun(run, &width, &height) < 0 ) || !width ) {
+        TTF_SetError("Text has zero width");
+        return(NULL);
+    }
+    font = run->font;
+
+    /* Create the target surface */
+    textbuf = SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 32,
+                               0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    if ( textbuf == NULL ) {
+        return(NULL);
+    }
+
+    /* Render each glyph where it was laid out */
+    pixel = (fg.r<<16)|(fg.g<<8)|fg.b;
+    SDL_FillRect(textbuf, NULL, pixel); /* Initialize with fg and 0 alpha */
+    for ( i = 0; i < run->num_glyphs; ++i ) {
+        error = Find_Glyph(font, run->glyphs[i].ch, CACHED_METRICS|CACHED_PIXMAP);
+        if ( error ) {
+            TTF_SetFTError("Couldn't find glyph", error);
+            SDL_FreeSurface( textbuf );
+            return NULL;
+        }
+        TTF_blendGlyph(font, textbuf, font->current, run->glyphs[i].x, 0, pixel);
+    }
+
+    /* Handle the underline style */
+    if ( TTF_HANDLE_STYLE_UNDERLINE(font) ) {
+        row = TTF_underline_top_row(font);
+        TTF_drawLine_Blended(font, textbuf, row, pixel);
+    }
+
+    /* Handle the strikethrough style */
+    if ( TTF_HANDLE_STYLE_STRIKETHROUGH(font) ) {
+        row = TTF_strikethrough_top_row(font);
+        TTF_drawLine_Blended(font, textbuf, row, pixel);
+    }
+    return(textbuf);
+}
+
+int TTF_DrawTextRun_Atlas(TTF_FontAtlas *atlas, TTF_TextRun *run,
+                int x, int y, SDL_Color fg)
+{
+    a_glyph *glyph;
+    int i, width;
+
+    TTF_CHECKPOINTER(atlas, -1);
+    if ( Atlas_Detached(atlas) ) {
+        TTF_SetError("The atlas's renderer was destroyed");
+        return -1;
+    }
+
+    if ( TTF_SizeTextRun(run, &width, NULL) < 0 ) {
+        return -1;
+    }
+    if ( run->font != atlas->font ) {
+        TTF_SetError("Text run and atlas use different fonts");
+        return -1;
+    }
+
+    for ( i = 0; i < run->num_glyphs; ++i ) {
+        glyph = Find_Atlas_Glyph(atlas, run->glyphs[i].ch);
+        if ( glyph == NULL ) {
+            return -1;
+        }
+        if ( Copy_Atlas_Glyph(atlas, glyph, x, y, run->glyphs[i].x, 1.0f, fg) < 0 ) {
+            return -1;
+        }
+    }
+    return Draw_Atlas_Lines(atlas, x, y, width, 1.0f, fg);
+}
+
+void TTF_FreeTextRun(TTF_TextRun *run)
+{
+    if ( run ) {
+        free( run->glyphs );
+        free( run );
+    }
+}
+
+void TTF_SetFontStyle( TTF_Font* font, int style )
+{
+    /* Glyphs are cached per style, so switching back and forth
+     * doesn't render them again.
+     * */
+    font->style = style | font->face_style;
+}
+
+int TTF_GetFontStyle( const TTF_Font* font )
+{
+    return font->style;
+}
+
+void TTF_SetFontOutline( TTF_Font* font, int outline )
+{
+    /* Glyphs are cached per outline as well */
+    font->outline = outline;
+}
+
+int TTF_GetFontOutline( const TTF_Font* font )
+{
+    return font->outline;
+}
+
+void TTF_SetFontHinting( TTF_Font* font, int hinting )
+{
+    TTF_FontAtlas *atlas;
+
+    if (hinting == TTF_HINTING_LIGHT)
+        font->hinting = FT_LOAD_TARGET_LIGHT;
+    else if (hinting == TTF_HINTING_MONO)
+        font->hinting = FT_LOAD_TARGET_MONO;
+    else if (hinting == TTF_HINTING_NONE)
+        font->hinting = FT_LOAD_NO_HINTING;
+    else
+        font->hinting = 0;
+
+    Flush_Cache( font );
+    for ( atlas = font->atlases; atlas; atlas = atlas->next ) {
+        Flush_Atlas( atlas );
+    }
 }
 
 int TTF_GetFontHinting( const TTF_Font* font )
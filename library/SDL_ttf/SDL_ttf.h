@@ -127,6 +127,17 @@ extern DECLSPEC int SDLCALL TTF_FontLineSkip(const TTF_Font *font);
 extern DECLSPEC int SDLCALL TTF_GetFontKerning(const TTF_Font *font);
 extern DECLSPEC void SDLCALL TTF_SetFontKerning(TTF_Font *font, int allowed);
 
+/* Get/Set how the lines of wrapped text are aligned, and the number of
+   pixels between them, 2 by default.
+ */
+#define TTF_WRAPPED_ALIGN_LEFT      0
+#define TTF_WRAPPED_ALIGN_CENTER    1
+#define TTF_WRAPPED_ALIGN_RIGHT     2
+extern DECLSPEC int SDLCALL TTF_GetFontWrappedAlign(const TTF_Font *font);
+extern DECLSPEC void SDLCALL TTF_SetFontWrappedAlign(TTF_Font *font, int align);
+extern DECLSPEC int SDLCALL TTF_GetFontWrappedSpacing(const TTF_Font *font);
+extern DECLSPEC void SDLCALL TTF_SetFontWrappedSpacing(TTF_Font *font, int spacing);
+
 /* Get the number of faces of the font */
 extern DECLSPEC long SDLCALL TTF_FontFaces(const TTF_Font *font);
 
@@ -137,6 +148,7 @@ extern DECLSPEC char * SDLCALL TTF_FontFaceStyleName(const TTF_Font *font);
 
 /* Check wether a glyph is provided by the font or not */
 extern DECLSPEC int SDLCALL TTF_GlyphIsProvided(const TTF_Font *font, Uint16 ch);
+extern DECLSPEC int SDLCALL TTF_GlyphIsProvided32(const TTF_Font *font, Uint32 ch);
 
 /* Get the metrics (dimensions) of a glyph
    To understand what these metrics mean, here is a useful link:
@@ -145,12 +157,35 @@ extern DECLSPEC int SDLCALL TTF_GlyphIsProvided(const TTF_Font *font, Uint16 ch)
 extern DECLSPEC int SDLCALL TTF_GlyphMetrics(TTF_Font *font, Uint16 ch,
                      int *minx, int *maxx,
                                      int *miny, int *maxy, int *advance);
+extern DECLSPEC int SDLCALL TTF_GlyphMetrics32(TTF_Font *font, Uint32 ch,
+                     int *minx, int *maxx,
+                                     int *miny, int *maxy, int *advance);
+
+/* Rendered glyphs are cached per character, style and outline.  When the
+   cache of a font uses more memory than its size, 4 MB by default, the
+   glyphs used least recently are thrown away.  A size of 0 means no limit.
+ */
+typedef struct TTF_GlyphCacheStats {
+    Uint32 hits;        /* Glyphs found already rendered */
+    Uint32 misses;      /* Glyphs loaded or rendered by FreeType */
+    Uint32 evictions;   /* Glyphs thrown away to stay within the size */
+    int glyphs;         /* Glyphs in the cache now */
+    size_t bytes;       /* Memory used by the cache now */
+} TTF_GlyphCacheStats;
+
+extern DECLSPEC void SDLCALL TTF_SetFontGlyphCacheSize(TTF_Font *font, size_t bytes);
+extern DECLSPEC void SDLCALL TTF_GetFontGlyphCacheStats(const TTF_Font *font, TTF_GlyphCacheStats *stats);
+extern DECLSPEC void SDLCALL TTF_ResetFontGlyphCacheStats(TTF_Font *font);
 
 /* Get the dimensions of a rendered string of text */
 extern DECLSPEC int SDLCALL TTF_SizeText(TTF_Font *font, const char *text, int *w, int *h);
 extern DECLSPEC int SDLCALL TTF_SizeUTF8(TTF_Font *font, const char *text, int *w, int *h);
 extern DECLSPEC int SDLCALL TTF_SizeUNICODE(TTF_Font *font, const Uint16 *text, int *w, int *h);
 
+/* Get the dimensions of text wrapped as TTF_RenderUTF8_Blended_Wrapped()
+   wraps it */
+extern DECLSPEC int SDLCALL TTF_SizeUTF8_Wrapped(TTF_Font *font, const char *text, Uint32 wrapLength, int *w, int *h);
+
 /* Create an 8-bit palettized surface and render the given text at
    fast quality with the given font and color.  The 0 pixel is the
    colorkey, giving a transparent background, and the 1 pixel is set
@@ -173,6 +208,8 @@ extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderUNICODE_Solid(TTF_Font *font,
 */
 extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderGlyph_Solid(TTF_Font *font,
                     Uint16 ch, SDL_Color fg);
+extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderGlyph32_Solid(TTF_Font *font,
+                    Uint32 ch, SDL_Color fg);
 
 /* Create an 8-bit palettized surface and render the given text at
    high quality with the given font and colors.  The 0 pixel is background,
@@ -195,6 +232,8 @@ extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderUNICODE_Shaded(TTF_Font *font,
 */
 extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderGlyph_Shaded(TTF_Font *font,
                 Uint16 ch, SDL_Color fg, SDL_Color bg);
+extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderGlyph32_Shaded(TTF_Font *font,
+                Uint32 ch, SDL_Color fg, SDL_Color bg);
 
 /* Create a 32-bit ARGB surface and render the given text at high quality,
    using alpha blending to dither the font with the given color.
@@ -211,7 +250,10 @@ extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderUNICODE_Blended(TTF_Font *font,
 /* Create a 32-bit ARGB surface and render the given text at high quality,
    using alpha blending to dither the font with the given color.
    Text is wrapped to multiple lines on line endings and on word boundaries
-   if it extends beyond wrapLength in pixels.
+   if it extends beyond wrapLength in pixels, and words that don't fit on
+   a line by themselves are broken.  A wrapLength of 0 only wraps at line
+   endings.  The lines are aligned within the widest line, or wrapLength
+   if there's more than one, as set by TTF_SetFontWrappedAlign().
    This function returns the new surface, or NULL if there was an error.
 */
 extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderText_Blended_Wrapped(TTF_Font *font,
@@ -229,6 +271,114 @@ extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderUNICODE_Blended_Wrapped(TTF_Font
 */
 extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderGlyph_Blended(TTF_Font *font,
                         Uint16 ch, SDL_Color fg);
+extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderGlyph32_Blended(TTF_Font *font,
+                        Uint32 ch, SDL_Color fg);
+
+/* A font atlas draws text with a renderer.  Each glyph is rendered once
+   at high quality into a texture page shared with the other glyphs, and
+   a string is drawn as copies from the pages, so drawing text
+   that has been drawn before needs no new surfaces or texture uploads.
+   Glyphs are kept per style and outline, like the glyph cache.
+
+   Destroying the renderer destroys the glyph textures, and the atlas
+   can't draw after that.  The atlas itself is destroyed with the font if
+   it's still around when the font is closed.
+ */
+typedef struct _TTF_FontAtlas TTF_FontAtlas;
+
+/* Create an atlas for drawing text in the font with the renderer.
+   This function returns the new atlas, or NULL if there was an error.
+*/
+extern DECLSPEC TTF_FontAtlas * SDLCALL TTF_CreateFontAtlas(TTF_Font *font,
+                SDL_Renderer *renderer);
+
+/* Create an atlas that stores each glyph as a signed distance field, so
+   text can be drawn sharp at any scale with the TTF_Draw*_Atlas_Scaled()
+   functions.  The alpha of a glyph is 128 on its edge, and falls to 0 at
+   spread pixels outside it and rises to 255 at spread pixels inside it.
+   Open the font at a fairly large size, like 32 points, and use a spread
+   of a few pixels, like 4.  The renderer must support distance field
+   textures, see SDL_SetTextureDistanceField().
+   This function returns the new atlas, or NULL if there was an error.
+*/
+extern DECLSPEC TTF_FontAtlas * SDLCALL TTF_CreateFontAtlas_SDF(TTF_Font *font,
+                SDL_Renderer *renderer, int spread);
+
+/* Draw the given text with its top left corner at (x, y), where the
+   surface from TTF_RenderText_Blended() would be copied.  The text is
+   blended in the given color, and fg.a is used as the alpha modulation.
+   This function returns 0, or -1 if there was an error.
+*/
+extern DECLSPEC int SDLCALL TTF_DrawText_Atlas(TTF_FontAtlas *atlas,
+                const char *text, int x, int y, SDL_Color fg);
+extern DECLSPEC int SDLCALL TTF_DrawUTF8_Atlas(TTF_FontAtlas *atlas,
+                const char *text, int x, int y, SDL_Color fg);
+extern DECLSPEC int SDLCALL TTF_DrawUNICODE_Atlas(TTF_FontAtlas *atlas,
+                const Uint16 *text, int x, int y, SDL_Color fg);
+
+/* Draw the given text as above, scaled around (x, y) by the given factor.
+   Glyphs from a distance field atlas keep sharp edges at any scale, the
+   ones from other atlases are stretched.
+   This function returns 0, or -1 if there was an error.
+*/
+extern DECLSPEC int SDLCALL TTF_DrawText_Atlas_Scaled(TTF_FontAtlas *atlas,
+                const char *text, int x, int y, float scale, SDL_Color fg);
+extern DECLSPEC int SDLCALL TTF_DrawUTF8_Atlas_Scaled(TTF_FontAtlas *atlas,
+                const char *text, int x, int y, float scale, SDL_Color fg);
+extern DECLSPEC int SDLCALL TTF_DrawUNICODE_Atlas_Scaled(TTF_FontAtlas *atlas,
+                const Uint16 *text, int x, int y, float scale, SDL_Color fg);
+
+/* Draw text wrapped as TTF_RenderUTF8_Blended_Wrapped() wraps it, with
+   the top left corner of that surface at (x, y).
+   This function returns 0, or -1 if there was an error.
+*/
+extern DECLSPEC int SDLCALL TTF_DrawUTF8_Wrapped_Atlas(TTF_FontAtlas *atlas,
+                const char *text, int x, int y, SDL_Color fg, Uint32 wrapLength);
+
+/* Destroy a font atlas and the textures holding its glyphs */
+extern DECLSPEC void SDLCALL TTF_DestroyFontAtlas(TTF_FontAtlas *atlas);
+
+/* A text run holds a string decoded and laid out in a font, so it can be
+   measured and drawn again without looking up each character and kerning
+   pair.  Text appended to a run is laid out after what's already there.
+   The run is laid out again if the style, outline, kerning or hinting of
+   the font changes.  It must be freed before the font is closed.
+ */
+typedef struct _TTF_TextRun TTF_TextRun;
+
+/* Create an empty text run in the given font.
+   This function returns the new run, or NULL if there was an error.
+*/
+extern DECLSPEC TTF_TextRun * SDLCALL TTF_CreateTextRun(TTF_Font *font);
+
+/* Replace the text of a run, or add text to the end of it.
+   These functions return 0, or -1 if there was an error.
+*/
+extern DECLSPEC int SDLCALL TTF_SetTextRunUTF8(TTF_TextRun *run, const char *text);
+extern DECLSPEC int SDLCALL TTF_AppendTextRunUTF8(TTF_TextRun *run, const char *text);
+
+/* Get the dimensions of the text, the same as TTF_SizeUTF8() */
+extern DECLSPEC int SDLCALL TTF_SizeTextRun(TTF_TextRun *run, int *w, int *h);
+
+/* Get the number of characters in a run, not counting byte order marks */
+extern DECLSPEC int SDLCALL TTF_GetTextRunLength(const TTF_TextRun *run);
+
+/* Get a character of a run and the x position of its origin in the text.
+   This function returns 0, or -1 if the index is out of range.
+*/
+extern DECLSPEC int SDLCALL TTF_GetTextRunGlyph(TTF_TextRun *run, int index,
+                Uint32 *ch, int *x);
+
+/* Render a run the same as TTF_RenderUTF8_Blended() renders its text */
+extern DECLSPEC SDL_Surface * SDLCALL TTF_RenderTextRun_Blended(TTF_TextRun *run,
+                SDL_Color fg);
+
+/* Draw a run with an atlas of the same font, as TTF_DrawUTF8_Atlas() */
+extern DECLSPEC int SDLCALL TTF_DrawTextRun_Atlas(TTF_FontAtlas *atlas,
+                TTF_TextRun *run, int x, int y, SDL_Color fg);
+
+/* Free a text run */
+extern DECLSPEC void SDLCALL TTF_FreeTextRun(TTF_TextRun *run);
 
 /* For compatibility with previous versions, here are the old functions */
 #define TTF_RenderText(font, text, fg, bg)  \
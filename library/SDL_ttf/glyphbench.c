@@ -0,0 +1,176 @@
+/*
+  glyphbench:  Measure how many glyphs per second each render mode produces.
+  Copyright (C) 2001-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* A benchmark of the glyph compositing in each render mode, on a long
+   paragraph with its glyphs already in the font's cache.
+ */
+
+/* quiet windows compiler warnings */
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "SDL_ttf.h"
+
+#define DEFAULT_PTSIZE      18
+#define DEFAULT_ITERATIONS  200
+#define DEFAULT_WRAPLENGTH  640
+
+static const char *Paragraph =
+"It was the best of times, it was the worst of times, it was the age of "
+"wisdom, it was the age of foolishness, it was the epoch of belief, it was "
+"the epoch of incredulity, it was the season of Light, it was the season of "
+"Darkness, it was the spring of hope, it was the winter of despair, we had "
+"everything before us, we had nothing before us, we were all going direct "
+"to Heaven, we were all going direct the other way \xe2\x80\x93 in short, the "
+"period was so far like the present period, that some of its noisiest "
+"authorities insisted on its being received, for good or for evil, in the "
+"superlative degree of comparison only. There were a king with a large jaw "
+"and a queen with a plain face, on the throne of England; there were a king "
+"with a large jaw and a queen with a fair face, on the throne of France.";
+
+static char *Usage =
+"Usage: %s <font>.ttf [ptsize] [iterations]\n";
+
+static int CountGlyphs(const char *text)
+{
+    int count = 0;
+
+    /* Every byte that doesn't continue a UTF-8 sequence starts a glyph */
+    while ( *text ) {
+        if ( (*text++ & 0xC0) != 0x80 ) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+static void Report(const char *what, int glyphs, int iterations, Uint64 start)
+{
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) /
+                     SDL_GetPerformanceFrequency();
+
+    printf("%-16s %9.3f ms %12.0f glyphs/s\n", what,
+           seconds * 1000.0 / iterations,
+           seconds > 0.0 ? glyphs * (double)iterations / seconds : 0.0);
+}
+
+int main(int argc, char *argv[])
+{
+    TTF_Font *font;
+    TTF_TextRun *run;
+    SDL_Surface *text;
+    SDL_Color fg = { 0, 0, 0, 255 };
+    SDL_Color bg = { 255, 255, 255, 255 };
+    Uint64 start;
+    int ptsize = DEFAULT_PTSIZE;
+    int iterations = DEFAULT_ITERATIONS;
+    int i, glyphs;
+
+    if ( argc < 2 ) {
+        fprintf(stderr, Usage, argv[0]);
+        return(1);
+    }
+    if ( argc > 2 ) {
+        ptsize = atoi(argv[2]);
+    }
+    if ( argc > 3 ) {
+        iterations = atoi(argv[3]);
+    }
+    if ( ptsize <= 0 || iterations <= 0 ) {
+        fprintf(stderr, Usage, argv[0]);
+        return(1);
+    }
+
+    if ( SDL_Init(0) < 0 || TTF_Init() < 0 ) {
+        fprintf(stderr, "Couldn't initialize: %s\n", SDL_GetError());
+        return(2);
+    }
+    font = TTF_OpenFont(argv[1], ptsize);
+    if ( font == NULL ) {
+        fprintf(stderr, "Couldn't load %d pt font from %s: %s\n",
+                    ptsize, argv[1], SDL_GetError());
+        TTF_Quit();
+        SDL_Quit();
+        return(2);
+    }
+    run = TTF_CreateTextRun(font);
+    if ( run == NULL || TTF_SetTextRunUTF8(run, Paragraph) < 0 ) {
+        fprintf(stderr, "Couldn't lay out the text: %s\n", SDL_GetError());
+        TTF_CloseFont(font);
+        TTF_Quit();
+        SDL_Quit();
+        return(2);
+    }
+    glyphs = CountGlyphs(Paragraph);
+    printf("%d glyphs at %d points, %d iterations%s\n", glyphs, ptsize,
+           iterations, SDL_HasSSE2() ? ", SSE2" : "");
+
+    /* Render everything once so the glyph cache is warm */
+    SDL_FreeSurface(TTF_RenderUTF8_Solid(font, Paragraph, fg));
+    SDL_FreeSurface(TTF_RenderUTF8_Shaded(font, Paragraph, fg, bg));
+    SDL_FreeSurface(TTF_RenderUTF8_Blended(font, Paragraph, fg));
+
+    start = SDL_GetPerformanceCounter();
+    for ( i = 0; i < iterations; ++i ) {
+        text = TTF_RenderUTF8_Solid(font, Paragraph, fg);
+        SDL_FreeSurface(text);
+    }
+    Report("solid", glyphs, iterations, start);
+
+    start = SDL_GetPerformanceCounter();
+    for ( i = 0; i < iterations; ++i ) {
+        text = TTF_RenderUTF8_Shaded(font, Paragraph, fg, bg);
+        SDL_FreeSurface(text);
+    }
+    Report("shaded", glyphs, iterations, start);
+
+    start = SDL_GetPerformanceCounter();
+    for ( i = 0; i < iterations; ++i ) {
+        text = TTF_RenderUTF8_Blended(font, Paragraph, fg);
+        SDL_FreeSurface(text);
+    }
+    Report("blended", glyphs, iterations, start);
+
+    start = SDL_GetPerformanceCounter();
+    for ( i = 0; i < iterations; ++i ) {
+        text = TTF_RenderUTF8_Blended_Wrapped(font, Paragraph, fg,
+                                              DEFAULT_WRAPLENGTH);
+        SDL_FreeSurface(text);
+    }
+    Report("blended wrapped", glyphs, iterations, start);
+
+    start = SDL_GetPerformanceCounter();
+    for ( i = 0; i < iterations; ++i ) {
+        text = TTF_RenderTextRun_Blended(run, fg);
+        SDL_FreeSurface(text);
+    }
+    Report("text run", glyphs, iterations, start);
+
+    TTF_FreeTextRun(run);
+    TTF_CloseFont(font);
+    TTF_Quit();
+    SDL_Quit();
+    return(0);
+}
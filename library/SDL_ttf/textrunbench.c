@@ -0,0 +1,189 @@
+/*
+  textrunbench:  Compare measuring and rendering text with and without text runs.
+  Copyright (C) 2001-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* A benchmark of TTF_TextRun against the string based functions, on a
+   long paragraph that a user interface would measure and render again
+   every frame.
+ */
+
+/* quiet windows compiler warnings */
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "SDL_ttf.h"
+
+#define DEFAULT_PTSIZE      18
+#define DEFAULT_ITERATIONS  200
+
+static const char *Paragraph =
+"It was the best of times, it was the worst of times, it was the age of "
+"wisdom, it was the age of foolishness, it was the epoch of belief, it was "
+"the epoch of incredulity, it was the season of Light, it was the season of "
+"Darkness, it was the spring of hope, it was the winter of despair, we had "
+"everything before us, we had nothing before us, we were all going direct "
+"to Heaven, we were all going direct the other way \xe2\x80\x93 in short, the "
+"period was so far like the present period, that some of its noisiest "
+"authorities insisted on its being received, for good or for evil, in the "
+"superlative degree of comparison only. There were a king with a large jaw "
+"and a queen with a plain face, on the throne of England; there were a king "
+"with a large jaw and a queen with a fair face, on the throne of France.";
+
+static char *Usage =
+"Usage: %s <font>.ttf [ptsize] [iterations]\n";
+
+static double Seconds(Uint64 start)
+{
+    return (double)(SDL_GetPerformanceCounter() - start) /
+           SDL_GetPerformanceFrequency();
+}
+
+static void Report(const char *what, int iterations, double plain, double run)
+{
+    printf("%-22s %9.3f ms %9.3f ms %7.1fx\n", what,
+           plain * 1000.0 / iterations, run * 1000.0 / iterations,
+           run > 0.0 ? plain / run : 0.0);
+}
+
+int main(int argc, char *argv[])
+{
+    TTF_Font *font;
+    TTF_TextRun *run;
+    SDL_Surface *text;
+    SDL_Color fg = { 0, 0, 0, 255 };
+    char *words, *word;
+    Uint64 start;
+    double plain, timed;
+    int ptsize = DEFAULT_PTSIZE;
+    int iterations = DEFAULT_ITERATIONS;
+    int i, w, h;
+
+    if ( argc < 2 ) {
+        fprintf(stderr, Usage, argv[0]);
+        return(1);
+    }
+    if ( argc > 2 ) {
+        ptsize = atoi(argv[2]);
+    }
+    if ( argc > 3 ) {
+        iterations = atoi(argv[3]);
+    }
+    if ( ptsize <= 0 || iterations <= 0 ) {
+        fprintf(stderr, Usage, argv[0]);
+        return(1);
+    }
+
+    if ( SDL_Init(0) < 0 || TTF_Init() < 0 ) {
+        fprintf(stderr, "Couldn't initialize: %s\n", SDL_GetError());
+        return(2);
+    }
+    font = TTF_OpenFont(argv[1], ptsize);
+    if ( font == NULL ) {
+        fprintf(stderr, "Couldn't load %d pt font from %s: %s\n",
+                    ptsize, argv[1], SDL_GetError());
+        TTF_Quit();
+        SDL_Quit();
+        return(2);
+    }
+    run = TTF_CreateTextRun(font);
+    if ( run == NULL || TTF_SetTextRunUTF8(run, Paragraph) < 0 ) {
+        fprintf(stderr, "Couldn't lay out the text: %s\n", SDL_GetError());
+        TTF_CloseFont(font);
+        TTF_Quit();
+        SDL_Quit();
+        return(2);
+    }
+    TTF_SizeTextRun(run, &w, &h);
+    printf("%d characters, %dx%d pixels, %d iterations\n",
+           TTF_GetTextRunLength(run), w, h, iterations);
+    printf("%-22s %12s %12s %8s\n", "", "string", "text run", "speedup");
+
+    /* Measuring the same text every frame */
+    start = SDL_GetPerformanceCounter();
+    for ( i = 0; i < iterations; ++i ) {
+        TTF_SizeUTF8(font, Paragraph, &w, &h);
+    }
+    plain = Seconds(start);
+    start = SDL_GetPerformanceCounter();
+    for ( i = 0; i < iterations; ++i ) {
+        TTF_SizeTextRun(run, &w, &h);
+    }
+    timed = Seconds(start);
+    Report("size", iterations, plain, timed);
+
+    /* Measuring and then rendering it */
+    start = SDL_GetPerformanceCounter();
+    for ( i = 0; i < iterations; ++i ) {
+        TTF_SizeUTF8(font, Paragraph, &w, &h);
+        text = TTF_RenderUTF8_Blended(font, Paragraph, fg);
+        SDL_FreeSurface(text);
+    }
+    plain = Seconds(start);
+    start = SDL_GetPerformanceCounter();
+    for ( i = 0; i < iterations; ++i ) {
+        TTF_SizeTextRun(run, &w, &h);
+        text = TTF_RenderTextRun_Blended(run, fg);
+        SDL_FreeSurface(text);
+    }
+    timed = Seconds(start);
+    Report("size and render", iterations, plain, timed);
+
+    /* Measuring the text as it's typed in a word at a time */
+    words = SDL_strdup(Paragraph);
+    if ( words == NULL ) {
+        fprintf(stderr, "Out of memory\n");
+    } else {
+        start = SDL_GetPerformanceCounter();
+        for ( i = 0; i < iterations; ++i ) {
+            for ( word = strchr(words, ' '); word; word = strchr(word + 1, ' ') ) {
+                *word = '\0';
+                TTF_SizeUTF8(font, words, &w, &h);
+                *word = ' ';
+            }
+        }
+        plain = Seconds(start);
+        start = SDL_GetPerformanceCounter();
+        for ( i = 0; i < iterations; ++i ) {
+            char *last = words;
+
+            TTF_SetTextRunUTF8(run, "");
+            for ( word = strchr(words, ' '); word; word = strchr(word + 1, ' ') ) {
+                *word = '\0';
+                TTF_AppendTextRunUTF8(run, last);
+                TTF_SizeTextRun(run, &w, &h);
+                *word = ' ';
+                last = word;
+            }
+        }
+        timed = Seconds(start);
+        Report("append and size", iterations, plain, timed);
+        SDL_free(words);
+    }
+
+    TTF_FreeTextRun(run);
+    TTF_CloseFont(font);
+    TTF_Quit();
+    SDL_Quit();
+    return(0);
+}
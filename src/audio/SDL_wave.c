@@ -26,7 +26,7 @@
 #include "SDL_wave.h"
 
 
-static int ReadChunk(SDL_RWops * src, Chunk * chunk);
+static int ReadChunk(SDL_RWops * src, Chunk * chunk, SDL_bool inplace);
 
 struct MS_ADPCM_decodestate
 {
@@ -116,10 +116,10 @@ MS_ADPCM_nibble(struct MS_ADPCM_decodestate *state,
 }
 
 static int
-MS_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
+MS_ADPCM_decode(const Uint8 * encoded, Uint8 ** audio_buf, Uint32 * audio_len)
 {
     struct MS_ADPCM_decodestate *state[2];
-    Uint8 *freeable, *encoded, *decoded;
+    Uint8 *decoded;
     Sint32 encoded_len, samplesleft;
     Sint8 nybble, stereo;
     Sint16 *coeff[2];
@@ -127,8 +127,6 @@ MS_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
 
     /* Allocate the proper sized output buffer */
     encoded_len = *audio_len;
-    encoded = *audio_buf;
-    freeable = *audio_buf;
     *audio_len = (encoded_len / MS_ADPCM_state.wavefmt.blockalign) *
         MS_ADPCM_state.wSamplesPerBlock *
         MS_ADPCM_state.wavefmt.channels * sizeof(Sint16);
@@ -210,7 +208,6 @@ MS_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
         }
         encoded_len -= MS_ADPCM_state.wavefmt.blockalign;
     }
-    SDL_free(freeable);
     return (0);
 }
 
@@ -304,7 +301,7 @@ IMA_ADPCM_nibble(struct IMA_ADPCM_decodestate *state, Uint8 nybble)
 
 /* Fill the decode buffer with a channel block of data (8 samples) */
 static void
-Fill_IMA_ADPCM_block(Uint8 * decoded, Uint8 * encoded,
+Fill_IMA_ADPCM_block(Uint8 * decoded, const Uint8 * encoded,
                      int channel, int numchannels,
                      struct IMA_ADPCM_decodestate *state)
 {
@@ -333,10 +330,10 @@ Fill_IMA_ADPCM_block(Uint8 * decoded, Uint8 * encoded,
 }
 
 static int
-IMA_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
+IMA_ADPCM_decode(const Uint8 * encoded, Uint8 ** audio_buf, Uint32 * audio_len)
 {
     struct IMA_ADPCM_decodestate *state;
-    Uint8 *freeable, *encoded, *decoded;
+    Uint8 *decoded;
     Sint32 encoded_len, samplesleft;
     unsigned int c, channels;
 
@@ -351,8 +348,6 @@ IMA_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
 
     /* Allocate the proper sized output buffer */
     encoded_len = *audio_len;
-    encoded = *audio_buf;
-    freeable = *audio_buf;
     *audio_len = (encoded_len / IMA_ADPCM_state.wavefmt.blockalign) *
         IMA_ADPCM_state.wSamplesPerBlock *
         IMA_ADPCM_state.wavefmt.channels * sizeof(Sint16);
@@ -397,7 +392,6 @@ IMA_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
         }
         encoded_len -= IMA_ADPCM_state.wavefmt.blockalign;
     }
-    SDL_free(freeable);
     return (0);
 }
 
@@ -410,6 +404,7 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     int lenread;
     int IEEE_float_encoded, MS_ADPCM_encoded, IMA_ADPCM_encoded;
     int samplesize;
+    SDL_bool inplace = SDL_FALSE;
 
     /* WAV magic header */
     Uint32 RIFFchunk;
@@ -451,7 +446,7 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     do {
         SDL_free(chunk.data);
         chunk.data = NULL;
-        lenread = ReadChunk(src, &chunk);
+        lenread = ReadChunk(src, &chunk, SDL_FALSE);
         if (lenread < 0) {
             was_error = 1;
             goto done;
@@ -462,6 +457,7 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
 
     /* Decode the audio data format */
     format = (WaveFMT *) chunk.data;
+    chunk.data = NULL;
     if (chunk.magic != FMT) {
         SDL_SetError("Complex WAVE files not supported");
         was_error = 1;
@@ -544,34 +540,49 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     spec->channels = (Uint8) SDL_SwapLE16(format->channels);
     spec->samples = 4096;       /* Good default buffer size */
 
-    /* Read the audio data chunk */
+    /* Read the audio data chunk.  If the data source is in memory, the
+       chunks are used where they are, and the samples are only copied
+       once, into the buffer we return.
+     */
+    inplace = (SDL_RWGetBuffer(src, NULL) != NULL);
     *audio_buf = NULL;
     do {
-        SDL_free(*audio_buf);
-        *audio_buf = NULL;
-        lenread = ReadChunk(src, &chunk);
+        if (!inplace) {
+            SDL_free(chunk.data);
+        }
+        chunk.data = NULL;
+        lenread = ReadChunk(src, &chunk, inplace);
         if (lenread < 0) {
             was_error = 1;
             goto done;
         }
         *audio_len = lenread;
-        *audio_buf = chunk.data;
         if (chunk.magic != DATA)
             headerDiff += lenread + 2 * sizeof(Uint32);
     } while (chunk.magic != DATA);
     headerDiff += 2 * sizeof(Uint32);   /* for the data chunk and len */
 
     if (MS_ADPCM_encoded) {
-        if (MS_ADPCM_decode(audio_buf, audio_len) < 0) {
+        if (MS_ADPCM_decode(chunk.data, audio_buf, audio_len) < 0) {
             was_error = 1;
             goto done;
         }
-    }
-    if (IMA_ADPCM_encoded) {
-        if (IMA_ADPCM_decode(audio_buf, audio_len) < 0) {
+    } else if (IMA_ADPCM_encoded) {
+        if (IMA_ADPCM_decode(chunk.data, audio_buf, audio_len) < 0) {
+            was_error = 1;
+            goto done;
+        }
+    } else if (inplace) {
+        *audio_buf = (Uint8 *) SDL_malloc(*audio_len);
+        if (*audio_buf == NULL) {
+            SDL_OutOfMemory();
             was_error = 1;
             goto done;
         }
+        SDL_memcpy(*audio_buf, chunk.data, *audio_len);
+    } else {
+        *audio_buf = chunk.data;
+        chunk.data = NULL;
     }
 
     /* Don't return a buffer that isn't a multiple of samplesize */
@@ -580,6 +591,9 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
 
   done:
     SDL_free(format);
+    if (!inplace) {
+        SDL_free(chunk.data);
+    }
     if (src) {
         if (freesrc) {
             SDL_RWclose(src);
@@ -603,11 +617,23 @@ SDL_FreeWAV(Uint8 * audio_buf)
     SDL_free(audio_buf);
 }
 
+/* Read a chunk, or with inplace, point at its data in the source's memory */
 static int
-ReadChunk(SDL_RWops * src, Chunk * chunk)
+ReadChunk(SDL_RWops * src, Chunk * chunk, SDL_bool inplace)
 {
     chunk->magic = SDL_ReadLE32(src);
     chunk->length = SDL_ReadLE32(src);
+    if (inplace) {
+        size_t left;
+
+        chunk->data = (Uint8 *) SDL_RWGetBuffer(src, &left);
+        if (chunk->data == NULL || chunk->length > left) {
+            chunk->data = NULL;
+            return SDL_Error(SDL_EFREAD);
+        }
+        SDL_RWseek(src, chunk->length, RW_SEEK_CUR);
+        return (chunk->length);
+    }
     chunk->data = (Uint8 *) SDL_malloc(chunk->length);
     if (chunk->data == NULL) {
         return SDL_OutOfMemory();
@@ -54,6 +54,7 @@
 #define CPU_HAS_SSE3    0x00000040
 #define CPU_HAS_SSE41   0x00000100
 #define CPU_HAS_SSE42   0x00000200
+#define CPU_HAS_AVX     0x00000400
 
 #if SDL_ALTIVEC_BLITTERS && HAVE_SETJMP && !__MACOSX__ && !__OpenBSD__
 /* This is the brute force way of detecting instruction sets...
@@ -328,6 +329,29 @@ CPU_haveSSE42(void)
     return 0;
 }
 
+static __inline__ int
+CPU_haveAVX(void)
+{
+    int haveAVX = 0;
+
+    if (CPU_haveCPUID()) {
+        int a, b, c, d;
+
+        cpuid(0, a, b, c, d);
+        if (a >= 1) {
+            cpuid(1, a, b, c, d);
+            /* The CPU must support AVX and the OS must save the YMM registers */
+            if ((c & 0x18000000) == 0x18000000) {
+#if defined(__GNUC__) && (defined(i386) || defined(__x86_64__))
+                __asm__ (".byte 0x0f, 0x01, 0xd0" : "=a" (a), "=d" (d) : "c" (0));
+                haveAVX = ((a & 0x6) == 0x6);
+#endif
+            }
+        }
+    }
+    return haveAVX;
+}
+
 static int SDL_CPUCount = 0;
 
 int
@@ -522,6 +546,9 @@ SDL_GetCPUFeatures(void)
         if (CPU_haveSSE42()) {
             SDL_CPUFeatures |= CPU_HAS_SSE42;
         }
+        if (CPU_haveAVX()) {
+            SDL_CPUFeatures |= CPU_HAS_AVX;
+        }
     }
     return SDL_CPUFeatures;
 }
@@ -607,6 +634,15 @@ SDL_HasSSE42(void)
     return SDL_FALSE;
 }
 
+SDL_bool
+SDL_HasAVX(void)
+{
+    if (SDL_GetCPUFeatures() & CPU_HAS_AVX) {
+        return SDL_TRUE;
+    }
+    return SDL_FALSE;
+}
+
 #ifdef TEST_MAIN
 
 #include <stdio.h>
@@ -627,6 +663,7 @@ main()
     printf("SSE3: %d\n", SDL_HasSSE3());
     printf("SSE4.1: %d\n", SDL_HasSSE41());
     printf("SSE4.2: %d\n", SDL_HasSSE42());
+    printf("AVX: %d\n", SDL_HasAVX());
     return 0;
 }
 
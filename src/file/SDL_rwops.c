@@ -38,6 +38,14 @@
 #include "SDL_system.h"
 #endif
 
+#ifdef HAVE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #ifdef __WIN32__
 
 /* Functions to read/write Win32 API file pointers */
@@ -448,6 +456,234 @@ mem_close(SDL_RWops * context)
     return (0);
 }
 
+#ifdef HAVE_MMAP
+
+/* Functions to read memory-mapped files, which are read-only memory
+   streams that unmap the file when they're closed.
+*/
+
+static int SDLCALL
+mapped_close(SDL_RWops * context)
+{
+    if (context) {
+        munmap(context->hidden.mem.base,
+               (size_t) (context->hidden.mem.stop - context->hidden.mem.base));
+        SDL_FreeRW(context);
+    }
+    return (0);
+}
+
+static SDL_RWops *
+mapped_file_open(const char *file)
+{
+    SDL_RWops *rwops;
+    struct stat st;
+    void *data;
+    int fd;
+
+    fd = open(file, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    /* Pipes and devices can't be mapped, and empty files needn't be */
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+        (Uint64) st.st_size > (size_t) -1) {
+        close(fd);
+        return NULL;
+    }
+    data = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);                  /* The mapping keeps the file open */
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+#ifdef MADV_WILLNEED
+    /* Loaders read the whole file, so start reading it in now */
+    madvise(data, (size_t) st.st_size, MADV_WILLNEED);
+#endif
+
+    rwops = SDL_AllocRW();
+    if (rwops == NULL) {
+        munmap(data, (size_t) st.st_size);
+        return NULL;
+    }
+    rwops->size = mem_size;
+    rwops->seek = mem_seek;
+    rwops->read = mem_read;
+    rwops->write = mem_writeconst;
+    rwops->close = mapped_close;
+    rwops->hidden.mem.base = (Uint8 *) data;
+    rwops->hidden.mem.here = rwops->hidden.mem.base;
+    rwops->hidden.mem.stop = rwops->hidden.mem.base + st.st_size;
+    rwops->type = SDL_RWOPS_MAPPED;
+    return (rwops);
+}
+#endif /* HAVE_MMAP */
+
+/* Functions to read ahead from another data source.  The source is always
+   at the end of what's been read into the buffer, so the position of the
+   buffered stream is position + (here - base).  A source that reads from
+   memory is used as the buffer directly, and is only seeked when closing.
+*/
+
+#define BUFFERED_READ_SIZE  4096
+
+#define BUFFERED_SOURCE_INMEMORY(src) \
+    ((src)->type == SDL_RWOPS_MEMORY || \
+     (src)->type == SDL_RWOPS_MEMORY_RO || \
+     (src)->type == SDL_RWOPS_MAPPED)
+
+static size_t
+buffered_fill(SDL_RWops * context)
+{
+    SDL_RWops *source = context->hidden.buffered.source;
+
+    if (!BUFFERED_SOURCE_INMEMORY(source)) {
+        Uint8 *base = context->hidden.buffered.base;
+
+        context->hidden.buffered.position += (context->hidden.buffered.stop - base);
+        context->hidden.buffered.here = base;
+        context->hidden.buffered.stop = base + SDL_RWread(source, base, 1, BUFFERED_READ_SIZE);
+    }
+    return (size_t) (context->hidden.buffered.stop - context->hidden.buffered.here);
+}
+
+static Sint64 SDLCALL
+buffered_size(SDL_RWops * context)
+{
+    return SDL_RWsize(context->hidden.buffered.source);
+}
+
+static Sint64 SDLCALL
+buffered_seek(SDL_RWops * context, Sint64 offset, int whence)
+{
+    SDL_RWops *source = context->hidden.buffered.source;
+    Uint8 *base = context->hidden.buffered.base;
+    Sint64 position = context->hidden.buffered.position;
+    Sint64 length = (Sint64) (context->hidden.buffered.stop - base);
+    Sint64 newpos;
+
+    switch (whence) {
+    case RW_SEEK_SET:
+        newpos = offset;
+        break;
+    case RW_SEEK_CUR:
+        newpos = position + (context->hidden.buffered.here - base) + offset;
+        break;
+    case RW_SEEK_END:
+        if (BUFFERED_SOURCE_INMEMORY(source)) {
+            newpos = position + length + offset;
+        } else {
+            newpos = SDL_RWseek(source, offset, RW_SEEK_END);
+            if (newpos < 0) {
+                return -1;
+            }
+            context->hidden.buffered.position = newpos;
+            context->hidden.buffered.here = base;
+            context->hidden.buffered.stop = base;
+            return newpos;
+        }
+        break;
+    default:
+        return SDL_SetError("Unknown value for 'whence'");
+    }
+
+    /* Memory sources are buffered whole, so clamp to them like mem_seek() */
+    if (BUFFERED_SOURCE_INMEMORY(source)) {
+        newpos = SDL_max(newpos, 0);
+        newpos = SDL_min(newpos, length);
+    }
+    if (newpos >= position && newpos <= position + length) {
+        context->hidden.buffered.here = base + (newpos - position);
+        return newpos;
+    }
+
+    newpos = SDL_RWseek(source, newpos, RW_SEEK_SET);
+    if (newpos < 0) {
+        return -1;
+    }
+    context->hidden.buffered.position = newpos;
+    context->hidden.buffered.here = base;
+    context->hidden.buffered.stop = base;
+    return newpos;
+}
+
+static size_t SDLCALL
+buffered_read(SDL_RWops * context, void *ptr, size_t size, size_t maxnum)
+{
+    SDL_RWops *source = context->hidden.buffered.source;
+    Uint8 *dst = (Uint8 *) ptr;
+    size_t total_bytes;
+    size_t total_read = 0;
+    size_t available;
+
+    total_bytes = (maxnum * size);
+    if ((maxnum <= 0) || (size <= 0)
+        || ((total_bytes / maxnum) != (size_t) size)) {
+        return 0;
+    }
+
+    while (total_read < total_bytes) {
+        available = (context->hidden.buffered.stop - context->hidden.buffered.here);
+        if (available == 0) {
+            if (total_bytes - total_read >= BUFFERED_READ_SIZE &&
+                !BUFFERED_SOURCE_INMEMORY(source)) {
+                /* Big reads go straight to the caller's memory */
+                size_t amount = SDL_RWread(source, dst + total_read, 1,
+                                           total_bytes - total_read);
+                Uint8 *base = context->hidden.buffered.base;
+
+                context->hidden.buffered.position += (context->hidden.buffered.stop - base) + amount;
+                context->hidden.buffered.here = base;
+                context->hidden.buffered.stop = base;
+                total_read += amount;
+                break;
+            }
+            available = buffered_fill(context);
+            if (available == 0) {
+                break;
+            }
+        }
+        if (available > total_bytes - total_read) {
+            available = total_bytes - total_read;
+        }
+        SDL_memcpy(dst + total_read, context->hidden.buffered.here, available);
+        context->hidden.buffered.here += available;
+        total_read += available;
+    }
+    return (total_read / size);
+}
+
+static size_t SDLCALL
+buffered_write(SDL_RWops * context, const void *ptr, size_t size, size_t num)
+{
+    SDL_SetError("Can't write to a buffered data source");
+    return (0);
+}
+
+static int SDLCALL
+buffered_close(SDL_RWops * context)
+{
+    int status = 0;
+
+    if (context) {
+        SDL_RWops *source = context->hidden.buffered.source;
+
+        if (context->hidden.buffered.freesrc) {
+            status = SDL_RWclose(source);
+        } else if (SDL_RWtell(context) != SDL_RWtell(source)) {
+            /* Leave the source where we stopped reading, not read ahead */
+            if (SDL_RWseek(source, SDL_RWtell(context), RW_SEEK_SET) < 0) {
+                status = -1;
+            }
+        }
+        if (!BUFFERED_SOURCE_INMEMORY(source)) {
+            SDL_free(context->hidden.buffered.base);
+        }
+        SDL_FreeRW(context);
+    }
+    return status;
+}
+
 
 /* Functions to create SDL_RWops structures from various data sources */
 
@@ -619,6 +855,107 @@ SDL_RWFromConstMem(const void *mem, int size)
     return (rwops);
 }
 
+SDL_RWops *
+SDL_RWFromMappedFile(const char *file)
+{
+    if (!file || !*file) {
+        SDL_SetError("SDL_RWFromMappedFile(): No file specified");
+        return NULL;
+    }
+#ifdef HAVE_MMAP
+    {
+        SDL_RWops *rwops = mapped_file_open(file);
+        if (rwops) {
+            return rwops;
+        }
+    }
+#endif
+    /* This also finds files in bundles and Android assets */
+    return SDL_RWFromFile(file, "rb");
+}
+
+const void *
+SDL_RWGetBuffer(SDL_RWops * context, size_t * size)
+{
+    if (!context) {
+        SDL_InvalidParamError("context");
+    } else if (context->type == SDL_RWOPS_MEMORY ||
+               context->type == SDL_RWOPS_MEMORY_RO ||
+               context->type == SDL_RWOPS_MAPPED) {
+        if (size) {
+            *size = (size_t) (context->hidden.mem.stop - context->hidden.mem.here);
+        }
+        return context->hidden.mem.here;
+    }
+    if (size) {
+        *size = 0;
+    }
+    return NULL;
+}
+
+SDL_RWops *
+SDL_RWFromBufferedRW(SDL_RWops * src, int freesrc)
+{
+    SDL_RWops *rwops;
+
+    if (!src) {
+        SDL_InvalidParamError("src");
+        return NULL;
+    }
+    rwops = SDL_AllocRW();
+    if (rwops == NULL) {
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        return NULL;
+    }
+    if (BUFFERED_SOURCE_INMEMORY(src)) {
+        rwops->hidden.buffered.base = src->hidden.mem.base;
+        rwops->hidden.buffered.here = src->hidden.mem.here;
+        rwops->hidden.buffered.stop = src->hidden.mem.stop;
+        rwops->hidden.buffered.position = 0;
+    } else {
+        rwops->hidden.buffered.base = (Uint8 *) SDL_malloc(BUFFERED_READ_SIZE);
+        if (rwops->hidden.buffered.base == NULL) {
+            SDL_FreeRW(rwops);
+            if (freesrc) {
+                SDL_RWclose(src);
+            }
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        rwops->hidden.buffered.here = rwops->hidden.buffered.base;
+        rwops->hidden.buffered.stop = rwops->hidden.buffered.base;
+        rwops->hidden.buffered.position = SDL_RWtell(src);
+    }
+    rwops->hidden.buffered.source = src;
+    rwops->hidden.buffered.freesrc = freesrc;
+    rwops->size = buffered_size;
+    rwops->seek = buffered_seek;
+    rwops->read = buffered_read;
+    rwops->write = buffered_write;
+    rwops->close = buffered_close;
+    rwops->type = SDL_RWOPS_BUFFERED;
+    return (rwops);
+}
+
+size_t
+SDL_RWFillBuffer(SDL_RWops * context)
+{
+    if (!context) {
+        SDL_InvalidParamError("context");
+        return 0;
+    }
+    if (context->type == SDL_RWOPS_BUFFERED &&
+        context->hidden.buffered.here == context->hidden.buffered.stop) {
+        return buffered_fill(context);
+    }
+    if (SDL_RWOPS_INMEMORY(context)) {
+        return (size_t) (context->hidden.mem.stop - context->hidden.mem.here);
+    }
+    return 0;
+}
+
 SDL_RWops *
 SDL_AllocRW(void)
 {
@@ -644,10 +981,9 @@ SDL_FreeRW(SDL_RWops * area)
 Uint8
 SDL_ReadU8(SDL_RWops * src)
 {
-    Uint8 value = 0;
+    int value = SDL_RWgetc(src);
 
-    SDL_RWread(src, &value, (sizeof value), 1);
-    return value;
+    return (value < 0) ? 0 : (Uint8) value;
 }
 
 Uint16
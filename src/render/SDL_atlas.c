@@ -0,0 +1,502 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+/* The skyline packer behind texture atlases */
+
+#include "SDL_sysrender.h"
+#include "SDL_atlas_c.h"
+
+/* Images are kept apart so filtering doesn't bleed between them */
+#define ATLAS_PADDING   1
+
+
+static void
+SDL_ResetSkyline(SDL_TextureAtlas * atlas, SDL_AtlasPage * page)
+{
+    page->skyline[0].x = 0;
+    page->skyline[0].y = 0;
+    page->skyline[0].w = atlas->page_w;
+    page->num_nodes = 1;
+    page->used = 0;
+    page->packed = 0;
+}
+
+/* The height a w x h rectangle would sit at, starting at a skyline node,
+   or -1 if it doesn't fit there.
+ */
+static int
+SDL_FitSkyline(SDL_TextureAtlas * atlas, const SDL_AtlasPage * page,
+               int index, int w, int h)
+{
+    const SDL_SkylineNode *node = &page->skyline[index];
+    int y = 0;
+
+    if (node->x + w > atlas->page_w) {
+        return -1;
+    }
+    while (w > 0) {
+        y = SDL_max(y, node->y);
+        if (y + h > atlas->page_h) {
+            return -1;
+        }
+        w -= node->w;
+        ++node;
+    }
+    return y;
+}
+
+/* Place a rectangle as low as possible, then on the narrowest segment */
+static SDL_bool
+SDL_PackSkyline(SDL_TextureAtlas * atlas, SDL_AtlasPage * page,
+                int w, int h, SDL_Rect * rect)
+{
+    SDL_SkylineNode *skyline = page->skyline;
+    int i, y, best = -1, best_y = 0, best_bottom = 0, best_w = 0;
+    int right;
+
+    for (i = 0; i < page->num_nodes; ++i) {
+        y = SDL_FitSkyline(atlas, page, i, w, h);
+        if (y < 0) {
+            continue;
+        }
+        if (best < 0 || y + h < best_bottom ||
+            (y + h == best_bottom && skyline[i].w < best_w)) {
+            best = i;
+            best_y = y;
+            best_bottom = y + h;
+            best_w = skyline[i].w;
+        }
+    }
+    if (best < 0) {
+        return SDL_FALSE;
+    }
+
+    rect->x = skyline[best].x;
+    rect->y = best_y;
+    rect->w = w;
+    rect->h = h;
+
+    /* Raise the skyline over the new rectangle */
+    SDL_memmove(&skyline[best + 1], &skyline[best],
+                (page->num_nodes - best) * sizeof(*skyline));
+    ++page->num_nodes;
+    skyline[best].x = rect->x;
+    skyline[best].y = best_bottom;
+    skyline[best].w = w;
+
+    right = rect->x + w;
+    for (i = best + 1; i < page->num_nodes; ) {
+        if (skyline[i].x >= right) {
+            break;
+        }
+        if (skyline[i].x + skyline[i].w > right) {
+            skyline[i].w -= right - skyline[i].x;
+            skyline[i].x = right;
+            break;
+        }
+        SDL_memmove(&skyline[i], &skyline[i + 1],
+                    (page->num_nodes - i - 1) * sizeof(*skyline));
+        --page->num_nodes;
+    }
+
+    /* Merge segments at the same height */
+    for (i = 0; i < page->num_nodes - 1; ) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].w += skyline[i + 1].w;
+            SDL_memmove(&skyline[i + 1], &skyline[i + 2],
+                        (page->num_nodes - i - 2) * sizeof(*skyline));
+            --page->num_nodes;
+        } else {
+            ++i;
+        }
+    }
+
+    page->used += w * h;
+    page->packed += w * h;
+    return SDL_TRUE;
+}
+
+static SDL_Surface *
+SDL_CreateAtlasSurface(SDL_TextureAtlas * atlas)
+{
+    SDL_Surface *surface;
+    Uint32 Rmask, Gmask, Bmask, Amask;
+    int bpp;
+
+    if (!SDL_PixelFormatEnumToMasks(atlas->format, &bpp, &Rmask, &Gmask, &Bmask, &Amask)) {
+        return NULL;
+    }
+    surface = SDL_CreateRGBSurface(0, atlas->page_w, atlas->page_h, bpp,
+                                   Rmask, Gmask, Bmask, Amask);
+    if (surface) {
+        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+    }
+    return surface;
+}
+
+static SDL_AtlasPage *
+SDL_AddAtlasPage(SDL_TextureAtlas * atlas)
+{
+    SDL_AtlasPage *page, **tail;
+
+    page = (SDL_AtlasPage *) SDL_calloc(1, sizeof(*page));
+    if (!page) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    page->skyline = (SDL_SkylineNode *) SDL_malloc((atlas->page_w + 1) * sizeof(*page->skyline));
+    page->surface = SDL_CreateAtlasSurface(atlas);
+    if (page->skyline && page->surface) {
+        page->texture = SDL_CreateTexture(atlas->renderer, atlas->format,
+                                          SDL_TEXTUREACCESS_STATIC,
+                                          atlas->page_w, atlas->page_h);
+    } else {
+        SDL_OutOfMemory();
+    }
+    if (!page->texture) {
+        SDL_FreeSurface(page->surface);
+        SDL_free(page->skyline);
+        SDL_free(page);
+        return NULL;
+    }
+    SDL_UpdateTexture(page->texture, NULL, page->surface->pixels, page->surface->pitch);
+    SDL_ResetSkyline(atlas, page);
+
+    for (tail = &atlas->pages; *tail; tail = &(*tail)->next) {
+    }
+    *tail = page;
+    return page;
+}
+
+static void
+SDL_FreeAtlasPage(SDL_AtlasPage * page)
+{
+    SDL_DestroyTexture(page->texture);
+    SDL_FreeSurface(page->surface);
+    SDL_free(page->skyline);
+    SDL_free(page);
+}
+
+int
+SDL_AllocAtlasRect(SDL_TextureAtlas * atlas, int w, int h,
+                   SDL_AtlasPage ** page, SDL_Rect * rect)
+{
+    const int padded_w = w + ATLAS_PADDING;
+    const int padded_h = h + ATLAS_PADDING;
+    SDL_AtlasPage *candidate;
+    int wasted = 0;
+
+    if (w <= 0 || h <= 0) {
+        return SDL_SetError("Texture atlas images must be at least 1x1");
+    }
+    if (padded_w > atlas->page_w || padded_h > atlas->page_h) {
+        return SDL_SetError("Image is too large for the texture atlas");
+    }
+
+    for (candidate = atlas->pages; candidate; candidate = candidate->next) {
+        if (SDL_PackSkyline(atlas, candidate, padded_w, padded_h, rect)) {
+            break;
+        }
+        wasted += candidate->packed - candidate->used;
+    }
+
+    /* Skylines can't reuse freed space, so repack before growing */
+    if (!candidate && wasted >= padded_w * padded_h) {
+        if (SDL_RepackAtlas(atlas) < 0) {
+            return -1;
+        }
+        for (candidate = atlas->pages; candidate; candidate = candidate->next) {
+            if (SDL_PackSkyline(atlas, candidate, padded_w, padded_h, rect)) {
+                break;
+            }
+        }
+    }
+
+    if (!candidate) {
+        candidate = SDL_AddAtlasPage(atlas);
+        if (!candidate) {
+            return -1;
+        }
+        SDL_PackSkyline(atlas, candidate, padded_w, padded_h, rect);
+    }
+
+    /* Clear the padding, which may hold pixels of an image freed earlier */
+    SDL_FillRect(candidate->surface, rect, 0);
+
+    rect->w = w;
+    rect->h = h;
+    *page = candidate;
+    return 0;
+}
+
+void
+SDL_FreeAtlasRect(SDL_TextureAtlas * atlas, SDL_AtlasPage * page,
+                  const SDL_Rect * rect)
+{
+    page->used -= (rect->w + ATLAS_PADDING) * (rect->h + ATLAS_PADDING);
+    if (page->used == 0) {
+        SDL_ResetSkyline(atlas, page);
+    }
+}
+
+static int
+SDL_CompareAtlasTextures(const void *a, const void *b)
+{
+    const SDL_Texture *A = *(const SDL_Texture **) a;
+    const SDL_Texture *B = *(const SDL_Texture **) b;
+
+    /* Tallest first, then widest, packs a skyline most tightly */
+    if (A->h != B->h) {
+        return B->h - A->h;
+    }
+    return B->w - A->w;
+}
+
+int
+SDL_RepackAtlas(SDL_TextureAtlas * atlas)
+{
+    SDL_AtlasPage *page, **tail;
+    SDL_AtlasPage *plans = NULL;
+    SDL_AtlasPage **pages = NULL;
+    SDL_Surface **sources = NULL;
+    SDL_Texture **textures = NULL;
+    SDL_Texture *texture;
+    int *placed = NULL;
+    SDL_Rect *rects = NULL;
+    int i, j, num_pages = 0, num_plans = 0, num_textures = 0;
+    SDL_bool laid_out = SDL_FALSE;
+    int status = -1;
+
+    for (page = atlas->pages; page; page = page->next) {
+        ++num_pages;
+    }
+    for (texture = atlas->textures; texture; texture = texture->next) {
+        ++num_textures;
+    }
+    if (num_pages == 0) {
+        return 0;
+    }
+
+    /* Each image may need a page of its own, at worst */
+    plans = (SDL_AtlasPage *) SDL_calloc(num_pages + num_textures, sizeof(*plans));
+    pages = (SDL_AtlasPage **) SDL_calloc(num_pages + num_textures, sizeof(*pages));
+    sources = (SDL_Surface **) SDL_calloc(num_pages, sizeof(*sources));
+    textures = (SDL_Texture **) SDL_malloc((num_textures + 1) * sizeof(*textures));
+    placed = (int *) SDL_malloc((num_textures + 1) * sizeof(*placed));
+    rects = (SDL_Rect *) SDL_malloc((num_textures + 1) * sizeof(*rects));
+    if (!plans || !pages || !sources || !textures || !placed || !rects) {
+        SDL_OutOfMemory();
+        goto done;
+    }
+
+    for (i = 0, texture = atlas->textures; texture; ++i, texture = texture->next) {
+        textures[i] = texture;
+    }
+    SDL_qsort(textures, num_textures, sizeof(*textures), SDL_CompareAtlasTextures);
+
+    /* Plan the new layout on scratch skylines, so a failure on the way
+       leaves every image where it is
+     */
+    for (i = 0; i < num_textures; ++i) {
+        const SDL_Rect *old_rect = &textures[i]->page_rect;
+
+        for (j = 0; j < num_plans; ++j) {
+            if (SDL_PackSkyline(atlas, &plans[j], old_rect->w + ATLAS_PADDING,
+                                old_rect->h + ATLAS_PADDING, &rects[i])) {
+                break;
+            }
+        }
+        if (j == num_plans) {
+            /* Sorting almost always packs tighter, but not always */
+            plans[j].skyline = (SDL_SkylineNode *) SDL_malloc((atlas->page_w + 1) * sizeof(*plans[j].skyline));
+            if (!plans[j].skyline) {
+                SDL_OutOfMemory();
+                goto done;
+            }
+            SDL_ResetSkyline(atlas, &plans[j]);
+            ++num_plans;
+            SDL_PackSkyline(atlas, &plans[j], old_rect->w + ATLAS_PADDING,
+                            old_rect->h + ATLAS_PADDING, &rects[i]);
+        }
+        rects[i].w = old_rect->w;
+        rects[i].h = old_rect->h;
+        placed[i] = j;
+    }
+
+    /* Get everything the new layout needs before changing anything: a fresh
+       surface for each page, and any pages the old layout didn't have
+     */
+    for (i = 0, page = atlas->pages; page; ++i, page = page->next) {
+        pages[i] = page;
+        sources[i] = SDL_CreateAtlasSurface(atlas);
+        if (!sources[i]) {
+            SDL_OutOfMemory();
+            goto done;
+        }
+    }
+    for (i = num_pages; i < num_plans; ++i) {
+        pages[i] = SDL_AddAtlasPage(atlas);
+        if (!pages[i]) {
+            goto done;
+        }
+    }
+
+    /* Nothing can fail from here on */
+    for (i = 0; i < num_pages; ++i) {
+        SDL_Surface *surface = pages[i]->surface;
+
+        pages[i]->surface = sources[i];
+        sources[i] = surface;
+    }
+    for (i = 0; i < SDL_max(num_pages, num_plans); ++i) {
+        if (i < num_plans) {
+            SDL_memcpy(pages[i]->skyline, plans[i].skyline,
+                       plans[i].num_nodes * sizeof(*plans[i].skyline));
+            pages[i]->num_nodes = plans[i].num_nodes;
+            pages[i]->used = plans[i].used;
+            pages[i]->packed = plans[i].packed;
+        } else {
+            SDL_ResetSkyline(atlas, pages[i]);
+        }
+    }
+    for (i = 0; i < num_textures; ++i) {
+        SDL_AtlasPage *old_page = textures[i]->page;
+
+        for (j = 0; pages[j] != old_page; ++j) {
+        }
+        SDL_LowerBlit(sources[j], &textures[i]->page_rect,
+                      pages[placed[i]]->surface, &rects[i]);
+        textures[i]->page = pages[placed[i]];
+        textures[i]->page_rect = rects[i];
+    }
+    laid_out = SDL_TRUE;
+    status = 0;
+
+    /* Upload the repacked pages */
+    for (page = atlas->pages; page; page = page->next) {
+        if (page->used == 0) {
+            continue;
+        }
+        if (SDL_UpdateTexture(page->texture, NULL, page->surface->pixels,
+                              page->surface->pitch) < 0) {
+            status = -1;
+        }
+    }
+
+done:
+    if (!laid_out && pages) {
+        /* Drop the pages added for a layout that wasn't used */
+        for (i = num_pages; i < num_plans && pages[i]; ++i) {
+            for (tail = &atlas->pages; *tail != pages[i]; tail = &(*tail)->next) {
+            }
+            *tail = pages[i]->next;
+            SDL_FreeAtlasPage(pages[i]);
+        }
+    }
+    if (sources) {
+        for (i = 0; i < num_pages; ++i) {
+            SDL_FreeSurface(sources[i]);
+        }
+    }
+    if (plans) {
+        for (i = 0; i < num_plans; ++i) {
+            SDL_free(plans[i].skyline);
+        }
+    }
+    SDL_free(plans);
+    SDL_free(pages);
+    SDL_free(sources);
+    SDL_free(textures);
+    SDL_free(placed);
+    SDL_free(rects);
+
+    /* Drop the pages left empty, the first one included */
+    for (tail = &atlas->pages; *tail; ) {
+        page = *tail;
+        if (page->used == 0) {
+            *tail = page->next;
+            SDL_FreeAtlasPage(page);
+        } else {
+            tail = &page->next;
+        }
+    }
+    return status;
+}
+
+int
+SDL_UpdateAtlasTexture(SDL_Texture * texture, const SDL_Rect * rect,
+                       const void *pixels, int pitch)
+{
+    SDL_AtlasPage *page = texture->page;
+    SDL_Surface *surface = page->surface;
+    SDL_Rect bounds, page_rect, upload_rect;
+    const Uint8 *src;
+    Uint8 *dst;
+    size_t length;
+    int row;
+
+    bounds.x = 0;
+    bounds.y = 0;
+    bounds.w = texture->w;
+    bounds.h = texture->h;
+    if (!SDL_IntersectRect(rect, &bounds, &page_rect) ||
+        page_rect.x != rect->x || page_rect.y != rect->y ||
+        page_rect.w != rect->w || page_rect.h != rect->h) {
+        return SDL_SetError("Update rectangle is outside the texture");
+    }
+    page_rect.x += texture->page_rect.x;
+    page_rect.y += texture->page_rect.y;
+
+    /* Keep the page copy current for repacking, then upload from it */
+    src = (const Uint8 *) pixels;
+    dst = (Uint8 *) surface->pixels + page_rect.y * surface->pitch +
+          page_rect.x * surface->format->BytesPerPixel;
+    length = page_rect.w * surface->format->BytesPerPixel;
+    for (row = 0; row < page_rect.h; ++row) {
+        SDL_memcpy(dst, src, length);
+        src += pitch;
+        dst += surface->pitch;
+    }
+
+    /* Replacing the whole image uploads its padding too */
+    upload_rect = page_rect;
+    if (rect->w == texture->w && rect->h == texture->h) {
+        upload_rect.w += ATLAS_PADDING;
+        upload_rect.h += ATLAS_PADDING;
+    }
+    dst = (Uint8 *) surface->pixels + upload_rect.y * surface->pitch +
+          upload_rect.x * surface->format->BytesPerPixel;
+    return SDL_UpdateTexture(page->texture, &upload_rect, dst, surface->pitch);
+}
+
+void
+SDL_DestroyAtlasPages(SDL_TextureAtlas * atlas)
+{
+    while (atlas->pages) {
+        SDL_AtlasPage *page = atlas->pages;
+
+        atlas->pages = page->next;
+        SDL_FreeAtlasPage(page);
+    }
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
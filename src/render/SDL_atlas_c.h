@@ -0,0 +1,69 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+#include "SDL_render.h"
+
+/* Texture atlases pack many images into a few shared page textures */
+
+/* A segment of the skyline, the top edge of everything packed below it */
+typedef struct
+{
+    int x, y, w;
+} SDL_SkylineNode;
+
+struct SDL_AtlasPage
+{
+    SDL_Texture *texture;
+    SDL_Surface *surface;       /**< A copy of the page pixels, for repacking */
+    SDL_SkylineNode *skyline;
+    int num_nodes;
+    int used;                   /**< The area of the images in the page */
+    int packed;                 /**< The area packed since the page was empty */
+    struct SDL_AtlasPage *next;
+};
+
+typedef struct SDL_AtlasPage SDL_AtlasPage;
+
+struct SDL_TextureAtlas
+{
+    SDL_Renderer *renderer;
+    Uint32 format;
+    int page_w;
+    int page_h;
+    SDL_AtlasPage *pages;
+    SDL_Texture *textures;      /**< The images packed into the pages */
+
+    SDL_TextureAtlas *prev;
+    SDL_TextureAtlas *next;
+};
+
+/* Find room for a w x h image, repacking or adding a page if needed */
+int SDL_AllocAtlasRect(SDL_TextureAtlas * atlas, int w, int h,
+                       SDL_AtlasPage ** page, SDL_Rect * rect);
+void SDL_FreeAtlasRect(SDL_TextureAtlas * atlas, SDL_AtlasPage * page,
+                       const SDL_Rect * rect);
+int SDL_RepackAtlas(SDL_TextureAtlas * atlas);
+int SDL_UpdateAtlasTexture(SDL_Texture * texture, const SDL_Rect * rect,
+                           const void *pixels, int pitch);
+void SDL_DestroyAtlasPages(SDL_TextureAtlas * atlas);
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,235 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+/* The worker thread that finishes asynchronous reads of the render target */
+
+#include "SDL_cpuinfo.h"
+#include "SDL_sysrender.h"
+
+static void
+SDL_FlipReadbackRows(SDL_RenderReadback * readback)
+{
+    const int length = readback->rect.w * SDL_BYTESPERPIXEL(readback->src_format);
+    Uint8 *src = (Uint8 *) readback->src_pixels + (readback->rect.h - 1) * readback->src_pitch;
+    Uint8 *dst = (Uint8 *) readback->src_pixels;
+    Uint8 *tmp = SDL_stack_alloc(Uint8, length);
+    int rows = readback->rect.h / 2;
+
+    while (rows--) {
+        SDL_memcpy(tmp, dst, length);
+        SDL_memcpy(dst, src, length);
+        SDL_memcpy(src, tmp, length);
+        dst += readback->src_pitch;
+        src -= readback->src_pitch;
+    }
+    SDL_stack_free(tmp);
+}
+
+static int
+SDL_ReadbackThread(void *data)
+{
+    SDL_ReadbackWorker *worker = (SDL_ReadbackWorker *) data;
+
+    SDL_LockMutex(worker->lock);
+    for ( ; ; ) {
+        SDL_RenderReadback *readback;
+        SDL_ReadbackStatus status = SDL_READBACK_DONE;
+
+        while (!worker->head && !worker->quit) {
+            SDL_CondWait(worker->wake, worker->lock);
+        }
+        if (!worker->head) {
+            break;
+        }
+        readback = worker->head;
+        worker->head = readback->next_queued;
+        if (!worker->head) {
+            worker->tail = NULL;
+        }
+        SDL_UnlockMutex(worker->lock);
+
+        /* Nothing else touches the pixels until the status changes */
+        if (readback->src_flipped) {
+            SDL_FlipReadbackRows(readback);
+        }
+        if (readback->pixels != readback->src_pixels &&
+            SDL_ConvertPixels(readback->rect.w, readback->rect.h,
+                              readback->src_format, readback->src_pixels,
+                              readback->src_pitch, readback->format,
+                              readback->pixels, readback->pitch) < 0) {
+            status = SDL_READBACK_FAILED;
+        }
+
+        SDL_LockMutex(worker->lock);
+        readback->status = status;
+        SDL_CondBroadcast(worker->done);
+    }
+    SDL_UnlockMutex(worker->lock);
+    return 0;
+}
+
+static void
+SDL_DestroyReadbackWorker(SDL_ReadbackWorker * worker)
+{
+    if (worker->thread) {
+        SDL_LockMutex(worker->lock);
+        worker->quit = SDL_TRUE;
+        SDL_CondSignal(worker->wake);
+        SDL_UnlockMutex(worker->lock);
+        SDL_WaitThread(worker->thread, NULL);
+    }
+    if (worker->lock) {
+        SDL_DestroyMutex(worker->lock);
+    }
+    if (worker->wake) {
+        SDL_DestroyCond(worker->wake);
+    }
+    if (worker->done) {
+        SDL_DestroyCond(worker->done);
+    }
+    SDL_free(worker);
+}
+
+static SDL_ReadbackWorker *
+SDL_CreateReadbackWorker(void)
+{
+    SDL_ReadbackWorker *worker;
+
+    worker = (SDL_ReadbackWorker *) SDL_calloc(1, sizeof(*worker));
+    if (!worker) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    worker->lock = SDL_CreateMutex();
+    worker->wake = SDL_CreateCond();
+    worker->done = SDL_CreateCond();
+    if (!worker->lock || !worker->wake || !worker->done) {
+        SDL_DestroyReadbackWorker(worker);
+        return NULL;
+    }
+
+    /* Make sure the CPU features are detected before the thread looks */
+    SDL_HasSSE2();
+
+    worker->thread = SDL_CreateThread(SDL_ReadbackThread, "SDLRenderReadback", worker);
+    if (!worker->thread) {
+        SDL_DestroyReadbackWorker(worker);
+        return NULL;
+    }
+    return worker;
+}
+
+int
+SDL_QueueReadbackConversion(SDL_Renderer * renderer,
+                            SDL_RenderReadback * readback)
+{
+    SDL_ReadbackWorker *worker;
+
+    /* Pixels that are already right don't need the worker */
+    if (!readback->src_flipped && readback->src_format == readback->format) {
+        readback->pixels = readback->src_pixels;
+        readback->pitch = readback->src_pitch;
+        readback->status = SDL_READBACK_DONE;
+        return 0;
+    }
+
+    if (readback->src_format == readback->format) {
+        /* Only flipped, which is done in place */
+        readback->pixels = readback->src_pixels;
+        readback->pitch = readback->src_pitch;
+    } else {
+        readback->pitch = readback->rect.w * SDL_BYTESPERPIXEL(readback->format);
+        readback->pixels = SDL_malloc(readback->rect.h * readback->pitch);
+        if (!readback->pixels) {
+            return SDL_OutOfMemory();
+        }
+    }
+
+    if (!renderer->readback_worker) {
+        renderer->readback_worker = SDL_CreateReadbackWorker();
+        if (!renderer->readback_worker) {
+            return -1;
+        }
+    }
+    worker = renderer->readback_worker;
+
+    SDL_LockMutex(worker->lock);
+    readback->status = SDL_READBACK_CONVERTING;
+    readback->next_queued = NULL;
+    if (worker->tail) {
+        worker->tail->next_queued = readback;
+    } else {
+        worker->head = readback;
+    }
+    worker->tail = readback;
+    SDL_CondSignal(worker->wake);
+    SDL_UnlockMutex(worker->lock);
+    return 0;
+}
+
+SDL_ReadbackStatus
+SDL_GetReadbackStatus(SDL_RenderReadback * readback, SDL_bool wait)
+{
+    SDL_ReadbackWorker *worker;
+    SDL_ReadbackStatus status;
+
+    if (!readback->renderer || !readback->renderer->readback_worker) {
+        return readback->status;
+    }
+    worker = readback->renderer->readback_worker;
+
+    SDL_LockMutex(worker->lock);
+    while (wait && readback->status == SDL_READBACK_CONVERTING) {
+        SDL_CondWait(worker->done, worker->lock);
+    }
+    status = readback->status;
+    SDL_UnlockMutex(worker->lock);
+    return status;
+}
+
+void
+SDL_DetachRenderReadbacks(SDL_Renderer * renderer)
+{
+    SDL_RenderReadback *readback;
+
+    for (readback = renderer->readbacks; readback; readback = readback->next) {
+        SDL_ReadbackStatus status = SDL_GetReadbackStatus(readback, SDL_TRUE);
+
+        if (status == SDL_READBACK_READING) {
+            if (renderer->DestroyReadback) {
+                renderer->DestroyReadback(renderer, readback);
+            }
+            readback->status = SDL_READBACK_FAILED;
+        }
+    }
+    for (readback = renderer->readbacks; readback; readback = readback->next) {
+        readback->renderer = NULL;
+    }
+    renderer->readbacks = NULL;
+
+    if (renderer->readback_worker) {
+        SDL_DestroyReadbackWorker(renderer->readback_worker);
+        renderer->readback_worker = NULL;
+    }
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
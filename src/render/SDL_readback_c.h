@@ -0,0 +1,90 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_readback_c_h
+#define _SDL_readback_c_h
+
+#include "SDL_mutex.h"
+#include "SDL_thread.h"
+#include "SDL_render.h"
+
+/* Reads of the render target started by SDL_RenderReadPixelsAsync().  The
+   backend copies the pixels out of the target, then a worker thread shared
+   by the renderer's reads flips and converts them.
+ */
+
+typedef enum
+{
+    SDL_READBACK_READING,       /**< Waiting for the backend's copy */
+    SDL_READBACK_CONVERTING,    /**< Queued for or being converted by the worker */
+    SDL_READBACK_DONE,
+    SDL_READBACK_FAILED
+} SDL_ReadbackStatus;
+
+struct SDL_RenderReadback
+{
+    SDL_Renderer *renderer;     /**< NULL once the renderer is destroyed */
+    SDL_Rect rect;              /**< The area of the target being read */
+    Uint32 format;
+    Uint32 frame;               /**< The frame the read was started in */
+
+    /* The pixels as copied by the backend */
+    Uint32 src_format;
+    void *src_pixels;
+    int src_pitch;
+    SDL_bool src_flipped;       /**< Rows are bottom-up */
+
+    /* The result, which may share the memory of the source */
+    void *pixels;
+    int pitch;
+
+    SDL_ReadbackStatus status;  /**< Written by the worker while converting */
+
+    void *driverdata;           /**< Driver specific state of the copy */
+
+    SDL_RenderReadback *next;   /**< The renderer's reads */
+    SDL_RenderReadback *next_queued;
+};
+
+typedef struct SDL_ReadbackWorker
+{
+    SDL_Thread *thread;
+    SDL_mutex *lock;
+    SDL_cond *wake;             /**< Signaled when a read is queued */
+    SDL_cond *done;             /**< Signaled when a read is converted */
+    SDL_RenderReadback *head;
+    SDL_RenderReadback *tail;
+    SDL_bool quit;
+} SDL_ReadbackWorker;
+
+/* Hand a read copied by the backend to the worker, starting it if needed */
+int SDL_QueueReadbackConversion(SDL_Renderer * renderer,
+                                SDL_RenderReadback * readback);
+/* Returns the status, waiting for the conversion to finish if asked */
+SDL_ReadbackStatus SDL_GetReadbackStatus(SDL_RenderReadback * readback,
+                                         SDL_bool wait);
+/* Fail the renderer's pending reads and stop its worker */
+void SDL_DetachRenderReadbacks(SDL_Renderer * renderer);
+
+#endif /* _SDL_readback_c_h */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -26,6 +26,8 @@
 #include "SDL_log.h"
 #include "SDL_render.h"
 #include "SDL_sysrender.h"
+#include "SDL_atlas_c.h"
+#include "SDL_texbuffers_c.h"
 #include "software/SDL_render_sw_c.h"
 
 
@@ -73,6 +75,122 @@ static char texture_magic;
 
 static int UpdateLogicalSize(SDL_Renderer *renderer);
 
+/* Send the recorded draws to the backend */
+static int
+FlushRenderCommands(SDL_Renderer * renderer)
+{
+    SDL_RenderCommandQueue *queue = &renderer->queue;
+    int i, status = 0;
+
+    if (queue->count == 0) {
+        return 0;
+    }
+
+    switch (queue->type) {
+    case SDL_RENDERCMD_FILLRECTS:
+        status = renderer->RenderFillRects(renderer, queue->dstrects, queue->count);
+        break;
+    case SDL_RENDERCMD_COPY:
+        if (renderer->RenderCopies) {
+            status = renderer->RenderCopies(renderer, queue->texture,
+                                            queue->srcrects, queue->dstrects,
+                                            queue->count);
+        } else {
+            for (i = 0; i < queue->count; ++i) {
+                if (renderer->RenderCopy(renderer, queue->texture,
+                                         &queue->srcrects[i],
+                                         &queue->dstrects[i]) < 0) {
+                    status = -1;
+                }
+            }
+        }
+        break;
+    default:
+        break;
+    }
+
+    queue->type = SDL_RENDERCMD_NONE;
+    queue->texture = NULL;
+    queue->count = 0;
+    return status;
+}
+
+/* Flush before a texture changes in a way that affects the draws recorded
+   from it or into it.
+ */
+static int
+FlushTextureCommands(SDL_Texture * texture)
+{
+    SDL_Renderer *renderer = texture->renderer;
+
+    if (renderer->queue.texture == texture || renderer->target == texture) {
+        return FlushRenderCommands(renderer);
+    }
+    return 0;
+}
+
+/* Record a draw, merging it with the previous ones if it uses the same
+   texture and state.  Anything that changes that state flushes first.
+ */
+static int
+QueueRenderCommand(SDL_Renderer * renderer, SDL_RenderCommandType type,
+                   SDL_Texture * texture, const SDL_Rect * srcrect,
+                   const SDL_FRect * dstrects, int count)
+{
+    SDL_RenderCommandQueue *queue = &renderer->queue;
+
+    if (queue->type != type || queue->texture != texture) {
+        if (FlushRenderCommands(renderer) < 0) {
+            return -1;
+        }
+        queue->type = type;
+        queue->texture = texture;
+    }
+
+    if (queue->count + count > queue->max_count) {
+        int max_count = SDL_max(queue->max_count * 2, queue->count + count);
+        SDL_Rect *srcrects;
+        SDL_FRect *rects;
+
+        max_count = SDL_max(max_count, 64);
+        srcrects = (SDL_Rect *) SDL_realloc(queue->srcrects, max_count * sizeof(*srcrects));
+        if (!srcrects) {
+            return SDL_OutOfMemory();
+        }
+        queue->srcrects = srcrects;
+
+        rects = (SDL_FRect *) SDL_realloc(queue->dstrects, max_count * sizeof(*rects));
+        if (!rects) {
+            return SDL_OutOfMemory();
+        }
+        queue->dstrects = rects;
+        queue->max_count = max_count;
+    }
+
+    if (srcrect) {
+        queue->srcrects[queue->count] = *srcrect;
+    }
+    SDL_memcpy(&queue->dstrects[queue->count], dstrects, count * sizeof(*dstrects));
+    queue->count += count;
+
+    if (!renderer->batching) {
+        return FlushRenderCommands(renderer);
+    }
+    return 0;
+}
+
+static void
+InitRenderCommands(SDL_Renderer * renderer, SDL_bool batching)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_RENDER_BATCHING);
+
+    if (hint && *hint) {
+        batching = (*hint != '0') ? SDL_TRUE : SDL_FALSE;
+    }
+    renderer->batching = batching;
+    SDL_zero(renderer->queue);
+}
+
 int
 SDL_GetNumRenderDrivers(void)
 {
@@ -106,6 +224,9 @@ SDL_RendererEventWatch(void *userdata, SDL_Event *event)
     if (event->type == SDL_WINDOWEVENT) {
         SDL_Window *window = SDL_GetWindowFromID(event->window.windowID);
         if (window == renderer->window) {
+            /* Draw what was recorded before the window changes */
+            FlushRenderCommands(renderer);
+
             if (renderer->WindowEvent) {
                 renderer->WindowEvent(renderer, &event->window);
             }
@@ -273,6 +394,7 @@ SDL_CreateRenderer(SDL_Window * window, int index, Uint32 flags)
         renderer->window = window;
         renderer->scale.x = 1.0f;
         renderer->scale.y = 1.0f;
+        InitRenderCommands(renderer, SDL_TRUE);
 
         if (SDL_GetWindowFlags(window) & (SDL_WINDOW_HIDDEN|SDL_WINDOW_MINIMIZED)) {
             renderer->hidden = SDL_TRUE;
@@ -308,6 +430,8 @@ SDL_CreateSoftwareRenderer(SDL_Surface * surface)
         renderer->magic = &renderer_magic;
         renderer->scale.x = 1.0f;
         renderer->scale.y = 1.0f;
+        /* Applications use the surface as soon as the draw calls return */
+        InitRenderCommands(renderer, SDL_FALSE);
 
         SDL_RenderSetViewport(renderer, NULL);
     }
@@ -377,6 +501,13 @@ GetClosestSupportedFormat(SDL_Renderer * renderer, Uint32 format)
                 return renderer->info.texture_formats[i];
             }
         }
+        /* Otherwise YUV is converted to a format that keeps 8 bit channels */
+        for (i = 0; i < renderer->info.num_texture_formats; ++i) {
+            if (!SDL_ISPIXELFORMAT_FOURCC(renderer->info.texture_formats[i]) &&
+                SDL_BYTESPERPIXEL(renderer->info.texture_formats[i]) == 4) {
+                return renderer->info.texture_formats[i];
+            }
+        }
     } else {
         SDL_bool hasAlpha = SDL_ISPIXELFORMAT_ALPHA(format);
 
@@ -560,6 +691,248 @@ SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface)
     return texture;
 }
 
+/* The application owns an atlas, and the renderer keeps a list of them.
+   Destroying the renderer destroys their images and pages and clears their
+   renderer, after which the atlas is only good for being destroyed.
+ */
+SDL_TextureAtlas *
+SDL_CreateTextureAtlas(SDL_Renderer * renderer, Uint32 format, int w, int h)
+{
+    SDL_TextureAtlas *atlas;
+
+    CHECK_RENDERER_MAGIC(renderer, NULL);
+
+    if (!format) {
+        format = SDL_PIXELFORMAT_ARGB8888;
+    }
+    if (SDL_BYTESPERPIXEL(format) == 0 || SDL_ISPIXELFORMAT_FOURCC(format)) {
+        SDL_SetError("Texture atlases need a packed pixel format");
+        return NULL;
+    }
+    if (w <= 0 || h <= 0) {
+        SDL_SetError("Texture atlas pages must be at least 1x1");
+        return NULL;
+    }
+
+    atlas = (SDL_TextureAtlas *) SDL_calloc(1, sizeof(*atlas));
+    if (!atlas) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    atlas->renderer = renderer;
+    atlas->format = format;
+    atlas->page_w = w;
+    atlas->page_h = h;
+
+    atlas->next = renderer->atlases;
+    if (renderer->atlases) {
+        renderer->atlases->prev = atlas;
+    }
+    renderer->atlases = atlas;
+
+    return atlas;
+}
+
+SDL_Texture *
+SDL_CreateAtlasTextureFromSurface(SDL_TextureAtlas * atlas, SDL_Surface * surface)
+{
+    SDL_Texture *texture;
+    SDL_Rect rect;
+    int status;
+
+    if (!atlas) {
+        SDL_InvalidParamError("atlas");
+        return NULL;
+    }
+    if (!atlas->renderer) {
+        SDL_SetError("The texture atlas's renderer was destroyed");
+        return NULL;
+    }
+    if (!surface) {
+        SDL_SetError("SDL_CreateAtlasTextureFromSurface() passed NULL surface");
+        return NULL;
+    }
+
+    texture = (SDL_Texture *) SDL_calloc(1, sizeof(*texture));
+    if (!texture) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    texture->magic = &texture_magic;
+    texture->format = atlas->format;
+    texture->access = SDL_TEXTUREACCESS_STATIC;
+    texture->w = surface->w;
+    texture->h = surface->h;
+    texture->r = 255;
+    texture->g = 255;
+    texture->b = 255;
+    texture->a = 255;
+    texture->renderer = atlas->renderer;
+    texture->atlas = atlas;
+
+    if (SDL_AllocAtlasRect(atlas, surface->w, surface->h,
+                           &texture->page, &texture->page_rect) < 0) {
+        SDL_free(texture);
+        return NULL;
+    }
+
+    rect.x = 0;
+    rect.y = 0;
+    rect.w = surface->w;
+    rect.h = surface->h;
+    if (surface->format->format == atlas->format &&
+        SDL_GetColorKey(surface, NULL) < 0) {
+        if (SDL_MUSTLOCK(surface)) {
+            SDL_LockSurface(surface);
+            status = SDL_UpdateAtlasTexture(texture, &rect, surface->pixels, surface->pitch);
+            SDL_UnlockSurface(surface);
+        } else {
+            status = SDL_UpdateAtlasTexture(texture, &rect, surface->pixels, surface->pitch);
+        }
+    } else {
+        SDL_PixelFormat *dst_fmt;
+        SDL_Surface *temp = NULL;
+
+        /* The conversion turns a colorkey into alpha */
+        dst_fmt = SDL_AllocFormat(atlas->format);
+        if (dst_fmt) {
+            temp = SDL_ConvertSurface(surface, dst_fmt, 0);
+            SDL_FreeFormat(dst_fmt);
+        }
+        if (temp) {
+            status = SDL_UpdateAtlasTexture(texture, &rect, temp->pixels, temp->pitch);
+            SDL_FreeSurface(temp);
+        } else {
+            status = -1;
+        }
+    }
+    if (status < 0) {
+        SDL_FreeAtlasRect(atlas, texture->page, &texture->page_rect);
+        SDL_free(texture);
+        return NULL;
+    }
+
+    texture->next = atlas->textures;
+    if (atlas->textures) {
+        atlas->textures->prev = texture;
+    }
+    atlas->textures = texture;
+
+    {
+        Uint8 r, g, b, a;
+        SDL_BlendMode blendMode;
+
+        SDL_GetSurfaceColorMod(surface, &r, &g, &b);
+        SDL_SetTextureColorMod(texture, r, g, b);
+
+        SDL_GetSurfaceAlphaMod(surface, &a);
+        SDL_SetTextureAlphaMod(texture, a);
+
+        if (SDL_GetColorKey(surface, NULL) == 0) {
+            /* We converted to a texture with alpha format */
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        } else {
+            SDL_GetSurfaceBlendMode(surface, &blendMode);
+            SDL_SetTextureBlendMode(texture, blendMode);
+        }
+    }
+    return texture;
+}
+
+int
+SDL_DefragmentTextureAtlas(SDL_TextureAtlas * atlas)
+{
+    if (!atlas) {
+        return SDL_InvalidParamError("atlas");
+    }
+    if (!atlas->renderer) {
+        return SDL_SetError("The texture atlas's renderer was destroyed");
+    }
+    return SDL_RepackAtlas(atlas);
+}
+
+int
+SDL_GetTextureAtlasPages(SDL_TextureAtlas * atlas)
+{
+    SDL_AtlasPage *page;
+    int count = 0;
+
+    if (!atlas) {
+        return SDL_InvalidParamError("atlas");
+    }
+    if (!atlas->renderer) {
+        return SDL_SetError("The texture atlas's renderer was destroyed");
+    }
+    for (page = atlas->pages; page; page = page->next) {
+        ++count;
+    }
+    return count;
+}
+
+SDL_Renderer *
+SDL_GetTextureAtlasRenderer(SDL_TextureAtlas * atlas)
+{
+    if (!atlas) {
+        SDL_InvalidParamError("atlas");
+        return NULL;
+    }
+    return atlas->renderer;
+}
+
+void
+SDL_DestroyTextureAtlas(SDL_TextureAtlas * atlas)
+{
+    SDL_Renderer *renderer;
+
+    if (!atlas) {
+        return;
+    }
+    renderer = atlas->renderer;
+    if (!renderer) {
+        /* Its images and pages went with the renderer */
+        SDL_free(atlas);
+        return;
+    }
+
+    while (atlas->textures) {
+        SDL_DestroyTexture(atlas->textures);
+    }
+    SDL_DestroyAtlasPages(atlas);
+
+    if (atlas->next) {
+        atlas->next->prev = atlas->prev;
+    }
+    if (atlas->prev) {
+        atlas->prev->next = atlas->next;
+    } else {
+        renderer->atlases = atlas->next;
+    }
+    SDL_free(atlas);
+}
+
+/* Atlas images are drawn from their page, which takes on their settings */
+static SDL_Texture *
+SelectAtlasPage(SDL_Texture * texture)
+{
+    SDL_Texture *page = texture->page->texture;
+
+    if (page->r != texture->r || page->g != texture->g || page->b != texture->b) {
+        SDL_SetTextureColorMod(page, texture->r, texture->g, texture->b);
+    }
+    if (page->a != texture->a) {
+        SDL_SetTextureAlphaMod(page, texture->a);
+    }
+    if (page->blendMode != texture->blendMode) {
+        SDL_SetTextureBlendMode(page, texture->blendMode);
+    }
+    if (page->distanceSpread != texture->distanceSpread ||
+        page->distanceThreshold != texture->distanceThreshold) {
+        SDL_SetTextureDistanceField(page, texture->distanceSpread,
+                                    texture->distanceThreshold);
+    }
+    return page;
+}
+
 int
 SDL_QueryTexture(SDL_Texture * texture, Uint32 * format, int *access,
                  int *w, int *h)
@@ -589,6 +962,9 @@ SDL_SetTextureColorMod(SDL_Texture * texture, Uint8 r, Uint8 g, Uint8 b)
     CHECK_TEXTURE_MAGIC(texture, -1);
 
     renderer = texture->renderer;
+    if (FlushTextureCommands(texture) < 0) {
+        return -1;
+    }
     if (r < 255 || g < 255 || b < 255) {
         texture->modMode |= SDL_TEXTUREMODULATE_COLOR;
     } else {
@@ -597,7 +973,9 @@ SDL_SetTextureColorMod(SDL_Texture * texture, Uint8 r, Uint8 g, Uint8 b)
     texture->r = r;
     texture->g = g;
     texture->b = b;
-    if (texture->native) {
+    if (texture->atlas) {
+        return 0;
+    } else if (texture->native) {
         return SDL_SetTextureColorMod(texture->native, r, g, b);
     } else if (renderer->SetTextureColorMod) {
         return renderer->SetTextureColorMod(renderer, texture);
@@ -632,13 +1010,18 @@ SDL_SetTextureAlphaMod(SDL_Texture * texture, Uint8 alpha)
     CHECK_TEXTURE_MAGIC(texture, -1);
 
     renderer = texture->renderer;
+    if (FlushTextureCommands(texture) < 0) {
+        return -1;
+    }
     if (alpha < 255) {
         texture->modMode |= SDL_TEXTUREMODULATE_ALPHA;
     } else {
         texture->modMode &= ~SDL_TEXTUREMODULATE_ALPHA;
     }
     texture->a = alpha;
-    if (texture->native) {
+    if (texture->atlas) {
+        return 0;
+    } else if (texture->native) {
         return SDL_SetTextureAlphaMod(texture->native, alpha);
     } else if (renderer->SetTextureAlphaMod) {
         return renderer->SetTextureAlphaMod(renderer, texture);
@@ -666,8 +1049,13 @@ SDL_SetTextureBlendMode(SDL_Texture * texture, SDL_BlendMode blendMode)
     CHECK_TEXTURE_MAGIC(texture, -1);
 
     renderer = texture->renderer;
+    if (FlushTextureCommands(texture) < 0) {
+        return -1;
+    }
     texture->blendMode = blendMode;
-    if (texture->native) {
+    if (texture->atlas) {
+        return 0;
+    } else if (texture->native) {
         return SDL_SetTextureBlendMode(texture->native, blendMode);
     } else if (renderer->SetTextureBlendMode) {
         return renderer->SetTextureBlendMode(renderer, texture);
@@ -687,16 +1075,57 @@ SDL_GetTextureBlendMode(SDL_Texture * texture, SDL_BlendMode *blendMode)
     return 0;
 }
 
-static int
-SDL_UpdateTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
-                     const void *pixels, int pitch)
+int
+SDL_SetTextureDistanceField(SDL_Texture * texture, int spread, Uint8 threshold)
 {
-    SDL_Texture *native = texture->native;
-    SDL_Rect full_rect;
+    SDL_Renderer *renderer;
 
-    if (SDL_SW_UpdateYUVTexture(texture->yuv, rect, pixels, pitch) < 0) {
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    renderer = texture->renderer;
+    if (spread < 0) {
+        return SDL_InvalidParamError("spread");
+    }
+    if (spread > 0 && !renderer->SetTextureDistanceField) {
+        return SDL_Unsupported();
+    }
+    if (FlushTextureCommands(texture) < 0) {
         return -1;
     }
+    texture->distanceSpread = spread;
+    texture->distanceThreshold = threshold;
+    if (texture->atlas) {
+        return 0;
+    } else if (texture->native) {
+        return SDL_SetTextureDistanceField(texture->native, spread, threshold);
+    } else if (renderer->SetTextureDistanceField) {
+        return renderer->SetTextureDistanceField(renderer, texture);
+    } else {
+        return 0;
+    }
+}
+
+int
+SDL_GetTextureDistanceField(SDL_Texture * texture, int *spread, Uint8 *threshold)
+{
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    if (spread) {
+        *spread = texture->distanceSpread;
+    }
+    if (threshold) {
+        *threshold = texture->distanceThreshold;
+    }
+    return 0;
+}
+
+/* Convert the YUV pixels of a texture into its native texture */
+static int
+SDL_ConvertTextureYUV(SDL_Texture * texture)
+{
+    SDL_Texture *native = texture->native;
+    const SDL_Rect *rect;
+    SDL_Rect full_rect;
 
     full_rect.x = 0;
     full_rect.y = 0;
@@ -733,6 +1162,29 @@ SDL_UpdateTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
     return 0;
 }
 
+static int
+SDL_UpdateTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
+                     const void *pixels, int pitch)
+{
+    if (SDL_SW_UpdateYUVTexture(texture->yuv, rect, pixels, pitch) < 0) {
+        return -1;
+    }
+    return SDL_ConvertTextureYUV(texture);
+}
+
+static int
+SDL_UpdateTextureYUVPlanar(SDL_Texture * texture, const SDL_Rect * rect,
+                           const Uint8 *Yplane, int Ypitch,
+                           const Uint8 *Uplane, int Upitch,
+                           const Uint8 *Vplane, int Vpitch)
+{
+    if (SDL_SW_UpdateYUVTexturePlanar(texture->yuv, rect, Yplane, Ypitch,
+                                      Uplane, Upitch, Vplane, Vpitch) < 0) {
+        return -1;
+    }
+    return SDL_ConvertTextureYUV(texture);
+}
+
 static int
 SDL_UpdateTextureNative(SDL_Texture * texture, const SDL_Rect * rect,
                         const void *pixels, int pitch)
@@ -794,6 +1246,14 @@ SDL_UpdateTexture(SDL_Texture * texture, const SDL_Rect * rect,
         rect = &full_rect;
     }
 
+    if (texture->atlas) {
+        return SDL_UpdateAtlasTexture(texture, rect, pixels, pitch);
+    }
+
+    if (FlushTextureCommands(texture) < 0) {
+        return -1;
+    }
+
     if (texture->yuv) {
         return SDL_UpdateTextureYUV(texture, rect, pixels, pitch);
     } else if (texture->native) {
@@ -804,6 +1264,66 @@ SDL_UpdateTexture(SDL_Texture * texture, const SDL_Rect * rect,
     }
 }
 
+int
+SDL_UpdateYUVTexture(SDL_Texture * texture, const SDL_Rect * rect,
+                     const Uint8 *Yplane, int Ypitch,
+                     const Uint8 *Uplane, int Upitch,
+                     const Uint8 *Vplane, int Vpitch)
+{
+    SDL_Renderer *renderer;
+    SDL_Rect full_rect;
+
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    if (!Yplane) {
+        return SDL_InvalidParamError("Yplane");
+    }
+    if (!Ypitch) {
+        return SDL_InvalidParamError("Ypitch");
+    }
+    if (!Uplane) {
+        return SDL_InvalidParamError("Uplane");
+    }
+    if (!Upitch) {
+        return SDL_InvalidParamError("Upitch");
+    }
+    if (!Vplane) {
+        return SDL_InvalidParamError("Vplane");
+    }
+    if (!Vpitch) {
+        return SDL_InvalidParamError("Vpitch");
+    }
+    if (texture->format != SDL_PIXELFORMAT_YV12 &&
+        texture->format != SDL_PIXELFORMAT_IYUV) {
+        return SDL_SetError("Texture format must be YV12 or IYUV");
+    }
+
+    if (!rect) {
+        full_rect.x = 0;
+        full_rect.y = 0;
+        full_rect.w = texture->w;
+        full_rect.h = texture->h;
+        rect = &full_rect;
+    }
+
+    if (FlushTextureCommands(texture) < 0) {
+        return -1;
+    }
+
+    if (texture->yuv) {
+        return SDL_UpdateTextureYUVPlanar(texture, rect, Yplane, Ypitch,
+                                          Uplane, Upitch, Vplane, Vpitch);
+    } else {
+        renderer = texture->renderer;
+        if (!renderer->UpdateTextureYUV) {
+            return SDL_Unsupported();
+        }
+        return renderer->UpdateTextureYUV(renderer, texture, rect,
+                                          Yplane, Ypitch, Uplane, Upitch,
+                                          Vplane, Vpitch);
+    }
+}
+
 static int
 SDL_LockTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
                    void **pixels, int *pitch)
@@ -815,7 +1335,6 @@ static int
 SDL_LockTextureNative(SDL_Texture * texture, const SDL_Rect * rect,
                       void **pixels, int *pitch)
 {
-    texture->locked_rect = *rect;
     *pixels = (void *) ((Uint8 *) texture->pixels +
                         rect->y * texture->pitch +
                         rect->x * SDL_BYTESPERPIXEL(texture->format));
@@ -844,6 +1363,11 @@ SDL_LockTexture(SDL_Texture * texture, const SDL_Rect * rect,
         rect = &full_rect;
     }
 
+    if (FlushTextureCommands(texture) < 0) {
+        return -1;
+    }
+    texture->locked_rect = *rect;
+
     if (texture->yuv) {
         return SDL_LockTextureYUV(texture, rect, pixels, pitch);
     } else if (texture->native) {
@@ -875,44 +1399,177 @@ SDL_UnlockTextureYUV(SDL_Texture * texture)
     SDL_UnlockTexture(native);
 }
 
+/* Convert the changed areas, which lie within bounds, to the native texture */
 static void
-SDL_UnlockTextureNative(SDL_Texture * texture)
+SDL_UnlockTextureNative(SDL_Texture * texture, const SDL_Rect * bounds,
+                        const SDL_Rect * rects, int count)
 {
     SDL_Texture *native = texture->native;
     void *native_pixels;
     int native_pitch;
-    const SDL_Rect *rect = &texture->locked_rect;
-    const void* pixels = (void *) ((Uint8 *) texture->pixels +
-                        rect->y * texture->pitch +
-                        rect->x * SDL_BYTESPERPIXEL(texture->format));
-    int pitch = texture->pitch;
+    int i;
+
+    if (SDL_LockTexture(native, bounds, &native_pixels, &native_pitch) < 0) {
+        return;
+    }
+    for (i = 0; i < count; ++i) {
+        const SDL_Rect *rect = &rects[i];
+        const void *pixels = (void *) ((Uint8 *) texture->pixels +
+                            rect->y * texture->pitch +
+                            rect->x * SDL_BYTESPERPIXEL(texture->format));
+        void *dst = (void *) ((Uint8 *) native_pixels +
+                    (rect->y - bounds->y) * native_pitch +
+                    (rect->x - bounds->x) * SDL_BYTESPERPIXEL(native->format));
+
+        SDL_ConvertPixels(rect->w, rect->h,
+                          texture->format, pixels, texture->pitch,
+                          native->format, dst, native_pitch);
+    }
+    SDL_UnlockTextureRects(native, rects, count);
+}
+
+void
+SDL_UnlockTexture(SDL_Texture * texture)
+{
+    SDL_Renderer *renderer;
+
+    CHECK_TEXTURE_MAGIC(texture, );
+
+    if (texture->access != SDL_TEXTUREACCESS_STREAMING) {
+        return;
+    }
+    FlushTextureCommands(texture);
+
+    if (texture->yuv) {
+        SDL_UnlockTextureYUV(texture);
+    } else if (texture->native) {
+        SDL_UnlockTextureNative(texture, &texture->locked_rect,
+                                &texture->locked_rect, 1);
+    } else {
+        renderer = texture->renderer;
+        renderer->UnlockTexture(renderer, texture);
+    }
+}
+
+void
+SDL_UnlockTextureRects(SDL_Texture * texture, const SDL_Rect * rects,
+                       int count)
+{
+    SDL_Renderer *renderer;
+    SDL_Rect *dirty;
+    SDL_Rect bounds;
+    int i, num_dirty, area;
+
+    CHECK_TEXTURE_MAGIC(texture, );
+
+    if (!rects) {
+        SDL_UnlockTexture(texture);
+        return;
+    }
+    if (texture->access != SDL_TEXTUREACCESS_STREAMING) {
+        return;
+    }
+
+    dirty = SDL_stack_alloc(SDL_Rect, SDL_max(count, 1));
+    if (!dirty) {
+        SDL_UnlockTexture(texture);
+        return;
+    }
+    num_dirty = 0;
+    area = 0;
+    for (i = 0; i < count; ++i) {
+        if (SDL_IntersectRect(&rects[i], &texture->locked_rect, &dirty[num_dirty])) {
+            if (num_dirty == 0) {
+                bounds = dirty[0];
+            } else {
+                SDL_UnionRect(&bounds, &dirty[num_dirty], &bounds);
+            }
+            area += dirty[num_dirty].w * dirty[num_dirty].h;
+            ++num_dirty;
+        }
+    }
+    if (num_dirty == 0 && (texture->yuv || texture->native)) {
+        /* Nothing is held until the pixels are converted, so there's
+           nothing left to release. */
+        SDL_stack_free(dirty);
+        return;
+    }
+
+    /* Each upload has a fixed cost, so if the pieces nearly fill their
+       bounding box it's cheaper to send the box in one go.
+     */
+    if (num_dirty > 1 && area >= (bounds.w * bounds.h) / 4 * 3) {
+        dirty[0] = bounds;
+        num_dirty = 1;
+    }
+
+    FlushTextureCommands(texture);
+
+    if (texture->yuv) {
+        /* The planes are converted as a whole */
+        SDL_UnlockTextureYUV(texture);
+    } else if (texture->native) {
+        SDL_UnlockTextureNative(texture, &bounds, dirty, num_dirty);
+    } else {
+        renderer = texture->renderer;
+        if (renderer->UnlockTextureRects) {
+            renderer->UnlockTextureRects(renderer, texture, dirty, num_dirty);
+        } else {
+            renderer->UnlockTexture(renderer, texture);
+        }
+    }
+    SDL_stack_free(dirty);
+}
+
+int
+SDL_SetTextureStreamingBuffers(SDL_Texture * texture, int count)
+{
+    SDL_TextureBuffers *buffers = NULL;
+
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    if (texture->access != SDL_TEXTUREACCESS_STREAMING) {
+        return SDL_SetError("SDL_SetTextureStreamingBuffers(): texture must be streaming");
+    }
+    if (count < 0 || count == 1) {
+        return SDL_InvalidParamError("count");
+    }
+    if (texture->buffers && SDL_IsTextureBufferLocked(texture->buffers)) {
+        return SDL_SetError("A frame buffer is locked");
+    }
+
+    if (count > 0) {
+        buffers = SDL_CreateTextureBuffers(texture->format,
+                                           texture->w, texture->h, count);
+        if (!buffers) {
+            return -1;
+        }
+    }
+    if (texture->buffers) {
+        SDL_DestroyTextureBuffers(texture->buffers);
+    }
+    texture->buffers = buffers;
+    return 0;
+}
 
-    if (SDL_LockTexture(native, rect, &native_pixels, &native_pitch) < 0) {
-        return;
+int
+SDL_LockTextureBuffer(SDL_Texture * texture, void **pixels, int *pitch)
+{
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    if (!texture->buffers) {
+        return SDL_SetError("SDL_LockTextureBuffer(): texture has no streaming buffers");
     }
-    SDL_ConvertPixels(rect->w, rect->h,
-                      texture->format, pixels, pitch,
-                      native->format, native_pixels, native_pitch);
-    SDL_UnlockTexture(native);
+    return SDL_AcquireTextureBuffer(texture->buffers, pixels, pitch);
 }
 
 void
-SDL_UnlockTexture(SDL_Texture * texture)
+SDL_UnlockTextureBuffer(SDL_Texture * texture)
 {
-    SDL_Renderer *renderer;
-
     CHECK_TEXTURE_MAGIC(texture, );
 
-    if (texture->access != SDL_TEXTUREACCESS_STREAMING) {
-        return;
-    }
-    if (texture->yuv) {
-        SDL_UnlockTextureYUV(texture);
-    } else if (texture->native) {
-        SDL_UnlockTextureNative(texture);
-    } else {
-        renderer = texture->renderer;
-        renderer->UnlockTexture(renderer, texture);
+    if (texture->buffers) {
+        SDL_QueueTextureBuffer(texture->buffers);
     }
 }
 
@@ -951,6 +1608,11 @@ SDL_SetRenderTarget(SDL_Renderer *renderer, SDL_Texture *texture)
         }
     }
 
+    /* The recorded draws go to the old target */
+    if (FlushRenderCommands(renderer) < 0) {
+        return -1;
+    }
+
     if (texture && !renderer->target) {
         /* Make a backup of the viewport */
         renderer->viewport_backup = renderer->viewport;
@@ -1083,6 +1745,10 @@ SDL_RenderSetViewport(SDL_Renderer * renderer, const SDL_Rect * rect)
 {
     CHECK_RENDERER_MAGIC(renderer, -1);
 
+    if (FlushRenderCommands(renderer) < 0) {
+        return -1;
+    }
+
     if (rect) {
         renderer->viewport.x = (int)SDL_floor(rect->x * renderer->scale.x);
         renderer->viewport.y = (int)SDL_floor(rect->y * renderer->scale.y);
@@ -1116,6 +1782,10 @@ SDL_RenderSetClipRect(SDL_Renderer * renderer, const SDL_Rect * rect)
 {
     CHECK_RENDERER_MAGIC(renderer, -1)
 
+    if (FlushRenderCommands(renderer) < 0) {
+        return -1;
+    }
+
     if (rect) {
         renderer->clip_rect.x = (int)SDL_floor(rect->x * renderer->scale.x);
         renderer->clip_rect.y = (int)SDL_floor(rect->y * renderer->scale.y);
@@ -1169,6 +1839,15 @@ SDL_SetRenderDrawColor(SDL_Renderer * renderer,
 {
     CHECK_RENDERER_MAGIC(renderer, -1);
 
+    /* Filled rectangles are drawn with the current color */
+    if (renderer->queue.type == SDL_RENDERCMD_FILLRECTS &&
+        (r != renderer->r || g != renderer->g ||
+         b != renderer->b || a != renderer->a)) {
+        if (FlushRenderCommands(renderer) < 0) {
+            return -1;
+        }
+    }
+
     renderer->r = r;
     renderer->g = g;
     renderer->b = b;
@@ -1202,6 +1881,13 @@ SDL_SetRenderDrawBlendMode(SDL_Renderer * renderer, SDL_BlendMode blendMode)
 {
     CHECK_RENDERER_MAGIC(renderer, -1);
 
+    if (renderer->queue.type == SDL_RENDERCMD_FILLRECTS &&
+        blendMode != renderer->blendMode) {
+        if (FlushRenderCommands(renderer) < 0) {
+            return -1;
+        }
+    }
+
     renderer->blendMode = blendMode;
     return 0;
 }
@@ -1224,6 +1910,9 @@ SDL_RenderClear(SDL_Renderer * renderer)
     if (renderer->hidden) {
         return 0;
     }
+    if (FlushRenderCommands(renderer) < 0) {
+        return -1;
+    }
     return renderer->RenderClear(renderer);
 }
 
@@ -1283,6 +1972,9 @@ SDL_RenderDrawPoints(SDL_Renderer * renderer,
     if (renderer->hidden) {
         return 0;
     }
+    if (FlushRenderCommands(renderer) < 0) {
+        return -1;
+    }
 
     if (renderer->scale.x != 1.0f || renderer->scale.y != 1.0f) {
         return RenderDrawPointsWithRects(renderer, points, count);
@@ -1392,6 +2084,9 @@ SDL_RenderDrawLines(SDL_Renderer * renderer,
     if (renderer->hidden) {
         return 0;
     }
+    if (FlushRenderCommands(renderer) < 0) {
+        return -1;
+    }
 
     if (renderer->scale.x != 1.0f || renderer->scale.y != 1.0f) {
         return RenderDrawLinesWithRects(renderer, points, count);
@@ -1518,7 +2213,8 @@ SDL_RenderFillRects(SDL_Renderer * renderer,
         frects[i].h = rects[i].h * renderer->scale.y;
     }
 
-    status = renderer->RenderFillRects(renderer, frects, count);
+    status = QueueRenderCommand(renderer, SDL_RENDERCMD_FILLRECTS, NULL,
+                                NULL, frects, count);
 
     SDL_stack_free(frects);
 
@@ -1540,6 +2236,12 @@ SDL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
         return SDL_SetError("Texture was not created with this renderer");
     }
 
+    /* Show the newest frame another thread finished */
+    if (texture->buffers &&
+        SDL_LatchTextureBuffer(texture, texture->buffers) < 0) {
+        return -1;
+    }
+
     real_srcrect.x = 0;
     real_srcrect.y = 0;
     real_srcrect.w = texture->w;
@@ -1560,6 +2262,11 @@ SDL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
         real_dstrect = *dstrect;
     }
 
+    if (texture->atlas) {
+        real_srcrect.x += texture->page_rect.x;
+        real_srcrect.y += texture->page_rect.y;
+        texture = SelectAtlasPage(texture);
+    }
     if (texture->native) {
         texture = texture->native;
     }
@@ -1574,7 +2281,8 @@ SDL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     frect.w = real_dstrect.w * renderer->scale.x;
     frect.h = real_dstrect.h * renderer->scale.y;
 
-    return renderer->RenderCopy(renderer, texture, &real_srcrect, &frect);
+    return QueueRenderCommand(renderer, SDL_RENDERCMD_COPY, texture,
+                              &real_srcrect, &frect, 1);
 }
 
 
@@ -1599,6 +2307,12 @@ SDL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
         return SDL_SetError("Renderer does not support RenderCopyEx");
     }
 
+    /* Show the newest frame another thread finished */
+    if (texture->buffers &&
+        SDL_LatchTextureBuffer(texture, texture->buffers) < 0) {
+        return -1;
+    }
+
     real_srcrect.x = 0;
     real_srcrect.y = 0;
     real_srcrect.w = texture->w;
@@ -1618,6 +2332,11 @@ SDL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
         real_dstrect.y = 0;
     }
 
+    if (texture->atlas) {
+        real_srcrect.x += texture->page_rect.x;
+        real_srcrect.y += texture->page_rect.y;
+        texture = SelectAtlasPage(texture);
+    }
     if (texture->native) {
         texture = texture->native;
     }
@@ -1636,9 +2355,169 @@ SDL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     fcenter.x = real_center.x * renderer->scale.x;
     fcenter.y = real_center.y * renderer->scale.y;
 
+    if (FlushRenderCommands(renderer) < 0) {
+        return -1;
+    }
+
     return renderer->RenderCopyEx(renderer, texture, &real_srcrect, &frect, angle, &fcenter, flip);
 }
 
+/* Draw the copies one at a time, for renderers without RenderCopyMany */
+static int
+RenderCopyManyFallback(SDL_Renderer * renderer, SDL_Texture * texture,
+                       const SDL_RenderCopyCommand * copies, int count)
+{
+    SDL_Texture *native = texture->native ? texture->native : texture;
+    Uint8 r, g, b, a;
+    int i, status = 0;
+
+    r = texture->r;
+    g = texture->g;
+    b = texture->b;
+    a = texture->a;
+
+    for (i = 0; i < count; ++i) {
+        const SDL_RenderCopyCommand *copy = &copies[i];
+
+        if (copy->r != texture->r || copy->g != texture->g || copy->b != texture->b) {
+            SDL_SetTextureColorMod(texture, copy->r, copy->g, copy->b);
+        }
+        if (copy->a != texture->a) {
+            SDL_SetTextureAlphaMod(texture, copy->a);
+        }
+        if (copy->angle != 0.0 || copy->flip != SDL_FLIP_NONE) {
+            if (renderer->RenderCopyEx(renderer, native, &copy->srcrect,
+                                       &copy->dstrect, copy->angle,
+                                       &copy->center, copy->flip) < 0) {
+                status = -1;
+            }
+        } else {
+            if (renderer->RenderCopy(renderer, native, &copy->srcrect,
+                                     &copy->dstrect) < 0) {
+                status = -1;
+            }
+        }
+    }
+
+    SDL_SetTextureColorMod(texture, r, g, b);
+    SDL_SetTextureAlphaMod(texture, a);
+    return status;
+}
+
+int
+SDL_RenderCopyMany(SDL_Renderer * renderer, SDL_Texture * texture,
+                   const SDL_RenderCopyData * copies, int count)
+{
+    SDL_RenderCommandQueue *queue = &renderer->queue;
+    SDL_RenderCopyCommand *commands;
+    SDL_Rect texture_rect;
+    SDL_Rect viewport;
+    int i, num_commands;
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    if (renderer != texture->renderer) {
+        return SDL_SetError("Texture was not created with this renderer");
+    }
+
+    /* Show the newest frame another thread finished */
+    if (texture->buffers &&
+        SDL_LatchTextureBuffer(texture, texture->buffers) < 0) {
+        return -1;
+    }
+    if (!copies) {
+        return SDL_InvalidParamError("copies");
+    }
+    if (count <= 0) {
+        return 0;
+    }
+
+    /* Don't draw while we're hidden */
+    if (renderer->hidden) {
+        return 0;
+    }
+
+    if (count > queue->max_copies) {
+        commands = (SDL_RenderCopyCommand *) SDL_realloc(queue->copies, count * sizeof(*commands));
+        if (!commands) {
+            return SDL_OutOfMemory();
+        }
+        queue->copies = commands;
+        queue->max_copies = count;
+    }
+    commands = queue->copies;
+
+    texture_rect.x = 0;
+    texture_rect.y = 0;
+    texture_rect.w = texture->w;
+    texture_rect.h = texture->h;
+
+    SDL_RenderGetViewport(renderer, &viewport);
+    viewport.x = 0;
+    viewport.y = 0;
+
+    /* Clip and scale everything up front, so the backend gets the copies
+       exactly as it would from SDL_RenderCopy() and SDL_RenderCopyEx().
+     */
+    num_commands = 0;
+    for (i = 0; i < count; ++i) {
+        const SDL_RenderCopyData *copy = &copies[i];
+        const SDL_bool transformed = (copy->angle != 0.0 || copy->flip != SDL_FLIP_NONE);
+        SDL_RenderCopyCommand *command = &commands[num_commands];
+
+        if (transformed && !renderer->RenderCopyEx) {
+            return SDL_SetError("Renderer does not support RenderCopyEx");
+        }
+
+        if (SDL_RectEmpty(&copy->srcrect)) {
+            command->srcrect = texture_rect;
+        } else if (!SDL_IntersectRect(&copy->srcrect, &texture_rect, &command->srcrect)) {
+            continue;
+        }
+
+        /* Rotated copies aren't culled, the same as SDL_RenderCopyEx() */
+        if (!transformed && !SDL_HasIntersection(&copy->dstrect, &viewport)) {
+            continue;
+        }
+
+        command->dstrect.x = copy->dstrect.x * renderer->scale.x;
+        command->dstrect.y = copy->dstrect.y * renderer->scale.y;
+        command->dstrect.w = copy->dstrect.w * renderer->scale.x;
+        command->dstrect.h = copy->dstrect.h * renderer->scale.y;
+        command->angle = copy->angle;
+        command->center.x = (copy->dstrect.w / 2) * renderer->scale.x;
+        command->center.y = (copy->dstrect.h / 2) * renderer->scale.y;
+        command->flip = copy->flip;
+        command->r = copy->r;
+        command->g = copy->g;
+        command->b = copy->b;
+        command->a = copy->a;
+        if (texture->atlas) {
+            command->srcrect.x += texture->page_rect.x;
+            command->srcrect.y += texture->page_rect.y;
+        }
+        ++num_commands;
+    }
+    if (num_commands == 0) {
+        return 0;
+    }
+
+    if (texture->atlas) {
+        texture = SelectAtlasPage(texture);
+    }
+
+    if (FlushRenderCommands(renderer) < 0) {
+        return -1;
+    }
+
+    if (renderer->RenderCopyMany) {
+        return renderer->RenderCopyMany(renderer, texture->native ? texture->native : texture,
+                                        commands, num_commands);
+    }
+    return RenderCopyManyFallback(renderer, texture, commands, num_commands);
+}
+
 int
 SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                      Uint32 format, void * pixels, int pitch)
@@ -1651,6 +2530,10 @@ SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
         return SDL_Unsupported();
     }
 
+    if (FlushRenderCommands(renderer) < 0) {
+        return -1;
+    }
+
     if (!format) {
         format = SDL_GetWindowPixelFormat(renderer->window);
     }
@@ -1676,6 +2559,210 @@ SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                                       format, pixels, pitch);
 }
 
+/* Move a read along as far as it can go, returning its status */
+static SDL_ReadbackStatus
+SDL_UpdateReadback(SDL_RenderReadback * readback, SDL_bool wait)
+{
+    SDL_Renderer *renderer = readback->renderer;
+
+    if (SDL_GetReadbackStatus(readback, SDL_FALSE) == SDL_READBACK_READING) {
+        int status = renderer->FinishReadback(renderer, readback, wait);
+
+        if (status == 0) {
+            return SDL_READBACK_READING;
+        }
+        if (status < 0 || SDL_QueueReadbackConversion(renderer, readback) < 0) {
+            readback->status = SDL_READBACK_FAILED;
+            return SDL_READBACK_FAILED;
+        }
+    }
+    return SDL_GetReadbackStatus(readback, wait);
+}
+
+SDL_RenderReadback *
+SDL_RenderReadPixelsAsync(SDL_Renderer * renderer, const SDL_Rect * rect,
+                          Uint32 format)
+{
+    SDL_RenderReadback *readback;
+    SDL_Rect real_rect;
+
+    CHECK_RENDERER_MAGIC(renderer, NULL);
+
+    if (!renderer->RenderReadPixels && !renderer->StartReadback) {
+        SDL_Unsupported();
+        return NULL;
+    }
+
+    if (!format) {
+        format = SDL_GetWindowPixelFormat(renderer->window);
+    }
+    if (SDL_ISPIXELFORMAT_FOURCC(format)) {
+        SDL_SetError("Can't read pixels in a FOURCC format");
+        return NULL;
+    }
+
+    real_rect.x = renderer->viewport.x;
+    real_rect.y = renderer->viewport.y;
+    real_rect.w = renderer->viewport.w;
+    real_rect.h = renderer->viewport.h;
+    if (rect && !SDL_IntersectRect(rect, &real_rect, &real_rect)) {
+        SDL_SetError("Rectangle is outside the viewport");
+        return NULL;
+    }
+
+    if (FlushRenderCommands(renderer) < 0) {
+        return NULL;
+    }
+
+    readback = (SDL_RenderReadback *) SDL_calloc(1, sizeof(*readback));
+    if (!readback) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    readback->renderer = renderer;
+    readback->rect = real_rect;
+    readback->format = format;
+    readback->frame = renderer->frame_count;
+    readback->status = SDL_READBACK_READING;
+
+    if (renderer->StartReadback) {
+        if (renderer->StartReadback(renderer, readback) < 0) {
+            SDL_free(readback->src_pixels);
+            SDL_free(readback);
+            return NULL;
+        }
+    } else {
+        /* Read the pixels now, as SDL_RenderReadPixels() does */
+        readback->pitch = real_rect.w * SDL_BYTESPERPIXEL(format);
+        readback->pixels = SDL_malloc(real_rect.h * readback->pitch);
+        if (!readback->pixels) {
+            SDL_free(readback);
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        if (renderer->RenderReadPixels(renderer, &real_rect, format,
+                                       readback->pixels, readback->pitch) < 0) {
+            SDL_free(readback->pixels);
+            SDL_free(readback);
+            return NULL;
+        }
+        readback->status = SDL_READBACK_DONE;
+    }
+
+    readback->next = renderer->readbacks;
+    renderer->readbacks = readback;
+
+    /* Start converting right away if the copy was quick */
+    SDL_UpdateReadback(readback, SDL_FALSE);
+    return readback;
+}
+
+int
+SDL_PollRenderReadback(SDL_RenderReadback * readback)
+{
+    if (!readback) {
+        return SDL_InvalidParamError("readback");
+    }
+
+    switch (SDL_UpdateReadback(readback, SDL_FALSE)) {
+    case SDL_READBACK_DONE:
+        return 1;
+    case SDL_READBACK_FAILED:
+        return SDL_SetError("Couldn't read the render target");
+    default:
+        return 0;
+    }
+}
+
+int
+SDL_WaitRenderReadback(SDL_RenderReadback * readback,
+                       const void **pixels, int *pitch)
+{
+    if (!readback) {
+        return SDL_InvalidParamError("readback");
+    }
+
+    if (SDL_UpdateReadback(readback, SDL_TRUE) != SDL_READBACK_DONE) {
+        return SDL_SetError("Couldn't read the render target");
+    }
+    if (pixels) {
+        *pixels = readback->pixels;
+    }
+    if (pitch) {
+        *pitch = readback->pitch;
+    }
+    return 0;
+}
+
+void
+SDL_FreeRenderReadback(SDL_RenderReadback * readback)
+{
+    SDL_Renderer *renderer;
+
+    if (!readback) {
+        return;
+    }
+
+    renderer = readback->renderer;
+    if (renderer) {
+        SDL_RenderReadback *prev = NULL, *curr;
+
+        /* The worker may still be using the pixels */
+        if (SDL_GetReadbackStatus(readback, SDL_TRUE) == SDL_READBACK_READING &&
+            renderer->DestroyReadback) {
+            renderer->DestroyReadback(renderer, readback);
+        }
+
+        for (curr = renderer->readbacks; curr; prev = curr, curr = curr->next) {
+            if (curr == readback) {
+                if (prev) {
+                    prev->next = curr->next;
+                } else {
+                    renderer->readbacks = curr->next;
+                }
+                break;
+            }
+        }
+    }
+
+    if (readback->pixels != readback->src_pixels) {
+        SDL_free(readback->pixels);
+    }
+    SDL_free(readback->src_pixels);
+    SDL_free(readback);
+}
+
+int
+SDL_RenderFlush(SDL_Renderer * renderer)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (FlushRenderCommands(renderer) < 0) {
+        return -1;
+    }
+    if (renderer->RenderFlush) {
+        return renderer->RenderFlush(renderer);
+    }
+    return 0;
+}
+
+int
+SDL_GetRenderStats(SDL_Renderer * renderer, SDL_RenderStats * current,
+                   SDL_RenderStats * previous)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    FlushRenderCommands(renderer);
+
+    if (current) {
+        *current = renderer->stats;
+    }
+    if (previous) {
+        *previous = renderer->last_stats;
+    }
+    return 0;
+}
+
 void
 SDL_RenderPresent(SDL_Renderer * renderer)
 {
@@ -1685,7 +2772,18 @@ SDL_RenderPresent(SDL_Renderer * renderer)
     if (renderer->hidden) {
         return;
     }
+    if (FlushRenderCommands(renderer) < 0) {
+        /* Show what was drawn, and leave the reason for the rest */
+        char reason[256];
+
+        SDL_strlcpy(reason, SDL_GetError(), sizeof(reason));
+        SDL_SetError("Couldn't draw the batched commands: %s", reason);
+    }
     renderer->RenderPresent(renderer);
+    ++renderer->frame_count;
+
+    renderer->last_stats = renderer->stats;
+    SDL_zero(renderer->stats);
 }
 
 void
@@ -1695,10 +2793,37 @@ SDL_DestroyTexture(SDL_Texture * texture)
 
     CHECK_TEXTURE_MAGIC(texture, );
 
+    if (texture->atlas) {
+        SDL_TextureAtlas *atlas = texture->atlas;
+
+        texture->magic = NULL;
+
+        if (texture->next) {
+            texture->next->prev = texture->prev;
+        }
+        if (texture->prev) {
+            texture->prev->next = texture->next;
+        } else {
+            atlas->textures = texture->next;
+        }
+
+        /* Anything still queued from the page has its pixels until the
+           space is packed again, which flushes before the upload.
+         */
+        SDL_FreeAtlasRect(atlas, texture->page, &texture->page_rect);
+        SDL_free(texture);
+        return;
+    }
+
     renderer = texture->renderer;
     if (texture == renderer->target) {
         SDL_SetRenderTarget(renderer, NULL);
     }
+    FlushTextureCommands(texture);
+
+    if (texture->buffers) {
+        SDL_DestroyTextureBuffers(texture->buffers);
+    }
 
     texture->magic = NULL;
 
@@ -1730,11 +2855,36 @@ SDL_DestroyRenderer(SDL_Renderer * renderer)
 
     SDL_DelEventWatch(SDL_RendererEventWatch, renderer);
 
+    /* Anything not yet drawn is discarded */
+    SDL_free(renderer->queue.srcrects);
+    SDL_free(renderer->queue.dstrects);
+    SDL_free(renderer->queue.copies);
+    SDL_zero(renderer->queue);
+
+    /* Atlases lose their images and pages, but belong to the application
+       until destroyed, like pending reads.
+     */
+    while (renderer->atlases) {
+        SDL_TextureAtlas *atlas = renderer->atlases;
+
+        while (atlas->textures) {
+            SDL_DestroyTexture(atlas->textures);
+        }
+        SDL_DestroyAtlasPages(atlas);
+        renderer->atlases = atlas->next;
+        atlas->renderer = NULL;
+        atlas->prev = NULL;
+        atlas->next = NULL;
+    }
+
     /* Free existing textures for this renderer */
     while (renderer->textures) {
         SDL_DestroyTexture(renderer->textures);
     }
 
+    /* Pending reads fail, but belong to the application until freed */
+    SDL_DetachRenderReadbacks(renderer);
+
     if (renderer->window) {
         SDL_SetWindowData(renderer->window, SDL_WINDOWRENDERDATA, NULL);
     }
@@ -1752,7 +2902,12 @@ int SDL_GL_BindTexture(SDL_Texture *texture, float *texw, float *texh)
 
     CHECK_TEXTURE_MAGIC(texture, -1);
     renderer = texture->renderer;
-    if (texture->native) {
+    if (renderer && FlushRenderCommands(renderer) < 0) {
+        return -1;
+    }
+    if (texture->atlas) {
+        return SDL_GL_BindTexture(texture->page->texture, texw, texh);
+    } else if (texture->native) {
         return SDL_GL_BindTexture(texture->native, texw, texh);
     } else if (renderer && renderer->GL_BindTexture) {
         return renderer->GL_BindTexture(renderer, texture, texw, texh);
@@ -1766,6 +2921,9 @@ int SDL_GL_UnbindTexture(SDL_Texture *texture)
     SDL_Renderer *renderer;
 
     CHECK_TEXTURE_MAGIC(texture, -1);
+    if (texture->atlas) {
+        return SDL_GL_UnbindTexture(texture->page->texture);
+    }
     renderer = texture->renderer;
     if (renderer && renderer->GL_UnbindTexture) {
         return renderer->GL_UnbindTexture(renderer, texture);
@@ -0,0 +1,73 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+/* The backend state cache shared by the renderers */
+
+#include "SDL_sysrender.h"
+
+SDL_bool
+SDL_ChangeRenderState(SDL_Renderer * renderer, SDL_RenderStateType type,
+                      size_t value)
+{
+    SDL_RenderStateCache *state = &renderer->state;
+    const Uint32 bit = (1 << type);
+
+    if ((state->known & bit) && state->values[type] == value) {
+        return SDL_FALSE;
+    }
+    state->known |= bit;
+    state->values[type] = value;
+
+    if (type == SDL_RENDERSTATE_TEXTURE) {
+        ++renderer->stats.texture_binds;
+    } else {
+        ++renderer->stats.state_changes;
+    }
+    return SDL_TRUE;
+}
+
+SDL_bool
+SDL_ChangeRenderStateData(SDL_Renderer * renderer, void *current,
+                          const void *value, size_t size)
+{
+    if (SDL_memcmp(current, value, size) == 0) {
+        return SDL_FALSE;
+    }
+    SDL_memcpy(current, value, size);
+
+    ++renderer->stats.state_changes;
+    return SDL_TRUE;
+}
+
+void
+SDL_InvalidateRenderState(SDL_Renderer * renderer, SDL_RenderStateType type)
+{
+    renderer->state.known &= ~(1 << type);
+}
+
+void
+SDL_ResetRenderState(SDL_Renderer * renderer)
+{
+    renderer->state.known = 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,63 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_renderstate_c_h
+#define _SDL_renderstate_c_h
+
+#include "SDL_render.h"
+
+/* The state a renderer backend last sent to the graphics API, so that
+   drawing only sends the state that changed.  What is sent is counted in
+   the renderer statistics.
+ */
+
+typedef enum
+{
+    SDL_RENDERSTATE_BLENDMODE,
+    SDL_RENDERSTATE_SHADER,     /**< The shader or program drawing with */
+    SDL_RENDERSTATE_TEXTURE,    /**< The texture bound for drawing */
+    SDL_RENDERSTATE_TEXTURE_UNIT, /**< The active texture unit */
+    SDL_RENDERSTATE_TEXTURING,  /**< Texturing or texture coordinates enabled */
+    SDL_RENDERSTATE_COLOR,      /**< The color of untextured vertices */
+    SDL_RENDERSTATE_MAX
+} SDL_RenderStateType;
+
+typedef struct
+{
+    Uint32 known;               /**< A bit for each state with a value below */
+    size_t values[SDL_RENDERSTATE_MAX];
+} SDL_RenderStateCache;
+
+/* Returns SDL_TRUE and records the value if it isn't the current state */
+SDL_bool SDL_ChangeRenderState(SDL_Renderer * renderer,
+                               SDL_RenderStateType type, size_t value);
+/* The same for state kept by the backend, like the uniforms of a program */
+SDL_bool SDL_ChangeRenderStateData(SDL_Renderer * renderer, void *current,
+                                   const void *value, size_t size);
+/* Forget a state that was changed outside of SDL_ChangeRenderState() */
+void SDL_InvalidateRenderState(SDL_Renderer * renderer,
+                               SDL_RenderStateType type);
+void SDL_ResetRenderState(SDL_Renderer * renderer);
+
+#endif /* _SDL_renderstate_c_h */
+
+/* vi: set ts=4 sw=4 expandtab: */
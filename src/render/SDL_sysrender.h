@@ -26,10 +26,14 @@
 #include "SDL_render.h"
 #include "SDL_events.h"
 #include "SDL_yuv_sw_c.h"
+#include "SDL_renderstate_c.h"
+#include "SDL_readback_c.h"
 
 /* The SDL 2D rendering system */
 
 typedef struct SDL_RenderDriver SDL_RenderDriver;
+typedef struct SDL_AtlasPage SDL_AtlasPage;
+typedef struct SDL_TextureBuffers SDL_TextureBuffers;
 
 typedef struct
 {
@@ -45,6 +49,37 @@ typedef struct
     float h;
 } SDL_FRect;
 
+/* A copy from SDL_RenderCopyMany(), clipped and scaled to the output */
+typedef struct
+{
+    SDL_Rect srcrect;
+    SDL_FRect dstrect;
+    double angle;
+    SDL_FPoint center;
+    SDL_RendererFlip flip;
+    Uint8 r, g, b, a;
+} SDL_RenderCopyCommand;
+
+/* Draws waiting to be sent to the renderer backend */
+typedef enum
+{
+    SDL_RENDERCMD_NONE,
+    SDL_RENDERCMD_FILLRECTS,
+    SDL_RENDERCMD_COPY
+} SDL_RenderCommandType;
+
+typedef struct
+{
+    SDL_RenderCommandType type;
+    SDL_Texture *texture;       /**< The source of SDL_RENDERCMD_COPY draws */
+    SDL_Rect *srcrects;
+    SDL_FRect *dstrects;
+    int count;
+    int max_count;
+    SDL_RenderCopyCommand *copies;  /**< Scratch space for SDL_RenderCopyMany() */
+    int max_copies;
+} SDL_RenderCommandQueue;
+
 /* Define the SDL texture structure */
 struct SDL_Texture
 {
@@ -56,6 +91,8 @@ struct SDL_Texture
     int modMode;                /**< The texture modulation mode */
     SDL_BlendMode blendMode;    /**< The texture blend mode */
     Uint8 r, g, b, a;           /**< Texture modulation values */
+    int distanceSpread;         /**< The distance field spread, 0 if none */
+    Uint8 distanceThreshold;    /**< The alpha on distance field edges */
 
     SDL_Renderer *renderer;
 
@@ -66,6 +103,14 @@ struct SDL_Texture
     int pitch;
     SDL_Rect locked_rect;
 
+    /* Support for images packed into a texture atlas */
+    SDL_TextureAtlas *atlas;
+    SDL_AtlasPage *page;
+    SDL_Rect page_rect;         /**< Where the image is within the page */
+
+    /* Frames filled by another thread, see SDL_LockTextureBuffer() */
+    SDL_TextureBuffers *buffers;
+
     void *driverdata;           /**< Driver specific texture representation */
 
     SDL_Texture *prev;
@@ -86,12 +131,21 @@ struct SDL_Renderer
                                SDL_Texture * texture);
     int (*SetTextureBlendMode) (SDL_Renderer * renderer,
                                 SDL_Texture * texture);
+    int (*SetTextureDistanceField) (SDL_Renderer * renderer,
+                                    SDL_Texture * texture);
     int (*UpdateTexture) (SDL_Renderer * renderer, SDL_Texture * texture,
                           const SDL_Rect * rect, const void *pixels,
                           int pitch);
+    int (*UpdateTextureYUV) (SDL_Renderer * renderer, SDL_Texture * texture,
+                            const SDL_Rect * rect,
+                            const Uint8 *Yplane, int Ypitch,
+                            const Uint8 *Uplane, int Upitch,
+                            const Uint8 *Vplane, int Vpitch);
     int (*LockTexture) (SDL_Renderer * renderer, SDL_Texture * texture,
                         const SDL_Rect * rect, void **pixels, int *pitch);
     void (*UnlockTexture) (SDL_Renderer * renderer, SDL_Texture * texture);
+    void (*UnlockTextureRects) (SDL_Renderer * renderer, SDL_Texture * texture,
+                                const SDL_Rect * rects, int count);
     int (*SetRenderTarget) (SDL_Renderer * renderer, SDL_Texture * texture);
     int (*UpdateViewport) (SDL_Renderer * renderer);
     int (*UpdateClipRect) (SDL_Renderer * renderer);
@@ -104,11 +158,22 @@ struct SDL_Renderer
                             int count);
     int (*RenderCopy) (SDL_Renderer * renderer, SDL_Texture * texture,
                        const SDL_Rect * srcrect, const SDL_FRect * dstrect);
+    int (*RenderCopies) (SDL_Renderer * renderer, SDL_Texture * texture,
+                         const SDL_Rect * srcrects, const SDL_FRect * dstrects,
+                         int count);
     int (*RenderCopyEx) (SDL_Renderer * renderer, SDL_Texture * texture,
                        const SDL_Rect * srcquad, const SDL_FRect * dstrect,
                        const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip);
+    int (*RenderCopyMany) (SDL_Renderer * renderer, SDL_Texture * texture,
+                           const SDL_RenderCopyCommand * copies, int count);
     int (*RenderReadPixels) (SDL_Renderer * renderer, const SDL_Rect * rect,
                              Uint32 format, void * pixels, int pitch);
+    int (*StartReadback) (SDL_Renderer * renderer, SDL_RenderReadback * readback);
+    /* Returns 1 when the source pixels are filled in, 0 if not yet */
+    int (*FinishReadback) (SDL_Renderer * renderer, SDL_RenderReadback * readback,
+                           SDL_bool wait);
+    void (*DestroyReadback) (SDL_Renderer * renderer, SDL_RenderReadback * readback);
+    int (*RenderFlush) (SDL_Renderer * renderer);
     void (*RenderPresent) (SDL_Renderer * renderer);
     void (*DestroyTexture) (SDL_Renderer * renderer, SDL_Texture * texture);
 
@@ -146,9 +211,28 @@ struct SDL_Renderer
     SDL_Texture *textures;
     SDL_Texture *target;
 
+    /* The list of texture atlases */
+    SDL_TextureAtlas *atlases;
+
     Uint8 r, g, b, a;                   /**< Color for drawing operations values */
     SDL_BlendMode blendMode;            /**< The drawing blend mode */
 
+    /* Draws are recorded here and merged before going to the backend */
+    SDL_bool batching;
+    SDL_RenderCommandQueue queue;
+
+    /* The backend state last sent, and the work sent this frame and the last */
+    SDL_RenderStateCache state;
+    SDL_RenderStats stats;
+    SDL_RenderStats last_stats;
+
+    /* The number of frames presented, to age asynchronous reads */
+    Uint32 frame_count;
+
+    /* Reads from SDL_RenderReadPixelsAsync() and the thread converting them */
+    SDL_RenderReadback *readbacks;
+    SDL_ReadbackWorker *readback_worker;
+
     void *driverdata;
 };
 
@@ -0,0 +1,200 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+/* Frame buffer rings for streaming textures written from another thread */
+
+#include "SDL_sysrender.h"
+#include "SDL_texbuffers_c.h"
+
+SDL_TextureBuffers *
+SDL_CreateTextureBuffers(Uint32 format, int w, int h, int count)
+{
+    SDL_TextureBuffers *buffers;
+    size_t size;
+    int i;
+
+    buffers = (SDL_TextureBuffers *) SDL_calloc(1, sizeof(*buffers));
+    if (!buffers) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    buffers->filling = -1;
+    buffers->count = count;
+
+    /* The frames are laid out the way SDL_UpdateTexture() takes them */
+    buffers->pitch = w * SDL_BYTESPERPIXEL(format);
+    size = (size_t) buffers->pitch * h;
+    if (format == SDL_PIXELFORMAT_YV12 || format == SDL_PIXELFORMAT_IYUV) {
+        /* The U and V planes follow at half resolution, rounded up */
+        size += 2 * (size_t) ((w + 1) / 2) * ((h + 1) / 2);
+    }
+
+    buffers->lock = SDL_CreateMutex();
+    buffers->buffers = (SDL_TextureBuffer *) SDL_calloc(count, sizeof(*buffers->buffers));
+    if (!buffers->lock) {
+        SDL_DestroyTextureBuffers(buffers);
+        return NULL;
+    }
+    if (!buffers->buffers) {
+        SDL_DestroyTextureBuffers(buffers);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    for (i = 0; i < count; ++i) {
+        buffers->buffers[i].pixels = SDL_calloc(1, size);
+        if (!buffers->buffers[i].pixels) {
+            SDL_DestroyTextureBuffers(buffers);
+            SDL_OutOfMemory();
+            return NULL;
+        }
+    }
+    return buffers;
+}
+
+int
+SDL_AcquireTextureBuffer(SDL_TextureBuffers * buffers, void **pixels,
+                         int *pitch)
+{
+    SDL_TextureBuffer *buffer = NULL;
+    int i;
+
+    SDL_LockMutex(buffers->lock);
+    if (buffers->filling >= 0) {
+        SDL_UnlockMutex(buffers->lock);
+        return SDL_SetError("A frame buffer is already locked");
+    }
+
+    for (i = 0; i < buffers->count; ++i) {
+        if (buffers->buffers[i].state == SDL_TEXTUREBUFFER_FREE) {
+            buffer = &buffers->buffers[i];
+            break;
+        }
+    }
+    if (!buffer) {
+        /* The renderer is behind, drop the oldest frame it hasn't drawn.
+           At most one buffer is uploading, so with two or more there is
+           always a finished frame here.
+         */
+        for (i = 0; i < buffers->count; ++i) {
+            if (buffers->buffers[i].state == SDL_TEXTUREBUFFER_READY &&
+                (!buffer || (Sint32)(buffers->buffers[i].serial - buffer->serial) < 0)) {
+                buffer = &buffers->buffers[i];
+            }
+        }
+        SDL_AtomicAdd(&buffers->ready, -1);
+    }
+
+    buffer->state = SDL_TEXTUREBUFFER_FILLING;
+    buffers->filling = (int) (buffer - buffers->buffers);
+    SDL_UnlockMutex(buffers->lock);
+
+    *pixels = buffer->pixels;
+    *pitch = buffers->pitch;
+    return 0;
+}
+
+void
+SDL_QueueTextureBuffer(SDL_TextureBuffers * buffers)
+{
+    SDL_TextureBuffer *buffer;
+
+    SDL_LockMutex(buffers->lock);
+    if (buffers->filling >= 0) {
+        buffer = &buffers->buffers[buffers->filling];
+        buffer->state = SDL_TEXTUREBUFFER_READY;
+        buffer->serial = ++buffers->serial;
+        buffers->filling = -1;
+        SDL_AtomicAdd(&buffers->ready, 1);
+    }
+    SDL_UnlockMutex(buffers->lock);
+}
+
+SDL_bool
+SDL_IsTextureBufferLocked(SDL_TextureBuffers * buffers)
+{
+    SDL_bool locked;
+
+    SDL_LockMutex(buffers->lock);
+    locked = (buffers->filling >= 0);
+    SDL_UnlockMutex(buffers->lock);
+    return locked;
+}
+
+int
+SDL_LatchTextureBuffer(SDL_Texture * texture, SDL_TextureBuffers * buffers)
+{
+    SDL_TextureBuffer *buffer = NULL;
+    int i, status;
+
+    if (SDL_AtomicGet(&buffers->ready) == 0) {
+        return 0;
+    }
+
+    /* Take the newest frame, the older ones will never be shown */
+    SDL_LockMutex(buffers->lock);
+    for (i = 0; i < buffers->count; ++i) {
+        if (buffers->buffers[i].state == SDL_TEXTUREBUFFER_READY &&
+            (!buffer || (Sint32)(buffers->buffers[i].serial - buffer->serial) > 0)) {
+            buffer = &buffers->buffers[i];
+        }
+    }
+    for (i = 0; i < buffers->count; ++i) {
+        if (buffers->buffers[i].state == SDL_TEXTUREBUFFER_READY) {
+            buffers->buffers[i].state = SDL_TEXTUREBUFFER_FREE;
+        }
+    }
+    SDL_AtomicSet(&buffers->ready, 0);
+    if (!buffer) {
+        SDL_UnlockMutex(buffers->lock);
+        return 0;
+    }
+    buffer->state = SDL_TEXTUREBUFFER_UPLOADING;
+    SDL_UnlockMutex(buffers->lock);
+
+    /* The writer can fill the other buffers while this one is uploaded */
+    status = SDL_UpdateTexture(texture, NULL, buffer->pixels, buffers->pitch);
+
+    SDL_LockMutex(buffers->lock);
+    buffer->state = SDL_TEXTUREBUFFER_FREE;
+    SDL_UnlockMutex(buffers->lock);
+
+    return status;
+}
+
+void
+SDL_DestroyTextureBuffers(SDL_TextureBuffers * buffers)
+{
+    int i;
+
+    if (buffers->buffers) {
+        for (i = 0; i < buffers->count; ++i) {
+            SDL_free(buffers->buffers[i].pixels);
+        }
+        SDL_free(buffers->buffers);
+    }
+    if (buffers->lock) {
+        SDL_DestroyMutex(buffers->lock);
+    }
+    SDL_free(buffers);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,69 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+#include "SDL_atomic.h"
+#include "SDL_mutex.h"
+#include "SDL_render.h"
+
+/* A ring of CPU frame buffers for a streaming texture.  A writer thread fills
+   one while the renderer uploads the newest finished one.
+ */
+
+typedef enum
+{
+    SDL_TEXTUREBUFFER_FREE,
+    SDL_TEXTUREBUFFER_FILLING,  /**< Locked by the writer */
+    SDL_TEXTUREBUFFER_READY,    /**< Finished, waiting to be uploaded */
+    SDL_TEXTUREBUFFER_UPLOADING
+} SDL_TextureBufferState;
+
+typedef struct
+{
+    void *pixels;
+    SDL_TextureBufferState state;
+    Uint32 serial;              /**< When it was finished, to find the newest */
+} SDL_TextureBuffer;
+
+struct SDL_TextureBuffers
+{
+    SDL_mutex *lock;
+    SDL_TextureBuffer *buffers;
+    int count;
+    int pitch;
+    int filling;                /**< The buffer locked by the writer, or -1 */
+    Uint32 serial;
+    SDL_atomic_t ready;         /**< Checked without the lock before drawing */
+};
+
+typedef struct SDL_TextureBuffers SDL_TextureBuffers;
+
+SDL_TextureBuffers *SDL_CreateTextureBuffers(Uint32 format, int w, int h,
+                                             int count);
+int SDL_AcquireTextureBuffer(SDL_TextureBuffers * buffers,
+                             void **pixels, int *pitch);
+void SDL_QueueTextureBuffer(SDL_TextureBuffers * buffers);
+SDL_bool SDL_IsTextureBufferLocked(SDL_TextureBuffers * buffers);
+/* Upload the newest finished frame, if there is one */
+int SDL_LatchTextureBuffer(SDL_Texture * texture, SDL_TextureBuffers * buffers);
+void SDL_DestroyTextureBuffers(SDL_TextureBuffers * buffers);
+
+/* vi: set ts=4 sw=4 expandtab: */
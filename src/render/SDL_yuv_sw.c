@@ -84,12 +84,41 @@
 
 #include "SDL_assert.h"
 #include "SDL_video.h"
+#include "SDL_hints.h"
 #include "SDL_cpuinfo.h"
 #include "SDL_yuv_sw_c.h"
 
 
 /* The colorspace conversion functions */
 
+/*
+ * The conversion tables are laid out in colortab as:
+ *   0 * 256 - Cr to red,   1 * 256 - Cr to green,
+ *   2 * 256 - Cb to green, 3 * 256 - Cb to blue,
+ *   4 * 256 - Y to luminance, with the range of the conversion mode applied,
+ * followed by the parameters of the conversion in 13 bit fixed point, and
+ * the layout of the destination pixels, for the SIMD conversion functions.
+ */
+#define YUV_PARAMS_OFFSET   (5 * 256)
+#define YUV_FIXED_BITS      13
+
+#define YUV_ROUND(x)    ((int) SDL_floor((x) + 0.5))
+
+enum
+{
+    YUV_PARAM_Y_OFFSET,
+    YUV_PARAM_Y_SCALE,
+    YUV_PARAM_CR_R,
+    YUV_PARAM_CR_G,
+    YUV_PARAM_CB_G,
+    YUV_PARAM_CB_B,
+    YUV_PARAM_R_SHIFT,
+    YUV_PARAM_G_SHIFT,
+    YUV_PARAM_B_SHIFT,
+    YUV_PARAM_AMASK,
+    YUV_PARAM_MAX
+};
+
 #if (__GNUC__ > 2) && defined(__i386__) && __OPTIMIZE__ && SDL_ASSEMBLY_ROUTINES
 extern void Color565DitherYV12MMX1X(int *colortab, Uint32 * rgb_2_pix,
                                     unsigned char *lum, unsigned char *cr,
@@ -135,12 +164,12 @@ Color16DitherYV12Mod1X(int *colortab, Uint32 * rgb_2_pix,
             ++cr;
             ++cb;
 
-            L = *lum++;
+            L = colortab[*lum++ + 4 * 256];
             *row1++ = (unsigned short) (rgb_2_pix[L + cr_r] |
                                         rgb_2_pix[L + crb_g] |
                                         rgb_2_pix[L + cb_b]);
 
-            L = *lum++;
+            L = colortab[*lum++ + 4 * 256];
             *row1++ = (unsigned short) (rgb_2_pix[L + cr_r] |
                                         rgb_2_pix[L + crb_g] |
                                         rgb_2_pix[L + cb_b]);
@@ -148,12 +177,12 @@ Color16DitherYV12Mod1X(int *colortab, Uint32 * rgb_2_pix,
 
             /* Now, do second row.  */
 
-            L = *lum2++;
+            L = colortab[*lum2++ + 4 * 256];
             *row2++ = (unsigned short) (rgb_2_pix[L + cr_r] |
                                         rgb_2_pix[L + crb_g] |
                                         rgb_2_pix[L + cb_b]);
 
-            L = *lum2++;
+            L = colortab[*lum2++ + 4 * 256];
             *row2++ = (unsigned short) (rgb_2_pix[L + cr_r] |
                                         rgb_2_pix[L + crb_g] |
                                         rgb_2_pix[L + cb_b]);
@@ -207,14 +236,14 @@ Color24DitherYV12Mod1X(int *colortab, Uint32 * rgb_2_pix,
             ++cr;
             ++cb;
 
-            L = *lum++;
+            L = colortab[*lum++ + 4 * 256];
             value = (rgb_2_pix[L + cr_r] |
                      rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
             *row1++ = (value) & 0xFF;
             *row1++ = (value >> 8) & 0xFF;
             *row1++ = (value >> 16) & 0xFF;
 
-            L = *lum++;
+            L = colortab[*lum++ + 4 * 256];
             value = (rgb_2_pix[L + cr_r] |
                      rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
             *row1++ = (value) & 0xFF;
@@ -224,14 +253,14 @@ Color24DitherYV12Mod1X(int *colortab, Uint32 * rgb_2_pix,
 
             /* Now, do second row.  */
 
-            L = *lum2++;
+            L = colortab[*lum2++ + 4 * 256];
             value = (rgb_2_pix[L + cr_r] |
                      rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
             *row2++ = (value) & 0xFF;
             *row2++ = (value >> 8) & 0xFF;
             *row2++ = (value >> 16) & 0xFF;
 
-            L = *lum2++;
+            L = colortab[*lum2++ + 4 * 256];
             value = (rgb_2_pix[L + cr_r] |
                      rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
             *row2++ = (value) & 0xFF;
@@ -285,22 +314,22 @@ Color32DitherYV12Mod1X(int *colortab, Uint32 * rgb_2_pix,
             ++cr;
             ++cb;
 
-            L = *lum++;
+            L = colortab[*lum++ + 4 * 256];
             *row1++ = (rgb_2_pix[L + cr_r] |
                        rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
 
-            L = *lum++;
+            L = colortab[*lum++ + 4 * 256];
             *row1++ = (rgb_2_pix[L + cr_r] |
                        rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
 
 
             /* Now, do second row.  */
 
-            L = *lum2++;
+            L = colortab[*lum2++ + 4 * 256];
             *row2++ = (rgb_2_pix[L + cr_r] |
                        rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
 
-            L = *lum2++;
+            L = colortab[*lum2++ + 4 * 256];
             *row2++ = (rgb_2_pix[L + cr_r] |
                        rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
         }
@@ -355,13 +384,13 @@ Color16DitherYV12Mod2X(int *colortab, Uint32 * rgb_2_pix,
             ++cr;
             ++cb;
 
-            L = *lum++;
+            L = colortab[*lum++ + 4 * 256];
             row1[0] = row1[next_row] = (rgb_2_pix[L + cr_r] |
                                         rgb_2_pix[L + crb_g] |
                                         rgb_2_pix[L + cb_b]);
             row1++;
 
-            L = *lum++;
+            L = colortab[*lum++ + 4 * 256];
             row1[0] = row1[next_row] = (rgb_2_pix[L + cr_r] |
                                         rgb_2_pix[L + crb_g] |
                                         rgb_2_pix[L + cb_b]);
@@ -370,13 +399,13 @@ Color16DitherYV12Mod2X(int *colortab, Uint32 * rgb_2_pix,
 
             /* Now, do second row. */
 
-            L = *lum2++;
+            L = colortab[*lum2++ + 4 * 256];
             row2[0] = row2[next_row] = (rgb_2_pix[L + cr_r] |
                                         rgb_2_pix[L + crb_g] |
                                         rgb_2_pix[L + cb_b]);
             row2++;
 
-            L = *lum2++;
+            L = colortab[*lum2++ + 4 * 256];
             row2[0] = row2[next_row] = (rgb_2_pix[L + cr_r] |
                                         rgb_2_pix[L + crb_g] |
                                         rgb_2_pix[L + cb_b]);
@@ -429,7 +458,7 @@ Color24DitherYV12Mod2X(int *colortab, Uint32 * rgb_2_pix,
             ++cr;
             ++cb;
 
-            L = *lum++;
+            L = colortab[*lum++ + 4 * 256];
             value = (rgb_2_pix[L + cr_r] |
                      rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
             row1[0 + 0] = row1[3 + 0] = row1[next_row + 0] =
@@ -440,7 +469,7 @@ Color24DitherYV12Mod2X(int *colortab, Uint32 * rgb_2_pix,
                 row1[next_row + 3 + 2] = (value >> 16) & 0xFF;
             row1 += 2 * 3;
 
-            L = *lum++;
+            L = colortab[*lum++ + 4 * 256];
             value = (rgb_2_pix[L + cr_r] |
                      rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
             row1[0 + 0] = row1[3 + 0] = row1[next_row + 0] =
@@ -454,7 +483,7 @@ Color24DitherYV12Mod2X(int *colortab, Uint32 * rgb_2_pix,
 
             /* Now, do second row. */
 
-            L = *lum2++;
+            L = colortab[*lum2++ + 4 * 256];
             value = (rgb_2_pix[L + cr_r] |
                      rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
             row2[0 + 0] = row2[3 + 0] = row2[next_row + 0] =
@@ -465,7 +494,7 @@ Color24DitherYV12Mod2X(int *colortab, Uint32 * rgb_2_pix,
                 row2[next_row + 3 + 2] = (value >> 16) & 0xFF;
             row2 += 2 * 3;
 
-            L = *lum2++;
+            L = colortab[*lum2++ + 4 * 256];
             value = (rgb_2_pix[L + cr_r] |
                      rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
             row2[0 + 0] = row2[3 + 0] = row2[next_row + 0] =
@@ -522,13 +551,13 @@ Color32DitherYV12Mod2X(int *colortab, Uint32 * rgb_2_pix,
             ++cr;
             ++cb;
 
-            L = *lum++;
+            L = colortab[*lum++ + 4 * 256];
             row1[0] = row1[1] = row1[next_row] = row1[next_row + 1] =
                 (rgb_2_pix[L + cr_r] |
                  rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
             row1 += 2;
 
-            L = *lum++;
+            L = colortab[*lum++ + 4 * 256];
             row1[0] = row1[1] = row1[next_row] = row1[next_row + 1] =
                 (rgb_2_pix[L + cr_r] |
                  rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
@@ -537,13 +566,13 @@ Color32DitherYV12Mod2X(int *colortab, Uint32 * rgb_2_pix,
 
             /* Now, do second row. */
 
-            L = *lum2++;
+            L = colortab[*lum2++ + 4 * 256];
             row2[0] = row2[1] = row2[next_row] = row2[next_row + 1] =
                 (rgb_2_pix[L + cr_r] |
                  rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
             row2 += 2;
 
-            L = *lum2++;
+            L = colortab[*lum2++ + 4 * 256];
             row2[0] = row2[1] = row2[next_row] = row2[next_row + 1] =
                 (rgb_2_pix[L + cr_r] |
                  rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
@@ -590,13 +619,13 @@ Color16DitherYUY2Mod1X(int *colortab, Uint32 * rgb_2_pix,
             cr += 4;
             cb += 4;
 
-            L = *lum;
+            L = colortab[*lum + 4 * 256];
             lum += 2;
             *row++ = (unsigned short) (rgb_2_pix[L + cr_r] |
                                        rgb_2_pix[L + crb_g] |
                                        rgb_2_pix[L + cb_b]);
 
-            L = *lum;
+            L = colortab[*lum + 4 * 256];
             lum += 2;
             *row++ = (unsigned short) (rgb_2_pix[L + cr_r] |
                                        rgb_2_pix[L + crb_g] |
@@ -637,7 +666,7 @@ Color24DitherYUY2Mod1X(int *colortab, Uint32 * rgb_2_pix,
             cr += 4;
             cb += 4;
 
-            L = *lum;
+            L = colortab[*lum + 4 * 256];
             lum += 2;
             value = (rgb_2_pix[L + cr_r] |
                      rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
@@ -645,7 +674,7 @@ Color24DitherYUY2Mod1X(int *colortab, Uint32 * rgb_2_pix,
             *row++ = (value >> 8) & 0xFF;
             *row++ = (value >> 16) & 0xFF;
 
-            L = *lum;
+            L = colortab[*lum + 4 * 256];
             lum += 2;
             value = (rgb_2_pix[L + cr_r] |
                      rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
@@ -685,12 +714,12 @@ Color32DitherYUY2Mod1X(int *colortab, Uint32 * rgb_2_pix,
             cr += 4;
             cb += 4;
 
-            L = *lum;
+            L = colortab[*lum + 4 * 256];
             lum += 2;
             *row++ = (rgb_2_pix[L + cr_r] |
                       rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
 
-            L = *lum;
+            L = colortab[*lum + 4 * 256];
             lum += 2;
             *row++ = (rgb_2_pix[L + cr_r] |
                       rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
@@ -733,14 +762,14 @@ Color16DitherYUY2Mod2X(int *colortab, Uint32 * rgb_2_pix,
             cr += 4;
             cb += 4;
 
-            L = *lum;
+            L = colortab[*lum + 4 * 256];
             lum += 2;
             row[0] = row[next_row] = (rgb_2_pix[L + cr_r] |
                                       rgb_2_pix[L + crb_g] |
                                       rgb_2_pix[L + cb_b]);
             row++;
 
-            L = *lum;
+            L = colortab[*lum + 4 * 256];
             lum += 2;
             row[0] = row[next_row] = (rgb_2_pix[L + cr_r] |
                                       rgb_2_pix[L + crb_g] |
@@ -779,7 +808,7 @@ Color24DitherYUY2Mod2X(int *colortab, Uint32 * rgb_2_pix,
             cr += 4;
             cb += 4;
 
-            L = *lum;
+            L = colortab[*lum + 4 * 256];
             lum += 2;
             value = (rgb_2_pix[L + cr_r] |
                      rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
@@ -791,7 +820,7 @@ Color24DitherYUY2Mod2X(int *colortab, Uint32 * rgb_2_pix,
                 row[next_row + 3 + 2] = (value >> 16) & 0xFF;
             row += 2 * 3;
 
-            L = *lum;
+            L = colortab[*lum + 4 * 256];
             lum += 2;
             value = (rgb_2_pix[L + cr_r] |
                      rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
@@ -835,14 +864,14 @@ Color32DitherYUY2Mod2X(int *colortab, Uint32 * rgb_2_pix,
             cr += 4;
             cb += 4;
 
-            L = *lum;
+            L = colortab[*lum + 4 * 256];
             lum += 2;
             row[0] = row[1] = row[next_row] = row[next_row + 1] =
                 (rgb_2_pix[L + cr_r] |
                  rgb_2_pix[L + crb_g] | rgb_2_pix[L + cb_b]);
             row += 2;
 
-            L = *lum;
+            L = colortab[*lum + 4 * 256];
             lum += 2;
             row[0] = row[1] = row[next_row] = row[next_row + 1] =
                 (rgb_2_pix[L + cr_r] |
@@ -856,6 +885,577 @@ Color32DitherYUY2Mod2X(int *colortab, Uint32 * rgb_2_pix,
     }
 }
 
+/* The SIMD functions convert 16 pixels at a time, 32 with AVX2, in 16 bit
+   fixed point, and the pixels left at the end of a row one at a time with
+   the same arithmetic.  The SSE2 functions are selected at runtime, the
+   AVX2 ones are only built when the compiler targets AVX2 (there's no
+   runtime check for it beyond AVX), and the NEON ones are used whenever
+   the compiler targets NEON.
+ */
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON)) && (SDL_BYTEORDER == SDL_LIL_ENDIAN)
+#include <arm_neon.h>
+#define SDL_YUV_NEON 1
+#endif
+
+#if defined(__SSE2__) || defined(SDL_YUV_NEON)
+#define SDL_YUV_SIMD 1
+#endif
+
+#ifdef SDL_YUV_SIMD
+/* The high word of a signed 16 bit product, as _mm_mulhi_epi16() gives */
+#define YUV_SIMD_MULHI(a, b)    ((int) (Sint16) (a) * (Sint16) (b) >> 16)
+
+/* Convert the pixels left over at the end of a row, with the same 16 bit
+   arithmetic as the vector code so the whole row rounds alike.
+ */
+static __inline__ Uint32
+YUV_SIMD_ConvertPixel(const int *params, int Y, int Cb, int Cr)
+{
+    int L, R, G, B;
+
+    L = YUV_SIMD_MULHI((Y - params[YUV_PARAM_Y_OFFSET]) << 7,
+                       params[YUV_PARAM_Y_SCALE] * 2) + (1 << 4);
+    Cb = (Cb - 128) << 8;
+    Cr = (Cr - 128) << 8;
+    R = (Sint16) (L + YUV_SIMD_MULHI(Cr, params[YUV_PARAM_CR_R])) >> 5;
+    G = (Sint16) (L + (Sint16) (YUV_SIMD_MULHI(Cr, params[YUV_PARAM_CR_G]) +
+                                YUV_SIMD_MULHI(Cb, params[YUV_PARAM_CB_G]))) >> 5;
+    B = (Sint16) (L + YUV_SIMD_MULHI(Cb, params[YUV_PARAM_CB_B])) >> 5;
+    R = SDL_max(0, SDL_min(R, 255));
+    G = SDL_max(0, SDL_min(G, 255));
+    B = SDL_max(0, SDL_min(B, 255));
+    return (((Uint32) R << params[YUV_PARAM_R_SHIFT]) |
+            ((Uint32) G << params[YUV_PARAM_G_SHIFT]) |
+            ((Uint32) B << params[YUV_PARAM_B_SHIFT]) |
+            (Uint32) params[YUV_PARAM_AMASK]);
+}
+
+#endif /* SDL_YUV_SIMD */
+
+#ifdef __SSE2__
+typedef struct
+{
+    __m128i zero;
+    __m128i y_offset;
+    __m128i chroma_offset;
+    __m128i y_scale;
+    __m128i round;
+    __m128i cr_r;
+    __m128i cr_g;
+    __m128i cb_g;
+    __m128i cb_b;
+    __m128i fill;               /* The byte of the pixels that isn't R, G or B */
+    int r_slot, g_slot, b_slot, fill_slot;
+} YUV_SSE2_Constants;
+
+static void
+YUV_SSE2_Setup(YUV_SSE2_Constants * k, const int *params)
+{
+    k->zero = _mm_setzero_si128();
+    k->y_offset = _mm_set1_epi16((short) params[YUV_PARAM_Y_OFFSET]);
+    k->chroma_offset = _mm_set1_epi16(128);
+    /* Y is shifted up 7 bits and Cb and Cr 8 bits so that the high words
+       of the products are in 5 bit fixed point.
+     */
+    k->y_scale = _mm_set1_epi16((short) (params[YUV_PARAM_Y_SCALE] * 2));
+    k->round = _mm_set1_epi16(1 << 4);
+    k->cr_r = _mm_set1_epi16((short) params[YUV_PARAM_CR_R]);
+    k->cr_g = _mm_set1_epi16((short) params[YUV_PARAM_CR_G]);
+    k->cb_g = _mm_set1_epi16((short) params[YUV_PARAM_CB_G]);
+    k->cb_b = _mm_set1_epi16((short) params[YUV_PARAM_CB_B]);
+    k->r_slot = params[YUV_PARAM_R_SHIFT] / 8;
+    k->g_slot = params[YUV_PARAM_G_SHIFT] / 8;
+    k->b_slot = params[YUV_PARAM_B_SHIFT] / 8;
+    k->fill_slot = 6 - k->r_slot - k->g_slot - k->b_slot;
+    k->fill = _mm_set1_epi8((char) (params[YUV_PARAM_AMASK] >>
+                                    (k->fill_slot * 8)));
+}
+
+/* Convert 16 pixels, given as 16 bit Y and the 16 bit Cb and Cr shared by
+   each pair of them.
+ */
+static __inline__ void
+YUV_SSE2_Convert16(const YUV_SSE2_Constants * k, __m128i y0, __m128i y1,
+                   __m128i cb, __m128i cr, Uint32 * out)
+{
+    __m128i r, g, b, chroma_r, chroma_g, chroma_b, channels[4], lo, hi;
+
+    y0 = _mm_slli_epi16(_mm_sub_epi16(y0, k->y_offset), 7);
+    y1 = _mm_slli_epi16(_mm_sub_epi16(y1, k->y_offset), 7);
+    y0 = _mm_add_epi16(_mm_mulhi_epi16(y0, k->y_scale), k->round);
+    y1 = _mm_add_epi16(_mm_mulhi_epi16(y1, k->y_scale), k->round);
+
+    cb = _mm_slli_epi16(_mm_sub_epi16(cb, k->chroma_offset), 8);
+    cr = _mm_slli_epi16(_mm_sub_epi16(cr, k->chroma_offset), 8);
+    chroma_r = _mm_mulhi_epi16(cr, k->cr_r);
+    chroma_g = _mm_add_epi16(_mm_mulhi_epi16(cr, k->cr_g),
+                             _mm_mulhi_epi16(cb, k->cb_g));
+    chroma_b = _mm_mulhi_epi16(cb, k->cb_b);
+
+    r = _mm_packus_epi16(
+        _mm_srai_epi16(_mm_add_epi16(y0, _mm_unpacklo_epi16(chroma_r, chroma_r)), 5),
+        _mm_srai_epi16(_mm_add_epi16(y1, _mm_unpackhi_epi16(chroma_r, chroma_r)), 5));
+    g = _mm_packus_epi16(
+        _mm_srai_epi16(_mm_add_epi16(y0, _mm_unpacklo_epi16(chroma_g, chroma_g)), 5),
+        _mm_srai_epi16(_mm_add_epi16(y1, _mm_unpackhi_epi16(chroma_g, chroma_g)), 5));
+    b = _mm_packus_epi16(
+        _mm_srai_epi16(_mm_add_epi16(y0, _mm_unpacklo_epi16(chroma_b, chroma_b)), 5),
+        _mm_srai_epi16(_mm_add_epi16(y1, _mm_unpackhi_epi16(chroma_b, chroma_b)), 5));
+
+    /* Interleave the bytes in the order of the destination pixels */
+    channels[k->r_slot] = r;
+    channels[k->g_slot] = g;
+    channels[k->b_slot] = b;
+    channels[k->fill_slot] = k->fill;
+    lo = _mm_unpacklo_epi8(channels[0], channels[1]);
+    hi = _mm_unpacklo_epi8(channels[2], channels[3]);
+    _mm_storeu_si128((__m128i *) out, _mm_unpacklo_epi16(lo, hi));
+    _mm_storeu_si128((__m128i *) (out + 4), _mm_unpackhi_epi16(lo, hi));
+    lo = _mm_unpackhi_epi8(channels[0], channels[1]);
+    hi = _mm_unpackhi_epi8(channels[2], channels[3]);
+    _mm_storeu_si128((__m128i *) (out + 8), _mm_unpacklo_epi16(lo, hi));
+    _mm_storeu_si128((__m128i *) (out + 12), _mm_unpackhi_epi16(lo, hi));
+}
+
+static void
+Color32YV12SSE2(int *colortab, Uint32 * rgb_2_pix,
+                unsigned char *lum, unsigned char *cr,
+                unsigned char *cb, unsigned char *out,
+                int rows, int cols, int mod)
+{
+    const int *params = &colortab[YUV_PARAMS_OFFSET];
+    const int cols_2 = cols / 2;
+    YUV_SSE2_Constants k;
+    int x, y;
+
+    YUV_SSE2_Setup(&k, params);
+
+    for (y = 0; y < (rows & ~1); ++y) {
+        const unsigned char *Y = lum + y * cols;
+        const unsigned char *U = cb + (y / 2) * cols_2;
+        const unsigned char *V = cr + (y / 2) * cols_2;
+        Uint32 *row = (Uint32 *) out + y * (cols + mod);
+
+        for (x = 0; x + 16 <= cols_2 * 2; x += 16) {
+            const __m128i l = _mm_loadu_si128((const __m128i *) &Y[x]);
+            const __m128i u = _mm_loadl_epi64((const __m128i *) &U[x / 2]);
+            const __m128i v = _mm_loadl_epi64((const __m128i *) &V[x / 2]);
+
+            YUV_SSE2_Convert16(&k, _mm_unpacklo_epi8(l, k.zero),
+                               _mm_unpackhi_epi8(l, k.zero),
+                               _mm_unpacklo_epi8(u, k.zero),
+                               _mm_unpacklo_epi8(v, k.zero), &row[x]);
+        }
+        for (; x < cols_2 * 2; ++x) {
+            row[x] = YUV_SIMD_ConvertPixel(params, Y[x], U[x / 2], V[x / 2]);
+        }
+    }
+}
+
+static void
+Color32YUY2SSE2(int *colortab, Uint32 * rgb_2_pix,
+                unsigned char *lum, unsigned char *cr,
+                unsigned char *cb, unsigned char *out,
+                int rows, int cols, int mod)
+{
+    const int *params = &colortab[YUV_PARAMS_OFFSET];
+    const int cols_2 = cols / 2;
+    /* The Y, Cb and Cr bytes are at these offsets in each 4 byte pair */
+    unsigned char *base = SDL_min(lum, SDL_min(cr, cb));
+    const int lum_offset = (int) (lum - base);
+    const int cb_offset = (int) (cb - base);
+    const int cr_offset = (int) (cr - base);
+    const __m128i cb_shift = _mm_cvtsi32_si128(cb_offset * 8);
+    const __m128i cr_shift = _mm_cvtsi32_si128(cr_offset * 8);
+    const __m128i lowbyte = _mm_set1_epi16(0xff);
+    const __m128i chromabyte = _mm_set1_epi32(0xff);
+    YUV_SSE2_Constants k;
+    int x, y;
+
+    YUV_SSE2_Setup(&k, params);
+
+    for (y = 0; y < rows; ++y) {
+        const unsigned char *src = base + y * cols * 2;
+        Uint32 *row = (Uint32 *) out + y * (cols + mod);
+
+        for (x = 0; x + 16 <= cols_2 * 2; x += 16) {
+            const __m128i p0 = _mm_loadu_si128((const __m128i *) &src[x * 2]);
+            const __m128i p1 =
+                _mm_loadu_si128((const __m128i *) &src[x * 2 + 16]);
+            __m128i l0, l1, u, v;
+
+            if (lum_offset) {
+                l0 = _mm_srli_epi16(p0, 8);
+                l1 = _mm_srli_epi16(p1, 8);
+            } else {
+                l0 = _mm_and_si128(p0, lowbyte);
+                l1 = _mm_and_si128(p1, lowbyte);
+            }
+            u = _mm_packs_epi32(
+                _mm_and_si128(_mm_srl_epi32(p0, cb_shift), chromabyte),
+                _mm_and_si128(_mm_srl_epi32(p1, cb_shift), chromabyte));
+            v = _mm_packs_epi32(
+                _mm_and_si128(_mm_srl_epi32(p0, cr_shift), chromabyte),
+                _mm_and_si128(_mm_srl_epi32(p1, cr_shift), chromabyte));
+            YUV_SSE2_Convert16(&k, l0, l1, u, v, &row[x]);
+        }
+        for (; x < cols_2 * 2; ++x) {
+            const unsigned char *pair = &src[(x & ~1) * 2];
+            row[x] = YUV_SIMD_ConvertPixel(params,
+                                           pair[lum_offset + (x & 1) * 2],
+                                           pair[cb_offset], pair[cr_offset]);
+        }
+    }
+}
+#endif /* __SSE2__ */
+
+#ifdef __AVX2__
+typedef struct
+{
+    __m256i y_offset;
+    __m256i chroma_offset;
+    __m256i y_scale;
+    __m256i round;
+    __m256i cr_r;
+    __m256i cr_g;
+    __m256i cb_g;
+    __m256i cb_b;
+    __m256i fill;
+    int r_slot, g_slot, b_slot, fill_slot;
+} YUV_AVX2_Constants;
+
+static void
+YUV_AVX2_Setup(YUV_AVX2_Constants * k, const int *params)
+{
+    k->y_offset = _mm256_set1_epi16((short) params[YUV_PARAM_Y_OFFSET]);
+    k->chroma_offset = _mm256_set1_epi16(128);
+    k->y_scale = _mm256_set1_epi16((short) (params[YUV_PARAM_Y_SCALE] * 2));
+    k->round = _mm256_set1_epi16(1 << 4);
+    k->cr_r = _mm256_set1_epi16((short) params[YUV_PARAM_CR_R]);
+    k->cr_g = _mm256_set1_epi16((short) params[YUV_PARAM_CR_G]);
+    k->cb_g = _mm256_set1_epi16((short) params[YUV_PARAM_CB_G]);
+    k->cb_b = _mm256_set1_epi16((short) params[YUV_PARAM_CB_B]);
+    k->r_slot = params[YUV_PARAM_R_SHIFT] / 8;
+    k->g_slot = params[YUV_PARAM_G_SHIFT] / 8;
+    k->b_slot = params[YUV_PARAM_B_SHIFT] / 8;
+    k->fill_slot = 6 - k->r_slot - k->g_slot - k->b_slot;
+    k->fill = _mm256_set1_epi8((char) (params[YUV_PARAM_AMASK] >>
+                                       (k->fill_slot * 8)));
+}
+
+/* Convert 32 pixels, given as 16 bit Y and the 16 bit Cb and Cr shared by
+   each pair of them.  The AVX2 unpack and pack instructions work within
+   128 bit lanes, so the quarters of Cb and Cr come in the order 0, 2, 1, 3.
+ */
+static __inline__ void
+YUV_AVX2_Convert32(const YUV_AVX2_Constants * k, __m256i y0, __m256i y1,
+                   __m256i cb, __m256i cr, Uint32 * out)
+{
+    __m256i r, g, b, chroma_r, chroma_g, chroma_b, channels[4], lo, hi, p, q;
+
+    y0 = _mm256_slli_epi16(_mm256_sub_epi16(y0, k->y_offset), 7);
+    y1 = _mm256_slli_epi16(_mm256_sub_epi16(y1, k->y_offset), 7);
+    y0 = _mm256_add_epi16(_mm256_mulhi_epi16(y0, k->y_scale), k->round);
+    y1 = _mm256_add_epi16(_mm256_mulhi_epi16(y1, k->y_scale), k->round);
+
+    cb = _mm256_slli_epi16(_mm256_sub_epi16(cb, k->chroma_offset), 8);
+    cr = _mm256_slli_epi16(_mm256_sub_epi16(cr, k->chroma_offset), 8);
+    chroma_r = _mm256_mulhi_epi16(cr, k->cr_r);
+    chroma_g = _mm256_add_epi16(_mm256_mulhi_epi16(cr, k->cr_g),
+                                _mm256_mulhi_epi16(cb, k->cb_g));
+    chroma_b = _mm256_mulhi_epi16(cb, k->cb_b);
+
+    /* The lanes of each channel hold pixels 0-7 and 16-23, then 8-15 and 24-31 */
+    r = _mm256_packus_epi16(
+        _mm256_srai_epi16(_mm256_add_epi16(y0, _mm256_unpacklo_epi16(chroma_r, chroma_r)), 5),
+        _mm256_srai_epi16(_mm256_add_epi16(y1, _mm256_unpackhi_epi16(chroma_r, chroma_r)), 5));
+    g = _mm256_packus_epi16(
+        _mm256_srai_epi16(_mm256_add_epi16(y0, _mm256_unpacklo_epi16(chroma_g, chroma_g)), 5),
+        _mm256_srai_epi16(_mm256_add_epi16(y1, _mm256_unpackhi_epi16(chroma_g, chroma_g)), 5));
+    b = _mm256_packus_epi16(
+        _mm256_srai_epi16(_mm256_add_epi16(y0, _mm256_unpacklo_epi16(chroma_b, chroma_b)), 5),
+        _mm256_srai_epi16(_mm256_add_epi16(y1, _mm256_unpackhi_epi16(chroma_b, chroma_b)), 5));
+
+    /* Interleave the bytes in the order of the destination pixels */
+    channels[k->r_slot] = r;
+    channels[k->g_slot] = g;
+    channels[k->b_slot] = b;
+    channels[k->fill_slot] = k->fill;
+    lo = _mm256_unpacklo_epi8(channels[0], channels[1]);
+    hi = _mm256_unpacklo_epi8(channels[2], channels[3]);
+    p = _mm256_unpacklo_epi16(lo, hi);
+    q = _mm256_unpackhi_epi16(lo, hi);
+    _mm256_storeu_si256((__m256i *) out, _mm256_permute2x128_si256(p, q, 0x20));
+    _mm256_storeu_si256((__m256i *) (out + 8), _mm256_permute2x128_si256(p, q, 0x31));
+    lo = _mm256_unpackhi_epi8(channels[0], channels[1]);
+    hi = _mm256_unpackhi_epi8(channels[2], channels[3]);
+    p = _mm256_unpacklo_epi16(lo, hi);
+    q = _mm256_unpackhi_epi16(lo, hi);
+    _mm256_storeu_si256((__m256i *) (out + 16), _mm256_permute2x128_si256(p, q, 0x20));
+    _mm256_storeu_si256((__m256i *) (out + 24), _mm256_permute2x128_si256(p, q, 0x31));
+}
+
+static void
+Color32YV12AVX2(int *colortab, Uint32 * rgb_2_pix,
+                unsigned char *lum, unsigned char *cr,
+                unsigned char *cb, unsigned char *out,
+                int rows, int cols, int mod)
+{
+    const int *params = &colortab[YUV_PARAMS_OFFSET];
+    const int cols_2 = cols / 2;
+    YUV_AVX2_Constants k;
+    int x, y;
+
+    YUV_AVX2_Setup(&k, params);
+
+    for (y = 0; y < (rows & ~1); ++y) {
+        const unsigned char *Y = lum + y * cols;
+        const unsigned char *U = cb + (y / 2) * cols_2;
+        const unsigned char *V = cr + (y / 2) * cols_2;
+        Uint32 *row = (Uint32 *) out + y * (cols + mod);
+
+        for (x = 0; x + 32 <= cols_2 * 2; x += 32) {
+            const __m256i l = _mm256_loadu_si256((const __m256i *) &Y[x]);
+            const __m128i u = _mm_loadu_si128((const __m128i *) &U[x / 2]);
+            const __m128i v = _mm_loadu_si128((const __m128i *) &V[x / 2]);
+
+            YUV_AVX2_Convert32(&k, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(l)),
+                               _mm256_cvtepu8_epi16(_mm256_extracti128_si256(l, 1)),
+                               _mm256_permute4x64_epi64(_mm256_cvtepu8_epi16(u), _MM_SHUFFLE(3, 1, 2, 0)),
+                               _mm256_permute4x64_epi64(_mm256_cvtepu8_epi16(v), _MM_SHUFFLE(3, 1, 2, 0)),
+                               &row[x]);
+        }
+        for (; x < cols_2 * 2; ++x) {
+            row[x] = YUV_SIMD_ConvertPixel(params, Y[x], U[x / 2], V[x / 2]);
+        }
+    }
+    _mm256_zeroupper();
+}
+
+static void
+Color32YUY2AVX2(int *colortab, Uint32 * rgb_2_pix,
+                unsigned char *lum, unsigned char *cr,
+                unsigned char *cb, unsigned char *out,
+                int rows, int cols, int mod)
+{
+    const int *params = &colortab[YUV_PARAMS_OFFSET];
+    const int cols_2 = cols / 2;
+    /* The Y, Cb and Cr bytes are at these offsets in each 4 byte pair */
+    unsigned char *base = SDL_min(lum, SDL_min(cr, cb));
+    const int lum_offset = (int) (lum - base);
+    const int cb_offset = (int) (cb - base);
+    const int cr_offset = (int) (cr - base);
+    const __m128i cb_shift = _mm_cvtsi32_si128(cb_offset * 8);
+    const __m128i cr_shift = _mm_cvtsi32_si128(cr_offset * 8);
+    const __m256i lowbyte = _mm256_set1_epi16(0xff);
+    const __m256i chromabyte = _mm256_set1_epi32(0xff);
+    YUV_AVX2_Constants k;
+    int x, y;
+
+    YUV_AVX2_Setup(&k, params);
+
+    for (y = 0; y < rows; ++y) {
+        const unsigned char *src = base + y * cols * 2;
+        Uint32 *row = (Uint32 *) out + y * (cols + mod);
+
+        for (x = 0; x + 32 <= cols_2 * 2; x += 32) {
+            const __m256i p0 = _mm256_loadu_si256((const __m256i *) &src[x * 2]);
+            const __m256i p1 =
+                _mm256_loadu_si256((const __m256i *) &src[x * 2 + 32]);
+            __m256i l0, l1, u, v;
+
+            if (lum_offset) {
+                l0 = _mm256_srli_epi16(p0, 8);
+                l1 = _mm256_srli_epi16(p1, 8);
+            } else {
+                l0 = _mm256_and_si256(p0, lowbyte);
+                l1 = _mm256_and_si256(p1, lowbyte);
+            }
+            /* Packing within lanes gives the quarters in the order 0, 2, 1, 3 */
+            u = _mm256_packs_epi32(
+                _mm256_and_si256(_mm256_srl_epi32(p0, cb_shift), chromabyte),
+                _mm256_and_si256(_mm256_srl_epi32(p1, cb_shift), chromabyte));
+            v = _mm256_packs_epi32(
+                _mm256_and_si256(_mm256_srl_epi32(p0, cr_shift), chromabyte),
+                _mm256_and_si256(_mm256_srl_epi32(p1, cr_shift), chromabyte));
+            YUV_AVX2_Convert32(&k, l0, l1, u, v, &row[x]);
+        }
+        for (; x < cols_2 * 2; ++x) {
+            const unsigned char *pair = &src[(x & ~1) * 2];
+            row[x] = YUV_SIMD_ConvertPixel(params,
+                                           pair[lum_offset + (x & 1) * 2],
+                                           pair[cb_offset], pair[cr_offset]);
+        }
+    }
+    _mm256_zeroupper();
+}
+#endif /* __AVX2__ */
+
+#ifdef SDL_YUV_NEON
+typedef struct
+{
+    int16x8_t y_offset;
+    int16x8_t chroma_offset;
+    int16x8_t y_scale;
+    int16x8_t round;
+    int16x8_t cr_r;
+    int16x8_t cr_g;
+    int16x8_t cb_g;
+    int16x8_t cb_b;
+    uint8x16_t fill;
+    int r_slot, g_slot, b_slot, fill_slot;
+} YUV_NEON_Constants;
+
+static void
+YUV_NEON_Setup(YUV_NEON_Constants * k, const int *params)
+{
+    k->y_offset = vdupq_n_s16((int16_t) params[YUV_PARAM_Y_OFFSET]);
+    k->chroma_offset = vdupq_n_s16(128);
+    k->y_scale = vdupq_n_s16((int16_t) (params[YUV_PARAM_Y_SCALE] * 2));
+    k->round = vdupq_n_s16(1 << 4);
+    k->cr_r = vdupq_n_s16((int16_t) params[YUV_PARAM_CR_R]);
+    k->cr_g = vdupq_n_s16((int16_t) params[YUV_PARAM_CR_G]);
+    k->cb_g = vdupq_n_s16((int16_t) params[YUV_PARAM_CB_G]);
+    k->cb_b = vdupq_n_s16((int16_t) params[YUV_PARAM_CB_B]);
+    k->r_slot = params[YUV_PARAM_R_SHIFT] / 8;
+    k->g_slot = params[YUV_PARAM_G_SHIFT] / 8;
+    k->b_slot = params[YUV_PARAM_B_SHIFT] / 8;
+    k->fill_slot = 6 - k->r_slot - k->g_slot - k->b_slot;
+    k->fill = vdupq_n_u8((uint8_t) (params[YUV_PARAM_AMASK] >>
+                                    (k->fill_slot * 8)));
+}
+
+/* The high words of the signed 16 bit products, like _mm_mulhi_epi16() */
+static __inline__ int16x8_t
+YUV_NEON_MulHi(int16x8_t a, int16x8_t b)
+{
+    return vcombine_s16(vshrn_n_s32(vmull_s16(vget_low_s16(a), vget_low_s16(b)), 16),
+                        vshrn_n_s32(vmull_s16(vget_high_s16(a), vget_high_s16(b)), 16));
+}
+
+/* Add the chroma of each pair of pixels to their luminance and saturate */
+static __inline__ uint8x16_t
+YUV_NEON_Channel(int16x8_t y0, int16x8_t y1, int16x8_t chroma)
+{
+    const int16x8x2_t pairs = vzipq_s16(chroma, chroma);
+
+    return vcombine_u8(vqmovun_s16(vshrq_n_s16(vaddq_s16(y0, pairs.val[0]), 5)),
+                       vqmovun_s16(vshrq_n_s16(vaddq_s16(y1, pairs.val[1]), 5)));
+}
+
+/* Convert 16 pixels, given as 16 bit Y and the 16 bit Cb and Cr shared by
+   each pair of them.
+ */
+static __inline__ void
+YUV_NEON_Convert16(const YUV_NEON_Constants * k, int16x8_t y0, int16x8_t y1,
+                   int16x8_t cb, int16x8_t cr, Uint32 * out)
+{
+    int16x8_t chroma_r, chroma_g, chroma_b;
+    uint8x16x4_t pixels;
+
+    y0 = vshlq_n_s16(vsubq_s16(y0, k->y_offset), 7);
+    y1 = vshlq_n_s16(vsubq_s16(y1, k->y_offset), 7);
+    y0 = vaddq_s16(YUV_NEON_MulHi(y0, k->y_scale), k->round);
+    y1 = vaddq_s16(YUV_NEON_MulHi(y1, k->y_scale), k->round);
+
+    cb = vshlq_n_s16(vsubq_s16(cb, k->chroma_offset), 8);
+    cr = vshlq_n_s16(vsubq_s16(cr, k->chroma_offset), 8);
+    chroma_r = YUV_NEON_MulHi(cr, k->cr_r);
+    chroma_g = vaddq_s16(YUV_NEON_MulHi(cr, k->cr_g),
+                         YUV_NEON_MulHi(cb, k->cb_g));
+    chroma_b = YUV_NEON_MulHi(cb, k->cb_b);
+
+    /* Store the bytes interleaved in the order of the destination pixels */
+    pixels.val[k->r_slot] = YUV_NEON_Channel(y0, y1, chroma_r);
+    pixels.val[k->g_slot] = YUV_NEON_Channel(y0, y1, chroma_g);
+    pixels.val[k->b_slot] = YUV_NEON_Channel(y0, y1, chroma_b);
+    pixels.val[k->fill_slot] = k->fill;
+    vst4q_u8((uint8_t *) out, pixels);
+}
+
+#define YUV_NEON_WIDEN(x)   vreinterpretq_s16_u16(vmovl_u8(x))
+
+static void
+Color32YV12NEON(int *colortab, Uint32 * rgb_2_pix,
+                unsigned char *lum, unsigned char *cr,
+                unsigned char *cb, unsigned char *out,
+                int rows, int cols, int mod)
+{
+    const int *params = &colortab[YUV_PARAMS_OFFSET];
+    const int cols_2 = cols / 2;
+    YUV_NEON_Constants k;
+    int x, y;
+
+    YUV_NEON_Setup(&k, params);
+
+    for (y = 0; y < (rows & ~1); ++y) {
+        const unsigned char *Y = lum + y * cols;
+        const unsigned char *U = cb + (y / 2) * cols_2;
+        const unsigned char *V = cr + (y / 2) * cols_2;
+        Uint32 *row = (Uint32 *) out + y * (cols + mod);
+
+        for (x = 0; x + 16 <= cols_2 * 2; x += 16) {
+            const uint8x16_t l = vld1q_u8(&Y[x]);
+
+            YUV_NEON_Convert16(&k, YUV_NEON_WIDEN(vget_low_u8(l)),
+                               YUV_NEON_WIDEN(vget_high_u8(l)),
+                               YUV_NEON_WIDEN(vld1_u8(&U[x / 2])),
+                               YUV_NEON_WIDEN(vld1_u8(&V[x / 2])), &row[x]);
+        }
+        for (; x < cols_2 * 2; ++x) {
+            row[x] = YUV_SIMD_ConvertPixel(params, Y[x], U[x / 2], V[x / 2]);
+        }
+    }
+}
+
+static void
+Color32YUY2NEON(int *colortab, Uint32 * rgb_2_pix,
+                unsigned char *lum, unsigned char *cr,
+                unsigned char *cb, unsigned char *out,
+                int rows, int cols, int mod)
+{
+    const int *params = &colortab[YUV_PARAMS_OFFSET];
+    const int cols_2 = cols / 2;
+    /* The Y, Cb and Cr bytes are at these offsets in each 4 byte pair */
+    unsigned char *base = SDL_min(lum, SDL_min(cr, cb));
+    const int lum_offset = (int) (lum - base);
+    const int cb_offset = (int) (cb - base);
+    const int cr_offset = (int) (cr - base);
+    YUV_NEON_Constants k;
+    int x, y;
+
+    YUV_NEON_Setup(&k, params);
+
+    for (y = 0; y < rows; ++y) {
+        const unsigned char *src = base + y * cols * 2;
+        Uint32 *row = (Uint32 *) out + y * (cols + mod);
+
+        for (x = 0; x + 16 <= cols_2 * 2; x += 16) {
+            /* Each vector holds one byte of each of 8 pairs */
+            const uint8x8x4_t p = vld4_u8(&src[x * 2]);
+            const uint8x8x2_t l = vzip_u8(p.val[lum_offset], p.val[lum_offset + 2]);
+
+            YUV_NEON_Convert16(&k, YUV_NEON_WIDEN(l.val[0]),
+                               YUV_NEON_WIDEN(l.val[1]),
+                               YUV_NEON_WIDEN(p.val[cb_offset]),
+                               YUV_NEON_WIDEN(p.val[cr_offset]), &row[x]);
+        }
+        for (; x < cols_2 * 2; ++x) {
+            const unsigned char *pair = &src[(x & ~1) * 2];
+            row[x] = YUV_SIMD_ConvertPixel(params,
+                                           pair[lum_offset + (x & 1) * 2],
+                                           pair[cb_offset], pair[cr_offset]);
+        }
+    }
+}
+#endif /* SDL_YUV_NEON */
+
 /*
  * How many 1 bits are there in the Uint32.
  * Low performance, do not call often.
@@ -894,6 +1494,10 @@ SDL_SW_SetupYUVDisplay(SDL_SW_YUVTexture * swdata, Uint32 target_format)
     int i;
     int bpp;
     Uint32 Rmask, Gmask, Bmask, Amask;
+#ifdef SDL_YUV_SIMD
+    int *params;
+    SDL_bool simd_layout;
+#endif
 
     if (!SDL_PixelFormatEnumToMasks
         (target_format, &bpp, &Rmask, &Gmask, &Bmask, &Amask) || bpp < 15) {
@@ -948,6 +1552,22 @@ SDL_SW_SetupYUVDisplay(SDL_SW_YUVTexture * swdata, Uint32 target_format)
         b_2_pix_alloc[i + 512] = b_2_pix_alloc[511];
     }
 
+#ifdef SDL_YUV_SIMD
+    /* The SIMD functions write 32-bit pixels with a byte for each channel */
+    params = &swdata->colortab[YUV_PARAMS_OFFSET];
+    params[YUV_PARAM_R_SHIFT] = free_bits_at_bottom(Rmask);
+    params[YUV_PARAM_G_SHIFT] = free_bits_at_bottom(Gmask);
+    params[YUV_PARAM_B_SHIFT] = free_bits_at_bottom(Bmask);
+    params[YUV_PARAM_AMASK] = (int) Amask;
+    simd_layout = (SDL_BYTESPERPIXEL(target_format) == 4 &&
+                   number_of_bits_set(Rmask) == 8 &&
+                   number_of_bits_set(Gmask) == 8 &&
+                   number_of_bits_set(Bmask) == 8 &&
+                   (params[YUV_PARAM_R_SHIFT] % 8) == 0 &&
+                   (params[YUV_PARAM_G_SHIFT] % 8) == 0 &&
+                   (params[YUV_PARAM_B_SHIFT] % 8) == 0);
+#endif
+
     /* You have chosen wisely... */
     switch (swdata->format) {
     case SDL_PIXELFORMAT_YV12:
@@ -955,7 +1575,8 @@ SDL_SW_SetupYUVDisplay(SDL_SW_YUVTexture * swdata, Uint32 target_format)
         if (SDL_BYTESPERPIXEL(target_format) == 2) {
 #if (__GNUC__ > 2) && defined(__i386__) && __OPTIMIZE__ && SDL_ASSEMBLY_ROUTINES
             /* inline assembly functions */
-            if (SDL_HasMMX() && (Rmask == 0xF800) &&
+            if (SDL_HasMMX() && swdata->mode == SDL_YUV_CONVERSION_JPEG &&
+                (Rmask == 0xF800) &&
                 (Gmask == 0x07E0) && (Bmask == 0x001F)
                 && (swdata->w & 15) == 0) {
 /* printf("Using MMX 16-bit 565 dither\n"); */
@@ -976,7 +1597,8 @@ SDL_SW_SetupYUVDisplay(SDL_SW_YUVTexture * swdata, Uint32 target_format)
         if (SDL_BYTESPERPIXEL(target_format) == 4) {
 #if (__GNUC__ > 2) && defined(__i386__) && __OPTIMIZE__ && SDL_ASSEMBLY_ROUTINES
             /* inline assembly functions */
-            if (SDL_HasMMX() && (Rmask == 0x00FF0000) &&
+            if (SDL_HasMMX() && swdata->mode == SDL_YUV_CONVERSION_JPEG &&
+                (Rmask == 0x00FF0000) &&
                 (Gmask == 0x0000FF00) &&
                 (Bmask == 0x000000FF) && (swdata->w & 15) == 0) {
 /* printf("Using MMX 32-bit dither\n"); */
@@ -987,6 +1609,21 @@ SDL_SW_SetupYUVDisplay(SDL_SW_YUVTexture * swdata, Uint32 target_format)
             }
 #else
             swdata->Display1X = Color32DitherYV12Mod1X;
+#endif
+#ifdef __SSE2__
+            if (SDL_HasSSE2() && simd_layout) {
+                swdata->Display1X = Color32YV12SSE2;
+            }
+#endif
+#ifdef __AVX2__
+            if (SDL_HasAVX() && simd_layout) {
+                swdata->Display1X = Color32YV12AVX2;
+            }
+#endif
+#ifdef SDL_YUV_NEON
+            if (simd_layout) {
+                swdata->Display1X = Color32YV12NEON;
+            }
 #endif
             swdata->Display2X = Color32DitherYV12Mod2X;
         }
@@ -1005,6 +1642,21 @@ SDL_SW_SetupYUVDisplay(SDL_SW_YUVTexture * swdata, Uint32 target_format)
         if (SDL_BYTESPERPIXEL(target_format) == 4) {
             swdata->Display1X = Color32DitherYUY2Mod1X;
             swdata->Display2X = Color32DitherYUY2Mod2X;
+#ifdef __SSE2__
+            if (SDL_HasSSE2() && simd_layout) {
+                swdata->Display1X = Color32YUY2SSE2;
+            }
+#endif
+#ifdef __AVX2__
+            if (SDL_HasAVX() && simd_layout) {
+                swdata->Display1X = Color32YUY2AVX2;
+            }
+#endif
+#ifdef SDL_YUV_NEON
+            if (simd_layout) {
+                swdata->Display1X = Color32YUY2NEON;
+            }
+#endif
         }
         break;
     default:
@@ -1025,8 +1677,13 @@ SDL_SW_CreateYUVTexture(Uint32 format, int w, int h)
     int *Cr_g_tab;
     int *Cb_g_tab;
     int *Cb_b_tab;
+    int *L_tab;
+    int *params;
+    const char *hint;
+    double Kr, Kb, Kg;
+    double y_offset, y_scale, c_scale;
+    double cr_r, cr_g, cb_g, cb_b;
     int i;
-    int CR, CB;
 
     switch (format) {
     case SDL_PIXELFORMAT_YV12:
@@ -1048,10 +1705,22 @@ SDL_SW_CreateYUVTexture(Uint32 format, int w, int h)
 
     swdata->format = format;
     swdata->target_format = SDL_PIXELFORMAT_UNKNOWN;
+    swdata->mode = SDL_YUV_CONVERSION_JPEG;
+    hint = SDL_GetHint(SDL_HINT_YUV_CONVERSION_MODE);
+    if (hint) {
+        if (SDL_strcasecmp(hint, "BT601") == 0) {
+            swdata->mode = SDL_YUV_CONVERSION_BT601;
+        } else if (SDL_strcasecmp(hint, "BT709") == 0) {
+            swdata->mode = SDL_YUV_CONVERSION_BT709;
+        } else if (SDL_strcasecmp(hint, "BT709_FULL") == 0) {
+            swdata->mode = SDL_YUV_CONVERSION_BT709_FULL;
+        }
+    }
     swdata->w = w;
     swdata->h = h;
     swdata->pixels = (Uint8 *) SDL_malloc(w * h * 2);
-    swdata->colortab = (int *) SDL_malloc(4 * 256 * sizeof(int));
+    swdata->colortab =
+        (int *) SDL_malloc((YUV_PARAMS_OFFSET + YUV_PARAM_MAX) * sizeof(int));
     swdata->rgb_2_pix = (Uint32 *) SDL_malloc(3 * 768 * sizeof(Uint32));
     if (!swdata->pixels || !swdata->colortab || !swdata->rgb_2_pix) {
         SDL_SW_DestroyYUVTexture(swdata);
@@ -1060,21 +1729,53 @@ SDL_SW_CreateYUVTexture(Uint32 format, int w, int h)
     }
 
     /* Generate the tables for the display surface */
+    if (swdata->mode == SDL_YUV_CONVERSION_BT709 ||
+        swdata->mode == SDL_YUV_CONVERSION_BT709_FULL) {
+        Kr = 0.2126;
+        Kb = 0.0722;
+    } else {
+        Kr = 0.299;
+        Kb = 0.114;
+    }
+    Kg = 1.0 - Kr - Kb;
+    if (swdata->mode == SDL_YUV_CONVERSION_BT601 ||
+        swdata->mode == SDL_YUV_CONVERSION_BT709) {
+        /* Y is in [16, 235] and Cb and Cr are in [16, 240] */
+        y_offset = 16.0;
+        y_scale = 255.0 / 219.0;
+        c_scale = 255.0 / 224.0;
+    } else {
+        y_offset = 0.0;
+        y_scale = 1.0;
+        c_scale = 1.0;
+    }
+    cr_r = 2.0 * (1.0 - Kr) * c_scale;
+    cr_g = -2.0 * (1.0 - Kr) * Kr / Kg * c_scale;
+    cb_g = -2.0 * (1.0 - Kb) * Kb / Kg * c_scale;
+    cb_b = 2.0 * (1.0 - Kb) * c_scale;
+
     Cr_r_tab = &swdata->colortab[0 * 256];
     Cr_g_tab = &swdata->colortab[1 * 256];
     Cb_g_tab = &swdata->colortab[2 * 256];
     Cb_b_tab = &swdata->colortab[3 * 256];
+    L_tab = &swdata->colortab[4 * 256];
     for (i = 0; i < 256; i++) {
-        /* Gamma correction (luminescence table) and chroma correction
-           would be done here.  See the Berkeley mpeg_play sources.
-         */
-        CB = CR = (i - 128);
-        Cr_r_tab[i] = (int) ((0.419 / 0.299) * CR);
-        Cr_g_tab[i] = (int) (-(0.299 / 0.419) * CR);
-        Cb_g_tab[i] = (int) (-(0.114 / 0.331) * CB);
-        Cb_b_tab[i] = (int) ((0.587 / 0.331) * CB);
+        /* The sums of these stay within the 768 entries of rgb_2_pix */
+        Cr_r_tab[i] = SDL_max(-256, SDL_min(YUV_ROUND(cr_r * (i - 128)), 256));
+        Cr_g_tab[i] = YUV_ROUND(cr_g * (i - 128));
+        Cb_g_tab[i] = YUV_ROUND(cb_g * (i - 128));
+        Cb_b_tab[i] = SDL_max(-256, SDL_min(YUV_ROUND(cb_b * (i - 128)), 256));
+        L_tab[i] = SDL_max(0, SDL_min(YUV_ROUND(y_scale * (i - y_offset)), 255));
     }
 
+    params = &swdata->colortab[YUV_PARAMS_OFFSET];
+    params[YUV_PARAM_Y_OFFSET] = (int) y_offset;
+    params[YUV_PARAM_Y_SCALE] = YUV_ROUND(y_scale * (1 << YUV_FIXED_BITS));
+    params[YUV_PARAM_CR_R] = YUV_ROUND(cr_r * (1 << YUV_FIXED_BITS));
+    params[YUV_PARAM_CR_G] = YUV_ROUND(cr_g * (1 << YUV_FIXED_BITS));
+    params[YUV_PARAM_CB_G] = YUV_ROUND(cb_g * (1 << YUV_FIXED_BITS));
+    params[YUV_PARAM_CB_B] = YUV_ROUND(cb_b * (1 << YUV_FIXED_BITS));
+
     /* Find the pitch and offset values for the overlay */
     switch (format) {
     case SDL_PIXELFORMAT_YV12:
@@ -1184,6 +1885,61 @@ SDL_SW_UpdateYUVTexture(SDL_SW_YUVTexture * swdata, const SDL_Rect * rect,
     return 0;
 }
 
+int
+SDL_SW_UpdateYUVTexturePlanar(SDL_SW_YUVTexture * swdata, const SDL_Rect * rect,
+                              const Uint8 *Yplane, int Ypitch,
+                              const Uint8 *Uplane, int Upitch,
+                              const Uint8 *Vplane, int Vpitch)
+{
+    const Uint8 *src;
+    Uint8 *dst;
+    int row;
+    size_t length;
+
+    /* Copy the Y plane */
+    src = Yplane;
+    dst = swdata->pixels + rect->y * swdata->w + rect->x;
+    length = rect->w;
+    for (row = 0; row < rect->h; ++row) {
+        SDL_memcpy(dst, src, length);
+        src += Ypitch;
+        dst += swdata->w;
+    }
+
+    /* Copy the U plane */
+    src = Uplane;
+    if (swdata->format == SDL_PIXELFORMAT_IYUV) {
+        dst = swdata->pixels + swdata->h * swdata->w;
+    } else {
+        dst = swdata->pixels + swdata->h * swdata->w +
+              (swdata->h * swdata->w) / 4;
+    }
+    dst += rect->y/2 * swdata->w/2 + rect->x/2;
+    length = rect->w / 2;
+    for (row = 0; row < rect->h/2; ++row) {
+        SDL_memcpy(dst, src, length);
+        src += Upitch;
+        dst += swdata->w/2;
+    }
+
+    /* Copy the V plane */
+    src = Vplane;
+    if (swdata->format == SDL_PIXELFORMAT_YV12) {
+        dst = swdata->pixels + swdata->h * swdata->w;
+    } else {
+        dst = swdata->pixels + swdata->h * swdata->w +
+              (swdata->h * swdata->w) / 4;
+    }
+    dst += rect->y/2 * swdata->w/2 + rect->x/2;
+    length = rect->w / 2;
+    for (row = 0; row < rect->h/2; ++row) {
+        SDL_memcpy(dst, src, length);
+        src += Vpitch;
+        dst += swdata->w/2;
+    }
+    return 0;
+}
+
 int
 SDL_SW_LockYUVTexture(SDL_SW_YUVTexture * swdata, const SDL_Rect * rect,
                       void **pixels, int *pitch)
@@ -24,10 +24,19 @@
 
 /* This is the software implementation of the YUV texture support */
 
+typedef enum
+{
+    SDL_YUV_CONVERSION_JPEG,        /**< BT.601, full range */
+    SDL_YUV_CONVERSION_BT601,       /**< BT.601, limited range */
+    SDL_YUV_CONVERSION_BT709,       /**< BT.709, limited range */
+    SDL_YUV_CONVERSION_BT709_FULL   /**< BT.709, full range */
+} SDL_YUV_CONVERSION_MODE;
+
 struct SDL_SW_YUVTexture
 {
     Uint32 format;
     Uint32 target_format;
+    SDL_YUV_CONVERSION_MODE mode;
     int w, h;
     Uint8 *pixels;
     int *colortab;
@@ -57,6 +66,10 @@ int SDL_SW_QueryYUVTexturePixels(SDL_SW_YUVTexture * swdata, void **pixels,
                                  int *pitch);
 int SDL_SW_UpdateYUVTexture(SDL_SW_YUVTexture * swdata, const SDL_Rect * rect,
                             const void *pixels, int pitch);
+int SDL_SW_UpdateYUVTexturePlanar(SDL_SW_YUVTexture * swdata, const SDL_Rect * rect,
+                                  const Uint8 *Yplane, int Ypitch,
+                                  const Uint8 *Uplane, int Upitch,
+                                  const Uint8 *Vplane, int Vpitch);
 int SDL_SW_LockYUVTexture(SDL_SW_YUVTexture * swdata, const SDL_Rect * rect,
                           void **pixels, int *pitch);
 void SDL_SW_UnlockYUVTexture(SDL_SW_YUVTexture * swdata);
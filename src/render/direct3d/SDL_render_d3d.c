@@ -209,6 +209,11 @@ static int D3D_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture);
 static int D3D_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                              const SDL_Rect * rect, const void *pixels,
                              int pitch);
+static int D3D_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
+                                const SDL_Rect * rect,
+                                const Uint8 *Yplane, int Ypitch,
+                                const Uint8 *Uplane, int Upitch,
+                                const Uint8 *Vplane, int Vpitch);
 static int D3D_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                            const SDL_Rect * rect, void **pixels, int *pitch);
 static void D3D_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture);
@@ -488,6 +493,7 @@ D3D_Reset(SDL_Renderer * renderer)
 
     IDirect3DDevice9_GetRenderTarget(data->device, 0, &data->defaultRenderTarget);
     D3D_InitRenderState(data);
+    SDL_ResetRenderState(renderer);
     D3D_UpdateViewport(renderer);
     return 0;
 }
@@ -663,6 +669,7 @@ D3D_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->WindowEvent = D3D_WindowEvent;
     renderer->CreateTexture = D3D_CreateTexture;
     renderer->UpdateTexture = D3D_UpdateTexture;
+    renderer->UpdateTextureYUV = D3D_UpdateTextureYUV;
     renderer->LockTexture = D3D_LockTexture;
     renderer->UnlockTexture = D3D_UnlockTexture;
     renderer->SetRenderTarget = D3D_SetRenderTarget;
@@ -1076,7 +1083,42 @@ D3D_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
         if (D3D_UpdateTextureInternal(texture->format == SDL_PIXELFORMAT_YV12 ? data->utexture : data->vtexture, texture->format, full_texture, rect->x / 2, rect->y / 2, rect->w / 2, rect->h / 2, pixels, pitch / 2) < 0) {
             return -1;
         }
+        renderer->stats.bytes_uploaded += 2 * (Uint64) (rect->w / 2) * (rect->h / 2);
     }
+    renderer->stats.bytes_uploaded +=
+        (Uint64) rect->w * rect->h * SDL_BYTESPERPIXEL(texture->format);
+    return 0;
+}
+
+static int
+D3D_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
+                     const SDL_Rect * rect,
+                     const Uint8 *Yplane, int Ypitch,
+                     const Uint8 *Uplane, int Upitch,
+                     const Uint8 *Vplane, int Vpitch)
+{
+    D3D_TextureData *data = (D3D_TextureData *) texture->driverdata;
+    SDL_bool full_texture = SDL_FALSE;
+
+#ifdef USE_DYNAMIC_TEXTURE
+    if (texture->access == SDL_TEXTUREACCESS_STREAMING &&
+        rect->x == 0 && rect->y == 0 &&
+        rect->w == texture->w && rect->h == texture->h) {
+        full_texture = SDL_TRUE;
+    }
+#endif
+
+    if (D3D_UpdateTextureInternal(data->texture, texture->format, full_texture, rect->x, rect->y, rect->w, rect->h, Yplane, Ypitch) < 0) {
+        return -1;
+    }
+    if (D3D_UpdateTextureInternal(data->utexture, texture->format, full_texture, rect->x / 2, rect->y / 2, rect->w / 2, rect->h / 2, Uplane, Upitch) < 0) {
+        return -1;
+    }
+    if (D3D_UpdateTextureInternal(data->vtexture, texture->format, full_texture, rect->x / 2, rect->y / 2, rect->w / 2, rect->h / 2, Vplane, Vpitch) < 0) {
+        return -1;
+    }
+    renderer->stats.bytes_uploaded += (Uint64) rect->w * rect->h +
+                                      2 * (Uint64) (rect->w / 2) * (rect->h / 2);
     return 0;
 }
 
@@ -1113,6 +1155,7 @@ D3D_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
         if (FAILED(result)) {
             return D3D_SetError("LockRect()", result);
         }
+        data->locked_rect = *rect;
         *pixels = locked.pBits;
         *pitch = locked.Pitch;
     }
@@ -1131,7 +1174,11 @@ D3D_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture)
                       rect->x * SDL_BYTESPERPIXEL(texture->format));
         D3D_UpdateTexture(renderer, texture, rect, pixels, data->pitch);
     } else {
+        const SDL_Rect *rect = &data->locked_rect;
+
         IDirect3DTexture9_UnlockRect(data->texture, 0);
+        renderer->stats.bytes_uploaded +=
+            (Uint64) rect->w * rect->h * SDL_BYTESPERPIXEL(texture->format);
     }
 }
 
@@ -1279,12 +1326,18 @@ D3D_RenderClear(SDL_Renderer * renderer)
     if (FAILED(result)) {
         return D3D_SetError("Clear()", result);
     }
+    ++renderer->stats.draw_calls;
     return 0;
 }
 
 static void
-D3D_SetBlendMode(D3D_RenderData * data, int blendMode)
+D3D_SetBlendMode(SDL_Renderer * renderer, int blendMode)
 {
+    D3D_RenderData *data = (D3D_RenderData *) renderer->driverdata;
+
+    if (!SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_BLENDMODE, blendMode)) {
+        return;
+    }
     switch (blendMode) {
     case SDL_BLENDMODE_NONE:
         IDirect3DDevice9_SetRenderState(data->device, D3DRS_ALPHABLENDENABLE,
@@ -1335,6 +1388,67 @@ D3D_SetBlendMode(D3D_RenderData * data, int blendMode)
     }
 }
 
+/* Bind a texture to the first stage and its planes to the next two, or
+   NULL for untextured drawing */
+static int
+D3D_SetTexture(SDL_Renderer * renderer, D3D_TextureData * texturedata)
+{
+    D3D_RenderData *data = (D3D_RenderData *) renderer->driverdata;
+    IDirect3DTexture9 *texture = texturedata ? texturedata->texture : NULL;
+    HRESULT result;
+
+    if (!SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_TEXTURE,
+                               (size_t) texture)) {
+        return 0;
+    }
+
+    result =
+        IDirect3DDevice9_SetTexture(data->device, 0, (IDirect3DBaseTexture9 *)
+                                    texture);
+    if (FAILED(result)) {
+        SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
+        return D3D_SetError("SetTexture()", result);
+    }
+
+    if (texturedata && texturedata->yuv) {
+        result =
+            IDirect3DDevice9_SetTexture(data->device, 1, (IDirect3DBaseTexture9 *)
+                                        texturedata->utexture);
+        if (FAILED(result)) {
+            SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
+            return D3D_SetError("SetTexture()", result);
+        }
+
+        result =
+            IDirect3DDevice9_SetTexture(data->device, 2, (IDirect3DBaseTexture9 *)
+                                        texturedata->vtexture);
+        if (FAILED(result)) {
+            SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
+            return D3D_SetError("SetTexture()", result);
+        }
+    }
+    return 0;
+}
+
+static int
+D3D_SetShader(SDL_Renderer * renderer, LPDIRECT3DPIXELSHADER9 shader)
+{
+    D3D_RenderData *data = (D3D_RenderData *) renderer->driverdata;
+    HRESULT result;
+
+    if (!SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_SHADER,
+                               (size_t) shader)) {
+        return 0;
+    }
+
+    result = IDirect3DDevice9_SetPixelShader(data->device, shader);
+    if (FAILED(result)) {
+        SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_SHADER);
+        return D3D_SetError("SetShader()", result);
+    }
+    return 0;
+}
+
 static int
 D3D_RenderDrawPoints(SDL_Renderer * renderer, const SDL_FPoint * points,
                      int count)
@@ -1349,13 +1463,13 @@ D3D_RenderDrawPoints(SDL_Renderer * renderer, const SDL_FPoint * points,
         return -1;
     }
 
-    D3D_SetBlendMode(data, renderer->blendMode);
+    D3D_SetBlendMode(renderer, renderer->blendMode);
 
-    result =
-        IDirect3DDevice9_SetTexture(data->device, 0,
-                                    (IDirect3DBaseTexture9 *) 0);
-    if (FAILED(result)) {
-        return D3D_SetError("SetTexture()", result);
+    if (D3D_SetTexture(renderer, NULL) < 0) {
+        return -1;
+    }
+    if (D3D_SetShader(renderer, NULL) < 0) {
+        return -1;
     }
 
     color = D3DCOLOR_ARGB(renderer->a, renderer->r, renderer->g, renderer->b);
@@ -1376,6 +1490,7 @@ D3D_RenderDrawPoints(SDL_Renderer * renderer, const SDL_FPoint * points,
     if (FAILED(result)) {
         return D3D_SetError("DrawPrimitiveUP()", result);
     }
+    ++renderer->stats.draw_calls;
     return 0;
 }
 
@@ -1393,13 +1508,13 @@ D3D_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
         return -1;
     }
 
-    D3D_SetBlendMode(data, renderer->blendMode);
+    D3D_SetBlendMode(renderer, renderer->blendMode);
 
-    result =
-        IDirect3DDevice9_SetTexture(data->device, 0,
-                                    (IDirect3DBaseTexture9 *) 0);
-    if (FAILED(result)) {
-        return D3D_SetError("SetTexture()", result);
+    if (D3D_SetTexture(renderer, NULL) < 0) {
+        return -1;
+    }
+    if (D3D_SetShader(renderer, NULL) < 0) {
+        return -1;
     }
 
     color = D3DCOLOR_ARGB(renderer->a, renderer->r, renderer->g, renderer->b);
@@ -1416,6 +1531,7 @@ D3D_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
     result =
         IDirect3DDevice9_DrawPrimitiveUP(data->device, D3DPT_LINESTRIP, count-1,
                                          vertices, sizeof(*vertices));
+    ++renderer->stats.draw_calls;
 
     /* DirectX 9 has the same line rasterization semantics as GDI,
        so we need to close the endpoint of the line */
@@ -1424,6 +1540,7 @@ D3D_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
         vertices[0].x = points[count-1].x;
         vertices[0].y = points[count-1].y;
         result = IDirect3DDevice9_DrawPrimitiveUP(data->device, D3DPT_POINTLIST, 1, vertices, sizeof(*vertices));
+        ++renderer->stats.draw_calls;
     }
 
     SDL_stack_free(vertices);
@@ -1448,13 +1565,13 @@ D3D_RenderFillRects(SDL_Renderer * renderer, const SDL_FRect * rects,
         return -1;
     }
 
-    D3D_SetBlendMode(data, renderer->blendMode);
+    D3D_SetBlendMode(renderer, renderer->blendMode);
 
-    result =
-        IDirect3DDevice9_SetTexture(data->device, 0,
-                                    (IDirect3DBaseTexture9 *) 0);
-    if (FAILED(result)) {
-        return D3D_SetError("SetTexture()", result);
+    if (D3D_SetTexture(renderer, NULL) < 0) {
+        return -1;
+    }
+    if (D3D_SetShader(renderer, NULL) < 0) {
+        return -1;
     }
 
     color = D3DCOLOR_ARGB(renderer->a, renderer->r, renderer->g, renderer->b);
@@ -1501,19 +1618,23 @@ D3D_RenderFillRects(SDL_Renderer * renderer, const SDL_FRect * rects,
         if (FAILED(result)) {
             return D3D_SetError("DrawPrimitiveUP()", result);
         }
+        ++renderer->stats.draw_calls;
     }
     return 0;
 }
 
 static void
-D3D_UpdateTextureScaleMode(D3D_RenderData *data, D3D_TextureData *texturedata, unsigned index)
+D3D_UpdateTextureScaleMode(SDL_Renderer * renderer, D3D_TextureData *texturedata, unsigned index)
 {
+    D3D_RenderData *data = (D3D_RenderData *) renderer->driverdata;
+
     if (texturedata->scaleMode != data->scaleMode[index]) {
         IDirect3DDevice9_SetSamplerState(data->device, index, D3DSAMP_MINFILTER,
                                          texturedata->scaleMode);
         IDirect3DDevice9_SetSamplerState(data->device, index, D3DSAMP_MAGFILTER,
                                          texturedata->scaleMode);
         data->scaleMode[index] = texturedata->scaleMode;
+        ++renderer->stats.state_changes;
     }
 }
 
@@ -1574,56 +1695,31 @@ D3D_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     vertices[3].u = minu;
     vertices[3].v = maxv;
 
-    D3D_SetBlendMode(data, texture->blendMode);
+    D3D_SetBlendMode(renderer, texture->blendMode);
 
-    D3D_UpdateTextureScaleMode(data, texturedata, 0);
-
-    result =
-        IDirect3DDevice9_SetTexture(data->device, 0, (IDirect3DBaseTexture9 *)
-                                    texturedata->texture);
-    if (FAILED(result)) {
-        return D3D_SetError("SetTexture()", result);
-    }
+    D3D_UpdateTextureScaleMode(renderer, texturedata, 0);
 
     if (texturedata->yuv) {
         shader = data->ps_yuv;
 
-        D3D_UpdateTextureScaleMode(data, texturedata, 1);
-        D3D_UpdateTextureScaleMode(data, texturedata, 2);
-
-        result =
-            IDirect3DDevice9_SetTexture(data->device, 1, (IDirect3DBaseTexture9 *)
-                                        texturedata->utexture);
-        if (FAILED(result)) {
-            return D3D_SetError("SetTexture()", result);
-        }
-
-        result =
-            IDirect3DDevice9_SetTexture(data->device, 2, (IDirect3DBaseTexture9 *)
-                                        texturedata->vtexture);
-        if (FAILED(result)) {
-            return D3D_SetError("SetTexture()", result);
-        }
+        D3D_UpdateTextureScaleMode(renderer, texturedata, 1);
+        D3D_UpdateTextureScaleMode(renderer, texturedata, 2);
     }
 
-    if (shader) {
-        result = IDirect3DDevice9_SetPixelShader(data->device, shader);
-        if (FAILED(result)) {
-            return D3D_SetError("SetShader()", result);
-        }
+    if (D3D_SetTexture(renderer, texturedata) < 0) {
+        return -1;
     }
+    if (D3D_SetShader(renderer, shader) < 0) {
+        return -1;
+    }
+
     result =
         IDirect3DDevice9_DrawPrimitiveUP(data->device, D3DPT_TRIANGLEFAN, 2,
                                          vertices, sizeof(*vertices));
     if (FAILED(result)) {
         return D3D_SetError("DrawPrimitiveUP()", result);
     }
-    if (shader) {
-        result = IDirect3DDevice9_SetPixelShader(data->device, NULL);
-        if (FAILED(result)) {
-            return D3D_SetError("SetShader()", result);
-        }
-    }
+    ++renderer->stats.draw_calls;
     return 0;
 }
 
@@ -1703,7 +1799,7 @@ D3D_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     vertices[3].u = minu;
     vertices[3].v = maxv;
 
-    D3D_SetBlendMode(data, texture->blendMode);
+    D3D_SetBlendMode(renderer, texture->blendMode);
 
     /* Rotate and translate */
     ID3DXMatrixStack_Push(data->matrixStack);
@@ -1712,54 +1808,29 @@ D3D_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     ID3DXMatrixStack_Translate(data->matrixStack, (float)dstrect->x + centerx, (float)dstrect->y + centery, (float)0.0);
     IDirect3DDevice9_SetTransform(data->device, D3DTS_VIEW, (D3DMATRIX*)ID3DXMatrixStack_GetTop(data->matrixStack));
 
-    D3D_UpdateTextureScaleMode(data, texturedata, 0);
-
-    result =
-        IDirect3DDevice9_SetTexture(data->device, 0, (IDirect3DBaseTexture9 *)
-                                    texturedata->texture);
-    if (FAILED(result)) {
-        return D3D_SetError("SetTexture()", result);
-    }
+    D3D_UpdateTextureScaleMode(renderer, texturedata, 0);
 
     if (texturedata->yuv) {
         shader = data->ps_yuv;
 
-        D3D_UpdateTextureScaleMode(data, texturedata, 1);
-        D3D_UpdateTextureScaleMode(data, texturedata, 2);
-
-        result =
-            IDirect3DDevice9_SetTexture(data->device, 1, (IDirect3DBaseTexture9 *)
-                                        texturedata->utexture);
-        if (FAILED(result)) {
-            return D3D_SetError("SetTexture()", result);
-        }
-
-        result =
-            IDirect3DDevice9_SetTexture(data->device, 2, (IDirect3DBaseTexture9 *)
-                                        texturedata->vtexture);
-        if (FAILED(result)) {
-            return D3D_SetError("SetTexture()", result);
-        }
+        D3D_UpdateTextureScaleMode(renderer, texturedata, 1);
+        D3D_UpdateTextureScaleMode(renderer, texturedata, 2);
     }
 
-    if (shader) {
-        result = IDirect3DDevice9_SetPixelShader(data->device, shader);
-        if (FAILED(result)) {
-            return D3D_SetError("SetShader()", result);
-        }
+    if (D3D_SetTexture(renderer, texturedata) < 0) {
+        return -1;
+    }
+    if (D3D_SetShader(renderer, shader) < 0) {
+        return -1;
     }
+
     result =
         IDirect3DDevice9_DrawPrimitiveUP(data->device, D3DPT_TRIANGLEFAN, 2,
                                          vertices, sizeof(*vertices));
     if (FAILED(result)) {
         return D3D_SetError("DrawPrimitiveUP()", result);
     }
-    if (shader) {
-        result = IDirect3DDevice9_SetPixelShader(data->device, NULL);
-        if (FAILED(result)) {
-            return D3D_SetError("SetShader()", result);
-        }
-    }
+    ++renderer->stats.draw_calls;
     ID3DXMatrixStack_Pop(data->matrixStack);
     ID3DXMatrixStack_Push(data->matrixStack);
     ID3DXMatrixStack_LoadIdentity(data->matrixStack);
@@ -1863,6 +1934,7 @@ D3D_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     }
     if (data->texture) {
         IDirect3DTexture9_Release(data->texture);
+        SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
     }
     if (data->utexture) {
         IDirect3DTexture9_Release(data->utexture);
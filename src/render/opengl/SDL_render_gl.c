@@ -49,12 +49,21 @@ static void GL_WindowEvent(SDL_Renderer * renderer,
                            const SDL_WindowEvent *event);
 static int GL_GetOutputSize(SDL_Renderer * renderer, int *w, int *h);
 static int GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture);
+static int GL_SetTextureDistanceField(SDL_Renderer * renderer,
+                                      SDL_Texture * texture);
 static int GL_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                             const SDL_Rect * rect, const void *pixels,
                             int pitch);
+static int GL_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
+                               const SDL_Rect * rect,
+                               const Uint8 *Yplane, int Ypitch,
+                               const Uint8 *Uplane, int Upitch,
+                               const Uint8 *Vplane, int Vpitch);
 static int GL_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                           const SDL_Rect * rect, void **pixels, int *pitch);
 static void GL_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture);
+static void GL_UnlockTextureRects(SDL_Renderer * renderer, SDL_Texture * texture,
+                                  const SDL_Rect * rects, int count);
 static int GL_SetRenderTarget(SDL_Renderer * renderer, SDL_Texture * texture);
 static int GL_UpdateViewport(SDL_Renderer * renderer);
 static int GL_UpdateClipRect(SDL_Renderer * renderer);
@@ -72,6 +81,12 @@ static int GL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
                          const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip);
 static int GL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                                Uint32 pixel_format, void * pixels, int pitch);
+static int GL_StartReadback(SDL_Renderer * renderer,
+                            SDL_RenderReadback * readback);
+static int GL_FinishReadback(SDL_Renderer * renderer,
+                             SDL_RenderReadback * readback, SDL_bool wait);
+static void GL_DestroyReadback(SDL_Renderer * renderer,
+                               SDL_RenderReadback * readback);
 static void GL_RenderPresent(SDL_Renderer * renderer);
 static void GL_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture);
 static void GL_DestroyRenderer(SDL_Renderer * renderer);
@@ -110,11 +125,6 @@ typedef struct
     GLvoid *next_error_userparam;
 
     SDL_bool GL_ARB_texture_rectangle_supported;
-    struct {
-        GL_Shader shader;
-        Uint32 color;
-        int blendMode;
-    } current;
 
     SDL_bool GL_EXT_framebuffer_object_supported;
     GL_FBOList *framebuffers;
@@ -135,6 +145,20 @@ typedef struct
     PFNGLBINDFRAMEBUFFEREXTPROC glBindFramebufferEXT;
     PFNGLCHECKFRAMEBUFFERSTATUSEXTPROC glCheckFramebufferStatusEXT;
 
+    /* Asynchronous readback support */
+    SDL_bool GL_ARB_pixel_buffer_object_supported;
+    PFNGLGENBUFFERSARBPROC glGenBuffersARB;
+    PFNGLDELETEBUFFERSARBPROC glDeleteBuffersARB;
+    PFNGLBINDBUFFERARBPROC glBindBufferARB;
+    PFNGLBUFFERDATAARBPROC glBufferDataARB;
+    PFNGLMAPBUFFERARBPROC glMapBufferARB;
+    PFNGLUNMAPBUFFERARBPROC glUnmapBufferARB;
+
+    SDL_bool GL_ARB_sync_supported;
+    PFNGLFENCESYNCPROC glFenceSync;
+    PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+    PFNGLDELETESYNCPROC glDeleteSync;
+
     /* Shader support */
     GL_ShaderContext *shaders;
 
@@ -160,6 +184,9 @@ typedef struct
     GL_FBOList *fbo;
 } GL_TextureData;
 
+static void GL_SetTexturing(SDL_Renderer * renderer, SDL_bool enabled);
+static void GL_SetTexture(SDL_Renderer * renderer, GL_TextureData * texturedata);
+
 SDL_FORCE_INLINE const char*
 GL_TranslateError (GLenum error)
 {
@@ -304,9 +331,8 @@ GL_ResetState(SDL_Renderer *renderer)
         GL_ActivateRenderer(renderer);
     }
 
-    data->current.shader = SHADER_NONE;
-    data->current.color = 0;
-    data->current.blendMode = -1;
+    SDL_ResetRenderState(renderer);
+    GL_SetTexturing(renderer, SDL_FALSE);
 
     data->glDisable(GL_DEPTH_TEST);
     data->glDisable(GL_CULL_FACE);
@@ -402,9 +428,12 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->WindowEvent = GL_WindowEvent;
     renderer->GetOutputSize = GL_GetOutputSize;
     renderer->CreateTexture = GL_CreateTexture;
+    renderer->SetTextureDistanceField = GL_SetTextureDistanceField;
     renderer->UpdateTexture = GL_UpdateTexture;
+    renderer->UpdateTextureYUV = GL_UpdateTextureYUV;
     renderer->LockTexture = GL_LockTexture;
     renderer->UnlockTexture = GL_UnlockTexture;
+    renderer->UnlockTextureRects = GL_UnlockTextureRects;
     renderer->SetRenderTarget = GL_SetRenderTarget;
     renderer->UpdateViewport = GL_UpdateViewport;
     renderer->UpdateClipRect = GL_UpdateClipRect;
@@ -415,6 +444,9 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->RenderCopy = GL_RenderCopy;
     renderer->RenderCopyEx = GL_RenderCopyEx;
     renderer->RenderReadPixels = GL_RenderReadPixels;
+    renderer->StartReadback = GL_StartReadback;
+    renderer->FinishReadback = GL_FinishReadback;
+    renderer->DestroyReadback = GL_DestroyReadback;
     renderer->RenderPresent = GL_RenderPresent;
     renderer->DestroyTexture = GL_DestroyTexture;
     renderer->DestroyRenderer = GL_DestroyRenderer;
@@ -524,6 +556,38 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     }
     data->framebuffers = NULL;
 
+    /* Check for reading pixels into buffer objects, without waiting */
+    if (SDL_GL_ExtensionSupported("GL_ARB_pixel_buffer_object")) {
+        data->glGenBuffersARB = (PFNGLGENBUFFERSARBPROC)
+            SDL_GL_GetProcAddress("glGenBuffersARB");
+        data->glDeleteBuffersARB = (PFNGLDELETEBUFFERSARBPROC)
+            SDL_GL_GetProcAddress("glDeleteBuffersARB");
+        data->glBindBufferARB = (PFNGLBINDBUFFERARBPROC)
+            SDL_GL_GetProcAddress("glBindBufferARB");
+        data->glBufferDataARB = (PFNGLBUFFERDATAARBPROC)
+            SDL_GL_GetProcAddress("glBufferDataARB");
+        data->glMapBufferARB = (PFNGLMAPBUFFERARBPROC)
+            SDL_GL_GetProcAddress("glMapBufferARB");
+        data->glUnmapBufferARB = (PFNGLUNMAPBUFFERARBPROC)
+            SDL_GL_GetProcAddress("glUnmapBufferARB");
+        if (data->glGenBuffersARB && data->glDeleteBuffersARB &&
+            data->glBindBufferARB && data->glBufferDataARB &&
+            data->glMapBufferARB && data->glUnmapBufferARB) {
+            data->GL_ARB_pixel_buffer_object_supported = SDL_TRUE;
+        }
+    }
+    if (SDL_GL_ExtensionSupported("GL_ARB_sync")) {
+        data->glFenceSync = (PFNGLFENCESYNCPROC)
+            SDL_GL_GetProcAddress("glFenceSync");
+        data->glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)
+            SDL_GL_GetProcAddress("glClientWaitSync");
+        data->glDeleteSync = (PFNGLDELETESYNCPROC)
+            SDL_GL_GetProcAddress("glDeleteSync");
+        if (data->glFenceSync && data->glClientWaitSync && data->glDeleteSync) {
+            data->GL_ARB_sync_supported = SDL_TRUE;
+        }
+    }
+
     /* Set up parameters for rendering */
     GL_ResetState(renderer);
 
@@ -665,7 +729,6 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     data->format = format;
     data->formattype = type;
     scaleMode = GetScaleQuality();
-    renderdata->glEnable(data->type);
     renderdata->glBindTexture(data->type, data->texture);
     renderdata->glTexParameteri(data->type, GL_TEXTURE_MIN_FILTER, scaleMode);
     renderdata->glTexParameteri(data->type, GL_TEXTURE_MAG_FILTER, scaleMode);
@@ -712,7 +775,7 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
         renderdata->glTexImage2D(data->type, 0, internalFormat, texture_w,
                                  texture_h, 0, format, type, NULL);
     }
-    renderdata->glDisable(data->type);
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
     if (GL_CheckError("glTexImage2D()", renderer) < 0) {
         return -1;
     }
@@ -723,7 +786,6 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 
         renderdata->glGenTextures(1, &data->utexture);
         renderdata->glGenTextures(1, &data->vtexture);
-        renderdata->glEnable(data->type);
 
         renderdata->glBindTexture(data->type, data->utexture);
         renderdata->glTexParameteri(data->type, GL_TEXTURE_MIN_FILTER,
@@ -748,13 +810,35 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
                                     GL_CLAMP_TO_EDGE);
         renderdata->glTexImage2D(data->type, 0, internalFormat, texture_w/2,
                                  texture_h/2, 0, format, type, NULL);
-
-        renderdata->glDisable(data->type);
     }
 
     return GL_CheckError("", renderer);
 }
 
+/* Distance fields are always sampled with linear filtering */
+static int
+GL_SetTextureDistanceField(SDL_Renderer * renderer, SDL_Texture * texture)
+{
+    GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
+    GL_TextureData *data = (GL_TextureData *) texture->driverdata;
+    GLenum scaleMode;
+
+    if (texture->distanceSpread && !renderdata->shaders) {
+        return SDL_SetError("Distance fields need OpenGL shaders");
+    }
+    if (texture->distanceSpread && data->yuv) {
+        return SDL_SetError("YUV textures can't be distance fields");
+    }
+
+    GL_ActivateRenderer(renderer);
+
+    scaleMode = texture->distanceSpread ? GL_LINEAR : GetScaleQuality();
+    GL_SetTexture(renderer, data);
+    renderdata->glTexParameteri(data->type, GL_TEXTURE_MIN_FILTER, scaleMode);
+    renderdata->glTexParameteri(data->type, GL_TEXTURE_MAG_FILTER, scaleMode);
+    return GL_CheckError("glTexParameteri()", renderer);
+}
+
 static int
 GL_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                  const SDL_Rect * rect, const void *pixels, int pitch)
@@ -764,14 +848,15 @@ GL_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
 
     GL_ActivateRenderer(renderer);
 
-    renderdata->glEnable(data->type);
-    renderdata->glBindTexture(data->type, data->texture);
+    GL_SetTexture(renderer, data);
     renderdata->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     renderdata->glPixelStorei(GL_UNPACK_ROW_LENGTH,
                               (pitch / SDL_BYTESPERPIXEL(texture->format)));
     renderdata->glTexSubImage2D(data->type, 0, rect->x, rect->y, rect->w,
                                 rect->h, data->format, data->formattype,
                                 pixels);
+    renderer->stats.bytes_uploaded +=
+        (Uint64) rect->w * rect->h * SDL_BYTESPERPIXEL(texture->format);
     if (data->yuv) {
         renderdata->glPixelStorei(GL_UNPACK_ROW_LENGTH, (pitch / 2));
 
@@ -796,8 +881,49 @@ GL_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
         renderdata->glTexSubImage2D(data->type, 0, rect->x/2, rect->y/2,
                                     rect->w/2, rect->h/2,
                                     data->format, data->formattype, pixels);
+
+        /* The planes were bound in place of the Y plane */
+        SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
+        renderer->stats.bytes_uploaded += 2 * (Uint64) (rect->w/2) * (rect->h/2);
     }
-    renderdata->glDisable(data->type);
+    return GL_CheckError("glTexSubImage2D()", renderer);
+}
+
+static int
+GL_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
+                    const SDL_Rect * rect,
+                    const Uint8 *Yplane, int Ypitch,
+                    const Uint8 *Uplane, int Upitch,
+                    const Uint8 *Vplane, int Vpitch)
+{
+    GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
+    GL_TextureData *data = (GL_TextureData *) texture->driverdata;
+
+    GL_ActivateRenderer(renderer);
+
+    GL_SetTexture(renderer, data);
+    renderdata->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    renderdata->glPixelStorei(GL_UNPACK_ROW_LENGTH, Ypitch);
+    renderdata->glTexSubImage2D(data->type, 0, rect->x, rect->y, rect->w,
+                                rect->h, data->format, data->formattype,
+                                Yplane);
+
+    renderdata->glPixelStorei(GL_UNPACK_ROW_LENGTH, Upitch);
+    renderdata->glBindTexture(data->type, data->utexture);
+    renderdata->glTexSubImage2D(data->type, 0, rect->x/2, rect->y/2,
+                                rect->w/2, rect->h/2,
+                                data->format, data->formattype, Uplane);
+
+    renderdata->glPixelStorei(GL_UNPACK_ROW_LENGTH, Vpitch);
+    renderdata->glBindTexture(data->type, data->vtexture);
+    renderdata->glTexSubImage2D(data->type, 0, rect->x/2, rect->y/2,
+                                rect->w/2, rect->h/2,
+                                data->format, data->formattype, Vplane);
+
+    /* The planes were bound in place of the Y plane */
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
+    renderer->stats.bytes_uploaded += (Uint64) rect->w * rect->h +
+                                      2 * (Uint64) (rect->w/2) * (rect->h/2);
     return GL_CheckError("glTexSubImage2D()", renderer);
 }
 
@@ -829,6 +955,28 @@ GL_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     GL_UpdateTexture(renderer, texture, rect, pixels, data->pitch);
 }
 
+static void
+GL_UnlockTextureRects(SDL_Renderer * renderer, SDL_Texture * texture,
+                      const SDL_Rect * rects, int count)
+{
+    GL_TextureData *data = (GL_TextureData *) texture->driverdata;
+    int i;
+
+    if (data->yuv) {
+        /* The planes are uploaded together */
+        GL_UnlockTexture(renderer, texture);
+        return;
+    }
+
+    for (i = 0; i < count; ++i) {
+        const SDL_Rect *rect = &rects[i];
+        void *pixels =
+            (void *) ((Uint8 *) data->pixels + rect->y * data->pitch +
+                      rect->x * SDL_BYTESPERPIXEL(texture->format));
+        GL_UpdateTexture(renderer, texture, rect, pixels, data->pitch);
+    }
+}
+
 static int
 GL_SetRenderTarget(SDL_Renderer * renderer, SDL_Texture * texture)
 {
@@ -904,32 +1052,36 @@ GL_UpdateClipRect(SDL_Renderer * renderer)
 }
 
 static void
-GL_SetShader(GL_RenderData * data, GL_Shader shader)
+GL_SetShader(SDL_Renderer * renderer, GL_Shader shader)
 {
-    if (data->shaders && shader != data->current.shader) {
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+
+    if (data->shaders &&
+        SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_SHADER, shader)) {
         GL_SelectShader(data->shaders, shader);
-        data->current.shader = shader;
     }
 }
 
 static void
-GL_SetColor(GL_RenderData * data, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+GL_SetColor(SDL_Renderer * renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
     Uint32 color = ((a << 24) | (r << 16) | (g << 8) | b);
 
-    if (color != data->current.color) {
+    if (SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_COLOR, color)) {
         data->glColor4f((GLfloat) r * inv255f,
                         (GLfloat) g * inv255f,
                         (GLfloat) b * inv255f,
                         (GLfloat) a * inv255f);
-        data->current.color = color;
     }
 }
 
 static void
-GL_SetBlendMode(GL_RenderData * data, int blendMode)
+GL_SetBlendMode(SDL_Renderer * renderer, int blendMode)
 {
-    if (blendMode != data->current.blendMode) {
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+
+    if (SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_BLENDMODE, blendMode)) {
         switch (blendMode) {
         case SDL_BLENDMODE_NONE:
             data->glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
@@ -951,10 +1103,47 @@ GL_SetBlendMode(GL_RenderData * data, int blendMode)
             data->glBlendFuncSeparate(GL_ZERO, GL_SRC_COLOR, GL_ZERO, GL_ONE);
             break;
         }
-        data->current.blendMode = blendMode;
     }
 }
 
+/* All textures are of the one type the renderer supports */
+static void
+GL_SetTexturing(SDL_Renderer * renderer, SDL_bool enabled)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GLenum type = data->GL_ARB_texture_rectangle_supported ?
+                  GL_TEXTURE_RECTANGLE_ARB : GL_TEXTURE_2D;
+
+    if (SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_TEXTURING, enabled)) {
+        if (enabled) {
+            data->glEnable(type);
+        } else {
+            data->glDisable(type);
+        }
+    }
+}
+
+static void
+GL_SetTexture(SDL_Renderer * renderer, GL_TextureData * texturedata)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+
+    if (!SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_TEXTURE,
+                               texturedata->texture)) {
+        return;
+    }
+    if (texturedata->yuv) {
+        data->glActiveTextureARB(GL_TEXTURE2_ARB);
+        data->glBindTexture(texturedata->type, texturedata->vtexture);
+
+        data->glActiveTextureARB(GL_TEXTURE1_ARB);
+        data->glBindTexture(texturedata->type, texturedata->utexture);
+
+        data->glActiveTextureARB(GL_TEXTURE0_ARB);
+    }
+    data->glBindTexture(texturedata->type, texturedata->texture);
+}
+
 static void
 GL_SetDrawingState(SDL_Renderer * renderer)
 {
@@ -962,14 +1151,16 @@ GL_SetDrawingState(SDL_Renderer * renderer)
 
     GL_ActivateRenderer(renderer);
 
-    GL_SetColor(data, renderer->r,
-                      renderer->g,
-                      renderer->b,
-                      renderer->a);
+    GL_SetTexturing(renderer, SDL_FALSE);
+
+    GL_SetColor(renderer, renderer->r,
+                          renderer->g,
+                          renderer->b,
+                          renderer->a);
 
-    GL_SetBlendMode(data, renderer->blendMode);
+    GL_SetBlendMode(renderer, renderer->blendMode);
 
-    GL_SetShader(data, SHADER_SOLID);
+    GL_SetShader(renderer, SHADER_SOLID);
 }
 
 static int
@@ -985,6 +1176,7 @@ GL_RenderClear(SDL_Renderer * renderer)
                        (GLfloat) renderer->a * inv255f);
 
     data->glClear(GL_COLOR_BUFFER_BIT);
+    ++renderer->stats.draw_calls;
 
     return 0;
 }
@@ -1003,6 +1195,7 @@ GL_RenderDrawPoints(SDL_Renderer * renderer, const SDL_FPoint * points,
         data->glVertex2f(0.5f + points[i].x, 0.5f + points[i].y);
     }
     data->glEnd();
+    ++renderer->stats.draw_calls;
 
     return 0;
 }
@@ -1025,6 +1218,7 @@ GL_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
             data->glVertex2f(0.5f + points[i].x, 0.5f + points[i].y);
         }
         data->glEnd();
+        ++renderer->stats.draw_calls;
     } else {
 #if defined(__APPLE__) || defined(__WIN32__)
 #else
@@ -1066,6 +1260,7 @@ GL_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
         }
 #endif
         data->glEnd();
+        renderer->stats.draw_calls += 2;
     }
     return GL_CheckError("", renderer);
 }
@@ -1083,9 +1278,33 @@ GL_RenderFillRects(SDL_Renderer * renderer, const SDL_FRect * rects, int count)
 
         data->glRectf(rect->x, rect->y, rect->x + rect->w, rect->y + rect->h);
     }
+    renderer->stats.draw_calls += count;
     return GL_CheckError("", renderer);
 }
 
+/* The coverage of a distance field edge depends on the scale of the copy */
+static void
+GL_SetCopyShader(SDL_Renderer * renderer, SDL_Texture * texture,
+                 const SDL_Rect * srcrect, const SDL_FRect * dstrect)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_TextureData *texturedata = (GL_TextureData *) texture->driverdata;
+
+    if (texturedata->yuv) {
+        GL_SetShader(renderer, SHADER_YV12);
+    } else if (texture->distanceSpread) {
+        const double scale = SDL_sqrt(((double) dstrect->w * dstrect->h) /
+                                      ((double) srcrect->w * srcrect->h));
+
+        GL_SetShader(renderer, SHADER_SDF);
+        GL_SetDistanceField(data->shaders,
+                            (float) texture->distanceThreshold * inv255f,
+                            (float) (2.0 * texture->distanceSpread * scale));
+    } else {
+        GL_SetShader(renderer, SHADER_RGB);
+    }
+}
+
 static int
 GL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
               const SDL_Rect * srcrect, const SDL_FRect * dstrect)
@@ -1097,31 +1316,18 @@ GL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
 
     GL_ActivateRenderer(renderer);
 
-    data->glEnable(texturedata->type);
-    if (texturedata->yuv) {
-        data->glActiveTextureARB(GL_TEXTURE2_ARB);
-        data->glBindTexture(texturedata->type, texturedata->vtexture);
-
-        data->glActiveTextureARB(GL_TEXTURE1_ARB);
-        data->glBindTexture(texturedata->type, texturedata->utexture);
-
-        data->glActiveTextureARB(GL_TEXTURE0_ARB);
-    }
-    data->glBindTexture(texturedata->type, texturedata->texture);
+    GL_SetTexturing(renderer, SDL_TRUE);
+    GL_SetTexture(renderer, texturedata);
 
     if (texture->modMode) {
-        GL_SetColor(data, texture->r, texture->g, texture->b, texture->a);
+        GL_SetColor(renderer, texture->r, texture->g, texture->b, texture->a);
     } else {
-        GL_SetColor(data, 255, 255, 255, 255);
+        GL_SetColor(renderer, 255, 255, 255, 255);
     }
 
-    GL_SetBlendMode(data, texture->blendMode);
+    GL_SetBlendMode(renderer, texture->blendMode);
 
-    if (texturedata->yuv) {
-        GL_SetShader(data, SHADER_YV12);
-    } else {
-        GL_SetShader(data, SHADER_RGB);
-    }
+    GL_SetCopyShader(renderer, texture, srcrect, dstrect);
 
     minx = dstrect->x;
     miny = dstrect->y;
@@ -1147,8 +1353,7 @@ GL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     data->glTexCoord2f(maxu, maxv);
     data->glVertex2f(maxx, maxy);
     data->glEnd();
-
-    data->glDisable(texturedata->type);
+    ++renderer->stats.draw_calls;
 
     return GL_CheckError("", renderer);
 }
@@ -1166,31 +1371,18 @@ GL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
 
     GL_ActivateRenderer(renderer);
 
-    data->glEnable(texturedata->type);
-    if (texturedata->yuv) {
-        data->glActiveTextureARB(GL_TEXTURE2_ARB);
-        data->glBindTexture(texturedata->type, texturedata->vtexture);
-
-        data->glActiveTextureARB(GL_TEXTURE1_ARB);
-        data->glBindTexture(texturedata->type, texturedata->utexture);
-
-        data->glActiveTextureARB(GL_TEXTURE0_ARB);
-    }
-    data->glBindTexture(texturedata->type, texturedata->texture);
+    GL_SetTexturing(renderer, SDL_TRUE);
+    GL_SetTexture(renderer, texturedata);
 
     if (texture->modMode) {
-        GL_SetColor(data, texture->r, texture->g, texture->b, texture->a);
+        GL_SetColor(renderer, texture->r, texture->g, texture->b, texture->a);
     } else {
-        GL_SetColor(data, 255, 255, 255, 255);
+        GL_SetColor(renderer, 255, 255, 255, 255);
     }
 
-    GL_SetBlendMode(data, texture->blendMode);
+    GL_SetBlendMode(renderer, texture->blendMode);
 
-    if (texturedata->yuv) {
-        GL_SetShader(data, SHADER_YV12);
-    } else {
-        GL_SetShader(data, SHADER_RGB);
-    }
+    GL_SetCopyShader(renderer, texture, srcrect, dstrect);
 
     centerx = center->x;
     centery = center->y;
@@ -1238,8 +1430,7 @@ GL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     data->glVertex2f(maxx, maxy);
     data->glEnd();
     data->glPopMatrix();
-
-    data->glDisable(texturedata->type);
+    ++renderer->stats.draw_calls;
 
     return GL_CheckError("", renderer);
 }
@@ -1302,6 +1493,147 @@ GL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
     return status;
 }
 
+/* A read into a pixel buffer object, finished when it's mapped */
+typedef struct
+{
+    GLuint buffer;
+    GLsync fence;
+} GL_ReadbackData;
+
+static int
+GL_StartReadback(SDL_Renderer * renderer, SDL_RenderReadback * readback)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    const SDL_Rect *rect = &readback->rect;
+    GL_ReadbackData *readdata;
+    GLint internalFormat;
+    GLenum format, type;
+    int w, h, size;
+
+    GL_ActivateRenderer(renderer);
+
+    /* Pixels come back in the renderer's format, bottom-up */
+    readback->src_format = SDL_PIXELFORMAT_ARGB8888;
+    readback->src_pitch = rect->w * SDL_BYTESPERPIXEL(readback->src_format);
+    readback->src_flipped = SDL_TRUE;
+    size = rect->h * readback->src_pitch;
+
+    convert_format(data, readback->src_format, &internalFormat, &format, &type);
+
+    SDL_GetRendererOutputSize(renderer, &w, &h);
+
+    data->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    data->glPixelStorei(GL_PACK_ROW_LENGTH, rect->w);
+
+    if (!data->GL_ARB_pixel_buffer_object_supported) {
+        /* Read now, only the flip and conversion are done later */
+        readback->src_pixels = SDL_malloc(size);
+        if (!readback->src_pixels) {
+            return SDL_OutOfMemory();
+        }
+        data->glReadPixels(rect->x, (h-rect->y)-rect->h, rect->w, rect->h,
+                           format, type, readback->src_pixels);
+        return GL_CheckError("glReadPixels()", renderer);
+    }
+
+    readdata = (GL_ReadbackData *) SDL_calloc(1, sizeof(*readdata));
+    if (!readdata) {
+        return SDL_OutOfMemory();
+    }
+    readback->driverdata = readdata;
+
+    GL_CheckError("", renderer);
+    data->glGenBuffersARB(1, &readdata->buffer);
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, readdata->buffer);
+    data->glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, size, NULL, GL_STREAM_READ_ARB);
+    data->glReadPixels(rect->x, (h-rect->y)-rect->h, rect->w, rect->h,
+                       format, type, NULL);
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+    if (data->GL_ARB_sync_supported) {
+        readdata->fence = data->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    if (GL_CheckError("glReadPixels()", renderer) < 0) {
+        GL_DestroyReadback(renderer, readback);
+        return -1;
+    }
+    return 0;
+}
+
+static int
+GL_FinishReadback(SDL_Renderer * renderer, SDL_RenderReadback * readback,
+                  SDL_bool wait)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_ReadbackData *readdata = (GL_ReadbackData *) readback->driverdata;
+    const int size = readback->rect.h * readback->src_pitch;
+    void *mapped;
+
+    if (!readdata) {
+        return 1;
+    }
+
+    GL_ActivateRenderer(renderer);
+
+    if (!wait) {
+        /* Mapping the buffer would wait for the copy, so check that it's
+           done, or without fences that a couple of frames have gone by.
+         */
+        if (readdata->fence) {
+            GLenum status = data->glClientWaitSync(readdata->fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED &&
+                status != GL_CONDITION_SATISFIED) {
+                return 0;
+            }
+        } else if (renderer->frame_count - readback->frame < 2) {
+            return 0;
+        }
+    }
+
+    readback->src_pixels = SDL_malloc(size);
+    if (!readback->src_pixels) {
+        GL_DestroyReadback(renderer, readback);
+        return SDL_OutOfMemory();
+    }
+
+    GL_CheckError("", renderer);
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, readdata->buffer);
+    mapped = data->glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB);
+    if (mapped) {
+        SDL_memcpy(readback->src_pixels, mapped, size);
+        data->glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
+    }
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+    GL_DestroyReadback(renderer, readback);
+
+    if (!mapped) {
+        GL_CheckError("glMapBufferARB()", renderer);
+        return SDL_SetError("Couldn't map the pixel buffer");
+    }
+    return 1;
+}
+
+static void
+GL_DestroyReadback(SDL_Renderer * renderer, SDL_RenderReadback * readback)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_ReadbackData *readdata = (GL_ReadbackData *) readback->driverdata;
+
+    if (!readdata) {
+        return;
+    }
+
+    GL_ActivateRenderer(renderer);
+
+    if (readdata->fence) {
+        data->glDeleteSync(readdata->fence);
+    }
+    if (readdata->buffer) {
+        data->glDeleteBuffersARB(1, &readdata->buffer);
+    }
+    SDL_free(readdata);
+    readback->driverdata = NULL;
+}
+
 static void
 GL_RenderPresent(SDL_Renderer * renderer)
 {
@@ -1323,6 +1655,7 @@ GL_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     }
     if (data->texture) {
         renderdata->glDeleteTextures(1, &data->texture);
+        SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
     }
     if (data->yuv) {
         renderdata->glDeleteTextures(1, &data->utexture);
@@ -1385,6 +1718,10 @@ GL_BindTexture (SDL_Renderer * renderer, SDL_Texture *texture, float *texw, floa
     }
     data->glBindTexture(texturedata->type, texturedata->texture);
 
+    /* The application may change the texture state before we draw again */
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURING);
+
     if(texw) *texw = (float)texturedata->texw;
     if(texh) *texh = (float)texturedata->texh;
 
@@ -1410,6 +1747,9 @@ GL_UnbindTexture (SDL_Renderer * renderer, SDL_Texture *texture)
 
     data->glDisable(texturedata->type);
 
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURING);
+
     return 0;
 }
 
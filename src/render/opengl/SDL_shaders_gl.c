@@ -60,6 +60,12 @@ struct GL_ShaderContext
     SDL_bool GL_ARB_texture_rectangle_supported;
 
     GL_ShaderData shaders[NUM_SHADERS];
+
+    /* The uniforms of SHADER_SDF and their current values */
+    GLint sdf_threshold;
+    GLint sdf_slope;
+    float threshold;
+    float slope;
 };
 
 /*
@@ -162,6 +168,34 @@ static const char *shader_source[NUM_SHADERS][2] =
 "\n"
 "    // That was easy. :) \n"
 "    gl_FragColor = vec4(rgb, 1.0) * v_color;\n"
+"}"
+    },
+
+    /* SHADER_SDF */
+    {
+        /* vertex shader */
+"varying vec4 v_color;\n"
+"varying vec2 v_texCoord;\n"
+"\n"
+"void main()\n"
+"{\n"
+"    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;\n"
+"    v_color = gl_Color;\n"
+"    v_texCoord = vec2(gl_MultiTexCoord0);\n"
+"}",
+        /* fragment shader */
+"varying vec4 v_color;\n"
+"varying vec2 v_texCoord;\n"
+"uniform sampler2D tex0;\n"
+"uniform float threshold; // alpha on the edge \n"
+"uniform float slope;     // output pixels per unit of alpha \n"
+"\n"
+"void main()\n"
+"{\n"
+"    vec4 texel = texture2D(tex0, v_texCoord);\n"
+"    float coverage = clamp((texel.a - threshold) * slope + 0.5, 0.0, 1.0);\n"
+"\n"
+"    gl_FragColor = vec4(texel.rgb, coverage) * v_color;\n"
 "}"
     },
 };
@@ -332,6 +366,11 @@ GL_CreateShaderContext()
         }
     }
 
+    ctx->sdf_threshold = ctx->glGetUniformLocationARB(ctx->shaders[SHADER_SDF].program, "threshold");
+    ctx->sdf_slope = ctx->glGetUniformLocationARB(ctx->shaders[SHADER_SDF].program, "slope");
+    ctx->threshold = -1.0f;
+    ctx->slope = -1.0f;
+
     /* We're done! */
     return ctx;
 }
@@ -342,6 +381,20 @@ GL_SelectShader(GL_ShaderContext *ctx, GL_Shader shader)
     ctx->glUseProgramObjectARB(ctx->shaders[shader].program);
 }
 
+/* SHADER_SDF must be the selected shader */
+void
+GL_SetDistanceField(GL_ShaderContext *ctx, float threshold, float slope)
+{
+    if (threshold != ctx->threshold) {
+        ctx->glUniform1fARB(ctx->sdf_threshold, threshold);
+        ctx->threshold = threshold;
+    }
+    if (slope != ctx->slope) {
+        ctx->glUniform1fARB(ctx->sdf_slope, slope);
+        ctx->slope = slope;
+    }
+}
+
 void
 GL_DestroyShaderContext(GL_ShaderContext *ctx)
 {
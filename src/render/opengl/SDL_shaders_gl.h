@@ -27,6 +27,7 @@ typedef enum {
     SHADER_SOLID,
     SHADER_RGB,
     SHADER_YV12,
+    SHADER_SDF,
     NUM_SHADERS
 } GL_Shader;
 
@@ -34,6 +35,7 @@ typedef struct GL_ShaderContext GL_ShaderContext;
 
 extern GL_ShaderContext * GL_CreateShaderContext();
 extern void GL_SelectShader(GL_ShaderContext *ctx, GL_Shader shader);
+extern void GL_SetDistanceField(GL_ShaderContext *ctx, float threshold, float slope);
 extern void GL_DestroyShaderContext(GL_ShaderContext *ctx);
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -56,6 +56,9 @@ static int GLES_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                             const SDL_Rect * rect, void **pixels, int *pitch);
 static void GLES_UnlockTexture(SDL_Renderer * renderer,
                                SDL_Texture * texture);
+static void GLES_UnlockTextureRects(SDL_Renderer * renderer,
+                                    SDL_Texture * texture,
+                                    const SDL_Rect * rects, int count);
 static int GLES_SetRenderTarget(SDL_Renderer * renderer,
                                  SDL_Texture * texture);
 static int GLES_UpdateViewport(SDL_Renderer * renderer);
@@ -106,11 +109,6 @@ SDL_RenderDriver GLES_RenderDriver = {
 typedef struct
 {
     SDL_GLContext context;
-    struct {
-        Uint32 color;
-        int blendMode;
-        SDL_bool tex_coords;
-    } current;
 
 #define SDL_PROC(ret,func,params) ret (APIENTRY *func) params;
 #define SDL_PROC_OES SDL_PROC
@@ -136,9 +134,14 @@ typedef struct
     GLenum formattype;
     void *pixels;
     int pitch;
+    SDL_Rect locked_rect;
     GLES_FBOList *fbo;
 } GLES_TextureData;
 
+static void GLES_SetTexturing(SDL_Renderer * renderer, SDL_bool enabled);
+static void GLES_SetTexture(SDL_Renderer * renderer,
+                            GLES_TextureData * texturedata);
+
 static int
 GLES_SetError(const char *prefix, GLenum result)
 {
@@ -257,9 +260,7 @@ GLES_ResetState(SDL_Renderer *renderer)
         GLES_ActivateRenderer(renderer);
     }
 
-    data->current.color = 0;
-    data->current.blendMode = -1;
-    data->current.tex_coords = SDL_FALSE;
+    SDL_ResetRenderState(renderer);
 
     data->glDisable(GL_DEPTH_TEST);
     data->glDisable(GL_CULL_FACE);
@@ -268,7 +269,7 @@ GLES_ResetState(SDL_Renderer *renderer)
     data->glLoadIdentity();
 
     data->glEnableClientState(GL_VERTEX_ARRAY);
-    data->glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    GLES_SetTexturing(renderer, SDL_FALSE);
 }
 
 SDL_Renderer *
@@ -311,6 +312,7 @@ GLES_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->UpdateTexture = GLES_UpdateTexture;
     renderer->LockTexture = GLES_LockTexture;
     renderer->UnlockTexture = GLES_UnlockTexture;
+    renderer->UnlockTextureRects = GLES_UnlockTextureRects;
     renderer->SetRenderTarget = GLES_SetRenderTarget;
     renderer->UpdateViewport = GLES_UpdateViewport;
     renderer->UpdateClipRect = GLES_UpdateClipRect;
@@ -487,7 +489,6 @@ GLES_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     
 
     renderdata->glGetError();
-    renderdata->glEnable(GL_TEXTURE_2D);
     renderdata->glGenTextures(1, &data->texture);
     result = renderdata->glGetError();
     if (result != GL_NO_ERROR) {
@@ -513,7 +514,7 @@ GLES_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 
     renderdata->glTexImage2D(data->type, 0, internalFormat, texture_w,
                              texture_h, 0, format, type, NULL);
-    renderdata->glDisable(GL_TEXTURE_2D);
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
 
     result = renderdata->glGetError();
     if (result != GL_NO_ERROR) {
@@ -561,8 +562,7 @@ GLES_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
 
     /* Create a texture subimage with the supplied data */
     renderdata->glGetError();
-    renderdata->glEnable(data->type);
-    renderdata->glBindTexture(data->type, data->texture);
+    GLES_SetTexture(renderer, data);
     renderdata->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     renderdata->glTexSubImage2D(data->type,
                     0,
@@ -574,6 +574,7 @@ GLES_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                     data->formattype,
                     src);
     SDL_free(blob);
+    renderer->stats.bytes_uploaded += (Uint64) srcPitch * rect->h;
 
     if (renderdata->glGetError() != GL_NO_ERROR)
     {
@@ -588,6 +589,7 @@ GLES_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
 {
     GLES_TextureData *data = (GLES_TextureData *) texture->driverdata;
 
+    data->locked_rect = *rect;
     *pixels =
         (void *) ((Uint8 *) data->pixels + rect->y * data->pitch +
                   rect->x * SDL_BYTESPERPIXEL(texture->format));
@@ -599,14 +601,24 @@ static void
 GLES_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
     GLES_TextureData *data = (GLES_TextureData *) texture->driverdata;
-    SDL_Rect rect;
-
-    /* We do whole texture updates, at least for now */
-    rect.x = 0;
-    rect.y = 0;
-    rect.w = texture->w;
-    rect.h = texture->h;
-    GLES_UpdateTexture(renderer, texture, &rect, data->pixels, data->pitch);
+
+    GLES_UnlockTextureRects(renderer, texture, &data->locked_rect, 1);
+}
+
+static void
+GLES_UnlockTextureRects(SDL_Renderer * renderer, SDL_Texture * texture,
+                        const SDL_Rect * rects, int count)
+{
+    GLES_TextureData *data = (GLES_TextureData *) texture->driverdata;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        const SDL_Rect *rect = &rects[i];
+        void *pixels =
+            (void *) ((Uint8 *) data->pixels + rect->y * data->pitch +
+                      rect->x * SDL_BYTESPERPIXEL(texture->format));
+        GLES_UpdateTexture(renderer, texture, rect, pixels, data->pitch);
+    }
 }
 
 static int
@@ -684,23 +696,25 @@ GLES_UpdateClipRect(SDL_Renderer * renderer)
 }
 
 static void
-GLES_SetColor(GLES_RenderData * data, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+GLES_SetColor(SDL_Renderer * renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
+    GLES_RenderData *data = (GLES_RenderData *) renderer->driverdata;
     Uint32 color = ((a << 24) | (r << 16) | (g << 8) | b);
 
-    if (color != data->current.color) {
+    if (SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_COLOR, color)) {
         data->glColor4f((GLfloat) r * inv255f,
                         (GLfloat) g * inv255f,
                         (GLfloat) b * inv255f,
                         (GLfloat) a * inv255f);
-        data->current.color = color;
     }
 }
 
 static void
-GLES_SetBlendMode(GLES_RenderData * data, int blendMode)
+GLES_SetBlendMode(SDL_Renderer * renderer, int blendMode)
 {
-    if (blendMode != data->current.blendMode) {
+    GLES_RenderData *data = (GLES_RenderData *) renderer->driverdata;
+
+    if (SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_BLENDMODE, blendMode)) {
         switch (blendMode) {
         case SDL_BLENDMODE_NONE:
             data->glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
@@ -734,20 +748,34 @@ GLES_SetBlendMode(GLES_RenderData * data, int blendMode)
             }
             break;
         }
-        data->current.blendMode = blendMode;
     }
 }
 
+/* Texturing and the texture coordinate array go on and off together */
 static void
-GLES_SetTexCoords(GLES_RenderData * data, SDL_bool enabled)
+GLES_SetTexturing(SDL_Renderer * renderer, SDL_bool enabled)
 {
-    if (enabled != data->current.tex_coords) {
+    GLES_RenderData *data = (GLES_RenderData *) renderer->driverdata;
+
+    if (SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_TEXTURING, enabled)) {
         if (enabled) {
+            data->glEnable(GL_TEXTURE_2D);
             data->glEnableClientState(GL_TEXTURE_COORD_ARRAY);
         } else {
+            data->glDisable(GL_TEXTURE_2D);
             data->glDisableClientState(GL_TEXTURE_COORD_ARRAY);
         }
-        data->current.tex_coords = enabled;
+    }
+}
+
+static void
+GLES_SetTexture(SDL_Renderer * renderer, GLES_TextureData * texturedata)
+{
+    GLES_RenderData *data = (GLES_RenderData *) renderer->driverdata;
+
+    if (SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_TEXTURE,
+                              texturedata->texture)) {
+        data->glBindTexture(texturedata->type, texturedata->texture);
     }
 }
 
@@ -758,14 +786,14 @@ GLES_SetDrawingState(SDL_Renderer * renderer)
 
     GLES_ActivateRenderer(renderer);
 
-    GLES_SetColor(data, (GLfloat) renderer->r,
-                        (GLfloat) renderer->g,
-                        (GLfloat) renderer->b,
-                        (GLfloat) renderer->a);
+    GLES_SetColor(renderer, (GLfloat) renderer->r,
+                            (GLfloat) renderer->g,
+                            (GLfloat) renderer->b,
+                            (GLfloat) renderer->a);
 
-    GLES_SetBlendMode(data, renderer->blendMode);
+    GLES_SetBlendMode(renderer, renderer->blendMode);
 
-    GLES_SetTexCoords(data, SDL_FALSE);
+    GLES_SetTexturing(renderer, SDL_FALSE);
 }
 
 static int
@@ -781,6 +809,7 @@ GLES_RenderClear(SDL_Renderer * renderer)
                  (GLfloat) renderer->a * inv255f);
 
     data->glClear(GL_COLOR_BUFFER_BIT);
+    ++renderer->stats.draw_calls;
 
     return 0;
 }
@@ -795,6 +824,7 @@ GLES_RenderDrawPoints(SDL_Renderer * renderer, const SDL_FPoint * points,
 
     data->glVertexPointer(2, GL_FLOAT, 0, points);
     data->glDrawArrays(GL_POINTS, 0, count);
+    ++renderer->stats.draw_calls;
 
     return 0;
 }
@@ -813,10 +843,12 @@ GLES_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
         /* GL_LINE_LOOP takes care of the final segment */
         --count;
         data->glDrawArrays(GL_LINE_LOOP, 0, count);
+        ++renderer->stats.draw_calls;
     } else {
         data->glDrawArrays(GL_LINE_STRIP, 0, count);
         /* We need to close the endpoint of the line */
         data->glDrawArrays(GL_POINTS, count-1, 1);
+        renderer->stats.draw_calls += 2;
     }
 
     return 0;
@@ -850,6 +882,7 @@ GLES_RenderFillRects(SDL_Renderer * renderer, const SDL_FRect * rects,
         data->glVertexPointer(2, GL_FLOAT, 0, vertices);
         data->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     }
+    renderer->stats.draw_calls += count;
 
     return 0;
 }
@@ -867,19 +900,17 @@ GLES_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
 
     GLES_ActivateRenderer(renderer);
 
-    data->glEnable(GL_TEXTURE_2D);
+    GLES_SetTexturing(renderer, SDL_TRUE);
 
-    data->glBindTexture(texturedata->type, texturedata->texture);
+    GLES_SetTexture(renderer, texturedata);
 
     if (texture->modMode) {
-        GLES_SetColor(data, texture->r, texture->g, texture->b, texture->a);
+        GLES_SetColor(renderer, texture->r, texture->g, texture->b, texture->a);
     } else {
-        GLES_SetColor(data, 255, 255, 255, 255);
+        GLES_SetColor(renderer, 255, 255, 255, 255);
     }
 
-    GLES_SetBlendMode(data, texture->blendMode);
-
-    GLES_SetTexCoords(data, SDL_TRUE);
+    GLES_SetBlendMode(renderer, texture->blendMode);
 
     if (data->GL_OES_draw_texture_supported && data->useDrawTexture) {
         /* this code is a little funny because the viewport is upside down vs SDL's coordinate system */
@@ -946,7 +977,7 @@ GLES_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
         data->glTexCoordPointer(2, GL_FLOAT, 0, texCoords);
         data->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     }
-    data->glDisable(GL_TEXTURE_2D);
+    ++renderer->stats.draw_calls;
 
     return 0;
 }
@@ -968,19 +999,17 @@ GLES_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
 
     GLES_ActivateRenderer(renderer);
 
-    data->glEnable(GL_TEXTURE_2D);
+    GLES_SetTexturing(renderer, SDL_TRUE);
 
-    data->glBindTexture(texturedata->type, texturedata->texture);
+    GLES_SetTexture(renderer, texturedata);
 
     if (texture->modMode) {
-        GLES_SetColor(data, texture->r, texture->g, texture->b, texture->a);
+        GLES_SetColor(renderer, texture->r, texture->g, texture->b, texture->a);
     } else {
-        GLES_SetColor(data, 255, 255, 255, 255);
+        GLES_SetColor(renderer, 255, 255, 255, 255);
     }
 
-    GLES_SetBlendMode(data, texture->blendMode);
-
-    GLES_SetTexCoords(data, SDL_TRUE);
+    GLES_SetBlendMode(renderer, texture->blendMode);
 
     centerx = center->x;
     centery = center->y;
@@ -1036,7 +1065,7 @@ GLES_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     data->glTexCoordPointer(2, GL_FLOAT, 0, texCoords);
     data->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     data->glPopMatrix();
-    data->glDisable(GL_TEXTURE_2D);
+    ++renderer->stats.draw_calls;
 
     return 0;
 }
@@ -1113,6 +1142,7 @@ GLES_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     }
     if (data->texture) {
         renderdata->glDeleteTextures(1, &data->texture);
+        SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
     }
     SDL_free(data->pixels);
     SDL_free(data);
@@ -1148,6 +1178,10 @@ static int GLES_BindTexture (SDL_Renderer * renderer, SDL_Texture *texture, floa
     data->glEnable(GL_TEXTURE_2D);
     data->glBindTexture(texturedata->type, texturedata->texture);
 
+    /* The application may change the texture state before we draw again */
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURING);
+
     if(texw) *texw = (float)texturedata->texw;
     if(texh) *texh = (float)texturedata->texh;
 
@@ -1161,6 +1195,9 @@ static int GLES_UnbindTexture (SDL_Renderer * renderer, SDL_Texture *texture)
     GLES_ActivateRenderer(renderer);
     data->glDisable(texturedata->type);
 
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURING);
+
     return 0;
 }
 
@@ -72,6 +72,7 @@ typedef struct GLES2_TextureData
     GLenum pixel_type;
     void *pixel_data;
     size_t pitch;
+    SDL_Rect locked_rect;
     GLES2_FBOList *fbo;
 } GLES2_TextureData;
 
@@ -98,6 +99,9 @@ typedef struct GLES2_ProgramCacheEntry
     GLES2_ShaderCacheEntry *vertex_shader;
     GLES2_ShaderCacheEntry *fragment_shader;
     GLuint uniform_locations[16];
+    GLfloat projection[4][4];   /**< The uniform values last set, GL starts them at 0 */
+    Uint32 color;
+    Uint32 modulation;
     struct GLES2_ProgramCacheEntry *prev;
     struct GLES2_ProgramCacheEntry *next;
 } GLES2_ProgramCacheEntry;
@@ -138,10 +142,6 @@ typedef enum
 typedef struct GLES2_DriverContext
 {
     SDL_GLContext *context;
-    struct {
-        int blendMode;
-        SDL_bool tex_coords;
-    } current;
 
 #define SDL_PROC(ret,func,params) ret (APIENTRY *func) params;
 #include "SDL_gles2funcs.h"
@@ -154,6 +154,10 @@ typedef struct GLES2_DriverContext
     GLES2_ShaderCache shader_cache;
     GLES2_ProgramCache program_cache;
     GLES2_ProgramCacheEntry *current_program;
+
+    /* Client-side vertex data for batched draws */
+    GLfloat *vertex_data;
+    int vertex_data_size;
 } GLES2_DriverContext;
 
 #define GLES2_MAX_CACHED_PROGRAMS 8
@@ -225,8 +229,9 @@ GLES2_ActivateRenderer(SDL_Renderer * renderer)
     GLES2_DriverContext *rdata = (GLES2_DriverContext *)renderer->driverdata;
 
     if (SDL_CurrentContext != rdata->context) {
-        /* Null out the current program to ensure we set it again */
+        /* Null out the current program and state to ensure we set it again */
         rdata->current_program = NULL;
+        SDL_ResetRenderState(renderer);
 
         if (SDL_GL_MakeCurrent(renderer->window, rdata->context) < 0) {
             return -1;
@@ -337,6 +342,7 @@ GLES2_DestroyRenderer(SDL_Renderer *renderer)
             SDL_GL_DeleteContext(rdata->context);
         }
         SDL_free(rdata->shader_formats);
+        SDL_free(rdata->vertex_data);
         SDL_free(rdata);
     }
     SDL_free(renderer);
@@ -351,6 +357,8 @@ static void GLES2_DestroyTexture(SDL_Renderer *renderer, SDL_Texture *texture);
 static int GLES2_LockTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *rect,
                              void **pixels, int *pitch);
 static void GLES2_UnlockTexture(SDL_Renderer *renderer, SDL_Texture *texture);
+static void GLES2_UnlockTextureRects(SDL_Renderer *renderer, SDL_Texture *texture,
+                                     const SDL_Rect *rects, int count);
 static int GLES2_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *rect,
                                const void *pixels, int pitch);
 static int GLES2_SetRenderTarget(SDL_Renderer * renderer, SDL_Texture * texture);
@@ -367,6 +375,21 @@ GetScaleQuality(void)
     }
 }
 
+/* Bind a texture for drawing or updating, if it isn't already */
+static void
+GLES2_SetTexture(SDL_Renderer *renderer, GLES2_TextureData *tdata)
+{
+    GLES2_DriverContext *rdata = (GLES2_DriverContext *)renderer->driverdata;
+
+    /* The sampler uniforms stay at unit 0, the application may pick another */
+    if (SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_TEXTURE_UNIT, GL_TEXTURE0)) {
+        rdata->glActiveTexture(GL_TEXTURE0);
+    }
+    if (SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_TEXTURE, tdata->texture)) {
+        rdata->glBindTexture(tdata->texture_type, tdata->texture);
+    }
+}
+
 static int
 GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 {
@@ -420,8 +443,7 @@ GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
         SDL_free(tdata);
         return SDL_SetError("Texture creation failed in glGenTextures()");
     }
-    rdata->glActiveTexture(GL_TEXTURE0);
-    rdata->glBindTexture(tdata->texture_type, tdata->texture);
+    GLES2_SetTexture(renderer, tdata);
     rdata->glTexParameteri(tdata->texture_type, GL_TEXTURE_MIN_FILTER, scaleMode);
     rdata->glTexParameteri(tdata->texture_type, GL_TEXTURE_MAG_FILTER, scaleMode);
     rdata->glTexParameteri(tdata->texture_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -451,10 +473,11 @@ GLES2_DestroyTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 
     GLES2_ActivateRenderer(renderer);
 
-    /* Destroy the texture */
+    /* Destroy the texture, its name may be reused by the next one */
     if (tdata)
     {
         rdata->glDeleteTextures(1, &tdata->texture);
+        SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
         SDL_free(tdata->pixel_data);
         SDL_free(tdata);
         texture->driverdata = NULL;
@@ -468,6 +491,7 @@ GLES2_LockTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *
     GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
 
     /* Retrieve the buffer/pitch for the specified region */
+    tdata->locked_rect = *rect;
     *pixels = (Uint8 *)tdata->pixel_data +
               (tdata->pitch * rect->y) +
               (rect->x * SDL_BYTESPERPIXEL(texture->format));
@@ -480,14 +504,25 @@ static void
 GLES2_UnlockTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 {
     GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
-    SDL_Rect rect;
-
-    /* We do whole texture updates, at least for now */
-    rect.x = 0;
-    rect.y = 0;
-    rect.w = texture->w;
-    rect.h = texture->h;
-    GLES2_UpdateTexture(renderer, texture, &rect, tdata->pixel_data, tdata->pitch);
+
+    GLES2_UnlockTextureRects(renderer, texture, &tdata->locked_rect, 1);
+}
+
+static void
+GLES2_UnlockTextureRects(SDL_Renderer *renderer, SDL_Texture *texture,
+                         const SDL_Rect *rects, int count)
+{
+    GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
+    int i;
+
+    /* Only the changed rectangles are uploaded */
+    for (i = 0; i < count; ++i) {
+        const SDL_Rect *rect = &rects[i];
+        const void *pixels = (Uint8 *)tdata->pixel_data +
+                             (tdata->pitch * rect->y) +
+                             (rect->x * SDL_BYTESPERPIXEL(texture->format));
+        GLES2_UpdateTexture(renderer, texture, rect, pixels, tdata->pitch);
+    }
 }
 
 static int
@@ -527,8 +562,7 @@ GLES2_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
 
     /* Create a texture subimage with the supplied data */
     rdata->glGetError();
-    rdata->glActiveTexture(GL_TEXTURE0);
-    rdata->glBindTexture(tdata->texture_type, tdata->texture);
+    GLES2_SetTexture(renderer, tdata);
     rdata->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     rdata->glTexSubImage2D(tdata->texture_type,
                     0,
@@ -544,6 +578,7 @@ GLES2_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
     if (rdata->glGetError() != GL_NO_ERROR) {
         return SDL_SetError("Failed to update texture");
     }
+    renderer->stats.bytes_uploaded += (Uint64)srcPitch * rect->h;
     return 0;
 }
 
@@ -872,12 +907,15 @@ GLES2_SelectProgram(SDL_Renderer *renderer, GLES2_ImageSource source, SDL_BlendM
         goto fault;
 
     /* Select that program in OpenGL */
-    rdata->glGetError();
-    rdata->glUseProgram(program->id);
-    if (rdata->glGetError() != GL_NO_ERROR)
+    if (SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_SHADER, (size_t)program))
     {
-        SDL_SetError("Failed to select program");
-        goto fault;
+        rdata->glGetError();
+        rdata->glUseProgram(program->id);
+        if (rdata->glGetError() != GL_NO_ERROR)
+        {
+            SDL_SetError("Failed to select program");
+            goto fault;
+        }
     }
 
     /* Set the current program */
@@ -895,6 +933,7 @@ fault:
     if (fragment && fragment->references <= 0)
         GLES2_EvictShader(renderer, fragment);
     rdata->current_program = NULL;
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_SHADER);
     return -1;
 }
 
@@ -902,6 +941,7 @@ static int
 GLES2_SetOrthographicProjection(SDL_Renderer *renderer)
 {
     GLES2_DriverContext *rdata = (GLES2_DriverContext *)renderer->driverdata;
+    GLES2_ProgramCacheEntry *program;
     GLfloat projection[4][4];
     GLuint locProjection;
 
@@ -935,11 +975,16 @@ GLES2_SetOrthographicProjection(SDL_Renderer *renderer)
     projection[3][2] = 0.0f;
     projection[3][3] = 1.0f;
 
-    /* Set the projection matrix */
-    locProjection = rdata->current_program->uniform_locations[GLES2_UNIFORM_PROJECTION];
+    /* Set the projection matrix, if the program doesn't have it already */
+    program = rdata->current_program;
+    if (!SDL_ChangeRenderStateData(renderer, program->projection, projection, sizeof(projection))) {
+        return 0;
+    }
+    locProjection = program->uniform_locations[GLES2_UNIFORM_PROJECTION];
     rdata->glGetError();
     rdata->glUniformMatrix4fv(locProjection, 1, GL_FALSE, (GLfloat *)projection);
     if (rdata->glGetError() != GL_NO_ERROR) {
+        SDL_zero(program->projection);
         return SDL_SetError("Failed to set orthographic projection");
     }
     return 0;
@@ -957,9 +1002,13 @@ static int GLES2_RenderDrawLines(SDL_Renderer *renderer, const SDL_FPoint *point
 static int GLES2_RenderFillRects(SDL_Renderer *renderer, const SDL_FRect *rects, int count);
 static int GLES2_RenderCopy(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *srcrect,
                             const SDL_FRect *dstrect);
+static int GLES2_RenderCopies(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *srcrects,
+                              const SDL_FRect *dstrects, int count);
 static int GLES2_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
                          const SDL_Rect * srcrect, const SDL_FRect * dstrect,
                          const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip);
+static int GLES2_RenderCopyMany(SDL_Renderer *renderer, SDL_Texture *texture,
+                                const SDL_RenderCopyCommand *copies, int count);
 static int GLES2_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                     Uint32 pixel_format, void * pixels, int pitch);
 static void GLES2_RenderPresent(SDL_Renderer *renderer);
@@ -978,14 +1027,17 @@ GLES2_RenderClear(SDL_Renderer * renderer)
                  (GLfloat) renderer->a * inv255f);
 
     rdata->glClear(GL_COLOR_BUFFER_BIT);
+    ++renderer->stats.draw_calls;
 
     return 0;
 }
 
 static void
-GLES2_SetBlendMode(GLES2_DriverContext *rdata, int blendMode)
+GLES2_SetBlendMode(SDL_Renderer *renderer, int blendMode)
 {
-    if (blendMode != rdata->current.blendMode) {
+    GLES2_DriverContext *rdata = (GLES2_DriverContext *)renderer->driverdata;
+
+    if (SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_BLENDMODE, blendMode)) {
         switch (blendMode) {
         default:
         case SDL_BLENDMODE_NONE:
@@ -1004,20 +1056,44 @@ GLES2_SetBlendMode(GLES2_DriverContext *rdata, int blendMode)
             rdata->glBlendFuncSeparate(GL_ZERO, GL_SRC_COLOR, GL_ZERO, GL_ONE);
             break;
         }
-        rdata->current.blendMode = blendMode;
     }
 }
 
 static void
-GLES2_SetTexCoords(GLES2_DriverContext * rdata, SDL_bool enabled)
+GLES2_SetTexCoords(SDL_Renderer *renderer, SDL_bool enabled)
 {
-    if (enabled != rdata->current.tex_coords) {
+    GLES2_DriverContext *rdata = (GLES2_DriverContext *)renderer->driverdata;
+
+    if (SDL_ChangeRenderState(renderer, SDL_RENDERSTATE_TEXTURING, enabled)) {
         if (enabled) {
             rdata->glEnableVertexAttribArray(GLES2_ATTRIBUTE_TEXCOORD);
         } else {
             rdata->glDisableVertexAttribArray(GLES2_ATTRIBUTE_TEXCOORD);
         }
-        rdata->current.tex_coords = enabled;
+    }
+}
+
+/* Set a color uniform of the current program, if it has changed */
+static void
+GLES2_SetColorUniform(SDL_Renderer *renderer, GLES2_Uniform uniform, Uint32 *current,
+                      Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    GLES2_DriverContext *rdata = (GLES2_DriverContext *)renderer->driverdata;
+    GLuint location = rdata->current_program->uniform_locations[uniform];
+    Uint32 color;
+
+    /* The shaders swizzle for ABGR, so swap red and blue for ARGB targets */
+    if (renderer->target &&
+        (renderer->target->format == SDL_PIXELFORMAT_ARGB8888 ||
+         renderer->target->format == SDL_PIXELFORMAT_RGB888)) {
+        Uint8 tmp = r;
+        r = b;
+        b = tmp;
+    }
+
+    color = ((Uint32)a << 24) | ((Uint32)b << 16) | ((Uint32)g << 8) | r;
+    if (SDL_ChangeRenderStateData(renderer, current, &color, sizeof(color))) {
+        rdata->glUniform4f(location, r * inv255f, g * inv255f, b * inv255f, a * inv255f);
     }
 }
 
@@ -1026,37 +1102,22 @@ GLES2_SetDrawingState(SDL_Renderer * renderer)
 {
     GLES2_DriverContext *rdata = (GLES2_DriverContext *)renderer->driverdata;
     int blendMode = renderer->blendMode;
-    GLuint locColor;
 
     rdata->glGetError();
 
     GLES2_ActivateRenderer(renderer);
 
-    GLES2_SetBlendMode(rdata, blendMode);
+    GLES2_SetBlendMode(renderer, blendMode);
 
-    GLES2_SetTexCoords(rdata, SDL_FALSE);
+    GLES2_SetTexCoords(renderer, SDL_FALSE);
 
     /* Activate an appropriate shader and set the projection matrix */
     if (GLES2_SelectProgram(renderer, GLES2_IMAGESOURCE_SOLID, blendMode) < 0)
         return -1;
 
     /* Select the color to draw with */
-    locColor = rdata->current_program->uniform_locations[GLES2_UNIFORM_COLOR];
-    if (renderer->target &&
-        (renderer->target->format == SDL_PIXELFORMAT_ARGB8888 ||
-         renderer->target->format == SDL_PIXELFORMAT_RGB888)) {
-        rdata->glUniform4f(locColor,
-                    renderer->b * inv255f,
-                    renderer->g * inv255f,
-                    renderer->r * inv255f,
-                    renderer->a * inv255f);
-    } else {
-        rdata->glUniform4f(locColor,
-                    renderer->r * inv255f,
-                    renderer->g * inv255f,
-                    renderer->b * inv255f,
-                    renderer->a * inv255f);
-    }
+    GLES2_SetColorUniform(renderer, GLES2_UNIFORM_COLOR, &rdata->current_program->color,
+                          renderer->r, renderer->g, renderer->b, renderer->a);
     return 0;
 }
 
@@ -1083,6 +1144,7 @@ GLES2_RenderDrawPoints(SDL_Renderer *renderer, const SDL_FPoint *points, int cou
     rdata->glGetError();
     rdata->glVertexAttribPointer(GLES2_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);
     rdata->glDrawArrays(GL_POINTS, 0, count);
+    ++renderer->stats.draw_calls;
     SDL_stack_free(vertices);
     if (rdata->glGetError() != GL_NO_ERROR) {
         return SDL_SetError("Failed to render points");
@@ -1113,11 +1175,13 @@ GLES2_RenderDrawLines(SDL_Renderer *renderer, const SDL_FPoint *points, int coun
     rdata->glGetError();
     rdata->glVertexAttribPointer(GLES2_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);
     rdata->glDrawArrays(GL_LINE_STRIP, 0, count);
+    ++renderer->stats.draw_calls;
 
     /* We need to close the endpoint of the line */
     if (count == 2 ||
         points[0].x != points[count-1].x || points[0].y != points[count-1].y) {
         rdata->glDrawArrays(GL_POINTS, count-1, 1);
+        ++renderer->stats.draw_calls;
     }
     SDL_stack_free(vertices);
     if (rdata->glGetError() != GL_NO_ERROR) {
@@ -1126,56 +1190,94 @@ GLES2_RenderDrawLines(SDL_Renderer *renderer, const SDL_FPoint *points, int coun
     return 0;
 }
 
+/* Get room for 'size' floats of vertex data */
+static GLfloat *
+GLES2_GetVertexData(GLES2_DriverContext *rdata, int size)
+{
+    if (size > rdata->vertex_data_size) {
+        GLfloat *vertex_data = (GLfloat *)SDL_realloc(rdata->vertex_data, size * sizeof(GLfloat));
+        if (!vertex_data) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        rdata->vertex_data = vertex_data;
+        rdata->vertex_data_size = size;
+    }
+    return rdata->vertex_data;
+}
+
+/* Write the two triangles covering a rectangle */
+static GLfloat *
+GLES2_EmitQuad(GLfloat *vertices, GLfloat xMin, GLfloat yMin, GLfloat xMax, GLfloat yMax)
+{
+    vertices[0] = xMin;
+    vertices[1] = yMin;
+    vertices[2] = xMax;
+    vertices[3] = yMin;
+    vertices[4] = xMin;
+    vertices[5] = yMax;
+    vertices[6] = xMax;
+    vertices[7] = yMin;
+    vertices[8] = xMin;
+    vertices[9] = yMax;
+    vertices[10] = xMax;
+    vertices[11] = yMax;
+    return vertices + 12;
+}
+
 static int
 GLES2_RenderFillRects(SDL_Renderer *renderer, const SDL_FRect *rects, int count)
 {
     GLES2_DriverContext *rdata = (GLES2_DriverContext *)renderer->driverdata;
-    GLfloat vertices[8];
+    GLfloat *vertices;
+    GLfloat *vertex;
     int idx;
 
     if (GLES2_SetDrawingState(renderer) < 0) {
         return -1;
     }
 
-    /* Emit a line loop for each rectangle */
+    vertices = GLES2_GetVertexData(rdata, count * 12);
+    if (!vertices) {
+        return -1;
+    }
+
+    /* Emit all the rectangles as triangles in a single draw */
     rdata->glGetError();
+    vertex = vertices;
     for (idx = 0; idx < count; ++idx) {
         const SDL_FRect *rect = &rects[idx];
 
-        GLfloat xMin = rect->x;
-        GLfloat xMax = (rect->x + rect->w);
-        GLfloat yMin = rect->y;
-        GLfloat yMax = (rect->y + rect->h);
-
-        vertices[0] = xMin;
-        vertices[1] = yMin;
-        vertices[2] = xMax;
-        vertices[3] = yMin;
-        vertices[4] = xMin;
-        vertices[5] = yMax;
-        vertices[6] = xMax;
-        vertices[7] = yMax;
-        rdata->glVertexAttribPointer(GLES2_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);
-        rdata->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        vertex = GLES2_EmitQuad(vertex, rect->x, rect->y,
+                                (rect->x + rect->w), (rect->y + rect->h));
     }
+    rdata->glVertexAttribPointer(GLES2_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+    rdata->glDrawArrays(GL_TRIANGLES, 0, count * 6);
+    ++renderer->stats.draw_calls;
     if (rdata->glGetError() != GL_NO_ERROR) {
         return SDL_SetError("Failed to render filled rects");
     }
     return 0;
 }
 
+/* Set the color modulation of the current texture program */
+static void
+GLES2_SetModulation(SDL_Renderer *renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    GLES2_DriverContext *rdata = (GLES2_DriverContext *)renderer->driverdata;
+
+    GLES2_SetColorUniform(renderer, GLES2_UNIFORM_MODULATION, &rdata->current_program->modulation,
+                          r, g, b, a);
+}
+
+/* Bind the texture and set up the program, modulation and blending for copies from it */
 static int
-GLES2_RenderCopy(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *srcrect,
-                 const SDL_FRect *dstrect)
+GLES2_SetupCopy(SDL_Renderer *renderer, SDL_Texture *texture)
 {
     GLES2_DriverContext *rdata = (GLES2_DriverContext *)renderer->driverdata;
     GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
     GLES2_ImageSource sourceType = GLES2_IMAGESOURCE_TEXTURE_ABGR;
     SDL_BlendMode blendMode;
-    GLfloat vertices[8];
-    GLfloat texCoords[8];
-    GLuint locTexture;
-    GLuint locModulation;
 
     GLES2_ActivateRenderer(renderer);
 
@@ -1264,35 +1366,31 @@ GLES2_RenderCopy(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *s
     if (GLES2_SelectProgram(renderer, sourceType, blendMode) < 0)
         return -1;
 
-    /* Select the target texture */
-    locTexture = rdata->current_program->uniform_locations[GLES2_UNIFORM_TEXTURE];
+    /* Select the target texture, the sampler uniforms stay at unit 0 */
     rdata->glGetError();
-    rdata->glActiveTexture(GL_TEXTURE0);
-    rdata->glBindTexture(tdata->texture_type, tdata->texture);
-    rdata->glUniform1i(locTexture, 0);
+    GLES2_SetTexture(renderer, tdata);
 
     /* Configure color modulation */
-    locModulation = rdata->current_program->uniform_locations[GLES2_UNIFORM_MODULATION];
-    if (renderer->target &&
-        (renderer->target->format == SDL_PIXELFORMAT_ARGB8888 ||
-         renderer->target->format == SDL_PIXELFORMAT_RGB888)) {
-        rdata->glUniform4f(locModulation,
-                    texture->b * inv255f,
-                    texture->g * inv255f,
-                    texture->r * inv255f,
-                    texture->a * inv255f);
-    } else {
-        rdata->glUniform4f(locModulation,
-                    texture->r * inv255f,
-                    texture->g * inv255f,
-                    texture->b * inv255f,
-                    texture->a * inv255f);
-    }
+    GLES2_SetModulation(renderer, texture->r, texture->g, texture->b, texture->a);
 
     /* Configure texture blending */
-    GLES2_SetBlendMode(rdata, blendMode);
+    GLES2_SetBlendMode(renderer, blendMode);
 
-    GLES2_SetTexCoords(rdata, SDL_TRUE);
+    GLES2_SetTexCoords(renderer, SDL_TRUE);
+    return 0;
+}
+
+static int
+GLES2_RenderCopy(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *srcrect,
+                 const SDL_FRect *dstrect)
+{
+    GLES2_DriverContext *rdata = (GLES2_DriverContext *)renderer->driverdata;
+    GLfloat vertices[8];
+    GLfloat texCoords[8];
+
+    if (GLES2_SetupCopy(renderer, texture) < 0) {
+        return -1;
+    }
 
     /* Emit the textured quad */
     vertices[0] = dstrect->x;
@@ -1314,6 +1412,150 @@ GLES2_RenderCopy(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *s
     texCoords[7] = (srcrect->y + srcrect->h) / (GLfloat)texture->h;
     rdata->glVertexAttribPointer(GLES2_ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0, texCoords);
     rdata->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    ++renderer->stats.draw_calls;
+    if (rdata->glGetError() != GL_NO_ERROR) {
+        return SDL_SetError("Failed to render texture");
+    }
+    return 0;
+}
+
+static int
+GLES2_RenderCopies(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *srcrects,
+                   const SDL_FRect *dstrects, int count)
+{
+    GLES2_DriverContext *rdata = (GLES2_DriverContext *)renderer->driverdata;
+    const GLfloat texw = (GLfloat)texture->w;
+    const GLfloat texh = (GLfloat)texture->h;
+    GLfloat *vertices;
+    GLfloat *texCoords;
+    GLfloat *vertex;
+    GLfloat *texCoord;
+    int idx;
+
+    if (GLES2_SetupCopy(renderer, texture) < 0) {
+        return -1;
+    }
+
+    /* Positions first, then texture coordinates */
+    vertices = GLES2_GetVertexData(rdata, count * 24);
+    if (!vertices) {
+        return -1;
+    }
+    texCoords = vertices + count * 12;
+
+    /* Emit all the textured quads as triangles in a single draw */
+    vertex = vertices;
+    texCoord = texCoords;
+    for (idx = 0; idx < count; ++idx) {
+        const SDL_Rect *srcrect = &srcrects[idx];
+        const SDL_FRect *dstrect = &dstrects[idx];
+
+        vertex = GLES2_EmitQuad(vertex, dstrect->x, dstrect->y,
+                                (dstrect->x + dstrect->w), (dstrect->y + dstrect->h));
+        texCoord = GLES2_EmitQuad(texCoord, srcrect->x / texw, srcrect->y / texh,
+                                  (srcrect->x + srcrect->w) / texw,
+                                  (srcrect->y + srcrect->h) / texh);
+    }
+    rdata->glVertexAttribPointer(GLES2_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+    rdata->glVertexAttribPointer(GLES2_ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0, texCoords);
+    rdata->glDrawArrays(GL_TRIANGLES, 0, count * 6);
+    ++renderer->stats.draw_calls;
+    if (rdata->glGetError() != GL_NO_ERROR) {
+        return SDL_SetError("Failed to render texture");
+    }
+    return 0;
+}
+
+static int
+GLES2_RenderCopyMany(SDL_Renderer *renderer, SDL_Texture *texture,
+                     const SDL_RenderCopyCommand *copies, int count)
+{
+    GLES2_DriverContext *rdata = (GLES2_DriverContext *)renderer->driverdata;
+    const GLfloat texw = (GLfloat)texture->w;
+    const GLfloat texh = (GLfloat)texture->h;
+    GLfloat *vertices;
+    GLfloat *texCoords;
+    int first, idx;
+
+    if (GLES2_SetupCopy(renderer, texture) < 0) {
+        return -1;
+    }
+
+    /* Positions first, then texture coordinates */
+    vertices = GLES2_GetVertexData(rdata, count * 24);
+    if (!vertices) {
+        return -1;
+    }
+    texCoords = vertices + count * 12;
+
+    /* Rotation and flipping are done here rather than in the shader, so each
+       run of copies with the same modulation is a single draw.
+     */
+    for (first = 0; first < count; first = idx) {
+        const SDL_RenderCopyCommand *run = &copies[first];
+        GLfloat *vertex = vertices + first * 12;
+        GLfloat *texCoord = texCoords + first * 12;
+
+        for (idx = first; idx < count; ++idx) {
+            const SDL_RenderCopyCommand *copy = &copies[idx];
+            const SDL_Rect *srcrect = &copy->srcrect;
+            const SDL_FRect *dstrect = &copy->dstrect;
+            GLfloat minu, minv, maxu, maxv, tmp;
+
+            if (copy->r != run->r || copy->g != run->g ||
+                copy->b != run->b || copy->a != run->a) {
+                break;
+            }
+
+            if (copy->angle != 0.0) {
+                const GLfloat radians = (GLfloat)(copy->angle * M_PI / 180.0);
+                const GLfloat c = SDL_cosf(radians);
+                const GLfloat s = SDL_sinf(radians);
+                const GLfloat cx = dstrect->x + copy->center.x;
+                const GLfloat cy = dstrect->y + copy->center.y;
+                const GLfloat x0 = dstrect->x - cx;
+                const GLfloat y0 = dstrect->y - cy;
+                const GLfloat x1 = x0 + dstrect->w;
+                const GLfloat y1 = y0 + dstrect->h;
+
+                /* The corners in the same order as GLES2_EmitQuad() */
+                vertex[0] = x0 * c - y0 * s + cx;   /* top left */
+                vertex[1] = x0 * s + y0 * c + cy;
+                vertex[2] = vertex[6] = x1 * c - y0 * s + cx;   /* top right */
+                vertex[3] = vertex[7] = x1 * s + y0 * c + cy;
+                vertex[4] = vertex[8] = x0 * c - y1 * s + cx;   /* bottom left */
+                vertex[5] = vertex[9] = x0 * s + y1 * c + cy;
+                vertex[10] = x1 * c - y1 * s + cx;  /* bottom right */
+                vertex[11] = x1 * s + y1 * c + cy;
+                vertex += 12;
+            } else {
+                vertex = GLES2_EmitQuad(vertex, dstrect->x, dstrect->y,
+                                        (dstrect->x + dstrect->w), (dstrect->y + dstrect->h));
+            }
+
+            minu = srcrect->x / texw;
+            minv = srcrect->y / texh;
+            maxu = (srcrect->x + srcrect->w) / texw;
+            maxv = (srcrect->y + srcrect->h) / texh;
+            if (copy->flip & SDL_FLIP_HORIZONTAL) {
+                tmp = minu;
+                minu = maxu;
+                maxu = tmp;
+            }
+            if (copy->flip & SDL_FLIP_VERTICAL) {
+                tmp = minv;
+                minv = maxv;
+                maxv = tmp;
+            }
+            texCoord = GLES2_EmitQuad(texCoord, minu, minv, maxu, maxv);
+        }
+
+        GLES2_SetModulation(renderer, run->r, run->g, run->b, run->a);
+        rdata->glVertexAttribPointer(GLES2_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices + first * 12);
+        rdata->glVertexAttribPointer(GLES2_ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0, texCoords + first * 12);
+        rdata->glDrawArrays(GL_TRIANGLES, 0, (idx - first) * 6);
+        ++renderer->stats.draw_calls;
+    }
     if (rdata->glGetError() != GL_NO_ERROR) {
         return SDL_SetError("Failed to render texture");
     }
@@ -1325,13 +1567,8 @@ GLES2_RenderCopyEx(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
                  const SDL_FRect *dstrect, const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip)
 {
     GLES2_DriverContext *rdata = (GLES2_DriverContext *)renderer->driverdata;
-    GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
-    GLES2_ImageSource sourceType = GLES2_IMAGESOURCE_TEXTURE_ABGR;
-    SDL_BlendMode blendMode;
     GLfloat vertices[8];
     GLfloat texCoords[8];
-    GLuint locTexture;
-    GLuint locModulation;
     GLfloat translate[8];
     GLfloat fAngle[4];
     GLfloat tmp;
@@ -1345,121 +1582,13 @@ GLES2_RenderCopyEx(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
     translate[0] = translate[2] = translate[4] = translate[6] = (center->x + dstrect->x);
     translate[1] = translate[3] = translate[5] = translate[7] = (center->y + dstrect->y);
 
-    /* Activate an appropriate shader and set the projection matrix */
-    blendMode = texture->blendMode;
-    if (renderer->target) {
-        /* Check if we need to do color mapping between the source and render target textures */
-        if (renderer->target->format != texture->format) {
-            switch (texture->format)
-            {
-            case SDL_PIXELFORMAT_ABGR8888:
-                switch (renderer->target->format)
-                {
-                    case SDL_PIXELFORMAT_ARGB8888:
-                    case SDL_PIXELFORMAT_RGB888:
-                        sourceType = GLES2_IMAGESOURCE_TEXTURE_ARGB;
-                        break;
-                    case SDL_PIXELFORMAT_BGR888:
-                        sourceType = GLES2_IMAGESOURCE_TEXTURE_ABGR;
-                        break;
-                }
-                break;
-            case SDL_PIXELFORMAT_ARGB8888:
-                switch (renderer->target->format)
-                {
-                    case SDL_PIXELFORMAT_ABGR8888:
-                    case SDL_PIXELFORMAT_BGR888:
-                        sourceType = GLES2_IMAGESOURCE_TEXTURE_ARGB;
-                        break;
-                    case SDL_PIXELFORMAT_RGB888:
-                        sourceType = GLES2_IMAGESOURCE_TEXTURE_ABGR;
-                        break;
-                }
-                break;
-            case SDL_PIXELFORMAT_BGR888:
-                switch (renderer->target->format)
-                {
-                    case SDL_PIXELFORMAT_ABGR8888:
-                        sourceType = GLES2_IMAGESOURCE_TEXTURE_BGR;
-                        break;
-                    case SDL_PIXELFORMAT_ARGB8888:
-                        sourceType = GLES2_IMAGESOURCE_TEXTURE_RGB;
-                        break;
-                    case SDL_PIXELFORMAT_RGB888:
-                        sourceType = GLES2_IMAGESOURCE_TEXTURE_ARGB;
-                        break;
-                }
-                break;
-            case SDL_PIXELFORMAT_RGB888:
-                switch (renderer->target->format)
-                {
-                    case SDL_PIXELFORMAT_ABGR8888:
-                        sourceType = GLES2_IMAGESOURCE_TEXTURE_ARGB;
-                        break;
-                    case SDL_PIXELFORMAT_ARGB8888:
-                        sourceType = GLES2_IMAGESOURCE_TEXTURE_BGR;
-                        break;
-                    case SDL_PIXELFORMAT_BGR888:
-                        sourceType = GLES2_IMAGESOURCE_TEXTURE_ARGB;
-                        break;
-                }
-                break;
-            }
-        }
-        else sourceType = GLES2_IMAGESOURCE_TEXTURE_ABGR;   /* Texture formats match, use the non color mapping shader (even if the formats are not ABGR) */
-    }
-    else {
-        switch (texture->format)
-        {
-            case SDL_PIXELFORMAT_ABGR8888:
-                sourceType = GLES2_IMAGESOURCE_TEXTURE_ABGR;
-                break;
-            case SDL_PIXELFORMAT_ARGB8888:
-                sourceType = GLES2_IMAGESOURCE_TEXTURE_ARGB;
-                break;
-            case SDL_PIXELFORMAT_BGR888:
-                sourceType = GLES2_IMAGESOURCE_TEXTURE_BGR;
-                break;
-            case SDL_PIXELFORMAT_RGB888:
-                sourceType = GLES2_IMAGESOURCE_TEXTURE_RGB;
-                break;
-            default:
-                return -1;
-        }
-    }
-    if (GLES2_SelectProgram(renderer, sourceType, blendMode) < 0)
+    /* Select the program, texture, modulation and blending */
+    if (GLES2_SetupCopy(renderer, texture) < 0) {
+        rdata->glDisableVertexAttribArray(GLES2_ATTRIBUTE_CENTER);
+        rdata->glDisableVertexAttribArray(GLES2_ATTRIBUTE_ANGLE);
         return -1;
-
-    /* Select the target texture */
-    locTexture = rdata->current_program->uniform_locations[GLES2_UNIFORM_TEXTURE];
-    rdata->glGetError();
-    rdata->glActiveTexture(GL_TEXTURE0);
-    rdata->glBindTexture(tdata->texture_type, tdata->texture);
-    rdata->glUniform1i(locTexture, 0);
-
-    /* Configure color modulation */
-    locModulation = rdata->current_program->uniform_locations[GLES2_UNIFORM_MODULATION];
-    if (renderer->target &&
-        (renderer->target->format == SDL_PIXELFORMAT_ARGB8888 ||
-         renderer->target->format == SDL_PIXELFORMAT_RGB888)) {
-        rdata->glUniform4f(locModulation,
-                    texture->b * inv255f,
-                    texture->g * inv255f,
-                    texture->r * inv255f,
-                    texture->a * inv255f);
-    } else {
-        rdata->glUniform4f(locModulation,
-                    texture->r * inv255f,
-                    texture->g * inv255f,
-                    texture->b * inv255f,
-                    texture->a * inv255f);
     }
 
-    /* Configure texture blending */
-    GLES2_SetBlendMode(rdata, blendMode);
-
-    GLES2_SetTexCoords(rdata, SDL_TRUE);
-
     /* Emit the textured quad */
     vertices[0] = dstrect->x;
     vertices[1] = dstrect->y;
@@ -1494,6 +1623,7 @@ GLES2_RenderCopyEx(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
     texCoords[7] = (srcrect->y + srcrect->h) / (GLfloat)texture->h;
     rdata->glVertexAttribPointer(GLES2_ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0, texCoords);
     rdata->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    ++renderer->stats.draw_calls;
     rdata->glDisableVertexAttribArray(GLES2_ATTRIBUTE_CENTER);
     rdata->glDisableVertexAttribArray(GLES2_ATTRIBUTE_ANGLE);
     if (rdata->glGetError() != GL_NO_ERROR) {
@@ -1573,7 +1703,11 @@ static int GLES2_BindTexture (SDL_Renderer * renderer, SDL_Texture *texture, flo
     GLES2_TextureData *texturedata = (GLES2_TextureData *)texture->driverdata;
     GLES2_ActivateRenderer(renderer);
 
+    /* The application may bind other textures, or select another texture
+       unit, before we draw again */
     data->glBindTexture(texturedata->texture_type, texturedata->texture);
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE_UNIT);
 
     if(texw) *texw = 1.0;
     if(texh) *texh = 1.0;
@@ -1587,6 +1721,8 @@ static int GLES2_UnbindTexture (SDL_Renderer * renderer, SDL_Texture *texture) {
     GLES2_ActivateRenderer(renderer);
 
     data->glBindTexture(texturedata->texture_type, 0);
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE);
+    SDL_InvalidateRenderState(renderer, SDL_RENDERSTATE_TEXTURE_UNIT);
 
     return 0;
 }
@@ -1609,11 +1745,10 @@ GLES2_ResetState(SDL_Renderer *renderer)
         GLES2_ActivateRenderer(renderer);
     }
 
-    rdata->current.blendMode = -1;
-    rdata->current.tex_coords = SDL_FALSE;
+    SDL_ResetRenderState(renderer);
 
     rdata->glEnableVertexAttribArray(GLES2_ATTRIBUTE_POSITION);
-    rdata->glDisableVertexAttribArray(GLES2_ATTRIBUTE_TEXCOORD);
+    GLES2_SetTexCoords(renderer, SDL_FALSE);
 }
 
 static SDL_Renderer *
@@ -1728,6 +1863,7 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     renderer->UpdateTexture       = &GLES2_UpdateTexture;
     renderer->LockTexture         = &GLES2_LockTexture;
     renderer->UnlockTexture       = &GLES2_UnlockTexture;
+    renderer->UnlockTextureRects  = &GLES2_UnlockTextureRects;
     renderer->SetRenderTarget     = &GLES2_SetRenderTarget;
     renderer->UpdateViewport      = &GLES2_UpdateViewport;
     renderer->UpdateClipRect      = &GLES2_UpdateClipRect;
@@ -1736,7 +1872,9 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     renderer->RenderDrawLines     = &GLES2_RenderDrawLines;
     renderer->RenderFillRects     = &GLES2_RenderFillRects;
     renderer->RenderCopy          = &GLES2_RenderCopy;
+    renderer->RenderCopies        = &GLES2_RenderCopies;
     renderer->RenderCopyEx        = &GLES2_RenderCopyEx;
+    renderer->RenderCopyMany      = &GLES2_RenderCopyMany;
     renderer->RenderReadPixels    = &GLES2_RenderReadPixels;
     renderer->RenderPresent       = &GLES2_RenderPresent;
     renderer->DestroyTexture      = &GLES2_DestroyTexture;
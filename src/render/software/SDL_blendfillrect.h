@@ -20,7 +20,10 @@
 */
 #include "SDL_config.h"
 
-
+/* Unlike SDL_FillRect(), these don't lock the surface.  The caller locks
+   the area the rectangles cover with SDL_LockSurfaceRect(), so an RLE
+   encoded surface re-encodes those rows.
+ */
 extern int SDL_BlendFillRect(SDL_Surface * dst, const SDL_Rect * rect, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 extern int SDL_BlendFillRects(SDL_Surface * dst, const SDL_Rect * rects, int count, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
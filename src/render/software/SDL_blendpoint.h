@@ -20,7 +20,9 @@
 */
 #include "SDL_config.h"
 
-
+/* The caller locks the area the points cover with SDL_LockSurfaceRect(),
+   these don't re-encode an RLE surface themselves.
+ */
 extern int SDL_BlendPoint(SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 extern int SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
@@ -0,0 +1,602 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+#if !SDL_RENDER_DISABLED
+
+#include "SDL_cpuinfo.h"
+#include "../../video/SDL_blit.h"
+#include "SDL_blitaffine.h"
+
+/* The sampled pixels are composited this many at a time */
+#define AFFINE_CHUNK    256
+
+/* A row of the destination mapped into the source, in 16.16 fixed point */
+typedef struct
+{
+    const SDL_PixelFormat *fmt;
+    const Uint8 *pixels;        /**< The top left of the source rectangle */
+    int pitch;
+    int w, h;                   /**< The size of the source rectangle */
+    Sint32 u, v;                /**< The source position of the first pixel */
+    Sint32 du, dv;              /**< The step from one pixel to the next */
+} SDL_AffineSpan;
+
+static __inline__ Uint32
+GetTexel(const SDL_AffineSpan * span, int x, int y)
+{
+    const Uint8 *row = span->pixels + y * span->pitch;
+
+    if (span->fmt->BytesPerPixel == 4) {
+        return ((const Uint32 *) row)[x];
+    } else {
+        return ((const Uint16 *) row)[x];
+    }
+}
+
+/* Convert a source pixel to ARGB8888 */
+static __inline__ Uint32
+TexelToARGB(const SDL_PixelFormat * fmt, Uint32 pixel)
+{
+    unsigned r, g, b, a;
+
+    switch (fmt->format) {
+    case SDL_PIXELFORMAT_ARGB8888:
+        return pixel;
+    case SDL_PIXELFORMAT_RGB888:
+        return (pixel | 0xFF000000);
+    default:
+        RGBA_FROM_PIXEL(pixel, fmt, r, g, b, a);
+        return ((a << 24) | (r << 16) | (g << 8) | b);
+    }
+}
+
+static void
+SampleNearest(const SDL_AffineSpan * span, Uint32 * out, int n)
+{
+    const SDL_PixelFormat *fmt = span->fmt;
+    Sint32 u = span->u;
+    Sint32 v = span->v;
+    int i;
+
+    if (fmt->format == SDL_PIXELFORMAT_ARGB8888) {
+        for (i = 0; i < n; ++i, u += span->du, v += span->dv) {
+            out[i] = GetTexel(span, u >> 16, v >> 16);
+        }
+    } else {
+        for (i = 0; i < n; ++i, u += span->du, v += span->dv) {
+            out[i] = TexelToARGB(fmt, GetTexel(span, u >> 16, v >> 16));
+        }
+    }
+}
+
+/* Interpolate four pixels with 8 bit weights, one byte channel at a time */
+static __inline__ Uint32
+Bilinear(Uint32 t00, Uint32 t10, Uint32 t01, Uint32 t11, unsigned fx, unsigned fy)
+{
+    Uint32 result = 0;
+    int shift;
+
+    for (shift = 0; shift < 32; shift += 8) {
+        const unsigned c0 = (((t00 >> shift) & 0xFF) * (256 - fy) +
+                             ((t01 >> shift) & 0xFF) * fy) >> 8;
+        const unsigned c1 = (((t10 >> shift) & 0xFF) * (256 - fy) +
+                             ((t11 >> shift) & 0xFF) * fy) >> 8;
+
+        result |= (Uint32)((c0 * (256 - fx) + c1 * fx) >> 8) << shift;
+    }
+    return result;
+}
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+/* The same arithmetic as Bilinear(), on all four channels at once */
+static __inline__ Uint32
+Bilinear_SSE2(Uint32 t00, Uint32 t10, Uint32 t01, Uint32 t11, unsigned fx, unsigned fy)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i top = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, (int)t10, (int)t00), zero);
+    const __m128i bottom = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, (int)t11, (int)t01), zero);
+    __m128i col, result;
+
+    /* Both columns down, then across */
+    col = _mm_srli_epi16(_mm_add_epi16(
+              _mm_mullo_epi16(top, _mm_set1_epi16((short)(256 - fy))),
+              _mm_mullo_epi16(bottom, _mm_set1_epi16((short)fy))), 8);
+    result = _mm_srli_epi16(_mm_add_epi16(
+                 _mm_mullo_epi16(col, _mm_set1_epi16((short)(256 - fx))),
+                 _mm_mullo_epi16(_mm_srli_si128(col, 8), _mm_set1_epi16((short)fx))), 8);
+    return (Uint32)_mm_cvtsi128_si32(_mm_packus_epi16(result, result));
+}
+#endif /* __SSE2__ */
+
+/* Sample between the four nearest source pixels.  The pixel centers are at
+   half texels, and the edges of the source rectangle are repeated outward.
+ */
+static void
+SampleBilinear(const SDL_AffineSpan * span, Uint32 * out, int n)
+{
+    const SDL_PixelFormat *fmt = span->fmt;
+    const SDL_bool convert_first = (fmt->BytesPerPixel != 4);
+#ifdef __SSE2__
+    const SDL_bool use_sse2 = SDL_HasSSE2();
+#endif
+    Sint32 u = span->u - 0x8000;
+    Sint32 v = span->v - 0x8000;
+    int i;
+
+    for (i = 0; i < n; ++i, u += span->du, v += span->dv) {
+        const unsigned fx = (u >> 8) & 0xFF;
+        const unsigned fy = (v >> 8) & 0xFF;
+        int x0 = u >> 16;
+        int y0 = v >> 16;
+        int x1 = x0 + 1;
+        int y1 = y0 + 1;
+        Uint32 t00, t10, t01, t11, pixel;
+
+        if (x0 < 0) {
+            x0 = 0;
+        }
+        if (x1 >= span->w) {
+            x1 = span->w - 1;
+        }
+        if (y0 < 0) {
+            y0 = 0;
+        }
+        if (y1 >= span->h) {
+            y1 = span->h - 1;
+        }
+        t00 = GetTexel(span, x0, y0);
+        t10 = GetTexel(span, x1, y0);
+        t01 = GetTexel(span, x0, y1);
+        t11 = GetTexel(span, x1, y1);
+
+        /* Packed 16 bit pixels are expanded before mixing, 32 bit pixels
+           have byte channels that can be mixed in place.
+         */
+        if (convert_first) {
+            t00 = TexelToARGB(fmt, t00);
+            t10 = TexelToARGB(fmt, t10);
+            t01 = TexelToARGB(fmt, t01);
+            t11 = TexelToARGB(fmt, t11);
+        }
+#ifdef __SSE2__
+        if (use_sse2) {
+            pixel = Bilinear_SSE2(t00, t10, t01, t11, fx, fy);
+        } else
+#endif
+        pixel = Bilinear(t00, t10, t01, t11, fx, fy);
+
+        out[i] = convert_first ? pixel : TexelToARGB(fmt, pixel);
+    }
+}
+
+/* Composite ARGB8888 pixels onto any destination, the way SDL_Blit_Slow()
+   does it.
+ */
+static void
+CompositeSpan(const SDL_BlitInfo * info, const Uint32 * src, Uint8 * dst, int n)
+{
+    const SDL_PixelFormat *dst_fmt = info->dst_fmt;
+    const int dstbpp = dst_fmt->BytesPerPixel;
+    const int flags = info->flags;
+    Uint32 srcR, srcG, srcB, srcA;
+    Uint32 dstpixel;
+    Uint32 dstR, dstG, dstB, dstA;
+
+    for (; n > 0; --n, ++src, dst += dstbpp) {
+        srcA = (Uint8)(*src >> 24);
+        srcR = (Uint8)(*src >> 16);
+        srcG = (Uint8)(*src >> 8);
+        srcB = (Uint8)*src;
+        if (dst_fmt->Amask) {
+            DISEMBLE_RGBA(dst, dstbpp, dst_fmt, dstpixel, dstR, dstG, dstB, dstA);
+        } else {
+            DISEMBLE_RGB(dst, dstbpp, dst_fmt, dstpixel, dstR, dstG, dstB);
+            dstA = 0xFF;
+        }
+        if (flags & SDL_COPY_MODULATE_COLOR) {
+            srcR = (srcR * info->r) / 255;
+            srcG = (srcG * info->g) / 255;
+            srcB = (srcB * info->b) / 255;
+        }
+        if (flags & SDL_COPY_MODULATE_ALPHA) {
+            srcA = (srcA * info->a) / 255;
+        }
+        if (flags & (SDL_COPY_BLEND | SDL_COPY_ADD)) {
+            if (srcA < 255) {
+                srcR = (srcR * srcA) / 255;
+                srcG = (srcG * srcA) / 255;
+                srcB = (srcB * srcA) / 255;
+            }
+        }
+        switch (flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD)) {
+        case 0:
+            dstR = srcR;
+            dstG = srcG;
+            dstB = srcB;
+            dstA = srcA;
+            break;
+        case SDL_COPY_BLEND:
+            dstR = srcR + ((255 - srcA) * dstR) / 255;
+            dstG = srcG + ((255 - srcA) * dstG) / 255;
+            dstB = srcB + ((255 - srcA) * dstB) / 255;
+            dstA = srcA + ((255 - srcA) * dstA) / 255;
+            break;
+        case SDL_COPY_ADD:
+            dstR = SDL_min(srcR + dstR, 255);
+            dstG = SDL_min(srcG + dstG, 255);
+            dstB = SDL_min(srcB + dstB, 255);
+            break;
+        case SDL_COPY_MOD:
+            dstR = (srcR * dstR) / 255;
+            dstG = (srcG * dstG) / 255;
+            dstB = (srcB * dstB) / 255;
+            break;
+        }
+        ASSEMBLE_RGBA(dst, dstbpp, dst_fmt, dstR, dstG, dstB, dstA);
+    }
+}
+
+#ifdef __SSE2__
+
+/* *INDENT-OFF* */
+
+/* x / 255 for x <= 255*255, exactly */
+#define DIV255_EPI16(x) \
+    _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8)), 8)
+
+/* *INDENT-ON* */
+
+/* Composite two pixels unpacked to 16 bits per channel, in ARGB order */
+static __inline__ __m128i
+CompositePair_SSE2(__m128i s, __m128i d, int flags, __m128i mod)
+{
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i max = _mm_set1_epi16(0xFF);
+    const __m128i alpha = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    __m128i a;
+
+    if (flags & (SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA)) {
+        s = DIV255_EPI16(_mm_mullo_epi16(s, mod));
+    }
+    switch (flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD)) {
+    case SDL_COPY_BLEND:
+    case SDL_COPY_ADD:
+        /* Premultiply the color, the alpha is multiplied by 255 / 255 */
+        a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xFF), 0xFF);
+        s = DIV255_EPI16(_mm_mullo_epi16(s, _mm_or_si128(a, _mm_and_si128(alpha, max))));
+        if (flags & SDL_COPY_BLEND) {
+            return _mm_add_epi16(s, DIV255_EPI16(_mm_mullo_epi16(d, _mm_sub_epi16(max, a))));
+        }
+        s = _mm_min_epi16(_mm_add_epi16(s, d), max);
+        return _mm_or_si128(_mm_andnot_si128(alpha, s), _mm_and_si128(alpha, d));
+    case SDL_COPY_MOD:
+        s = DIV255_EPI16(_mm_mullo_epi16(s, d));
+        return _mm_or_si128(_mm_andnot_si128(alpha, s), _mm_and_si128(alpha, d));
+    default:
+        return s;
+    }
+}
+
+/* Composite onto ARGB8888 or RGB888, four pixels at a time */
+static void
+CompositeSpan_SSE2(const SDL_BlitInfo * info, const Uint32 * src, Uint32 * dst, int n)
+{
+    const int flags = info->flags;
+    const short r = (flags & SDL_COPY_MODULATE_COLOR) ? info->r : 0xFF;
+    const short g = (flags & SDL_COPY_MODULATE_COLOR) ? info->g : 0xFF;
+    const short b = (flags & SDL_COPY_MODULATE_COLOR) ? info->b : 0xFF;
+    const short a = (flags & SDL_COPY_MODULATE_ALPHA) ? info->a : 0xFF;
+    const __m128i mod = _mm_set_epi16(a, r, g, b, a, r, g, b);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i keep = _mm_set1_epi32(info->dst_fmt->Amask ? -1 : 0x00FFFFFF);
+
+    for (; n >= 4; n -= 4, src += 4, dst += 4) {
+        const __m128i s = _mm_loadu_si128((const __m128i *)src);
+        const __m128i d = _mm_loadu_si128((const __m128i *)dst);
+        const __m128i lo = CompositePair_SSE2(_mm_unpacklo_epi8(s, zero),
+                                              _mm_unpacklo_epi8(d, zero),
+                                              flags, mod);
+        const __m128i hi = CompositePair_SSE2(_mm_unpackhi_epi8(s, zero),
+                                              _mm_unpackhi_epi8(d, zero),
+                                              flags, mod);
+
+        _mm_storeu_si128((__m128i *)dst, _mm_and_si128(_mm_packus_epi16(lo, hi), keep));
+    }
+    CompositeSpan(info, src, (Uint8 *) dst, n);
+}
+#endif /* __SSE2__ */
+
+static Sint64
+FloorDiv(Sint64 a, Sint64 b)
+{
+    Sint64 q = a / b;
+
+    if ((a % b) != 0 && ((a < 0) != (b < 0))) {
+        --q;
+    }
+    return q;
+}
+
+/* Narrow [*first, *last] to the k where 0 <= a + k * d < limit */
+static void
+ClipSpan(Sint64 a, Sint64 d, Sint64 limit, int *first, int *last)
+{
+    Sint64 lo, hi;
+
+    if (d == 0) {
+        if (a < 0 || a >= limit) {
+            *last = *first - 1;
+        }
+        return;
+    }
+    if (d > 0) {
+        lo = -FloorDiv(a, d);
+        hi = -FloorDiv(a - limit, d) - 1;
+    } else {
+        lo = FloorDiv(a - limit, -d) + 1;
+        hi = FloorDiv(a, -d);
+    }
+    if (lo > *first) {
+        *first = (int) SDL_min(lo, *last + 1);
+    }
+    if (hi < *last) {
+        *last = (int) SDL_max(hi, *first - 1);
+    }
+}
+
+static Sint32
+ToFixed(double x)
+{
+    return (Sint32) SDL_floor(x * 65536.0 + 0.5);
+}
+
+/* Replace the sampled alpha of a distance field with the edge coverage */
+static void
+ApplyCoverage(Uint32 * pixels, int n, const Uint8 * coverage)
+{
+    int i;
+
+    for (i = 0; i < n; ++i) {
+        pixels[i] = (pixels[i] & 0x00FFFFFF) |
+                    ((Uint32) coverage[pixels[i] >> 24] << 24);
+    }
+}
+
+static int
+BlitAffine(SDL_Surface * src, const SDL_Rect * srcrect,
+           SDL_Surface * dst, const SDL_Rect * dstrect,
+           double angle, const SDL_FPoint * center,
+           SDL_RendererFlip flip, SDL_bool smooth, const Uint8 * coverage)
+{
+    const SDL_BlitMap *map = src->map;
+    Uint32 span_pixels[AFFINE_CHUNK];
+    SDL_AffineSpan span;
+    SDL_BlitInfo info;
+    SDL_Rect bounds;
+    double turns, cangle, sangle, cx, cy, sx, sy;
+    double ux, uy, u0, vx, vy, v0;
+    double minx, miny, maxx, maxy;
+    SDL_bool use_sse2 = SDL_FALSE;
+    int i, x, y;
+
+    if (srcrect->w <= 0 || srcrect->h <= 0 || dstrect->w <= 0 || dstrect->h <= 0) {
+        return 0;
+    }
+    if (src->format->BytesPerPixel != 2 && src->format->BytesPerPixel != 4) {
+        return SDL_SetError("Unsupported texture format for rotation");
+    }
+    if (srcrect->w >= 0x8000 || srcrect->h >= 0x8000) {
+        return SDL_SetError("Texture is too large for rotation");
+    }
+
+    /* Quarter turns are exact, so they land on the same pixels as a copy */
+    turns = angle / 90.0;
+    if (turns == SDL_floor(turns)) {
+        switch ((int) (turns - 4.0 * SDL_floor(turns / 4.0))) {
+        case 0:
+            cangle = 1.0;
+            sangle = 0.0;
+            break;
+        case 1:
+            cangle = 0.0;
+            sangle = 1.0;
+            break;
+        case 2:
+            cangle = -1.0;
+            sangle = 0.0;
+            break;
+        default:
+            cangle = 0.0;
+            sangle = -1.0;
+            break;
+        }
+    } else {
+        const double radians = angle * M_PI / 180.0;
+
+        cangle = SDL_cos(radians);
+        sangle = SDL_sin(radians);
+    }
+
+    /* The destination area is the rotated rectangle's bounding box */
+    cx = dstrect->x + center->x;
+    cy = dstrect->y + center->y;
+    minx = miny = 1e30;
+    maxx = maxy = -1e30;
+    for (i = 0; i < 4; ++i) {
+        const double px = ((i & 1) ? dstrect->x + dstrect->w : dstrect->x) - cx;
+        const double py = ((i & 2) ? dstrect->y + dstrect->h : dstrect->y) - cy;
+        const double qx = px * cangle - py * sangle + cx;
+        const double qy = px * sangle + py * cangle + cy;
+
+        minx = SDL_min(minx, qx);
+        maxx = SDL_max(maxx, qx);
+        miny = SDL_min(miny, qy);
+        maxy = SDL_max(maxy, qy);
+    }
+    bounds.x = (int) SDL_floor(minx);
+    bounds.y = (int) SDL_floor(miny);
+    bounds.w = (int) SDL_ceil(maxx) - bounds.x;
+    bounds.h = (int) SDL_ceil(maxy) - bounds.y;
+    if (!SDL_IntersectRect(&bounds, &dst->clip_rect, &bounds)) {
+        return 0;
+    }
+
+    /* Map a destination pixel center back into the rectangle, then flip
+       and scale it to the source:  u = ux * x + uy * y + u0
+     */
+    sx = (double) srcrect->w / dstrect->w;
+    sy = (double) srcrect->h / dstrect->h;
+    if (flip & SDL_FLIP_HORIZONTAL) {
+        sx = -sx;
+    }
+    if (flip & SDL_FLIP_VERTICAL) {
+        sy = -sy;
+    }
+    ux = cangle * sx;
+    uy = sangle * sx;
+    u0 = ((0.5 - cx) * cangle + (0.5 - cy) * sangle + center->x) * sx;
+    vx = -sangle * sy;
+    vy = cangle * sy;
+    v0 = (-(0.5 - cx) * sangle + (0.5 - cy) * cangle + center->y) * sy;
+    if (flip & SDL_FLIP_HORIZONTAL) {
+        u0 += srcrect->w;
+    }
+    if (flip & SDL_FLIP_VERTICAL) {
+        v0 += srcrect->h;
+    }
+
+    span.fmt = src->format;
+    span.pixels = (const Uint8 *) src->pixels + srcrect->y * src->pitch +
+                  srcrect->x * src->format->BytesPerPixel;
+    span.pitch = src->pitch;
+    span.w = srcrect->w;
+    span.h = srcrect->h;
+    span.du = ToFixed(ux);
+    span.dv = ToFixed(vx);
+
+    /* The blend mode and modulation are the ones the blitter would use */
+    SDL_zero(info);
+    info.flags = map->info.flags & (SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA |
+                                    SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD);
+    info.r = map->info.r;
+    info.g = map->info.g;
+    info.b = map->info.b;
+    info.a = map->info.a;
+    info.dst_fmt = dst->format;
+#ifdef __SSE2__
+    use_sse2 = (SDL_HasSSE2() &&
+                (dst->format->format == SDL_PIXELFORMAT_ARGB8888 ||
+                 dst->format->format == SDL_PIXELFORMAT_RGB888));
+#endif
+
+    /* Lock the touched area so a window surface knows what changed */
+    SDL_LockSurfaceRect(dst, &bounds);
+
+    for (y = bounds.y; y < bounds.y + bounds.h; ++y) {
+        const Sint32 u = ToFixed(ux * bounds.x + uy * y + u0);
+        const Sint32 v = ToFixed(vx * bounds.x + vy * y + v0);
+        int first = 0;
+        int last = bounds.w - 1;
+
+        /* Only the pixels that map inside the source rectangle are drawn */
+        ClipSpan(u, span.du, (Sint64) span.w << 16, &first, &last);
+        ClipSpan(v, span.dv, (Sint64) span.h << 16, &first, &last);
+
+        for (x = first; x <= last; x += AFFINE_CHUNK) {
+            const int n = SDL_min(last - x + 1, AFFINE_CHUNK);
+            Uint8 *pixel = (Uint8 *) dst->pixels + y * dst->pitch +
+                           (bounds.x + x) * dst->format->BytesPerPixel;
+
+            span.u = (Sint32) (u + (Sint64) x * span.du);
+            span.v = (Sint32) (v + (Sint64) x * span.dv);
+            if (smooth) {
+                SampleBilinear(&span, span_pixels, n);
+            } else {
+                SampleNearest(&span, span_pixels, n);
+            }
+            if (coverage) {
+                ApplyCoverage(span_pixels, n, coverage);
+            }
+#ifdef __SSE2__
+            if (use_sse2) {
+                CompositeSpan_SSE2(&info, span_pixels, (Uint32 *) pixel, n);
+                continue;
+            }
+#endif
+            CompositeSpan(&info, span_pixels, pixel, n);
+        }
+    }
+
+    SDL_UnlockSurface(dst);
+    return 0;
+}
+
+int
+SDL_BlitAffine(SDL_Surface * src, const SDL_Rect * srcrect,
+               SDL_Surface * dst, const SDL_Rect * dstrect,
+               double angle, const SDL_FPoint * center,
+               SDL_RendererFlip flip, SDL_bool smooth)
+{
+    return BlitAffine(src, srcrect, dst, dstrect, angle, center, flip,
+                      smooth, NULL);
+}
+
+int
+SDL_BlitDistanceField(SDL_Surface * src, const SDL_Rect * srcrect,
+                      SDL_Surface * dst, const SDL_Rect * dstrect,
+                      double angle, const SDL_FPoint * center,
+                      SDL_RendererFlip flip, int spread, Uint8 threshold)
+{
+    Uint8 coverage[256];
+    double scale, slope;
+    int i;
+
+    if (srcrect->w <= 0 || srcrect->h <= 0 || dstrect->w <= 0 || dstrect->h <= 0) {
+        return 0;
+    }
+
+    /* An alpha step is 2 * spread / 255 source pixels from the edge, and
+       the coverage goes from 0 to 1 over one destination pixel across it.
+     */
+    scale = SDL_sqrt(((double) dstrect->w * dstrect->h) /
+                     ((double) srcrect->w * srcrect->h));
+    slope = 2.0 * spread * scale / 255.0;
+    for (i = 0; i < 256; ++i) {
+        const double c = (i - threshold) * slope + 0.5;
+
+        if (c <= 0.0) {
+            coverage[i] = 0;
+        } else if (c >= 1.0) {
+            coverage[i] = 255;
+        } else {
+            coverage[i] = (Uint8) (c * 255.0 + 0.5);
+        }
+    }
+    return BlitAffine(src, srcrect, dst, dstrect, angle, center, flip,
+                      SDL_TRUE, coverage);
+}
+
+#endif /* !SDL_RENDER_DISABLED */
+
+/* vi: set ts=4 sw=4 expandtab: */
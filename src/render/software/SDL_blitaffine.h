@@ -0,0 +1,45 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+#include "../SDL_sysrender.h"
+
+/* Rotated and flipped copies are drawn by walking the destination pixels
+   inside the rotated rectangle and mapping each one back into the source,
+   so there's no intermediate surface.  The source modulation and blend mode
+   are applied the same way SDL_BlitSurface() applies them.
+ */
+extern int SDL_BlitAffine(SDL_Surface * src, const SDL_Rect * srcrect,
+                          SDL_Surface * dst, const SDL_Rect * dstrect,
+                          double angle, const SDL_FPoint * center,
+                          SDL_RendererFlip flip, SDL_bool smooth);
+
+/* Distance field textures are drawn the same way with smooth sampling, and
+   then the sampled alpha is turned into coverage of the edge at threshold.
+   This is the reference for renderers that do it in a shader.
+ */
+extern int SDL_BlitDistanceField(SDL_Surface * src, const SDL_Rect * srcrect,
+                                 SDL_Surface * dst, const SDL_Rect * dstrect,
+                                 double angle, const SDL_FPoint * center,
+                                 SDL_RendererFlip flip, int spread,
+                                 Uint8 threshold);
+
+/* vi: set ts=4 sw=4 expandtab: */
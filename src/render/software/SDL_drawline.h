@@ -20,7 +20,10 @@
 */
 #include "SDL_config.h"
 
-
+/* These write the pixels directly.  The caller locks the area the lines
+   cover with SDL_LockSurfaceRect(), so an RLE encoded surface re-encodes
+   those rows and a window surface records them as changed.
+ */
 extern int SDL_DrawLine(SDL_Surface * dst, int x1, int y1, int x2, int y2, Uint32 color);
 extern int SDL_DrawLines(SDL_Surface * dst, const SDL_Point * points, int count, Uint32 color);
 
@@ -20,7 +20,9 @@
 */
 #include "SDL_config.h"
 
-
+/* The points are written directly, the caller locks the area they cover
+   with SDL_LockSurfaceRect() to keep an RLE encoding up to date.
+ */
 extern int SDL_DrawPoint(SDL_Surface * dst, int x, int y, Uint32 color);
 extern int SDL_DrawPoints(SDL_Surface * dst, const SDL_Point * points, int count, Uint32 color);
 
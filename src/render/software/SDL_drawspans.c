@@ -0,0 +1,310 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+#if !SDL_RENDER_DISABLED
+
+#include "SDL_cpuinfo.h"
+#include "SDL_draw.h"
+#include "SDL_drawspans.h"
+#include "SDL_blendfillrect.h"
+
+SDL_Rect *
+SDL_ReserveSpans(SDL_SpanBuffer * buffer, int count)
+{
+    SDL_Rect *spans;
+
+    if (buffer->count + count > buffer->capacity) {
+        int capacity = SDL_max(buffer->capacity * 2, buffer->count + count);
+
+        capacity = SDL_max(capacity, 256);
+        spans = (SDL_Rect *) SDL_realloc(buffer->spans, capacity * sizeof(*spans));
+        if (!spans) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        buffer->spans = spans;
+        buffer->capacity = capacity;
+    }
+    spans = &buffer->spans[buffer->count];
+    buffer->count += count;
+    return spans;
+}
+
+int
+SDL_AddSpanRect(SDL_SpanBuffer * buffer, const SDL_Rect * clip,
+                const SDL_Rect * rect)
+{
+    SDL_Rect clipped;
+    SDL_Rect *spans;
+    int i;
+
+    if (!SDL_IntersectRect(rect, clip, &clipped)) {
+        return 0;
+    }
+
+    spans = SDL_ReserveSpans(buffer, clipped.h);
+    if (!spans) {
+        return -1;
+    }
+    for (i = 0; i < clipped.h; ++i) {
+        spans[i].x = clipped.x;
+        spans[i].y = clipped.y + i;
+        spans[i].w = clipped.w;
+        spans[i].h = 1;
+    }
+    return 0;
+}
+
+/* Put the spans in scanline order.  This is a counting sort on y, so it
+   costs a couple of passes over the spans rather than a comparison sort.
+   It only improves locality, so the spans are left alone if there's no
+   memory for it.
+ */
+static void
+SDL_SortSpans(SDL_SpanBuffer * buffer)
+{
+    SDL_Rect *spans = buffer->spans;
+    const int count = buffer->count;
+    SDL_bool sorted = SDL_TRUE;
+    int i, row, miny, maxy, num_rows;
+    int *rows;
+
+    miny = maxy = spans[0].y;
+    for (i = 1; i < count; ++i) {
+        const int y = spans[i].y;
+
+        if (y < spans[i-1].y) {
+            sorted = SDL_FALSE;
+        }
+        miny = SDL_min(miny, y);
+        maxy = SDL_max(maxy, y);
+    }
+
+    /* A single rectangle is already in order */
+    if (sorted) {
+        return;
+    }
+
+    num_rows = maxy - miny + 1;
+    if (buffer->sorted_capacity < buffer->capacity) {
+        SDL_Rect *scratch = (SDL_Rect *) SDL_realloc(buffer->sorted, buffer->capacity * sizeof(*scratch));
+        if (!scratch) {
+            return;
+        }
+        buffer->sorted = scratch;
+        buffer->sorted_capacity = buffer->capacity;
+    }
+    if (buffer->num_rows < num_rows + 1) {
+        rows = (int *) SDL_realloc(buffer->rows, (num_rows + 1) * sizeof(*rows));
+        if (!rows) {
+            return;
+        }
+        buffer->rows = rows;
+        buffer->num_rows = num_rows + 1;
+    }
+    rows = buffer->rows;
+
+    /* rows[row] is where the spans for that row start */
+    SDL_memset(rows, 0, (num_rows + 1) * sizeof(*rows));
+    for (i = 0; i < count; ++i) {
+        ++rows[spans[i].y - miny + 1];
+    }
+    for (row = 1; row <= num_rows; ++row) {
+        rows[row] += rows[row-1];
+    }
+    for (i = 0; i < count; ++i) {
+        buffer->sorted[rows[spans[i].y - miny]++] = spans[i];
+    }
+
+    /* The scratch buffer becomes the span buffer */
+    buffer->spans = buffer->sorted;
+    buffer->sorted = spans;
+    i = buffer->capacity;
+    buffer->capacity = buffer->sorted_capacity;
+    buffer->sorted_capacity = i;
+}
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+/* *INDENT-OFF* */
+
+/* x / 255 for x <= 255*255, the same as DRAW_MUL() */
+#define DIV255_EPI16(x) \
+    _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8)), 8)
+
+#define SPAN_SSE2_LOOP(op) \
+    for (; n >= 4; n -= 4, pixel += 4) { \
+        __m128i d = _mm_loadu_si128((const __m128i *)pixel); \
+        __m128i lo = _mm_unpacklo_epi8(d, zero); \
+        __m128i hi = _mm_unpackhi_epi8(d, zero); \
+        __m128i res; \
+        op; \
+        res = _mm_packus_epi16(lo, hi); \
+        res = _mm_or_si128(_mm_and_si128(res, rgbmask), \
+                           _mm_and_si128(d, keepmask)); \
+        _mm_storeu_si128((__m128i *)pixel, res); \
+    }
+
+#define SPAN_SSE2_BLEND \
+    lo = _mm_add_epi16(DIV255_EPI16(_mm_mullo_epi16(lo, inva16)), color16); \
+    hi = _mm_add_epi16(DIV255_EPI16(_mm_mullo_epi16(hi, inva16)), color16)
+
+#define SPAN_SSE2_ADD \
+    lo = _mm_adds_epu16(lo, color16); \
+    hi = _mm_adds_epu16(hi, color16); \
+    lo = _mm_min_epi16(lo, max16); \
+    hi = _mm_min_epi16(hi, max16)
+
+#define SPAN_SSE2_MOD \
+    lo = DIV255_EPI16(_mm_mullo_epi16(lo, color16)); \
+    hi = DIV255_EPI16(_mm_mullo_epi16(hi, color16))
+
+/* *INDENT-ON* */
+
+/* Blend a span of RGB888 or ARGB8888 pixels, four at a time.  The color is
+   premultiplied as for the DRAW_SETPIXEL_BLEND macros, and the destination
+   alpha is kept for ARGB8888, the same as the scalar code does.
+ */
+static void
+SDL_BlendSpan_8888_SSE2(Uint32 * pixel, int n, SDL_BlendMode blendMode,
+                        unsigned r, unsigned g, unsigned b, unsigned a,
+                        SDL_bool keep_alpha)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i max16 = _mm_set1_epi16(0xff);
+    const __m128i color16 = _mm_unpacklo_epi8(
+        _mm_set1_epi32((int)((r << 16) | (g << 8) | b)), zero);
+    const __m128i inva16 = _mm_set1_epi16((short)(0xff - a));
+    const __m128i rgbmask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i keepmask = _mm_set1_epi32(keep_alpha ? 0xFF000000 : 0);
+    unsigned inva = 0xff - a;
+
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        SPAN_SSE2_LOOP(SPAN_SSE2_BLEND);
+        break;
+    case SDL_BLENDMODE_ADD:
+        SPAN_SSE2_LOOP(SPAN_SSE2_ADD);
+        break;
+    case SDL_BLENDMODE_MOD:
+        SPAN_SSE2_LOOP(SPAN_SSE2_MOD);
+        break;
+    default:
+        break;
+    }
+
+    /* Finish the last few pixels the same way SDL_BlendFillRect() does */
+    for (; n > 0; --n, ++pixel) {
+        if (keep_alpha) {
+            switch (blendMode) {
+            case SDL_BLENDMODE_BLEND:
+                DRAW_SETPIXEL_BLEND_ARGB8888;
+                break;
+            case SDL_BLENDMODE_ADD:
+                DRAW_SETPIXEL_ADD_ARGB8888;
+                break;
+            default:
+                DRAW_SETPIXEL_MOD_ARGB8888;
+                break;
+            }
+        } else {
+            switch (blendMode) {
+            case SDL_BLENDMODE_BLEND:
+                DRAW_SETPIXEL_BLEND_RGB888;
+                break;
+            case SDL_BLENDMODE_ADD:
+                DRAW_SETPIXEL_ADD_RGB888;
+                break;
+            default:
+                DRAW_SETPIXEL_MOD_RGB888;
+                break;
+            }
+        }
+    }
+}
+#endif /* __SSE2__ */
+
+int
+SDL_BlendSpans(SDL_Surface * dst, SDL_SpanBuffer * buffer,
+               SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    SDL_Rect *spans;
+    int count = buffer->count;
+
+    if (!dst) {
+        buffer->count = 0;
+        return SDL_SetError("Passed NULL destination surface");
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    /* Blending isn't idempotent, so overlapping spans are all kept and
+       only sorted, to walk the rows in memory order.
+     */
+    SDL_SortSpans(buffer);
+    spans = buffer->spans;
+    buffer->count = 0;
+
+#ifdef __SSE2__
+    if (SDL_HasSSE2() &&
+        dst->format->BytesPerPixel == 4 &&
+        dst->format->Rmask == 0x00FF0000 &&
+        dst->format->Gmask == 0x0000FF00 &&
+        dst->format->Bmask == 0x000000FF &&
+        (dst->format->Amask == 0xFF000000 || dst->format->Amask == 0) &&
+        (blendMode == SDL_BLENDMODE_BLEND || blendMode == SDL_BLENDMODE_ADD ||
+         blendMode == SDL_BLENDMODE_MOD)) {
+        const SDL_bool keep_alpha = (dst->format->Amask != 0);
+        int i;
+
+        if (blendMode == SDL_BLENDMODE_BLEND || blendMode == SDL_BLENDMODE_ADD) {
+            r = DRAW_MUL(r, a);
+            g = DRAW_MUL(g, a);
+            b = DRAW_MUL(b, a);
+        }
+        for (i = 0; i < count; ++i) {
+            Uint32 *pixel = (Uint32 *)((Uint8 *)dst->pixels +
+                                       spans[i].y * dst->pitch) + spans[i].x;
+            SDL_BlendSpan_8888_SSE2(pixel, spans[i].w, blendMode,
+                                    r, g, b, a, keep_alpha);
+        }
+        return 0;
+    }
+#endif
+    return SDL_BlendFillRects(dst, spans, count, blendMode, r, g, b, a);
+}
+
+void
+SDL_FreeSpans(SDL_SpanBuffer * buffer)
+{
+    SDL_free(buffer->spans);
+    SDL_free(buffer->sorted);
+    SDL_free(buffer->rows);
+    SDL_zerop(buffer);
+}
+
+#endif /* !SDL_RENDER_DISABLED */
+
+/* vi: set ts=4 sw=4 expandtab: */
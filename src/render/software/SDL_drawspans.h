@@ -0,0 +1,48 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+/* Blended rectangles are broken down into horizontal spans, stored as
+   rectangles one pixel high, and drawn sorted by scanline.  The spans cover
+   exactly the pixels SDL_BlendFillRects() would touch.
+ */
+typedef struct SDL_SpanBuffer
+{
+    SDL_Rect *spans;
+    int count;
+    int capacity;
+
+    /* Scratch space for sorting the spans by scanline */
+    SDL_Rect *sorted;
+    int sorted_capacity;
+    int *rows;
+    int num_rows;
+} SDL_SpanBuffer;
+
+/* Draw the buffered spans once there are this many of them */
+#define SDL_SPAN_BATCH  16384
+
+extern SDL_Rect *SDL_ReserveSpans(SDL_SpanBuffer * buffer, int count);
+extern int SDL_AddSpanRect(SDL_SpanBuffer * buffer, const SDL_Rect * clip, const SDL_Rect * rect);
+extern int SDL_BlendSpans(SDL_Surface * dst, SDL_SpanBuffer * buffer, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+extern void SDL_FreeSpans(SDL_SpanBuffer * buffer);
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,789 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+#if !SDL_RENDER_DISABLED
+
+#include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_thread.h"
+#include "../../video/SDL_pixels_c.h"
+#include "SDL_draw.h"
+#include "SDL_blendpoint.h"
+#include "SDL_drawpoint.h"
+#include "SDL_drawspans.h"
+#include "SDL_drawtiles.h"
+
+/* Tiles are wide, so each of their rows is a decent run of memory */
+#define TILE_W  128
+#define TILE_H  64
+
+/* Draw the recorded commands once there are this many of them */
+#define TILE_BATCH  16384
+
+typedef enum
+{
+    SDL_TILECMD_CLEAR,
+    SDL_TILECMD_FILLRECT,
+    SDL_TILECMD_POINTS,
+    SDL_TILECMD_BLIT
+} SDL_TileCommandType;
+
+typedef struct
+{
+    SDL_TileCommandType type;
+    SDL_BlendMode blendMode;
+    Uint8 r, g, b, a;
+    Uint32 color;               /**< The mapped color, for unblended draws */
+    SDL_Rect bounds;            /**< The area drawn, clipped */
+    SDL_Rect rect;              /**< The rectangle, or where the blit goes */
+    SDL_Rect srcrect;
+    SDL_Surface *src;           /**< The blit source, NULL to skip it */
+    int first;                  /**< The points of SDL_TILECMD_POINTS */
+    int count;
+} SDL_TileCommand;
+
+typedef struct
+{
+    int *commands;
+    int count;
+    int capacity;
+} SDL_TileBin;
+
+typedef struct
+{
+    SDL_TileQueue *queue;
+    SDL_Thread *thread;
+    SDL_SpanBuffer spans;
+    SDL_Rect *rects;
+    int max_rects;
+} SDL_TileWorker;
+
+/* A surface blitted from in this flush and the state it had before */
+typedef struct
+{
+    SDL_Surface *src;
+    Uint8 r, g, b, a;
+    SDL_BlendMode blendMode;
+    Uint8 saved_r, saved_g, saved_b, saved_a;
+    SDL_BlendMode saved_blendMode;
+    int segment;                /**< The first command of the last run using it */
+} SDL_TileSource;
+
+struct SDL_TileQueue
+{
+    SDL_Surface *dst;
+    SDL_Rect clip;
+
+    SDL_TileCommand *commands;
+    int num_commands;
+    int max_commands;
+    SDL_Point *points;
+    int num_points;
+    int max_points;
+
+    SDL_TileSource *sources;
+    int num_sources;
+    int max_sources;
+
+    /* The commands being drawn, binned by tile */
+    int first;
+    int last;
+    SDL_TileBin *bins;
+    int max_bins;
+    int cols;
+    int rows;
+    SDL_atomic_t next_tile;
+
+    /* The calling thread is worker 0 */
+    SDL_TileWorker *workers;
+    int num_workers;
+    SDL_sem *start;
+    SDL_sem *done;
+    SDL_bool quit;
+};
+
+/* Clip a blit the same way SDL_UpperBlit() does */
+static SDL_bool
+ClipBlit(SDL_Surface * src, const SDL_Rect * srcrect, const SDL_Rect * clip,
+         const SDL_Rect * dstrect, SDL_Rect * sr, SDL_Rect * dr)
+{
+    int srcx, srcy, w, h, maxw, maxh, dx, dy;
+
+    *dr = *dstrect;
+
+    srcx = srcrect->x;
+    w = srcrect->w;
+    if (srcx < 0) {
+        w += srcx;
+        dr->x -= srcx;
+        srcx = 0;
+    }
+    maxw = src->w - srcx;
+    if (maxw < w) {
+        w = maxw;
+    }
+
+    srcy = srcrect->y;
+    h = srcrect->h;
+    if (srcy < 0) {
+        h += srcy;
+        dr->y -= srcy;
+        srcy = 0;
+    }
+    maxh = src->h - srcy;
+    if (maxh < h) {
+        h = maxh;
+    }
+
+    dx = clip->x - dr->x;
+    if (dx > 0) {
+        w -= dx;
+        dr->x += dx;
+        srcx += dx;
+    }
+    dx = dr->x + w - clip->x - clip->w;
+    if (dx > 0) {
+        w -= dx;
+    }
+
+    dy = clip->y - dr->y;
+    if (dy > 0) {
+        h -= dy;
+        dr->y += dy;
+        srcy += dy;
+    }
+    dy = dr->y + h - clip->y - clip->h;
+    if (dy > 0) {
+        h -= dy;
+    }
+
+    if (w <= 0 || h <= 0) {
+        return SDL_FALSE;
+    }
+    sr->x = srcx;
+    sr->y = srcy;
+    sr->w = dr->w = w;
+    sr->h = dr->h = h;
+    return SDL_TRUE;
+}
+
+static SDL_bool
+SameFill(const SDL_TileCommand * a, const SDL_TileCommand * b)
+{
+    return (b->type == SDL_TILECMD_FILLRECT &&
+            a->blendMode == b->blendMode && a->color == b->color &&
+            a->r == b->r && a->g == b->g && a->b == b->b && a->a == b->a);
+}
+
+/* Fill a run of rectangles of one color the way SW_RenderFillRects() does */
+static void
+DrawFills(SDL_TileQueue * queue, SDL_TileWorker * worker, SDL_Surface * view,
+          const int *commands, int count)
+{
+    const SDL_TileCommand *cmd = &queue->commands[commands[0]];
+    int i;
+
+    if (count > worker->max_rects) {
+        SDL_Rect *rects = (SDL_Rect *) SDL_realloc(worker->rects, count * sizeof(*rects));
+        if (rects) {
+            worker->rects = rects;
+            worker->max_rects = count;
+        }
+    }
+
+    if (cmd->blendMode == SDL_BLENDMODE_NONE) {
+        if (count > worker->max_rects) {
+            for (i = 0; i < count; ++i) {
+                SDL_FillRect(view, &queue->commands[commands[i]].rect, cmd->color);
+            }
+            return;
+        }
+        for (i = 0; i < count; ++i) {
+            worker->rects[i] = queue->commands[commands[i]].rect;
+        }
+        SDL_FillRects(view, worker->rects, count, cmd->color);
+        return;
+    }
+
+    for (i = 0; i < count; ++i) {
+        if (SDL_AddSpanRect(&worker->spans, &view->clip_rect, &queue->commands[commands[i]].rect) < 0) {
+            worker->spans.count = 0;
+            return;
+        }
+        if (worker->spans.count >= SDL_SPAN_BATCH) {
+            SDL_BlendSpans(view, &worker->spans, cmd->blendMode,
+                           cmd->r, cmd->g, cmd->b, cmd->a);
+        }
+    }
+    SDL_BlendSpans(view, &worker->spans, cmd->blendMode,
+                   cmd->r, cmd->g, cmd->b, cmd->a);
+}
+
+static void
+DrawTile(SDL_TileQueue * queue, SDL_TileWorker * worker, int tile)
+{
+    SDL_TileBin *bin = &queue->bins[tile];
+    SDL_Surface view;
+    SDL_Rect tile_rect, clip;
+    int i, n;
+
+    if (bin->count == 0) {
+        return;
+    }
+
+    tile_rect.x = (tile % queue->cols) * TILE_W;
+    tile_rect.y = (tile / queue->cols) * TILE_H;
+    tile_rect.w = SDL_min(TILE_W, queue->dst->w - tile_rect.x);
+    tile_rect.h = SDL_min(TILE_H, queue->dst->h - tile_rect.y);
+
+    /* Draw through a copy of the surface clipped to the tile.  The copy
+       doesn't record changes, the whole area was marked before drawing.
+     */
+    view = *queue->dst;
+    view.flags &= ~SDL_TRACKDIRTY;
+    if (!SDL_IntersectRect(&tile_rect, &queue->clip, &view.clip_rect)) {
+        SDL_zero(view.clip_rect);
+    }
+
+    for (i = 0; i < bin->count; i += n) {
+        const SDL_TileCommand *cmd = &queue->commands[bin->commands[i]];
+
+        n = 1;
+        switch (cmd->type) {
+        case SDL_TILECMD_CLEAR:
+            /* By definition the clear ignores the clip rect */
+            clip = view.clip_rect;
+            view.clip_rect = tile_rect;
+            SDL_FillRect(&view, NULL, cmd->color);
+            view.clip_rect = clip;
+            break;
+        case SDL_TILECMD_FILLRECT:
+            while (i + n < bin->count &&
+                   SameFill(cmd, &queue->commands[bin->commands[i + n]])) {
+                ++n;
+            }
+            DrawFills(queue, worker, &view, &bin->commands[i], n);
+            break;
+        case SDL_TILECMD_POINTS:
+            if (cmd->blendMode == SDL_BLENDMODE_NONE) {
+                SDL_DrawPoints(&view, &queue->points[cmd->first], cmd->count,
+                               cmd->color);
+            } else {
+                SDL_BlendPoints(&view, &queue->points[cmd->first], cmd->count,
+                                cmd->blendMode, cmd->r, cmd->g, cmd->b, cmd->a);
+            }
+            break;
+        case SDL_TILECMD_BLIT:
+            if (cmd->src) {
+                SDL_Rect sr, dr;
+
+                /* The blit map was set up for this surface before drawing */
+                if (ClipBlit(cmd->src, &cmd->srcrect, &view.clip_rect,
+                             &cmd->rect, &sr, &dr)) {
+                    cmd->src->map->blit(cmd->src, &sr, &view, &dr);
+                }
+            }
+            break;
+        }
+    }
+}
+
+static void
+DrawTiles(SDL_TileQueue * queue, SDL_TileWorker * worker)
+{
+    const int num_tiles = queue->cols * queue->rows;
+    int tile;
+
+    while ((tile = SDL_AtomicAdd(&queue->next_tile, 1)) < num_tiles) {
+        DrawTile(queue, worker, tile);
+    }
+}
+
+static int SDLCALL
+SDL_TileThread(void *data)
+{
+    SDL_TileWorker *worker = (SDL_TileWorker *) data;
+    SDL_TileQueue *queue = worker->queue;
+
+    for ( ; ; ) {
+        SDL_SemWait(queue->start);
+        if (queue->quit) {
+            break;
+        }
+        DrawTiles(queue, worker);
+        SDL_SemPost(queue->done);
+    }
+    return 0;
+}
+
+static int
+AddToBin(SDL_TileBin * bin, int command)
+{
+    if (bin->count == bin->capacity) {
+        int capacity = SDL_max(bin->capacity * 2, 64);
+        int *commands = (int *) SDL_realloc(bin->commands, capacity * sizeof(*commands));
+
+        if (!commands) {
+            return SDL_OutOfMemory();
+        }
+        bin->commands = commands;
+        bin->capacity = capacity;
+    }
+    bin->commands[bin->count++] = command;
+    return 0;
+}
+
+/* Bin a run of commands and draw the tiles on all the threads */
+static int
+DrawCommands(SDL_TileQueue * queue, int first, int last)
+{
+    SDL_Surface *dst = queue->dst;
+    SDL_Rect bounds;
+    int i, x, y, num_tiles, status = 0;
+
+    if (first == last) {
+        return 0;
+    }
+
+    queue->cols = (dst->w + TILE_W - 1) / TILE_W;
+    queue->rows = (dst->h + TILE_H - 1) / TILE_H;
+    num_tiles = queue->cols * queue->rows;
+    if (num_tiles > queue->max_bins) {
+        SDL_TileBin *bins = (SDL_TileBin *) SDL_realloc(queue->bins, num_tiles * sizeof(*bins));
+
+        if (!bins) {
+            return SDL_OutOfMemory();
+        }
+        SDL_memset(&bins[queue->max_bins], 0,
+                   (num_tiles - queue->max_bins) * sizeof(*bins));
+        queue->bins = bins;
+        queue->max_bins = num_tiles;
+    }
+    for (i = 0; i < num_tiles; ++i) {
+        queue->bins[i].count = 0;
+    }
+
+    bounds = queue->commands[first].bounds;
+    for (i = first; i < last; ++i) {
+        const SDL_Rect *rect = &queue->commands[i].bounds;
+        const int x0 = rect->x / TILE_W;
+        const int x1 = (rect->x + rect->w - 1) / TILE_W;
+        const int y0 = rect->y / TILE_H;
+        const int y1 = (rect->y + rect->h - 1) / TILE_H;
+
+        for (y = y0; y <= y1; ++y) {
+            for (x = x0; x <= x1; ++x) {
+                if (AddToBin(&queue->bins[y * queue->cols + x], i) < 0) {
+                    status = -1;
+                }
+            }
+        }
+        SDL_UnionRect(&bounds, rect, &bounds);
+    }
+
+    /* Mark the whole area at once, so a window surface knows what changed */
+    SDL_LockSurfaceRect(dst, &bounds);
+
+    SDL_AtomicSet(&queue->next_tile, 0);
+    for (i = 1; i < queue->num_workers; ++i) {
+        SDL_SemPost(queue->start);
+    }
+    DrawTiles(queue, &queue->workers[0]);
+    for (i = 1; i < queue->num_workers; ++i) {
+        SDL_SemWait(queue->done);
+    }
+
+    SDL_UnlockSurface(dst);
+    return status;
+}
+
+static SDL_TileSource *
+GetSource(SDL_TileQueue * queue, SDL_Surface * src)
+{
+    SDL_TileSource *source;
+    int i;
+
+    for (i = 0; i < queue->num_sources; ++i) {
+        if (queue->sources[i].src == src) {
+            return &queue->sources[i];
+        }
+    }
+
+    if (queue->num_sources == queue->max_sources) {
+        int max_sources = SDL_max(queue->max_sources * 2, 16);
+
+        source = (SDL_TileSource *) SDL_realloc(queue->sources, max_sources * sizeof(*source));
+        if (!source) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        queue->sources = source;
+        queue->max_sources = max_sources;
+    }
+    source = &queue->sources[queue->num_sources++];
+    source->src = src;
+    SDL_GetSurfaceColorMod(src, &source->r, &source->g, &source->b);
+    SDL_GetSurfaceAlphaMod(src, &source->a);
+    SDL_GetSurfaceBlendMode(src, &source->blendMode);
+    source->saved_r = source->r;
+    source->saved_g = source->g;
+    source->saved_b = source->b;
+    source->saved_a = source->a;
+    source->saved_blendMode = source->blendMode;
+    source->segment = -1;
+    return source;
+}
+
+static void
+SetSourceState(SDL_TileSource * source, Uint8 r, Uint8 g, Uint8 b, Uint8 a,
+               SDL_BlendMode blendMode)
+{
+    if (r != source->r || g != source->g || b != source->b) {
+        SDL_SetSurfaceColorMod(source->src, r, g, b);
+        source->r = r;
+        source->g = g;
+        source->b = b;
+    }
+    if (a != source->a) {
+        SDL_SetSurfaceAlphaMod(source->src, a);
+        source->a = a;
+    }
+    if (blendMode != source->blendMode) {
+        SDL_SetSurfaceBlendMode(source->src, blendMode);
+        source->blendMode = blendMode;
+    }
+}
+
+/* Get a blit source ready to be used from the worker threads */
+static int
+PrepareBlit(SDL_TileQueue * queue, SDL_TileCommand * cmd, int *first, int i)
+{
+    SDL_Surface *src = cmd->src;
+    SDL_Surface *dst = queue->dst;
+    SDL_TileSource *source = GetSource(queue, src);
+    int status = 0;
+
+    if (!source) {
+        cmd->src = NULL;
+        return -1;
+    }
+
+    if (cmd->r != source->r || cmd->g != source->g || cmd->b != source->b ||
+        cmd->a != source->a || cmd->blendMode != source->blendMode) {
+        /* The surface can't change while the threads are blitting from it */
+        if (source->segment == *first) {
+            status = DrawCommands(queue, *first, i);
+            *first = i;
+        }
+        SetSourceState(source, cmd->r, cmd->g, cmd->b, cmd->a, cmd->blendMode);
+    }
+    source->segment = *first;
+
+    /* This is what SDL_UpperBlit() and SDL_LowerBlit() do before blitting */
+    SDL_SetBlitNearest(src, SDL_FALSE);
+    if ((src->map->dst != dst) ||
+        (dst->format->palette &&
+         src->map->dst_palette_version != dst->format->palette->version) ||
+        (src->format->palette &&
+         src->map->src_palette_version != src->format->palette->version)) {
+        if (SDL_MapSurface(src, dst) < 0) {
+            cmd->src = NULL;
+            return -1;
+        }
+    }
+    return status;
+}
+
+int
+SDL_FlushTiles(SDL_TileQueue * queue)
+{
+    int i, first, status = 0;
+
+    if (queue->num_commands == 0) {
+        return 0;
+    }
+
+    /* Runs of commands are drawn in parallel, but a blit source that needs
+       a different modulation than earlier in the run starts a new run.
+     */
+    first = 0;
+    for (i = 0; i < queue->num_commands; ++i) {
+        SDL_TileCommand *cmd = &queue->commands[i];
+
+        if (cmd->type == SDL_TILECMD_BLIT &&
+            PrepareBlit(queue, cmd, &first, i) < 0) {
+            status = -1;
+        }
+    }
+    if (DrawCommands(queue, first, queue->num_commands) < 0) {
+        status = -1;
+    }
+
+    /* Put back the state the sources had */
+    for (i = 0; i < queue->num_sources; ++i) {
+        SDL_TileSource *source = &queue->sources[i];
+
+        SetSourceState(source, source->saved_r, source->saved_g,
+                       source->saved_b, source->saved_a,
+                       source->saved_blendMode);
+    }
+    queue->num_sources = 0;
+
+    queue->num_commands = 0;
+    queue->num_points = 0;
+    return status;
+}
+
+static SDL_TileCommand *
+AddCommand(SDL_TileQueue * queue, SDL_Surface * dst, SDL_TileCommandType type)
+{
+    SDL_TileCommand *cmd;
+
+    /* The recorded draws all share a target and clip rectangle */
+    if (queue->num_commands > 0 &&
+        (dst != queue->dst || !SDL_RectEquals(&dst->clip_rect, &queue->clip) ||
+         queue->num_commands >= TILE_BATCH)) {
+        if (SDL_FlushTiles(queue) < 0) {
+            return NULL;
+        }
+    }
+    queue->dst = dst;
+    queue->clip = dst->clip_rect;
+
+    if (queue->num_commands == queue->max_commands) {
+        int max_commands = SDL_max(queue->max_commands * 2, 256);
+
+        cmd = (SDL_TileCommand *) SDL_realloc(queue->commands, max_commands * sizeof(*cmd));
+        if (!cmd) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        queue->commands = cmd;
+        queue->max_commands = max_commands;
+    }
+    cmd = &queue->commands[queue->num_commands++];
+    SDL_zerop(cmd);
+    cmd->type = type;
+    return cmd;
+}
+
+int
+SDL_TileClear(SDL_TileQueue * queue, SDL_Surface * dst, Uint32 color)
+{
+    SDL_TileCommand *cmd;
+
+    /* Everything recorded so far would be cleared away */
+    if (dst == queue->dst) {
+        queue->num_commands = 0;
+        queue->num_points = 0;
+    }
+
+    cmd = AddCommand(queue, dst, SDL_TILECMD_CLEAR);
+    if (!cmd) {
+        return -1;
+    }
+    cmd->color = color;
+    cmd->bounds.w = dst->w;
+    cmd->bounds.h = dst->h;
+    return 0;
+}
+
+int
+SDL_TileFillRects(SDL_TileQueue * queue, SDL_Surface * dst,
+                  const SDL_Rect * rects, int count, SDL_BlendMode blendMode,
+                  Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    const Uint32 color = SDL_MapRGBA(dst->format, r, g, b, a);
+    SDL_TileCommand *cmd;
+    SDL_Rect bounds;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        if (!SDL_IntersectRect(&rects[i], &dst->clip_rect, &bounds)) {
+            continue;
+        }
+
+        /* Each rectangle is binned on its own, and drawn with its neighbours */
+        cmd = AddCommand(queue, dst, SDL_TILECMD_FILLRECT);
+        if (!cmd) {
+            return -1;
+        }
+        cmd->blendMode = blendMode;
+        cmd->r = r;
+        cmd->g = g;
+        cmd->b = b;
+        cmd->a = a;
+        cmd->color = color;
+        cmd->rect = rects[i];
+        cmd->bounds = bounds;
+    }
+    return 0;
+}
+
+int
+SDL_TileDrawPoints(SDL_TileQueue * queue, SDL_Surface * dst,
+                   const SDL_Point * points, int count,
+                   SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    SDL_TileCommand *cmd;
+    SDL_Rect bounds;
+
+    if (!SDL_EnclosePoints(points, count, &dst->clip_rect, &bounds)) {
+        return 0;
+    }
+
+    cmd = AddCommand(queue, dst, SDL_TILECMD_POINTS);
+    if (!cmd) {
+        return -1;
+    }
+    if (queue->num_points + count > queue->max_points) {
+        int max_points = SDL_max(queue->max_points * 2, queue->num_points + count);
+        SDL_Point *new_points = (SDL_Point *) SDL_realloc(queue->points, max_points * sizeof(*new_points));
+
+        if (!new_points) {
+            --queue->num_commands;
+            return SDL_OutOfMemory();
+        }
+        queue->points = new_points;
+        queue->max_points = max_points;
+    }
+    SDL_memcpy(&queue->points[queue->num_points], points, count * sizeof(*points));
+
+    cmd->blendMode = blendMode;
+    cmd->r = r;
+    cmd->g = g;
+    cmd->b = b;
+    cmd->a = a;
+    cmd->color = SDL_MapRGBA(dst->format, r, g, b, a);
+    cmd->first = queue->num_points;
+    cmd->count = count;
+    cmd->bounds = bounds;
+    queue->num_points += count;
+    return 0;
+}
+
+int
+SDL_TileBlit(SDL_TileQueue * queue, SDL_Surface * src, const SDL_Rect * srcrect,
+             SDL_Surface * dst, const SDL_Rect * dstrect,
+             Uint8 r, Uint8 g, Uint8 b, Uint8 a, SDL_BlendMode blendMode)
+{
+    SDL_TileCommand *cmd;
+    SDL_Rect sr, bounds;
+
+    if (!ClipBlit(src, srcrect, &dst->clip_rect, dstrect, &sr, &bounds)) {
+        return 0;
+    }
+
+    cmd = AddCommand(queue, dst, SDL_TILECMD_BLIT);
+    if (!cmd) {
+        return -1;
+    }
+    cmd->src = src;
+    cmd->srcrect = *srcrect;
+    cmd->rect = *dstrect;
+    cmd->bounds = bounds;
+    cmd->r = r;
+    cmd->g = g;
+    cmd->b = b;
+    cmd->a = a;
+    cmd->blendMode = blendMode;
+    return 0;
+}
+
+SDL_TileQueue *
+SDL_CreateTileQueue(int num_threads)
+{
+    SDL_TileQueue *queue;
+    int i;
+
+    queue = (SDL_TileQueue *) SDL_calloc(1, sizeof(*queue));
+    if (!queue) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    queue->workers = (SDL_TileWorker *) SDL_calloc(num_threads, sizeof(*queue->workers));
+    queue->start = SDL_CreateSemaphore(0);
+    queue->done = SDL_CreateSemaphore(0);
+    if (!queue->workers || !queue->start || !queue->done) {
+        SDL_DestroyTileQueue(queue);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    /* Make sure the CPU features are detected before the threads look */
+    SDL_HasSSE2();
+
+    queue->workers[0].queue = queue;
+    queue->num_workers = 1;
+    for (i = 1; i < num_threads; ++i) {
+        SDL_TileWorker *worker = &queue->workers[i];
+
+        worker->queue = queue;
+        worker->thread = SDL_CreateThread(SDL_TileThread, "SDLRenderTiles", worker);
+        if (!worker->thread) {
+            break;
+        }
+        ++queue->num_workers;
+    }
+    return queue;
+}
+
+void
+SDL_DestroyTileQueue(SDL_TileQueue * queue)
+{
+    int i;
+
+    if (queue->workers) {
+        queue->quit = SDL_TRUE;
+        for (i = 1; i < queue->num_workers; ++i) {
+            SDL_SemPost(queue->start);
+        }
+        for (i = 0; i < queue->num_workers; ++i) {
+            SDL_TileWorker *worker = &queue->workers[i];
+
+            if (worker->thread) {
+                SDL_WaitThread(worker->thread, NULL);
+            }
+            SDL_FreeSpans(&worker->spans);
+            SDL_free(worker->rects);
+        }
+        SDL_free(queue->workers);
+    }
+    if (queue->start) {
+        SDL_DestroySemaphore(queue->start);
+    }
+    if (queue->done) {
+        SDL_DestroySemaphore(queue->done);
+    }
+    for (i = 0; i < queue->max_bins; ++i) {
+        SDL_free(queue->bins[i].commands);
+    }
+    SDL_free(queue->bins);
+    SDL_free(queue->commands);
+    SDL_free(queue->points);
+    SDL_free(queue->sources);
+    SDL_free(queue);
+}
+
+#endif /* !SDL_RENDER_DISABLED */
+
+/* vi: set ts=4 sw=4 expandtab: */
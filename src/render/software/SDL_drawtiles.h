@@ -0,0 +1,42 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+/* With more than one thread, the software renderer records its draws and
+   bins them into screen tiles.  The tiles are drawn by a pool of threads,
+   each with its own clip rectangle, using the same drawing functions as
+   drawing directly, so the pixels come out the same.
+
+   Only draws that give the same pixels when cut up by a clip rectangle are
+   recorded: clears, filled rectangles, points and unscaled blits.  Anything
+   else has to flush the queue and draw directly.
+ */
+typedef struct SDL_TileQueue SDL_TileQueue;
+
+extern SDL_TileQueue *SDL_CreateTileQueue(int num_threads);
+extern int SDL_TileClear(SDL_TileQueue * queue, SDL_Surface * dst, Uint32 color);
+extern int SDL_TileFillRects(SDL_TileQueue * queue, SDL_Surface * dst, const SDL_Rect * rects, int count, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+extern int SDL_TileDrawPoints(SDL_TileQueue * queue, SDL_Surface * dst, const SDL_Point * points, int count, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+extern int SDL_TileBlit(SDL_TileQueue * queue, SDL_Surface * src, const SDL_Rect * srcrect, SDL_Surface * dst, const SDL_Rect * dstrect, Uint8 r, Uint8 g, Uint8 b, Uint8 a, SDL_BlendMode blendMode);
+extern int SDL_FlushTiles(SDL_TileQueue * queue);
+extern void SDL_DestroyTileQueue(SDL_TileQueue * queue);
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -25,14 +25,16 @@
 #include "../SDL_sysrender.h"
 #include "SDL_render_sw_c.h"
 #include "SDL_hints.h"
+#include "SDL_cpuinfo.h"
 
 #include "SDL_draw.h"
-#include "SDL_blendfillrect.h"
 #include "SDL_blendline.h"
 #include "SDL_blendpoint.h"
+#include "SDL_blitaffine.h"
 #include "SDL_drawline.h"
 #include "SDL_drawpoint.h"
-#include "SDL_rotate.h"
+#include "SDL_drawspans.h"
+#include "SDL_drawtiles.h"
 
 /* SDL surface based renderer implementation */
 
@@ -47,6 +49,8 @@ static int SW_SetTextureAlphaMod(SDL_Renderer * renderer,
                                  SDL_Texture * texture);
 static int SW_SetTextureBlendMode(SDL_Renderer * renderer,
                                   SDL_Texture * texture);
+static int SW_SetTextureDistanceField(SDL_Renderer * renderer,
+                                      SDL_Texture * texture);
 static int SW_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                             const SDL_Rect * rect, const void *pixels,
                             int pitch);
@@ -68,8 +72,15 @@ static int SW_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
 static int SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
                           const SDL_Rect * srcrect, const SDL_FRect * dstrect,
                           const double angle, const SDL_FPoint * center, const SDL_RendererFlip flip);
+static int SW_RenderCopyMany(SDL_Renderer * renderer, SDL_Texture * texture,
+                             const SDL_RenderCopyCommand * copies, int count);
 static int SW_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                                Uint32 format, void * pixels, int pitch);
+static int SW_StartReadback(SDL_Renderer * renderer,
+                            SDL_RenderReadback * readback);
+static int SW_FinishReadback(SDL_Renderer * renderer,
+                             SDL_RenderReadback * readback, SDL_bool wait);
+static int SW_RenderFlush(SDL_Renderer * renderer);
 static void SW_RenderPresent(SDL_Renderer * renderer);
 static void SW_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture);
 static void SW_DestroyRenderer(SDL_Renderer * renderer);
@@ -99,8 +110,50 @@ typedef struct
 {
     SDL_Surface *surface;
     SDL_Surface *window;
+    SDL_SpanBuffer spans;
+    SDL_TileQueue *tiles;
 } SW_RenderData;
 
+/* Get the tile queue if drawing to this surface can be recorded */
+static SDL_TileQueue *
+SW_GetTiles(SDL_Renderer * renderer, SDL_Surface * surface)
+{
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+
+    if (!data->tiles) {
+        return NULL;
+    }
+    if (surface->format->BytesPerPixel < 2 || SDL_MUSTLOCK(surface)) {
+        SDL_FlushTiles(data->tiles);
+        return NULL;
+    }
+    return data->tiles;
+}
+
+static int
+SW_FlushTiles(SDL_Renderer * renderer)
+{
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+
+    if (!data->tiles) {
+        return 0;
+    }
+    return SDL_FlushTiles(data->tiles);
+}
+
+static int
+GetThreadCount(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_RENDER_SOFTWARE_THREADS);
+
+    if (!hint) {
+        return 1;
+    }
+    if (SDL_strcasecmp(hint, "auto") == 0) {
+        return SDL_GetCPUCount();
+    }
+    return SDL_atoi(hint);
+}
 
 static SDL_Surface *
 SW_ActivateRenderer(SDL_Renderer * renderer)
@@ -127,6 +180,7 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
 {
     SDL_Renderer *renderer;
     SW_RenderData *data;
+    int num_threads;
 
     if (!surface) {
         SDL_SetError("Can't create renderer for NULL surface");
@@ -146,6 +200,7 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
         return NULL;
     }
     data->surface = surface;
+    data->window = surface;
 
     renderer->WindowEvent = SW_WindowEvent;
     renderer->GetOutputSize = SW_GetOutputSize;
@@ -153,6 +208,7 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     renderer->SetTextureColorMod = SW_SetTextureColorMod;
     renderer->SetTextureAlphaMod = SW_SetTextureAlphaMod;
     renderer->SetTextureBlendMode = SW_SetTextureBlendMode;
+    renderer->SetTextureDistanceField = SW_SetTextureDistanceField;
     renderer->UpdateTexture = SW_UpdateTexture;
     renderer->LockTexture = SW_LockTexture;
     renderer->UnlockTexture = SW_UnlockTexture;
@@ -165,13 +221,26 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     renderer->RenderFillRects = SW_RenderFillRects;
     renderer->RenderCopy = SW_RenderCopy;
     renderer->RenderCopyEx = SW_RenderCopyEx;
+    renderer->RenderCopyMany = SW_RenderCopyMany;
     renderer->RenderReadPixels = SW_RenderReadPixels;
+    renderer->StartReadback = SW_StartReadback;
+    renderer->FinishReadback = SW_FinishReadback;
+    renderer->RenderFlush = SW_RenderFlush;
     renderer->RenderPresent = SW_RenderPresent;
     renderer->DestroyTexture = SW_DestroyTexture;
     renderer->DestroyRenderer = SW_DestroyRenderer;
     renderer->info = SW_RenderDriver.info;
     renderer->driverdata = data;
 
+    num_threads = GetThreadCount();
+    if (num_threads > 1) {
+        data->tiles = SDL_CreateTileQueue(num_threads);
+        if (!data->tiles) {
+            SW_DestroyRenderer(renderer);
+            return NULL;
+        }
+    }
+
     SW_ActivateRenderer(renderer);
 
     return renderer;
@@ -195,6 +264,7 @@ SW_WindowEvent(SDL_Renderer * renderer, const SDL_WindowEvent *event)
     SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
 
     if (event->event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+        SW_FlushTiles(renderer);
         data->surface = NULL;
         data->window = NULL;
     }
@@ -270,6 +340,21 @@ SW_SetTextureBlendMode(SDL_Renderer * renderer, SDL_Texture * texture)
     return SDL_SetSurfaceBlendMode(surface, texture->blendMode);
 }
 
+static int
+SW_SetTextureDistanceField(SDL_Renderer * renderer, SDL_Texture * texture)
+{
+    SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
+
+    /* Distance fields are sampled by the affine blitter, which needs 2 or 4
+       bytes per pixel, and it reads the settings from the texture.
+     */
+    if (texture->distanceSpread && surface->format->BytesPerPixel != 2 &&
+        surface->format->BytesPerPixel != 4) {
+        return SDL_SetError("Unsupported texture format for distance fields");
+    }
+    return 0;
+}
+
 static int
 SW_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                  const SDL_Rect * rect, const void *pixels, int pitch)
@@ -279,6 +364,8 @@ SW_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
     int row;
     size_t length;
 
+    SW_FlushTiles(renderer);
+
     if(SDL_MUSTLOCK(surface))
         SDL_LockSurface(surface);
     src = (Uint8 *) pixels;
@@ -293,6 +380,8 @@ SW_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
     }
     if(SDL_MUSTLOCK(surface))
         SDL_UnlockSurface(surface);
+
+    renderer->stats.bytes_uploaded += (Uint64)length * rect->h;
     return 0;
 }
 
@@ -302,6 +391,8 @@ SW_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
 {
     SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
 
+    SW_FlushTiles(renderer);
+
     *pixels =
         (void *) ((Uint8 *) surface->pixels + rect->y * surface->pitch +
                   rect->x * surface->format->BytesPerPixel);
@@ -363,6 +454,7 @@ static int
 SW_RenderClear(SDL_Renderer * renderer)
 {
     SDL_Surface *surface = SW_ActivateRenderer(renderer);
+    SDL_TileQueue *tiles;
     Uint32 color;
     SDL_Rect clip_rect;
 
@@ -370,9 +462,16 @@ SW_RenderClear(SDL_Renderer * renderer)
         return -1;
     }
 
+    ++renderer->stats.draw_calls;
+
     color = SDL_MapRGBA(surface->format,
                         renderer->r, renderer->g, renderer->b, renderer->a);
 
+    tiles = SW_GetTiles(renderer, surface);
+    if (tiles) {
+        return SDL_TileClear(tiles, surface, color);
+    }
+
     /* By definition the clear ignores the clip rect */
     clip_rect = surface->clip_rect;
     SDL_SetClipRect(surface, NULL);
@@ -386,12 +485,16 @@ SW_RenderDrawPoints(SDL_Renderer * renderer, const SDL_FPoint * points,
                     int count)
 {
     SDL_Surface *surface = SW_ActivateRenderer(renderer);
+    SDL_TileQueue *tiles;
     SDL_Point *final_points;
+    SDL_Rect bounds;
+    SDL_bool locked;
     int i, status;
 
     if (!surface) {
         return -1;
     }
+    ++renderer->stats.draw_calls;
 
     final_points = SDL_stack_alloc(SDL_Point, count);
     if (!final_points) {
@@ -412,6 +515,22 @@ SW_RenderDrawPoints(SDL_Renderer * renderer, const SDL_FPoint * points,
         }
     }
 
+    tiles = SW_GetTiles(renderer, surface);
+    if (tiles) {
+        status = SDL_TileDrawPoints(tiles, surface, final_points, count,
+                                    renderer->blendMode,
+                                    renderer->r, renderer->g, renderer->b,
+                                    renderer->a);
+        SDL_stack_free(final_points);
+        return status;
+    }
+
+    /* Lock the touched area so a window surface knows what changed */
+    locked = SDL_EnclosePoints(final_points, count, NULL, &bounds);
+    if (locked) {
+        SDL_LockSurfaceRect(surface, &bounds);
+    }
+
     /* Draw the points! */
     if (renderer->blendMode == SDL_BLENDMODE_NONE) {
         Uint32 color = SDL_MapRGBA(surface->format,
@@ -425,6 +544,9 @@ SW_RenderDrawPoints(SDL_Renderer * renderer, const SDL_FPoint * points,
                                 renderer->r, renderer->g, renderer->b,
                                 renderer->a);
     }
+    if (locked) {
+        SDL_UnlockSurface(surface);
+    }
     SDL_stack_free(final_points);
 
     return status;
@@ -436,11 +558,14 @@ SW_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
 {
     SDL_Surface *surface = SW_ActivateRenderer(renderer);
     SDL_Point *final_points;
+    SDL_Rect bounds;
+    SDL_bool locked;
     int i, status;
 
     if (!surface) {
         return -1;
     }
+    ++renderer->stats.draw_calls;
 
     final_points = SDL_stack_alloc(SDL_Point, count);
     if (!final_points) {
@@ -461,6 +586,15 @@ SW_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
         }
     }
 
+    /* Lines cross tiles at arbitrary slopes, so they are drawn here */
+    SW_FlushTiles(renderer);
+
+    /* Lock the touched area so a window surface knows what changed */
+    locked = SDL_EnclosePoints(final_points, count, NULL, &bounds);
+    if (locked) {
+        SDL_LockSurfaceRect(surface, &bounds);
+    }
+
     /* Draw the lines! */
     if (renderer->blendMode == SDL_BLENDMODE_NONE) {
         Uint32 color = SDL_MapRGBA(surface->format,
@@ -474,59 +608,115 @@ SW_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
                                 renderer->r, renderer->g, renderer->b,
                                 renderer->a);
     }
+    if (locked) {
+        SDL_UnlockSurface(surface);
+    }
     SDL_stack_free(final_points);
 
     return status;
 }
 
+/* Blend the spans gathered so far, one scanline at a time */
+static int
+SW_BlendSpans(SDL_Renderer * renderer, SDL_Surface * surface)
+{
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+    SDL_SpanBuffer *spans = &data->spans;
+    SDL_Rect bounds;
+    int i, minx, miny, maxx, maxy, status;
+
+    if (spans->count == 0) {
+        return 0;
+    }
+
+    /* Lock the touched area so a window surface knows what changed */
+    minx = spans->spans[0].x;
+    maxx = spans->spans[0].x + spans->spans[0].w;
+    miny = maxy = spans->spans[0].y;
+    for (i = 1; i < spans->count; ++i) {
+        const SDL_Rect *span = &spans->spans[i];
+        minx = SDL_min(minx, span->x);
+        maxx = SDL_max(maxx, span->x + span->w);
+        miny = SDL_min(miny, span->y);
+        maxy = SDL_max(maxy, span->y);
+    }
+    bounds.x = minx;
+    bounds.y = miny;
+    bounds.w = maxx - minx;
+    bounds.h = maxy - miny + 1;
+
+    SDL_LockSurfaceRect(surface, &bounds);
+    status = SDL_BlendSpans(surface, spans, renderer->blendMode,
+                            renderer->r, renderer->g, renderer->b,
+                            renderer->a);
+    SDL_UnlockSurface(surface);
+
+    return status;
+}
+
 static int
 SW_RenderFillRects(SDL_Renderer * renderer, const SDL_FRect * rects, int count)
 {
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
     SDL_Surface *surface = SW_ActivateRenderer(renderer);
-    SDL_Rect *final_rects;
+    SDL_TileQueue *tiles;
+    const int x = renderer->viewport.x;
+    const int y = renderer->viewport.y;
+    SDL_Rect rect;
     int i, status;
 
     if (!surface) {
         return -1;
     }
+    ++renderer->stats.draw_calls;
 
-    final_rects = SDL_stack_alloc(SDL_Rect, count);
-    if (!final_rects) {
-        return SDL_OutOfMemory();
-    }
-    if (renderer->viewport.x || renderer->viewport.y) {
-        int x = renderer->viewport.x;
-        int y = renderer->viewport.y;
+    tiles = SW_GetTiles(renderer, surface);
+    if (renderer->blendMode == SDL_BLENDMODE_NONE || tiles) {
+        /* SDL_FillRects() already writes each covered band once */
+        SDL_Rect *final_rects = SDL_ReserveSpans(&data->spans, count);
 
+        if (!final_rects) {
+            return -1;
+        }
         for (i = 0; i < count; ++i) {
             final_rects[i].x = (int)(x + rects[i].x);
             final_rects[i].y = (int)(y + rects[i].y);
             final_rects[i].w = SDL_max((int)rects[i].w, 1);
             final_rects[i].h = SDL_max((int)rects[i].h, 1);
         }
-    } else {
-        for (i = 0; i < count; ++i) {
-            final_rects[i].x = (int)rects[i].x;
-            final_rects[i].y = (int)rects[i].y;
-            final_rects[i].w = SDL_max((int)rects[i].w, 1);
-            final_rects[i].h = SDL_max((int)rects[i].h, 1);
+        if (tiles) {
+            status = SDL_TileFillRects(tiles, surface, final_rects, count,
+                                       renderer->blendMode,
+                                       renderer->r, renderer->g, renderer->b,
+                                       renderer->a);
+        } else {
+            Uint32 color = SDL_MapRGBA(surface->format,
+                                       renderer->r, renderer->g, renderer->b,
+                                       renderer->a);
+
+            status = SDL_FillRects(surface, final_rects, count, color);
         }
+        data->spans.count = 0;
+        return status;
     }
 
-    if (renderer->blendMode == SDL_BLENDMODE_NONE) {
-        Uint32 color = SDL_MapRGBA(surface->format,
-                                   renderer->r, renderer->g, renderer->b,
-                                   renderer->a);
-        status = SDL_FillRects(surface, final_rects, count, color);
-    } else {
-        status = SDL_BlendFillRects(surface, final_rects, count,
-                                    renderer->blendMode,
-                                    renderer->r, renderer->g, renderer->b,
-                                    renderer->a);
-    }
-    SDL_stack_free(final_rects);
+    /* Blended rectangles are cut into spans and blended row by row */
+    for (i = 0; i < count; ++i) {
+        rect.x = (int)(x + rects[i].x);
+        rect.y = (int)(y + rects[i].y);
+        rect.w = SDL_max((int)rects[i].w, 1);
+        rect.h = SDL_max((int)rects[i].h, 1);
 
-    return status;
+        if (SDL_AddSpanRect(&data->spans, &surface->clip_rect, &rect) < 0) {
+            data->spans.count = 0;
+            return -1;
+        }
+        if (data->spans.count >= SDL_SPAN_BATCH &&
+            SW_BlendSpans(renderer, surface) < 0) {
+            return -1;
+        }
+    }
+    return SW_BlendSpans(renderer, surface);
 }
 
 static int
@@ -551,9 +741,31 @@ SW_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     final_rect.w = (int)dstrect->w;
     final_rect.h = (int)dstrect->h;
 
+    ++renderer->stats.draw_calls;
+
+    if (texture->distanceSpread) {
+        SDL_FPoint center;
+
+        center.x = center.y = 0.0f;
+        SW_FlushTiles(renderer);
+        return SDL_BlitDistanceField(src, srcrect, surface, &final_rect,
+                                     0.0, &center, SDL_FLIP_NONE,
+                                     texture->distanceSpread,
+                                     texture->distanceThreshold);
+    }
+
     if ( srcrect->w == final_rect.w && srcrect->h == final_rect.h ) {
+        SDL_TileQueue *tiles = SW_GetTiles(renderer, surface);
+
+        if (tiles) {
+            return SDL_TileBlit(tiles, src, srcrect, surface, &final_rect,
+                                texture->r, texture->g, texture->b,
+                                texture->a, texture->blendMode);
+        }
         return SDL_BlitSurface(src, srcrect, surface, &final_rect);
     } else {
+        /* Scaling steps through the source from the rectangle's edge */
+        SW_FlushTiles(renderer);
         return SDL_BlitScaled(src, srcrect, surface, &final_rect);
     }
 }
@@ -577,11 +789,7 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
 {
     SDL_Surface *surface = SW_ActivateRenderer(renderer);
     SDL_Surface *src = (SDL_Surface *) texture->driverdata;
-    SDL_Rect final_rect, tmp_rect;
-    SDL_Surface *surface_rotated, *surface_scaled;
-    Uint32 colorkey;
-    int retval, dstwidth, dstheight, abscenterx, abscentery;
-    double cangle, sangle, px, py, p1x, p1y, p2x, p2y, p3x, p3y, p4x, p4y;
+    SDL_Rect final_rect;
 
     if (!surface) {
         return -1;
@@ -597,78 +805,121 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     final_rect.w = (int)dstrect->w;
     final_rect.h = (int)dstrect->h;
 
-    surface_scaled = SDL_CreateRGBSurface(SDL_SWSURFACE, final_rect.w, final_rect.h, src->format->BitsPerPixel,
-                                          src->format->Rmask, src->format->Gmask,
-                                          src->format->Bmask, src->format->Amask );
-    if (surface_scaled) {
-        SDL_GetColorKey(src, &colorkey);
-        SDL_SetColorKey(surface_scaled, SDL_TRUE, colorkey);
-        tmp_rect = final_rect;
-        tmp_rect.x = 0;
-        tmp_rect.y = 0;
-
-        retval = SDL_BlitScaled(src, srcrect, surface_scaled, &tmp_rect);
-        if (!retval) {
-            _rotozoomSurfaceSizeTrig(tmp_rect.w, tmp_rect.h, -angle, &dstwidth, &dstheight, &cangle, &sangle);
-            surface_rotated = _rotateSurface(surface_scaled, -angle, dstwidth/2, dstheight/2, GetScaleQuality(), flip & SDL_FLIP_HORIZONTAL, flip & SDL_FLIP_VERTICAL, dstwidth, dstheight, cangle, sangle);
-            if(surface_rotated) {
-                /* Find out where the new origin is by rotating the four final_rect points around the center and then taking the extremes */
-                abscenterx = final_rect.x + (int)center->x;
-                abscentery = final_rect.y + (int)center->y;
-                /* Compensate the angle inversion to match the behaviour of the other backends */
-                sangle = -sangle;
-
-                /* Top Left */
-                px = final_rect.x - abscenterx;
-                py = final_rect.y - abscentery;
-                p1x = px * cangle - py * sangle + abscenterx;
-                p1y = px * sangle + py * cangle + abscentery;
-
-                /* Top Right */
-                px = final_rect.x + final_rect.w - abscenterx;
-                py = final_rect.y - abscentery;
-                p2x = px * cangle - py * sangle + abscenterx;
-                p2y = px * sangle + py * cangle + abscentery;
-
-                /* Bottom Left */
-                px = final_rect.x - abscenterx;
-                py = final_rect.y + final_rect.h - abscentery;
-                p3x = px * cangle - py * sangle + abscenterx;
-                p3y = px * sangle + py * cangle + abscentery;
-
-                /* Bottom Right */
-                px = final_rect.x + final_rect.w - abscenterx;
-                py = final_rect.y + final_rect.h - abscentery;
-                p4x = px * cangle - py * sangle + abscenterx;
-                p4y = px * sangle + py * cangle + abscentery;
-
-                tmp_rect.x = (int)MIN(MIN(p1x, p2x), MIN(p3x, p4x));
-                tmp_rect.y = (int)MIN(MIN(p1y, p2y), MIN(p3y, p4y));
-                tmp_rect.w = dstwidth;
-                tmp_rect.h = dstheight;
-
-                retval = SDL_BlitSurface(surface_rotated, NULL, surface, &tmp_rect);
-                SDL_FreeSurface(surface_scaled);
-                SDL_FreeSurface(surface_rotated);
-                return retval;
+    ++renderer->stats.draw_calls;
+
+    SW_FlushTiles(renderer);
+
+    if (texture->distanceSpread) {
+        return SDL_BlitDistanceField(src, srcrect, surface, &final_rect,
+                                     angle, center, flip,
+                                     texture->distanceSpread,
+                                     texture->distanceThreshold);
+    }
+    return SDL_BlitAffine(src, srcrect, surface, &final_rect, angle, center,
+                          flip, GetScaleQuality() ? SDL_TRUE : SDL_FALSE);
+}
+
+static int
+SW_RenderCopyMany(SDL_Renderer * renderer, SDL_Texture * texture,
+                  const SDL_RenderCopyCommand * copies, int count)
+{
+    SDL_Surface *surface = SW_ActivateRenderer(renderer);
+    SDL_Surface *src = (SDL_Surface *) texture->driverdata;
+    SDL_TileQueue *tiles;
+    SDL_Rect final_rect;
+    Uint8 r, g, b, a;
+    int i, status = 0;
+
+    if (!surface) {
+        return -1;
+    }
+    tiles = SW_GetTiles(renderer, surface);
+
+    SDL_GetSurfaceColorMod(src, &r, &g, &b);
+    SDL_GetSurfaceAlphaMod(src, &a);
+
+    /* The blitter reads the modulation as it goes, so changing it between
+       copies is cheap unless it switches modulation on or off.  Each copy is
+       a separate blit, and is counted as a draw.
+     */
+    for (i = 0; i < count; ++i) {
+        const SDL_RenderCopyCommand *copy = &copies[i];
+
+        final_rect.x = (int)(renderer->viewport.x + copy->dstrect.x);
+        final_rect.y = (int)(renderer->viewport.y + copy->dstrect.y);
+        final_rect.w = (int)copy->dstrect.w;
+        final_rect.h = (int)copy->dstrect.h;
+
+        /* Rotated and flipped copies are counted by SW_RenderCopyEx(),
+           which also draws every distance field copy.
+         */
+        if (copy->angle == 0.0 && copy->flip == SDL_FLIP_NONE &&
+            !texture->distanceSpread) {
+            ++renderer->stats.draw_calls;
+        }
+
+        /* Recorded copies keep their own modulation */
+        if (tiles && copy->angle == 0.0 && copy->flip == SDL_FLIP_NONE &&
+            !texture->distanceSpread &&
+            copy->srcrect.w == final_rect.w && copy->srcrect.h == final_rect.h) {
+            if (SDL_TileBlit(tiles, src, &copy->srcrect, surface, &final_rect,
+                             copy->r, copy->g, copy->b, copy->a,
+                             texture->blendMode) < 0) {
+                status = -1;
+            }
+            continue;
+        }
+        SW_FlushTiles(renderer);
+
+        if (copy->r != r || copy->g != g || copy->b != b) {
+            r = copy->r;
+            g = copy->g;
+            b = copy->b;
+            SDL_SetSurfaceColorMod(src, r, g, b);
+        }
+        if (copy->a != a) {
+            a = copy->a;
+            SDL_SetSurfaceAlphaMod(src, a);
+        }
+
+        if (copy->angle != 0.0 || copy->flip != SDL_FLIP_NONE ||
+            texture->distanceSpread) {
+            if (SW_RenderCopyEx(renderer, texture, &copy->srcrect, &copy->dstrect,
+                                copy->angle, &copy->center, copy->flip) < 0) {
+                status = -1;
+            }
+            continue;
+        }
+
+        if (copy->srcrect.w == final_rect.w && copy->srcrect.h == final_rect.h) {
+            if (SDL_BlitSurface(src, &copy->srcrect, surface, &final_rect) < 0) {
+                status = -1;
+            }
+        } else {
+            if (SDL_BlitScaled(src, &copy->srcrect, surface, &final_rect) < 0) {
+                status = -1;
             }
         }
-        return retval;
     }
 
-    return -1;
+    /* Put back the texture's own modulation */
+    SDL_SetSurfaceColorMod(src, texture->r, texture->g, texture->b);
+    SDL_SetSurfaceAlphaMod(src, texture->a);
+    return status;
 }
 
+/* Find the pixels of the target under a rectangle, with drawing finished */
 static int
-SW_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
-                    Uint32 format, void * pixels, int pitch)
+SW_GetReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
+                 SDL_Surface ** surface, void ** pixels)
 {
-    SDL_Surface *surface = SW_ActivateRenderer(renderer);
-    Uint32 src_format;
-    void *src_pixels;
+    SDL_Surface *target = SW_ActivateRenderer(renderer);
     SDL_Rect final_rect;
 
-    if (!surface) {
+    if (!target) {
+        return -1;
+    }
+    if (SW_FlushTiles(renderer) < 0) {
         return -1;
     }
 
@@ -680,26 +931,83 @@ SW_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
         rect = &final_rect;
     }
 
-    if (rect->x < 0 || rect->x+rect->w > surface->w ||
-        rect->y < 0 || rect->y+rect->h > surface->h) {
+    if (rect->x < 0 || rect->x+rect->w > target->w ||
+        rect->y < 0 || rect->y+rect->h > target->h) {
         return SDL_SetError("Tried to read outside of surface bounds");
     }
 
-    src_format = surface->format->format;
-    src_pixels = (void*)((Uint8 *) surface->pixels +
-                    rect->y * surface->pitch +
-                    rect->x * surface->format->BytesPerPixel);
+    *surface = target;
+    *pixels = (void*)((Uint8 *) target->pixels +
+                    rect->y * target->pitch +
+                    rect->x * target->format->BytesPerPixel);
+    return 0;
+}
+
+static int
+SW_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
+                    Uint32 format, void * pixels, int pitch)
+{
+    SDL_Surface *surface;
+    void *src_pixels;
+
+    if (SW_GetReadPixels(renderer, rect, &surface, &src_pixels) < 0) {
+        return -1;
+    }
 
     return SDL_ConvertPixels(rect->w, rect->h,
-                             src_format, src_pixels, surface->pitch,
+                             surface->format->format, src_pixels, surface->pitch,
                              format, pixels, pitch);
 }
 
+static int
+SW_StartReadback(SDL_Renderer * renderer, SDL_RenderReadback * readback)
+{
+    SDL_Surface *surface;
+    Uint8 *src, *dst;
+    int length, row;
+
+    if (SW_GetReadPixels(renderer, &readback->rect, &surface, (void **) &src) < 0) {
+        return -1;
+    }
+
+    /* Copy the rows out now, the conversion is left for the worker */
+    length = readback->rect.w * surface->format->BytesPerPixel;
+    readback->src_format = surface->format->format;
+    readback->src_pitch = length;
+    readback->src_pixels = SDL_malloc(readback->rect.h * length);
+    if (!readback->src_pixels) {
+        return SDL_OutOfMemory();
+    }
+    dst = (Uint8 *) readback->src_pixels;
+    for (row = 0; row < readback->rect.h; ++row) {
+        SDL_memcpy(dst, src, length);
+        src += surface->pitch;
+        dst += length;
+    }
+    return 0;
+}
+
+static int
+SW_FinishReadback(SDL_Renderer * renderer, SDL_RenderReadback * readback,
+                  SDL_bool wait)
+{
+    /* The pixels were copied when the read started */
+    return 1;
+}
+
+static int
+SW_RenderFlush(SDL_Renderer * renderer)
+{
+    return SW_FlushTiles(renderer);
+}
+
 static void
 SW_RenderPresent(SDL_Renderer * renderer)
 {
     SDL_Window *window = renderer->window;
 
+    SW_FlushTiles(renderer);
+
     if (window) {
         SDL_UpdateWindowSurface(window);
     }
@@ -710,6 +1018,7 @@ SW_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
     SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
 
+    SW_FlushTiles(renderer);
     SDL_FreeSurface(surface);
 }
 
@@ -718,6 +1027,12 @@ SW_DestroyRenderer(SDL_Renderer * renderer)
 {
     SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
 
+    if (data) {
+        if (data->tiles) {
+            SDL_DestroyTileQueue(data->tiles);
+        }
+        SDL_FreeSpans(&data->spans);
+    }
     SDL_free(data);
     SDL_free(renderer);
 }
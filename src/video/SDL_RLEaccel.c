@@ -61,7 +61,7 @@
  * Encoding of surfaces with per-pixel alpha:
  *
  *   The sequence begins with a struct RLEDestFormat describing the target
- *   pixel format, to provide reliable un-encoding.
+ *   pixel format, so lines can be re-encoded without the target at hand.
  *
  *   Each scan line is encoded twice: First all completely opaque pixels,
  *   encoded in the target format as described above, and then all
@@ -83,6 +83,17 @@
  *
  *   The end of the sequence is marked by a zero <skip>,<run> pair at the
  *   beginning of an opaque line.
+ *
+ * Persistent encoding:
+ *
+ *   The encoded stream is kept in a struct SDL_RLECache hanging off the blit
+ *   map, beside the raw pixels which are never released. Blank lines are
+ *   kept in the stream, and the offset of every scan line is recorded, so
+ *   the blitters can start at any line directly and a line can be
+ *   re-encoded on its own. Locking only marks the touched lines as dirty;
+ *   unlocking re-encodes those lines, and remapping the surface (after a
+ *   colour, alpha or blend mode change) reuses the stream unchanged as long
+ *   as the colorkey and destination format it was made for still apply.
  */
 
 #include "SDL_video.h"
@@ -90,6 +101,18 @@
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
 
+struct SDL_RLECache
+{
+    Uint32 kind;                /* SDL_COPY_RLE_COLORKEY or SDL_COPY_RLE_ALPHAKEY */
+    Uint32 colorkey;            /* colorkey the stream was encoded with */
+    Uint8 *data;                /* the encoded stream */
+    size_t size;                /* size of the stream in bytes */
+    Uint32 *rows;               /* offsets of the h lines and the end marker */
+    int dirty_top;              /* first line changed since encoding */
+    int dirty_bottom;           /* one past the last line changed */
+};
+typedef struct SDL_RLECache SDL_RLECache;
+
 #ifndef MAX
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #endif
@@ -432,11 +455,163 @@ RLEClipBlit(int w, Uint8 * srcbuf, SDL_Surface * dst,
 }
 
 
+/*
+ * Draw n pixels of an opaque run, sampling the run at the 16.16 fixed point
+ * positions pos, pos + inc, ... This handles the colour modulated and the
+ * scaled cases, which the run copying macros above don't, per pixel with
+ * the same arithmetic as SDL_Blit_Slow().
+ */
+static void
+RLESpan(Uint8 * dst, const Uint8 * src, int n, Uint32 pos, Uint32 inc,
+        SDL_PixelFormat * fmt, const SDL_BlitInfo * info)
+{
+    const int bpp = fmt->BytesPerPixel;
+    const Uint32 flags = info->flags;
+    unsigned alpha = 255;
+
+    if ((flags & SDL_COPY_BLEND) && !SDL_ISPIXELFORMAT_INDEXED(fmt->format)) {
+        alpha = info->a;
+    }
+
+    if (!(flags & SDL_COPY_MODULATE_COLOR) && alpha == 255) {
+        switch (bpp) {
+        case 1:
+            for (; n > 0; --n, pos += inc) {
+                *dst++ = src[pos >> 16];
+            }
+            break;
+        case 2:
+            {
+                Uint16 *d = (Uint16 *) dst;
+                const Uint16 *s = (const Uint16 *) src;
+                for (; n > 0; --n, pos += inc) {
+                    *d++ = s[pos >> 16];
+                }
+            }
+            break;
+        case 3:
+            for (; n > 0; --n, pos += inc, dst += 3) {
+                const Uint8 *s = src + (pos >> 16) * 3;
+                dst[0] = s[0];
+                dst[1] = s[1];
+                dst[2] = s[2];
+            }
+            break;
+        case 4:
+            {
+                Uint32 *d = (Uint32 *) dst;
+                const Uint32 *s = (const Uint32 *) src;
+                for (; n > 0; --n, pos += inc) {
+                    *d++ = s[pos >> 16];
+                }
+            }
+            break;
+        }
+        return;
+    }
+
+    for (; n > 0; --n, pos += inc, dst += bpp) {
+        Uint8 *s = (Uint8 *) src + (pos >> 16) * bpp;
+        Uint32 pixel;
+        unsigned sR, sG, sB, sA, dR, dG, dB;
+
+        if (fmt->Amask) {
+            DISEMBLE_RGBA(s, bpp, fmt, pixel, sR, sG, sB, sA);
+        } else {
+            DISEMBLE_RGB(s, bpp, fmt, pixel, sR, sG, sB);
+            sA = 0xFF;
+        }
+        if (flags & SDL_COPY_MODULATE_COLOR) {
+            sR = (sR * info->r) / 255;
+            sG = (sG * info->g) / 255;
+            sB = (sB * info->b) / 255;
+        }
+        if (alpha < 255) {
+            /* only surfaces without an alpha channel get here */
+            DISEMBLE_RGB(dst, bpp, fmt, pixel, dR, dG, dB);
+            dR = (sR * alpha) / 255 + ((255 - alpha) * dR) / 255;
+            dG = (sG * alpha) / 255 + ((255 - alpha) * dG) / 255;
+            dB = (sB * alpha) / 255 + ((255 - alpha) * dB) / 255;
+            ASSEMBLE_RGB(dst, bpp, fmt, dR, dG, dB);
+        } else if (fmt->Amask) {
+            ASSEMBLE_RGBA(dst, bpp, fmt, sR, sG, sB, sA);
+        } else {
+            ASSEMBLE_RGB(dst, bpp, fmt, sR, sG, sB);
+        }
+    }
+}
+
+/*
+ * Blit a colorkeyed RLE surface with scaling and/or colour modulation.
+ * Destination pixels map back to the source the same way as in the
+ * SDL_COPY_NEAREST software blitters; runs are walked line by line and only
+ * destination pixels that land on opaque source pixels are touched.
+ */
+static void
+RLEScaleBlit(SDL_Surface * src, SDL_Rect * srcrect,
+             SDL_Surface * dst, SDL_Rect * dstrect)
+{
+    SDL_RLECache *cache = src->map->rle_cache;
+    SDL_PixelFormat *fmt = src->format;
+    const int bpp = fmt->BytesPerPixel;
+    const int left = srcrect->x;
+    const int right = left + srcrect->w;
+    const Uint32 dstw = (Uint32) dstrect->w;
+    const Uint32 incx = ((Uint32) srcrect->w << 16) / dstw;
+    const Uint32 incy = ((Uint32) srcrect->h << 16) / (Uint32) dstrect->h;
+    Uint32 posy = 0;
+    Uint8 *dstbuf;
+    int y;
+
+    dstbuf = (Uint8 *) dst->pixels + dstrect->y * dst->pitch + dstrect->x * bpp;
+    for (y = 0; y < dstrect->h; ++y) {
+        const Uint8 *srcbuf =
+            cache->data + cache->rows[srcrect->y + (posy >> 16)];
+        int ofs = 0;
+
+        while (ofs < right) {
+            int run;
+            if (bpp == 4) {
+                ofs += ((const Uint16 *) srcbuf)[0];
+                run = ((const Uint16 *) srcbuf)[1];
+                srcbuf += 4;
+            } else {
+                ofs += srcbuf[0];
+                run = srcbuf[1];
+                srcbuf += 2;
+            }
+            if (run) {
+                /* the part of the run inside srcrect, relative to it */
+                int start = MAX(ofs, left) - left;
+                int end = MIN(ofs + run, right) - left;
+                if (start < end) {
+                    /* first destination pixels sampling at or past each end */
+                    Uint32 i0 = (((Uint32) start << 16) + incx - 1) / incx;
+                    Uint32 i1 = (((Uint32) end << 16) + incx - 1) / incx;
+                    if (i1 > dstw) {
+                        i1 = dstw;
+                    }
+                    if (i0 < i1) {
+                        RLESpan(dstbuf + i0 * bpp, srcbuf, (int) (i1 - i0),
+                                i0 * incx - ((Uint32) (ofs - left) << 16),
+                                incx, fmt, &src->map->info);
+                    }
+                }
+                srcbuf += run * bpp;
+                ofs += run;
+            }
+        }
+        posy += incy;
+        dstbuf += dst->pitch;
+    }
+}
+
 /* blit a colorkeyed RLE surface */
 int
 SDL_RLEBlit(SDL_Surface * src, SDL_Rect * srcrect,
             SDL_Surface * dst, SDL_Rect * dstrect)
 {
+    SDL_RLECache *cache = src->map->rle_cache;
     Uint8 *dstbuf;
     Uint8 *srcbuf;
     int x, y;
@@ -445,61 +620,23 @@ SDL_RLEBlit(SDL_Surface * src, SDL_Rect * srcrect,
 
     /* Lock the destination if necessary */
     if (SDL_MUSTLOCK(dst)) {
-        if (SDL_LockSurface(dst) < 0) {
+        if (SDL_LockSurfaceRect(dst, dstrect) < 0) {
             return (-1);
         }
     }
 
+    if (srcrect->w != dstrect->w || srcrect->h != dstrect->h ||
+        (src->map->info.flags & SDL_COPY_MODULATE_COLOR)) {
+        RLEScaleBlit(src, srcrect, dst, dstrect);
+        goto done;
+    }
+
     /* Set up the source and destination pointers */
     x = dstrect->x;
     y = dstrect->y;
     dstbuf = (Uint8 *) dst->pixels
         + y * dst->pitch + x * src->format->BytesPerPixel;
-    srcbuf = (Uint8 *) src->map->data;
-
-    {
-        /* skip lines at the top if necessary */
-        int vskip = srcrect->y;
-        int ofs = 0;
-        if (vskip) {
-
-#define RLESKIP(bpp, Type)          \
-        for(;;) {           \
-            int run;            \
-            ofs += *(Type *)srcbuf; \
-            run = ((Type *)srcbuf)[1];  \
-            srcbuf += sizeof(Type) * 2; \
-            if(run) {           \
-            srcbuf += run * bpp;    \
-            ofs += run;     \
-            } else if(!ofs)     \
-            goto done;      \
-            if(ofs == w) {      \
-            ofs = 0;        \
-            if(!--vskip)        \
-                break;      \
-            }               \
-        }
-
-            switch (src->format->BytesPerPixel) {
-            case 1:
-                RLESKIP(1, Uint8);
-                break;
-            case 2:
-                RLESKIP(2, Uint8);
-                break;
-            case 3:
-                RLESKIP(3, Uint8);
-                break;
-            case 4:
-                RLESKIP(4, Uint16);
-                break;
-            }
-
-#undef RLESKIP
-
-        }
-    }
+    srcbuf = cache->data + cache->rows[srcrect->y];
 
     alpha = src->map->info.a;
     /* if left or right edge clipping needed, call clip blit */
@@ -715,6 +852,7 @@ int
 SDL_RLEAlphaBlit(SDL_Surface * src, SDL_Rect * srcrect,
                  SDL_Surface * dst, SDL_Rect * dstrect)
 {
+    SDL_RLECache *cache = src->map->rle_cache;
     int x, y;
     int w = src->w;
     Uint8 *srcbuf, *dstbuf;
@@ -722,7 +860,7 @@ SDL_RLEAlphaBlit(SDL_Surface * src, SDL_Rect * srcrect,
 
     /* Lock the destination if necessary */
     if (SDL_MUSTLOCK(dst)) {
-        if (SDL_LockSurface(dst) < 0) {
+        if (SDL_LockSurfaceRect(dst, dstrect) < 0) {
             return -1;
         }
     }
@@ -730,63 +868,7 @@ SDL_RLEAlphaBlit(SDL_Surface * src, SDL_Rect * srcrect,
     x = dstrect->x;
     y = dstrect->y;
     dstbuf = (Uint8 *) dst->pixels + y * dst->pitch + x * df->BytesPerPixel;
-    srcbuf = (Uint8 *) src->map->data + sizeof(RLEDestFormat);
-
-    {
-        /* skip lines at the top if necessary */
-        int vskip = srcrect->y;
-        if (vskip) {
-            int ofs;
-            if (df->BytesPerPixel == 2) {
-                /* the 16/32 interleaved format */
-                do {
-                    /* skip opaque line */
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += srcbuf[0];
-                        run = srcbuf[1];
-                        srcbuf += 2;
-                        if (run) {
-                            srcbuf += 2 * run;
-                            ofs += run;
-                        } else if (!ofs)
-                            goto done;
-                    } while (ofs < w);
-
-                    /* skip padding */
-                    srcbuf += (uintptr_t) srcbuf & 2;
-
-                    /* skip translucent line */
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += ((Uint16 *) srcbuf)[0];
-                        run = ((Uint16 *) srcbuf)[1];
-                        srcbuf += 4 * (run + 1);
-                        ofs += run;
-                    } while (ofs < w);
-                } while (--vskip);
-            } else {
-                /* the 32/32 interleaved format */
-                vskip <<= 1;    /* opaque and translucent have same format */
-                do {
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += ((Uint16 *) srcbuf)[0];
-                        run = ((Uint16 *) srcbuf)[1];
-                        srcbuf += 4;
-                        if (run) {
-                            srcbuf += 4 * run;
-                            ofs += run;
-                        } else if (!ofs)
-                            goto done;
-                    } while (ofs < w);
-                } while (--vskip);
-            }
-        }
-    }
+    srcbuf = cache->data + cache->rows[srcrect->y];
 
     /* if left or right edge clipping needed, call clip blit */
     if (srcrect->x || srcrect->w != src->w) {
@@ -869,16 +951,17 @@ SDL_RLEAlphaBlit(SDL_Surface * src, SDL_Rect * srcrect,
  * Auxiliary functions:
  * The encoding functions take 32bpp rgb + a, and
  * return the number of bytes copied to the destination.
- * The decoding functions copy to 32bpp rgb + a, and
- * return the number of bytes copied from the source.
- * These are only used in the encoder and un-RLE code and are therefore not
+ * These are only used in the encoder and are therefore not
  * highly optimised.
  */
 
+typedef int (*copy_func) (void *, Uint32 *, int,
+                          SDL_PixelFormat *, RLEDestFormat *);
+
 /* encode 32bpp rgb + a into 16bpp rgb, losing alpha */
 static int
 copy_opaque_16(void *dst, Uint32 * src, int n,
-               SDL_PixelFormat * sfmt, SDL_PixelFormat * dfmt)
+               SDL_PixelFormat * sfmt, RLEDestFormat * dfmt)
 {
     int i;
     Uint16 *d = dst;
@@ -892,30 +975,10 @@ copy_opaque_16(void *dst, Uint32 * src, int n,
     return n * 2;
 }
 
-/* decode opaque pixels from 16bpp to 32bpp rgb + a */
-static int
-uncopy_opaque_16(Uint32 * dst, void *src, int n,
-                 RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint16 *s = src;
-    unsigned alpha = dfmt->Amask ? 255 : 0;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b;
-        RGB_FROM_PIXEL(*s, sfmt, r, g, b);
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, alpha);
-        s++;
-        dst++;
-    }
-    return n * 2;
-}
-
-
-
 /* encode 32bpp rgb + a into 32bpp G0RAB format for blitting into 565 */
 static int
 copy_transl_565(void *dst, Uint32 * src, int n,
-                SDL_PixelFormat * sfmt, SDL_PixelFormat * dfmt)
+                SDL_PixelFormat * sfmt, RLEDestFormat * dfmt)
 {
     int i;
     Uint32 *d = dst;
@@ -934,7 +997,7 @@ copy_transl_565(void *dst, Uint32 * src, int n,
 /* encode 32bpp rgb + a into 32bpp G0RAB format for blitting into 555 */
 static int
 copy_transl_555(void *dst, Uint32 * src, int n,
-                SDL_PixelFormat * sfmt, SDL_PixelFormat * dfmt)
+                SDL_PixelFormat * sfmt, RLEDestFormat * dfmt)
 {
     int i;
     Uint32 *d = dst;
@@ -950,91 +1013,57 @@ copy_transl_555(void *dst, Uint32 * src, int n,
     return n * 4;
 }
 
-/* decode translucent pixels from 32bpp GORAB to 32bpp rgb + a */
-static int
-uncopy_transl_16(Uint32 * dst, void *src, int n,
-                 RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint32 *s = src;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b, a;
-        Uint32 pix = *s++;
-        a = (pix & 0x3e0) >> 2;
-        pix = (pix & ~0x3e0) | pix >> 16;
-        RGB_FROM_PIXEL(pix, sfmt, r, g, b);
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, a);
-        dst++;
-    }
-    return n * 4;
-}
-
-/* encode 32bpp rgba into 32bpp rgba, keeping alpha (dual purpose) */
+/* encode 32bpp rgba into 32bpp rgb with alpha in the top 8 bits
+   (dual purpose; the alpha takes the place of the target's own, if any) */
 static int
 copy_32(void *dst, Uint32 * src, int n,
-        SDL_PixelFormat * sfmt, SDL_PixelFormat * dfmt)
+        SDL_PixelFormat * sfmt, RLEDestFormat * dfmt)
 {
     int i;
     Uint32 *d = dst;
     for (i = 0; i < n; i++) {
         unsigned r, g, b, a;
         RGBA_FROM_8888(*src, sfmt, r, g, b, a);
-        PIXEL_FROM_RGBA(*d, dfmt, r, g, b, a);
+        PIXEL_FROM_RGB(*d, dfmt, r, g, b);
+        *d = (*d & 0x00ffffff) | ((Uint32) a << 24);
         d++;
         src++;
     }
     return n * 4;
 }
 
-/* decode 32bpp rgba into 32bpp rgba, keeping alpha (dual purpose) */
-static int
-uncopy_32(Uint32 * dst, void *src, int n,
-          RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint32 *s = src;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b, a;
-        Uint32 pixel = *s++;
-        RGB_FROM_PIXEL(pixel, sfmt, r, g, b);
-        a = pixel >> 24;
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, a);
-        dst++;
-    }
-    return n * 4;
-}
-
 #define ISOPAQUE(pixel, fmt) ((((pixel) & fmt->Amask) >> fmt->Ashift) == 255)
 
 #define ISTRANSL(pixel, fmt)    \
     ((unsigned)((((pixel) & fmt->Amask) >> fmt->Ashift) - 1U) < 254U)
 
-/* convert surface to be quickly alpha-blittable onto dest, if possible */
+/* save the destination format at the start of a pixel-alpha encoding */
+static void
+RLESaveDestFormat(RLEDestFormat * r, const SDL_PixelFormat * df)
+{
+    SDL_zerop(r);
+    r->BytesPerPixel = df->BytesPerPixel;
+    r->Rmask = df->Rmask;
+    r->Gmask = df->Gmask;
+    r->Bmask = df->Bmask;
+    r->Amask = df->Amask;
+    r->Rloss = df->Rloss;
+    r->Gloss = df->Gloss;
+    r->Bloss = df->Bloss;
+    r->Aloss = df->Aloss;
+    r->Rshift = df->Rshift;
+    r->Gshift = df->Gshift;
+    r->Bshift = df->Bshift;
+    r->Ashift = df->Ashift;
+}
+
+/* find out whether the destination is one we support for pixel alpha */
 static int
-RLEAlphaSurface(SDL_Surface * surface)
+RLEAlphaCopyFuncs(const RLEDestFormat * df,
+                  copy_func * copy_opaque, copy_func * copy_transl)
 {
-    SDL_Surface *dest;
-    SDL_PixelFormat *df;
-    int maxsize = 0;
-    int max_opaque_run;
-    int max_transl_run = 65535;
-    unsigned masksum;
-    Uint8 *rlebuf, *dst;
-    int (*copy_opaque) (void *, Uint32 *, int,
-                        SDL_PixelFormat *, SDL_PixelFormat *);
-    int (*copy_transl) (void *, Uint32 *, int,
-                        SDL_PixelFormat *, SDL_PixelFormat *);
-
-    dest = surface->map->dst;
-    if (!dest)
-        return -1;
-    df = dest->format;
-    if (surface->format->BitsPerPixel != 32)
-        return -1;              /* only 32bpp source supported */
+    unsigned masksum = df->Rmask | df->Gmask | df->Bmask;
 
-    /* find out whether the destination is one we support,
-       and determine the max size of the encoded result */
-    masksum = df->Rmask | df->Gmask | df->Bmask;
     switch (df->BytesPerPixel) {
     case 2:
         /* 16bpp: only support 565 and 555 formats */
@@ -1042,75 +1071,49 @@ RLEAlphaSurface(SDL_Surface * surface)
         case 0xffff:
             if (df->Gmask == 0x07e0
                 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0) {
-                copy_opaque = copy_opaque_16;
-                copy_transl = copy_transl_565;
-            } else
-                return -1;
+                *copy_opaque = copy_opaque_16;
+                *copy_transl = copy_transl_565;
+                return 0;
+            }
             break;
         case 0x7fff:
             if (df->Gmask == 0x03e0
                 || df->Rmask == 0x03e0 || df->Bmask == 0x03e0) {
-                copy_opaque = copy_opaque_16;
-                copy_transl = copy_transl_555;
-            } else
-                return -1;
+                *copy_opaque = copy_opaque_16;
+                *copy_transl = copy_transl_555;
+                return 0;
+            }
             break;
-        default:
-            return -1;
         }
-        max_opaque_run = 255;   /* runs stored as bytes */
-
-        /* worst case is alternating opaque and translucent pixels,
-           with room for alignment padding between lines */
-        maxsize = surface->h * (2 + (4 + 2) * (surface->w + 1)) + 2;
         break;
     case 4:
-        if (masksum != 0x00ffffff)
-            return -1;          /* requires unused high byte */
-        copy_opaque = copy_32;
-        copy_transl = copy_32;
-        max_opaque_run = 255;   /* runs stored as short ints */
-
-        /* worst case is alternating opaque and translucent pixels */
-        maxsize = surface->h * 2 * 4 * (surface->w + 1) + 4;
+        /* requires unused high byte */
+        if (masksum == 0x00ffffff) {
+            *copy_opaque = copy_32;
+            *copy_transl = copy_32;
+            return 0;
+        }
         break;
-    default:
-        return -1;              /* anything else unsupported right now */
     }
+    return -1;                  /* anything else unsupported right now */
+}
 
-    maxsize += sizeof(RLEDestFormat);
-    rlebuf = (Uint8 *) SDL_malloc(maxsize);
-    if (!rlebuf) {
-        return SDL_OutOfMemory();
-    }
-    {
-        /* save the destination format so we can undo the encoding later */
-        RLEDestFormat *r = (RLEDestFormat *) rlebuf;
-        r->BytesPerPixel = df->BytesPerPixel;
-        r->Rmask = df->Rmask;
-        r->Gmask = df->Gmask;
-        r->Bmask = df->Bmask;
-        r->Amask = df->Amask;
-        r->Rloss = df->Rloss;
-        r->Gloss = df->Gloss;
-        r->Bloss = df->Bloss;
-        r->Aloss = df->Aloss;
-        r->Rshift = df->Rshift;
-        r->Gshift = df->Gshift;
-        r->Bshift = df->Bshift;
-        r->Ashift = df->Ashift;
-    }
-    dst = rlebuf + sizeof(RLEDestFormat);
+/* encode one scan line of a surface with pixel alpha */
+static int
+RLEAlphaLine(SDL_Surface * surface, int y, Uint8 * dst, RLEDestFormat * df)
+{
+    Uint8 *start = dst;
+    SDL_PixelFormat *sf = surface->format;
+    Uint32 *src = (Uint32 *) ((Uint8 *) surface->pixels + y * surface->pitch);
+    int max_opaque_run = 255;   /* runs stored as bytes or short ints */
+    int max_transl_run = 65535;
+    int w = surface->w;
+    int x, runstart, skipstart;
+    copy_func copy_opaque, copy_transl;
 
-    /* Do the actual encoding */
-    {
-        int x, y;
-        int h = surface->h, w = surface->w;
-        SDL_PixelFormat *sf = surface->format;
-        Uint32 *src = (Uint32 *) surface->pixels;
-        Uint8 *lastline = dst;  /* end of last non-blank line */
+    RLEAlphaCopyFuncs(df, &copy_opaque, &copy_transl);
 
-        /* opaque counts are 8 or 16 bits, depending on target depth */
+    /* opaque counts are 8 or 16 bits, depending on target depth */
 #define ADD_OPAQUE_COUNTS(n, m)         \
     if(df->BytesPerPixel == 4) {        \
         ((Uint16 *)dst)[0] = n;     \
@@ -1122,105 +1125,77 @@ RLEAlphaSurface(SDL_Surface * surface)
         dst += 2;               \
     }
 
-        /* translucent counts are always 16 bit */
+    /* translucent counts are always 16 bit */
 #define ADD_TRANSL_COUNTS(n, m)     \
     (((Uint16 *)dst)[0] = n, ((Uint16 *)dst)[1] = m, dst += 4)
 
-        for (y = 0; y < h; y++) {
-            int runstart, skipstart;
-            int blankline = 0;
-            /* First encode all opaque pixels of a scan line */
-            x = 0;
-            do {
-                int run, skip, len;
-                skipstart = x;
-                while (x < w && !ISOPAQUE(src[x], sf))
-                    x++;
-                runstart = x;
-                while (x < w && ISOPAQUE(src[x], sf))
-                    x++;
-                skip = runstart - skipstart;
-                if (skip == w)
-                    blankline = 1;
-                run = x - runstart;
-                while (skip > max_opaque_run) {
-                    ADD_OPAQUE_COUNTS(max_opaque_run, 0);
-                    skip -= max_opaque_run;
-                }
-                len = MIN(run, max_opaque_run);
-                ADD_OPAQUE_COUNTS(skip, len);
-                dst += copy_opaque(dst, src + runstart, len, sf, df);
-                runstart += len;
-                run -= len;
-                while (run) {
-                    len = MIN(run, max_opaque_run);
-                    ADD_OPAQUE_COUNTS(0, len);
-                    dst += copy_opaque(dst, src + runstart, len, sf, df);
-                    runstart += len;
-                    run -= len;
-                }
-            } while (x < w);
-
-            /* Make sure the next output address is 32-bit aligned */
-            dst += (uintptr_t) dst & 2;
-
-            /* Next, encode all translucent pixels of the same scan line */
-            x = 0;
-            do {
-                int run, skip, len;
-                skipstart = x;
-                while (x < w && !ISTRANSL(src[x], sf))
-                    x++;
-                runstart = x;
-                while (x < w && ISTRANSL(src[x], sf))
-                    x++;
-                skip = runstart - skipstart;
-                blankline &= (skip == w);
-                run = x - runstart;
-                while (skip > max_transl_run) {
-                    ADD_TRANSL_COUNTS(max_transl_run, 0);
-                    skip -= max_transl_run;
-                }
-                len = MIN(run, max_transl_run);
-                ADD_TRANSL_COUNTS(skip, len);
-                dst += copy_transl(dst, src + runstart, len, sf, df);
-                runstart += len;
-                run -= len;
-                while (run) {
-                    len = MIN(run, max_transl_run);
-                    ADD_TRANSL_COUNTS(0, len);
-                    dst += copy_transl(dst, src + runstart, len, sf, df);
-                    runstart += len;
-                    run -= len;
-                }
-                if (!blankline)
-                    lastline = dst;
-            } while (x < w);
-
-            src += surface->pitch >> 2;
+    /* First encode all opaque pixels of a scan line */
+    x = 0;
+    do {
+        int run, skip, len;
+        skipstart = x;
+        while (x < w && !ISOPAQUE(src[x], sf))
+            x++;
+        runstart = x;
+        while (x < w && ISOPAQUE(src[x], sf))
+            x++;
+        skip = runstart - skipstart;
+        run = x - runstart;
+        while (skip > max_opaque_run) {
+            ADD_OPAQUE_COUNTS(max_opaque_run, 0);
+            skip -= max_opaque_run;
         }
-        dst = lastline;         /* back up past trailing blank lines */
-        ADD_OPAQUE_COUNTS(0, 0);
-    }
+        len = MIN(run, max_opaque_run);
+        ADD_OPAQUE_COUNTS(skip, len);
+        dst += copy_opaque(dst, src + runstart, len, sf, df);
+        runstart += len;
+        run -= len;
+        while (run) {
+            len = MIN(run, max_opaque_run);
+            ADD_OPAQUE_COUNTS(0, len);
+            dst += copy_opaque(dst, src + runstart, len, sf, df);
+            runstart += len;
+            run -= len;
+        }
+    } while (x < w);
+
+    /* Make sure the next output address is 32-bit aligned */
+    dst += (uintptr_t) dst & 2;
+
+    /* Next, encode all translucent pixels of the same scan line */
+    x = 0;
+    do {
+        int run, skip, len;
+        skipstart = x;
+        while (x < w && !ISTRANSL(src[x], sf))
+            x++;
+        runstart = x;
+        while (x < w && ISTRANSL(src[x], sf))
+            x++;
+        skip = runstart - skipstart;
+        run = x - runstart;
+        while (skip > max_transl_run) {
+            ADD_TRANSL_COUNTS(max_transl_run, 0);
+            skip -= max_transl_run;
+        }
+        len = MIN(run, max_transl_run);
+        ADD_TRANSL_COUNTS(skip, len);
+        dst += copy_transl(dst, src + runstart, len, sf, df);
+        runstart += len;
+        run -= len;
+        while (run) {
+            len = MIN(run, max_transl_run);
+            ADD_TRANSL_COUNTS(0, len);
+            dst += copy_transl(dst, src + runstart, len, sf, df);
+            runstart += len;
+            run -= len;
+        }
+    } while (x < w);
 
 #undef ADD_OPAQUE_COUNTS
 #undef ADD_TRANSL_COUNTS
 
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
-        surface->pixels = NULL;
-    }
-
-    /* realloc the buffer to release unused memory */
-    {
-        Uint8 *p = SDL_realloc(rlebuf, dst - rlebuf);
-        if (!p)
-            p = rlebuf;
-        surface->map->data = p;
-    }
-
-    return 0;
+    return (int) (dst - start);
 }
 
 static Uint32
@@ -1257,54 +1232,18 @@ static const getpix_func getpixes[4] = {
     getpix_8, getpix_16, getpix_24, getpix_32
 };
 
+/* encode one scan line of a colorkeyed surface */
 static int
-RLEColorkeySurface(SDL_Surface * surface)
+RLEColorkeyLine(SDL_Surface * surface, int y, Uint8 * dst, Uint32 ckey)
 {
-    Uint8 *rlebuf, *dst;
-    int maxn;
-    int y;
-    Uint8 *srcbuf, *lastline;
-    int maxsize = 0;
+    Uint8 *start = dst;
+    Uint8 *srcbuf = (Uint8 *) surface->pixels + y * surface->pitch;
     int bpp = surface->format->BytesPerPixel;
-    getpix_func getpix;
-    Uint32 ckey, rgbmask;
-    int w, h;
-
-    /* calculate the worst case size for the compressed surface */
-    switch (bpp) {
-    case 1:
-        /* worst case is alternating opaque and transparent pixels,
-           starting with an opaque pixel */
-        maxsize = surface->h * 3 * (surface->w / 2 + 1) + 2;
-        break;
-    case 2:
-    case 3:
-        /* worst case is solid runs, at most 255 pixels wide */
-        maxsize = surface->h * (2 * (surface->w / 255 + 1)
-                                + surface->w * bpp) + 2;
-        break;
-    case 4:
-        /* worst case is solid runs, at most 65535 pixels wide */
-        maxsize = surface->h * (4 * (surface->w / 65535 + 1)
-                                + surface->w * 4) + 4;
-        break;
-    }
-
-    rlebuf = (Uint8 *) SDL_malloc(maxsize);
-    if (rlebuf == NULL) {
-        return SDL_OutOfMemory();
-    }
-
-    /* Set up the conversion */
-    srcbuf = (Uint8 *) surface->pixels;
-    maxn = bpp == 4 ? 65535 : 255;
-    dst = rlebuf;
-    rgbmask = ~surface->format->Amask;
-    ckey = surface->map->info.colorkey & rgbmask;
-    lastline = dst;
-    getpix = getpixes[bpp - 1];
-    w = surface->w;
-    h = surface->h;
+    getpix_func getpix = getpixes[bpp - 1];
+    Uint32 rgbmask = ~surface->format->Amask;
+    int maxn = bpp == 4 ? 65535 : 255;
+    int w = surface->w;
+    int x = 0;
 
 #define ADD_COUNTS(n, m)            \
     if(bpp == 4) {              \
@@ -1317,82 +1256,168 @@ RLEColorkeySurface(SDL_Surface * surface)
         dst += 2;               \
     }
 
-    for (y = 0; y < h; y++) {
-        int x = 0;
-        int blankline = 0;
-        do {
-            int run, skip, len;
-            int runstart;
-            int skipstart = x;
-
-            /* find run of transparent, then opaque pixels */
-            while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) == ckey)
-                x++;
-            runstart = x;
-            while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) != ckey)
-                x++;
-            skip = runstart - skipstart;
-            if (skip == w)
-                blankline = 1;
-            run = x - runstart;
-
-            /* encode segment */
-            while (skip > maxn) {
-                ADD_COUNTS(maxn, 0);
-                skip -= maxn;
-            }
+    do {
+        int run, skip, len;
+        int runstart;
+        int skipstart = x;
+
+        /* find run of transparent, then opaque pixels */
+        while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) == ckey)
+            x++;
+        runstart = x;
+        while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) != ckey)
+            x++;
+        skip = runstart - skipstart;
+        run = x - runstart;
+
+        /* encode segment */
+        while (skip > maxn) {
+            ADD_COUNTS(maxn, 0);
+            skip -= maxn;
+        }
+        len = MIN(run, maxn);
+        ADD_COUNTS(skip, len);
+        SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
+        dst += len * bpp;
+        run -= len;
+        runstart += len;
+        while (run) {
             len = MIN(run, maxn);
-            ADD_COUNTS(skip, len);
+            ADD_COUNTS(0, len);
             SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
             dst += len * bpp;
-            run -= len;
             runstart += len;
-            while (run) {
-                len = MIN(run, maxn);
-                ADD_COUNTS(0, len);
-                SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
-                dst += len * bpp;
-                runstart += len;
-                run -= len;
-            }
-            if (!blankline)
-                lastline = dst;
-        } while (x < w);
+            run -= len;
+        }
+    } while (x < w);
+
+#undef ADD_COUNTS
 
-        srcbuf += surface->pitch;
+    return (int) (dst - start);
+}
+
+/* the worst case size of one encoded scan line */
+static int
+RLEMaxLineSize(SDL_Surface * surface, Uint32 kind, const RLEDestFormat * df)
+{
+    int w = surface->w;
+    int bpp = surface->format->BytesPerPixel;
+
+    if (kind == SDL_COPY_RLE_ALPHAKEY) {
+        if (df->BytesPerPixel == 2) {
+            /* worst case is alternating opaque and translucent pixels,
+               with room for alignment padding */
+            return 2 + (4 + 2) * (w + 1);
+        }
+        /* worst case is alternating opaque and translucent pixels */
+        return 2 * 4 * (w + 1);
     }
-    dst = lastline;             /* back up bast trailing blank lines */
-    ADD_COUNTS(0, 0);
 
-#undef ADD_COUNTS
+    switch (bpp) {
+    case 1:
+        /* worst case is alternating opaque and transparent pixels,
+           starting with an opaque pixel */
+        return 3 * (w / 2 + 1);
+    case 2:
+    case 3:
+        /* worst case is solid runs, at most 255 pixels wide */
+        return 2 * (w / 255 + 1) + w * bpp;
+    default:
+        /* worst case is solid runs, at most 65535 pixels wide */
+        return 4 * (w / 65535 + 1) + w * 4;
+    }
+}
+
+/*
+ * (Re-)encode the lines top to bottom - 1 of a surface into its cache,
+ * splicing them between the unchanged lines. A cache without a stream is
+ * encoded from scratch.
+ */
+static int
+RLEEncodeLines(SDL_Surface * surface, SDL_RLECache * cache,
+               int top, int bottom, const RLEDestFormat * df)
+{
+    const int h = surface->h;
+    const int alpha = (cache->kind == SDL_COPY_RLE_ALPHAKEY);
+    size_t head, tail, tailstart, maxsize;
+    Uint8 *data, *dst;
+    RLEDestFormat *format;
+    int y;
+
+    if (cache->data) {
+        head = cache->rows[top];
+        tailstart = cache->rows[bottom];
+        tail = cache->size - tailstart;
+    } else {
+        top = 0;
+        bottom = h;
+        head = alpha ? sizeof(RLEDestFormat) : 0;
+        tailstart = 0;
+        /* the end marker is a zero count pair */
+        if (alpha) {
+            tail = df->BytesPerPixel == 4 ? 4 : 2;
+        } else {
+            tail = surface->format->BytesPerPixel == 4 ? 4 : 2;
+        }
+    }
 
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
-        surface->pixels = NULL;
+    maxsize = head + (size_t) (bottom - top) *
+        RLEMaxLineSize(surface, cache->kind, df) + tail;
+    data = (Uint8 *) SDL_malloc(maxsize);
+    if (!data) {
+        return SDL_OutOfMemory();
     }
+    if (cache->data) {
+        SDL_memcpy(data, cache->data, head);
+    } else if (alpha) {
+        SDL_memcpy(data, df, sizeof(*df));
+    }
+    format = (RLEDestFormat *) data;
+
+    /* Do the actual encoding */
+    dst = data + head;
+    for (y = top; y < bottom; ++y) {
+        cache->rows[y] = (Uint32) (dst - data);
+        if (alpha) {
+            dst += RLEAlphaLine(surface, y, dst, format);
+        } else {
+            dst += RLEColorkeyLine(surface, y, dst, cache->colorkey);
+        }
+    }
+
+    if (cache->data) {
+        /* move the following lines and the end marker along */
+        Uint32 delta = (Uint32) (dst - data) - (Uint32) tailstart;
+        SDL_memcpy(dst, cache->data + tailstart, tail);
+        for (y = bottom; y <= h; ++y) {
+            cache->rows[y] += delta;
+        }
+        SDL_free(cache->data);
+    } else {
+        cache->rows[h] = (Uint32) (dst - data);
+        SDL_memset(dst, 0, tail);
+    }
+    dst += tail;
 
     /* realloc the buffer to release unused memory */
     {
         /* If realloc returns NULL, the original block is left intact */
-        Uint8 *p = SDL_realloc(rlebuf, dst - rlebuf);
+        Uint8 *p = SDL_realloc(data, dst - data);
         if (!p)
-            p = rlebuf;
-        surface->map->data = p;
+            p = data;
+        cache->data = p;
+        cache->size = dst - data;
     }
-
-    return (0);
+    return 0;
 }
 
-int
-SDL_RLESurface(SDL_Surface * surface)
+/* decide how a surface can be encoded, or return -1 if it can't */
+static int
+RLEChooseEncoding(SDL_Surface * surface, Uint32 * kind, RLEDestFormat * df)
 {
-    int flags;
-
-    /* Clear any previous RLE conversion */
-    if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        SDL_UnRLESurface(surface, 1);
-    }
+    SDL_BlitMap *map = surface->map;
+    int flags = map->info.flags;
+    copy_func copy_opaque, copy_transl;
 
     /* We don't support RLE encoding of bitmaps */
     if (surface->format->BitsPerPixel < 8) {
@@ -1405,120 +1430,122 @@ SDL_RLESurface(SDL_Surface * surface)
     }
 
     /* If we don't have colorkey or blending, nothing to do... */
-    flags = surface->map->info.flags;
     if (!(flags & (SDL_COPY_COLORKEY | SDL_COPY_BLEND))) {
         return -1;
     }
 
     /* Pass on combinations not supported */
-    if ((flags & SDL_COPY_MODULATE_COLOR) ||
-        ((flags & SDL_COPY_MODULATE_ALPHA) && surface->format->Amask) ||
-        (flags & (SDL_COPY_ADD | SDL_COPY_MOD)) ||
-        (flags & SDL_COPY_NEAREST)) {
+    if (((flags & SDL_COPY_MODULATE_ALPHA) && surface->format->Amask) ||
+        (flags & (SDL_COPY_ADD | SDL_COPY_MOD))) {
         return -1;
     }
 
-    /* Encode and set up the blit */
     if (!surface->format->Amask || !(flags & SDL_COPY_BLEND)) {
-        if (!surface->map->identity) {
-            return -1;
-        }
-        if (RLEColorkeySurface(surface) < 0) {
+        /* runs are copied as they are, and modulated in RGB */
+        if (!map->identity) {
             return -1;
         }
-        surface->map->blit = SDL_RLEBlit;
-        surface->map->info.flags |= SDL_COPY_RLE_COLORKEY;
-    } else {
-        if (RLEAlphaSurface(surface) < 0) {
+        if ((flags & SDL_COPY_MODULATE_COLOR) &&
+            SDL_ISPIXELFORMAT_INDEXED(surface->format->format)) {
             return -1;
         }
-        surface->map->blit = SDL_RLEAlphaBlit;
-        surface->map->info.flags |= SDL_COPY_RLE_ALPHAKEY;
+        *kind = SDL_COPY_RLE_COLORKEY;
+        return 0;
     }
 
-    /* The surface is now accelerated */
-    surface->flags |= SDL_RLEACCEL;
-
-    return (0);
+    /* The pixel alpha blitters only do straight copies */
+    if (flags & (SDL_COPY_MODULATE_COLOR | SDL_COPY_NEAREST)) {
+        return -1;
+    }
+    if (surface->format->BitsPerPixel != 32) {
+        return -1;              /* only 32bpp source supported */
+    }
+    if (map->dst) {
+        RLESaveDestFormat(df, map->dst->format);
+    } else if (map->rle_cache &&
+               map->rle_cache->kind == SDL_COPY_RLE_ALPHAKEY) {
+        /* no target while the map is invalid, keep to the last one */
+        SDL_memcpy(df, map->rle_cache->data, sizeof(*df));
+    } else {
+        return -1;
+    }
+    if (RLEAlphaCopyFuncs(df, &copy_opaque, &copy_transl) < 0) {
+        return -1;
+    }
+    *kind = SDL_COPY_RLE_ALPHAKEY;
+    return 0;
 }
 
-/*
- * Un-RLE a surface with pixel alpha
- * This may not give back exactly the image before RLE-encoding; all
- * completely transparent pixels will be lost, and color and alpha depth
- * may have been reduced (when encoding for 16bpp targets).
- */
-static SDL_bool
-UnRLEAlpha(SDL_Surface * surface)
+int
+SDL_RLESurface(SDL_Surface * surface)
 {
-    Uint8 *srcbuf;
-    Uint32 *dst;
-    SDL_PixelFormat *sf = surface->format;
-    RLEDestFormat *df = surface->map->data;
-    int (*uncopy_opaque) (Uint32 *, void *, int,
-                          RLEDestFormat *, SDL_PixelFormat *);
-    int (*uncopy_transl) (Uint32 *, void *, int,
-                          RLEDestFormat *, SDL_PixelFormat *);
-    int w = surface->w;
-    int bpp = df->BytesPerPixel;
+    SDL_BlitMap *map = surface->map;
+    SDL_RLECache *cache;
+    RLEDestFormat df;
+    Uint32 kind = 0;
+    Uint32 colorkey = 0;
 
-    if (bpp == 2) {
-        uncopy_opaque = uncopy_opaque_16;
-        uncopy_transl = uncopy_transl_16;
-    } else {
-        uncopy_opaque = uncopy_transl = uncopy_32;
+    /* Clear any previous RLE conversion */
+    if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
+        SDL_UnRLESurface(surface, 1);
     }
 
-    surface->pixels = SDL_malloc(surface->h * surface->pitch);
-    if (!surface->pixels) {
-        return (SDL_FALSE);
+    SDL_zero(df);
+    if (RLEChooseEncoding(surface, &kind, &df) < 0) {
+        SDL_FreeRLECache(map);
+        return -1;
+    }
+    if (kind == SDL_COPY_RLE_COLORKEY) {
+        colorkey = map->info.colorkey & ~surface->format->Amask;
     }
-    /* fill background with transparent pixels */
-    SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
 
-    dst = surface->pixels;
-    srcbuf = (Uint8 *) (df + 1);
-    for (;;) {
-        /* copy opaque pixels */
-        int ofs = 0;
-        do {
-            unsigned run;
-            if (bpp == 2) {
-                ofs += srcbuf[0];
-                run = srcbuf[1];
-                srcbuf += 2;
-            } else {
-                ofs += ((Uint16 *) srcbuf)[0];
-                run = ((Uint16 *) srcbuf)[1];
-                srcbuf += 4;
-            }
-            if (run) {
-                srcbuf += uncopy_opaque(dst + ofs, srcbuf, run, df, sf);
-                ofs += run;
-            } else if (!ofs)
-                return (SDL_TRUE);
-        } while (ofs < w);
-
-        /* skip padding if needed */
-        if (bpp == 2)
-            srcbuf += (uintptr_t) srcbuf & 2;
-
-        /* copy translucent pixels */
-        ofs = 0;
-        do {
-            unsigned run;
-            ofs += ((Uint16 *) srcbuf)[0];
-            run = ((Uint16 *) srcbuf)[1];
-            srcbuf += 4;
-            if (run) {
-                srcbuf += uncopy_transl(dst + ofs, srcbuf, run, df, sf);
-                ofs += run;
-            }
-        } while (ofs < w);
-        dst += surface->pitch >> 2;
+    /* Throw away an encoding made for another colorkey or target */
+    cache = map->rle_cache;
+    if (cache && (cache->kind != kind || cache->colorkey != colorkey ||
+                  (kind == SDL_COPY_RLE_ALPHAKEY &&
+                   SDL_memcmp(cache->data, &df, sizeof(df)) != 0))) {
+        SDL_FreeRLECache(map);
+        cache = NULL;
+    }
+
+    if (!cache) {
+        cache = (SDL_RLECache *) SDL_calloc(1, sizeof(*cache));
+        if (!cache) {
+            return SDL_OutOfMemory();
+        }
+        cache->rows = (Uint32 *) SDL_malloc((surface->h + 1) * sizeof(Uint32));
+        if (!cache->rows) {
+            SDL_free(cache);
+            return SDL_OutOfMemory();
+        }
+        cache->kind = kind;
+        cache->colorkey = colorkey;
+        map->rle_cache = cache;
+        if (RLEEncodeLines(surface, cache, 0, surface->h, &df) < 0) {
+            SDL_FreeRLECache(map);
+            return -1;
+        }
+    } else if (cache->dirty_top < cache->dirty_bottom) {
+        if (RLEEncodeLines(surface, cache, cache->dirty_top,
+                           cache->dirty_bottom, &df) < 0) {
+            SDL_FreeRLECache(map);
+            return -1;
+        }
     }
-    /* Make the compiler happy */
-    return (SDL_TRUE);
+    cache->dirty_top = cache->dirty_bottom = 0;
+
+    /* Set up the blit */
+    if (kind == SDL_COPY_RLE_COLORKEY) {
+        map->blit = SDL_RLEBlit;
+    } else {
+        map->blit = SDL_RLEAlphaBlit;
+    }
+    map->info.flags |= kind;
+
+    /* The surface is now accelerated */
+    surface->flags |= SDL_RLEACCEL;
+
+    return (0);
 }
 
 void
@@ -1526,40 +1553,50 @@ SDL_UnRLESurface(SDL_Surface * surface, int recode)
 {
     if (surface->flags & SDL_RLEACCEL) {
         surface->flags &= ~SDL_RLEACCEL;
+        surface->map->info.flags &=
+            ~(SDL_COPY_RLE_COLORKEY | SDL_COPY_RLE_ALPHAKEY);
+    }
 
-        if (recode && !(surface->flags & SDL_PREALLOC)) {
-            if (surface->map->info.flags & SDL_COPY_RLE_COLORKEY) {
-                SDL_Rect full;
-
-                /* re-create the original surface */
-                surface->pixels = SDL_malloc(surface->h * surface->pitch);
-                if (!surface->pixels) {
-                    /* Oh crap... */
-                    surface->flags |= SDL_RLEACCEL;
-                    return;
-                }
+    /* The pixels are always intact; keep the encoding if the surface is
+       about to be encoded again, it is likely to still be good */
+    if (!recode) {
+        SDL_FreeRLECache(surface->map);
+    }
+}
 
-                /* fill it with the background color */
-                SDL_FillRect(surface, NULL, surface->map->info.colorkey);
+void
+SDL_InvalidateRLESurface(SDL_Surface * surface, const SDL_Rect * rect)
+{
+    SDL_RLECache *cache = surface->map->rle_cache;
+    int top = 0;
+    int bottom = surface->h;
 
-                /* now render the encoded surface */
-                full.x = full.y = 0;
-                full.w = surface->w;
-                full.h = surface->h;
-                SDL_RLEBlit(surface, &full, surface, &full);
-            } else {
-                if (!UnRLEAlpha(surface)) {
-                    /* Oh crap... */
-                    surface->flags |= SDL_RLEACCEL;
-                    return;
-                }
-            }
+    if (!cache) {
+        return;
+    }
+    if (rect) {
+        top = MAX(rect->y, 0);
+        bottom = MIN(rect->y + rect->h, surface->h);
+        if (top >= bottom) {
+            return;
         }
-        surface->map->info.flags &=
-            ~(SDL_COPY_RLE_COLORKEY | SDL_COPY_RLE_ALPHAKEY);
+    }
+    if (cache->dirty_top < cache->dirty_bottom) {
+        top = MIN(top, cache->dirty_top);
+        bottom = MAX(bottom, cache->dirty_bottom);
+    }
+    cache->dirty_top = top;
+    cache->dirty_bottom = bottom;
+}
 
-        SDL_free(surface->map->data);
-        surface->map->data = NULL;
+void
+SDL_FreeRLECache(SDL_BlitMap * map)
+{
+    if (map && map->rle_cache) {
+        SDL_free(map->rle_cache->data);
+        SDL_free(map->rle_cache->rows);
+        SDL_free(map->rle_cache);
+        map->rle_cache = NULL;
     }
 }
 
@@ -28,4 +28,7 @@ extern int SDL_RLEBlit(SDL_Surface * src, SDL_Rect * srcrect,
 extern int SDL_RLEAlphaBlit(SDL_Surface * src, SDL_Rect * srcrect,
                             SDL_Surface * dst, SDL_Rect * dstrect);
 extern void SDL_UnRLESurface(SDL_Surface * surface, int recode);
+extern void SDL_InvalidateRLESurface(SDL_Surface * surface,
+                                     const SDL_Rect * rect);
+extern void SDL_FreeRLECache(SDL_BlitMap * map);
 /* vi: set ts=4 sw=4 expandtab: */
@@ -44,7 +44,7 @@ SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
     /* Lock the destination if it's in hardware */
     dst_locked = 0;
     if (SDL_MUSTLOCK(dst)) {
-        if (SDL_LockSurface(dst) < 0) {
+        if (SDL_LockSurfaceRect(dst, dstrect) < 0) {
             okay = 0;
         } else {
             dst_locked = 1;
@@ -63,9 +63,13 @@ SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
     /* Set up source and destination buffer pointers, and BLIT! */
     if (okay && !SDL_RectEmpty(srcrect)) {
         SDL_BlitFunc RunBlit;
-        SDL_BlitInfo *info = &src->map->info;
+        SDL_BlitInfo blit_info = src->map->info;
+        SDL_BlitInfo *info = &blit_info;
 
-        /* Set up the blit information */
+        /* Set up the blit information.  The blitters advance the pointers
+           as they go, so they work on a copy and the same source can be
+           blitted from several threads at once.
+         */
         info->src = (Uint8 *) src->pixels +
             (Uint16) srcrect->y * src->pitch +
             (Uint16) srcrect->x * info->src_fmt->BytesPerPixel;
@@ -234,6 +238,8 @@ SDL_CalculateBlit(SDL_Surface * surface)
         if (SDL_RLESurface(surface) == 0) {
             return 0;
         }
+    } else {
+        SDL_FreeRLECache(map);
     }
 
     /* Choose a standard blit function */
@@ -283,4 +289,28 @@ SDL_CalculateBlit(SDL_Surface * surface)
     return 0;
 }
 
+/* Switch a surface between its scaled and unscaled blitters */
+void
+SDL_SetBlitNearest(SDL_Surface * surface, SDL_bool nearest)
+{
+    SDL_BlitMap *map = surface->map;
+
+    if (!(map->info.flags & SDL_COPY_NEAREST) == !nearest) {
+        return;
+    }
+    if (nearest) {
+        map->info.flags |= SDL_COPY_NEAREST;
+    } else {
+        map->info.flags &= ~SDL_COPY_NEAREST;
+    }
+
+    /* Only the blit function depends on the flag, so a mapped surface keeps
+       its destination and color tables.  On failure the map is invalidated
+       and the next blit maps it again.
+     */
+    if (map->dst) {
+        SDL_CalculateBlit(surface);
+    }
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -90,6 +90,9 @@ typedef struct SDL_BlitMap
     void *data;
     SDL_BlitInfo info;
 
+    /* persistent RLE encoding of the source, see SDL_RLEaccel.c */
+    struct SDL_RLECache *rle_cache;
+
     /* the version count matches the destination; mismatch indicates
        an invalid mapping */
     Uint32 dst_palette_version;
@@ -98,6 +101,7 @@ typedef struct SDL_BlitMap
 
 /* Functions found in SDL_blit.c */
 extern int SDL_CalculateBlit(SDL_Surface * surface);
+extern void SDL_SetBlitNearest(SDL_Surface * surface, SDL_bool nearest);
 
 /* Functions found in SDL_blit_*.c */
 extern SDL_BlitFunc SDL_CalculateBlit0(SDL_Surface * surface);
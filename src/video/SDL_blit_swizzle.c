@@ -0,0 +1,673 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+#include "SDL_video.h"
+#include "SDL_endian.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_blit.h"
+#include "SDL_blit_swizzle.h"
+
+/* Direct conversion between the common byte-aligned RGB formats
+   (ARGB8888, ABGR8888, RGB888, RGB24, ...) and RGB565/BGR565.
+
+   These are the conversions used for texture uploads and framebuffer
+   readback, so rather than disassembling and reassembling each pixel the
+   way BlitNtoN does, they're expressed as byte permutations which map
+   directly onto SIMD shuffles.
+
+   The SSSE3 paths are only built when the compiler targets SSSE3 (there's
+   no runtime check for it), the SSE2 paths are selected at runtime, and
+   the NEON paths are used whenever the compiler targets NEON.
+ */
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON)) && (SDL_BYTEORDER == SDL_LIL_ENDIAN)
+#include <arm_neon.h>
+#define SDL_SWIZZLE_NEON 1
+#endif
+
+typedef struct
+{
+    int bpp;                    /* bytes per pixel: 2, 3 or 4 */
+    int r, g, b, a;             /* byte offset of each channel, a is -1 if absent */
+    SDL_bool is565;             /* 16-bit 5-6-5 format, channel offsets unused */
+    SDL_bool bgr;               /* BGR565 rather than RGB565 */
+} SDL_SwizzleFormat;
+
+typedef struct
+{
+    SDL_SwizzleFormat src;
+    SDL_SwizzleFormat dst;
+    int perm[4];                /* source byte for each destination byte, or -1 */
+    Uint8 fill[4];              /* value for destination bytes with no source */
+} SDL_SwizzleInfo;
+
+/* Converts the first pixels of a row and returns how many it handled */
+typedef int (*SDL_SwizzleRowFunc) (const SDL_SwizzleInfo * info,
+                                   const Uint8 * src, Uint8 * dst, int width);
+
+static int
+SDL_SwizzleByteOffset(Uint32 mask, int bpp)
+{
+    int i;
+
+    for (i = 0; i < bpp; ++i) {
+        if (mask == ((Uint32) 0xFF << (i * 8))) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            return i;
+#else
+            return (bpp - 1 - i);
+#endif
+        }
+    }
+    return -1;
+}
+
+static SDL_bool
+SDL_GetSwizzleFormat(Uint32 format, SDL_SwizzleFormat * fmt)
+{
+    int bits;
+    Uint32 Rmask, Gmask, Bmask, Amask;
+
+    SDL_zerop(fmt);
+
+    switch (format) {
+    case SDL_PIXELFORMAT_RGB565:
+    case SDL_PIXELFORMAT_BGR565:
+        fmt->bpp = 2;
+        fmt->is565 = SDL_TRUE;
+        fmt->bgr = (format == SDL_PIXELFORMAT_BGR565);
+        return SDL_TRUE;
+    default:
+        break;
+    }
+
+    if (SDL_ISPIXELFORMAT_FOURCC(format) || SDL_ISPIXELFORMAT_INDEXED(format)) {
+        return SDL_FALSE;
+    }
+    fmt->bpp = SDL_BYTESPERPIXEL(format);
+    if (fmt->bpp != 3 && fmt->bpp != 4) {
+        return SDL_FALSE;
+    }
+    if (!SDL_PixelFormatEnumToMasks(format, &bits, &Rmask, &Gmask, &Bmask, &Amask)) {
+        return SDL_FALSE;
+    }
+    fmt->r = SDL_SwizzleByteOffset(Rmask, fmt->bpp);
+    fmt->g = SDL_SwizzleByteOffset(Gmask, fmt->bpp);
+    fmt->b = SDL_SwizzleByteOffset(Bmask, fmt->bpp);
+    fmt->a = Amask ? SDL_SwizzleByteOffset(Amask, fmt->bpp) : -1;
+    if (fmt->r < 0 || fmt->g < 0 || fmt->b < 0 || (Amask && fmt->a < 0)) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+/* 5-6-5 component extraction */
+#define SWIZZLE_565_R(p, bgr)   (((bgr) ? (p) : ((p) >> 11)) & 0x1F)
+#define SWIZZLE_565_G(p)        (((p) >> 5) & 0x3F)
+#define SWIZZLE_565_B(p, bgr)   (((bgr) ? ((p) >> 11) : (p)) & 0x1F)
+
+/* The SIMD paths can't use the SDL_expand_byte tables, these reproduce
+   SDL_expand_byte[3] and SDL_expand_byte[2] exactly in 16-bit arithmetic.
+ */
+#define SWIZZLE_EXPAND5_MUL     1053
+#define SWIZZLE_EXPAND5_SHIFT   7
+#define SWIZZLE_EXPAND6_MUL     259
+#define SWIZZLE_EXPAND6_ADD     3
+#define SWIZZLE_EXPAND6_SHIFT   6
+
+static void
+SDL_SwizzleRow_Bytes(const SDL_SwizzleInfo * info,
+                     const Uint8 * src, Uint8 * dst, int width)
+{
+    const int srcbpp = info->src.bpp;
+    const int dstbpp = info->dst.bpp;
+    int i;
+
+    while (width-- > 0) {
+        for (i = 0; i < dstbpp; ++i) {
+            const int s = info->perm[i];
+            dst[i] = (s >= 0) ? src[s] : info->fill[i];
+        }
+        src += srcbpp;
+        dst += dstbpp;
+    }
+}
+
+static void
+SDL_SwizzleRow_To565(const SDL_SwizzleInfo * info,
+                     const Uint8 * src, Uint8 * dst, int width)
+{
+    const int srcbpp = info->src.bpp;
+    const int r = info->src.r, g = info->src.g, b = info->src.b;
+    Uint16 *dst16 = (Uint16 *) dst;
+
+    if (info->dst.bgr) {
+        while (width-- > 0) {
+            *dst16++ = ((src[b] >> 3) << 11) | ((src[g] >> 2) << 5) | (src[r] >> 3);
+            src += srcbpp;
+        }
+    } else {
+        while (width-- > 0) {
+            *dst16++ = ((src[r] >> 3) << 11) | ((src[g] >> 2) << 5) | (src[b] >> 3);
+            src += srcbpp;
+        }
+    }
+}
+
+static void
+SDL_SwizzleRow_From565(const SDL_SwizzleInfo * info,
+                       const Uint8 * src, Uint8 * dst, int width)
+{
+    const int dstbpp = info->dst.bpp;
+    const int r = info->dst.r, g = info->dst.g, b = info->dst.b;
+    const SDL_bool bgr = info->src.bgr;
+    const Uint16 *src16 = (const Uint16 *) src;
+
+    while (width-- > 0) {
+        const unsigned p = *src16++;
+        if (dstbpp == 4) {
+            dst[0] = dst[1] = dst[2] = dst[3] = 0;
+            if (info->dst.a >= 0) {
+                dst[info->dst.a] = 0xFF;
+            }
+        }
+        dst[r] = SDL_expand_byte[3][SWIZZLE_565_R(p, bgr)];
+        dst[g] = SDL_expand_byte[2][SWIZZLE_565_G(p)];
+        dst[b] = SDL_expand_byte[3][SWIZZLE_565_B(p, bgr)];
+        dst += dstbpp;
+    }
+}
+
+static void
+SDL_SwizzleRow_565To565(const SDL_SwizzleInfo * info,
+                        const Uint8 * src, Uint8 * dst, int width)
+{
+    const Uint16 *src16 = (const Uint16 *) src;
+    Uint16 *dst16 = (Uint16 *) dst;
+
+    while (width-- > 0) {
+        const Uint16 p = *src16++;
+        *dst16++ = (Uint16) ((p >> 11) | (p & 0x07E0) | (p << 11));
+    }
+}
+
+#ifdef __SSE2__
+/* Only defined for 4 byte source and destination formats */
+static int
+SDL_SwizzleRow_BytesSSE2(const SDL_SwizzleInfo * info,
+                         const Uint8 * src, Uint8 * dst, int width)
+{
+    __m128i shift_in[4], shift_out[4];
+    __m128i fill;
+    int i, n;
+
+    if (info->src.bpp != 4 || info->dst.bpp != 4) {
+        return 0;
+    }
+
+    for (i = 0; i < 4; ++i) {
+        const int s = (info->perm[i] >= 0) ? info->perm[i] : 0;
+        shift_in[i] = _mm_cvtsi32_si128(24 - 8 * s);
+        shift_out[i] = _mm_cvtsi32_si128(8 * i);
+    }
+    fill = _mm_set1_epi32((int) ((Uint32) info->fill[0] |
+                                 ((Uint32) info->fill[1] << 8) |
+                                 ((Uint32) info->fill[2] << 16) |
+                                 ((Uint32) info->fill[3] << 24)));
+
+    for (n = width; n >= 4; n -= 4) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) src);
+        __m128i y = fill;
+        for (i = 0; i < 4; ++i) {
+            if (info->perm[i] >= 0) {
+                /* Isolate the source byte, then move it into place */
+                const __m128i t = _mm_srli_epi32(_mm_sll_epi32(x, shift_in[i]), 24);
+                y = _mm_or_si128(y, _mm_sll_epi32(t, shift_out[i]));
+            }
+        }
+        _mm_storeu_si128((__m128i *) dst, y);
+        src += 16;
+        dst += 16;
+    }
+    return (width - n);
+}
+
+/* Only defined for 4 byte source formats */
+static int
+SDL_SwizzleRow_To565SSE2(const SDL_SwizzleInfo * info,
+                         const Uint8 * src, Uint8 * dst, int width)
+{
+    const __m128i mask5 = _mm_set1_epi32(0x1F);
+    const __m128i mask6 = _mm_set1_epi32(0x3F);
+    const int hi = info->dst.bgr ? info->src.b : info->src.r;
+    const int lo = info->dst.bgr ? info->src.r : info->src.b;
+    const __m128i shift_hi = _mm_cvtsi32_si128(8 * hi + 3);
+    const __m128i shift_g = _mm_cvtsi32_si128(8 * info->src.g + 2);
+    const __m128i shift_lo = _mm_cvtsi32_si128(8 * lo + 3);
+    __m128i p[2];
+    int i, n;
+
+    if (info->src.bpp != 4) {
+        return 0;
+    }
+
+    for (n = width; n >= 8; n -= 8) {
+        for (i = 0; i < 2; ++i) {
+            const __m128i x = _mm_loadu_si128((const __m128i *) src + i);
+            __m128i y;
+            y = _mm_slli_epi32(_mm_and_si128(_mm_srl_epi32(x, shift_hi), mask5), 11);
+            y = _mm_or_si128(y, _mm_slli_epi32(_mm_and_si128(_mm_srl_epi32(x, shift_g), mask6), 5));
+            y = _mm_or_si128(y, _mm_and_si128(_mm_srl_epi32(x, shift_lo), mask5));
+            /* Sign extend so the signed saturating pack keeps all 16 bits */
+            p[i] = _mm_srai_epi32(_mm_slli_epi32(y, 16), 16);
+        }
+        _mm_storeu_si128((__m128i *) dst, _mm_packs_epi32(p[0], p[1]));
+        src += 32;
+        dst += 16;
+    }
+    return (width - n);
+}
+
+/* Only defined for 4 byte destination formats */
+static int
+SDL_SwizzleRow_From565SSE2(const SDL_SwizzleInfo * info,
+                           const Uint8 * src, Uint8 * dst, int width)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask5 = _mm_set1_epi32(0x1F);
+    const __m128i mask6 = _mm_set1_epi32(0x3F);
+    const __m128i mul5 = _mm_set1_epi32(SWIZZLE_EXPAND5_MUL);
+    const __m128i mul6 = _mm_set1_epi32(SWIZZLE_EXPAND6_MUL);
+    const __m128i add6 = _mm_set1_epi32(SWIZZLE_EXPAND6_ADD);
+    const int hi = info->src.bgr ? info->dst.b : info->dst.r;
+    const int lo = info->src.bgr ? info->dst.r : info->dst.b;
+    const __m128i shift_hi = _mm_cvtsi32_si128(8 * hi);
+    const __m128i shift_g = _mm_cvtsi32_si128(8 * info->dst.g);
+    const __m128i shift_lo = _mm_cvtsi32_si128(8 * lo);
+    const __m128i fill = _mm_set1_epi32((info->dst.a >= 0) ? (int) (0xFFu << (8 * info->dst.a)) : 0);
+    __m128i p[2];
+    int i, n;
+
+    if (info->dst.bpp != 4) {
+        return 0;
+    }
+
+    for (n = width; n >= 8; n -= 8) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) src);
+        p[0] = _mm_unpacklo_epi16(x, zero);
+        p[1] = _mm_unpackhi_epi16(x, zero);
+        for (i = 0; i < 2; ++i) {
+            const __m128i c5hi = _mm_and_si128(_mm_srli_epi32(p[i], 11), mask5);
+            const __m128i c6 = _mm_and_si128(_mm_srli_epi32(p[i], 5), mask6);
+            const __m128i c5lo = _mm_and_si128(p[i], mask5);
+            /* The products fit in the low 16 bits of each 32-bit lane */
+            const __m128i c8hi = _mm_srli_epi32(_mm_mullo_epi16(c5hi, mul5), SWIZZLE_EXPAND5_SHIFT);
+            const __m128i c8g = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi16(c6, mul6), add6), SWIZZLE_EXPAND6_SHIFT);
+            const __m128i c8lo = _mm_srli_epi32(_mm_mullo_epi16(c5lo, mul5), SWIZZLE_EXPAND5_SHIFT);
+            __m128i y = fill;
+            y = _mm_or_si128(y, _mm_sll_epi32(c8hi, shift_hi));
+            y = _mm_or_si128(y, _mm_sll_epi32(c8g, shift_g));
+            y = _mm_or_si128(y, _mm_sll_epi32(c8lo, shift_lo));
+            _mm_storeu_si128((__m128i *) dst + i, y);
+        }
+        src += 16;
+        dst += 32;
+    }
+    return (width - n);
+}
+
+static int
+SDL_SwizzleRow_565To565SSE2(const SDL_SwizzleInfo * info,
+                            const Uint8 * src, Uint8 * dst, int width)
+{
+    const __m128i maskg = _mm_set1_epi16(0x07E0);
+    int n;
+
+    for (n = width; n >= 8; n -= 8) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) src);
+        __m128i y = _mm_and_si128(x, maskg);
+        y = _mm_or_si128(y, _mm_srli_epi16(x, 11));
+        y = _mm_or_si128(y, _mm_slli_epi16(x, 11));
+        _mm_storeu_si128((__m128i *) dst, y);
+        src += 16;
+        dst += 16;
+    }
+    return (width - n);
+}
+#endif /* __SSE2__ */
+
+#ifdef __SSSE3__
+static __m128i
+SDL_SwizzleShuffleMask(const SDL_SwizzleInfo * info, int pixels)
+{
+    DECLARE_ALIGNED(Uint8, mask[16], 16);
+    int i, j;
+
+    for (i = 0; i < 16; ++i) {
+        mask[i] = 0x80;
+    }
+    for (i = 0; i < pixels; ++i) {
+        for (j = 0; j < info->dst.bpp; ++j) {
+            if (info->perm[j] >= 0) {
+                mask[i * info->dst.bpp + j] = (Uint8) (i * info->src.bpp + info->perm[j]);
+            }
+        }
+    }
+    return _mm_load_si128((const __m128i *) mask);
+}
+
+static __m128i
+SDL_SwizzleFillMask(const SDL_SwizzleInfo * info, int pixels)
+{
+    DECLARE_ALIGNED(Uint8, fill[16], 16);
+    int i, j;
+
+    SDL_zero(fill);
+    for (i = 0; i < pixels; ++i) {
+        for (j = 0; j < info->dst.bpp; ++j) {
+            fill[i * info->dst.bpp + j] = info->fill[j];
+        }
+    }
+    return _mm_load_si128((const __m128i *) fill);
+}
+
+/* Handles every combination of 3 and 4 byte formats with one pshufb per
+   step.  Packed 3 byte pixels don't fill a register evenly, so those loops
+   read or write a few bytes past the pixels they convert and stop early
+   enough that this never leaves the row.
+ */
+static int
+SDL_SwizzleRow_BytesSSSE3(const SDL_SwizzleInfo * info,
+                          const Uint8 * src, Uint8 * dst, int width)
+{
+    const int srcbpp = info->src.bpp;
+    const int dstbpp = info->dst.bpp;
+    const int pixels = (srcbpp == 3 && dstbpp == 3) ? 5 : 4;
+    const __m128i shuffle = SDL_SwizzleShuffleMask(info, pixels);
+    const __m128i fill = SDL_SwizzleFillMask(info, pixels);
+    const int stop = (srcbpp == 4 && dstbpp == 4) ? 4 : (pixels + 2);
+    int n;
+
+    for (n = width; n >= stop; n -= pixels) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) src);
+        _mm_storeu_si128((__m128i *) dst,
+                         _mm_or_si128(_mm_shuffle_epi8(x, shuffle), fill));
+        src += pixels * srcbpp;
+        dst += pixels * dstbpp;
+    }
+    return (width - n);
+}
+#endif /* __SSSE3__ */
+
+#ifdef SDL_SWIZZLE_NEON
+static uint8x16x4_t
+SDL_SwizzleLoadNEON(const Uint8 * src, int bpp)
+{
+    uint8x16x4_t v;
+
+    if (bpp == 4) {
+        v = vld4q_u8(src);
+    } else {
+        const uint8x16x3_t t = vld3q_u8(src);
+        v.val[0] = t.val[0];
+        v.val[1] = t.val[1];
+        v.val[2] = t.val[2];
+        v.val[3] = vdupq_n_u8(0);
+    }
+    return v;
+}
+
+static void
+SDL_SwizzleStoreNEON(Uint8 * dst, int bpp, uint8x16x4_t v)
+{
+    if (bpp == 4) {
+        vst4q_u8(dst, v);
+    } else {
+        uint8x16x3_t t;
+        t.val[0] = v.val[0];
+        t.val[1] = v.val[1];
+        t.val[2] = v.val[2];
+        vst3q_u8(dst, t);
+    }
+}
+
+/* The structured loads split pixels into one register per byte, so any
+   combination of 3 and 4 byte formats is just a register permutation.
+ */
+static int
+SDL_SwizzleRow_BytesNEON(const SDL_SwizzleInfo * info,
+                         const Uint8 * src, Uint8 * dst, int width)
+{
+    const int srcbpp = info->src.bpp;
+    const int dstbpp = info->dst.bpp;
+    uint8x16x4_t x, y;
+    int i, n;
+
+    for (i = 0; i < 4; ++i) {
+        y.val[i] = vdupq_n_u8(info->fill[i]);
+    }
+    for (n = width; n >= 16; n -= 16) {
+        x = SDL_SwizzleLoadNEON(src, srcbpp);
+        for (i = 0; i < dstbpp; ++i) {
+            if (info->perm[i] >= 0) {
+                y.val[i] = x.val[info->perm[i]];
+            }
+        }
+        SDL_SwizzleStoreNEON(dst, dstbpp, y);
+        src += 16 * srcbpp;
+        dst += 16 * dstbpp;
+    }
+    return (width - n);
+}
+
+static uint16x8_t
+SDL_Swizzle565NEON(uint8x8_t hi, uint8x8_t g, uint8x8_t lo)
+{
+    uint16x8_t p = vshll_n_u8(hi, 8);
+    p = vsriq_n_u16(p, vshll_n_u8(g, 8), 5);
+    p = vsriq_n_u16(p, vshll_n_u8(lo, 8), 11);
+    return p;
+}
+
+static int
+SDL_SwizzleRow_To565NEON(const SDL_SwizzleInfo * info,
+                         const Uint8 * src, Uint8 * dst, int width)
+{
+    const int srcbpp = info->src.bpp;
+    const int hi = info->dst.bgr ? info->src.b : info->src.r;
+    const int lo = info->dst.bgr ? info->src.r : info->src.b;
+    const int g = info->src.g;
+    uint16_t *dst16 = (uint16_t *) dst;
+    uint8x16x4_t x;
+    int n;
+
+    for (n = width; n >= 16; n -= 16) {
+        x = SDL_SwizzleLoadNEON(src, srcbpp);
+        vst1q_u16(dst16, SDL_Swizzle565NEON(vget_low_u8(x.val[hi]),
+                                            vget_low_u8(x.val[g]),
+                                            vget_low_u8(x.val[lo])));
+        vst1q_u16(dst16 + 8, SDL_Swizzle565NEON(vget_high_u8(x.val[hi]),
+                                                vget_high_u8(x.val[g]),
+                                                vget_high_u8(x.val[lo])));
+        src += 16 * srcbpp;
+        dst16 += 16;
+    }
+    return (width - n);
+}
+
+static uint8x8_t
+SDL_SwizzleExpand5NEON(uint16x8_t v)
+{
+    return vshrn_n_u16(vmulq_n_u16(v, SWIZZLE_EXPAND5_MUL), SWIZZLE_EXPAND5_SHIFT);
+}
+
+static uint8x8_t
+SDL_SwizzleExpand6NEON(uint16x8_t v)
+{
+    v = vmlaq_n_u16(vdupq_n_u16(SWIZZLE_EXPAND6_ADD), v, SWIZZLE_EXPAND6_MUL);
+    return vshrn_n_u16(v, SWIZZLE_EXPAND6_SHIFT);
+}
+
+static int
+SDL_SwizzleRow_From565NEON(const SDL_SwizzleInfo * info,
+                           const Uint8 * src, Uint8 * dst, int width)
+{
+    const int dstbpp = info->dst.bpp;
+    const int hi = info->src.bgr ? info->dst.b : info->dst.r;
+    const int lo = info->src.bgr ? info->dst.r : info->dst.b;
+    const int g = info->dst.g;
+    const uint16_t *src16 = (const uint16_t *) src;
+    uint8x16x4_t y;
+    int i, n;
+
+    for (i = 0; i < 4; ++i) {
+        y.val[i] = vdupq_n_u8(info->fill[i]);
+    }
+    for (n = width; n >= 16; n -= 16) {
+        const uint16x8_t p0 = vld1q_u16(src16);
+        const uint16x8_t p1 = vld1q_u16(src16 + 8);
+
+        y.val[hi] = vcombine_u8(SDL_SwizzleExpand5NEON(vshrq_n_u16(p0, 11)),
+                                SDL_SwizzleExpand5NEON(vshrq_n_u16(p1, 11)));
+        y.val[g] = vcombine_u8(SDL_SwizzleExpand6NEON(vandq_u16(vshrq_n_u16(p0, 5), vdupq_n_u16(0x3F))),
+                               SDL_SwizzleExpand6NEON(vandq_u16(vshrq_n_u16(p1, 5), vdupq_n_u16(0x3F))));
+        y.val[lo] = vcombine_u8(SDL_SwizzleExpand5NEON(vandq_u16(p0, vdupq_n_u16(0x1F))),
+                                SDL_SwizzleExpand5NEON(vandq_u16(p1, vdupq_n_u16(0x1F))));
+
+        SDL_SwizzleStoreNEON(dst, dstbpp, y);
+        src16 += 16;
+        dst += 16 * dstbpp;
+    }
+    return (width - n);
+}
+
+static int
+SDL_SwizzleRow_565To565NEON(const SDL_SwizzleInfo * info,
+                            const Uint8 * src, Uint8 * dst, int width)
+{
+    const uint16_t *src16 = (const uint16_t *) src;
+    uint16_t *dst16 = (uint16_t *) dst;
+    int n;
+
+    for (n = width; n >= 8; n -= 8) {
+        const uint16x8_t x = vld1q_u16(src16);
+        uint16x8_t y = vandq_u16(x, vdupq_n_u16(0x07E0));
+        y = vorrq_u16(y, vshrq_n_u16(x, 11));
+        y = vorrq_u16(y, vshlq_n_u16(x, 11));
+        vst1q_u16(dst16, y);
+        src16 += 8;
+        dst16 += 8;
+    }
+    return (width - n);
+}
+#endif /* SDL_SWIZZLE_NEON */
+
+SDL_bool
+SDL_SwizzlePixels(int width, int height,
+                  Uint32 src_format, const void * src, int src_pitch,
+                  Uint32 dst_format, void * dst, int dst_pitch)
+{
+    SDL_SwizzleInfo info;
+    SDL_SwizzleRowFunc simd = NULL;
+    void (*scalar) (const SDL_SwizzleInfo *, const Uint8 *, Uint8 *, int);
+    const Uint8 *srcrow = (const Uint8 *) src;
+    Uint8 *dstrow = (Uint8 *) dst;
+    int i;
+
+    if (!SDL_GetSwizzleFormat(src_format, &info.src) ||
+        !SDL_GetSwizzleFormat(dst_format, &info.dst)) {
+        return SDL_FALSE;
+    }
+
+    for (i = 0; i < 4; ++i) {
+        info.perm[i] = -1;
+        info.fill[i] = 0;
+    }
+
+    if (info.src.is565 && info.dst.is565) {
+        scalar = SDL_SwizzleRow_565To565;
+#if defined(SDL_SWIZZLE_NEON)
+        simd = SDL_SwizzleRow_565To565NEON;
+#elif defined(__SSE2__)
+        if (SDL_HasSSE2()) {
+            simd = SDL_SwizzleRow_565To565SSE2;
+        }
+#endif
+    } else if (info.dst.is565) {
+        scalar = SDL_SwizzleRow_To565;
+#if defined(SDL_SWIZZLE_NEON)
+        simd = SDL_SwizzleRow_To565NEON;
+#elif defined(__SSE2__)
+        if (SDL_HasSSE2()) {
+            simd = SDL_SwizzleRow_To565SSE2;
+        }
+#endif
+    } else if (info.src.is565) {
+        if (info.dst.a >= 0) {
+            info.fill[info.dst.a] = 0xFF;
+        }
+        scalar = SDL_SwizzleRow_From565;
+#if defined(SDL_SWIZZLE_NEON)
+        simd = SDL_SwizzleRow_From565NEON;
+#elif defined(__SSE2__)
+        if (SDL_HasSSE2()) {
+            simd = SDL_SwizzleRow_From565SSE2;
+        }
+#endif
+    } else {
+        info.perm[info.dst.r] = info.src.r;
+        info.perm[info.dst.g] = info.src.g;
+        info.perm[info.dst.b] = info.src.b;
+        if (info.dst.a >= 0) {
+            if (info.src.a >= 0) {
+                info.perm[info.dst.a] = info.src.a;
+            } else {
+                info.fill[info.dst.a] = 0xFF;
+            }
+        }
+        scalar = SDL_SwizzleRow_Bytes;
+#if defined(SDL_SWIZZLE_NEON)
+        simd = SDL_SwizzleRow_BytesNEON;
+#elif defined(__SSSE3__)
+        simd = SDL_SwizzleRow_BytesSSSE3;
+#elif defined(__SSE2__)
+        if (SDL_HasSSE2()) {
+            simd = SDL_SwizzleRow_BytesSSE2;
+        }
+#endif
+    }
+
+    while (height-- > 0) {
+        const int done = simd ? simd(&info, srcrow, dstrow, width) : 0;
+        scalar(&info, srcrow + done * info.src.bpp,
+               dstrow + done * info.dst.bpp, width - done);
+        srcrow += src_pitch;
+        dstrow += dst_pitch;
+    }
+    return SDL_TRUE;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
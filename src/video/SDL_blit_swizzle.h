@@ -0,0 +1,38 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_blit_swizzle_h
+#define _SDL_blit_swizzle_h
+
+#include "SDL_pixels.h"
+
+/* Convert between common 16/24/32-bit RGB formats without going through the
+   blit machinery.  Returns SDL_FALSE if the format pair isn't handled here,
+   in which case the caller should fall back to a regular blit.
+ */
+extern SDL_bool SDL_SwizzlePixels(int width, int height,
+                                  Uint32 src_format, const void * src, int src_pitch,
+                                  Uint32 dst_format, void * dst, int dst_pitch);
+
+#endif /* _SDL_blit_swizzle_h */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -22,7 +22,35 @@
 
 #include "SDL_video.h"
 #include "SDL_blit.h"
+#include "SDL_sysvideo.h"
 
+/* Fills larger than this use non-temporal stores where available, so that
+   clearing a big surface doesn't evict everything else from the cache.
+ */
+#define SDL_FILLRECT_STREAM_BYTES   (1024 * 1024)
+
+/* Build 16 pixels worth of a 24-bit color in memory order, with two extra
+   bytes so that the pattern can be started at any byte of a pixel.
+ */
+static void
+SDL_FillRect3Pattern(Uint32 color, Uint8 pattern[50])
+{
+    Uint8 bytes[3];
+    int i;
+
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    bytes[0] = (Uint8) (color & 0xFF);
+    bytes[1] = (Uint8) ((color >> 8) & 0xFF);
+    bytes[2] = (Uint8) ((color >> 16) & 0xFF);
+#else
+    bytes[0] = (Uint8) ((color >> 16) & 0xFF);
+    bytes[1] = (Uint8) ((color >> 8) & 0xFF);
+    bytes[2] = (Uint8) (color & 0xFF);
+#endif
+    for (i = 0; i < 50; ++i) {
+        pattern[i] = bytes[i % 3];
+    }
+}
 
 #ifdef __SSE__
 /* *INDENT-OFF* */
@@ -46,19 +74,33 @@
 #endif
 
 #define SSE_WORK \
-    for (i = n / 64; i--;) { \
-        _mm_stream_ps((float *)(p+0), c128); \
-        _mm_stream_ps((float *)(p+16), c128); \
-        _mm_stream_ps((float *)(p+32), c128); \
-        _mm_stream_ps((float *)(p+48), c128); \
-        p += 64; \
+    if (stream) { \
+        for (i = n / 64; i--;) { \
+            _mm_stream_ps((float *)(p+0), c128); \
+            _mm_stream_ps((float *)(p+16), c128); \
+            _mm_stream_ps((float *)(p+32), c128); \
+            _mm_stream_ps((float *)(p+48), c128); \
+            p += 64; \
+        } \
+    } else { \
+        for (i = n / 64; i--;) { \
+            _mm_store_ps((float *)(p+0), c128); \
+            _mm_store_ps((float *)(p+16), c128); \
+            _mm_store_ps((float *)(p+32), c128); \
+            _mm_store_ps((float *)(p+48), c128); \
+            p += 64; \
+        } \
     }
 
-#define SSE_END
+#define SSE_END \
+    if (stream) { \
+        _mm_sfence(); \
+    }
 
 #define DEFINE_SSE_FILLRECT(bpp, type) \
 static void \
-SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h, \
+                       SDL_bool stream) \
 { \
     int i, n; \
     Uint8 *p = NULL; \
@@ -96,7 +138,8 @@ SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
 }
 
 static void
-SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
+SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h,
+                 SDL_bool stream)
 {
     int i, n;
     Uint8 *p = NULL;
@@ -107,7 +150,7 @@ SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
         p = pixels;
 
         if (n > 63) {
-            int adjust = 16 - ((uintptr_t)p & 15);
+            int adjust = (16 - ((uintptr_t)p & 15)) & 15;
             if (adjust) {
                 n -= adjust;
                 SDL_memset(p, color, adjust);
@@ -129,9 +172,244 @@ SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
 DEFINE_SSE_FILLRECT(2, Uint16)
 DEFINE_SSE_FILLRECT(4, Uint32)
 
+static void
+SDL_FillRect3SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h,
+                 SDL_bool stream)
+{
+    Uint8 pattern[50];
+    __m128 a, b, c;
+    int i, n, adjust, phase;
+    Uint8 *p = NULL;
+
+    SDL_FillRect3Pattern(color, pattern);
+
+    while (h--) {
+        n = w * 3;
+        p = pixels;
+
+        if (n > 63) {
+            adjust = (16 - ((uintptr_t)p & 15)) & 15;
+            SDL_memcpy(p, pattern, adjust);
+            p += adjust;
+            n -= adjust;
+
+            /* 48 bytes is a whole number of pixels and of vectors */
+            phase = adjust % 3;
+            a = _mm_loadu_ps((const float *)(pattern + phase + 0));
+            b = _mm_loadu_ps((const float *)(pattern + phase + 16));
+            c = _mm_loadu_ps((const float *)(pattern + phase + 32));
+            if (stream) {
+                for (i = n / 48; i--;) {
+                    _mm_stream_ps((float *)(p+0), a);
+                    _mm_stream_ps((float *)(p+16), b);
+                    _mm_stream_ps((float *)(p+32), c);
+                    p += 48;
+                }
+            } else {
+                for (i = n / 48; i--;) {
+                    _mm_store_ps((float *)(p+0), a);
+                    _mm_store_ps((float *)(p+16), b);
+                    _mm_store_ps((float *)(p+32), c);
+                    p += 48;
+                }
+            }
+            SDL_memcpy(p, pattern + phase, n % 48);
+        } else {
+            if (n > 48) {
+                SDL_memcpy(p, pattern, 48);
+                p += 48;
+                n -= 48;
+            }
+            SDL_memcpy(p, pattern, n);
+        }
+        pixels += pitch;
+    }
+
+    SSE_END;
+}
+
 /* *INDENT-ON* */
 #endif /* __SSE__ */
 
+#ifdef __AVX__
+/* *INDENT-OFF* */
+
+#include <immintrin.h>
+
+#define AVX_BEGIN \
+    __m256 c256 = _mm256_castsi256_ps(_mm256_set1_epi32((int)color))
+
+#define AVX_WORK \
+    if (stream) { \
+        for (i = n / 128; i--;) { \
+            _mm256_stream_ps((float *)(p+0), c256); \
+            _mm256_stream_ps((float *)(p+32), c256); \
+            _mm256_stream_ps((float *)(p+64), c256); \
+            _mm256_stream_ps((float *)(p+96), c256); \
+            p += 128; \
+        } \
+    } else { \
+        for (i = n / 128; i--;) { \
+            _mm256_store_ps((float *)(p+0), c256); \
+            _mm256_store_ps((float *)(p+32), c256); \
+            _mm256_store_ps((float *)(p+64), c256); \
+            _mm256_store_ps((float *)(p+96), c256); \
+            p += 128; \
+        } \
+    }
+
+#define AVX_END \
+    if (stream) { \
+        _mm_sfence(); \
+    } \
+    _mm256_zeroupper()
+
+#define DEFINE_AVX_FILLRECT(bpp, type) \
+static void \
+SDL_FillRect##bpp##AVX(Uint8 *pixels, int pitch, Uint32 color, int w, int h, \
+                       SDL_bool stream) \
+{ \
+    int i, n; \
+    Uint8 *p = NULL; \
+ \
+    AVX_BEGIN; \
+ \
+    while (h--) { \
+        n = w * bpp; \
+        p = pixels; \
+ \
+        if (n > 127) { \
+            int adjust = 32 - ((uintptr_t)p & 31); \
+            if (adjust < 32) { \
+                n -= adjust; \
+                adjust /= bpp; \
+                while (adjust--) { \
+                    *((type *)p) = (type)color; \
+                    p += bpp; \
+                } \
+            } \
+            AVX_WORK; \
+        } \
+        if (n & 127) { \
+            int remainder = (n & 127); \
+            remainder /= bpp; \
+            while (remainder--) { \
+                *((type *)p) = (type)color; \
+                p += bpp; \
+            } \
+        } \
+        pixels += pitch; \
+    } \
+ \
+    AVX_END; \
+}
+
+static void
+SDL_FillRect1AVX(Uint8 *pixels, int pitch, Uint32 color, int w, int h,
+                 SDL_bool stream)
+{
+    int i, n;
+    Uint8 *p = NULL;
+
+    AVX_BEGIN;
+
+    while (h--) {
+        n = w;
+        p = pixels;
+
+        if (n > 127) {
+            int adjust = (32 - ((uintptr_t)p & 31)) & 31;
+            if (adjust) {
+                n -= adjust;
+                SDL_memset(p, color, adjust);
+                p += adjust;
+            }
+            AVX_WORK;
+        }
+        if (n & 127) {
+            int remainder = (n & 127);
+            SDL_memset(p, color, remainder);
+            p += remainder;
+        }
+        pixels += pitch;
+    }
+
+    AVX_END;
+}
+DEFINE_AVX_FILLRECT(2, Uint16)
+DEFINE_AVX_FILLRECT(4, Uint32)
+
+/* *INDENT-ON* */
+#endif /* __AVX__ */
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define SDL_FILLRECT_NEON
+
+#include <arm_neon.h>
+
+/* NEON stores don't need any alignment, so rows are filled 64 bytes at a
+   time from wherever they start, and the tail is copied from the same
+   pattern.  The color must be replicated to 32 bits for 1 and 2 bpp.
+ */
+static void
+SDL_FillRectNEON(Uint8 *pixels, int pitch, Uint32 color, int w, int h,
+                 int bpp)
+{
+    const uint8x16_t c128 = vreinterpretq_u8_u32(vdupq_n_u32(color));
+    Uint32 pattern[4];
+    Uint8 *p;
+    int n;
+
+    pattern[0] = pattern[1] = pattern[2] = pattern[3] = color;
+
+    while (h--) {
+        n = w * bpp;
+        p = pixels;
+
+        for (; n >= 64; n -= 64) {
+            vst1q_u8(p+0, c128);
+            vst1q_u8(p+16, c128);
+            vst1q_u8(p+32, c128);
+            vst1q_u8(p+48, c128);
+            p += 64;
+        }
+        for (; n >= 16; n -= 16) {
+            vst1q_u8(p, c128);
+            p += 16;
+        }
+        SDL_memcpy(p, pattern, n);
+        pixels += pitch;
+    }
+}
+
+static void
+SDL_FillRect3NEON(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
+{
+    Uint8 pattern[50];
+    uint8x16x3_t c384;
+    Uint8 *p;
+    int n;
+
+    SDL_FillRect3Pattern(color, pattern);
+    c384.val[0] = vdupq_n_u8(pattern[0]);
+    c384.val[1] = vdupq_n_u8(pattern[1]);
+    c384.val[2] = vdupq_n_u8(pattern[2]);
+
+    while (h--) {
+        n = w * 3;
+        p = pixels;
+
+        for (; n >= 48; n -= 48) {
+            vst3q_u8(p, c384);
+            p += 48;
+        }
+        SDL_memcpy(p, pattern, n);
+        pixels += pitch;
+    }
+}
+
+#endif /* __ARM_NEON__ || __ARM_NEON */
+
 #ifdef __MMX__
 /* *INDENT-OFF* */
 
@@ -297,20 +575,37 @@ SDL_FillRect2(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
 static void
 SDL_FillRect3(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
 {
-    Uint8 r = (Uint8) ((color >> 16) & 0xFF);
-    Uint8 g = (Uint8) ((color >> 8) & 0xFF);
-    Uint8 b = (Uint8) (color & 0xFF);
-    int n;
+    Uint8 pattern[50];
+    Uint32 c0, c1, c2;
+    int n, adjust, phase;
     Uint8 *p = NULL;
 
+    SDL_FillRect3Pattern(color, pattern);
+
     while (h--) {
-        n = w;
+        n = w * 3;
         p = pixels;
 
-        while (n--) {
-            *p++ = r;
-            *p++ = g;
-            *p++ = b;
+        /* Write 4 pixels at a time as 3 aligned words */
+        adjust = (4 - ((uintptr_t) p & 3)) & 3;
+        if (n > 11 + adjust) {
+            SDL_memcpy(p, pattern, adjust);
+            p += adjust;
+            n -= adjust;
+
+            phase = adjust % 3;
+            SDL_memcpy(&c0, pattern + phase + 0, 4);
+            SDL_memcpy(&c1, pattern + phase + 4, 4);
+            SDL_memcpy(&c2, pattern + phase + 8, 4);
+            for (; n >= 12; n -= 12) {
+                ((Uint32 *) p)[0] = c0;
+                ((Uint32 *) p)[1] = c1;
+                ((Uint32 *) p)[2] = c2;
+                p += 12;
+            }
+            SDL_memcpy(p, pattern + phase, n);
+        } else {
+            SDL_memcpy(p, pattern, n);
         }
         pixels += pitch;
     }
@@ -325,128 +620,324 @@ SDL_FillRect4(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
     }
 }
 
-/* 
- * This function performs a fast fill of the given rectangle with 'color'
+/*
+ * Fill rows of pixels with a color, using the fastest method available
  */
-int
-SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
+static void
+SDL_FillRectPixels(int bpp, Uint8 * pixels, int pitch, Uint32 color,
+                   int w, int h, SDL_bool stream)
 {
-    SDL_Rect clipped;
-    Uint8 *pixels;
-
-    if (!dst) {
-        return SDL_SetError("Passed NULL destination surface");
-    }
-
-    /* This function doesn't work on surfaces < 8 bpp */
-    if (dst->format->BitsPerPixel < 8) {
-        return SDL_SetError("SDL_FillRect(): Unsupported surface format");
-    }
-
-    /* If 'rect' == NULL, then fill the whole surface */
-    if (rect) {
-        /* Perform clipping */
-        if (!SDL_IntersectRect(rect, &dst->clip_rect, &clipped)) {
-            return 0;
-        }
-        rect = &clipped;
-    } else {
-        rect = &dst->clip_rect;
-    }
-
-    /* Perform software fill */
-    if (!dst->pixels) {
-        return SDL_SetError("SDL_FillRect(): You must lock the surface");
-    }
-
-    pixels = (Uint8 *) dst->pixels + rect->y * dst->pitch +
-                                     rect->x * dst->format->BytesPerPixel;
-
-    switch (dst->format->BytesPerPixel) {
+    switch (bpp) {
     case 1:
         {
             color |= (color << 8);
             color |= (color << 16);
+#ifdef __AVX__
+            if (SDL_HasAVX()) {
+                SDL_FillRect1AVX(pixels, pitch, color, w, h, stream);
+                break;
+            }
+#endif
 #ifdef __SSE__
             if (SDL_HasSSE()) {
-                SDL_FillRect1SSE(pixels, dst->pitch, color, rect->w, rect->h);
+                SDL_FillRect1SSE(pixels, pitch, color, w, h, stream);
                 break;
             }
 #endif
 #ifdef __MMX__
             if (SDL_HasMMX()) {
-                SDL_FillRect1MMX(pixels, dst->pitch, color, rect->w, rect->h);
+                SDL_FillRect1MMX(pixels, pitch, color, w, h);
                 break;
             }
 #endif
-            SDL_FillRect1(pixels, dst->pitch, color, rect->w, rect->h);
+#ifdef SDL_FILLRECT_NEON
+            SDL_FillRectNEON(pixels, pitch, color, w, h, 1);
+            break;
+#endif
+            SDL_FillRect1(pixels, pitch, color, w, h);
             break;
         }
 
     case 2:
         {
             color |= (color << 16);
+#ifdef __AVX__
+            if (SDL_HasAVX()) {
+                SDL_FillRect2AVX(pixels, pitch, color, w, h, stream);
+                break;
+            }
+#endif
 #ifdef __SSE__
             if (SDL_HasSSE()) {
-                SDL_FillRect2SSE(pixels, dst->pitch, color, rect->w, rect->h);
+                SDL_FillRect2SSE(pixels, pitch, color, w, h, stream);
                 break;
             }
 #endif
 #ifdef __MMX__
             if (SDL_HasMMX()) {
-                SDL_FillRect2MMX(pixels, dst->pitch, color, rect->w, rect->h);
+                SDL_FillRect2MMX(pixels, pitch, color, w, h);
                 break;
             }
 #endif
-            SDL_FillRect2(pixels, dst->pitch, color, rect->w, rect->h);
+#ifdef SDL_FILLRECT_NEON
+            SDL_FillRectNEON(pixels, pitch, color, w, h, 2);
+            break;
+#endif
+            SDL_FillRect2(pixels, pitch, color, w, h);
             break;
         }
 
     case 3:
-        /* 24-bit RGB is a slow path, at least for now. */
         {
-            SDL_FillRect3(pixels, dst->pitch, color, rect->w, rect->h);
+#ifdef __SSE__
+            if (SDL_HasSSE()) {
+                SDL_FillRect3SSE(pixels, pitch, color, w, h, stream);
+                break;
+            }
+#endif
+#ifdef SDL_FILLRECT_NEON
+            SDL_FillRect3NEON(pixels, pitch, color, w, h);
+            break;
+#endif
+            SDL_FillRect3(pixels, pitch, color, w, h);
             break;
         }
 
     case 4:
         {
+#ifdef __AVX__
+            if (SDL_HasAVX()) {
+                SDL_FillRect4AVX(pixels, pitch, color, w, h, stream);
+                break;
+            }
+#endif
 #ifdef __SSE__
             if (SDL_HasSSE()) {
-                SDL_FillRect4SSE(pixels, dst->pitch, color, rect->w, rect->h);
+                SDL_FillRect4SSE(pixels, pitch, color, w, h, stream);
                 break;
             }
 #endif
 #ifdef __MMX__
             if (SDL_HasMMX()) {
-                SDL_FillRect4MMX(pixels, dst->pitch, color, rect->w, rect->h);
+                SDL_FillRect4MMX(pixels, pitch, color, w, h);
                 break;
             }
 #endif
-            SDL_FillRect4(pixels, dst->pitch, color, rect->w, rect->h);
+#ifdef SDL_FILLRECT_NEON
+            SDL_FillRectNEON(pixels, pitch, color, w, h, 4);
+            break;
+#endif
+            SDL_FillRect4(pixels, pitch, color, w, h);
             break;
         }
     }
+}
+
+/* 
+ * This function performs a fast fill of the given rectangle with 'color'
+ */
+int
+SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
+{
+    SDL_Rect clipped;
+    Uint8 *pixels;
+    SDL_bool stream;
+
+    if (!dst) {
+        return SDL_SetError("Passed NULL destination surface");
+    }
+
+    /* This function doesn't work on surfaces < 8 bpp */
+    if (dst->format->BitsPerPixel < 8) {
+        return SDL_SetError("SDL_FillRect(): Unsupported surface format");
+    }
+
+    /* If 'rect' == NULL, then fill the whole surface */
+    if (rect) {
+        /* Perform clipping */
+        if (!SDL_IntersectRect(rect, &dst->clip_rect, &clipped)) {
+            return 0;
+        }
+        rect = &clipped;
+    } else {
+        rect = &dst->clip_rect;
+        /* The clip rectangle may be empty if it was set outside the surface */
+        if (SDL_RectEmpty(rect)) {
+            return 0;
+        }
+    }
+
+    /* Perform software fill */
+    if (!dst->pixels) {
+        return SDL_SetError("SDL_FillRect(): You must lock the surface");
+    }
+
+    if (dst->flags & SDL_TRACKDIRTY) {
+        SDL_AddWindowSurfaceDirtyRect(dst, rect);
+    }
+
+    /* Keep the RLE encoding of the surface up to date */
+    if (SDL_MUSTLOCK(dst)) {
+        if (SDL_LockSurfaceRect(dst, rect) < 0) {
+            return -1;
+        }
+    }
+
+    pixels = (Uint8 *) dst->pixels + rect->y * dst->pitch +
+                                     rect->x * dst->format->BytesPerPixel;
+
+    stream = ((size_t) rect->w * rect->h * dst->format->BytesPerPixel >=
+              SDL_FILLRECT_STREAM_BYTES);
+    SDL_FillRectPixels(dst->format->BytesPerPixel, pixels, dst->pitch, color,
+                       rect->w, rect->h, stream);
+
+    if (SDL_MUSTLOCK(dst)) {
+        SDL_UnlockSurface(dst);
+    }
 
     /* We're done! */
     return 0;
 }
 
+static int
+SDL_CompareFillRects(const void *a, const void *b)
+{
+    const SDL_Rect *A = (const SDL_Rect *) a;
+    const SDL_Rect *B = (const SDL_Rect *) b;
+
+    if (A->y != B->y) {
+        return (A->y - B->y);
+    }
+    return (A->x - B->x);
+}
+
+/*
+ * Fill the rectangles in horizontal bands, top to bottom.  Within a band
+ * the overlapping rectangles are merged into disjoint spans, so every
+ * pixel is written once and memory is walked in order.
+ */
 int
 SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
               Uint32 color)
 {
-    int i;
+    SDL_Rect *sorted, *active, span, bounds;
+    SDL_bool stream;
+    int bpp, numrects, numactive, next, y, bottom;
+    int i, j;
     int status = 0;
 
     if (!rects) {
         return SDL_SetError("SDL_FillRects() passed NULL rects");
     }
+    if (count <= 1) {
+        return (count == 1) ? SDL_FillRect(dst, rects, color) : 0;
+    }
+    if (!dst) {
+        return SDL_SetError("Passed NULL destination surface");
+    }
+    if (dst->format->BitsPerPixel < 8) {
+        return SDL_SetError("SDL_FillRects(): Unsupported surface format");
+    }
+    if (!dst->pixels) {
+        return SDL_SetError("SDL_FillRects(): You must lock the surface");
+    }
+
+    sorted = (SDL_Rect *) SDL_malloc(2 * count * sizeof(*sorted));
+    if (!sorted) {
+        /* Do it the slow way */
+        for (i = 0; i < count; ++i) {
+            status += SDL_FillRect(dst, &rects[i], color);
+        }
+        return status;
+    }
+    active = sorted + count;
 
+    numrects = 0;
     for (i = 0; i < count; ++i) {
-        status += SDL_FillRect(dst, &rects[i], color);
+        if (SDL_IntersectRect(&rects[i], &dst->clip_rect, &sorted[numrects])) {
+            if (numrects == 0) {
+                bounds = sorted[0];
+            } else {
+                SDL_UnionRect(&bounds, &sorted[numrects], &bounds);
+            }
+            if (dst->flags & SDL_TRACKDIRTY) {
+                SDL_AddWindowSurfaceDirtyRect(dst, &sorted[numrects]);
+            }
+            ++numrects;
+        }
     }
-    return status;
+    if (numrects == 0) {
+        SDL_free(sorted);
+        return 0;
+    }
+    SDL_qsort(sorted, numrects, sizeof(*sorted), SDL_CompareFillRects);
+
+    /* Keep the RLE encoding of the surface up to date */
+    if (SDL_MUSTLOCK(dst)) {
+        if (SDL_LockSurfaceRect(dst, &bounds) < 0) {
+            SDL_free(sorted);
+            return -1;
+        }
+    }
+
+    bpp = dst->format->BytesPerPixel;
+    numactive = 0;
+    next = 0;
+    y = sorted[0].y;
+    while (next < numrects || numactive > 0) {
+        if (numactive == 0 && y < sorted[next].y) {
+            y = sorted[next].y;
+        }
+
+        /* Add the rectangles starting on this row, keeping them in x order */
+        while (next < numrects && sorted[next].y <= y) {
+            for (j = numactive; j > 0 && active[j - 1].x > sorted[next].x; --j) {
+                active[j] = active[j - 1];
+            }
+            active[j] = sorted[next++];
+            ++numactive;
+        }
+
+        /* The band ends where a rectangle starts or ends */
+        bottom = (next < numrects) ? sorted[next].y : bounds.y + bounds.h;
+        for (i = 0; i < numactive; ++i) {
+            bottom = SDL_min(bottom, active[i].y + active[i].h);
+        }
+
+        span.x = active[0].x;
+        span.w = active[0].w;
+        for (i = 1; i <= numactive; ++i) {
+            if (i < numactive && active[i].x <= span.x + span.w) {
+                span.w = SDL_max(span.w, active[i].x + active[i].w - span.x);
+                continue;
+            }
+            stream = ((size_t) span.w * (bottom - y) * bpp >=
+                      SDL_FILLRECT_STREAM_BYTES);
+            SDL_FillRectPixels(bpp, (Uint8 *) dst->pixels + y * dst->pitch +
+                               span.x * bpp, dst->pitch, color,
+                               span.w, bottom - y, stream);
+            if (i < numactive) {
+                span.x = active[i].x;
+                span.w = active[i].w;
+            }
+        }
+
+        /* Drop the rectangles that are finished */
+        y = bottom;
+        for (i = 0, j = 0; i < numactive; ++i) {
+            if (active[i].y + active[i].h > y) {
+                active[j++] = active[i];
+            }
+        }
+        numactive = j;
+    }
+
+    if (SDL_MUSTLOCK(dst)) {
+        SDL_UnlockSurface(dst);
+    }
+    SDL_free(sorted);
+
+    return 0;
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
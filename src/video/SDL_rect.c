@@ -521,4 +521,72 @@ SDL_GetSpanEnclosingRect(int width, int height,
     return SDL_FALSE;
 }
 
+/* The fixed cost of sending one more rectangle, in pixels. Two rectangles
+   are merged when their union adds no more unchanged pixels than this. */
+#define SDL_DIRTY_RECT_OVERHEAD 4096
+
+/* How many unchanged pixels more merging A and B would cost than keeping
+   them apart (negative if the union is cheaper) */
+static Sint64
+SDL_DirtyMergeCost(const SDL_Rect * A, const SDL_Rect * B)
+{
+    SDL_Rect u;
+
+    SDL_UnionRect(A, B, &u);
+    return (Sint64) u.w * u.h - (Sint64) A->w * A->h - (Sint64) B->w * B->h
+        - SDL_DIRTY_RECT_OVERHEAD;
+}
+
+void
+SDL_AddDirtyRect(SDL_DirtyRects * dirty, const SDL_Rect * rect)
+{
+    SDL_Rect r;
+    int i;
+
+    if (SDL_RectEmpty(rect)) {
+        return;
+    }
+
+    /* Fold the new rectangle into any it is cheaper to send together with,
+       including anything it overlaps or touches along a full edge */
+    r = *rect;
+    i = 0;
+    while (i < dirty->count) {
+        if (SDL_DirtyMergeCost(&dirty->rects[i], &r) <= 0) {
+            SDL_UnionRect(&dirty->rects[i], &r, &r);
+            dirty->rects[i] = dirty->rects[--dirty->count];
+            /* the bigger rectangle may now merge with earlier ones */
+            i = 0;
+        } else {
+            ++i;
+        }
+    }
+
+    /* Out of room, merge with whichever rectangle wastes the least */
+    if (dirty->count == SDL_MAX_DIRTY_RECTS) {
+        int best = 0;
+        Sint64 cost, best_cost = SDL_DirtyMergeCost(&dirty->rects[0], &r);
+
+        for (i = 1; i < dirty->count; ++i) {
+            cost = SDL_DirtyMergeCost(&dirty->rects[i], &r);
+            if (cost < best_cost) {
+                best = i;
+                best_cost = cost;
+            }
+        }
+        SDL_UnionRect(&dirty->rects[best], &r, &r);
+        dirty->rects[best] = dirty->rects[--dirty->count];
+        SDL_AddDirtyRect(dirty, &r);
+        return;
+    }
+
+    dirty->rects[dirty->count++] = r;
+}
+
+void
+SDL_ClearDirtyRects(SDL_DirtyRects * dirty)
+{
+    dirty->count = 0;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -20,6 +20,24 @@
 */
 #include "SDL_config.h"
 
+#ifndef _SDL_rect_c_h
+#define _SDL_rect_c_h
+
 extern SDL_bool SDL_GetSpanEnclosingRect(int width, int height, int numrects, const SDL_Rect * rects, SDL_Rect *span);
 
+/* The most rectangles a dirty list holds before it merges harder */
+#define SDL_MAX_DIRTY_RECTS 32
+
+/* A list of changed areas, merged as they are added */
+typedef struct SDL_DirtyRects
+{
+    int count;
+    SDL_Rect rects[SDL_MAX_DIRTY_RECTS];
+} SDL_DirtyRects;
+
+extern void SDL_AddDirtyRect(SDL_DirtyRects * dirty, const SDL_Rect * rect);
+extern void SDL_ClearDirtyRects(SDL_DirtyRects * dirty);
+
+#endif /* _SDL_rect_c_h */
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -255,7 +255,7 @@ SDL_SoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
     /* Lock the destination if it's in hardware */
     dst_locked = 0;
     if (SDL_MUSTLOCK(dst)) {
-        if (SDL_LockSurface(dst) < 0) {
+        if (SDL_LockSurfaceRect(dst, dstrect) < 0) {
             return SDL_SetError("Unable to lock destination surface");
         }
         dst_locked = 1;
@@ -24,6 +24,7 @@
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
+#include "SDL_blit_swizzle.h"
 #include "SDL_pixels_c.h"
 
 
@@ -511,6 +512,9 @@ SDL_LowerBlit(SDL_Surface * src, SDL_Rect * srcrect,
 /*              src, dst->flags, src->map->info.flags, dst, dst->flags, */
 /*              dst->map->info.flags, src->map->blit); */
     }
+    if (dst->flags & SDL_TRACKDIRTY) {
+        SDL_AddWindowSurfaceDirtyRect(dst, dstrect);
+    }
     return (src->map->blit(src, srcrect, dst, dstrect));
 }
 
@@ -530,6 +534,9 @@ SDL_UpperBlit(SDL_Surface * src, const SDL_Rect * srcrect,
         return SDL_SetError("Surfaces must not be locked during blit");
     }
 
+    /* Switch back to a fast blit if we were previously stretching */
+    SDL_SetBlitNearest(src, SDL_FALSE);
+
     /* If the destination rectangle is NULL, use the entire dest surface */
     if (dstrect == NULL) {
         fulldst.x = fulldst.y = 0;
@@ -747,11 +754,14 @@ SDL_LowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
         return 0;
     }
 
-    src->map->info.flags |= SDL_COPY_NEAREST;
+    SDL_SetBlitNearest(src, SDL_TRUE);
 
     if ( !(src->map->info.flags & complex_copy_flags) &&
          src->format->format == dst->format->format &&
          !SDL_ISPIXELFORMAT_INDEXED(src->format->format) ) {
+        if (dst->flags & SDL_TRACKDIRTY) {
+            SDL_AddWindowSurfaceDirtyRect(dst, &final_dst);
+        }
         return SDL_SoftStretch( src, &final_src, dst, &final_dst );
     } else {
         return SDL_LowerBlit( src, &final_src, dst, &final_dst );
@@ -764,12 +774,23 @@ SDL_LowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
 int
 SDL_LockSurface(SDL_Surface * surface)
 {
-    if (!surface->locked) {
-        /* Perform the lock */
-        if (surface->flags & SDL_RLEACCEL) {
-            SDL_UnRLESurface(surface, 1);
-            surface->flags |= SDL_RLEACCEL;     /* save accel'd state */
-        }
+    return SDL_LockSurfaceRect(surface, NULL);
+}
+
+/*
+ * Lock a surface to change the pixels in an area of it
+ */
+int
+SDL_LockSurfaceRect(SDL_Surface * surface, const SDL_Rect * rect)
+{
+    /* The RLE encoding of the changed lines is redone on unlock */
+    if (surface->flags & SDL_RLEACCEL) {
+        SDL_InvalidateRLESurface(surface, rect);
+    }
+
+    /* Pixels written through the lock are sent on the next window update */
+    if (surface->flags & SDL_TRACKDIRTY) {
+        SDL_AddWindowSurfaceDirtyRect(surface, rect);
     }
 
     /* Increment the surface lock count, for recursive locks */
@@ -1028,6 +1049,12 @@ int SDL_ConvertPixels(int width, int height,
         return 0;
     }
 
+    /* Fast path for swizzles between common RGB formats */
+    if (SDL_SwizzlePixels(width, height, src_format, src, src_pitch,
+                          dst_format, dst, dst_pitch)) {
+        return 0;
+    }
+
     if (!SDL_CreateSurfaceOnStack(width, height, src_format, nonconst_src,
                                   src_pitch,
                                   &src_surface, &src_fmt, &src_blitmap)) {
@@ -26,6 +26,7 @@
 #include "SDL_messagebox.h"
 #include "SDL_shape.h"
 #include "SDL_thread.h"
+#include "SDL_rect_c.h"
 
 /* The SDL video driver */
 
@@ -91,6 +92,7 @@ struct SDL_Window
 
     SDL_Surface *surface;
     SDL_bool surface_valid;
+    SDL_DirtyRects dirty;       /* regions of the surface changed since the last update */
 
     SDL_WindowShaper *shaper;
 
@@ -379,6 +381,7 @@ extern int SDL_RecreateWindow(SDL_Window * window, Uint32 flags);
 extern void SDL_OnWindowShown(SDL_Window * window);
 extern void SDL_OnWindowHidden(SDL_Window * window);
 extern void SDL_OnWindowResized(SDL_Window * window);
+extern void SDL_OnWindowExposed(SDL_Window * window);
 extern void SDL_OnWindowMinimized(SDL_Window * window);
 extern void SDL_OnWindowRestored(SDL_Window * window);
 extern void SDL_OnWindowEnter(SDL_Window * window);
@@ -390,6 +393,8 @@ extern SDL_Window * SDL_GetFocusWindow(void);
 
 extern SDL_bool SDL_ShouldAllowTopmost(void);
 
+extern void SDL_AddWindowSurfaceDirtyRect(SDL_Surface * surface, const SDL_Rect * rect);
+
 #endif /* _SDL_sysvideo_h */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -1827,6 +1827,16 @@ SDL_SetWindowFullscreen(SDL_Window * window, Uint32 flags)
     return 0;
 }
 
+static SDL_bool
+ShouldTrackDirtyRects(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_FRAMEBUFFER_DIRTY_RECTS);
+    if (hint && *hint != '0') {
+        return SDL_TRUE;
+    }
+    return SDL_FALSE;
+}
+
 static SDL_Surface *
 SDL_CreateWindowFramebuffer(SDL_Window * window)
 {
@@ -1865,11 +1875,47 @@ SDL_GetWindowSurface(SDL_Window * window)
         if (window->surface) {
             window->surface_valid = SDL_TRUE;
             window->surface->flags |= SDL_DONTFREE;
+            if (ShouldTrackDirtyRects()) {
+                /* The new framebuffer hasn't been shown yet, start fully dirty */
+                window->surface->flags |= SDL_TRACKDIRTY;
+                SDL_ClearDirtyRects(&window->dirty);
+                SDL_AddWindowSurfaceDirtyRect(window->surface, NULL);
+            }
         }
     }
     return window->surface;
 }
 
+void
+SDL_AddWindowSurfaceDirtyRect(SDL_Surface * surface, const SDL_Rect * rect)
+{
+    SDL_Window *window;
+    SDL_Rect full_rect, clipped;
+
+    if (!_this || !surface || !(surface->flags & SDL_TRACKDIRTY)) {
+        return;
+    }
+
+    for (window = _this->windows; window; window = window->next) {
+        if (window->surface == surface) {
+            break;
+        }
+    }
+    if (!window) {
+        return;
+    }
+
+    full_rect.x = 0;
+    full_rect.y = 0;
+    full_rect.w = surface->w;
+    full_rect.h = surface->h;
+    if (!rect) {
+        SDL_AddDirtyRect(&window->dirty, &full_rect);
+    } else if (SDL_IntersectRect(rect, &full_rect, &clipped)) {
+        SDL_AddDirtyRect(&window->dirty, &clipped);
+    }
+}
+
 int
 SDL_UpdateWindowSurface(SDL_Window * window)
 {
@@ -1877,6 +1923,16 @@ SDL_UpdateWindowSurface(SDL_Window * window)
 
     CHECK_WINDOW_MAGIC(window, -1);
 
+    if (window->surface_valid && (window->surface->flags & SDL_TRACKDIRTY)) {
+        SDL_DirtyRects dirty = window->dirty;
+
+        if (dirty.count == 0) {
+            return 0;
+        }
+        SDL_ClearDirtyRects(&window->dirty);
+        return _this->UpdateWindowFramebuffer(_this, window, dirty.rects, dirty.count);
+    }
+
     full_rect.x = 0;
     full_rect.y = 0;
     full_rect.w = window->w;
@@ -1888,13 +1944,51 @@ int
 SDL_UpdateWindowSurfaceRects(SDL_Window * window, const SDL_Rect * rects,
                              int numrects)
 {
+    SDL_DirtyRects merged;
+    SDL_Rect full_rect, clipped;
+    int i;
+
     CHECK_WINDOW_MAGIC(window, -1);
 
     if (!window->surface_valid) {
         return SDL_SetError("Window surface is invalid, please call SDL_GetWindowSurface() to get a new surface");
     }
 
-    return _this->UpdateWindowFramebuffer(_this, window, rects, numrects);
+    /* Overlapping and neighbouring rectangles are cheaper to send together */
+    full_rect.x = 0;
+    full_rect.y = 0;
+    full_rect.w = window->w;
+    full_rect.h = window->h;
+    SDL_ClearDirtyRects(&merged);
+    for (i = 0; i < numrects; ++i) {
+        if (SDL_IntersectRect(&rects[i], &full_rect, &clipped)) {
+            SDL_AddDirtyRect(&merged, &clipped);
+        }
+    }
+    if (merged.count == 0) {
+        return 0;
+    }
+
+    return _this->UpdateWindowFramebuffer(_this, window, merged.rects, merged.count);
+}
+
+int
+SDL_GetWindowSurfaceDirtyRects(SDL_Window * window, SDL_Rect * rects,
+                               int maxrects)
+{
+    int i;
+
+    CHECK_WINDOW_MAGIC(window, -1);
+
+    if (!window->surface_valid || !(window->surface->flags & SDL_TRACKDIRTY)) {
+        return SDL_SetError("Window surface isn't tracking modified regions");
+    }
+    if (rects) {
+        for (i = 0; i < window->dirty.count && i < maxrects; ++i) {
+            rects[i] = window->dirty.rects[i];
+        }
+    }
+    return window->dirty.count;
 }
 
 int
@@ -2057,6 +2151,15 @@ SDL_OnWindowResized(SDL_Window * window)
     SDL_SendWindowEvent(window, SDL_WINDOWEVENT_SIZE_CHANGED, window->w, window->h);
 }
 
+void
+SDL_OnWindowExposed(SDL_Window * window)
+{
+    /* The window contents are gone, the next update has to send them all */
+    if (window->surface_valid) {
+        SDL_AddWindowSurfaceDirtyRect(window->surface, NULL);
+    }
+}
+
 void
 SDL_OnWindowMinimized(SDL_Window * window)
 {
@@ -2066,6 +2169,7 @@ SDL_OnWindowMinimized(SDL_Window * window)
 void
 SDL_OnWindowRestored(SDL_Window * window)
 {
+    SDL_OnWindowExposed(window);
     SDL_RaiseWindow(window);
 
     if (FULLSCREEN_VISIBLE(window)) {
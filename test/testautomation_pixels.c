@@ -496,6 +496,106 @@ pixels_calcGammaRamp(void *arg)
   return TEST_COMPLETED;
 }
 
+/* Formats with a direct SDL_ConvertPixels path */
+static const Uint32 _convertPixelFormats[] =
+  {
+    SDL_PIXELFORMAT_RGB565,
+    SDL_PIXELFORMAT_BGR565,
+    SDL_PIXELFORMAT_RGB24,
+    SDL_PIXELFORMAT_BGR24,
+    SDL_PIXELFORMAT_RGB888,
+    SDL_PIXELFORMAT_RGBX8888,
+    SDL_PIXELFORMAT_BGR888,
+    SDL_PIXELFORMAT_BGRX8888,
+    SDL_PIXELFORMAT_ARGB8888,
+    SDL_PIXELFORMAT_RGBA8888,
+    SDL_PIXELFORMAT_ABGR8888,
+    SDL_PIXELFORMAT_BGRA8888
+  };
+
+/**
+ * @brief Compare SDL_ConvertPixels against a surface blit for all common RGB format pairs
+ *
+ * @sa http://wiki.libsdl.org/moin.fcg/SDL_ConvertPixels
+ */
+int
+pixels_convertPixels(void *arg)
+{
+  const int numFormats = SDL_arraysize(_convertPixelFormats);
+  const int width = 37;
+  const int height = 5;
+  SDL_Surface *src;
+  SDL_Surface *ref;
+  Uint8 *dst;
+  Uint32 srcFormat, dstFormat;
+  Uint32 Rmask, Gmask, Bmask, Amask;
+  int bpp, srcIndex, dstIndex, x, y, result, mismatches;
+
+  dst = (Uint8 *)SDL_malloc(width * height * 4);
+  SDLTest_AssertCheck(dst != NULL, "Validate destination buffer could be allocated");
+  if (dst == NULL) return TEST_ABORTED;
+
+  for (srcIndex = 0; srcIndex < numFormats; srcIndex++) {
+    srcFormat = _convertPixelFormats[srcIndex];
+    SDL_PixelFormatEnumToMasks(srcFormat, &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+    src = SDL_CreateRGBSurface(0, width, height, bpp, Rmask, Gmask, Bmask, Amask);
+    SDLTest_AssertCheck(src != NULL, "Verify source surface is not NULL");
+    if (src == NULL) continue;
+    for (y = 0; y < height; y++) {
+      for (x = 0; x < src->pitch; x++) {
+        ((Uint8 *)src->pixels)[y * src->pitch + x] = (Uint8)SDLTest_RandomUint8();
+      }
+    }
+
+    for (dstIndex = 0; dstIndex < numFormats; dstIndex++) {
+      dstFormat = _convertPixelFormats[dstIndex];
+      if (dstFormat == srcFormat) continue;
+
+      ref = SDL_ConvertSurfaceFormat(src, dstFormat, 0);
+      SDLTest_AssertCheck(ref != NULL, "Verify reference surface is not NULL");
+      if (ref == NULL) continue;
+
+      result = SDL_ConvertPixels(width, height, srcFormat, src->pixels, src->pitch,
+                                 dstFormat, dst, width * ref->format->BytesPerPixel);
+      SDLTest_AssertCheck(result == 0, "Call to SDL_ConvertPixels(%s, %s), expected: 0, got: %i",
+                          SDL_GetPixelFormatName(srcFormat), SDL_GetPixelFormatName(dstFormat), result);
+
+      /* Padding bits are undefined, so compare the channels.  The RGB565
+         to 32-bit blitters expand with a lookup table that truncates, so
+         16-bit sources are checked against SDL_GetRGBA() of the source. */
+      mismatches = 0;
+      for (y = 0; y < height; y++) {
+        for (x = 0; x < width; x++) {
+          Uint32 expected = 0, actual = 0;
+          Uint8 er, eg, eb, ea, ar, ag, ab, aa;
+          const Uint8 *e = (Uint8 *)ref->pixels + y * ref->pitch + x * ref->format->BytesPerPixel;
+          const Uint8 *a = dst + (y * width + x) * ref->format->BytesPerPixel;
+          SDL_memcpy(&expected, e, ref->format->BytesPerPixel);
+          SDL_memcpy(&actual, a, ref->format->BytesPerPixel);
+          SDL_GetRGBA(expected, ref->format, &er, &eg, &eb, &ea);
+          if (bpp == 16 && ref->format->BytesPerPixel != 2) {
+            Uint16 pixel = ((Uint16 *)((Uint8 *)src->pixels + y * src->pitch))[x];
+            SDL_GetRGBA(pixel, src->format, &er, &eg, &eb, &ea);
+          }
+          SDL_GetRGBA(actual, ref->format, &ar, &ag, &ab, &aa);
+          if (er != ar || eg != ag || eb != ab || ea != aa) {
+            mismatches++;
+          }
+        }
+      }
+      SDLTest_AssertCheck(mismatches == 0, "Validate converted pixels %s -> %s, expected: 0 mismatches, got: %i",
+                          SDL_GetPixelFormatName(srcFormat), SDL_GetPixelFormatName(dstFormat), mismatches);
+
+      SDL_FreeSurface(ref);
+    }
+    SDL_FreeSurface(src);
+  }
+
+  SDL_free(dst);
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Pixels test cases */
@@ -511,9 +611,12 @@ static const SDLTest_TestCaseReference pixelsTest3 =
 static const SDLTest_TestCaseReference pixelsTest4 =
         { (SDLTest_TestCaseFp)pixels_getPixelFormatName, "pixels_getPixelFormatName", "Call to SDL_GetPixelFormatName", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference pixelsTest5 =
+        { (SDLTest_TestCaseFp)pixels_convertPixels, "pixels_convertPixels", "Compare SDL_ConvertPixels against SDL_ConvertSurfaceFormat", TEST_ENABLED };
+
 /* Sequence of Pixels test cases */
 static const SDLTest_TestCaseReference *pixelsTests[] =  {
-    &pixelsTest1, &pixelsTest2, &pixelsTest3, &pixelsTest4, NULL
+    &pixelsTest1, &pixelsTest2, &pixelsTest3, &pixelsTest4, &pixelsTest5, NULL
 };
 
 /* Pixels test suite (global) */
@@ -1010,6 +1010,1873 @@ _clearScreen(void)
    return 0;
 }
 
+/**
+ * @brief Draws a scene with copies, fills and a target change. Helper function.
+ */
+static void
+_drawBatchScene(SDL_Renderer *sw, SDL_Texture *tsprite, SDL_Texture *ttarget)
+{
+   SDL_Rect rect;
+   int i;
+
+   SDL_SetRenderDrawColor(sw, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(sw);
+
+   /* Runs of fills, broken up by color changes */
+   for (i = 0; i < 16; i++) {
+      rect.x = i * 4;
+      rect.y = i * 2;
+      rect.w = 12;
+      rect.h = 9;
+      SDL_SetRenderDrawColor(sw, (Uint8)(i * 16), 128, (Uint8)(255 - i * 16), SDL_ALPHA_OPAQUE);
+      SDL_RenderFillRect(sw, &rect);
+      SDL_RenderFillRect(sw, &rect);
+   }
+
+   /* Runs of copies, broken up by texture state changes */
+   SDL_SetTextureBlendMode(tsprite, SDL_BLENDMODE_BLEND);
+   for (i = 0; i < 32; i++) {
+      rect.x = (i * 7) % 56;
+      rect.y = (i * 5) % 40;
+      rect.w = 8 + (i % 3) * 4;
+      rect.h = 8;
+      if ((i % 8) == 0) {
+         SDL_SetTextureColorMod(tsprite, (Uint8)(255 - i * 4), (Uint8)(i * 8), 200);
+         SDL_SetTextureAlphaMod(tsprite, (Uint8)(128 + i * 4));
+      }
+      SDL_RenderCopy(sw, tsprite, NULL, &rect);
+   }
+
+   /* Draw into a target, then copy the target back out */
+   if (ttarget != NULL) {
+      SDL_SetRenderTarget(sw, ttarget);
+      SDL_SetRenderDrawColor(sw, 255, 255, 0, SDL_ALPHA_OPAQUE);
+      SDL_RenderClear(sw);
+      SDL_RenderCopy(sw, tsprite, NULL, NULL);
+      SDL_SetRenderTarget(sw, NULL);
+      rect.x = 40;
+      rect.y = 30;
+      rect.w = 16;
+      rect.h = 16;
+      SDL_RenderCopy(sw, ttarget, NULL, &rect);
+   }
+
+   /* Finish with fills in a blend mode */
+   SDL_SetRenderDrawBlendMode(sw, SDL_BLENDMODE_BLEND);
+   SDL_SetRenderDrawColor(sw, 0, 255, 0, 100);
+   for (i = 0; i < 8; i++) {
+      rect.x = i * 8;
+      rect.y = 0;
+      rect.w = 6;
+      rect.h = 64;
+      SDL_RenderFillRect(sw, &rect);
+   }
+   SDL_SetRenderDrawBlendMode(sw, SDL_BLENDMODE_NONE);
+}
+
+/**
+ * @brief Checks that batched rendering matches immediate rendering.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderFlush
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderReadPixels
+ */
+int
+render_testBatching(void *arg)
+{
+   SDL_Surface *surfaces[2];
+   SDL_Surface *spriteSurface;
+   SDL_Renderer *sw;
+   SDL_Texture *tsprite, *ttarget;
+   Uint32 *readback;
+   Uint32 pixel;
+   int i, ret;
+
+   spriteSurface = SDL_CreateRGBSurface(0, 8, 8, 32,
+                                        RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                        RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   SDLTest_AssertCheck(spriteSurface != NULL, "Verify sprite surface is not NULL");
+   if (spriteSurface == NULL) {
+      return TEST_ABORTED;
+   }
+   for (i = 0; i < 8 * 8; i++) {
+      ((Uint32 *)spriteSurface->pixels)[i] = 0x80000000 | (i * 0x030507);
+   }
+
+   /* Draw the same scene with batching off and on */
+   for (i = 0; i < 2; i++) {
+      SDL_SetHint(SDL_HINT_RENDER_BATCHING, i ? "1" : "0");
+      surfaces[i] = SDL_CreateRGBSurface(0, 64, 64, 32,
+                                         RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                         RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+      SDLTest_AssertCheck(surfaces[i] != NULL, "Verify destination surface is not NULL");
+      if (surfaces[i] == NULL) {
+         return TEST_ABORTED;
+      }
+      sw = SDL_CreateSoftwareRenderer(surfaces[i]);
+      SDLTest_AssertCheck(sw != NULL, "Verify SDL_CreateSoftwareRenderer result is not NULL");
+      if (sw == NULL) {
+         return TEST_ABORTED;
+      }
+      tsprite = SDL_CreateTextureFromSurface(sw, spriteSurface);
+      SDLTest_AssertCheck(tsprite != NULL, "Verify sprite texture is not NULL");
+      ttarget = SDL_CreateTexture(sw, RENDER_COMPARE_FORMAT, SDL_TEXTUREACCESS_TARGET, 8, 8);
+
+      _drawBatchScene(sw, tsprite, ttarget);
+
+      if (i == 1) {
+         /* Reading back flushes the batched commands */
+         readback = (Uint32 *)SDL_malloc(64 * 64 * 4);
+         SDLTest_AssertCheck(readback != NULL, "Validate allocated readback buffer");
+         if (readback != NULL) {
+            ret = SDL_RenderReadPixels(sw, NULL, RENDER_COMPARE_FORMAT, readback, 64 * 4);
+            SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+            ret = SDL_memcmp(readback, surfaces[0]->pixels, 64 * 64 * 4);
+            SDLTest_AssertCheck(ret == 0, "Verify batched rendering matches immediate rendering");
+            SDL_free(readback);
+         }
+
+         /* A fill is only drawn once it is flushed */
+         SDL_SetRenderDrawColor(sw, 1, 2, 3, SDL_ALPHA_OPAQUE);
+         SDL_RenderFillRect(sw, NULL);
+         pixel = *(Uint32 *)surfaces[i]->pixels;
+         SDLTest_AssertCheck(pixel != 0xff010203, "Verify fill is deferred, got 0x%.8x", pixel);
+         ret = SDL_RenderFlush(sw);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderFlush, expected: 0, got: %i", ret);
+         pixel = *(Uint32 *)surfaces[i]->pixels;
+         SDLTest_AssertCheck(pixel == 0xff010203, "Verify fill is drawn after SDL_RenderFlush, expected 0xff010203, got 0x%.8x", pixel);
+      }
+
+      SDL_DestroyRenderer(sw);
+   }
+   SDL_SetHint(SDL_HINT_RENDER_BATCHING, "");
+
+   /* Surface renderers draw immediately unless batching is asked for */
+   sw = SDL_CreateSoftwareRenderer(surfaces[0]);
+   SDLTest_AssertCheck(sw != NULL, "Verify SDL_CreateSoftwareRenderer result is not NULL");
+   if (sw != NULL) {
+      SDL_SetRenderDrawColor(sw, 4, 5, 6, SDL_ALPHA_OPAQUE);
+      SDL_RenderFillRect(sw, NULL);
+      pixel = *(Uint32 *)surfaces[0]->pixels;
+      SDLTest_AssertCheck(pixel == 0xff040506, "Verify fill is drawn by default, expected 0xff040506, got 0x%.8x", pixel);
+      SDL_DestroyRenderer(sw);
+   }
+
+   SDL_FreeSurface(spriteSurface);
+   SDL_FreeSurface(surfaces[0]);
+   SDL_FreeSurface(surfaces[1]);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Checks that SDL_RenderCopyMany matches drawing each copy separately.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderCopyMany
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderCopyEx
+ */
+int
+render_testCopyMany(void *arg)
+{
+   SDL_RenderCopyData copies[48];
+   SDL_Surface *surfaces[2];
+   SDL_Surface *spriteSurface;
+   SDL_Renderer *sw;
+   SDL_Texture *tsprite;
+   Uint8 r, g, b, a;
+   int i, j, ret;
+
+   spriteSurface = SDL_CreateRGBSurface(0, 8, 8, 32,
+                                        RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                        RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   SDLTest_AssertCheck(spriteSurface != NULL, "Verify sprite surface is not NULL");
+   if (spriteSurface == NULL) {
+      return TEST_ABORTED;
+   }
+   for (i = 0; i < 8 * 8; i++) {
+      ((Uint32 *)spriteSurface->pixels)[i] = 0x80000000 | (i * 0x030507);
+   }
+
+   /* Plain, scaled, clipped, rotated and flipped copies with changing modulation */
+   SDL_zero(copies);
+   for (i = 0; i < SDL_arraysize(copies); i++) {
+      if (i % 4) {
+         copies[i].srcrect.x = i % 4;
+         copies[i].srcrect.y = i % 3;
+         copies[i].srcrect.w = 4;
+         copies[i].srcrect.h = 5;
+      }
+      copies[i].dstrect.x = (i * 7) % 72 - 8;
+      copies[i].dstrect.y = (i * 5) % 72 - 8;
+      copies[i].dstrect.w = 4 + (i % 3) * 4;
+      copies[i].dstrect.h = 8;
+      if ((i % 6) == 5) {
+         copies[i].angle = 30.0 * i;
+      }
+      copies[i].flip = (SDL_RendererFlip)((i / 8) % 4);
+      copies[i].r = (i < 16) ? 255 : (Uint8)(255 - i * 4);
+      copies[i].g = (i < 16) ? 255 : (Uint8)(i * 5);
+      copies[i].b = 200;
+      copies[i].a = (i < 32) ? 255 : (Uint8)(i * 4);
+   }
+
+   /* Draw the copies in one call and one at a time */
+   for (i = 0; i < 2; i++) {
+      surfaces[i] = SDL_CreateRGBSurface(0, 64, 64, 32,
+                                         RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                         RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+      SDLTest_AssertCheck(surfaces[i] != NULL, "Verify destination surface is not NULL");
+      if (surfaces[i] == NULL) {
+         return TEST_ABORTED;
+      }
+      sw = SDL_CreateSoftwareRenderer(surfaces[i]);
+      SDLTest_AssertCheck(sw != NULL, "Verify SDL_CreateSoftwareRenderer result is not NULL");
+      if (sw == NULL) {
+         return TEST_ABORTED;
+      }
+      tsprite = SDL_CreateTextureFromSurface(sw, spriteSurface);
+      SDLTest_AssertCheck(tsprite != NULL, "Verify sprite texture is not NULL");
+      SDL_SetTextureBlendMode(tsprite, SDL_BLENDMODE_BLEND);
+      SDL_SetTextureColorMod(tsprite, 10, 20, 30);
+      SDL_SetTextureAlphaMod(tsprite, 40);
+
+      if (i == 0) {
+         for (j = 0; j < SDL_arraysize(copies); j++) {
+            SDL_SetTextureColorMod(tsprite, copies[j].r, copies[j].g, copies[j].b);
+            SDL_SetTextureAlphaMod(tsprite, copies[j].a);
+            if (copies[j].angle != 0.0 || copies[j].flip != SDL_FLIP_NONE) {
+               SDL_RenderCopyEx(sw, tsprite,
+                                SDL_RectEmpty(&copies[j].srcrect) ? NULL : &copies[j].srcrect,
+                                &copies[j].dstrect, copies[j].angle, NULL, copies[j].flip);
+            } else {
+               SDL_RenderCopy(sw, tsprite,
+                              SDL_RectEmpty(&copies[j].srcrect) ? NULL : &copies[j].srcrect,
+                              &copies[j].dstrect);
+            }
+         }
+         SDL_RenderFlush(sw);
+      } else {
+         ret = SDL_RenderCopyMany(sw, tsprite, copies, SDL_arraysize(copies));
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyMany, expected: 0, got: %i", ret);
+         ret = SDL_memcmp(surfaces[1]->pixels, surfaces[0]->pixels, 64 * 64 * 4);
+         SDLTest_AssertCheck(ret == 0, "Verify SDL_RenderCopyMany matches separate copies");
+
+         /* The texture keeps its own modulation */
+         SDL_GetTextureColorMod(tsprite, &r, &g, &b);
+         SDL_GetTextureAlphaMod(tsprite, &a);
+         SDLTest_AssertCheck(r == 10 && g == 20 && b == 30 && a == 40,
+                             "Verify texture modulation is unchanged, expected: 10,20,30,40, got: %i,%i,%i,%i", r, g, b, a);
+
+         ret = SDL_RenderCopyMany(sw, tsprite, NULL, 1);
+         SDLTest_AssertCheck(ret == -1, "Validate result from SDL_RenderCopyMany with NULL copies, expected: -1, got: %i", ret);
+         ret = SDL_RenderCopyMany(sw, tsprite, copies, 0);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyMany with no copies, expected: 0, got: %i", ret);
+      }
+
+      SDL_DestroyRenderer(sw);
+   }
+
+   SDL_FreeSurface(spriteSurface);
+   SDL_FreeSurface(surfaces[0]);
+   SDL_FreeSurface(surfaces[1]);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Creates a surface with a distinct pattern for each seed. Helper function.
+ */
+static SDL_Surface *
+_createPatternSurface(int w, int h, int seed)
+{
+   SDL_Surface *surface;
+   int i;
+
+   surface = SDL_CreateRGBSurface(0, w, h, 32,
+                                  RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                  RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   if (surface != NULL) {
+      for (i = 0; i < w * h; i++) {
+         ((Uint32 *)surface->pixels)[i] = 0xC0000000 | ((i * 0x030507 + seed * 0x402010) & 0xFFFFFF);
+      }
+   }
+   return surface;
+}
+
+/**
+ * @brief Draws a grid of textures. Helper function.
+ */
+static void
+_drawTextureGrid(SDL_Renderer *sw, SDL_Texture **textures, int count)
+{
+   SDL_Rect rect;
+   int i;
+
+   SDL_SetRenderDrawColor(sw, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(sw);
+   for (i = 0; i < count; i++) {
+      if (textures[i] == NULL) {
+         continue;
+      }
+      SDL_QueryTexture(textures[i], NULL, NULL, &rect.w, &rect.h);
+      rect.x = (i % 6) * 10;
+      rect.y = (i / 6) * 10;
+      if (i % 5 == 4) {
+         SDL_RenderCopyEx(sw, textures[i], NULL, &rect, 90.0, NULL, SDL_FLIP_NONE);
+      } else {
+         SDL_RenderCopy(sw, textures[i], NULL, &rect);
+      }
+   }
+   SDL_RenderFlush(sw);
+}
+
+/**
+ * @brief Checks that atlas textures draw like ordinary textures and survive repacking.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_CreateTextureAtlas
+ * http://wiki.libsdl.org/moin.cgi/SDL_CreateAtlasTextureFromSurface
+ * http://wiki.libsdl.org/moin.cgi/SDL_DefragmentTextureAtlas
+ */
+int
+render_testTextureAtlas(void *arg)
+{
+   SDL_Surface *surfaces[2];
+   SDL_Surface *images[24];
+   SDL_Texture *plain[24];
+   SDL_Texture *packed[24];
+   SDL_Renderer *renderers[2];
+   SDL_TextureAtlas *atlas;
+   SDL_Surface *big;
+   SDL_Texture *texture;
+   Uint32 pixels[4];
+   Uint32 pixel;
+   int i, ret, pages;
+
+   for (i = 0; i < SDL_arraysize(images); i++) {
+      images[i] = _createPatternSurface(8 - (i % 3), 8 - (i % 2), i);
+      SDLTest_AssertCheck(images[i] != NULL, "Verify image surface is not NULL");
+      if (images[i] == NULL) {
+         return TEST_ABORTED;
+      }
+   }
+   for (i = 0; i < 2; i++) {
+      surfaces[i] = SDL_CreateRGBSurface(0, 64, 64, 32,
+                                         RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                         RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+      SDLTest_AssertCheck(surfaces[i] != NULL, "Verify destination surface is not NULL");
+      if (surfaces[i] == NULL) {
+         return TEST_ABORTED;
+      }
+      renderers[i] = SDL_CreateSoftwareRenderer(surfaces[i]);
+      SDLTest_AssertCheck(renderers[i] != NULL, "Verify SDL_CreateSoftwareRenderer result is not NULL");
+      if (renderers[i] == NULL) {
+         return TEST_ABORTED;
+      }
+   }
+
+   atlas = SDL_CreateTextureAtlas(renderers[1], 0, 32, 32);
+   SDLTest_AssertCheck(atlas != NULL, "Verify SDL_CreateTextureAtlas result is not NULL");
+   if (atlas == NULL) {
+      return TEST_ABORTED;
+   }
+   SDLTest_AssertCheck(SDL_GetTextureAtlasRenderer(atlas) == renderers[1],
+                       "Verify SDL_GetTextureAtlasRenderer result is the atlas renderer");
+   for (i = 0; i < SDL_arraysize(images); i++) {
+      plain[i] = SDL_CreateTextureFromSurface(renderers[0], images[i]);
+      packed[i] = SDL_CreateAtlasTextureFromSurface(atlas, images[i]);
+      SDLTest_AssertCheck(packed[i] != NULL, "Verify SDL_CreateAtlasTextureFromSurface result is not NULL");
+   }
+   pages = SDL_GetTextureAtlasPages(atlas);
+   SDLTest_AssertCheck(pages > 1, "Verify the atlas added pages, got: %i", pages);
+
+   /* Atlas textures draw exactly like separate textures */
+   _drawTextureGrid(renderers[0], plain, SDL_arraysize(plain));
+   _drawTextureGrid(renderers[1], packed, SDL_arraysize(packed));
+   ret = SDL_memcmp(surfaces[1]->pixels, surfaces[0]->pixels, 64 * 64 * 4);
+   SDLTest_AssertCheck(ret == 0, "Verify atlas textures match separate textures");
+
+   /* Free most of the images, then repack them into fewer pages */
+   for (i = 0; i < SDL_arraysize(images); i++) {
+      if (i % 4) {
+         SDL_DestroyTexture(plain[i]);
+         SDL_DestroyTexture(packed[i]);
+         plain[i] = packed[i] = NULL;
+      }
+   }
+   ret = SDL_DefragmentTextureAtlas(atlas);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_DefragmentTextureAtlas, expected: 0, got: %i", ret);
+   ret = SDL_GetTextureAtlasPages(atlas);
+   SDLTest_AssertCheck(ret == 1, "Verify repacking released pages, expected: 1, got: %i", ret);
+   _drawTextureGrid(renderers[0], plain, SDL_arraysize(plain));
+   _drawTextureGrid(renderers[1], packed, SDL_arraysize(packed));
+   ret = SDL_memcmp(surfaces[1]->pixels, surfaces[0]->pixels, 64 * 64 * 4);
+   SDLTest_AssertCheck(ret == 0, "Verify atlas textures match separate textures after repacking");
+
+   /* Updating an atlas texture only touches its own pixels */
+   SDL_SetTextureBlendMode(packed[0], SDL_BLENDMODE_NONE);
+   pixels[0] = pixels[1] = pixels[2] = pixels[3] = 0xff112233;
+   {
+      SDL_Rect rect = { 1, 1, 2, 2 };
+      ret = SDL_UpdateTexture(packed[0], &rect, pixels, 2 * 4);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+      rect.x = 7;
+      ret = SDL_UpdateTexture(packed[0], &rect, pixels, 2 * 4);
+      SDLTest_AssertCheck(ret == -1, "Validate result from SDL_UpdateTexture outside the texture, expected: -1, got: %i", ret);
+   }
+   _drawTextureGrid(renderers[1], packed, 1);
+   pixel = *(Uint32 *)((Uint8 *)surfaces[1]->pixels + surfaces[1]->pitch + 4);
+   SDLTest_AssertCheck(pixel == 0xff112233, "Verify updated pixel, expected: 0xff112233, got: 0x%.8x", pixel);
+   pixel = *(Uint32 *)surfaces[1]->pixels;
+   SDLTest_AssertCheck(pixel == *(Uint32 *)images[0]->pixels,
+                       "Verify pixel outside the update is unchanged, got: 0x%.8x", pixel);
+
+   /* Images larger than a page are refused */
+   big = _createPatternSurface(40, 8, 0);
+   texture = SDL_CreateAtlasTextureFromSurface(atlas, big);
+   SDLTest_AssertCheck(texture == NULL, "Verify an image larger than a page is refused");
+   SDL_FreeSurface(big);
+
+   /* Without any images left, repacking releases every page */
+   for (i = 0; i < SDL_arraysize(packed); i++) {
+      if (packed[i]) {
+         SDL_DestroyTexture(packed[i]);
+         packed[i] = NULL;
+      }
+   }
+   ret = SDL_DefragmentTextureAtlas(atlas);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_DefragmentTextureAtlas, expected: 0, got: %i", ret);
+   ret = SDL_GetTextureAtlasPages(atlas);
+   SDLTest_AssertCheck(ret == 0, "Verify repacking released all pages, expected: 0, got: %i", ret);
+
+   /* Destroying the renderer destroys the atlas images, but not the atlas */
+   SDL_DestroyRenderer(renderers[0]);
+   SDL_DestroyRenderer(renderers[1]);
+   ret = SDL_GetTextureAtlasPages(atlas);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_GetTextureAtlasPages after SDL_DestroyRenderer, expected: -1, got: %i", ret);
+   SDL_ClearError();
+   SDLTest_AssertCheck(SDL_GetTextureAtlasRenderer(atlas) == NULL,
+                       "Verify SDL_GetTextureAtlasRenderer result is NULL after SDL_DestroyRenderer");
+   SDLTest_AssertCheck(*SDL_GetError() == '\0', "Verify SDL_GetTextureAtlasRenderer doesn't set an error, got: '%s'", SDL_GetError());
+   texture = SDL_CreateAtlasTextureFromSurface(atlas, images[0]);
+   SDLTest_AssertCheck(texture == NULL, "Verify SDL_CreateAtlasTextureFromSurface fails after SDL_DestroyRenderer");
+   SDL_DestroyTextureAtlas(atlas);
+   for (i = 0; i < SDL_arraysize(images); i++) {
+      SDL_FreeSurface(images[i]);
+   }
+   SDL_FreeSurface(surfaces[0]);
+   SDL_FreeSurface(surfaces[1]);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Locks the whole of an RGB24 texture and fills it with a pattern. Helper function.
+ */
+static void
+_fillLockedTexture(SDL_Texture *texture, int seed)
+{
+   Uint8 *pixels;
+   int pitch, w, h, x, y;
+
+   SDL_QueryTexture(texture, NULL, NULL, &w, &h);
+   if (SDL_LockTexture(texture, NULL, (void **)&pixels, &pitch) < 0) {
+      return;
+   }
+   for (y = 0; y < h; y++) {
+      for (x = 0; x < w * 3; x++) {
+         pixels[y * pitch + x] = (Uint8)((x * 7 + y * 13) * seed);
+      }
+   }
+}
+
+/**
+ * @brief Draws a texture over the whole of a software renderer. Helper function.
+ */
+static void
+_drawTexture(SDL_Renderer *sw, SDL_Texture *texture)
+{
+   SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+   SDL_RenderCopy(sw, texture, NULL, NULL);
+   SDL_RenderFlush(sw);
+}
+
+typedef struct
+{
+   SDL_Texture *texture;
+   int frames;
+   SDL_atomic_t done;
+} _StreamState;
+
+/**
+ * @brief Writes numbered frames into a texture's streaming buffers. Helper thread.
+ */
+static int
+_streamFrames(void *data)
+{
+   _StreamState *state = (_StreamState *)data;
+   Uint32 *pixels;
+   int frame, pitch, i;
+
+   for (frame = 1; frame <= state->frames; frame++) {
+      if (SDL_LockTextureBuffer(state->texture, (void **)&pixels, &pitch) < 0) {
+         break;
+      }
+      for (i = 0; i < 8 * 8; i++) {
+         pixels[i] = 0xff000000 | frame;
+      }
+      SDL_UnlockTextureBuffer(state->texture);
+   }
+   SDL_AtomicSet(&state->done, 1);
+   return 0;
+}
+
+/**
+ * @brief Checks partial texture uploads and frames written from another thread.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_UnlockTextureRects
+ * http://wiki.libsdl.org/moin.cgi/SDL_SetTextureStreamingBuffers
+ * http://wiki.libsdl.org/moin.cgi/SDL_LockTextureBuffer
+ */
+int
+render_testStreamingTexture(void *arg)
+{
+   const SDL_Rect rects[2] = { { 2, 3, 4, 5 }, { 10, 10, 20, 20 } };
+   SDL_Surface *surface;
+   SDL_Renderer *sw;
+   SDL_Texture *texture, *reference, *frames;
+   SDL_Thread *thread;
+   _StreamState state;
+   Uint32 before[16 * 16], after[16 * 16];
+   Uint32 *pixels;
+   Uint32 pixel, last;
+   SDL_Point point;
+   int i, ret, pitch, uniform, mismatches;
+
+   surface = SDL_CreateRGBSurface(0, 16, 16, 32,
+                                  RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                  RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   SDLTest_AssertCheck(surface != NULL, "Verify destination surface is not NULL");
+   if (surface == NULL) {
+      return TEST_ABORTED;
+   }
+   sw = SDL_CreateSoftwareRenderer(surface);
+   SDLTest_AssertCheck(sw != NULL, "Verify SDL_CreateSoftwareRenderer result is not NULL");
+   if (sw == NULL) {
+      return TEST_ABORTED;
+   }
+
+   /* RGB24 isn't a software renderer format, so unlocking converts it */
+   texture = SDL_CreateTexture(sw, SDL_PIXELFORMAT_RGB24, SDL_TEXTUREACCESS_STREAMING, 16, 16);
+   reference = SDL_CreateTexture(sw, SDL_PIXELFORMAT_RGB24, SDL_TEXTUREACCESS_STREAMING, 16, 16);
+   SDLTest_AssertCheck(texture != NULL && reference != NULL, "Verify SDL_CreateTexture results are not NULL");
+   if (texture == NULL || reference == NULL) {
+      return TEST_ABORTED;
+   }
+   _fillLockedTexture(reference, 2);
+   SDL_UnlockTexture(reference);
+   _drawTexture(sw, reference);
+   SDL_memcpy(after, surface->pixels, sizeof(after));
+   _fillLockedTexture(texture, 1);
+   SDL_UnlockTexture(texture);
+   _drawTexture(sw, texture);
+   SDL_memcpy(before, surface->pixels, sizeof(before));
+
+   /* Only the rectangles passed to SDL_UnlockTextureRects() are uploaded */
+   _fillLockedTexture(texture, 2);
+   SDL_UnlockTextureRects(texture, rects, SDL_arraysize(rects));
+   _drawTexture(sw, texture);
+   mismatches = 0;
+   for (i = 0; i < 16 * 16; i++) {
+      point.x = i % 16;
+      point.y = i / 16;
+      pixel = ((Uint32 *)surface->pixels)[i];
+      if (SDL_EnclosePoints(&point, 1, &rects[0], NULL) ||
+          SDL_EnclosePoints(&point, 1, &rects[1], NULL)) {
+         mismatches += (pixel != after[i]);
+      } else {
+         mismatches += (pixel != before[i]);
+      }
+   }
+   SDLTest_AssertCheck(mismatches == 0, "Verify only the dirty rectangles changed, expected: 0 mismatches, got: %i", mismatches);
+
+   /* No rectangles, no upload */
+   SDL_memcpy(before, surface->pixels, sizeof(before));
+   _fillLockedTexture(texture, 3);
+   SDL_UnlockTextureRects(texture, rects, 0);
+   _drawTexture(sw, texture);
+   ret = SDL_memcmp(surface->pixels, before, sizeof(before));
+   SDLTest_AssertCheck(ret == 0, "Verify unlocking with no rectangles changed nothing");
+
+   /* Frame buffers need a streaming texture and at least two buffers */
+   ret = SDL_SetTextureStreamingBuffers(texture, 1);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_SetTextureStreamingBuffers with one buffer, expected: -1, got: %i", ret);
+   frames = SDL_CreateTexture(sw, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 8, 8);
+   ret = SDL_SetTextureStreamingBuffers(frames, 2);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_SetTextureStreamingBuffers on a static texture, expected: -1, got: %i", ret);
+   SDL_DestroyTexture(frames);
+   frames = SDL_CreateTexture(sw, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, 8, 8);
+   ret = SDL_SetTextureStreamingBuffers(frames, 2);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetTextureStreamingBuffers, expected: 0, got: %i", ret);
+
+   /* The newest finished frame is the one drawn */
+   for (i = 0; i < 3; i++) {
+      ret = SDL_LockTextureBuffer(frames, (void **)&pixels, &pitch);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_LockTextureBuffer, expected: 0, got: %i", ret);
+      if (ret == 0) {
+         SDL_memset4(pixels, 0xff000010 + i, 8 * 8);
+         SDL_UnlockTextureBuffer(frames);
+      }
+   }
+   _drawTexture(sw, frames);
+   pixel = *(Uint32 *)surface->pixels;
+   SDLTest_AssertCheck(pixel == 0xff000012, "Verify the newest frame was drawn, expected: 0xff000012, got: 0x%.8x", pixel);
+
+   ret = SDL_LockTextureBuffer(frames, (void **)&pixels, &pitch);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_LockTextureBuffer, expected: 0, got: %i", ret);
+   ret = SDL_LockTextureBuffer(frames, (void **)&pixels, &pitch);
+   SDLTest_AssertCheck(ret == -1, "Validate result from a second SDL_LockTextureBuffer, expected: -1, got: %i", ret);
+   SDL_UnlockTextureBuffer(frames);
+
+   /* Frames written by another thread are never drawn torn or out of order */
+   state.texture = frames;
+   state.frames = 500;
+   SDL_AtomicSet(&state.done, 0);
+   ret = SDL_SetTextureStreamingBuffers(frames, 3);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetTextureStreamingBuffers, expected: 0, got: %i", ret);
+   thread = SDL_CreateThread(_streamFrames, "StreamFrames", &state);
+   SDLTest_AssertCheck(thread != NULL, "Verify SDL_CreateThread result is not NULL");
+   if (thread == NULL) {
+      return TEST_ABORTED;
+   }
+   last = 0xff000000;
+   uniform = 1;
+   mismatches = 0;
+   do {
+      ret = SDL_AtomicGet(&state.done);
+      _drawTexture(sw, frames);
+      pixel = *(Uint32 *)surface->pixels;
+      for (i = 0; i < 8 * 8; i++) {
+         if (((Uint32 *)surface->pixels)[(i / 8) * 16 + (i % 8)] != pixel) {
+            uniform = 0;
+         }
+      }
+      if (pixel < last) {
+         mismatches++;
+      }
+      last = pixel;
+   } while (!ret);
+   SDL_WaitThread(thread, NULL);
+   SDLTest_AssertCheck(uniform, "Verify every drawn frame was a single frame");
+   SDLTest_AssertCheck(mismatches == 0, "Verify frames were drawn in order, got: %i out of order", mismatches);
+   SDLTest_AssertCheck(last == (0xff000000 | state.frames), "Verify the last frame was drawn, expected: 0x%.8x, got: 0x%.8x", 0xff000000 | state.frames, last);
+
+   /* Planar YUV frames of odd size have room for the rounded up chroma planes */
+   SDL_DestroyTexture(frames);
+   frames = SDL_CreateTexture(sw, SDL_PIXELFORMAT_YV12, SDL_TEXTUREACCESS_STREAMING, 7, 5);
+   SDLTest_AssertCheck(frames != NULL, "Verify SDL_CreateTexture result is not NULL");
+   if (frames == NULL) {
+      return TEST_ABORTED;
+   }
+   ret = SDL_SetTextureStreamingBuffers(frames, 2);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetTextureStreamingBuffers, expected: 0, got: %i", ret);
+   ret = SDL_LockTextureBuffer(frames, (void **)&pixels, &pitch);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_LockTextureBuffer, expected: 0, got: %i", ret);
+   if (ret == 0) {
+      SDLTest_AssertCheck(pitch == 7, "Verify the pitch of the Y plane, expected: 7, got: %i", pitch);
+      SDL_memset(pixels, 0x80, pitch * 5 + 2 * 4 * 3);
+      SDL_UnlockTextureBuffer(frames);
+   }
+   _drawTexture(sw, frames);
+   pixel = *(Uint32 *)surface->pixels;
+   SDLTest_AssertCheck((pixel & 0xff) == ((pixel >> 8) & 0xff) && (pixel & 0xff) == ((pixel >> 16) & 0xff),
+                       "Verify the frame was drawn gray, got: 0x%.8x", pixel);
+
+   SDL_DestroyTexture(texture);
+   SDL_DestroyTexture(reference);
+   SDL_DestroyTexture(frames);
+   SDL_DestroyRenderer(sw);
+   SDL_FreeSurface(surface);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Draws a scene that covers every kind of software draw. Helper function.
+ */
+static void
+_drawTiledScene(SDL_Renderer *sw, SDL_Texture *tsprite, SDL_Texture *ttarget)
+{
+   const SDL_BlendMode modes[] = {
+      SDL_BLENDMODE_NONE, SDL_BLENDMODE_BLEND, SDL_BLENDMODE_ADD, SDL_BLENDMODE_MOD
+   };
+   SDL_RenderCopyData copies[64];
+   SDL_Point points[256];
+   SDL_Rect rect;
+   int i;
+
+   /* Fills, points and lines in every blend mode */
+   _drawBatchScene(sw, tsprite, ttarget);
+   for (i = 0; i < 64; i++) {
+      rect.x = (i * 37) % 300 - 20;
+      rect.y = (i * 23) % 200 - 20;
+      rect.w = 10 + (i * 13) % 150;
+      rect.h = 5 + (i * 7) % 90;
+      SDL_SetRenderDrawBlendMode(sw, modes[i % 4]);
+      SDL_SetRenderDrawColor(sw, (Uint8)(i * 4), (Uint8)(255 - i * 3), (Uint8)(i * 9), (Uint8)(60 + i * 3));
+      SDL_RenderFillRect(sw, &rect);
+   }
+   for (i = 0; i < SDL_arraysize(points); i++) {
+      points[i].x = (i * 71) % 320;
+      points[i].y = (i * 29) % 240;
+   }
+   for (i = 0; i < 4; i++) {
+      SDL_SetRenderDrawBlendMode(sw, modes[i]);
+      SDL_SetRenderDrawColor(sw, 255, (Uint8)(i * 60), 0, 128);
+      SDL_RenderDrawPoints(sw, &points[i * 64], 64);
+      SDL_RenderDrawLine(sw, 0, i * 50, 319, 239 - i * 50);
+   }
+
+   /* Copies of a texture that crosses tiles, with the state changing */
+   for (i = 0; i < 48; i++) {
+      rect.x = (i * 53) % 320 - 16;
+      rect.y = (i * 31) % 240 - 16;
+      rect.w = 64;
+      rect.h = 64;
+      if ((i % 12) == 6) {
+         rect.w = 40;
+      }
+      SDL_SetTextureBlendMode(tsprite, modes[(i / 3) % 4]);
+      SDL_SetTextureColorMod(tsprite, (Uint8)(255 - i * 5), 200, (Uint8)(i * 5));
+      SDL_SetTextureAlphaMod(tsprite, (Uint8)(255 - i * 2));
+      if ((i % 12) == 11) {
+         SDL_RenderCopyEx(sw, tsprite, NULL, &rect, 15.0 * i, NULL, SDL_FLIP_NONE);
+      } else {
+         SDL_RenderCopy(sw, tsprite, NULL, &rect);
+      }
+   }
+
+   /* Many copies in one call, each with its own modulation */
+   SDL_zero(copies);
+   SDL_SetTextureBlendMode(tsprite, SDL_BLENDMODE_BLEND);
+   for (i = 0; i < SDL_arraysize(copies); i++) {
+      copies[i].dstrect.x = (i * 41) % 320 - 8;
+      copies[i].dstrect.y = (i * 17) % 240 - 8;
+      copies[i].dstrect.w = ((i % 9) == 0) ? 32 : 64;
+      copies[i].dstrect.h = 64;
+      if ((i % 10) == 3) {
+         copies[i].angle = 20.0 * i;
+      }
+      copies[i].r = (Uint8)(i * 4);
+      copies[i].g = 255;
+      copies[i].b = (Uint8)(255 - i * 4);
+      copies[i].a = (Uint8)(128 + i);
+   }
+   SDL_RenderCopyMany(sw, tsprite, copies, SDL_arraysize(copies));
+
+   /* Clipped and offset drawing */
+   rect.x = 50;
+   rect.y = 40;
+   rect.w = 200;
+   rect.h = 150;
+   SDL_RenderSetViewport(sw, &rect);
+   rect.x = 30;
+   rect.y = 10;
+   rect.w = 130;
+   rect.h = 100;
+   SDL_RenderSetClipRect(sw, &rect);
+   SDL_SetRenderDrawBlendMode(sw, SDL_BLENDMODE_BLEND);
+   SDL_SetRenderDrawColor(sw, 0, 0, 255, 100);
+   SDL_RenderFillRect(sw, NULL);
+   SDL_RenderCopy(sw, tsprite, NULL, NULL);
+   SDL_RenderDrawPoints(sw, points, SDL_arraysize(points));
+   SDL_RenderSetClipRect(sw, NULL);
+   SDL_RenderSetViewport(sw, NULL);
+   SDL_SetRenderDrawBlendMode(sw, SDL_BLENDMODE_NONE);
+}
+
+/**
+ * @brief Checks that the threaded software renderer matches the serial one.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_HINT_RENDER_SOFTWARE_THREADS
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderFlush
+ */
+int
+render_testSoftwareThreads(void *arg)
+{
+   const char *threads[2] = { "1", "4" };
+   SDL_Surface *surfaces[2];
+   SDL_Surface *spriteSurface;
+   SDL_Renderer *sw;
+   SDL_Texture *tsprite, *ttarget;
+   Uint32 pixel;
+   int i, ret;
+
+   spriteSurface = SDL_CreateRGBSurface(0, 64, 64, 32,
+                                        RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                        RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   SDLTest_AssertCheck(spriteSurface != NULL, "Verify sprite surface is not NULL");
+   if (spriteSurface == NULL) {
+      return TEST_ABORTED;
+   }
+   for (i = 0; i < 64 * 64; i++) {
+      ((Uint32 *)spriteSurface->pixels)[i] = (((Uint32)i * 0x01030507) & 0x00ffffff) | ((Uint32)(i % 5) * 0x3f000000);
+   }
+
+   /* Draw the same scene on one thread and on several */
+   for (i = 0; i < 2; i++) {
+      SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_THREADS, threads[i]);
+      surfaces[i] = SDL_CreateRGBSurface(0, 320, 240, 32,
+                                         RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                         RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+      SDLTest_AssertCheck(surfaces[i] != NULL, "Verify destination surface is not NULL");
+      if (surfaces[i] == NULL) {
+         return TEST_ABORTED;
+      }
+      sw = SDL_CreateSoftwareRenderer(surfaces[i]);
+      SDLTest_AssertCheck(sw != NULL, "Verify SDL_CreateSoftwareRenderer result is not NULL");
+      if (sw == NULL) {
+         return TEST_ABORTED;
+      }
+      tsprite = SDL_CreateTextureFromSurface(sw, spriteSurface);
+      SDLTest_AssertCheck(tsprite != NULL, "Verify sprite texture is not NULL");
+      ttarget = SDL_CreateTexture(sw, RENDER_COMPARE_FORMAT, SDL_TEXTUREACCESS_TARGET, 8, 8);
+
+      _drawTiledScene(sw, tsprite, ttarget);
+      ret = SDL_RenderFlush(sw);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderFlush, expected: 0, got: %i", ret);
+
+      if (i == 1) {
+         ret = SDLTest_CompareSurfaces(surfaces[1], surfaces[0], 0);
+         SDLTest_AssertCheck(ret == 0, "Verify threaded rendering matches serial rendering, expected: 0, got: %i", ret);
+
+         /* A clear is only drawn once it is flushed */
+         SDL_SetRenderDrawColor(sw, 1, 2, 3, SDL_ALPHA_OPAQUE);
+         SDL_RenderClear(sw);
+         ret = SDL_RenderFlush(sw);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderFlush, expected: 0, got: %i", ret);
+         pixel = ((Uint32 *)surfaces[i]->pixels)[320 * 240 - 1];
+         SDLTest_AssertCheck(pixel == 0xff010203, "Verify clear is drawn after SDL_RenderFlush, expected 0xff010203, got 0x%.8x", pixel);
+      }
+
+      SDL_DestroyRenderer(sw);
+   }
+   SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_THREADS, NULL);
+
+   SDL_FreeSurface(spriteSurface);
+   SDL_FreeSurface(surfaces[0]);
+   SDL_FreeSurface(surfaces[1]);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Copies a surface flipped, then turned clockwise by quarter turns. Helper function.
+ */
+static SDL_Surface *
+_turnSurface(SDL_Surface *surface, int turns, SDL_RendererFlip flip)
+{
+   SDL_Surface *turned;
+   int x, y, sx, sy, tx, ty;
+   int w = surface->w;
+   int h = surface->h;
+
+   turned = SDL_CreateRGBSurface(0, (turns % 2) ? h : w, (turns % 2) ? w : h, 32,
+                                 RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                 RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   if (turned == NULL) {
+      return NULL;
+   }
+   for (y = 0; y < h; y++) {
+      for (x = 0; x < w; x++) {
+         sx = (flip & SDL_FLIP_HORIZONTAL) ? (w - 1 - x) : x;
+         sy = (flip & SDL_FLIP_VERTICAL) ? (h - 1 - y) : y;
+         switch (turns) {
+         case 1: tx = h - 1 - y; ty = x; break;
+         case 2: tx = w - 1 - x; ty = h - 1 - y; break;
+         case 3: tx = y; ty = w - 1 - x; break;
+         default: tx = x; ty = y; break;
+         }
+         ((Uint32 *)turned->pixels)[ty * turned->w + tx] = ((Uint32 *)surface->pixels)[sy * w + sx];
+      }
+   }
+   return turned;
+}
+
+/**
+ * @brief Draws an image into a new surface, rotated or as a plain copy. Helper function.
+ */
+static SDL_Surface *
+_drawCopyEx(Uint32 format, SDL_Surface *image, const SDL_Rect *rect, double angle,
+            SDL_RendererFlip flip, SDL_BlendMode blendMode)
+{
+   SDL_Surface *surface;
+   SDL_Renderer *sw;
+   SDL_Texture *texture;
+   int bpp;
+   Uint32 Rmask, Gmask, Bmask, Amask;
+
+   SDL_PixelFormatEnumToMasks(format, &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+   surface = SDL_CreateRGBSurface(0, 40, 40, bpp, Rmask, Gmask, Bmask, Amask);
+   if (surface == NULL) {
+      return NULL;
+   }
+   sw = SDL_CreateSoftwareRenderer(surface);
+   if (sw == NULL) {
+      SDL_FreeSurface(surface);
+      return NULL;
+   }
+   SDL_SetRenderDrawColor(sw, 90, 60, 30, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(sw);
+
+   texture = SDL_CreateTextureFromSurface(sw, image);
+   if (texture != NULL) {
+      SDL_SetTextureBlendMode(texture, blendMode);
+      if (blendMode != SDL_BLENDMODE_NONE) {
+         SDL_SetTextureColorMod(texture, 200, 150, 100);
+         SDL_SetTextureAlphaMod(texture, 180);
+      }
+      if (angle != 0.0 || flip != SDL_FLIP_NONE) {
+         SDL_RenderCopyEx(sw, texture, NULL, rect, angle, NULL, flip);
+      } else {
+         SDL_RenderCopy(sw, texture, NULL, rect);
+      }
+      SDL_DestroyTexture(texture);
+   }
+   SDL_DestroyRenderer(sw);
+   return surface;
+}
+
+/**
+ * @brief Checks rotated and flipped copies against turned images.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderCopyEx
+ */
+int
+render_testCopyEx(void *arg)
+{
+   const Uint32 formats[2] = { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565 };
+   const char *quality[2] = { "nearest", "linear" };
+   const SDL_RendererFlip flips[3] = { SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL };
+   SDL_Surface *image, *turned, *rotated, *reference;
+   SDL_Rect rect, turned_rect;
+   Uint32 pixel;
+   int i, j, turns, f, mismatches, ret;
+
+   image = SDL_CreateRGBSurface(0, 12, 8, 32,
+                                RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   SDLTest_AssertCheck(image != NULL, "Verify image surface is not NULL");
+   if (image == NULL) {
+      return TEST_ABORTED;
+   }
+   for (i = 0; i < 12 * 8; i++) {
+      ((Uint32 *)image->pixels)[i] = 0xff000000 | ((Uint32)i * 0x0a1f2b);
+   }
+   rect.x = 10;
+   rect.y = 12;
+   rect.w = 12;
+   rect.h = 8;
+
+   /* Quarter turns land exactly on pixels, with and without filtering */
+   for (i = 0; i < SDL_arraysize(formats); i++) {
+      for (j = 0; j < SDL_arraysize(quality); j++) {
+         SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, quality[j]);
+         mismatches = 0;
+         for (turns = 0; turns < 4; turns++) {
+            for (f = 0; f < SDL_arraysize(flips); f++) {
+               turned = _turnSurface(image, turns, flips[f]);
+               turned_rect = rect;
+               if (turns % 2) {
+                  turned_rect.x = rect.x + (rect.w - rect.h) / 2;
+                  turned_rect.y = rect.y + (rect.h - rect.w) / 2;
+                  turned_rect.w = rect.h;
+                  turned_rect.h = rect.w;
+               }
+               rotated = _drawCopyEx(formats[i], image, &rect, 90.0 * turns, flips[f], SDL_BLENDMODE_NONE);
+               reference = _drawCopyEx(formats[i], turned, &turned_rect, 0.0, SDL_FLIP_NONE, SDL_BLENDMODE_NONE);
+               if (rotated == NULL || reference == NULL ||
+                   SDL_memcmp(rotated->pixels, reference->pixels, rotated->h * rotated->pitch) != 0) {
+                  mismatches++;
+               }
+               SDL_FreeSurface(turned);
+               SDL_FreeSurface(rotated);
+               SDL_FreeSurface(reference);
+            }
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify %s quarter turns onto %s match turned images, got %i mismatches",
+                             quality[j], SDL_GetPixelFormatName(formats[i]), mismatches);
+      }
+   }
+
+   /* Modulation and blending work as they do for a plain copy */
+   SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+   rotated = _drawCopyEx(SDL_PIXELFORMAT_ARGB8888, image, &rect, 360.0, SDL_FLIP_NONE, SDL_BLENDMODE_BLEND);
+   reference = _drawCopyEx(SDL_PIXELFORMAT_ARGB8888, image, &rect, 0.0, SDL_FLIP_NONE, SDL_BLENDMODE_BLEND);
+   SDLTest_AssertCheck(rotated != NULL && reference != NULL, "Verify blended copies were drawn");
+   if (rotated != NULL && reference != NULL) {
+      ret = SDLTest_CompareSurfaces(rotated, reference, 0);
+      SDLTest_AssertCheck(ret == 0, "Verify blended full turn matches a plain copy, expected: 0, got: %i", ret);
+   }
+   SDL_FreeSurface(rotated);
+   SDL_FreeSurface(reference);
+
+   /* Half a quarter turn covers the center but not the corners */
+   SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+   SDL_FillRect(image, NULL, 0xff102030);
+   rect.w = 16;
+   rect.h = 16;
+   rotated = _drawCopyEx(SDL_PIXELFORMAT_ARGB8888, image, &rect, 45.0, SDL_FLIP_NONE, SDL_BLENDMODE_NONE);
+   SDLTest_AssertCheck(rotated != NULL, "Verify rotated copy was drawn");
+   if (rotated != NULL) {
+      pixel = ((Uint32 *)rotated->pixels)[(rect.y + 8) * rotated->w + rect.x + 8];
+      SDLTest_AssertCheck(pixel == 0xff102030, "Verify center of rotated copy, expected: 0xff102030, got: 0x%.8x", pixel);
+      pixel = ((Uint32 *)rotated->pixels)[rect.y * rotated->w + rect.x];
+      SDLTest_AssertCheck(pixel == 0xff5a3c1e, "Verify corner outside rotated copy, expected: 0xff5a3c1e, got: 0x%.8x", pixel);
+      pixel = ((Uint32 *)rotated->pixels)[(rect.y + 8) * rotated->w + rect.x - 2];
+      SDLTest_AssertCheck(pixel == 0xff102030, "Verify left point of rotated copy, expected: 0xff102030, got: 0x%.8x", pixel);
+      SDL_FreeSurface(rotated);
+   }
+   SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, NULL);
+
+   SDL_FreeSurface(image);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Counts the work the renderers send to their backends.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_GetRenderStats
+ */
+int
+render_testRenderStats(void *arg)
+{
+   const SDL_Rect rects[3] = { { 0, 0, 4, 4 }, { 4, 4, 4, 4 }, { 8, 8, 4, 4 } };
+   Uint32 pixels[16 * 16];
+   SDL_Surface *surface;
+   SDL_Renderer *sw;
+   SDL_Texture *texture;
+   SDL_RenderStats current, previous;
+   int ret;
+
+   ret = SDL_GetRenderStats(NULL, &current, NULL);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_GetRenderStats with NULL renderer, expected: -1, got: %i", ret);
+
+   surface = SDL_CreateRGBSurface(0, 16, 16, 32,
+                                  RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                  RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   SDLTest_AssertCheck(surface != NULL, "Verify destination surface is not NULL");
+   if (surface == NULL) {
+      return TEST_ABORTED;
+   }
+   sw = SDL_CreateSoftwareRenderer(surface);
+   SDLTest_AssertCheck(sw != NULL, "Verify SDL_CreateSoftwareRenderer result is not NULL");
+   if (sw == NULL) {
+      return TEST_ABORTED;
+   }
+   texture = SDL_CreateTexture(sw, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 16, 16);
+   SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTexture result is not NULL");
+   if (texture == NULL) {
+      return TEST_ABORTED;
+   }
+
+   /* A new renderer has sent nothing */
+   ret = SDL_GetRenderStats(sw, &current, &previous);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_GetRenderStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(current.draw_calls == 0 && previous.draw_calls == 0,
+                       "Verify no draw calls, got: %u and %u", current.draw_calls, previous.draw_calls);
+
+   /* The software renderer has no backend state, so only draws and uploads count */
+   SDL_memset4(pixels, 0xff204060, SDL_arraysize(pixels));
+   SDL_UpdateTexture(texture, NULL, pixels, 16 * sizeof(Uint32));
+   SDL_RenderClear(sw);
+   SDL_SetRenderDrawColor(sw, 255, 0, 0, 255);
+   SDL_RenderFillRects(sw, rects, SDL_arraysize(rects));
+   SDL_RenderCopy(sw, texture, NULL, NULL);
+   SDL_RenderCopy(sw, texture, &rects[0], &rects[1]);
+   ret = SDL_GetRenderStats(sw, &current, NULL);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_GetRenderStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(current.draw_calls == 4, "Verify draw calls, expected: 4, got: %u", current.draw_calls);
+   SDLTest_AssertCheck(current.state_changes == 0, "Verify state changes, expected: 0, got: %u", current.state_changes);
+   SDLTest_AssertCheck(current.texture_binds == 0, "Verify texture binds, expected: 0, got: %u", current.texture_binds);
+   SDLTest_AssertCheck(current.bytes_uploaded == sizeof(pixels),
+                       "Verify bytes uploaded, expected: %u, got: %u",
+                       (unsigned)sizeof(pixels), (unsigned)current.bytes_uploaded);
+
+   /* Presenting starts a new frame */
+   SDL_RenderPresent(sw);
+   ret = SDL_GetRenderStats(sw, &current, &previous);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_GetRenderStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(current.draw_calls == 0 && current.bytes_uploaded == 0,
+                       "Verify the new frame is empty, got: %u draw calls", current.draw_calls);
+   SDLTest_AssertCheck(previous.draw_calls == 4 && previous.bytes_uploaded == sizeof(pixels),
+                       "Verify the last frame was kept, got: %u draw calls", previous.draw_calls);
+
+   SDL_DestroyTexture(texture);
+   SDL_DestroyRenderer(sw);
+   SDL_FreeSurface(surface);
+
+   /* Drawing the same copy again changes no backend state */
+   texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 16, 16);
+   SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTexture result is not NULL");
+   if (texture == NULL) {
+      return TEST_ABORTED;
+   }
+   SDL_RenderCopy(renderer, texture, NULL, &rects[0]);
+   SDL_GetRenderStats(renderer, &previous, NULL);
+   SDL_RenderCopy(renderer, texture, NULL, &rects[0]);
+   SDL_GetRenderStats(renderer, &current, NULL);
+   SDLTest_AssertCheck(current.draw_calls == previous.draw_calls + 1,
+                       "Verify one more draw call, expected: %u, got: %u", previous.draw_calls + 1, current.draw_calls);
+   SDLTest_AssertCheck(current.state_changes == previous.state_changes,
+                       "Verify no state changes, expected: %u, got: %u", previous.state_changes, current.state_changes);
+   SDLTest_AssertCheck(current.texture_binds == previous.texture_binds,
+                       "Verify no texture binds, expected: %u, got: %u", previous.texture_binds, current.texture_binds);
+   SDL_DestroyTexture(texture);
+
+   return TEST_COMPLETED;
+}
+
+/* The YUV to RGB conversion of one pixel for each SDL_HINT_YUV_CONVERSION_MODE */
+static void
+_yuvToRGB(int mode, int Y, int U, int V, int *r, int *g, int *b)
+{
+   double kr = (mode >= 2) ? 0.2126 : 0.299;
+   double kb = (mode >= 2) ? 0.0722 : 0.114;
+   double kg = 1.0 - kr - kb;
+   SDL_bool limited = (mode == 1 || mode == 2);
+   double y = limited ? (Y - 16) * 255.0 / 219.0 : Y;
+   double u = (U - 128) * (limited ? 255.0 / 224.0 : 1.0);
+   double v = (V - 128) * (limited ? 255.0 / 224.0 : 1.0);
+   double rgb[3];
+   int i;
+
+   rgb[0] = y + 2.0 * (1.0 - kr) * v;
+   rgb[1] = y - 2.0 * (1.0 - kb) * kb / kg * u - 2.0 * (1.0 - kr) * kr / kg * v;
+   rgb[2] = y + 2.0 * (1.0 - kb) * u;
+   for (i = 0; i < 3; ++i) {
+      rgb[i] = SDL_floor(rgb[i] + 0.5);
+      rgb[i] = (rgb[i] < 0.0) ? 0.0 : (rgb[i] > 255.0) ? 255.0 : rgb[i];
+   }
+   *r = (int)rgb[0];
+   *g = (int)rgb[1];
+   *b = (int)rgb[2];
+}
+
+/**
+ * @brief Tests the conversion of YUV textures in each colorspace and range
+ *
+ * The widths convert some pixels in groups and the rest one at a time.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_HINT_YUV_CONVERSION_MODE
+ */
+int
+render_testYUVConversion(void *arg)
+{
+   const char *modes[] = { "JPEG", "BT601", "BT709", "BT709_FULL" };
+   const Uint32 formats[] = { SDL_PIXELFORMAT_IYUV, SDL_PIXELFORMAT_YV12, SDL_PIXELFORMAT_YUY2 };
+   const int widths[] = { 16, 30, 62 };
+   const int h = 32;
+   Uint8 yuv[62 * 32 * 2];
+   Uint8 Y[62 * 32], U[62 * 32], V[62 * 32];
+   SDL_Surface *surface;
+   SDL_Renderer *sw;
+   SDL_Texture *texture;
+   int m, f, i, x, y, w;
+
+   surface = SDL_CreateRGBSurface(0, 62, h, 32,
+                                  RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                  RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   SDLTest_AssertCheck(surface != NULL, "Verify destination surface is not NULL");
+   if (surface == NULL) {
+      return TEST_ABORTED;
+   }
+   sw = SDL_CreateSoftwareRenderer(surface);
+   SDLTest_AssertCheck(sw != NULL, "Verify SDL_CreateSoftwareRenderer result is not NULL");
+   if (sw == NULL) {
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+
+   for (m = 0; m < SDL_arraysize(modes); ++m) {
+      /* Limited range values outside of the range aren't converted exactly */
+      const SDL_bool limited = (m == 1 || m == 2);
+      const int ymin = limited ? 16 : 0, ymax = limited ? 235 : 255;
+      const int cmin = limited ? 16 : 0, cmax = limited ? 240 : 255;
+
+      SDL_SetHint(SDL_HINT_YUV_CONVERSION_MODE, modes[m]);
+      for (f = 0; f < SDL_arraysize(formats); ++f) {
+         for (i = 0; i < SDL_arraysize(widths); ++i) {
+            SDL_Rect rect;
+            int errors = 0, tail_errors = 0;
+            w = widths[i];
+            rect.x = 0;
+            rect.y = 0;
+            rect.w = w;
+            rect.h = h;
+
+            /* Each 2x2 block of planar pixels, or pair of packed pixels, shares its chroma */
+            for (y = 0; y < h; ++y) {
+               for (x = 0; x < w; ++x) {
+                  Y[y * w + x] = (Uint8)SDLTest_RandomIntegerInRange(ymin, ymax);
+                  if (x % 2 == 0 && (formats[f] == SDL_PIXELFORMAT_YUY2 || y % 2 == 0)) {
+                     U[y * w + x] = (Uint8)SDLTest_RandomIntegerInRange(cmin, cmax);
+                     V[y * w + x] = (Uint8)SDLTest_RandomIntegerInRange(cmin, cmax);
+                  } else if (x % 2 == 0) {
+                     U[y * w + x] = U[(y - 1) * w + x];
+                     V[y * w + x] = V[(y - 1) * w + x];
+                  } else {
+                     U[y * w + x] = U[y * w + x - 1];
+                     V[y * w + x] = V[y * w + x - 1];
+                  }
+               }
+            }
+            /* Pixels past a multiple of 16 repeat the first ones, so the end of
+               the row can be compared with the start of it */
+            for (y = 0; y < h; ++y) {
+               for (x = 16; x < w; ++x) {
+                  Y[y * w + x] = Y[y * w + x - 16];
+                  U[y * w + x] = U[y * w + x - 16];
+                  V[y * w + x] = V[y * w + x - 16];
+               }
+            }
+            if (formats[f] == SDL_PIXELFORMAT_YUY2) {
+               for (y = 0; y < h; ++y) {
+                  for (x = 0; x < w; ++x) {
+                     yuv[(y * w + x) * 2] = Y[y * w + x];
+                     yuv[(y * w + x) * 2 + 1] = (x % 2 == 0) ? U[y * w + x] : V[y * w + x];
+                  }
+               }
+            } else {
+               Uint8 *cb = yuv + w * h + ((formats[f] == SDL_PIXELFORMAT_YV12) ? (w / 2) * (h / 2) : 0);
+               Uint8 *cr = yuv + w * h + ((formats[f] == SDL_PIXELFORMAT_IYUV) ? (w / 2) * (h / 2) : 0);
+               SDL_memcpy(yuv, Y, w * h);
+               for (y = 0; y < h / 2; ++y) {
+                  for (x = 0; x < w / 2; ++x) {
+                     cb[y * (w / 2) + x] = U[(y * 2) * w + x * 2];
+                     cr[y * (w / 2) + x] = V[(y * 2) * w + x * 2];
+                  }
+               }
+            }
+
+            texture = SDL_CreateTexture(sw, formats[f], SDL_TEXTUREACCESS_STATIC, w, h);
+            SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTexture result is not NULL");
+            if (texture == NULL) {
+               continue;
+            }
+            SDL_UpdateTexture(texture, NULL, yuv, (formats[f] == SDL_PIXELFORMAT_YUY2) ? w * 2 : w);
+            SDL_RenderCopy(sw, texture, NULL, &rect);
+            SDL_DestroyTexture(texture);
+
+            /* The source is exact, the tables and fixed point math are within 2 */
+            for (y = 0; y < h; ++y) {
+               const Uint32 *row = (const Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+               for (x = 16; x < w; ++x) {
+                  if (row[x] != row[x - 16]) {
+                     ++tail_errors;
+                  }
+               }
+               for (x = 0; x < w; ++x) {
+                  int r, g, b;
+                  Uint8 R, G, B;
+
+                  _yuvToRGB(m, Y[y * w + x], U[y * w + x], V[y * w + x], &r, &g, &b);
+                  SDL_GetRGB(row[x], surface->format, &R, &G, &B);
+                  if (SDL_abs(r - R) > 2 || SDL_abs(g - G) > 2 || SDL_abs(b - B) > 2) {
+                     ++errors;
+                  }
+               }
+            }
+            SDLTest_AssertCheck(errors == 0,
+                                "Verify %s conversion of %s %ix%i, expected: 0 errors, got: %i",
+                                modes[m], SDL_GetPixelFormatName(formats[f]), w, h, errors);
+            SDLTest_AssertCheck(tail_errors == 0,
+                                "Verify %s conversion of %s %ix%i rounds the end of a row alike, expected: 0 errors, got: %i",
+                                modes[m], SDL_GetPixelFormatName(formats[f]), w, h, tail_errors);
+         }
+      }
+   }
+   SDL_SetHint(SDL_HINT_YUV_CONVERSION_MODE, "JPEG");
+
+   SDL_DestroyRenderer(sw);
+   SDL_FreeSurface(surface);
+
+   return TEST_COMPLETED;
+}
+
+/* Renders a texture and reads back the pixels */
+static void
+_renderYUVTexture(SDL_Renderer *sw, SDL_Texture *texture, Uint32 *pixels, int w)
+{
+   SDL_RenderCopy(sw, texture, NULL, NULL);
+   SDL_RenderReadPixels(sw, NULL, RENDER_COMPARE_FORMAT, pixels, w * sizeof(Uint32));
+}
+
+/**
+ * @brief Tests updating planar YUV textures from separate planes.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_UpdateYUVTexture
+ */
+int
+render_testUpdateYUVTexture(void *arg)
+{
+   const Uint32 formats[] = { SDL_PIXELFORMAT_IYUV, SDL_PIXELFORMAT_YV12 };
+   const SDL_Rect rects[2] = { { 0, 0, 16, 8 }, { 4, 2, 8, 4 } };
+   /* The planes have pitches wider than their rows */
+   const int Ypitch = 16 + 5, Upitch = 8 + 3, Vpitch = 8 + 7;
+   Uint8 Y[21 * 8], U[11 * 4], V[15 * 4];
+   Uint8 buffer[16 * 8 * 2];
+   Uint32 expected[16 * 8], actual[16 * 8];
+   SDL_Surface *surface;
+   SDL_Renderer *sw;
+   SDL_Texture *planar, *contiguous;
+   int f, r, i, row, ret;
+
+   surface = SDL_CreateRGBSurface(0, 16, 8, 32,
+                                  RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                  RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   SDLTest_AssertCheck(surface != NULL, "Verify destination surface is not NULL");
+   if (surface == NULL) {
+      return TEST_ABORTED;
+   }
+   sw = SDL_CreateSoftwareRenderer(surface);
+   SDLTest_AssertCheck(sw != NULL, "Verify SDL_CreateSoftwareRenderer result is not NULL");
+   if (sw == NULL) {
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+
+   for (f = 0; f < SDL_arraysize(formats); ++f) {
+      planar = SDL_CreateTexture(sw, formats[f], SDL_TEXTUREACCESS_STATIC, 16, 8);
+      contiguous = SDL_CreateTexture(sw, formats[f], SDL_TEXTUREACCESS_STATIC, 16, 8);
+      SDLTest_AssertCheck(planar != NULL && contiguous != NULL, "Verify SDL_CreateTexture results are not NULL");
+      if (planar == NULL || contiguous == NULL) {
+         continue;
+      }
+
+      /* The whole texture, then a part of it */
+      for (r = 0; r < SDL_arraysize(rects); ++r) {
+         const SDL_Rect *rect = &rects[r];
+         Uint8 *dst = buffer;
+
+         for (i = 0; i < SDL_arraysize(Y); ++i) {
+            Y[i] = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+         }
+         for (i = 0; i < SDL_arraysize(U); ++i) {
+            U[i] = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+         }
+         for (i = 0; i < SDL_arraysize(V); ++i) {
+            V[i] = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+         }
+
+         /* SDL_UpdateTexture() takes the planes one after another, in the order of the format */
+         for (row = 0; row < rect->h; ++row, dst += rect->w) {
+            SDL_memcpy(dst, &Y[row * Ypitch], rect->w);
+         }
+         for (row = 0; row < rect->h / 2; ++row, dst += rect->w / 2) {
+            if (formats[f] == SDL_PIXELFORMAT_IYUV) {
+               SDL_memcpy(dst, &U[row * Upitch], rect->w / 2);
+            } else {
+               SDL_memcpy(dst, &V[row * Vpitch], rect->w / 2);
+            }
+         }
+         for (row = 0; row < rect->h / 2; ++row, dst += rect->w / 2) {
+            if (formats[f] == SDL_PIXELFORMAT_IYUV) {
+               SDL_memcpy(dst, &V[row * Vpitch], rect->w / 2);
+            } else {
+               SDL_memcpy(dst, &U[row * Upitch], rect->w / 2);
+            }
+         }
+
+         ret = SDL_UpdateTexture(contiguous, rect, buffer, rect->w);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+         ret = SDL_UpdateYUVTexture(planar, rect, Y, Ypitch, U, Upitch, V, Vpitch);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateYUVTexture, expected: 0, got: %i", ret);
+
+         _renderYUVTexture(sw, contiguous, expected, 16);
+         _renderYUVTexture(sw, planar, actual, 16);
+         SDLTest_AssertCheck(SDL_memcmp(expected, actual, sizeof(expected)) == 0,
+                             "Verify %s texture updated from planes in %ix%i at %i,%i matches",
+                             SDL_GetPixelFormatName(formats[f]), rect->w, rect->h, rect->x, rect->y);
+      }
+
+      ret = SDL_UpdateYUVTexture(planar, NULL, NULL, Ypitch, U, Upitch, V, Vpitch);
+      SDLTest_AssertCheck(ret == -1, "Validate result from SDL_UpdateYUVTexture with NULL Y plane, expected: -1, got: %i", ret);
+      ret = SDL_UpdateYUVTexture(planar, NULL, Y, Ypitch, U, 0, V, Vpitch);
+      SDLTest_AssertCheck(ret == -1, "Validate result from SDL_UpdateYUVTexture with 0 U pitch, expected: -1, got: %i", ret);
+
+      SDL_DestroyTexture(planar);
+      SDL_DestroyTexture(contiguous);
+   }
+
+   /* Only planar YUV textures have separate planes */
+   planar = SDL_CreateTexture(sw, SDL_PIXELFORMAT_YUY2, SDL_TEXTUREACCESS_STATIC, 16, 8);
+   SDLTest_AssertCheck(planar != NULL, "Verify SDL_CreateTexture result is not NULL");
+   if (planar != NULL) {
+      ret = SDL_UpdateYUVTexture(planar, NULL, Y, Ypitch, U, Upitch, V, Vpitch);
+      SDLTest_AssertCheck(ret == -1, "Validate result from SDL_UpdateYUVTexture with YUY2 texture, expected: -1, got: %i", ret);
+      SDL_DestroyTexture(planar);
+   }
+   ret = SDL_UpdateYUVTexture(NULL, NULL, Y, Ypitch, U, Upitch, V, Vpitch);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_UpdateYUVTexture with NULL texture, expected: -1, got: %i", ret);
+
+   SDL_DestroyRenderer(sw);
+   SDL_FreeSurface(surface);
+
+   return TEST_COMPLETED;
+}
+
+/* Waits for an asynchronous read by polling, and checks it against a blocking read */
+static void
+_compareReadback(SDL_RenderReadback *readback, const Uint8 *expected,
+                 int w, int h, Uint32 format, const char *description)
+{
+   const int length = w * SDL_BYTESPERPIXEL(format);
+   const void *pixels = NULL;
+   int pitch = 0, polls, ret, row, same = 1;
+
+   for (polls = 0; polls < 1000; ++polls) {
+      ret = SDL_PollRenderReadback(readback);
+      if (ret != 0) {
+         break;
+      }
+      SDL_Delay(1);
+   }
+   SDLTest_AssertCheck(ret == 1, "Validate result from SDL_PollRenderReadback, expected: 1, got: %i", ret);
+
+   ret = SDL_WaitRenderReadback(readback, &pixels, &pitch);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_WaitRenderReadback, expected: 0, got: %i", ret);
+   if (ret != 0 || pixels == NULL) {
+      return;
+   }
+   SDLTest_AssertCheck(pitch >= length, "Verify pitch is at least %i, got: %i", length, pitch);
+   for (row = 0; row < h; ++row) {
+      if (SDL_memcmp((const Uint8 *)pixels + row * pitch, expected + row * length, length) != 0) {
+         same = 0;
+      }
+   }
+   SDLTest_AssertCheck(same, "Verify %s read in %s matches SDL_RenderReadPixels",
+                       description, SDL_GetPixelFormatName(format));
+}
+
+/**
+ * @brief Tests reading pixels asynchronously.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderReadPixelsAsync
+ */
+int
+render_testReadPixelsAsync(void *arg)
+{
+   /* The target's own format needs no conversion, the others go to the worker */
+   const Uint32 formats[] = { RENDER_COMPARE_FORMAT, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGB565 };
+   const SDL_Rect part = { 5, 3, 10, 7 };
+   const SDL_Rect outside = { 100, 100, 4, 4 };
+   const SDL_Rect overlapping = { -4, -4, 8, 8 };
+   const SDL_Rect corner = { 0, 0, 4, 4 };
+   Uint8 expected[32 * 16 * 4];
+   SDL_RenderReadback *readback, *orphan;
+   SDL_Surface *surface;
+   SDL_Renderer *sw;
+   SDL_Rect rect;
+   int f, i, ret, bpp;
+   const void *pixels;
+   int pitch;
+
+   surface = SDL_CreateRGBSurface(0, 32, 16, 32,
+                                  RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                  RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   SDLTest_AssertCheck(surface != NULL, "Verify destination surface is not NULL");
+   if (surface == NULL) {
+      return TEST_ABORTED;
+   }
+   sw = SDL_CreateSoftwareRenderer(surface);
+   SDLTest_AssertCheck(sw != NULL, "Verify SDL_CreateSoftwareRenderer result is not NULL");
+   if (sw == NULL) {
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+
+   SDL_SetRenderDrawColor(sw, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(sw);
+   for (i = 0; i < 8; ++i) {
+      rect.x = SDLTest_RandomIntegerInRange(0, 31);
+      rect.y = SDLTest_RandomIntegerInRange(0, 15);
+      rect.w = SDLTest_RandomIntegerInRange(1, 16);
+      rect.h = SDLTest_RandomIntegerInRange(1, 8);
+      SDL_SetRenderDrawColor(sw, (Uint8)SDLTest_RandomIntegerInRange(0, 255),
+                             (Uint8)SDLTest_RandomIntegerInRange(0, 255),
+                             (Uint8)SDLTest_RandomIntegerInRange(0, 255), SDL_ALPHA_OPAQUE);
+      SDL_RenderFillRect(sw, &rect);
+   }
+
+   for (f = 0; f < SDL_arraysize(formats); ++f) {
+      bpp = SDL_BYTESPERPIXEL(formats[f]);
+
+      /* The whole target, with the draws still batched */
+      SDL_RenderReadPixels(sw, NULL, formats[f], expected, 32 * bpp);
+      readback = SDL_RenderReadPixelsAsync(sw, NULL, formats[f]);
+      SDLTest_AssertCheck(readback != NULL, "Verify SDL_RenderReadPixelsAsync result is not NULL");
+      if (readback != NULL) {
+         _compareReadback(readback, expected, 32, 16, formats[f], "whole target");
+         SDL_FreeRenderReadback(readback);
+      }
+
+      /* Part of the target */
+      SDL_RenderReadPixels(sw, &part, formats[f], expected, part.w * bpp);
+      readback = SDL_RenderReadPixelsAsync(sw, &part, formats[f]);
+      SDLTest_AssertCheck(readback != NULL, "Verify SDL_RenderReadPixelsAsync result is not NULL");
+      if (readback != NULL) {
+         _compareReadback(readback, expected, part.w, part.h, formats[f], "part of target");
+         SDL_FreeRenderReadback(readback);
+      }
+   }
+
+   /* The pixels are those when the read started, not when it finished */
+   SDL_RenderReadPixels(sw, NULL, RENDER_COMPARE_FORMAT, expected, 32 * 4);
+   readback = SDL_RenderReadPixelsAsync(sw, NULL, SDL_PIXELFORMAT_ABGR8888);
+   SDLTest_AssertCheck(readback != NULL, "Verify SDL_RenderReadPixelsAsync result is not NULL");
+   SDL_SetRenderDrawColor(sw, 255, 255, 255, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(sw);
+   SDL_RenderFlush(sw);
+   if (readback != NULL) {
+      SDL_ConvertPixels(32, 16, RENDER_COMPARE_FORMAT, expected, 32 * 4,
+                        SDL_PIXELFORMAT_ABGR8888, expected, 32 * 4);
+      _compareReadback(readback, expected, 32, 16, SDL_PIXELFORMAT_ABGR8888, "drawn over");
+      SDL_FreeRenderReadback(readback);
+   }
+
+   /* Rectangles are clipped to the viewport */
+   SDL_RenderReadPixels(sw, &corner, RENDER_COMPARE_FORMAT, expected, corner.w * 4);
+   readback = SDL_RenderReadPixelsAsync(sw, &overlapping, RENDER_COMPARE_FORMAT);
+   SDLTest_AssertCheck(readback != NULL, "Verify SDL_RenderReadPixelsAsync result is not NULL");
+   if (readback != NULL) {
+      _compareReadback(readback, expected, corner.w, corner.h, RENDER_COMPARE_FORMAT, "clipped");
+      SDL_FreeRenderReadback(readback);
+   }
+   readback = SDL_RenderReadPixelsAsync(sw, &outside, RENDER_COMPARE_FORMAT);
+   SDLTest_AssertCheck(readback == NULL, "Verify SDL_RenderReadPixelsAsync result is NULL outside the viewport");
+   readback = SDL_RenderReadPixelsAsync(sw, NULL, SDL_PIXELFORMAT_YV12);
+   SDLTest_AssertCheck(readback == NULL, "Verify SDL_RenderReadPixelsAsync result is NULL for YV12");
+
+   /* A read outlives its renderer, until it's freed */
+   SDL_RenderReadPixels(sw, NULL, SDL_PIXELFORMAT_RGB565, expected, 32 * 2);
+   orphan = SDL_RenderReadPixelsAsync(sw, NULL, SDL_PIXELFORMAT_RGB565);
+   SDLTest_AssertCheck(orphan != NULL, "Verify SDL_RenderReadPixelsAsync result is not NULL");
+   SDL_DestroyRenderer(sw);
+   if (orphan != NULL) {
+      _compareReadback(orphan, expected, 32, 16, SDL_PIXELFORMAT_RGB565, "orphaned");
+      SDL_FreeRenderReadback(orphan);
+   }
+
+   ret = SDL_PollRenderReadback(NULL);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_PollRenderReadback with NULL readback, expected: -1, got: %i", ret);
+   ret = SDL_WaitRenderReadback(NULL, &pixels, &pitch);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_WaitRenderReadback with NULL readback, expected: -1, got: %i", ret);
+   SDL_FreeRenderReadback(NULL);
+   SDLTest_AssertPass("Call to SDL_FreeRenderReadback(NULL)");
+
+   SDL_FreeSurface(surface);
+
+   return TEST_COMPLETED;
+}
+
+/* A white disc as a distance field, with alpha 128 on its edge */
+static SDL_Surface *
+_createDistanceFieldDisc(int size, double radius, int spread)
+{
+   SDL_Surface *surface;
+   Uint32 *pixels;
+   double dx, dy, a;
+   int x, y;
+
+   surface = SDL_CreateRGBSurface(0, size, size, 32,
+                                  0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+   if (surface == NULL) {
+      return NULL;
+   }
+   for (y = 0; y < size; y++) {
+      pixels = (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+      for (x = 0; x < size; x++) {
+         dx = x + 0.5 - size / 2.0;
+         dy = y + 0.5 - size / 2.0;
+         a = 128.0 + (radius - SDL_sqrt(dx * dx + dy * dy)) * 255.0 / (2 * spread);
+         a = SDL_max(0.0, SDL_min(a, 255.0));
+         pixels[x] = ((Uint32)(a + 0.5) << 24) | 0x00FFFFFF;
+      }
+   }
+   return surface;
+}
+
+/* Count the lit and partly lit pixels in a row of the target */
+static void
+_measureDiscRow(SDL_Surface *surface, int y, int *lit, int *partial)
+{
+   const Uint32 *pixels = (const Uint32 *)((const Uint8 *)surface->pixels + y * surface->pitch);
+   Uint8 r, g, b;
+   int x;
+
+   *lit = 0;
+   *partial = 0;
+   for (x = 0; x < surface->w; x++) {
+      SDL_GetRGB(pixels[x], surface->format, &r, &g, &b);
+      if (r >= 128) {
+         (*lit)++;
+      }
+      if (r > 0 && r < 255) {
+         (*partial)++;
+      }
+   }
+}
+
+/**
+ * @brief Tests drawing distance field textures at different scales.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_SetTextureDistanceField
+ */
+int
+render_testDistanceField(void *arg)
+{
+   const int scales[] = { 1, 2, 4, 8 };
+   SDL_Surface *surface, *disc, *expected;
+   SDL_TextureAtlas *atlas;
+   SDL_Texture *texture, *packed;
+   SDL_Renderer *sw;
+   SDL_Rect rect;
+   Uint8 threshold;
+   int i, ret, spread, lit, partial, size;
+
+   surface = SDL_CreateRGBSurface(0, 128, 128, 32,
+                                  RENDER_COMPARE_RMASK, RENDER_COMPARE_GMASK,
+                                  RENDER_COMPARE_BMASK, RENDER_COMPARE_AMASK);
+   SDLTest_AssertCheck(surface != NULL, "Verify destination surface is not NULL");
+   if (surface == NULL) {
+      return TEST_ABORTED;
+   }
+   sw = SDL_CreateSoftwareRenderer(surface);
+   SDLTest_AssertCheck(sw != NULL, "Verify SDL_CreateSoftwareRenderer result is not NULL");
+   disc = _createDistanceFieldDisc(16, 5.0, 3);
+   SDLTest_AssertCheck(disc != NULL, "Verify distance field surface is not NULL");
+   if (sw == NULL || disc == NULL) {
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+   texture = SDL_CreateTextureFromSurface(sw, disc);
+   SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTextureFromSurface result is not NULL");
+   if (texture == NULL) {
+      SDL_DestroyRenderer(sw);
+      SDL_FreeSurface(surface);
+      SDL_FreeSurface(disc);
+      return TEST_ABORTED;
+   }
+
+   ret = SDL_GetTextureDistanceField(texture, &spread, &threshold);
+   SDLTest_AssertCheck(ret == 0 && spread == 0, "Verify textures aren't distance fields by default, got spread: %i", spread);
+   ret = SDL_SetTextureDistanceField(texture, -1, 128);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_SetTextureDistanceField with negative spread, expected: -1, got: %i", ret);
+   ret = SDL_SetTextureDistanceField(texture, 3, 128);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetTextureDistanceField, expected: 0, got: %i", ret);
+   ret = SDL_GetTextureDistanceField(texture, &spread, &threshold);
+   SDLTest_AssertCheck(ret == 0 && spread == 3 && threshold == 128, "Verify SDL_GetTextureDistanceField, expected: 3 and 128, got: %i and %i", spread, threshold);
+
+   /* The disc keeps its size relative to the copy, with an edge one pixel wide */
+   for (i = 0; i < SDL_arraysize(scales); i++) {
+      size = 16 * scales[i];
+      rect.x = (128 - size) / 2;
+      rect.y = (128 - size) / 2;
+      rect.w = size;
+      rect.h = size;
+      SDL_SetRenderDrawColor(sw, 0, 0, 0, SDL_ALPHA_OPAQUE);
+      SDL_RenderClear(sw);
+      SDL_RenderCopy(sw, texture, NULL, &rect);
+      SDL_RenderFlush(sw);
+      _measureDiscRow(surface, 64, &lit, &partial);
+      SDLTest_AssertCheck(SDL_abs(lit - 10 * scales[i]) <= 1, "Verify disc width at scale %i, expected: %i, got: %i", scales[i], 10 * scales[i], lit);
+      SDLTest_AssertCheck(partial <= 2, "Verify sharp edges at scale %i, expected at most 2 partly lit pixels, got: %i", scales[i], partial);
+   }
+
+   /* A higher threshold moves the edge 2 texels inward */
+   SDL_SetTextureDistanceField(texture, 3, 128 + 85);
+   SDL_RenderClear(sw);
+   SDL_RenderCopy(sw, texture, NULL, &rect);
+   SDL_RenderFlush(sw);
+   _measureDiscRow(surface, 64, &lit, &partial);
+   SDLTest_AssertCheck(SDL_abs(lit - 6 * 8) <= 1, "Verify disc width with a higher threshold, expected: %i, got: %i", 6 * 8, lit);
+   SDL_SetTextureDistanceField(texture, 3, 128);
+
+   /* Half turns of the disc land on the same pixels */
+   SDL_RenderClear(sw);
+   SDL_RenderCopy(sw, texture, NULL, &rect);
+   SDL_RenderFlush(sw);
+   expected = SDL_ConvertSurface(surface, surface->format, 0);
+   SDLTest_AssertCheck(expected != NULL, "Verify copy of the target is not NULL");
+   if (expected != NULL) {
+      SDL_RenderClear(sw);
+      SDL_RenderCopyEx(sw, texture, NULL, &rect, 180.0, NULL, SDL_FLIP_NONE);
+      SDL_RenderFlush(sw);
+      ret = SDLTest_CompareSurfaces(surface, expected, 0);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDLTest_CompareSurfaces for a rotated copy, expected: 0, got: %i", ret);
+
+      /* An image in an atlas is drawn the same as its own texture */
+      atlas = SDL_CreateTextureAtlas(sw, 0, 64, 64);
+      SDLTest_AssertCheck(atlas != NULL, "Verify SDL_CreateTextureAtlas result is not NULL");
+      packed = atlas ? SDL_CreateAtlasTextureFromSurface(atlas, disc) : NULL;
+      SDLTest_AssertCheck(packed != NULL, "Verify SDL_CreateAtlasTextureFromSurface result is not NULL");
+      if (packed != NULL) {
+         ret = SDL_SetTextureDistanceField(packed, 3, 128);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetTextureDistanceField on an atlas image, expected: 0, got: %i", ret);
+         SDL_RenderClear(sw);
+         SDL_RenderCopy(sw, packed, NULL, &rect);
+         SDL_RenderFlush(sw);
+         ret = SDLTest_CompareSurfaces(surface, expected, 0);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDLTest_CompareSurfaces for an atlas image, expected: 0, got: %i", ret);
+      }
+      if (atlas != NULL) {
+         SDL_DestroyTextureAtlas(atlas);
+      }
+      SDL_FreeSurface(expected);
+   }
+
+   /* Turned off, the texture is scaled like any other */
+   ret = SDL_SetTextureDistanceField(texture, 0, 128);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetTextureDistanceField with 0 spread, expected: 0, got: %i", ret);
+   SDL_RenderClear(sw);
+   SDL_RenderCopy(sw, texture, NULL, &rect);
+   SDL_RenderFlush(sw);
+   _measureDiscRow(surface, 64, &lit, &partial);
+   SDLTest_AssertCheck(partial > 2, "Verify a plain copy has soft edges, got %i partly lit pixels", partial);
+
+   ret = SDL_SetTextureDistanceField(NULL, 3, 128);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_SetTextureDistanceField with NULL texture, expected: -1, got: %i", ret);
+
+   SDL_DestroyTexture(texture);
+   SDL_DestroyRenderer(sw);
+   SDL_FreeSurface(disc);
+   SDL_FreeSurface(surface);
+
+   return TEST_COMPLETED;
+}
+
+/* Span widths for render_testBlendSpans, around the four pixel vector size */
+static const int _blendSpanWidths[] = { 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 33 };
+
+/* Blend spans of every width and alignment onto a patterned surface of the
+   given format, and read the result back as ARGB8888. */
+static int
+_drawBlendSpans(Uint32 format, SDL_BlendMode blendMode, Uint8 alpha, Uint32 *pixels)
+{
+   const int w = 64, h = 48;
+   SDL_Surface *surface;
+   SDL_Renderer *sw;
+   SDL_Rect rect;
+   Uint32 Rmask, Gmask, Bmask, Amask;
+   int bpp, x, y, i, ret;
+
+   SDL_PixelFormatEnumToMasks(format, &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+   surface = SDL_CreateRGBSurface(0, w, h, bpp, Rmask, Gmask, Bmask, Amask);
+   if (surface == NULL) {
+      return -1;
+   }
+   for (y = 0; y < h; y++) {
+      for (x = 0; x < w; x++) {
+         ((Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch))[x] =
+            SDL_MapRGBA(surface->format, (Uint8)(x * 4), (Uint8)(y * 5), (Uint8)(x * y), (Uint8)(255 - x * 3));
+      }
+   }
+   sw = SDL_CreateSoftwareRenderer(surface);
+   if (sw == NULL) {
+      SDL_FreeSurface(surface);
+      return -1;
+   }
+   SDL_SetRenderDrawBlendMode(sw, blendMode);
+   SDL_SetRenderDrawColor(sw, 200, 100, 50, alpha);
+
+   /* One row for each width at each of the four alignments */
+   for (x = 0; x < 4; x++) {
+      for (i = 0; i < SDL_arraysize(_blendSpanWidths); i++) {
+         rect.x = 1 + x;
+         rect.y = x * SDL_arraysize(_blendSpanWidths) + i;
+         rect.w = _blendSpanWidths[i];
+         rect.h = 1;
+         SDL_RenderFillRect(sw, &rect);
+      }
+   }
+   /* Overlapping rectangles blend twice */
+   rect.x = 20; rect.y = 2; rect.w = 30; rect.h = 20;
+   SDL_RenderFillRect(sw, &rect);
+   rect.x = 27; rect.y = 11; rect.w = 13; rect.h = 30;
+   SDL_RenderFillRect(sw, &rect);
+
+   ret = SDL_RenderReadPixels(sw, NULL, SDL_PIXELFORMAT_ARGB8888, pixels, w * sizeof(Uint32));
+   SDL_DestroyRenderer(sw);
+   SDL_FreeSurface(surface);
+   return ret;
+}
+
+/**
+ * @brief Checks blended fills on the 8888 formats with vector code against
+ * the same fills on formats drawn pixel by pixel.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderFillRect
+ * http://wiki.libsdl.org/moin.cgi/SDL_SetRenderDrawBlendMode
+ */
+int
+render_testBlendSpans(void *arg)
+{
+   /* The first format of each pair has a SIMD span blender, the second not */
+   const Uint32 formats[][2] = {
+      { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888 },
+      { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_BGR888 }
+   };
+   const SDL_BlendMode modes[] = {
+      SDL_BLENDMODE_BLEND, SDL_BLENDMODE_ADD, SDL_BLENDMODE_MOD
+   };
+   const Uint8 alphas[] = { 0, 100, 255 };
+   Uint32 *fast, *reference;
+   int i, j, k, ret;
+
+   fast = (Uint32 *)SDL_malloc(64 * 48 * sizeof(Uint32));
+   reference = (Uint32 *)SDL_malloc(64 * 48 * sizeof(Uint32));
+   SDLTest_AssertCheck(fast != NULL && reference != NULL, "Validate allocated readback buffers");
+   if (fast == NULL || reference == NULL) {
+      SDL_free(fast);
+      SDL_free(reference);
+      return TEST_ABORTED;
+   }
+
+   for (i = 0; i < SDL_arraysize(formats); i++) {
+      for (j = 0; j < SDL_arraysize(modes); j++) {
+         for (k = 0; k < SDL_arraysize(alphas); k++) {
+            ret = _drawBlendSpans(formats[i][0], modes[j], alphas[k], fast);
+            SDLTest_AssertCheck(ret == 0, "Validate drawing on %s, expected: 0, got: %i",
+                                SDL_GetPixelFormatName(formats[i][0]), ret);
+            ret = _drawBlendSpans(formats[i][1], modes[j], alphas[k], reference);
+            SDLTest_AssertCheck(ret == 0, "Validate drawing on %s, expected: 0, got: %i",
+                                SDL_GetPixelFormatName(formats[i][1]), ret);
+            ret = SDL_memcmp(fast, reference, 64 * 48 * sizeof(Uint32));
+            SDLTest_AssertCheck(ret == 0, "Verify %s matches %s with blend mode %d and alpha %d",
+                                SDL_GetPixelFormatName(formats[i][0]),
+                                SDL_GetPixelFormatName(formats[i][1]),
+                                (int)modes[j], (int)alphas[k]);
+         }
+      }
+   }
+
+   SDL_free(fast);
+   SDL_free(reference);
+   return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Render test cases */
@@ -1037,9 +2904,45 @@ static const SDLTest_TestCaseReference renderTest6 =
 static const SDLTest_TestCaseReference renderTest7 =
         {  (SDLTest_TestCaseFp)render_testBlitBlend, "render_testBlitBlend", "Tests blitting with blending", TEST_DISABLED };
 
+static const SDLTest_TestCaseReference renderTest8 =
+        { (SDLTest_TestCaseFp)render_testBatching, "render_testBatching", "Tests that batched rendering matches immediate rendering", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest9 =
+        { (SDLTest_TestCaseFp)render_testCopyMany, "render_testCopyMany", "Tests drawing many copies in one call", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest10 =
+        { (SDLTest_TestCaseFp)render_testTextureAtlas, "render_testTextureAtlas", "Tests packing textures into an atlas", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest11 =
+        { (SDLTest_TestCaseFp)render_testStreamingTexture, "render_testStreamingTexture", "Tests partial and multi-buffered streaming texture updates", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest12 =
+        { (SDLTest_TestCaseFp)render_testSoftwareThreads, "render_testSoftwareThreads", "Tests that threaded software rendering matches serial rendering", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest13 =
+        { (SDLTest_TestCaseFp)render_testCopyEx, "render_testCopyEx", "Tests rotated and flipped copies", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest14 =
+        { (SDLTest_TestCaseFp)render_testRenderStats, "render_testRenderStats", "Tests counting the work sent to the renderer backends", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest15 =
+        { (SDLTest_TestCaseFp)render_testYUVConversion, "render_testYUVConversion", "Tests converting YUV textures in each colorspace and range", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest16 =
+        { (SDLTest_TestCaseFp)render_testUpdateYUVTexture, "render_testUpdateYUVTexture", "Tests updating planar YUV textures from separate planes", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest17 =
+        { (SDLTest_TestCaseFp)render_testReadPixelsAsync, "render_testReadPixelsAsync", "Tests reading pixels asynchronously", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest18 =
+        { (SDLTest_TestCaseFp)render_testDistanceField, "render_testDistanceField", "Tests drawing distance field textures at different scales", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest19 =
+        { (SDLTest_TestCaseFp)render_testBlendSpans, "render_testBlendSpans", "Tests vectorized blended fills against the per pixel code", TEST_ENABLED };
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] =  {
-    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, NULL
+    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, &renderTest8, &renderTest9, &renderTest10, &renderTest11, &renderTest12, &renderTest13, &renderTest14, &renderTest15, &renderTest16, &renderTest17, &renderTest18, &renderTest19, NULL
 };
 
 /* Render test suite (global) */
@@ -334,6 +334,239 @@ rwops_testFileRead(void)
    return TEST_COMPLETED;
 }
 
+/**
+ * @brief Tests reading from a memory-mapped file.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWFromMappedFile
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWClose
+ */
+int
+rwops_testMappedFileRead(void)
+{
+   SDL_RWops *rw;
+   int result;
+
+   /* Read test. */
+   rw = SDL_RWFromMappedFile(RWopsReadTestFilename);
+   SDLTest_AssertPass("Call to SDL_RWFromMappedFile() succeeded");
+   SDLTest_AssertCheck(rw != NULL, "Verify opening file with SDL_RWFromMappedFile does not return NULL");
+
+   /* Bail out if NULL */
+   if (rw == NULL) return TEST_ABORTED;
+
+   /* Check type */
+#if defined(HAVE_MMAP) && !defined(ANDROID)
+   SDLTest_AssertCheck(
+      rw->type == SDL_RWOPS_MAPPED,
+      "Verify RWops type is SDL_RWOPS_MAPPED; expected: %d, got: %d", SDL_RWOPS_MAPPED, rw->type);
+#endif
+
+   /* Run generic tests */
+   _testGenericRWopsValidations( rw, 0 );
+
+   /* Close handle */
+   result = SDL_RWclose(rw);
+   SDLTest_AssertPass("Call to SDL_RWclose() succeeded");
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+
+   /* Missing files fail like SDL_RWFromFile() */
+   rw = SDL_RWFromMappedFile("!!this file doesn't exist!!");
+   SDLTest_AssertPass("Call to SDL_RWFromMappedFile() with a missing file succeeded");
+   SDLTest_AssertCheck(rw == NULL, "Verify opening a missing file returns NULL");
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests getting the memory behind memory and file RWops.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWGetBuffer
+ */
+int
+rwops_testGetBuffer(void)
+{
+   char mem[sizeof(RWopsHelloWorldTestString)];
+   SDL_RWops *rw;
+   const char *data;
+   size_t size;
+   Sint64 i;
+
+   /* Memory: the buffer follows the read position */
+   rw = SDL_RWFromConstMem(RWopsHelloWorldCompString, sizeof(RWopsHelloWorldCompString) - 1);
+   SDLTest_AssertCheck(rw != NULL, "Verify opening memory with SDL_RWFromConstMem does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   data = (const char *)SDL_RWGetBuffer(rw, &size);
+   SDLTest_AssertPass("Call to SDL_RWGetBuffer() succeeded");
+   SDLTest_AssertCheck(data == RWopsHelloWorldCompString, "Verify buffer is the memory; expected: %p, got: %p", RWopsHelloWorldCompString, data);
+   SDLTest_AssertCheck(size == sizeof(RWopsHelloWorldCompString) - 1, "Verify size; expected: %d, got: %d", (int) sizeof(RWopsHelloWorldCompString) - 1, (int) size);
+   i = SDL_RWseek(rw, 6, RW_SEEK_SET);
+   SDLTest_AssertCheck(i == 6, "Verify seek to 6 with SDL_RWseek (RW_SEEK_SET), expected 6, got %i", (int) i);
+   data = (const char *)SDL_RWGetBuffer(rw, &size);
+   SDLTest_AssertCheck(data == RWopsHelloWorldCompString + 6, "Verify buffer follows the position; expected: %p, got: %p", RWopsHelloWorldCompString + 6, data);
+   SDLTest_AssertCheck(size == sizeof(RWopsHelloWorldCompString) - 7, "Verify size; expected: %d, got: %d", (int) sizeof(RWopsHelloWorldCompString) - 7, (int) size);
+   SDL_RWclose(rw);
+
+   /* A mapped file has the file's contents */
+   rw = SDL_RWFromMappedFile(RWopsReadTestFilename);
+   SDLTest_AssertCheck(rw != NULL, "Verify opening file with SDL_RWFromMappedFile does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   data = (const char *)SDL_RWGetBuffer(rw, &size);
+   if (rw->type == SDL_RWOPS_MAPPED) {
+      SDLTest_AssertCheck(data != NULL, "Verify buffer of a mapped file is not NULL");
+      SDLTest_AssertCheck(size == sizeof(RWopsHelloWorldTestString) - 1, "Verify size; expected: %d, got: %d", (int) sizeof(RWopsHelloWorldTestString) - 1, (int) size);
+      if (data != NULL) {
+         SDLTest_AssertCheck(SDL_strncmp(data, RWopsHelloWorldTestString, sizeof(RWopsHelloWorldTestString) - 1) == 0, "Verify buffer holds the file's contents");
+      }
+   }
+   SDL_RWclose(rw);
+
+   /* Writable memory and files without a mapping */
+   rw = SDL_RWFromMem(mem, sizeof(mem));
+   SDLTest_AssertCheck(rw != NULL, "Verify opening memory with SDL_RWFromMem does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   data = (const char *)SDL_RWGetBuffer(rw, NULL);
+   SDLTest_AssertCheck(data == mem, "Verify buffer is the memory; expected: %p, got: %p", mem, data);
+   SDL_RWclose(rw);
+
+   rw = SDL_RWFromFile(RWopsReadTestFilename, "r");
+   SDLTest_AssertCheck(rw != NULL, "Verify opening file with SDL_RWFromFile does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   size = 1;
+   data = (const char *)SDL_RWGetBuffer(rw, &size);
+   SDLTest_AssertCheck(data == NULL, "Verify buffer of a stdio file is NULL");
+   SDLTest_AssertCheck(size == 0, "Verify size is 0; got: %d", (int) size);
+   SDL_RWclose(rw);
+
+   return TEST_COMPLETED;
+}
+
+/* Checks reading and seeking a buffered RWops over the given source */
+static void
+_testBufferedRWops(SDL_RWops *src, const Uint8 *data, int size)
+{
+   SDL_RWops *rw;
+   Uint8 buf[6000];
+   Uint32 expected, value;
+   Sint64 i;
+   size_t s;
+   int c, n, mismatches;
+
+   /* Start one byte in, to check the buffer starts at the source's position */
+   i = SDL_RWseek(src, 1, RW_SEEK_SET);
+   SDLTest_AssertCheck(i == 1, "Verify seek of source to 1, expected 1, got %i", (int) i);
+   rw = SDL_RWFromBufferedRW(src, 0);
+   SDLTest_AssertPass("Call to SDL_RWFromBufferedRW() succeeded");
+   SDLTest_AssertCheck(rw != NULL, "Verify result of SDL_RWFromBufferedRW is not NULL");
+   if (rw == NULL) return;
+   SDLTest_AssertCheck(rw->type == SDL_RWOPS_BUFFERED, "Verify RWops type is SDL_RWOPS_BUFFERED; expected: %d, got: %d", SDL_RWOPS_BUFFERED, rw->type);
+   i = SDL_RWtell(rw);
+   SDLTest_AssertCheck(i == 1, "Verify position is 1, got %i", (int) i);
+
+   /* Byte at a time, across several refills */
+   mismatches = 0;
+   for (n = 1; n < 5001; ++n) {
+      c = SDL_RWgetc(rw);
+      if (c != data[n]) {
+         ++mismatches;
+      }
+   }
+   SDLTest_AssertCheck(mismatches == 0, "Verify bytes read with SDL_RWgetc, got %i mismatches", mismatches);
+   i = SDL_RWtell(rw);
+   SDLTest_AssertCheck(i == 5001, "Verify position is 5001, got %i", (int) i);
+
+   value = SDL_RWgetBE32(rw);
+   expected = ((Uint32) data[5001] << 24) | ((Uint32) data[5002] << 16) | ((Uint32) data[5003] << 8) | data[5004];
+   SDLTest_AssertCheck(value == expected, "Verify SDL_RWgetBE32, expected 0x%08x, got 0x%08x", expected, value);
+   value = SDL_RWgetLE16(rw);
+   expected = data[5005] | (data[5006] << 8);
+   SDLTest_AssertCheck(value == expected, "Verify SDL_RWgetLE16, expected 0x%04x, got 0x%04x", expected, value);
+
+   /* Seeking near by stays in the buffer, further away reads the source */
+   i = SDL_RWseek(rw, -10, RW_SEEK_CUR);
+   SDLTest_AssertCheck(i == 4997, "Verify seek to 4997 with SDL_RWseek (RW_SEEK_CUR), expected 4997, got %i", (int) i);
+   c = SDL_RWgetc(rw);
+   SDLTest_AssertCheck(c == data[4997], "Verify byte after seek, expected %i, got %i", data[4997], c);
+   i = SDL_RWseek(rw, 100, RW_SEEK_SET);
+   SDLTest_AssertCheck(i == 100, "Verify seek to 100 with SDL_RWseek (RW_SEEK_SET), expected 100, got %i", (int) i);
+   c = SDL_RWgetc(rw);
+   SDLTest_AssertCheck(c == data[100], "Verify byte after seek, expected %i, got %i", data[100], c);
+
+   /* Big reads, and reading past the end */
+   s = SDL_RWread(rw, buf, 1, sizeof(buf));
+   SDLTest_AssertCheck(s == sizeof(buf), "Verify result from SDL_RWread, expected %i, got %i", (int) sizeof(buf), (int) s);
+   SDLTest_AssertCheck(SDL_memcmp(buf, &data[101], sizeof(buf)) == 0, "Verify read bytes match");
+   s = SDL_RWread(rw, buf, 1, sizeof(buf));
+   SDLTest_AssertCheck(s == (size_t) (size - 6101), "Verify result from SDL_RWread at end, expected %i, got %i", size - 6101, (int) s);
+   c = SDL_RWgetc(rw);
+   SDLTest_AssertCheck(c == -1, "Verify SDL_RWgetc at end of file, expected -1, got %i", c);
+   i = SDL_RWseek(rw, -4, RW_SEEK_END);
+   SDLTest_AssertCheck(i == size - 4, "Verify seek to -4 with SDL_RWseek (RW_SEEK_END), expected %i, got %i", size - 4, (int) i);
+   value = SDL_RWgetLE32(rw);
+   expected = data[size - 4] | (data[size - 3] << 8) | ((Uint32) data[size - 2] << 16) | ((Uint32) data[size - 1] << 24);
+   SDLTest_AssertCheck(value == expected, "Verify SDL_RWgetLE32, expected 0x%08x, got 0x%08x", expected, value);
+
+   /* Closing leaves the source where reading stopped */
+   i = SDL_RWseek(rw, 20, RW_SEEK_SET);
+   SDLTest_AssertCheck(i == 20, "Verify seek to 20 with SDL_RWseek (RW_SEEK_SET), expected 20, got %i", (int) i);
+   SDL_RWclose(rw);
+   i = SDL_RWtell(src);
+   SDLTest_AssertCheck(i == 20, "Verify position of source after close, expected 20, got %i", (int) i);
+   c = SDL_ReadU8(src);
+   SDLTest_AssertCheck(c == data[20], "Verify byte read from source, expected %i, got %i", data[20], c);
+}
+
+/**
+ * @brief Tests reading through a buffered RWops.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWFromBufferedRW
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWClose
+ */
+int
+rwops_testBufferedRead(void)
+{
+   static Uint8 data[10000];
+   SDL_RWops *rw;
+   size_t s;
+   int n;
+
+   for (n = 0; n < sizeof(data); ++n) {
+      data[n] = (Uint8) (n * 7 % 251);
+   }
+   rw = SDL_RWFromFile(RWopsWriteTestFilename, "wb");
+   SDLTest_AssertCheck(rw != NULL, "Verify opening file with SDL_RWFromFile in write mode does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   s = SDL_RWwrite(rw, data, 1, sizeof(data));
+   SDLTest_AssertCheck(s == sizeof(data), "Verify result from SDL_RWwrite, expected %i, got %i", (int) sizeof(data), (int) s);
+   SDL_RWclose(rw);
+
+   /* Over a file, reading ahead into a buffer */
+   rw = SDL_RWFromFile(RWopsWriteTestFilename, "rb");
+   SDLTest_AssertCheck(rw != NULL, "Verify opening file with SDL_RWFromFile does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   _testBufferedRWops(rw, data, sizeof(data));
+   SDL_RWclose(rw);
+
+   /* Over memory, which is read in place */
+   rw = SDL_RWFromConstMem(data, sizeof(data));
+   SDLTest_AssertCheck(rw != NULL, "Verify opening memory with SDL_RWFromConstMem does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   _testBufferedRWops(rw, data, sizeof(data));
+   SDL_RWclose(rw);
+
+   /* Closing the source along with it */
+   rw = SDL_RWFromBufferedRW(SDL_RWFromFile(RWopsReadTestFilename, "rb"), 1);
+   SDLTest_AssertCheck(rw != NULL, "Verify result of SDL_RWFromBufferedRW is not NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   _testGenericRWopsValidations(rw, 0);
+   n = SDL_RWclose(rw);
+   SDLTest_AssertCheck(n == 0, "Verify result value is 0; got: %d", n);
+
+   return TEST_COMPLETED;
+}
+
 /**
  * @brief Tests writing from file.
  *
@@ -733,10 +966,20 @@ static const SDLTest_TestCaseReference rwopsTest9 =
 static const SDLTest_TestCaseReference rwopsTest10 =
         { (SDLTest_TestCaseFp)rwops_testCompareRWFromMemWithRWFromFile, "rwops_testCompareRWFromMemWithRWFromFile", "Compare RWFromMem and RWFromFile RWops for read and seek", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference rwopsTest11 =
+        { (SDLTest_TestCaseFp)rwops_testMappedFileRead, "rwops_testMappedFileRead", "Tests reading from a memory-mapped file", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference rwopsTest12 =
+        { (SDLTest_TestCaseFp)rwops_testGetBuffer, "rwops_testGetBuffer", "Tests getting the memory behind a RWops", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference rwopsTest13 =
+        { (SDLTest_TestCaseFp)rwops_testBufferedRead, "rwops_testBufferedRead", "Tests reading through a buffered RWops", TEST_ENABLED };
+
 /* Sequence of RWops test cases */
 static const SDLTest_TestCaseReference *rwopsTests[] =  {
     &rwopsTest1, &rwopsTest2, &rwopsTest3, &rwopsTest4, &rwopsTest5, &rwopsTest6,
-    &rwopsTest7, &rwopsTest8, &rwopsTest9, &rwopsTest10, NULL
+    &rwopsTest7, &rwopsTest8, &rwopsTest9, &rwopsTest10, &rwopsTest11,
+    &rwopsTest12, &rwopsTest13, NULL
 };
 
 /* RWops test suite (global) */
@@ -581,6 +581,259 @@ surface_testBlitBlendLoop(void *arg) {
 
 }
 
+/**
+ * @brief Tests RLE accelerated blits against plain blits of the same sprite,
+ * including colour modulated and scaled blits, and updates of the RLE
+ * encoding through SDL_LockSurfaceRect().
+ */
+int
+surface_testBlitRLE(void *arg)
+{
+    SDL_Surface *face, *sprite, *spriteRLE, *dst, *dstRLE;
+    SDL_Rect rect, rectRLE, changed;
+    Uint32 key;
+    int ret, i, x, y;
+    struct {
+        int x, y, w, h;
+        Uint8 r, g, b, a;
+        SDL_BlendMode blendMode;
+    } blits[] = {
+        { 8, 8, 0, 0, 255, 255, 255, 255, SDL_BLENDMODE_NONE },
+        { -20, 200, 0, 0, 255, 255, 255, 255, SDL_BLENDMODE_NONE },
+        { 16, 4, 0, 0, 255, 128, 64, 255, SDL_BLENDMODE_NONE },
+        { 40, 60, 0, 0, 200, 100, 255, 128, SDL_BLENDMODE_BLEND },
+        { 0, 0, 311, 197, 255, 255, 255, 255, SDL_BLENDMODE_NONE },
+        { 100, 20, 57, 43, 255, 255, 255, 255, SDL_BLENDMODE_NONE },
+        { -30, 90, 250, 180, 64, 255, 128, 255, SDL_BLENDMODE_NONE },
+        { 120, 10, 90, 300, 255, 200, 200, 96, SDL_BLENDMODE_BLEND },
+    };
+
+    /* Create sample surfaces */
+    face = SDLTest_ImageFace();
+    SDLTest_AssertCheck(face != NULL, "Verify face surface is not NULL");
+    if (face == NULL)
+        return TEST_ABORTED;
+    sprite = SDL_ConvertSurfaceFormat(face, SDL_PIXELFORMAT_RGB888, 0);
+    spriteRLE = SDL_ConvertSurfaceFormat(face, SDL_PIXELFORMAT_RGB888, 0);
+    dst = SDL_CreateRGBSurface(0, 320, 240, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+    dstRLE = SDL_CreateRGBSurface(0, 320, 240, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+    SDL_FreeSurface(face);
+    SDLTest_AssertCheck(sprite && spriteRLE && dst && dstRLE, "Verify surfaces are not NULL");
+    if (!sprite || !spriteRLE || !dst || !dstRLE)
+        return TEST_ABORTED;
+
+    /* Use the pixel at (0,0) as the colorkey */
+    key = *(Uint32 *) sprite->pixels;
+    ret = SDL_SetColorKey(sprite, SDL_TRUE, key);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SetColorKey, expected: 0, got: %i", ret);
+    ret = SDL_SetColorKey(spriteRLE, SDL_TRUE, key);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SetColorKey, expected: 0, got: %i", ret);
+    ret = SDL_SetSurfaceRLE(spriteRLE, 1);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SetSurfaceRLE, expected: 0, got: %i", ret);
+
+    SDL_FillRect(dst, NULL, SDL_MapRGB(dst->format, 30, 90, 150));
+    SDL_FillRect(dstRLE, NULL, SDL_MapRGB(dstRLE->format, 30, 90, 150));
+
+    for (i = 0; i < SDL_arraysize(blits); ++i) {
+        if (i == 5) {
+            /* Change part of the sprite, the RLE encoding has to follow */
+            changed.x = 5;
+            changed.y = 10;
+            changed.w = 20;
+            changed.h = 7;
+            ret = SDL_LockSurfaceRect(spriteRLE, &changed);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_LockSurfaceRect, expected: 0, got: %i", ret);
+            for (y = changed.y; y < changed.y + changed.h; ++y) {
+                for (x = changed.x; x < changed.x + changed.w; ++x) {
+                    Uint32 pixel = (x & 1) ? key : 0x00FF8040;
+                    ((Uint32 *) ((Uint8 *) sprite->pixels + y * sprite->pitch))[x] = pixel;
+                    ((Uint32 *) ((Uint8 *) spriteRLE->pixels + y * spriteRLE->pitch))[x] = pixel;
+                }
+            }
+            SDL_UnlockSurface(spriteRLE);
+            SDLTest_AssertCheck((spriteRLE->flags & SDL_RLEACCEL) != 0, "Verify surface is still RLE accelerated after unlock");
+
+            /* Fills go through the same path */
+            changed.y = 30;
+            SDL_FillRect(sprite, &changed, key);
+            SDL_FillRect(spriteRLE, &changed, key);
+        }
+
+        SDL_SetSurfaceColorMod(sprite, blits[i].r, blits[i].g, blits[i].b);
+        SDL_SetSurfaceColorMod(spriteRLE, blits[i].r, blits[i].g, blits[i].b);
+        SDL_SetSurfaceAlphaMod(sprite, blits[i].a);
+        SDL_SetSurfaceAlphaMod(spriteRLE, blits[i].a);
+        SDL_SetSurfaceBlendMode(sprite, blits[i].blendMode);
+        SDL_SetSurfaceBlendMode(spriteRLE, blits[i].blendMode);
+
+        rect.x = rectRLE.x = blits[i].x;
+        rect.y = rectRLE.y = blits[i].y;
+        if (blits[i].w) {
+            rect.w = rectRLE.w = blits[i].w;
+            rect.h = rectRLE.h = blits[i].h;
+            ret = SDL_BlitScaled(sprite, NULL, dst, &rect);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitScaled, expected: 0, got: %i", ret);
+            ret = SDL_BlitScaled(spriteRLE, NULL, dstRLE, &rectRLE);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitScaled, expected: 0, got: %i", ret);
+        } else {
+            ret = SDL_BlitSurface(sprite, NULL, dst, &rect);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+            ret = SDL_BlitSurface(spriteRLE, NULL, dstRLE, &rectRLE);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+        }
+        SDLTest_AssertCheck((spriteRLE->flags & SDL_RLEACCEL) != 0, "Verify blit %d used RLE acceleration", i);
+
+        /* Blending may round differently, allow 1 per channel */
+        ret = SDLTest_CompareSurfaces(dstRLE, dst, 3);
+        SDLTest_AssertCheck(ret == 0, "Validate result of blit %d from SDLTest_CompareSurfaces, expected: 0, got: %i", i, ret);
+    }
+
+    /* Clean up. */
+    SDL_FreeSurface(sprite);
+    SDL_FreeSurface(spriteRLE);
+    SDL_FreeSurface(dst);
+    SDL_FreeSurface(dstRLE);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests RLE accelerated blits of a sprite with translucent pixels
+ * against plain blits, onto targets with and without an alpha channel.
+ */
+int
+surface_testBlitRLEAlpha(void *arg)
+{
+    SDL_Surface *sprite, *spriteRLE, *dst, *dstRLE;
+    SDL_Rect rect;
+    Uint32 amasks[] = { 0xFF000000, 0 };
+    int ret, i, x, y;
+
+    sprite = SDL_CreateRGBSurface(0, 64, 32, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    spriteRLE = SDL_CreateRGBSurface(0, 64, 32, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    SDLTest_AssertCheck(sprite && spriteRLE, "Verify surfaces are not NULL");
+    if (!sprite || !spriteRLE)
+        return TEST_ABORTED;
+
+    /* Transparent, translucent and opaque pixels along each line */
+    for (y = 0; y < sprite->h; ++y) {
+        for (x = 0; x < sprite->w; ++x) {
+            Uint32 alpha = (x < 8) ? 0 : (x >= 56) ? 255 : (Uint32) ((x - 8) * 255 / 48);
+            Uint32 pixel = (alpha << 24) | ((Uint32) (y * 8) << 16) | 0x0000C040;
+            ((Uint32 *) ((Uint8 *) sprite->pixels + y * sprite->pitch))[x] = pixel;
+            ((Uint32 *) ((Uint8 *) spriteRLE->pixels + y * spriteRLE->pitch))[x] = pixel;
+        }
+    }
+    SDL_SetSurfaceBlendMode(sprite, SDL_BLENDMODE_BLEND);
+    SDL_SetSurfaceBlendMode(spriteRLE, SDL_BLENDMODE_BLEND);
+    ret = SDL_SetSurfaceRLE(spriteRLE, 1);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SetSurfaceRLE, expected: 0, got: %i", ret);
+
+    for (i = 0; i < SDL_arraysize(amasks); ++i) {
+        dst = SDL_CreateRGBSurface(0, 80, 48, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, amasks[i]);
+        dstRLE = SDL_CreateRGBSurface(0, 80, 48, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, amasks[i]);
+        SDLTest_AssertCheck(dst && dstRLE, "Verify surfaces are not NULL");
+        if (!dst || !dstRLE)
+            return TEST_ABORTED;
+        SDL_FillRect(dst, NULL, SDL_MapRGB(dst->format, 30, 90, 150));
+        SDL_FillRect(dstRLE, NULL, SDL_MapRGB(dstRLE->format, 30, 90, 150));
+
+        rect.x = 7;
+        rect.y = 9;
+        ret = SDL_BlitSurface(sprite, NULL, dst, &rect);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+        rect.x = 7;
+        rect.y = 9;
+        ret = SDL_BlitSurface(spriteRLE, NULL, dstRLE, &rect);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+        SDLTest_AssertCheck((spriteRLE->flags & SDL_RLEACCEL) != 0, "Verify blit %d used RLE acceleration", i);
+
+        /* The RLE blender divides by 256, allow 2 per channel */
+        ret = SDLTest_CompareSurfaces(dstRLE, dst, 12);
+        SDLTest_AssertCheck(ret == 0, "Validate result of blit %d from SDLTest_CompareSurfaces, expected: 0, got: %i", i, ret);
+
+        SDL_FreeSurface(dst);
+        SDL_FreeSurface(dstRLE);
+    }
+
+    /* Clean up. */
+    SDL_FreeSurface(sprite);
+    SDL_FreeSurface(spriteRLE);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests SDL_FillRects() with overlapping rectangles against filling
+ * them one at a time, at every pixel size.
+ */
+int
+surface_testFillRects(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_INDEX8, SDL_PIXELFORMAT_RGB565,
+        SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_ARGB8888
+    };
+    SDL_Rect rects[] = {
+        { -10, -5, 100, 20 }, { 30, 10, 200, 30 }, { 31, 12, 5, 5 },
+        { 230, 10, 70, 1 }, { 0, 45, 301, 10 }, { 150, 0, 3, 50 },
+        { 230, 11, 0, 10 }, { 97, 3, 180, 14 }
+    };
+    SDL_Rect clip = { 1, 2, 290, 45 };
+    SDL_Surface *surface, *reference, *converted;
+    Uint32 Rmask, Gmask, Bmask, Amask, color;
+    int bpp, ret, i, j, y;
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        SDL_PixelFormatEnumToMasks(formats[i], &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+        surface = SDL_CreateRGBSurface(0, 300, 50, bpp, Rmask, Gmask, Bmask, Amask);
+        reference = SDL_CreateRGBSurface(0, 300, 50, bpp, Rmask, Gmask, Bmask, Amask);
+        SDLTest_AssertCheck(surface && reference, "Verify surfaces are not NULL");
+        if (!surface || !reference)
+            return TEST_ABORTED;
+        SDL_SetClipRect(surface, &clip);
+        SDL_SetClipRect(reference, &clip);
+
+        color = SDL_MapRGB(surface->format, 10, 20, 30);
+        ret = SDL_FillRects(surface, rects, SDL_arraysize(rects), color);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRects, expected: 0, got: %i", ret);
+        for (j = 0; j < SDL_arraysize(rects); ++j) {
+            SDL_FillRect(reference, &rects[j], color);
+        }
+
+        ret = 0;
+        for (y = 0; y < surface->h; ++y) {
+            if (SDL_memcmp((Uint8 *)surface->pixels + y * surface->pitch,
+                           (Uint8 *)reference->pixels + y * reference->pitch,
+                           surface->w * surface->format->BytesPerPixel) != 0) {
+                ++ret;
+            }
+        }
+        SDLTest_AssertCheck(ret == 0, "Verify %s rows match filling one rect at a time, expected: 0, got: %i",
+                            SDL_GetPixelFormatName(formats[i]), ret);
+
+        /* The color has to land in the right bytes of the pixel */
+        if (!SDL_ISPIXELFORMAT_INDEXED(formats[i])) {
+            converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+            SDLTest_AssertCheck(converted != NULL, "Verify converted surface is not NULL");
+            if (converted) {
+                Uint32 pixel = *(Uint32 *)((Uint8 *)converted->pixels + 20 * converted->pitch + 40 * 4);
+                Uint8 r, g, b;
+                SDL_GetRGB(pixel, converted->format, &r, &g, &b);
+                SDLTest_AssertCheck(SDL_abs(r - 10) <= 8 && SDL_abs(g - 20) <= 4 && SDL_abs(b - 30) <= 8,
+                                    "Verify %s filled color, expected: (10,20,30), got: (%d,%d,%d)",
+                                    SDL_GetPixelFormatName(formats[i]), r, g, b);
+                SDL_FreeSurface(converted);
+            }
+        }
+
+        SDL_FreeSurface(surface);
+        SDL_FreeSurface(reference);
+    }
+
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Surface test cases */
@@ -623,11 +876,21 @@ static const SDLTest_TestCaseReference surfaceTest11 =
 static const SDLTest_TestCaseReference surfaceTest12 =
         { (SDLTest_TestCaseFp)surface_testBlitBlendMod, "surface_testBlitBlendMod", "Tests blitting routines with mod blending mode.", TEST_ENABLED};
 
+static const SDLTest_TestCaseReference surfaceTest13 =
+        { (SDLTest_TestCaseFp)surface_testBlitRLE, "surface_testBlitRLE", "Tests RLE accelerated blits against plain blits.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest14 =
+        { (SDLTest_TestCaseFp)surface_testBlitRLEAlpha, "surface_testBlitRLEAlpha", "Tests RLE accelerated blits of translucent pixels.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest15 =
+        { (SDLTest_TestCaseFp)surface_testFillRects, "surface_testFillRects", "Tests filling overlapping rectangles in one call.", TEST_ENABLED};
+
 /* Sequence of Surface test cases */
 static const SDLTest_TestCaseReference *surfaceTests[] =  {
     &surfaceTest1, &surfaceTest2, &surfaceTest3, &surfaceTest4, &surfaceTest5,
     &surfaceTest6, &surfaceTest7, &surfaceTest8, &surfaceTest9, &surfaceTest10,
-    &surfaceTest11, &surfaceTest12, NULL
+    &surfaceTest11, &surfaceTest12, &surfaceTest13, &surfaceTest14,
+    &surfaceTest15, NULL
 };
 
 /* Surface test suite (global) */
@@ -1723,6 +1723,134 @@ video_getSetWindowData(void *arg)
 }
 
 
+/**
+ * @brief Tests the modified regions tracked on the window surface
+ *
+ * @sa http://wiki.libsdl.org/moin.fcg/SDL_GetWindowSurfaceDirtyRects
+ * @sa http://wiki.libsdl.org/moin.fcg/SDL_UpdateWindowSurface
+ */
+int
+video_getWindowSurfaceDirtyRects(void *arg)
+{
+  const char* title = "video_getWindowSurfaceDirtyRects Test Window";
+  SDL_Window* window;
+  SDL_Surface* surface;
+  SDL_Rect rects[64];
+  SDL_Rect rect;
+  int count, result, w, h;
+
+  SDL_SetHint(SDL_HINT_FRAMEBUFFER_DIRTY_RECTS, "1");
+  window = _createVideoSuiteTestWindow(title);
+  if (window == NULL) {
+    SDL_SetHint(SDL_HINT_FRAMEBUFFER_DIRTY_RECTS, "0");
+    return TEST_ABORTED;
+  }
+  SDL_GetWindowSize(window, &w, &h);
+
+  surface = SDL_GetWindowSurface(window);
+  SDLTest_AssertPass("Call to SDL_GetWindowSurface()");
+  SDLTest_AssertCheck(surface != NULL, "Validate that returned surface is not NULL");
+  if (surface == NULL) {
+    _destroyVideoSuiteTestWindow(window);
+    SDL_SetHint(SDL_HINT_FRAMEBUFFER_DIRTY_RECTS, "0");
+    return TEST_ABORTED;
+  }
+  SDLTest_AssertCheck((surface->flags & SDL_TRACKDIRTY) != 0, "Validate that the surface tracks modified regions");
+
+  /* A new surface has never been shown, so all of it is modified */
+  count = SDL_GetWindowSurfaceDirtyRects(window, rects, SDL_arraysize(rects));
+  SDLTest_AssertPass("Call to SDL_GetWindowSurfaceDirtyRects()");
+  SDLTest_AssertCheck(count == 1, "Verify number of regions, expected: 1, got: %i", count);
+  SDLTest_AssertCheck(count < 1 || (rects[0].x == 0 && rects[0].y == 0 && rects[0].w == w && rects[0].h == h),
+                      "Verify the region covers the whole %ix%i surface, got: %i,%i %ix%i", w, h,
+                      rects[0].x, rects[0].y, rects[0].w, rects[0].h);
+
+  /* Nothing is left after an update */
+  result = SDL_UpdateWindowSurface(window);
+  SDLTest_AssertPass("Call to SDL_UpdateWindowSurface()");
+  SDLTest_AssertCheck(result == 0, "Verify return value, expected: 0, got: %i", result);
+  count = SDL_GetWindowSurfaceDirtyRects(window, NULL, 0);
+  SDLTest_AssertCheck(count == 0, "Verify number of regions after update, expected: 0, got: %i", count);
+
+  /* Overlapping fills, and small ones close to each other, are merged */
+  rect.x = 10; rect.y = 10; rect.w = 20; rect.h = 20;
+  SDL_FillRect(surface, &rect, 0);
+  rect.x = 20; rect.y = 20; rect.w = 20; rect.h = 20;
+  SDL_FillRect(surface, &rect, 0);
+  rect.x = 200; rect.y = 100; rect.w = 10; rect.h = 10;
+  SDL_FillRect(surface, &rect, 0);
+  rect.x = 230; rect.y = 100; rect.w = 10; rect.h = 10;
+  SDL_FillRect(surface, &rect, 0);
+  SDLTest_AssertPass("Call to SDL_FillRect() 4 times");
+  count = SDL_GetWindowSurfaceDirtyRects(window, rects, SDL_arraysize(rects));
+  SDLTest_AssertCheck(count == 2, "Verify number of regions, expected: 2, got: %i", count);
+  if (count == 2) {
+    if (rects[0].x != 10) {
+      rect = rects[0];
+      rects[0] = rects[1];
+      rects[1] = rect;
+    }
+    SDLTest_AssertCheck(rects[0].x == 10 && rects[0].y == 10 && rects[0].w == 30 && rects[0].h == 30,
+                        "Verify overlapping fills merged, expected: 10,10 30x30, got: %i,%i %ix%i",
+                        rects[0].x, rects[0].y, rects[0].w, rects[0].h);
+    SDLTest_AssertCheck(rects[1].x == 200 && rects[1].y == 100 && rects[1].w == 40 && rects[1].h == 10,
+                        "Verify neighbouring fills merged, expected: 200,100 40x10, got: %i,%i %ix%i",
+                        rects[1].x, rects[1].y, rects[1].w, rects[1].h);
+  }
+
+  /* Fills far apart are kept apart, and at most 'maxrects' are returned */
+  rect.x = w - 20; rect.y = h - 20; rect.w = 10; rect.h = 10;
+  SDL_FillRect(surface, &rect, 0);
+  count = SDL_GetWindowSurfaceDirtyRects(window, rects, 1);
+  SDLTest_AssertCheck(count == 3, "Verify number of regions, expected: 3, got: %i", count);
+
+  /* Without an array only the number of regions is returned */
+  count = SDL_GetWindowSurfaceDirtyRects(window, NULL, SDL_arraysize(rects));
+  SDLTest_AssertPass("Call to SDL_GetWindowSurfaceDirtyRects() with NULL rects");
+  SDLTest_AssertCheck(count == 3, "Verify number of regions, expected: 3, got: %i", count);
+
+  /* Fills partly outside the surface are clipped to it */
+  SDL_UpdateWindowSurface(window);
+  rect.x = -10; rect.y = -10; rect.w = 30; rect.h = 30;
+  SDL_FillRect(surface, &rect, 0);
+  SDLTest_AssertPass("Call to SDL_FillRect() across the top left corner");
+  count = SDL_GetWindowSurfaceDirtyRects(window, rects, SDL_arraysize(rects));
+  SDLTest_AssertCheck(count == 1, "Verify number of regions, expected: 1, got: %i", count);
+  SDLTest_AssertCheck(count < 1 || (rects[0].x == 0 && rects[0].y == 0 && rects[0].w == 20 && rects[0].h == 20),
+                      "Verify clipped region, expected: 0,0 20x20, got: %i,%i %ix%i",
+                      rects[0].x, rects[0].y, rects[0].w, rects[0].h);
+
+  /* Showing the window again needs the whole surface, even if unchanged */
+  SDL_UpdateWindowSurface(window);
+  SDL_HideWindow(window);
+  SDL_ShowWindow(window);
+  SDLTest_AssertPass("Call to SDL_HideWindow() and SDL_ShowWindow()");
+  count = SDL_GetWindowSurfaceDirtyRects(window, rects, SDL_arraysize(rects));
+  SDLTest_AssertCheck(count == 1, "Verify number of regions after showing, expected: 1, got: %i", count);
+  SDLTest_AssertCheck(count < 1 || (rects[0].w == w && rects[0].h == h),
+                      "Verify the region covers the whole %ix%i surface, got: %ix%i", w, h,
+                      rects[0].w, rects[0].h);
+
+  _destroyVideoSuiteTestWindow(window);
+
+  /* Without the hint, nothing is tracked */
+  SDL_SetHint(SDL_HINT_FRAMEBUFFER_DIRTY_RECTS, "0");
+  window = _createVideoSuiteTestWindow(title);
+  if (window == NULL) {
+    return TEST_ABORTED;
+  }
+  surface = SDL_GetWindowSurface(window);
+  SDLTest_AssertCheck(surface != NULL && (surface->flags & SDL_TRACKDIRTY) == 0,
+                      "Validate that the surface doesn't track modified regions");
+  count = SDL_GetWindowSurfaceDirtyRects(window, rects, SDL_arraysize(rects));
+  SDLTest_AssertPass("Call to SDL_GetWindowSurfaceDirtyRects()");
+  SDLTest_AssertCheck(count == -1, "Verify return value, expected: -1, got: %i", count);
+  _destroyVideoSuiteTestWindow(window);
+
+  return TEST_COMPLETED;
+}
+
+
 /* ================= Test References ================== */
 
 /* Video test cases */
@@ -1795,13 +1923,16 @@ static const SDLTest_TestCaseReference videoTest22 =
 static const SDLTest_TestCaseReference videoTest23 =
         { (SDLTest_TestCaseFp)video_getSetWindowData, "video_getSetWindowData",  "Checks SDL_SetWindowData and SDL_GetWindowData positive and negative cases", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference videoTest24 =
+        { (SDLTest_TestCaseFp)video_getWindowSurfaceDirtyRects, "video_getWindowSurfaceDirtyRects",  "Checks the modified regions tracked on the window surface", TEST_ENABLED };
+
 /* Sequence of Video test cases */
 static const SDLTest_TestCaseReference *videoTests[] =  {
     &videoTest1, &videoTest2, &videoTest3, &videoTest4, &videoTest5, &videoTest6,
     &videoTest7, &videoTest8, &videoTest9, &videoTest10, &videoTest11, &videoTest12,
     &videoTest13, &videoTest14, &videoTest15, &videoTest16, &videoTest17,
     &videoTest18, &videoTest19, &videoTest20, &videoTest21, &videoTest22,
-    &videoTest23, NULL
+    &videoTest23, &videoTest24, NULL
 };
 
 /* Video test suite (global) */
@@ -0,0 +1,149 @@
+/*
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark SDL_ConvertPixels() over every pair of RGB pixel formats,
+   printing a matrix of throughput in megapixels per second.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+static const Uint32 formats[] = {
+    SDL_PIXELFORMAT_RGB555,
+    SDL_PIXELFORMAT_ARGB1555,
+    SDL_PIXELFORMAT_ARGB4444,
+    SDL_PIXELFORMAT_RGB565,
+    SDL_PIXELFORMAT_BGR565,
+    SDL_PIXELFORMAT_RGB24,
+    SDL_PIXELFORMAT_BGR24,
+    SDL_PIXELFORMAT_RGB888,
+    SDL_PIXELFORMAT_RGBX8888,
+    SDL_PIXELFORMAT_BGR888,
+    SDL_PIXELFORMAT_BGRX8888,
+    SDL_PIXELFORMAT_ARGB8888,
+    SDL_PIXELFORMAT_RGBA8888,
+    SDL_PIXELFORMAT_ABGR8888,
+    SDL_PIXELFORMAT_BGRA8888,
+    SDL_PIXELFORMAT_ARGB2101010
+};
+
+/* Strip the SDL_PIXELFORMAT_ prefix so the matrix fits on screen */
+static const char *
+ShortName(Uint32 format)
+{
+    const char *name = SDL_GetPixelFormatName(format);
+    const char *prefix = "SDL_PIXELFORMAT_";
+
+    if (SDL_strncmp(name, prefix, SDL_strlen(prefix)) == 0) {
+        name += SDL_strlen(prefix);
+    }
+    return name;
+}
+
+int
+main(int argc, char *argv[])
+{
+    const int numformats = SDL_arraysize(formats);
+    int width = 1920;
+    int height = 1080;
+    int iterations = 20;
+    int pitch, i, j, k;
+    Uint8 *src, *dst;
+    Uint64 freq;
+    char line[1024];
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcasecmp(argv[i], "--size") == 0 && i + 2 < argc) {
+            width = SDL_atoi(argv[++i]);
+            height = SDL_atoi(argv[++i]);
+        } else if (SDL_strcasecmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("Usage: %s [--size W H] [--iterations N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (width <= 0 || height <= 0 || iterations <= 0) {
+        SDL_Log("Invalid benchmark parameters\n");
+        return 1;
+    }
+
+    pitch = width * 4;
+    src = (Uint8 *) SDL_malloc(pitch * height);
+    dst = (Uint8 *) SDL_malloc(pitch * height);
+    if (!src || !dst) {
+        SDL_Log("Out of memory\n");
+        return 1;
+    }
+    for (i = 0; i < pitch * height; ++i) {
+        src[i] = (Uint8) rand();
+    }
+
+    freq = SDL_GetPerformanceFrequency();
+
+    SDL_Log("SDL_ConvertPixels %dx%d, %d iterations, megapixels/second\n",
+            width, height, iterations);
+    SDL_Log("Rows are source formats, columns are destination formats\n");
+
+    SDL_snprintf(line, sizeof(line), "%-12s", "");
+    for (j = 0; j < numformats; ++j) {
+        SDL_snprintf(line + SDL_strlen(line), sizeof(line) - SDL_strlen(line),
+                     " %11.11s", ShortName(formats[j]));
+    }
+    SDL_Log("%s\n", line);
+
+    for (i = 0; i < numformats; ++i) {
+        const int src_pitch = width * SDL_BYTESPERPIXEL(formats[i]);
+
+        SDL_snprintf(line, sizeof(line), "%-12.12s", ShortName(formats[i]));
+        for (j = 0; j < numformats; ++j) {
+            const int dst_pitch = width * SDL_BYTESPERPIXEL(formats[j]);
+            Uint64 start, elapsed;
+            double rate;
+
+            /* Warm up caches and any lazily built lookup tables */
+            SDL_ConvertPixels(width, height, formats[i], src, src_pitch,
+                              formats[j], dst, dst_pitch);
+
+            start = SDL_GetPerformanceCounter();
+            for (k = 0; k < iterations; ++k) {
+                if (SDL_ConvertPixels(width, height, formats[i], src, src_pitch,
+                                      formats[j], dst, dst_pitch) < 0) {
+                    break;
+                }
+            }
+            elapsed = SDL_GetPerformanceCounter() - start;
+
+            if (k < iterations) {
+                rate = 0.0;
+            } else {
+                rate = ((double) width * height * iterations) /
+                       ((double) elapsed / freq) / 1000000.0;
+            }
+            SDL_snprintf(line + SDL_strlen(line), sizeof(line) - SDL_strlen(line),
+                         " %11.1f", rate);
+        }
+        SDL_Log("%s\n", line);
+    }
+
+    SDL_free(src);
+    SDL_free(dst);
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,132 @@
+/*
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark SDL_FillRect() and SDL_FillRects() at every pixel size,
+   printing clear throughput in gigabytes per second.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+static const Uint32 formats[] = {
+    SDL_PIXELFORMAT_INDEX8,
+    SDL_PIXELFORMAT_RGB565,
+    SDL_PIXELFORMAT_RGB24,
+    SDL_PIXELFORMAT_ARGB8888
+};
+
+#define NUM_RECTS   256
+
+static double
+Rate(Uint64 bytes, Uint64 elapsed)
+{
+    return ((double) bytes / ((double) elapsed / SDL_GetPerformanceFrequency())) /
+           (1024.0 * 1024.0 * 1024.0);
+}
+
+int
+main(int argc, char *argv[])
+{
+    int width = 3840;
+    int height = 2160;
+    int iterations = 50;
+    SDL_Rect rects[NUM_RECTS];
+    int i, j, k;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcasecmp(argv[i], "--size") == 0 && i + 2 < argc) {
+            width = SDL_atoi(argv[++i]);
+            height = SDL_atoi(argv[++i]);
+        } else if (SDL_strcasecmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("Usage: %s [--size W H] [--iterations N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (width <= 0 || height <= 0 || iterations <= 0) {
+        SDL_Log("Invalid benchmark parameters\n");
+        return 1;
+    }
+
+    /* Overlapping rectangles, like a UI redrawing its widgets */
+    srand(0);
+    for (i = 0; i < NUM_RECTS; ++i) {
+        rects[i].w = 64 + rand() % (width / 4);
+        rects[i].h = 16 + rand() % (height / 8);
+        rects[i].x = rand() % (width - rects[i].w + 1);
+        rects[i].y = rand() % (height - rects[i].h + 1);
+    }
+
+    SDL_Log("Filling %dx%d, %d iterations, gigabytes/second\n",
+            width, height, iterations);
+    SDL_Log("%-10s %12s %12s %12s\n", "Format", "Clear", "FillRect", "FillRects");
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        SDL_Surface *surface;
+        Uint32 Rmask, Gmask, Bmask, Amask;
+        Uint64 start, clear, single, batched, area = 0;
+        int bpp;
+
+        SDL_PixelFormatEnumToMasks(formats[i], &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+        surface = SDL_CreateRGBSurface(0, width, height, bpp, Rmask, Gmask, Bmask, Amask);
+        if (!surface) {
+            SDL_Log("Couldn't create surface: %s\n", SDL_GetError());
+            return 1;
+        }
+        for (j = 0; j < NUM_RECTS; ++j) {
+            area += (Uint64) rects[j].w * rects[j].h;
+        }
+
+        /* Warm up the page tables */
+        SDL_FillRect(surface, NULL, 0);
+
+        start = SDL_GetPerformanceCounter();
+        for (k = 0; k < iterations; ++k) {
+            SDL_FillRect(surface, NULL, k);
+        }
+        clear = SDL_GetPerformanceCounter() - start;
+
+        start = SDL_GetPerformanceCounter();
+        for (k = 0; k < iterations; ++k) {
+            for (j = 0; j < NUM_RECTS; ++j) {
+                SDL_FillRect(surface, &rects[j], k);
+            }
+        }
+        single = SDL_GetPerformanceCounter() - start;
+
+        start = SDL_GetPerformanceCounter();
+        for (k = 0; k < iterations; ++k) {
+            SDL_FillRects(surface, rects, NUM_RECTS, k);
+        }
+        batched = SDL_GetPerformanceCounter() - start;
+
+        /* The rectangle rates count every rectangle, overlaps included */
+        SDL_Log("%-10.10s %12.2f %12.2f %12.2f\n",
+                SDL_GetPixelFormatName(formats[i]) + SDL_strlen("SDL_PIXELFORMAT_"),
+                Rate((Uint64) surface->pitch * height * iterations, clear),
+                Rate(area * surface->format->BytesPerPixel * iterations, single),
+                Rate(area * surface->format->BytesPerPixel * iterations, batched));
+
+        SDL_FreeSurface(surface);
+    }
+
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
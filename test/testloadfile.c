@@ -0,0 +1,196 @@
+/*
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark loading files through SDL_RWFromFile() and through
+   SDL_RWFromMappedFile(), with the file in the page cache (warm) and,
+   where the system lets us drop it from there, read from disk (cold).
+
+   WAVE and BMP files go through SDL_LoadWAV_RW() and SDL_LoadBMP_RW(),
+   any other file is read once from start to end.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#ifdef __LINUX__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* Where ReadBytes() leaves its sums, so the reads can't be optimized away */
+static Uint32 checksum;
+
+/* Drop the file from the page cache, so the next load reads the disk */
+static SDL_bool
+Evict(const char *file)
+{
+#if defined(__LINUX__) && defined(POSIX_FADV_DONTNEED)
+    int fd = open(file, O_RDONLY);
+    int result;
+
+    if (fd < 0) {
+        return SDL_FALSE;
+    }
+    result = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+    return (result == 0);
+#else
+    return SDL_FALSE;
+#endif
+}
+
+/* Read a file through, adding up its bytes so none of it is skipped */
+static Uint32
+ReadBytes(SDL_RWops *src)
+{
+    const Uint8 *data;
+    Uint8 buffer[4096];
+    size_t size, i;
+    Uint32 sum = 0;
+
+    data = (const Uint8 *) SDL_RWGetBuffer(src, &size);
+    if (data) {
+        for (i = 0; i < size; ++i) {
+            sum += data[i];
+        }
+        return sum;
+    }
+    while ((size = SDL_RWread(src, buffer, 1, sizeof(buffer))) > 0) {
+        for (i = 0; i < size; ++i) {
+            sum += buffer[i];
+        }
+    }
+    return sum;
+}
+
+static SDL_bool
+Load(const char *file, SDL_bool mapped)
+{
+    const char *ext = SDL_strrchr(file, '.');
+    SDL_RWops *src;
+
+    src = mapped ? SDL_RWFromMappedFile(file) : SDL_RWFromFile(file, "rb");
+    if (!src) {
+        return SDL_FALSE;
+    }
+    if (ext && SDL_strcasecmp(ext, ".wav") == 0) {
+        SDL_AudioSpec spec;
+        Uint8 *buffer;
+        Uint32 length;
+
+        if (!SDL_LoadWAV_RW(src, 1, &spec, &buffer, &length)) {
+            return SDL_FALSE;
+        }
+        SDL_FreeWAV(buffer);
+    } else if (ext && SDL_strcasecmp(ext, ".bmp") == 0) {
+        SDL_Surface *surface = SDL_LoadBMP_RW(src, 1);
+
+        if (!surface) {
+            return SDL_FALSE;
+        }
+        SDL_FreeSurface(surface);
+    } else {
+        checksum += ReadBytes(src);
+        SDL_RWclose(src);
+    }
+    return SDL_TRUE;
+}
+
+/* Average milliseconds per load, optionally evicting the file first */
+static double
+Time(const char *file, SDL_bool mapped, SDL_bool cold, int iterations)
+{
+    Uint64 elapsed = 0, start;
+    int i;
+
+    for (i = 0; i < iterations; ++i) {
+        if (cold) {
+            Evict(file);
+        }
+        start = SDL_GetPerformanceCounter();
+        if (!Load(file, mapped)) {
+            return -1.0;
+        }
+        elapsed += SDL_GetPerformanceCounter() - start;
+    }
+    return (double) elapsed * 1000.0 / SDL_GetPerformanceFrequency() / iterations;
+}
+
+int
+main(int argc, char *argv[])
+{
+    static const char *default_files[] = { "sample.wav", "sample.bmp" };
+    const char **files = default_files;
+    int num_files = SDL_arraysize(default_files);
+    int iterations = 20;
+    SDL_bool cold;
+    int i, j;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcasecmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = SDL_atoi(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            SDL_Log("Usage: %s [--iterations N] [file ...]\n", argv[0]);
+            return 1;
+        } else {
+            break;
+        }
+    }
+    if (i < argc) {
+        files = (const char **) &argv[i];
+        num_files = argc - i;
+    }
+    if (iterations <= 0) {
+        SDL_Log("Invalid benchmark parameters\n");
+        return 1;
+    }
+
+    cold = Evict(files[0]);
+    if (!cold) {
+        SDL_Log("Can't drop files from the page cache here, only timing warm loads\n");
+    }
+    SDL_Log("Loading %d files, %d iterations, milliseconds per load\n",
+            num_files, iterations);
+    SDL_Log("%-24s %-8s %10s %10s\n", "File", "RWops", "Cold", "Warm");
+
+    for (i = 0; i < num_files; ++i) {
+        for (j = 0; j < 2; ++j) {
+            const SDL_bool mapped = (j == 1);
+            const char *name = SDL_strrchr(files[i], '/');
+            double cold_ms = 0.0, warm_ms;
+
+            name = name ? name + 1 : files[i];
+            if (!Load(files[i], mapped)) {
+                SDL_Log("Couldn't load %s: %s\n", files[i], SDL_GetError());
+                break;
+            }
+            if (cold) {
+                cold_ms = Time(files[i], mapped, SDL_TRUE, iterations);
+            }
+            Load(files[i], mapped);     /* Back into the page cache */
+            warm_ms = Time(files[i], mapped, SDL_FALSE, iterations);
+
+            SDL_Log("%-24.24s %-8s %10.3f %10.3f\n", name,
+                    mapped ? "mapped" : "stdio", cold_ms, warm_ms);
+        }
+    }
+
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
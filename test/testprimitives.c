@@ -0,0 +1,183 @@
+/*
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark the software renderer drawing the random points, lines and
+   rectangles of testdraw2, one call per primitive and batched in a single
+   call, printing thousands of primitives per second.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define NUM_OBJECTS 1000
+
+static SDL_Point points[NUM_OBJECTS * 4];
+static SDL_Point lines[NUM_OBJECTS * 2];
+static SDL_Rect rects[NUM_OBJECTS];
+
+static const SDL_BlendMode modes[] = {
+    SDL_BLENDMODE_NONE,
+    SDL_BLENDMODE_BLEND,
+    SDL_BLENDMODE_ADD,
+    SDL_BLENDMODE_MOD
+};
+
+static const char *mode_names[] = {
+    "none", "blend", "add", "mod"
+};
+
+/* Random objects sized the way testdraw2 makes them */
+static void
+MakeObjects(int width, int height)
+{
+    int i;
+
+    srand(0);
+    for (i = 0; i < SDL_arraysize(points); ++i) {
+        points[i].x = rand() % width;
+        points[i].y = rand() % height;
+    }
+    for (i = 0; i < SDL_arraysize(lines); ++i) {
+        lines[i].x = rand() % width;
+        lines[i].y = rand() % height;
+    }
+    for (i = 0; i < SDL_arraysize(rects); ++i) {
+        rects[i].w = rand() % (height / 2);
+        rects[i].h = rand() % (height / 2);
+        rects[i].x = (rand() % (width * 2) - width) - (rects[i].w / 2);
+        rects[i].y = (rand() % (height * 2) - height) - (rects[i].h / 2);
+    }
+}
+
+static double
+Rate(int count, int iterations, Uint64 elapsed)
+{
+    return ((double) count * iterations) /
+           ((double) elapsed / SDL_GetPerformanceFrequency()) / 1000.0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int width = 1920;
+    int height = 1080;
+    int iterations = 20;
+    SDL_Surface *surface;
+    SDL_Renderer *renderer;
+    int i, j, k;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcasecmp(argv[i], "--size") == 0 && i + 2 < argc) {
+            width = SDL_atoi(argv[++i]);
+            height = SDL_atoi(argv[++i]);
+        } else if (SDL_strcasecmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("Usage: %s [--size W H] [--iterations N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (width <= 1 || height <= 1 || iterations <= 0) {
+        SDL_Log("Invalid benchmark parameters\n");
+        return 1;
+    }
+
+    surface = SDL_CreateRGBSurface(0, width, height, 32,
+                                   0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    if (!surface) {
+        SDL_Log("Couldn't create surface: %s\n", SDL_GetError());
+        return 1;
+    }
+    renderer = SDL_CreateSoftwareRenderer(surface);
+    if (!renderer) {
+        SDL_Log("Couldn't create renderer: %s\n", SDL_GetError());
+        return 1;
+    }
+    MakeObjects(width, height);
+
+    SDL_Log("Software renderer %dx%d, %d iterations, kiloprimitives/second\n",
+            width, height, iterations);
+    SDL_Log("%-6s %10s %10s %10s %10s %10s %10s\n", "Mode",
+            "Points", "Points[]", "Lines", "Lines[]", "Rects", "Rects[]");
+
+    for (i = 0; i < SDL_arraysize(modes); ++i) {
+        Uint64 start, elapsed[6];
+
+        SDL_SetRenderDrawBlendMode(renderer, modes[i]);
+        SDL_SetRenderDrawColor(renderer, 255, 128, 64, 128);
+        SDL_RenderClear(renderer);
+
+        start = SDL_GetPerformanceCounter();
+        for (k = 0; k < iterations; ++k) {
+            for (j = 0; j < SDL_arraysize(points); ++j) {
+                SDL_RenderDrawPoint(renderer, points[j].x, points[j].y);
+            }
+        }
+        elapsed[0] = SDL_GetPerformanceCounter() - start;
+
+        start = SDL_GetPerformanceCounter();
+        for (k = 0; k < iterations; ++k) {
+            SDL_RenderDrawPoints(renderer, points, SDL_arraysize(points));
+        }
+        elapsed[1] = SDL_GetPerformanceCounter() - start;
+
+        start = SDL_GetPerformanceCounter();
+        for (k = 0; k < iterations; ++k) {
+            for (j = 0; j < SDL_arraysize(lines); j += 2) {
+                SDL_RenderDrawLine(renderer, lines[j].x, lines[j].y,
+                                   lines[j+1].x, lines[j+1].y);
+            }
+        }
+        elapsed[2] = SDL_GetPerformanceCounter() - start;
+
+        /* A polyline, so there is one line per point */
+        start = SDL_GetPerformanceCounter();
+        for (k = 0; k < iterations; ++k) {
+            SDL_RenderDrawLines(renderer, lines, SDL_arraysize(lines));
+        }
+        elapsed[3] = SDL_GetPerformanceCounter() - start;
+
+        start = SDL_GetPerformanceCounter();
+        for (k = 0; k < iterations; ++k) {
+            for (j = 0; j < SDL_arraysize(rects); ++j) {
+                SDL_RenderFillRect(renderer, &rects[j]);
+            }
+        }
+        elapsed[4] = SDL_GetPerformanceCounter() - start;
+
+        start = SDL_GetPerformanceCounter();
+        for (k = 0; k < iterations; ++k) {
+            SDL_RenderFillRects(renderer, rects, SDL_arraysize(rects));
+        }
+        elapsed[5] = SDL_GetPerformanceCounter() - start;
+
+        SDL_Log("%-6s %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", mode_names[i],
+                Rate(SDL_arraysize(points), iterations, elapsed[0]),
+                Rate(SDL_arraysize(points), iterations, elapsed[1]),
+                Rate(SDL_arraysize(lines) / 2, iterations, elapsed[2]),
+                Rate(SDL_arraysize(lines) - 1, iterations, elapsed[3]),
+                Rate(SDL_arraysize(rects), iterations, elapsed[4]),
+                Rate(SDL_arraysize(rects), iterations, elapsed[5]));
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
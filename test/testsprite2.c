@@ -31,6 +31,11 @@ static int current_alpha = 0;
 static int current_color = 0;
 static SDL_Rect *positions;
 static SDL_Rect *velocities;
+static SDL_RenderCopyData *copies;
+static SDL_bool batch;
+static SDL_bool rotate;
+static int current_angle = 0;
+static int max_frames = -1;
 static int sprite_w, sprite_h;
 static SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND;
 
@@ -45,6 +50,7 @@ quit(int rc)
     SDL_free(sprites);
     SDL_free(positions);
     SDL_free(velocities);
+    SDL_free(copies);
     SDLTest_CommonQuit(state);
     exit(rc);
 }
@@ -218,12 +224,45 @@ MoveSprites(SDL_Renderer * renderer, SDL_Texture * sprite)
         }
     }
 
+    if (rotate) {
+        current_angle = (current_angle + 1) % 360;
+    }
+
     /* Draw sprites */
-    for (i = 0; i < num_sprites; ++i) {
-        position = &positions[i];
-		
-        /* Blit the sprite onto the screen */
-        SDL_RenderCopy(renderer, sprite, NULL, position);
+    if (batch) {
+        Uint8 r, g, b, a;
+
+        SDL_GetTextureColorMod(sprite, &r, &g, &b);
+        SDL_GetTextureAlphaMod(sprite, &a);
+        for (i = 0; i < num_sprites; ++i) {
+            SDL_RenderCopyData *copy = &copies[i];
+
+            SDL_zerop(copy);
+            copy->dstrect = positions[i];
+            if (rotate) {
+                copy->angle = (double)((current_angle + i * 30) % 360);
+            }
+            copy->r = r;
+            copy->g = g;
+            copy->b = b;
+            copy->a = a;
+        }
+
+        /* Blit all the sprites onto the screen at once */
+        SDL_RenderCopyMany(renderer, sprite, copies, num_sprites);
+    } else {
+        for (i = 0; i < num_sprites; ++i) {
+            position = &positions[i];
+
+            /* Blit the sprite onto the screen */
+            if (rotate) {
+                SDL_RenderCopyEx(renderer, sprite, NULL, position,
+                                 (double)((current_angle + i * 30) % 360),
+                                 NULL, SDL_FLIP_NONE);
+            } else {
+                SDL_RenderCopy(renderer, sprite, NULL, position);
+            }
+        }
     }
 
     /* Update the screen! */
@@ -278,6 +317,17 @@ main(int argc, char *argv[])
                     if (iterations < -1) iterations = -1;
                     consumed = 2;
                 }
+            } else if (SDL_strcasecmp(argv[i], "--frames") == 0) {
+                if (argv[i + 1]) {
+                    max_frames = SDL_atoi(argv[i + 1]);
+                    consumed = 2;
+                }
+            } else if (SDL_strcasecmp(argv[i], "--batch") == 0) {
+                batch = SDL_TRUE;
+                consumed = 1;
+            } else if (SDL_strcasecmp(argv[i], "--rotate") == 0) {
+                rotate = SDL_TRUE;
+                consumed = 1;
             } else if (SDL_strcasecmp(argv[i], "--cyclecolor") == 0) {
                 cycle_color = SDL_TRUE;
                 consumed = 1;
@@ -293,7 +343,7 @@ main(int argc, char *argv[])
             }
         }
         if (consumed < 0) {
-            SDL_Log("Usage: %s %s [--blend none|blend|add|mod] [--cyclecolor] [--cyclealpha] [--iterations N] [num_sprites] [icon.bmp]\n",
+            SDL_Log("Usage: %s %s [--blend none|blend|add|mod] [--cyclecolor] [--cyclealpha] [--iterations N] [--frames N] [--batch] [--rotate] [num_sprites] [icon.bmp]\n",
                     argv[0], SDLTest_CommonUsage(state));
             quit(1);
         }
@@ -322,7 +372,8 @@ main(int argc, char *argv[])
     /* Allocate memory for the sprite info */
     positions = (SDL_Rect *) SDL_malloc(num_sprites * sizeof(SDL_Rect));
     velocities = (SDL_Rect *) SDL_malloc(num_sprites * sizeof(SDL_Rect));
-    if (!positions || !velocities) {
+    copies = (SDL_RenderCopyData *) SDL_malloc(num_sprites * sizeof(SDL_RenderCopyData));
+    if (!positions || !velocities || !copies) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
         quit(2);
     }
@@ -362,6 +413,11 @@ main(int argc, char *argv[])
         for (i = 0; i < state->num_windows; ++i) {
             MoveSprites(state->renderers[i], sprites[i]);
         }
+
+        /* Stop after a fixed number of frames when benchmarking */
+        if (max_frames > 0 && frames >= (Uint32) max_frames) {
+            done = 1;
+        }
     }
 
     /* Print out some timing information */
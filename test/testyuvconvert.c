@@ -0,0 +1,147 @@
+/*
+  Copyright (C) 1997-2013 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark updating YUV textures on the software renderer, which converts
+   them to RGB with SDL_SW_CopyYUVToRGB(), for each YUV format and each
+   SDL_HINT_YUV_CONVERSION_MODE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+static const Uint32 formats[] = {
+    SDL_PIXELFORMAT_IYUV,
+    SDL_PIXELFORMAT_YV12,
+    SDL_PIXELFORMAT_YUY2,
+    SDL_PIXELFORMAT_UYVY,
+    SDL_PIXELFORMAT_YVYU
+};
+
+static const char *modes[] = {
+    "JPEG",
+    "BT601",
+    "BT709",
+    "BT709_FULL"
+};
+
+int
+main(int argc, char *argv[])
+{
+    int width = 1920;
+    int height = 1080;
+    int iterations = 50;
+    int i, j, k;
+    Uint8 *yuv;
+    SDL_Surface *surface;
+    SDL_Renderer *renderer;
+    Uint64 freq;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcasecmp(argv[i], "--size") == 0 && i + 2 < argc) {
+            width = SDL_atoi(argv[++i]);
+            height = SDL_atoi(argv[++i]);
+        } else if (SDL_strcasecmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("Usage: %s [--size W H] [--iterations N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (width <= 0 || height <= 0 || iterations <= 0) {
+        SDL_Log("Invalid benchmark parameters\n");
+        return 1;
+    }
+    /* The chroma of YUV textures covers pairs of pixels */
+    width &= ~1;
+    height &= ~1;
+
+    yuv = (Uint8 *) SDL_malloc(width * height * 2);
+    surface = SDL_CreateRGBSurface(0, width, height, 32,
+                                   0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+    if (!yuv || !surface) {
+        SDL_Log("Out of memory\n");
+        return 1;
+    }
+    for (i = 0; i < width * height * 2; ++i) {
+        yuv[i] = (Uint8) rand();
+    }
+    renderer = SDL_CreateSoftwareRenderer(surface);
+    if (!renderer) {
+        SDL_Log("Couldn't create software renderer: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    freq = SDL_GetPerformanceFrequency();
+
+    SDL_Log("YUV to RGB conversion %dx%d, %d iterations, SSE2 %s\n",
+            width, height, iterations, SDL_HasSSE2() ? "available" : "not available");
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        /* Planar formats have a byte of Y per pixel, packed formats two */
+        const int pitch = (formats[i] == SDL_PIXELFORMAT_IYUV ||
+                           formats[i] == SDL_PIXELFORMAT_YV12) ? width : width * 2;
+
+        for (j = 0; j < SDL_arraysize(modes); ++j) {
+            SDL_Texture *texture;
+            Uint64 start, elapsed;
+            double seconds;
+
+            /* The conversion mode is read when the texture is created */
+            SDL_SetHint(SDL_HINT_YUV_CONVERSION_MODE, modes[j]);
+            texture = SDL_CreateTexture(renderer, formats[i],
+                                        SDL_TEXTUREACCESS_STREAMING,
+                                        width, height);
+            if (!texture) {
+                SDL_Log("Couldn't create %s texture: %s\n",
+                        SDL_GetPixelFormatName(formats[i]), SDL_GetError());
+                continue;
+            }
+
+            /* Warm up caches and the conversion tables */
+            SDL_UpdateTexture(texture, NULL, yuv, pitch);
+
+            start = SDL_GetPerformanceCounter();
+            for (k = 0; k < iterations; ++k) {
+                if (SDL_UpdateTexture(texture, NULL, yuv, pitch) < 0) {
+                    break;
+                }
+            }
+            elapsed = SDL_GetPerformanceCounter() - start;
+            SDL_DestroyTexture(texture);
+
+            if (k < iterations) {
+                SDL_Log("%-24s %-10s failed: %s\n",
+                        SDL_GetPixelFormatName(formats[i]), modes[j],
+                        SDL_GetError());
+                continue;
+            }
+            seconds = (double) elapsed / freq;
+            SDL_Log("%-24s %-10s %8.2f ms/frame %8.1f megapixels/second\n",
+                    SDL_GetPixelFormatName(formats[i]), modes[j],
+                    seconds * 1000.0 / iterations,
+                    ((double) width * height * iterations) / seconds / 1000000.0);
+        }
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    SDL_free(yuv);
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */